@@ -0,0 +1,114 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Throughput of sa_process_common_encryption for the cenc, cens, cbc1, and cbcs schemes. The pattern schemes are run
+// with 1:9, 5:5, and 9:1 crypt:skip patterns. Every sample is split in 4 subsamples with a 16 byte clear header each.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+
+using namespace client_bench_helpers;
+
+#define SUBSAMPLE_COUNT 4
+#define BYTES_OF_CLEAR_DATA 16
+
+namespace {
+    void BM_ProcessCommonEncryption(
+            benchmark::State& state,
+            sa_cipher_algorithm cipher_algorithm) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        std::vector<uint8_t> iv(AES_BLOCK_SIZE);
+        sa_cipher_parameters_aes_cbc parameters = {iv.data(), iv.size()};
+        auto cipher = create_uninitialized_sa_crypto_cipher_context();
+        if (!setup_ok(state, sa_crypto_cipher_init(cipher.get(), cipher_algorithm, SA_CIPHER_MODE_DECRYPT, *key,
+                                     &parameters),
+                    "sa_crypto_cipher_init"))
+            return;
+
+        size_t size = state.range(0);
+        size_t crypt_byte_block = state.range(1);
+        std::vector<uint8_t> in_data(size);
+        std::vector<uint8_t> out_data(size);
+        sa_buffer in = clear_buffer(in_data);
+        sa_buffer out = clear_buffer(out_data);
+
+        std::vector<sa_subsample_length> subsample_lengths(SUBSAMPLE_COUNT);
+        for (auto& subsample_length : subsample_lengths) {
+            subsample_length.bytes_of_clear_data = BYTES_OF_CLEAR_DATA;
+            subsample_length.bytes_of_protected_data = size / SUBSAMPLE_COUNT - BYTES_OF_CLEAR_DATA;
+        }
+
+        sa_sample sample = {};
+        sample.iv = iv.data();
+        sample.iv_length = iv.size();
+        sample.crypt_byte_block = crypt_byte_block;
+        sample.skip_byte_block = crypt_byte_block == 0 ? 0 : 10 - crypt_byte_block;
+        sample.subsample_count = subsample_lengths.size();
+        sample.subsample_lengths = subsample_lengths.data();
+        sample.context = *cipher;
+        sample.out = &out;
+        sample.in = &in;
+        for (auto _ : state) {
+            in.context.clear.offset = 0;
+            out.context.clear.offset = 0;
+            if (sa_process_common_encryption(1, &sample) != SA_STATUS_OK) {
+                state.SkipWithError("sa_process_common_encryption failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    void no_pattern(benchmark::internal::Benchmark* benchmark) {
+        for (int64_t size = 1 << 10; size <= 1 << 22; size <<= 2)
+            benchmark->Args({size, 0});
+    }
+
+    void patterns(benchmark::internal::Benchmark* benchmark) {
+        for (int64_t size = 1 << 10; size <= 1 << 22; size <<= 2) {
+            for (int64_t crypt_byte_block : {1, 5, 9})
+                benchmark->Args({size, crypt_byte_block});
+        }
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(BM_ProcessCommonEncryption, cenc, SA_CIPHER_ALGORITHM_AES_CTR)
+        ->Apply(no_pattern)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessCommonEncryption, cens, SA_CIPHER_ALGORITHM_AES_CTR)
+        ->Apply(patterns)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessCommonEncryption, cbc1, SA_CIPHER_ALGORITHM_AES_CBC)
+        ->Apply(no_pattern)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_ProcessCommonEncryption, cbcs, SA_CIPHER_ALGORITHM_AES_CBC)
+        ->Apply(patterns)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
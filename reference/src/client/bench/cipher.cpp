@@ -0,0 +1,222 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Throughput of sa_crypto_cipher_process for every symmetric algorithm from 16 B to 16 MB, and latency of the
+// asymmetric decrypt algorithms.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+#include <openssl/evp.h>
+
+using namespace client_bench_helpers;
+
+namespace {
+    struct symmetric_parameters {
+        std::vector<uint8_t> iv = std::vector<uint8_t>(AES_BLOCK_SIZE);
+        std::vector<uint8_t> nonce = std::vector<uint8_t>(CHACHA20_NONCE_LENGTH);
+        std::vector<uint8_t> counter = std::vector<uint8_t>(CHACHA20_COUNTER_LENGTH);
+        sa_cipher_parameters_aes_cbc aes_cbc = {iv.data(), iv.size()};
+        sa_cipher_parameters_aes_ctr aes_ctr = {iv.data(), iv.size()};
+        sa_cipher_parameters_aes_gcm aes_gcm = {iv.data(), GCM_IV_LENGTH, nullptr, 0};
+        sa_cipher_parameters_chacha20 chacha20 = {counter.data(), counter.size(), nonce.data(), nonce.size()};
+        sa_cipher_parameters_chacha20_poly1305 chacha20_poly1305 = {nonce.data(), nonce.size(), nullptr, 0};
+
+        void* get(sa_cipher_algorithm cipher_algorithm) {
+            switch (cipher_algorithm) {
+                case SA_CIPHER_ALGORITHM_AES_CBC:
+                case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7:
+                    return &aes_cbc;
+
+                case SA_CIPHER_ALGORITHM_AES_CTR:
+                    return &aes_ctr;
+
+                case SA_CIPHER_ALGORITHM_AES_GCM:
+                    return &aes_gcm;
+
+                case SA_CIPHER_ALGORITHM_CHACHA20:
+                    return &chacha20;
+
+                case SA_CIPHER_ALGORITHM_CHACHA20_POLY1305:
+                    return &chacha20_poly1305;
+
+                default:
+                    return nullptr;
+            }
+        }
+    };
+
+    void BM_CipherProcess(
+            benchmark::State& state,
+            sa_cipher_algorithm cipher_algorithm) {
+
+        bool chacha = cipher_algorithm == SA_CIPHER_ALGORITHM_CHACHA20 ||
+                      cipher_algorithm == SA_CIPHER_ALGORITHM_CHACHA20_POLY1305;
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(chacha ? SYM_256_KEY_SIZE : SYM_128_KEY_SIZE));
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        symmetric_parameters parameters;
+        auto cipher = create_uninitialized_sa_crypto_cipher_context();
+        if (!setup_ok(state, sa_crypto_cipher_init(cipher.get(), cipher_algorithm, SA_CIPHER_MODE_ENCRYPT, *key,
+                                     parameters.get(cipher_algorithm)),
+                    "sa_crypto_cipher_init"))
+            return;
+
+        size_t size = state.range(0);
+        std::vector<uint8_t> in_data(size);
+        std::vector<uint8_t> out_data(size + AES_BLOCK_SIZE);
+        sa_buffer in = clear_buffer(in_data);
+        sa_buffer out = clear_buffer(out_data);
+        for (auto _ : state) {
+            in.context.clear.offset = 0;
+            out.context.clear.offset = 0;
+            size_t bytes_to_process = size;
+            if (sa_crypto_cipher_process(&out, *cipher, &in, &bytes_to_process) != SA_STATUS_OK) {
+                state.SkipWithError("sa_crypto_cipher_process failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    void BM_CipherDecryptRsa(
+            benchmark::State& state,
+            sa_cipher_algorithm cipher_algorithm) {
+
+        auto clear_key = sample_rsa_2048_pkcs8();
+        auto rsa = rsa_import_pkcs8(clear_key);
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_rsa(&rights, clear_key);
+        if (rsa == nullptr || key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        auto clear = random(32);
+        std::vector<uint8_t> in_data(EVP_PKEY_bits(rsa.get()) / 8);
+        sa_cipher_parameters_rsa_oaep oaep_parameters = {SA_DIGEST_ALGORITHM_SHA256, SA_DIGEST_ALGORITHM_SHA256,
+                nullptr, 0};
+        void* parameters = nullptr;
+        bool encrypted;
+        if (cipher_algorithm == SA_CIPHER_ALGORITHM_RSA_OAEP) {
+            parameters = &oaep_parameters;
+            encrypted = encrypt_rsa_oaep_openssl(in_data, clear, rsa, SA_DIGEST_ALGORITHM_SHA256,
+                    SA_DIGEST_ALGORITHM_SHA256, {});
+        } else {
+            encrypted = encrypt_rsa_pkcs1v15_openssl(in_data, clear, rsa);
+        }
+
+        if (!encrypted) {
+            state.SkipWithError("encrypt failed");
+            return;
+        }
+
+        auto cipher = create_uninitialized_sa_crypto_cipher_context();
+        if (!setup_ok(state, sa_crypto_cipher_init(cipher.get(), cipher_algorithm, SA_CIPHER_MODE_DECRYPT, *key,
+                                     parameters),
+                    "sa_crypto_cipher_init"))
+            return;
+
+        std::vector<uint8_t> out_data(in_data.size());
+        sa_buffer in = clear_buffer(in_data);
+        sa_buffer out = clear_buffer(out_data);
+        for (auto _ : state) {
+            in.context.clear.offset = 0;
+            out.context.clear.offset = 0;
+            size_t bytes_to_process = in_data.size();
+            if (sa_crypto_cipher_process(&out, *cipher, &in, &bytes_to_process) != SA_STATUS_OK) {
+                state.SkipWithError("sa_crypto_cipher_process failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_CipherDecryptEcElgamal(benchmark::State& state) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_uninitialized_sa_key();
+        sa_generate_parameters_ec generate_parameters = {SA_ELLIPTIC_CURVE_NIST_P256};
+        if (!setup_ok(state, sa_key_generate(key.get(), &rights, SA_KEY_TYPE_EC, &generate_parameters),
+                    "sa_key_generate"))
+            return;
+
+        // The x coordinate of the generator is a valid message point.
+        std::shared_ptr<EVP_PKEY> public_key(sa_get_public_key(*key), EVP_PKEY_free);
+        std::shared_ptr<EC_GROUP> ec_group(EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1), EC_GROUP_free);
+        std::vector<uint8_t> generator;
+        if (public_key == nullptr || ec_group == nullptr ||
+                !ec_point_export_xy(generator, EC_GROUP_get0_generator(ec_group.get()), ec_group.get())) {
+            state.SkipWithError("public key export failed");
+            return;
+        }
+
+        std::vector<uint8_t> clear(generator.begin(), generator.begin() + EC_P256_KEY_SIZE);
+        std::vector<uint8_t> in_data(4 * EC_P256_KEY_SIZE);
+        if (!encrypt_ec_elgamal_openssl(in_data, clear, SA_ELLIPTIC_CURVE_NIST_P256, public_key)) {
+            state.SkipWithError("encrypt failed");
+            return;
+        }
+
+        auto cipher = create_uninitialized_sa_crypto_cipher_context();
+        if (!setup_ok(state, sa_crypto_cipher_init(cipher.get(), SA_CIPHER_ALGORITHM_EC_ELGAMAL,
+                                     SA_CIPHER_MODE_DECRYPT, *key, nullptr),
+                    "sa_crypto_cipher_init"))
+            return;
+
+        std::vector<uint8_t> out_data(EC_P256_KEY_SIZE);
+        sa_buffer in = clear_buffer(in_data);
+        sa_buffer out = clear_buffer(out_data);
+        for (auto _ : state) {
+            in.context.clear.offset = 0;
+            out.context.clear.offset = 0;
+            size_t bytes_to_process = in_data.size();
+            if (sa_crypto_cipher_process(&out, *cipher, &in, &bytes_to_process) != SA_STATUS_OK) {
+                state.SkipWithError("sa_crypto_cipher_process failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+#define CIPHER_SIZES RangeMultiplier(16)->Range(16, 16 << 20)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime()
+
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_ecb, SA_CIPHER_ALGORITHM_AES_ECB)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_ecb_pkcs7, SA_CIPHER_ALGORITHM_AES_ECB_PKCS7)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_cbc, SA_CIPHER_ALGORITHM_AES_CBC)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_cbc_pkcs7, SA_CIPHER_ALGORITHM_AES_CBC_PKCS7)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_ctr, SA_CIPHER_ALGORITHM_AES_CTR)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, aes_gcm, SA_CIPHER_ALGORITHM_AES_GCM)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, chacha20, SA_CIPHER_ALGORITHM_CHACHA20)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherProcess, chacha20_poly1305, SA_CIPHER_ALGORITHM_CHACHA20_POLY1305)->CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_CipherDecryptRsa, rsa_oaep, SA_CIPHER_ALGORITHM_RSA_OAEP)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_CipherDecryptRsa, rsa_pkcs1v15, SA_CIPHER_ALGORITHM_RSA_PKCS1V15)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK(BM_CipherDecryptEcElgamal)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
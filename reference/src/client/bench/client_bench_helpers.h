@@ -0,0 +1,67 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CLIENT_BENCH_HELPERS_H
+#define CLIENT_BENCH_HELPERS_H
+
+#include "client_test_helpers.h"
+#include <benchmark/benchmark.h>
+
+// Upper bound of the thread counts every benchmark is run with. Each benchmark thread opens its own client session.
+#define SABENCH_MAX_THREADS 8
+
+namespace client_bench_helpers {
+    using namespace client_test_helpers;
+
+    /**
+     * Wraps a byte vector in a clear sa_buffer.
+     *
+     * @param[in] data the buffer contents.
+     * @return the sa_buffer. The buffer is valid as long as data is not resized.
+     */
+    inline sa_buffer clear_buffer(std::vector<uint8_t>& data) {
+        sa_buffer buffer = {};
+        buffer.buffer_type = SA_BUFFER_TYPE_CLEAR;
+        buffer.context.clear.buffer = data.data();
+        buffer.context.clear.length = data.size();
+        return buffer;
+    }
+
+    /**
+     * Marks the benchmark as skipped if a setup step did not return SA_STATUS_OK.
+     *
+     * @param[in] state the benchmark state.
+     * @param[in] status the status returned by the setup step.
+     * @param[in] step the name of the setup step.
+     * @return true if the setup step succeeded.
+     */
+    inline bool setup_ok(
+            benchmark::State& state,
+            sa_status status,
+            const char* step) {
+        if (status == SA_STATUS_OK)
+            return true;
+
+        std::string message = std::string(step) + (status == SA_STATUS_OPERATION_NOT_SUPPORTED ? " not supported" :
+                                                                                                   " failed");
+        state.SkipWithError(message.c_str());
+        return false;
+    }
+} // namespace client_bench_helpers
+
+#endif // CLIENT_BENCH_HELPERS_H
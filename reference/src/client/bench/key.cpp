@@ -0,0 +1,231 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Latency of key import, unwrap, derive, exchange, and generate. Every iteration releases the key it created.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+
+using namespace client_bench_helpers;
+
+namespace {
+    void BM_KeyImport(benchmark::State& state) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto clear_key = random(SYM_128_KEY_SIZE);
+        sa_import_parameters_symmetric parameters = {&rights};
+        for (auto _ : state) {
+            sa_key key = INVALID_HANDLE;
+            if (sa_key_import(&key, SA_KEY_FORMAT_SYMMETRIC_BYTES, clear_key.data(), clear_key.size(),
+                        &parameters) != SA_STATUS_OK) {
+                state.SkipWithError("sa_key_import failed");
+                break;
+            }
+
+            sa_key_release(key);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_KeyUnwrap(benchmark::State& state) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto wrapping_clear_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, wrapping_clear_key);
+        std::vector<uint8_t> wrapped;
+        if (wrapping_key == nullptr || *wrapping_key == UNSUPPORTED_KEY ||
+                !encrypt_aes_ecb_openssl(wrapped, random(SYM_128_KEY_SIZE), wrapping_clear_key, false)) {
+            state.SkipWithError("wrapping key setup failed");
+            return;
+        }
+
+        for (auto _ : state) {
+            sa_key key = INVALID_HANDLE;
+            if (sa_key_unwrap(&key, &rights, SA_KEY_TYPE_SYMMETRIC, nullptr, SA_CIPHER_ALGORITHM_AES_ECB, nullptr,
+                        *wrapping_key, wrapped.data(), wrapped.size()) != SA_STATUS_OK) {
+                state.SkipWithError("sa_key_unwrap failed");
+                break;
+            }
+
+            sa_key_release(key);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_KeyDerive(
+            benchmark::State& state,
+            sa_kdf_algorithm kdf_algorithm) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto parent = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        if (parent == nullptr || *parent == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        auto info = random(AES_BLOCK_SIZE);
+        auto salt = random(AES_BLOCK_SIZE);
+        sa_kdf_parameters_hkdf hkdf_parameters = {SYM_128_KEY_SIZE, SA_DIGEST_ALGORITHM_SHA256, *parent, salt.data(),
+                salt.size(), info.data(), info.size()};
+        sa_kdf_parameters_concat concat_parameters = {SYM_128_KEY_SIZE, SA_DIGEST_ALGORITHM_SHA256, *parent,
+                info.data(), info.size()};
+        sa_kdf_parameters_ansi_x963 ansi_x963_parameters = {SYM_128_KEY_SIZE, SA_DIGEST_ALGORITHM_SHA256, *parent,
+                info.data(), info.size()};
+        sa_kdf_parameters_cmac cmac_parameters = {SYM_128_KEY_SIZE, *parent, info.data(), info.size(), 1};
+        void* parameters;
+        switch (kdf_algorithm) {
+            case SA_KDF_ALGORITHM_HKDF:
+                parameters = &hkdf_parameters;
+                break;
+
+            case SA_KDF_ALGORITHM_CONCAT:
+                parameters = &concat_parameters;
+                break;
+
+            case SA_KDF_ALGORITHM_ANSI_X963:
+                parameters = &ansi_x963_parameters;
+                break;
+
+            default:
+                parameters = &cmac_parameters;
+                break;
+        }
+
+        for (auto _ : state) {
+            sa_key key = INVALID_HANDLE;
+            if (sa_key_derive(&key, &rights, kdf_algorithm, parameters) != SA_STATUS_OK) {
+                state.SkipWithError("sa_key_derive failed");
+                break;
+            }
+
+            sa_key_release(key);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_KeyExchange(
+            benchmark::State& state,
+            sa_key_exchange_algorithm key_exchange_algorithm) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto dh_parameters = get_dh_parameters(DH_2048_BYTE_LENGTH);
+        sa_generate_parameters_dh dh_generate_parameters = {std::get<0>(dh_parameters).data(),
+                std::get<0>(dh_parameters).size(), std::get<1>(dh_parameters).data(),
+                std::get<1>(dh_parameters).size()};
+        sa_generate_parameters_ec ec_generate_parameters = {SA_ELLIPTIC_CURVE_NIST_P256};
+        sa_key_type key_type = key_exchange_algorithm == SA_KEY_EXCHANGE_ALGORITHM_DH ? SA_KEY_TYPE_DH : SA_KEY_TYPE_EC;
+        void* generate_parameters = key_type == SA_KEY_TYPE_DH ? static_cast<void*>(&dh_generate_parameters) :
+                                                                 static_cast<void*>(&ec_generate_parameters);
+
+        auto private_key = create_uninitialized_sa_key();
+        auto other_key = create_uninitialized_sa_key();
+        if (!setup_ok(state, sa_key_generate(private_key.get(), &rights, key_type, generate_parameters),
+                    "sa_key_generate") ||
+                !setup_ok(state, sa_key_generate(other_key.get(), &rights, key_type, generate_parameters),
+                        "sa_key_generate"))
+            return;
+
+        std::vector<uint8_t> other_public(4096);
+        size_t other_public_length = other_public.size();
+        if (!setup_ok(state, sa_key_get_public(other_public.data(), &other_public_length, *other_key),
+                    "sa_key_get_public"))
+            return;
+
+        for (auto _ : state) {
+            sa_key key = INVALID_HANDLE;
+            if (sa_key_exchange(&key, &rights, key_exchange_algorithm, *private_key, other_public.data(),
+                        other_public_length, nullptr) != SA_STATUS_OK) {
+                state.SkipWithError("sa_key_exchange failed");
+                break;
+            }
+
+            sa_key_release(key);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_KeyGenerate(
+            benchmark::State& state,
+            sa_key_type key_type) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto dh_parameters = get_dh_parameters(DH_2048_BYTE_LENGTH);
+        sa_generate_parameters_symmetric symmetric_parameters = {SYM_128_KEY_SIZE};
+        sa_generate_parameters_rsa rsa_parameters = {RSA_2048_BYTE_LENGTH};
+        sa_generate_parameters_ec ec_parameters = {SA_ELLIPTIC_CURVE_NIST_P256};
+        sa_generate_parameters_dh dh_generate_parameters = {std::get<0>(dh_parameters).data(),
+                std::get<0>(dh_parameters).size(), std::get<1>(dh_parameters).data(),
+                std::get<1>(dh_parameters).size()};
+        void* parameters;
+        switch (key_type) {
+            case SA_KEY_TYPE_SYMMETRIC:
+                parameters = &symmetric_parameters;
+                break;
+
+            case SA_KEY_TYPE_RSA:
+                parameters = &rsa_parameters;
+                break;
+
+            case SA_KEY_TYPE_EC:
+                parameters = &ec_parameters;
+                break;
+
+            default:
+                parameters = &dh_generate_parameters;
+                break;
+        }
+
+        for (auto _ : state) {
+            sa_key key = INVALID_HANDLE;
+            if (!setup_ok(state, sa_key_generate(&key, &rights, key_type, parameters), "sa_key_generate"))
+                break;
+
+            sa_key_release(key);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+BENCHMARK(BM_KeyImport)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK(BM_KeyUnwrap)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyDerive, hkdf, SA_KDF_ALGORITHM_HKDF)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyDerive, concat, SA_KDF_ALGORITHM_CONCAT)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyDerive, ansi_x963, SA_KDF_ALGORITHM_ANSI_X963)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyDerive, cmac, SA_KDF_ALGORITHM_CMAC)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyExchange, dh, SA_KEY_EXCHANGE_ALGORITHM_DH)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyExchange, ecdh, SA_KEY_EXCHANGE_ALGORITHM_ECDH)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyGenerate, symmetric, SA_KEY_TYPE_SYMMETRIC)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyGenerate, ec, SA_KEY_TYPE_EC)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyGenerate, dh, SA_KEY_TYPE_DH)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_KeyGenerate, rsa, SA_KEY_TYPE_RSA)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Latency of a complete sa_crypto_mac init/process/compute/release sequence for HMAC and CMAC from 16 B to 1 MB.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+
+using namespace client_bench_helpers;
+
+namespace {
+    void BM_Mac(
+            benchmark::State& state,
+            sa_mac_algorithm mac_algorithm) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        sa_mac_parameters_hmac hmac_parameters = {SA_DIGEST_ALGORITHM_SHA256};
+        void* parameters = mac_algorithm == SA_MAC_ALGORITHM_HMAC ? &hmac_parameters : nullptr;
+        auto in = random(state.range(0));
+        std::vector<uint8_t> out(SHA256_DIGEST_LENGTH);
+        for (auto _ : state) {
+            sa_crypto_mac_context context = INVALID_HANDLE;
+            size_t out_length = out.size();
+            sa_status status = sa_crypto_mac_init(&context, mac_algorithm, *key, parameters);
+            if (status == SA_STATUS_OK)
+                status = sa_crypto_mac_process(context, in.data(), in.size());
+
+            if (status == SA_STATUS_OK)
+                status = sa_crypto_mac_compute(out.data(), &out_length, context);
+
+            sa_crypto_mac_release(context);
+            if (status != SA_STATUS_OK) {
+                state.SkipWithError("sa_crypto_mac failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * in.size()));
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Mac, hmac_sha256, SA_MAC_ALGORITHM_HMAC)
+        ->RangeMultiplier(16)
+        ->Range(16, 1 << 20)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Mac, cmac, SA_MAC_ALGORITHM_CMAC)
+        ->RangeMultiplier(16)
+        ->Range(16, 1 << 20)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
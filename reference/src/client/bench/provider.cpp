@@ -0,0 +1,247 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Compares the OpenSSL 3 provider with the engine: EVP cipher throughput for AES CBC, CTR, and GCM from 1 KB to 1 MB,
+// the cost of initializing an EVP cipher context for a single block, and EVP signing latency for RSA and ECDSA. The
+// engine takes a global lock on every cipher lookup and context init; the provider does not.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+#include "sa_engine.h"
+#include "sa_provider.h"
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+using namespace client_bench_helpers;
+
+namespace {
+    // One library context with the provider loaded is shared by all benchmark threads, as it would be in a player.
+    OSSL_LIB_CTX* provider_libctx() {
+        static struct provider_holder {
+            OSSL_LIB_CTX* libctx = OSSL_LIB_CTX_new();
+            OSSL_PROVIDER* provider = sa_provider_load(libctx);
+        } holder;
+        return holder.provider == nullptr ? nullptr : holder.libctx;
+    }
+
+    // Likewise one engine reference is shared by all benchmark threads.
+    ENGINE* shared_engine() {
+        static std::shared_ptr<ENGINE> engine(sa_get_engine(), sa_engine_free);
+        return engine.get();
+    }
+
+    // Returns the cipher used by the engine or by the provider and, for the engine, the engine to pass to init.
+    bool get_cipher(
+            benchmark::State& state,
+            bool provider,
+            const char* name,
+            std::shared_ptr<EVP_CIPHER>& cipher,
+            ENGINE*& engine) {
+
+        if (provider) {
+            OSSL_LIB_CTX* libctx = provider_libctx();
+            cipher = std::shared_ptr<EVP_CIPHER>(
+                    libctx == nullptr ? nullptr : EVP_CIPHER_fetch(libctx, name, SA_PROVIDER_PROPERTY_QUERY),
+                    EVP_CIPHER_free);
+        } else {
+            engine = shared_engine();
+            // The engine substitutes its own implementation at init, so the built in cipher is only a lookup key.
+            cipher = std::shared_ptr<EVP_CIPHER>(const_cast<EVP_CIPHER*>(EVP_get_cipherbyname(name)),
+                    [](EVP_CIPHER*) {});
+        }
+
+        if (cipher == nullptr || (!provider && engine == nullptr)) {
+            state.SkipWithError("cipher setup failed");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool cipher_init(
+            EVP_CIPHER_CTX* cipher_ctx,
+            const EVP_CIPHER* cipher,
+            ENGINE* engine,
+            const sa_key* key,
+            const std::vector<uint8_t>& iv) {
+
+        const auto* key_bytes = reinterpret_cast<const unsigned char*>(key);
+        if (engine == nullptr)
+            return EVP_EncryptInit_ex2(cipher_ctx, cipher, key_bytes, iv.data(), nullptr) == 1;
+
+        return EVP_EncryptInit_ex(cipher_ctx, cipher, engine, key_bytes, iv.data()) == 1;
+    }
+
+    void BM_EvpCipher(
+            benchmark::State& state,
+            bool provider,
+            const char* name) {
+
+        std::shared_ptr<EVP_CIPHER> cipher;
+        ENGINE* engine = nullptr;
+        if (!get_cipher(state, provider, name, cipher, engine))
+            return;
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        auto iv = random(AES_BLOCK_SIZE);
+        std::shared_ptr<EVP_CIPHER_CTX> cipher_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+        if (!cipher_init(cipher_ctx.get(), cipher.get(), engine, key.get(), iv) ||
+                EVP_CIPHER_CTX_set_padding(cipher_ctx.get(), 0) != 1) {
+            state.SkipWithError("EVP_EncryptInit failed");
+            return;
+        }
+
+        size_t size = state.range(0);
+        std::vector<uint8_t> in(size);
+        std::vector<uint8_t> out(size + AES_BLOCK_SIZE);
+        for (auto _ : state) {
+            int length;
+            if (EVP_EncryptUpdate(cipher_ctx.get(), out.data(), &length, in.data(), static_cast<int>(size)) != 1) {
+                state.SkipWithError("EVP_EncryptUpdate failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    // A full init, one block update, and final per iteration, as a player does for every short lived operation.
+    void BM_EvpCipherInit(
+            benchmark::State& state,
+            bool provider) {
+
+        std::shared_ptr<EVP_CIPHER> cipher;
+        ENGINE* engine = nullptr;
+        if (!get_cipher(state, provider, "AES-128-CBC", cipher, engine))
+            return;
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key import failed");
+            return;
+        }
+
+        auto iv = random(AES_BLOCK_SIZE);
+        std::vector<uint8_t> in(AES_BLOCK_SIZE);
+        std::vector<uint8_t> out(2 * AES_BLOCK_SIZE);
+        for (auto _ : state) {
+            // The engine returns the number of bytes written from final rather than 1.
+            std::shared_ptr<EVP_CIPHER_CTX> cipher_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+            int length;
+            if (!cipher_init(cipher_ctx.get(), cipher.get(), engine, key.get(), iv) ||
+                    EVP_EncryptUpdate(cipher_ctx.get(), out.data(), &length, in.data(),
+                            static_cast<int>(in.size())) != 1 ||
+                    EVP_EncryptFinal_ex(cipher_ctx.get(), out.data() + length, &length) <= 0) {
+                state.SkipWithError("EVP encrypt failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_EvpSign(
+            benchmark::State& state,
+            bool provider,
+            sa_key_type key_type) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        std::shared_ptr<sa_key> key;
+        if (key_type == SA_KEY_TYPE_RSA) {
+            key = create_sa_key_rsa(&rights, sample_rsa_2048_pkcs8());
+        } else {
+            key = create_uninitialized_sa_key();
+            sa_generate_parameters_ec generate_parameters = {SA_ELLIPTIC_CURVE_NIST_P256};
+            if (key != nullptr && sa_key_generate(key.get(), &rights, SA_KEY_TYPE_EC, &generate_parameters) !=
+                                          SA_STATUS_OK)
+                key = nullptr;
+        }
+
+        if (key == nullptr || *key == UNSUPPORTED_KEY) {
+            state.SkipWithError("key setup failed");
+            return;
+        }
+
+        OSSL_LIB_CTX* libctx = nullptr;
+        ENGINE* engine = nullptr;
+        std::shared_ptr<EVP_PKEY> evp_pkey;
+        if (provider) {
+            libctx = provider_libctx();
+            evp_pkey = std::shared_ptr<EVP_PKEY>(
+                    libctx == nullptr ? nullptr : sa_provider_load_private_key(libctx, *key), EVP_PKEY_free);
+        } else {
+            engine = shared_engine();
+            evp_pkey = std::shared_ptr<EVP_PKEY>(engine == nullptr ? nullptr :
+                                                                     ENGINE_load_private_key(engine,
+                                                                             reinterpret_cast<char*>(key.get()),
+                                                                             nullptr, nullptr),
+                    EVP_PKEY_free);
+        }
+
+        if (evp_pkey == nullptr) {
+            state.SkipWithError("private key load failed");
+            return;
+        }
+
+        auto data = random(32);
+        std::vector<uint8_t> signature(EVP_PKEY_get_size(evp_pkey.get()));
+        for (auto _ : state) {
+            std::shared_ptr<EVP_MD_CTX> evp_md_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+            int result = provider ? EVP_DigestSignInit_ex(evp_md_ctx.get(), nullptr, "SHA256", libctx, nullptr,
+                                            evp_pkey.get(), nullptr) :
+                                    EVP_DigestSignInit(evp_md_ctx.get(), nullptr, EVP_sha256(), engine,
+                                            evp_pkey.get());
+            size_t signature_length = signature.size();
+            if (result != 1 ||
+                    EVP_DigestSign(evp_md_ctx.get(), signature.data(), &signature_length, data.data(),
+                            data.size()) != 1) {
+                state.SkipWithError("EVP_DigestSign failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+#define PROVIDER_CIPHER_SIZES Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime()
+
+BENCHMARK_CAPTURE(BM_EvpCipher, engine_aes_128_cbc, false, "AES-128-CBC")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipher, provider_aes_128_cbc, true, "AES-128-CBC")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipher, engine_aes_128_ctr, false, "AES-128-CTR")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipher, provider_aes_128_ctr, true, "AES-128-CTR")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipher, engine_aes_128_gcm, false, "AES-128-GCM")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipher, provider_aes_128_gcm, true, "AES-128-GCM")->PROVIDER_CIPHER_SIZES;
+BENCHMARK_CAPTURE(BM_EvpCipherInit, engine, false)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_EvpCipherInit, provider, true)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_EvpSign, engine_rsa, false, SA_KEY_TYPE_RSA)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_EvpSign, provider_rsa, true, SA_KEY_TYPE_RSA)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_EvpSign, engine_ecdsa, false, SA_KEY_TYPE_EC)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_EvpSign, provider_ecdsa, true, SA_KEY_TYPE_EC)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+#endif
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Nonces per second from sa_crypto_random, one call into the TA per nonce, and from sa_crypto_random_buffered, which
+// serves nonces from a per thread block of TA random bytes.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+
+using namespace client_bench_helpers;
+
+namespace {
+    void BM_Random(
+            benchmark::State& state,
+            sa_status (*random_function)(void*, size_t)) {
+
+        std::vector<uint8_t> out(state.range(0));
+        for (auto _ : state) {
+            if (random_function(out.data(), out.size()) != SA_STATUS_OK) {
+                state.SkipWithError("random failed");
+                break;
+            }
+
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Random, direct, sa_crypto_random)
+        ->Arg(12)
+        ->Arg(16)
+        ->Arg(32)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Random, buffered, sa_crypto_random_buffered)
+        ->Arg(12)
+        ->Arg(16)
+        ->Arg(32)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Teardown cost: releasing a set of keys and the cipher contexts that use them, as a player does when it stops a
+// stream. The coalesced variants queue the releases with sa_coalesce_releases and send them in batches, so they pay one
+// TA call per 64 releases instead of one per release. Run against the ta_simulator build to see the difference a real
+// REE to TA transition makes.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+#include <vector>
+
+using namespace client_bench_helpers;
+
+namespace {
+    void BM_Teardown(
+            benchmark::State& state,
+            bool coalesce) {
+
+        auto objects = static_cast<size_t>(state.range(0));
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        sa_import_parameters_symmetric parameters = {&rights};
+        auto clear_key = random(SYM_128_KEY_SIZE);
+        std::vector<sa_key> keys(objects);
+        std::vector<sa_crypto_cipher_context> ciphers(objects);
+        if (!setup_ok(state, sa_coalesce_releases(coalesce), "sa_coalesce_releases"))
+            return;
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            bool created = true;
+            for (size_t i = 0; i < objects && created; i++) {
+                created = sa_key_import(&keys[i], SA_KEY_FORMAT_SYMMETRIC_BYTES, clear_key.data(), clear_key.size(),
+                                  &parameters) == SA_STATUS_OK &&
+                          sa_crypto_cipher_init(&ciphers[i], SA_CIPHER_ALGORITHM_AES_ECB, SA_CIPHER_MODE_ENCRYPT,
+                                  keys[i], nullptr) == SA_STATUS_OK;
+            }
+
+            state.ResumeTiming();
+            if (!created) {
+                state.SkipWithError("key or cipher setup failed");
+                break;
+            }
+
+            for (size_t i = 0; i < objects; i++) {
+                sa_crypto_cipher_release(ciphers[i]);
+                sa_key_release(keys[i]);
+            }
+
+            if (coalesce && sa_flush_releases() != SA_STATUS_OK) {
+                state.SkipWithError("sa_flush_releases failed");
+                break;
+            }
+        }
+
+        sa_coalesce_releases(false);
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * objects * 2));
+        state.SetLabel(coalesce ? "coalesced" : "synchronous");
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Teardown, synchronous, false)->Arg(16)->Arg(128);
+BENCHMARK_CAPTURE(BM_Teardown, coalesced, true)->Arg(16)->Arg(128);
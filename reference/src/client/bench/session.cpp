@@ -0,0 +1,66 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Latency of opening and closing a TA session, the cost a new client thread pays on its first SecApi call, and the
+// cost of a short lived thread that makes a single SecApi call. Run with SA_SESSION_POOL_SIZE set to measure the
+// session pool mode, in which threads are bound to a pool session instead of opening their own. The sabench_pooled
+// target runs every benchmark that way.
+
+#include "client_bench_helpers.h"
+#include "ta_client.h"
+#include <cstdlib>
+#include <thread>
+
+using namespace client_bench_helpers;
+
+namespace {
+    void BM_SessionOpenClose(benchmark::State& state) {
+        for (auto _ : state) {
+            void* session = nullptr;
+            if (ta_open_session(&session) != SA_STATUS_OK) {
+                state.SkipWithError("ta_open_session failed");
+                break;
+            }
+
+            ta_close_session(session);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_ThreadChurn(benchmark::State& state) {
+        for (auto _ : state) {
+            sa_status status = SA_STATUS_INTERNAL_ERROR;
+            std::thread thread([&status]() {
+                sa_version version;
+                status = sa_get_version(&version);
+            });
+            thread.join();
+            if (status != SA_STATUS_OK) {
+                state.SkipWithError("sa_get_version failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.SetLabel(getenv("SA_SESSION_POOL_SIZE") != nullptr ? "pooled" : "per-thread");
+    }
+} // namespace
+
+BENCHMARK(BM_SessionOpenClose)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK(BM_ThreadChurn)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
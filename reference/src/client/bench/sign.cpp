@@ -0,0 +1,94 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Latency of sa_crypto_sign for RSA PKCS #1 v1.5, RSA PSS, ECDSA, and EdDSA over a 32 byte message.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+
+using namespace client_bench_helpers;
+
+namespace {
+    std::shared_ptr<sa_key> sign_key(
+            benchmark::State& state,
+            sa_signature_algorithm signature_algorithm) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        if (signature_algorithm == SA_SIGNATURE_ALGORITHM_RSA_PKCS1V15 ||
+                signature_algorithm == SA_SIGNATURE_ALGORITHM_RSA_PSS) {
+            auto key = create_sa_key_rsa(&rights, sample_rsa_2048_pkcs8());
+            if (key == nullptr || *key == UNSUPPORTED_KEY) {
+                state.SkipWithError("key import failed");
+                return nullptr;
+            }
+
+            return key;
+        }
+
+        auto key = create_uninitialized_sa_key();
+        sa_generate_parameters_ec parameters = {signature_algorithm == SA_SIGNATURE_ALGORITHM_EDDSA ?
+                                                        SA_ELLIPTIC_CURVE_ED25519 :
+                                                        SA_ELLIPTIC_CURVE_NIST_P256};
+        if (!setup_ok(state, sa_key_generate(key.get(), &rights, SA_KEY_TYPE_EC, &parameters), "sa_key_generate"))
+            return nullptr;
+
+        return key;
+    }
+
+    void BM_Sign(
+            benchmark::State& state,
+            sa_signature_algorithm signature_algorithm) {
+
+        auto key = sign_key(state, signature_algorithm);
+        if (key == nullptr)
+            return;
+
+        sa_sign_parameters_rsa_pkcs1v15 rsa_pkcs1v15_parameters = {SA_DIGEST_ALGORITHM_SHA256, false};
+        sa_sign_parameters_rsa_pss rsa_pss_parameters = {SA_DIGEST_ALGORITHM_SHA256, SA_DIGEST_ALGORITHM_SHA256, false,
+                SHA256_DIGEST_LENGTH};
+        sa_sign_parameters_ecdsa ecdsa_parameters = {SA_DIGEST_ALGORITHM_SHA256, false};
+        void* parameters = nullptr;
+        if (signature_algorithm == SA_SIGNATURE_ALGORITHM_RSA_PKCS1V15)
+            parameters = &rsa_pkcs1v15_parameters;
+        else if (signature_algorithm == SA_SIGNATURE_ALGORITHM_RSA_PSS)
+            parameters = &rsa_pss_parameters;
+        else if (signature_algorithm == SA_SIGNATURE_ALGORITHM_ECDSA)
+            parameters = &ecdsa_parameters;
+
+        auto in = random(32);
+        std::vector<uint8_t> out(RSA_2048_BYTE_LENGTH);
+        for (auto _ : state) {
+            size_t out_length = out.size();
+            if (sa_crypto_sign(out.data(), &out_length, signature_algorithm, *key, in.data(), in.size(),
+                        parameters) != SA_STATUS_OK) {
+                state.SkipWithError("sa_crypto_sign failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Sign, rsa_pkcs1v15, SA_SIGNATURE_ALGORITHM_RSA_PKCS1V15)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(BM_Sign, rsa_pss, SA_SIGNATURE_ALGORITHM_RSA_PSS)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Sign, ecdsa, SA_SIGNATURE_ALGORITHM_ECDSA)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Sign, eddsa, SA_SIGNATURE_ALGORITHM_EDDSA)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
@@ -0,0 +1,223 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Throughput of sa_svp_buffer_write and sa_svp_buffer_copy from 1 KB to 16 MB, throughput of reassembling a frame from
+// ranges of 16 B to 4 MB with a call per range and with sa_svp_buffer_batch, latency of sa_svp_key_check, and the
+// cost of obtaining and returning a frame buffer with sa_svp_buffer_alloc/free and with an SVP buffer pool.
+// sa_svp_buffer_check can only be called from a TA and is not benchmarked here.
+
+#include "client_bench_helpers.h"
+#include "sa.h"
+#include <algorithm>
+
+using namespace client_bench_helpers;
+
+namespace {
+    bool svp_supported(benchmark::State& state) {
+        return setup_ok(state, sa_svp_supported(), "svp");
+    }
+
+    void BM_SvpBufferWrite(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        size_t size = state.range(0);
+        auto out = buffer_alloc(SA_BUFFER_TYPE_SVP, size);
+        if (out == nullptr) {
+            state.SkipWithError("buffer_alloc failed");
+            return;
+        }
+
+        auto in = random(size);
+        sa_svp_offset offset = {0, 0, size};
+        for (auto _ : state) {
+            if (sa_svp_buffer_write(out->context.svp.buffer, in.data(), in.size(), &offset, 1) != SA_STATUS_OK) {
+                state.SkipWithError("sa_svp_buffer_write failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    void BM_SvpBufferCopy(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        size_t size = state.range(0);
+        auto out = buffer_alloc(SA_BUFFER_TYPE_SVP, size);
+        auto in = buffer_alloc(SA_BUFFER_TYPE_SVP, size);
+        if (out == nullptr || in == nullptr) {
+            state.SkipWithError("buffer_alloc failed");
+            return;
+        }
+
+        sa_svp_offset offset = {0, 0, size};
+        for (auto _ : state) {
+            if (sa_svp_buffer_copy(out->context.svp.buffer, in->context.svp.buffer, &offset, 1) != SA_STATUS_OK) {
+                state.SkipWithError("sa_svp_buffer_copy failed");
+                break;
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+
+    // Reassemble a frame from NAL units whose 4 byte start codes are dropped, so that no two ranges can be merged.
+    // Mode 0 writes each unit with its own sa_svp_buffer_write call, mode 1 writes the whole frame with one
+    // sa_svp_buffer_batch call.
+    void BM_SvpBufferRanges(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        const size_t start_code_length = 4;
+        size_t range_size = state.range(0);
+        bool batched = state.range(1) != 0;
+        size_t ranges = std::max<size_t>(1, std::min<size_t>(4096, (4 << 20) / range_size));
+        auto out = buffer_alloc(SA_BUFFER_TYPE_SVP, ranges * range_size);
+        if (out == nullptr) {
+            state.SkipWithError("buffer_alloc failed");
+            return;
+        }
+
+        auto in = random(ranges * (range_size + start_code_length));
+        std::vector<sa_svp_offset> offsets(ranges);
+        for (size_t i = 0; i < ranges; i++)
+            offsets[i] = {i * range_size, i * (range_size + start_code_length) + start_code_length, range_size};
+
+        sa_svp_batch_entry entry = {out->context.svp.buffer, INVALID_HANDLE, offsets.data(), offsets.size()};
+        for (auto _ : state) {
+            if (batched) {
+                if (sa_svp_buffer_batch(in.data(), in.size(), &entry, 1) != SA_STATUS_OK) {
+                    state.SkipWithError("sa_svp_buffer_batch failed");
+                    break;
+                }
+
+                continue;
+            }
+
+            for (size_t i = 0; i < ranges; i++) {
+                sa_svp_offset offset = {offsets[i].out_offset, 0, range_size};
+                if (sa_svp_buffer_write(out->context.svp.buffer, in.data() + offsets[i].in_offset, range_size,
+                            &offset, 1) != SA_STATUS_OK) {
+                    state.SkipWithError("sa_svp_buffer_write failed");
+                    break;
+                }
+            }
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * ranges * range_size));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ranges));
+    }
+
+    void BM_SvpKeyCheck(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto clear_key = random(SYM_128_KEY_SIZE);
+        auto key = create_sa_key_symmetric(&rights, clear_key);
+        auto clear = random(AES_BLOCK_SIZE);
+        std::vector<uint8_t> encrypted;
+        if (key == nullptr || *key == UNSUPPORTED_KEY || !encrypt_aes_ecb_openssl(encrypted, clear, clear_key, false)) {
+            state.SkipWithError("key setup failed");
+            return;
+        }
+
+        auto in = buffer_alloc(SA_BUFFER_TYPE_CLEAR, encrypted);
+        if (in == nullptr) {
+            state.SkipWithError("buffer_alloc failed");
+            return;
+        }
+
+        for (auto _ : state) {
+            in->context.clear.offset = 0;
+            if (sa_svp_key_check(*key, in.get(), clear.size(), clear.data(), clear.size()) != SA_STATUS_OK) {
+                state.SkipWithError("sa_svp_key_check failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_SvpBufferAllocFree(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        size_t size = state.range(0);
+        for (auto _ : state) {
+            sa_svp_buffer svp_buffer;
+            if (sa_svp_buffer_alloc(&svp_buffer, size) != SA_STATUS_OK) {
+                state.SkipWithError("sa_svp_buffer_alloc failed");
+                break;
+            }
+
+            sa_svp_buffer_free(svp_buffer);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_SvpBufferPoolAcquireRelease(benchmark::State& state) {
+        if (!svp_supported(state))
+            return;
+
+        size_t size = state.range(0);
+        sa_svp_buffer_pool_parameters parameters = {&size, 1, 1, 4};
+        sa_svp_buffer_pool* pool = nullptr;
+        if (!setup_ok(state, sa_svp_buffer_pool_create(&pool, &parameters), "sa_svp_buffer_pool_create"))
+            return;
+
+        for (auto _ : state) {
+            sa_buffer buffer;
+            if (sa_svp_buffer_pool_acquire(&buffer, pool, size) != SA_STATUS_OK) {
+                state.SkipWithError("sa_svp_buffer_pool_acquire failed");
+                break;
+            }
+
+            sa_svp_buffer_pool_release(pool, buffer.context.svp.buffer);
+        }
+
+        sa_svp_buffer_pool_destroy(pool);
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+} // namespace
+
+BENCHMARK(BM_SvpBufferWrite)
+        ->RangeMultiplier(16)
+        ->Range(1 << 10, 16 << 20)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK(BM_SvpBufferCopy)
+        ->RangeMultiplier(16)
+        ->Range(1 << 10, 16 << 20)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
+BENCHMARK(BM_SvpBufferRanges)
+        ->ArgNames({"range", "batched"})
+        ->ArgsProduct({{16, 256, 4 << 10, 64 << 10, 1 << 20, 4 << 20}, {0, 1}})
+        ->UseRealTime();
+BENCHMARK(BM_SvpKeyCheck)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK(BM_SvpBufferAllocFree)->Arg(1 << 20)->Arg(12 << 20)->ThreadRange(1, SABENCH_MAX_THREADS)->UseRealTime();
+BENCHMARK(BM_SvpBufferPoolAcquireRelease)
+        ->Arg(1 << 20)
+        ->Arg(12 << 20)
+        ->ThreadRange(1, SABENCH_MAX_THREADS)
+        ->UseRealTime();
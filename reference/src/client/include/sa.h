@@ -83,6 +83,109 @@ sa_status sa_get_name(
         char* name,
         size_t* name_length);
 
+/**
+ * Obtain the TA command statistics. The statistics include, for every command that has been
+ * invoked, the number of calls, the number of calls that returned each status code, the number of
+ * payload bytes and a latency histogram. Counters are cumulative from the start of the TA. See
+ * sa_stats_header for the layout of the snapshot.
+ *
+ * @param[out] stats Buffer where the statistics snapshot will be written. Can be set to NULL to
+ * obtain the required length.
+ * @param[in,out] stats_length Length of the stats buffer. Set to number of bytes required to
+ * store the snapshot if stats is NULL, or to the number of bytes written otherwise.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - stats_length is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - stats is not NULL and *stats_length value is smaller than required
+ * to store the snapshot.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_get_stats(
+        void* stats,
+        size_t* stats_length);
+
+/**
+ * Obtain the client side key header cache statistics. Key headers are immutable, so the client caches the header of
+ * a key on the first sa_key_header call and answers subsequent calls without invoking the TA. Counters are cumulative
+ * from the start of the process.
+ *
+ * @param[out] stats Cache statistics.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - stats is NULL.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ */
+sa_status sa_get_key_header_cache_stats(sa_key_header_cache_stats* stats);
+
+/**
+ * Switch the client to session pool mode. By default every thread opens its own TA session on its first SecApi call
+ * and closes it on thread exit, and handles are private to the thread that created them. In session pool mode,
+ * session_count sessions are opened up front and every thread is bound to one of them, round robin unless
+ * sa_session_pool_bind is called first. Threads bound to the same session share handles. Pool sessions stay open until
+ * the process exits. Setting the SA_SESSION_POOL_SIZE environment variable to the number of sessions has the same
+ * effect as calling this function before the first SecApi call.
+ *
+ * @param[in] session_count Number of sessions in the pool.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_INVALID_PARAMETER - session_count is 0 or larger than the implementation limit.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - A session pool or a per thread session already exists.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_session_pool_init(size_t session_count);
+
+/**
+ * Bind the calling thread to a session of the session pool, for example to keep threads that share handles or that
+ * run on the same core on the same session. Handles created by the thread on its previous session cannot be used
+ * after the thread is bound to a different one.
+ *
+ * @param[in] index Index of the pool session, smaller than the session_count passed to sa_session_pool_init.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_INVALID_PARAMETER - index is out of range.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - The client is not in session pool mode.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ */
+sa_status sa_session_pool_bind(size_t index);
+
+/**
+ * Enable or disable release coalescing. While enabled, sa_key_release, sa_crypto_cipher_release and
+ * sa_crypto_mac_release queue the release and return SA_STATUS_OK without calling into the TA. The queued releases of a
+ * thread are sent to the TA in a single command when the queue is full, before the next SecApi call of the thread that
+ * calls into the TA, when sa_flush_releases is called, when coalescing is disabled and when the thread exits. There is
+ * no time bound: the TA keeps the queued handles of a thread that makes no further SecApi calls allocated until the
+ * thread calls sa_flush_releases or exits. Disabling coalescing affects every thread, but only sends the calling
+ * thread's queue. A handle must not be used once it has been released, whether or not the release has been sent.
+ * Errors of queued releases are not returned by the release functions or by the call that sent them, they are kept and
+ * returned by the next sa_flush_releases or sa_coalesce_releases(false) of the thread. Setting the SA_COALESCE_RELEASES
+ * environment variable to 1 has the same effect as enabling coalescing before the first SecApi call.
+ *
+ * @param[in] enable Whether releases are queued.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ * + Any status returned by sa_flush_releases when enable is false.
+ */
+sa_status sa_coalesce_releases(bool enable);
+
+/**
+ * Send the releases queued by the calling thread to the TA. Returns once the TA has released every queued handle. The
+ * status covers every release of the thread sent since the previous sa_flush_releases, including the ones sent
+ * automatically before another SecApi call, and is then cleared.
+ *
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Every queued release succeeded, or no release was queued.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ * + Otherwise, the status of the first queued release that failed, for example SA_STATUS_INVALID_PARAMETER if the
+ * handle was not valid.
+ */
+sa_status sa_flush_releases();
+
 /**
  * Obtain the device ID. ID will be formatted according to the "SOC Identifier Specification"
  * specification.
@@ -48,6 +48,27 @@ sa_status sa_crypto_random(
         void* out,
         size_t length);
 
+/**
+ * Fill a memory buffer with random data served from a per thread buffer of TA generated random bytes. The buffer is
+ * refilled from sa_crypto_random in large blocks, so small requests such as nonces do not cost a call into the TA
+ * each. Bytes are handed out exactly once and are wiped from the buffer when they are handed out. The buffer is
+ * discarded in the child after a fork. Requests larger than the buffering threshold are forwarded to
+ * sa_crypto_random. Use sa_crypto_random directly when every request must be generated by the TA at the time of the
+ * call.
+ *
+ * @param[out] out Destination buffer.
+ * @param[in] length Number of bytes to write.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - out is NULL.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_crypto_random_buffered(
+        void* out,
+        size_t length);
+
 /**
  * Initialize the cipher context.
  *
@@ -183,6 +183,45 @@ sa_status sa_key_unwrap(
         const void* in,
         size_t in_length);
 
+/**
+ * Unwrap multiple symmetric keys wrapped with the same key in a single call. This is equivalent to calling
+ * sa_key_unwrap with SA_KEY_TYPE_SYMMETRIC once per entry, but the wrapping key is only loaded and scheduled once for
+ * the whole batch, which is the common case for license responses carrying many content keys. If any key fails to
+ * unwrap, no keys are returned.
+ *
+ * @param[in,out] entries Per key rights, wrapped key and algorithm parameters. Unwrapped key handles are returned in
+ * the key field of each entry.
+ * @param[in] entries_length Number of entries.
+ * @param[in] cipher_algorithm Wrapping algorithm. SA_CIPHER_ALGORITHM_AES_ECB, SA_CIPHER_ALGORITHM_AES_ECB_PKCS7,
+ * SA_CIPHER_ALGORITHM_AES_CBC, SA_CIPHER_ALGORITHM_AES_CBC_PKCS7, SA_CIPHER_ALGORITHM_AES_CTR and
+ * SA_CIPHER_ALGORITHM_AES_GCM are supported.
+ * @param[in] wrapping_key Wrapping key.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - There are no available key slots.
+ * + SA_STATUS_INVALID_KEY_FORMAT - Input data failed the format validation.
+ * + SA_STATUS_INVALID_KEY_TYPE - Wrapping key type is not valid for the specified algorithm.
+ * + SA_STATUS_NULL_PARAMETER - entries, an entry's rights, in or algorithm_parameters (if required) is NULL.
+ * + SA_STATUS_INVALID_PARAMETER
+ *   + entries_length is 0.
+ *   + in_length is not valid for specified algorithm.
+ *   + Invalid algorithm.
+ *   + Invalid algorithm specific parameter value encountered.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - Wrapping key usage requirements are not met for the specified
+ * operation.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_VERIFICATION_FAILED
+ *   + Invalid padding value has been encountered.
+ *   + Tag verification has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_key_unwrap_batch(
+        sa_unwrap_batch_entry* entries,
+        size_t entries_length,
+        sa_cipher_algorithm cipher_algorithm,
+        sa_key wrapping_key);
+
 /**
  * Obtain the public component of an asymmetric key.
  * + Public keys are in the SubjectPublicKeyInfo format described in RFC 5280
@@ -242,6 +281,41 @@ sa_status sa_key_derive(
         sa_kdf_algorithm kdf_algorithm,
         void* parameters);
 
+/**
+ * Derive multiple symmetric keys from the same parent key in a single call. This is equivalent to calling
+ * sa_key_derive once per entry with the entry's rights and info value, but the parent key is only loaded once and
+ * the HKDF extract step is shared by all entries. If any key fails to derive, no keys are returned.
+ *
+ * @param[in,out] entries Per key rights and info (or other data) values. Derived key handles are returned in the key
+ * field of each entry.
+ * @param[in] entries_length Number of entries.
+ * @param[in] kdf_algorithm KDF algorithm. SA_KDF_ALGORITHM_HKDF, SA_KDF_ALGORITHM_CONCAT,
+ * SA_KDF_ALGORITHM_ANSI_X963 and SA_KDF_ALGORITHM_CMAC are supported.
+ * @param[in] parameters Algorithm specific parameters shared by all entries. Use sa_kdf_parameters_hkdf with
+ * SA_KDF_ALGORITHM_HKDF, sa_kdf_parameters_concat with SA_KDF_ALGORITHM_CONCAT,
+ * sa_kdf_parameters_ansi_x963 with SA_KDF_ALGORITHM_ANSI_X963, sa_kdf_parameters_cmac with SA_KDF_ALGORITHM_CMAC.
+ * The info (or other_data) fields of the parameters are ignored and the per entry values are used instead.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - There are no available key slots.
+ * + SA_STATUS_INVALID_KEY_TYPE - Key type is not valid for the specified operation.
+ * + SA_STATUS_NULL_PARAMETER - entries, an entry's rights, or parameters is NULL.
+ * + SA_STATUS_INVALID_PARAMETER
+ *   + entries_length is 0.
+ *   + Invalid algorithm value.
+ *   + Invalid algorithm specific parameter value encountered.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - Key usage requirements are not met for the specified
+ * operation.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_key_derive_batch(
+        sa_kdf_batch_entry* entries,
+        size_t entries_length,
+        sa_kdf_algorithm kdf_algorithm,
+        void* parameters);
+
 /**
  * Compute a shared secret using specified key exchange algorithm.
  *
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file sa_provider.h
+ *
+ * sa_provider implements an OpenSSL 3 provider that delegates its implementation to SecApi 3. It is the OpenSSL 3
+ * replacement for the engine in sa_engine.h. Algorithms are published through immutable dispatch tables, so once an
+ * algorithm has been fetched no locks are taken on the operation path.
+ *
+ * To use the provider, users must call sa_provider_load() on the library context that should expose it. Algorithms
+ * are fetched with the SA_PROVIDER_PROPERTY_QUERY property query. Fetches without a property query may select
+ * either this provider or the default provider, so loading the provider into its own OSSL_LIB_CTX is recommended.
+ * Once finished with the provider, users must call sa_provider_unload.
+ *
+ * For APIs that take an unsigned char* key parameter, a pointer to the sa_key value should be passed in. For
+ * asymmetric keys, sa_provider_load_private_key() should be called to wrap the sa_key in an EVP_PKEY. The sa_key
+ * remains owned by the caller and must outlive every EVP_PKEY and context created from it.
+ *
+ * *Examples:*
+ * *Encryption/Decryption (AES, CHACHA20)*
+ * sa_key key = // Load key into SecApi 3;
+ * OSSL_PROVIDER* provider = sa_provider_load(libctx);
+ * EVP_CIPHER* cipher = EVP_CIPHER_fetch(libctx, "AES-128-CBC", SA_PROVIDER_PROPERTY_QUERY);
+ * EVP_CIPHER_CTX* evp_cipher_ctx = EVP_CIPHER_CTX_new();
+ * EVP_CipherInit_ex2(evp_cipher_ctx, cipher, (const unsigned char*)&key, iv, 1, NULL); // 1 = enc, 0 = dec
+ * EVP_CipherUpdate(evp_cipher_ctx, encrypted_data, &length, data, data_length);
+ * EVP_CipherFinal(evp_cipher_ctx, encrypted_data + total_length, &length);
+ * EVP_CIPHER_CTX_free(evp_cipher_ctx);
+ * EVP_CIPHER_free(cipher);
+ * sa_provider_unload(provider);
+ *
+ * *Signing (RSA, EC, ED25519, ED448)*
+ * sa_key key = // Load key into SecApi 3;
+ * OSSL_PROVIDER* provider = sa_provider_load(libctx);
+ * EVP_PKEY* evp_pkey = sa_provider_load_private_key(libctx, key);
+ * EVP_MD_CTX* evp_md_ctx = EVP_MD_CTX_new();
+ * EVP_PKEY_CTX* evp_pkey_ctx;
+ * EVP_DigestSignInit_ex(evp_md_ctx, &evp_pkey_ctx, "SHA256", libctx, NULL, evp_pkey, NULL);
+ * EVP_PKEY_CTX_set_rsa_padding(evp_pkey_ctx, RSA_PKCS1_PSS_PADDING);
+ * EVP_DigestSignUpdate(evp_md_ctx, data, data_length);
+ * EVP_DigestSignFinal(evp_md_ctx, signature, &signature_length);
+ * EVP_MD_CTX_free(evp_md_ctx);
+ * EVP_PKEY_free(evp_pkey);
+ * sa_provider_unload(provider);
+ *
+ * *Decryption (RSA)*
+ * EVP_PKEY* evp_pkey = sa_provider_load_private_key(libctx, key);
+ * EVP_PKEY_CTX* evp_pkey_ctx = EVP_PKEY_CTX_new_from_pkey(libctx, evp_pkey, NULL);
+ * EVP_PKEY_decrypt_init(evp_pkey_ctx);
+ * EVP_PKEY_CTX_set_rsa_padding(evp_pkey_ctx, RSA_PKCS1_OAEP_PADDING);
+ * EVP_PKEY_decrypt(evp_pkey_ctx, decrypted_data, &decrypted_data_length, encrypted_data, encrypted_data_length);
+ * EVP_PKEY_CTX_free(evp_pkey_ctx);
+ * EVP_PKEY_free(evp_pkey);
+ *
+ * *Derivation (DH, EC, X25519, X448)*
+ * EVP_PKEY* evp_pkey = sa_provider_load_private_key(libctx, key);
+ * EVP_PKEY_CTX* evp_pkey_ctx = EVP_PKEY_CTX_new_from_pkey(libctx, evp_pkey, NULL);
+ * EVP_PKEY_derive_init(evp_pkey_ctx);
+ * EVP_PKEY_derive_set_peer(evp_pkey_ctx, other_public_key);
+ * EVP_PKEY_derive(evp_pkey_ctx, shared_secret, &shared_secret_length);
+ * sa_key shared_secret_key = *((sa_key*)shared_secret);
+ * EVP_PKEY_CTX_free(evp_pkey_ctx);
+ * EVP_PKEY_free(evp_pkey);
+ */
+
+#ifndef SA_PROVIDER_H
+#define SA_PROVIDER_H
+
+#include "sa.h"
+#include <openssl/opensslv.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+
+#include <openssl/evp.h>
+#include <openssl/provider.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name of the SecApi 3 provider. */
+#define SA_PROVIDER_NAME "secapi3"
+
+/** Property query that selects the algorithms implemented by the SecApi 3 provider. */
+#define SA_PROVIDER_PROPERTY_QUERY "provider=" SA_PROVIDER_NAME
+
+/** Key parameter holding the sa_key handle of a SecApi 3 provider key. Its type is an unsigned long. */
+#define OSSL_PKEY_PARAM_SA_KEY "sa-key"
+
+/**
+ * Loads the SecApi 3 provider into the library context. The default provider remains available as a fallback so that
+ * digests and public key operations keep working.
+ *
+ * @param[in] libctx the library context to load the provider into. NULL selects the default library context.
+ * @return the provider if successful or NULL if not.
+ */
+OSSL_PROVIDER* sa_provider_load(OSSL_LIB_CTX* libctx);
+
+/**
+ * Unloads the provider.
+ *
+ * @param[in] provider the provider to unload.
+ */
+void sa_provider_unload(OSSL_PROVIDER* provider);
+
+/**
+ * Wraps an asymmetric SecApi 3 key in an EVP_PKEY managed by the SecApi 3 provider. The key type is taken from the key
+ * header.
+ *
+ * @param[in] libctx the library context the provider was loaded into.
+ * @param[in] key the key to wrap.
+ * @return the EVP_PKEY if successful or NULL if not.
+ */
+EVP_PKEY* sa_provider_load_private_key(
+        OSSL_LIB_CTX* libctx,
+        sa_key key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif //SA_PROVIDER_H
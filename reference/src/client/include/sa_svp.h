@@ -199,6 +199,34 @@ sa_status sa_svp_buffer_copy(
         sa_svp_offset* offsets,
         size_t offsets_length);
 
+/**
+ * Perform many writes and copies into SVP buffers in a single call. An entry whose in is INVALID_HANDLE is equivalent
+ * to sa_svp_buffer_write from in, any other entry is equivalent to sa_svp_buffer_copy. This is intended for
+ * reassembling frames out of many small ranges, such as NAL units, where a call per buffer dominates the cost of the
+ * copies. Every range of every entry is validated before any data is moved, so nothing is written if the batch is
+ * rejected. Entries are applied in order. Ranges that are contiguous in both the source and the destination are
+ * merged, and large ranges are copied with non-temporal stores where the platform supports them.
+ *
+ * @param[in] in Source data of the writes. May be NULL if in_length is 0.
+ * @param[in] in_length The length of the source data.
+ * @param[in] entries Operations to perform.
+ * @param[in] entries_length Number of entries.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - entries or an entry's offsets is NULL, or in is NULL and in_length is not 0.
+ * + SA_STATUS_INVALID_PARAMETER - entries_length is 0 or an SVP buffer handle is invalid.
+ * + SA_STATUS_INVALID_SVP_BUFFER - Reading or writing past the end of a buffer detected, or SVP buffer is not fully
+ * contained withing SVP memory region.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_batch(
+        const void* in,
+        size_t in_length,
+        const sa_svp_batch_entry* entries,
+        size_t entries_length);
+
 /**
  * Perform a key check by decrypting input data with an AES ECB into restricted memory and comparing with reference
  * value. This operation allows validation of keys that cannot decrypt into non-SVP buffers.
@@ -255,6 +283,123 @@ sa_status sa_svp_buffer_check(
         const void* hash,
         size_t hash_length);
 
+/**
+ * Perform a buffer check over several ranges of a buffer in one call, for example the slices or planes of a decoded
+ * frame. Each range is digested separately and compared with its own hash. This function can only be called from
+ * another TA. Calls from the REE will return SA_STATUS_OPERATION_NOT_ALLOWED.
+ *
+ * @param[in] svp_buffer Buffer to hash.
+ * @param[in] ranges Ranges of the buffer to hash.
+ * @param[in] ranges_length Number of ranges.
+ * @param[in] digest_algorithm Digest algorithm to use.
+ * @param[in] hashes Hashes to compare against, one digest per range in the order of the ranges.
+ * @param[in] hashes_length Length of the hashes. Must be ranges_length times the digest length.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded. All ranges passed the check.
+ * + SA_STATUS_NULL_PARAMETER - ranges or hashes is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - A range is outside the buffer or hashes_length is invalid.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_INVALID_SVP_BUFFER - invalid SVP buffer.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_VERIFICATION_FAILED - The computed value of at least one range does not match the expected one.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_check_ranges(
+        sa_svp_buffer svp_buffer,
+        const sa_svp_range* ranges,
+        size_t ranges_length,
+        sa_digest_algorithm digest_algorithm,
+        const void* hashes,
+        size_t hashes_length);
+
+/**
+ * Create an SVP buffer pool. The pool hands out SVP buffers that are already registered with the TA, so that a media
+ * pipeline does not pay for sa_svp_memory_alloc, sa_svp_buffer_create, sa_svp_buffer_release, and sa_svp_memory_free
+ * on every frame. parameters->min_free buffers are created for each size class up front. SVP buffer handles belong to
+ * the TA session of the calling thread, so the pool must only be used from threads that share that session.
+ *
+ * @param[out] pool SVP buffer pool.
+ * @param[in] parameters Pool parameters.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - No available SVP slots.
+ * + SA_STATUS_NULL_PARAMETER - pool, parameters, or parameters->size_classes is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - Size classes are empty, zero, or not in ascending order, or max_free is less than
+ * min_free.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_pool_create(
+        sa_svp_buffer_pool** pool,
+        const sa_svp_buffer_pool_parameters* parameters);
+
+/**
+ * Obtain an SVP buffer of at least size bytes from the pool. The buffer is taken from the free buffers of the smallest
+ * size class that fits the request, or created if that class has none. The returned sa_buffer is set up as an SVP
+ * buffer with its offset cleared. The contents of a recycled buffer are not cleared.
+ *
+ * @param[out] buffer SVP buffer.
+ * @param[in] pool SVP buffer pool.
+ * @param[in] size Minimum size of the buffer in bytes.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - No available SVP slots.
+ * + SA_STATUS_NULL_PARAMETER - buffer or pool is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - size is larger than the largest size class.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_pool_acquire(
+        sa_buffer* buffer,
+        sa_svp_buffer_pool* pool,
+        size_t size);
+
+/**
+ * Return an SVP buffer obtained from sa_svp_buffer_pool_acquire to the pool. If its size class then holds more than
+ * max_free free buffers, the class shrinks back to min_free buffers.
+ *
+ * @param[in] pool SVP buffer pool.
+ * @param[in] svp_buffer SVP buffer handle.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - pool is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - svp_buffer was not obtained from this pool or was already returned.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_pool_release(
+        sa_svp_buffer_pool* pool,
+        sa_svp_buffer svp_buffer);
+
+/**
+ * Obtain the statistics of an SVP buffer pool.
+ *
+ * @param[out] stats Pool statistics.
+ * @param[in] pool SVP buffer pool.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - stats or pool is NULL.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ */
+sa_status sa_svp_buffer_pool_get_stats(
+        sa_svp_buffer_pool_stats* stats,
+        sa_svp_buffer_pool* pool);
+
+/**
+ * Destroy an SVP buffer pool. All buffers of the pool are freed, including buffers that have not been returned.
+ *
+ * @param[in] pool SVP buffer pool. NULL is ignored.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status sa_svp_buffer_pool_destroy(sa_svp_buffer_pool* pool);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,8 @@ extern "C" {
 #define CHACHA20_NONCE_LENGTH 12
 #define CHACHA20_TAG_LENGTH 16
 #define API_VERSION 1
+#define COMMAND_BATCH_PARAMS 4
+#define COMMAND_BATCH_ALIGNMENT 8
 
 /**
  * Command IDs of the SecApi 3 commands, used in the ta_invoke_command function.
@@ -78,7 +80,13 @@ typedef enum {
     SA_SVP_BUFFER_COPY,
     SA_SVP_KEY_CHECK,
     SA_SVP_BUFFER_CHECK,
-    SA_PROCESS_COMMON_ENCRYPTION
+    SA_PROCESS_COMMON_ENCRYPTION,
+    SA_KEY_DERIVE_BATCH,
+    SA_KEY_UNWRAP_BATCH,
+    SA_GET_STATS,
+    SA_SVP_BUFFER_BATCH,
+    SA_SVP_BUFFER_CHECK_RANGES,
+    SA_COMMAND_BATCH
 } SA_COMMAND_ID;
 
 /**
@@ -114,6 +122,14 @@ typedef struct {
     size_t name_length;
 } sa_get_name_s;
 
+// sa_get_stats
+// param[0] INOUT - sa_get_stats_s
+// param[1] OUT - stats
+typedef struct {
+    uint8_t api_version;
+    size_t stats_length;
+} sa_get_stats_s;
+
 // sa_get_device_id
 // param[0] INOUT - sa_get_device_id_s
 typedef struct {
@@ -209,6 +225,30 @@ typedef struct {
 
 typedef sa_unwrap_parameters_ec_elgamal sa_unwrap_parameters_ec_elgamal_s;
 
+// sa_key_unwrap_batch
+// param[0] INOUT - sa_key_unwrap_batch_s
+// param[1] INOUT - sa_unwrap_batch_entry_s[entries_length]
+// param[2] IN - wrapped keys and aad values referenced by the entries
+typedef struct {
+    uint8_t api_version;
+    uint32_t cipher_algorithm;
+    sa_key wrapping_key;
+    size_t entries_length;
+} sa_key_unwrap_batch_s;
+
+typedef struct {
+    sa_key key;
+    sa_rights rights;
+    size_t in_offset;
+    size_t in_length;
+    uint8_t iv[AES_BLOCK_SIZE]; // iv or ctr
+    size_t iv_length;
+    size_t aad_offset;
+    size_t aad_length;
+    uint8_t tag[MAX_GCM_TAG_LENGTH];
+    uint8_t tag_length;
+} sa_unwrap_batch_entry_s;
+
 // sa_key_get_public
 // param[0] INOUT - sa_key_get_public_s
 // param[1] OUT - out + out_length
@@ -264,6 +304,26 @@ typedef struct {
 
 typedef sa_kdf_parameters_netflix sa_kdf_parameters_netflix_s;
 
+// sa_key_derive_batch
+// param[0] INOUT - sa_key_derive_batch_s
+// param[1] IN - sa_kdf_parameters_hkdf_s or sa_kdf_parameters_concat_s or sa_kdf_parameters_ansi_x963_s or
+// sa_kdf_parameters_cmac_s
+// param[2] INOUT - sa_kdf_batch_entry_s[entries_length]
+// param[3] IN - salt followed by the info or other_data values referenced by the entries
+typedef struct {
+    uint8_t api_version;
+    uint32_t kdf_algorithm;
+    size_t entries_length;
+    size_t salt_length;
+} sa_key_derive_batch_s;
+
+typedef struct {
+    sa_key key;
+    sa_rights rights;
+    size_t info_offset;
+    size_t info_length;
+} sa_kdf_batch_entry_s;
+
 // sa_key_exchange
 // param[0] INOUT - sa_key_exchange_s
 // param[1] IN - other_public + other_public_length
@@ -469,6 +529,23 @@ typedef struct {
     sa_svp_buffer in;
 } sa_svp_buffer_copy_s;
 
+// sa_svp_buffer_batch
+// param[0] INOUT - sa_svp_buffer_batch_s
+// param[1] IN - sa_svp_batch_entry_s[entries_length]
+// param[2] IN - sa_svp_offset values referenced by the entries
+// param[3] IN - in + in_length
+typedef struct {
+    uint8_t api_version;
+    size_t entries_length;
+} sa_svp_buffer_batch_s;
+
+typedef struct {
+    sa_svp_buffer out;
+    sa_svp_buffer in;
+    size_t offsets_index;
+    size_t offsets_length;
+} sa_svp_batch_entry_s;
+
 // sa_svp_key_check
 // param[0] INOUT - sa_svp_key_check_s
 // param[1] IN - in
@@ -492,6 +569,16 @@ typedef struct {
     uint32_t digest_algorithm;
 } sa_svp_buffer_check_s;
 
+// sa_svp_buffer_check_ranges
+// param[0] IN - sa_svp_buffer_check_ranges_s
+// param[1] IN - sa_svp_range[]
+// param[2] IN - hashes+length
+typedef struct {
+    uint8_t api_version;
+    sa_svp_buffer svp_buffer;
+    uint32_t digest_algorithm;
+} sa_svp_buffer_check_ranges_s;
+
 // sa_process_common_encryption (1 sample per call)
 // param[0] INOUT - sa_process_common_encryption_s
 // param[1] IN - subsample_lengths
@@ -509,6 +596,24 @@ typedef struct {
     uint32_t in_buffer_type;
     size_t in_offset;
 } sa_process_common_encryption_s;
+
+// sa_command_batch
+// param[0] IN - sa_command_batch_s
+// param[1] IN - sa_command_batch_entry_s[commands_length]
+// param[2] INOUT - parameters of the sub-commands, each starting at a multiple of COMMAND_BATCH_ALIGNMENT
+// param[3] OUT - sa_status[commands_length]
+typedef struct {
+    uint8_t api_version;
+    size_t commands_length;
+} sa_command_batch_s;
+
+// A parameter with a param_sizes entry of 0 is passed to the sub-command as NULL.
+typedef struct {
+    uint32_t command_id;
+    size_t param_offsets[COMMAND_BATCH_PARAMS];
+    size_t param_sizes[COMMAND_BATCH_PARAMS];
+} sa_command_batch_entry_s;
+
 #ifdef __cplusplus
 }
 #endif
@@ -779,6 +779,24 @@ typedef struct {
     size_t key_length;
 } sa_unwrap_parameters_ec_elgamal;
 
+/**
+ * Per key parameters for sa_key_unwrap_batch.
+ */
+typedef struct {
+    /** Unwrapped key handle. Set on successful return. */
+    sa_key key;
+    /** Key rights to associate with the unwrapped key. */
+    const sa_rights* rights;
+    /** Wrapped key. */
+    const void* in;
+    /** Wrapped key length in bytes. */
+    size_t in_length;
+    /** Algorithm specific parameters. sa_unwrap_parameters_aes_cbc for SA_CIPHER_ALGORITHM_AES_CBC and
+     * SA_CIPHER_ALGORITHM_AES_CBC_PKCS7, sa_unwrap_parameters_aes_ctr for SA_CIPHER_ALGORITHM_AES_CTR,
+     * sa_unwrap_parameters_aes_gcm for SA_CIPHER_ALGORITHM_AES_GCM. NULL for the ECB algorithms. */
+    void* algorithm_parameters;
+} sa_unwrap_batch_entry;
+
 /**
  * Signature parameters for SA_SIGNATURE_ALGORITHM_RSA_PSS.
  */
@@ -914,6 +932,21 @@ typedef struct {
     sa_key khmac;
 } sa_kdf_parameters_netflix;
 
+/**
+ * Per key parameters for sa_key_derive_batch.
+ */
+typedef struct {
+    /** Derived key handle. Set on successful return. */
+    sa_key key;
+    /** Key rights to associate with the derived key. */
+    const sa_rights* rights;
+    /** Info value for SA_KDF_ALGORITHM_HKDF, SA_KDF_ALGORITHM_CONCAT and SA_KDF_ALGORITHM_ANSI_X963, other data
+     * value for SA_KDF_ALGORITHM_CMAC. */
+    const void* info;
+    /** Info length in bytes. */
+    size_t info_length;
+} sa_kdf_batch_entry;
+
 /**
  * Key exchange parameters for SA_KEY_EXCHANGE_ALGORITHM_NETFLIX_AUTHENTICATED_DH
  * (https://github.com/Netflix/msl/wiki/Authenticated-Diffie-Hellman-Key-Exchange).
@@ -946,6 +979,138 @@ typedef struct {
     size_t length;
 } sa_svp_offset;
 
+/**
+ * Per operation parameters for sa_svp_buffer_batch.
+ */
+typedef struct {
+    /** Destination SVP buffer. */
+    sa_svp_buffer out;
+    /** Source SVP buffer of a copy. INVALID_HANDLE if the operation writes from the clear input of the batch. */
+    sa_svp_buffer in;
+    /** Ranges to move from the source to the destination. */
+    const sa_svp_offset* offsets;
+    /** Number of ranges. */
+    size_t offsets_length;
+} sa_svp_batch_entry;
+
+/**
+ * Structure to use in sa_svp_buffer_check_ranges
+ */
+typedef struct {
+    // offset into the SVP buffer.
+    size_t offset;
+    // number of bytes to digest.
+    size_t length;
+} sa_svp_range;
+
+/**
+ * Opaque SVP buffer pool created with sa_svp_buffer_pool_create.
+ */
+typedef struct sa_svp_buffer_pool_s sa_svp_buffer_pool;
+
+/**
+ * SVP buffer pool parameters.
+ */
+typedef struct {
+    /** Buffer sizes in bytes, in ascending order. A request is served from the smallest class that fits it. */
+    const size_t* size_classes;
+    /** Number of size classes. */
+    size_t size_classes_length;
+    /** Number of free buffers created for each class when the pool is created, and kept when the pool shrinks. */
+    size_t min_free;
+    /** Number of free buffers a class can hold before it shrinks back to min_free. Must not be less than min_free. */
+    size_t max_free;
+} sa_svp_buffer_pool_parameters;
+
+/**
+ * SVP buffer pool statistics.
+ */
+typedef struct {
+    /** Number of buffers handed out. */
+    uint64_t acquires;
+    /** Number of buffers handed out from the free buffers of the pool. */
+    uint64_t hits;
+    /** Number of buffers that had to be created to serve a request. */
+    uint64_t misses;
+    /** Number of buffers returned to the pool. */
+    uint64_t releases;
+    /** Number of free buffers destroyed when the pool shrank. */
+    uint64_t shrinks;
+    /** Number of free buffers currently held by the pool. */
+    uint64_t free_buffers;
+    /** Number of buffers currently handed out. */
+    uint64_t in_use_buffers;
+} sa_svp_buffer_pool_stats;
+
+/** Version of the statistics snapshot layout returned by sa_get_stats. */
+#define SA_STATS_VERSION 1
+
+/**
+ * Header of the statistics snapshot returned by sa_get_stats.
+ *
+ * The header is followed by command_count records. Each record starts with an sa_stats_command
+ * structure, followed by status_count uint64_t counters holding the number of calls that returned
+ * each sa_status value, followed by bucket_count uint64_t counters holding the latency histogram.
+ * Calls, bytes and statuses are counted for every call. Latencies may be sampled, in which case only
+ * timed_calls calls contribute to the histogram.
+ *
+ * The histogram is log-linear. Latencies below 2^sub_bucket_bits ns each have their own bucket.
+ * Every power of two range above that is split into 2^sub_bucket_bits equally sized buckets. The
+ * lower bound of bucket i, with S = sub_bucket_bits, is i for i < 2^S, and otherwise
+ * (2^S + i % 2^S) << (i / 2^S - 1). Latencies beyond the last bucket are counted in the last bucket.
+ */
+typedef struct {
+    /** Snapshot layout version. Set to SA_STATS_VERSION. */
+    uint32_t version;
+    /** Length of this header in bytes. */
+    uint32_t header_length;
+    /** Number of command records following the header. */
+    uint32_t command_count;
+    /** Number of status counters in each command record. */
+    uint32_t status_count;
+    /** Number of histogram buckets in each command record. */
+    uint32_t bucket_count;
+    /** Number of bits used to split each power of two histogram range. */
+    uint32_t sub_bucket_bits;
+} sa_stats_header;
+
+/**
+ * Per command statistics record of the snapshot returned by sa_get_stats.
+ */
+typedef struct {
+    /** Command ID the record applies to. */
+    uint32_t command_id;
+    /** Length of the record in bytes, including the trailing status and histogram counters. */
+    uint32_t record_length;
+    /** Number of calls. */
+    uint64_t calls;
+    /** Number of sampled calls that were timed. total_ns, max_ns and the histogram cover these calls. */
+    uint64_t timed_calls;
+    /**
+     * Total size of the memory reference parameters passed to the command. Output parameters count
+     * their capacity. SA_COMMAND_BATCH counts none, its commands are recorded individually.
+     */
+    uint64_t param_bytes;
+    /** Total time spent in the timed calls in ns. */
+    uint64_t total_ns;
+    /** Longest time spent in a single timed call in ns. */
+    uint64_t max_ns;
+} sa_stats_command;
+
+/**
+ * Client side key header cache statistics returned by sa_get_key_header_cache_stats.
+ */
+typedef struct {
+    /** Number of sa_key_header calls answered from the cache. */
+    uint64_t hits;
+    /** Number of sa_key_header calls that required a call into the TA. */
+    uint64_t misses;
+    /** Number of headers stored in the cache. */
+    uint64_t inserts;
+    /** Number of cached headers dropped because their key was released or its handle reassigned. */
+    uint64_t invalidations;
+} sa_key_header_cache_stats;
+
 #ifdef __cplusplus
 }
 #endif
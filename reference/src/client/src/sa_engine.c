@@ -123,6 +123,7 @@ ENGINE* sa_get_engine() {
     if (ENGINE_init(engine) != 1) {
         ERROR("ENGINE_init failed");
         ENGINE_free(engine);
+        mtx_unlock(&engine_mutex);
         return NULL;
     }
 
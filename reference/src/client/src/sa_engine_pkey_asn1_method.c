@@ -157,6 +157,7 @@ int sa_get_engine_pkey_asn1_meths(
         sym_pkey_asn1_method = get_pkey_asn1_method(EVP_PKEY_SYM, EVP_PKEY_SYM_NAME);
 
     if (!method) {
+        mtx_unlock(&engine_mutex);
         if (nids == NULL)
             return 0;
 
@@ -0,0 +1,345 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "log.h"
+#include "sa_provider_internal.h"
+#include <openssl/core_names.h>
+#include <openssl/rsa.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define SA_PROVIDER_FULL_NAME "SecApi3 OpenSSL Provider"
+#define SA_PROVIDER_VERSION "3.1.2"
+
+// The algorithm tables are immutable. OpenSSL caches the implementations it fetches from them, so after the first
+// fetch an operation never comes back to the provider to look up its dispatch table.
+static const OSSL_ALGORITHM cipher_algorithms[] = {
+        {"AES-128-ECB", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_128_ecb_functions, NULL},
+        {"AES-256-ECB", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_256_ecb_functions, NULL},
+        {"AES-128-CBC", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_128_cbc_functions, NULL},
+        {"AES-256-CBC", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_256_cbc_functions, NULL},
+        {"AES-128-CTR", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_128_ctr_functions, NULL},
+        {"AES-256-CTR", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_256_ctr_functions, NULL},
+        {"AES-128-GCM", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_128_gcm_functions, NULL},
+        {"AES-256-GCM", SA_PROVIDER_PROPERTIES, sa_provider_cipher_aes_256_gcm_functions, NULL},
+        {"ChaCha20", SA_PROVIDER_PROPERTIES, sa_provider_cipher_chacha20_functions, NULL},
+        {"ChaCha20-Poly1305", SA_PROVIDER_PROPERTIES, sa_provider_cipher_chacha20_poly1305_functions, NULL},
+        {NULL, NULL, NULL, NULL}};
+
+static const OSSL_ALGORITHM keymgmt_algorithms[] = {
+        {"RSA", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_rsa_functions, NULL},
+        {"EC", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_ec_functions, NULL},
+        {"ED25519", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_ed25519_functions, NULL},
+        {"ED448", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_ed448_functions, NULL},
+        {"X25519", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_x25519_functions, NULL},
+        {"X448", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_x448_functions, NULL},
+        {"DH", SA_PROVIDER_PROPERTIES, sa_provider_keymgmt_dh_functions, NULL},
+        {NULL, NULL, NULL, NULL}};
+
+static const OSSL_ALGORITHM signature_algorithms[] = {
+        {"RSA", SA_PROVIDER_PROPERTIES, sa_provider_signature_functions, NULL},
+        {"ECDSA", SA_PROVIDER_PROPERTIES, sa_provider_signature_functions, NULL},
+        {"ED25519", SA_PROVIDER_PROPERTIES, sa_provider_signature_functions, NULL},
+        {"ED448", SA_PROVIDER_PROPERTIES, sa_provider_signature_functions, NULL},
+        {NULL, NULL, NULL, NULL}};
+
+static const OSSL_ALGORITHM asym_cipher_algorithms[] = {
+        {"RSA", SA_PROVIDER_PROPERTIES, sa_provider_asym_cipher_rsa_functions, NULL},
+        {NULL, NULL, NULL, NULL}};
+
+static const OSSL_ALGORITHM keyexch_algorithms[] = {
+        {"ECDH", SA_PROVIDER_PROPERTIES, sa_provider_keyexch_functions, NULL},
+        {"X25519", SA_PROVIDER_PROPERTIES, sa_provider_keyexch_functions, NULL},
+        {"X448", SA_PROVIDER_PROPERTIES, sa_provider_keyexch_functions, NULL},
+        {"DH", SA_PROVIDER_PROPERTIES, sa_provider_keyexch_functions, NULL},
+        {NULL, NULL, NULL, NULL}};
+
+static const OSSL_PARAM provider_gettable_params[] = {
+        OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_NAME, NULL, 0),
+        OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_VERSION, NULL, 0),
+        OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_BUILDINFO, NULL, 0),
+        OSSL_PARAM_int(OSSL_PROV_PARAM_STATUS, NULL),
+        OSSL_PARAM_END};
+
+static const OSSL_ALGORITHM* provider_query_operation(
+        void* provctx,
+        int operation_id,
+        int* no_cache) {
+
+    *no_cache = 0;
+    switch (operation_id) {
+        case OSSL_OP_CIPHER:
+            return cipher_algorithms;
+
+        case OSSL_OP_KEYMGMT:
+            return keymgmt_algorithms;
+
+        case OSSL_OP_SIGNATURE:
+            return signature_algorithms;
+
+        case OSSL_OP_ASYM_CIPHER:
+            return asym_cipher_algorithms;
+
+        case OSSL_OP_KEYEXCH:
+            return keyexch_algorithms;
+
+        default:
+            return NULL;
+    }
+}
+
+static const OSSL_PARAM* provider_gettable_params_function(void* provctx) {
+    return provider_gettable_params;
+}
+
+static int provider_get_params(
+        void* provctx,
+        OSSL_PARAM params[]) {
+
+    OSSL_PARAM* param = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_NAME);
+    if (param != NULL && !OSSL_PARAM_set_utf8_ptr(param, SA_PROVIDER_FULL_NAME))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_VERSION);
+    if (param != NULL && !OSSL_PARAM_set_utf8_ptr(param, SA_PROVIDER_VERSION))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_BUILDINFO);
+    if (param != NULL && !OSSL_PARAM_set_utf8_ptr(param, OPENSSL_VERSION_TEXT))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_STATUS);
+    if (param != NULL && !OSSL_PARAM_set_int(param, 1))
+        return 0;
+
+    return 1;
+}
+
+static void provider_teardown(void* provctx) {
+    OPENSSL_free(provctx);
+}
+
+static const OSSL_DISPATCH provider_functions[] = {
+        {OSSL_FUNC_PROVIDER_TEARDOWN, (void (*)(void)) provider_teardown},
+        {OSSL_FUNC_PROVIDER_GETTABLE_PARAMS, (void (*)(void)) provider_gettable_params_function},
+        {OSSL_FUNC_PROVIDER_GET_PARAMS, (void (*)(void)) provider_get_params},
+        {OSSL_FUNC_PROVIDER_QUERY_OPERATION, (void (*)(void)) provider_query_operation},
+        {0, NULL}};
+
+static int provider_init(
+        const OSSL_CORE_HANDLE* handle,
+        const OSSL_DISPATCH* in,
+        const OSSL_DISPATCH** out,
+        void** provctx) {
+
+    OSSL_FUNC_core_get_libctx_fn* core_get_libctx = NULL;
+    for (; in->function_id != 0; in++) {
+        if (in->function_id == OSSL_FUNC_CORE_GET_LIBCTX)
+            core_get_libctx = OSSL_FUNC_core_get_libctx(in);
+    }
+
+    if (core_get_libctx == NULL) {
+        ERROR("NULL core_get_libctx");
+        return 0;
+    }
+
+    sa_provider_context* provider_context = OPENSSL_zalloc(sizeof(sa_provider_context));
+    if (provider_context == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return 0;
+    }
+
+    // The provider is built in to the application, so the core context is the library context it was loaded into.
+    provider_context->handle = handle;
+    provider_context->libctx = (OSSL_LIB_CTX*) core_get_libctx(handle);
+    *provctx = provider_context;
+    *out = provider_functions;
+    return 1;
+}
+
+sa_digest_algorithm sa_provider_get_digest_algorithm(const EVP_MD* evp_md) {
+    if (evp_md != NULL) {
+        if (EVP_MD_is_a(evp_md, "SHA1"))
+            return SA_DIGEST_ALGORITHM_SHA1;
+
+        if (EVP_MD_is_a(evp_md, "SHA256"))
+            return SA_DIGEST_ALGORITHM_SHA256;
+
+        if (EVP_MD_is_a(evp_md, "SHA384"))
+            return SA_DIGEST_ALGORITHM_SHA384;
+
+        if (EVP_MD_is_a(evp_md, "SHA512"))
+            return SA_DIGEST_ALGORITHM_SHA512;
+    }
+
+    return UINT32_MAX;
+}
+
+int sa_provider_set_digest(
+        EVP_MD** evp_md,
+        const sa_provider_context* provider_context,
+        const OSSL_PARAM* param) {
+
+    const char* name = NULL;
+    if (!OSSL_PARAM_get_utf8_string_ptr(param, &name)) {
+        ERROR("OSSL_PARAM_get_utf8_string_ptr failed");
+        return 0;
+    }
+
+    EVP_MD* new_evp_md = EVP_MD_fetch(provider_context->libctx, name, SA_PROVIDER_DELEGATE_PROPERTY_QUERY);
+    if (new_evp_md == NULL) {
+        ERROR("EVP_MD_fetch failed");
+        return 0;
+    }
+
+    EVP_MD_free(*evp_md);
+    *evp_md = new_evp_md;
+    return 1;
+}
+
+int sa_provider_get_padding_mode(
+        int* padding_mode,
+        const OSSL_PARAM* param) {
+
+    if (param->data_type == OSSL_PARAM_UTF8_STRING) {
+        if (param->data == NULL) {
+            ERROR("NULL data");
+            return 0;
+        }
+
+        if (strcmp(param->data, OSSL_PKEY_RSA_PAD_MODE_PKCSV15) == 0)
+            *padding_mode = RSA_PKCS1_PADDING;
+        else if (strcmp(param->data, OSSL_PKEY_RSA_PAD_MODE_OAEP) == 0)
+            *padding_mode = RSA_PKCS1_OAEP_PADDING;
+        else if (strcmp(param->data, OSSL_PKEY_RSA_PAD_MODE_PSS) == 0)
+            *padding_mode = RSA_PKCS1_PSS_PADDING;
+        else {
+            ERROR("Unknown padding mode");
+            return 0;
+        }
+
+        return 1;
+    }
+
+    if (!OSSL_PARAM_get_int(param, padding_mode)) {
+        ERROR("OSSL_PARAM_get_int failed");
+        return 0;
+    }
+
+    return 1;
+}
+
+OSSL_PROVIDER* sa_provider_load(OSSL_LIB_CTX* libctx) {
+    if (!OSSL_PROVIDER_available(libctx, SA_PROVIDER_NAME)) {
+        if (OSSL_PROVIDER_add_builtin(libctx, SA_PROVIDER_NAME, provider_init) != 1) {
+            ERROR("OSSL_PROVIDER_add_builtin failed");
+            return NULL;
+        }
+    }
+
+    // Keep the fallback providers so that digests and public key operations are still found.
+    OSSL_PROVIDER* provider = OSSL_PROVIDER_try_load(libctx, SA_PROVIDER_NAME, 1);
+    if (provider == NULL) {
+        ERROR("OSSL_PROVIDER_try_load failed");
+        return NULL;
+    }
+
+    return provider;
+}
+
+void sa_provider_unload(OSSL_PROVIDER* provider) {
+    if (provider != NULL)
+        OSSL_PROVIDER_unload(provider);
+}
+
+EVP_PKEY* sa_provider_load_private_key(
+        OSSL_LIB_CTX* libctx,
+        sa_key key) {
+
+    EVP_PKEY* evp_pkey = NULL;
+    EVP_PKEY_CTX* evp_pkey_ctx = NULL;
+    do {
+        sa_header header;
+        sa_status status = sa_key_header(&header, key);
+        if (status != SA_STATUS_OK) {
+            ERROR("sa_key_header failed %d", status);
+            break;
+        }
+
+        const char* name;
+        if (header.type == SA_KEY_TYPE_RSA) {
+            name = "RSA";
+        } else if (header.type == SA_KEY_TYPE_DH) {
+            name = "DH";
+        } else if (header.type == SA_KEY_TYPE_EC) {
+            switch (header.type_parameters.curve) {
+                case SA_ELLIPTIC_CURVE_ED25519:
+                    name = "ED25519";
+                    break;
+
+                case SA_ELLIPTIC_CURVE_ED448:
+                    name = "ED448";
+                    break;
+
+                case SA_ELLIPTIC_CURVE_X25519:
+                    name = "X25519";
+                    break;
+
+                case SA_ELLIPTIC_CURVE_X448:
+                    name = "X448";
+                    break;
+
+                default:
+                    name = "EC";
+            }
+        } else {
+            ERROR("Invalid key type");
+            break;
+        }
+
+        evp_pkey_ctx = EVP_PKEY_CTX_new_from_name(libctx, name, SA_PROVIDER_PROPERTY_QUERY);
+        if (evp_pkey_ctx == NULL) {
+            ERROR("EVP_PKEY_CTX_new_from_name failed");
+            break;
+        }
+
+        if (EVP_PKEY_fromdata_init(evp_pkey_ctx) != 1) {
+            ERROR("EVP_PKEY_fromdata_init failed");
+            break;
+        }
+
+        unsigned long handle = key;
+        OSSL_PARAM params[] = {
+                OSSL_PARAM_construct_ulong(OSSL_PKEY_PARAM_SA_KEY, &handle),
+                OSSL_PARAM_construct_end()};
+
+        if (EVP_PKEY_fromdata(evp_pkey_ctx, &evp_pkey, EVP_PKEY_KEYPAIR, params) != 1) {
+            ERROR("EVP_PKEY_fromdata failed");
+            evp_pkey = NULL;
+            break;
+        }
+    } while (false);
+
+    EVP_PKEY_CTX_free(evp_pkey_ctx);
+    return evp_pkey;
+}
+
+#endif
@@ -0,0 +1,371 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_internal.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "log.h"
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <openssl/rsa.h>
+#include <string.h>
+
+typedef struct {
+    sa_provider_context* provider_context;
+    sa_provider_key_data* key_data;
+    int padding_mode;
+    EVP_MD* oaep_md;
+    EVP_MD* mgf1_md;
+    unsigned char* oaep_label;
+    size_t oaep_label_length;
+} asym_cipher_context;
+
+static const OSSL_PARAM asym_cipher_gettable_ctx_params[] = {
+        OSSL_PARAM_int(OSSL_ASYM_CIPHER_PARAM_PAD_MODE, NULL),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_OAEP_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_MGF1_DIGEST, NULL, 0),
+        OSSL_PARAM_octet_ptr(OSSL_ASYM_CIPHER_PARAM_OAEP_LABEL, NULL, 0),
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM asym_cipher_settable_ctx_params[] = {
+        OSSL_PARAM_int(OSSL_ASYM_CIPHER_PARAM_PAD_MODE, NULL),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_OAEP_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_OAEP_DIGEST_PROPS, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_MGF1_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_ASYM_CIPHER_PARAM_MGF1_DIGEST_PROPS, NULL, 0),
+        OSSL_PARAM_octet_string(OSSL_ASYM_CIPHER_PARAM_OAEP_LABEL, NULL, 0),
+        OSSL_PARAM_END};
+
+static void* asym_cipher_newctx(void* provctx) {
+    asym_cipher_context* context = OPENSSL_zalloc(sizeof(asym_cipher_context));
+    if (context == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return NULL;
+    }
+
+    context->provider_context = provctx;
+    context->padding_mode = RSA_PKCS1_PADDING;
+    return context;
+}
+
+static void asym_cipher_freectx(void* vctx) {
+    asym_cipher_context* context = vctx;
+    if (context != NULL) {
+        EVP_MD_free(context->oaep_md);
+        EVP_MD_free(context->mgf1_md);
+        OPENSSL_free(context->oaep_label);
+        OPENSSL_free(context);
+    }
+}
+
+static void* asym_cipher_dupctx(void* vctx) {
+    asym_cipher_context* context = vctx;
+    asym_cipher_context* new_context = OPENSSL_memdup(context, sizeof(asym_cipher_context));
+    if (new_context == NULL) {
+        ERROR("OPENSSL_memdup failed");
+        return NULL;
+    }
+
+    if (new_context->oaep_md != NULL)
+        EVP_MD_up_ref(new_context->oaep_md);
+
+    if (new_context->mgf1_md != NULL)
+        EVP_MD_up_ref(new_context->mgf1_md);
+
+    if (context->oaep_label != NULL) {
+        new_context->oaep_label = OPENSSL_memdup(context->oaep_label, context->oaep_label_length);
+        if (new_context->oaep_label == NULL) {
+            ERROR("OPENSSL_memdup failed");
+            new_context->oaep_label_length = 0;
+            asym_cipher_freectx(new_context);
+            return NULL;
+        }
+    }
+
+    return new_context;
+}
+
+static int asym_cipher_set_ctx_params(
+        void* vctx,
+        const OSSL_PARAM params[]) {
+
+    asym_cipher_context* context = vctx;
+    if (params == NULL)
+        return 1;
+
+    const OSSL_PARAM* param = OSSL_PARAM_locate_const(params, OSSL_ASYM_CIPHER_PARAM_PAD_MODE);
+    if (param != NULL) {
+        int padding_mode;
+        if (!sa_provider_get_padding_mode(&padding_mode, param))
+            return 0;
+
+        if (padding_mode != RSA_PKCS1_PADDING && padding_mode != RSA_PKCS1_OAEP_PADDING) {
+            ERROR("Invalid padding mode");
+            return 0;
+        }
+
+        context->padding_mode = padding_mode;
+    }
+
+    param = OSSL_PARAM_locate_const(params, OSSL_ASYM_CIPHER_PARAM_OAEP_DIGEST);
+    if (param != NULL && !sa_provider_set_digest(&context->oaep_md, context->provider_context, param))
+        return 0;
+
+    param = OSSL_PARAM_locate_const(params, OSSL_ASYM_CIPHER_PARAM_MGF1_DIGEST);
+    if (param != NULL && !sa_provider_set_digest(&context->mgf1_md, context->provider_context, param))
+        return 0;
+
+    param = OSSL_PARAM_locate_const(params, OSSL_ASYM_CIPHER_PARAM_OAEP_LABEL);
+    if (param != NULL) {
+        void* label = NULL;
+        size_t label_length = 0;
+        if (!OSSL_PARAM_get_octet_string(param, &label, 0, &label_length)) {
+            ERROR("OSSL_PARAM_get_octet_string failed");
+            return 0;
+        }
+
+        OPENSSL_free(context->oaep_label);
+        context->oaep_label = label;
+        context->oaep_label_length = label_length;
+    }
+
+    return 1;
+}
+
+static const OSSL_PARAM* asym_cipher_settable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return asym_cipher_settable_ctx_params;
+}
+
+static int asym_cipher_get_ctx_params(
+        void* vctx,
+        OSSL_PARAM params[]) {
+
+    asym_cipher_context* context = vctx;
+    OSSL_PARAM* param = OSSL_PARAM_locate(params, OSSL_ASYM_CIPHER_PARAM_PAD_MODE);
+    if (param != NULL && !OSSL_PARAM_set_int(param, context->padding_mode))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_ASYM_CIPHER_PARAM_OAEP_DIGEST);
+    if (param != NULL && !OSSL_PARAM_set_utf8_string(param,
+                                 context->oaep_md == NULL ? "SHA1" : EVP_MD_get0_name(context->oaep_md)))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_ASYM_CIPHER_PARAM_MGF1_DIGEST);
+    if (param != NULL) {
+        const EVP_MD* mgf1_md = context->mgf1_md != NULL ? context->mgf1_md : context->oaep_md;
+        if (!OSSL_PARAM_set_utf8_string(param, mgf1_md == NULL ? "SHA1" : EVP_MD_get0_name(mgf1_md)))
+            return 0;
+    }
+
+    param = OSSL_PARAM_locate(params, OSSL_ASYM_CIPHER_PARAM_OAEP_LABEL);
+    if (param != NULL && !OSSL_PARAM_set_octet_ptr(param, context->oaep_label, context->oaep_label_length))
+        return 0;
+
+    return 1;
+}
+
+static const OSSL_PARAM* asym_cipher_gettable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return asym_cipher_gettable_ctx_params;
+}
+
+static int asym_cipher_init(
+        asym_cipher_context* context,
+        sa_provider_key_data* key_data,
+        bool decrypt,
+        const OSSL_PARAM params[]) {
+
+    if (key_data == NULL || key_data->type != EVP_PKEY_RSA) {
+        ERROR("Invalid key");
+        return 0;
+    }
+
+    if (decrypt ? key_data->private_key == INVALID_HANDLE : key_data->public_key == NULL) {
+        ERROR("Key can't be used for this operation");
+        return 0;
+    }
+
+    context->key_data = key_data;
+    return asym_cipher_set_ctx_params(context, params);
+}
+
+static int asym_cipher_encrypt_init(
+        void* vctx,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return asym_cipher_init(vctx, provkey, false, params);
+}
+
+static int asym_cipher_decrypt_init(
+        void* vctx,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return asym_cipher_init(vctx, provkey, true, params);
+}
+
+// Encryption only needs the public key, so it is handed to the providers that own it.
+static int asym_cipher_encrypt(
+        void* vctx,
+        unsigned char* out,
+        size_t* out_length,
+        size_t out_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    asym_cipher_context* context = vctx;
+    int result = 0;
+    EVP_PKEY_CTX* encrypt_pkey_ctx = NULL;
+    do {
+        encrypt_pkey_ctx = EVP_PKEY_CTX_new_from_pkey(context->provider_context->libctx,
+                context->key_data->public_key, SA_PROVIDER_DELEGATE_PROPERTY_QUERY);
+        if (encrypt_pkey_ctx == NULL) {
+            ERROR("EVP_PKEY_CTX_new_from_pkey failed");
+            break;
+        }
+
+        if (EVP_PKEY_encrypt_init(encrypt_pkey_ctx) != 1) {
+            ERROR("EVP_PKEY_encrypt_init failed");
+            break;
+        }
+
+        if (EVP_PKEY_CTX_set_rsa_padding(encrypt_pkey_ctx, context->padding_mode) != 1) {
+            ERROR("EVP_PKEY_CTX_set_rsa_padding failed");
+            break;
+        }
+
+        if (context->padding_mode == RSA_PKCS1_OAEP_PADDING) {
+            if (context->oaep_md != NULL && EVP_PKEY_CTX_set_rsa_oaep_md(encrypt_pkey_ctx, context->oaep_md) != 1) {
+                ERROR("EVP_PKEY_CTX_set_rsa_oaep_md failed");
+                break;
+            }
+
+            const EVP_MD* mgf1_md = context->mgf1_md != NULL ? context->mgf1_md : context->oaep_md;
+            if (mgf1_md != NULL && EVP_PKEY_CTX_set_rsa_mgf1_md(encrypt_pkey_ctx, mgf1_md) != 1) {
+                ERROR("EVP_PKEY_CTX_set_rsa_mgf1_md failed");
+                break;
+            }
+
+            if (context->oaep_label != NULL) {
+                void* label = OPENSSL_memdup(context->oaep_label, context->oaep_label_length);
+                if (label == NULL) {
+                    ERROR("OPENSSL_memdup failed");
+                    break;
+                }
+
+                // EVP_PKEY_CTX_set0_rsa_oaep_label takes ownership of label.
+                if (EVP_PKEY_CTX_set0_rsa_oaep_label(encrypt_pkey_ctx, label, (int) context->oaep_label_length) != 1) {
+                    ERROR("EVP_PKEY_CTX_set0_rsa_oaep_label failed");
+                    OPENSSL_free(label);
+                    break;
+                }
+            }
+        }
+
+        *out_length = out_size;
+        if (EVP_PKEY_encrypt(encrypt_pkey_ctx, out, out_length, in, in_length) != 1) {
+            ERROR("EVP_PKEY_encrypt failed");
+            break;
+        }
+
+        result = 1;
+    } while (false);
+
+    EVP_PKEY_CTX_free(encrypt_pkey_ctx);
+    return result;
+}
+
+static int asym_cipher_decrypt(
+        void* vctx,
+        unsigned char* out,
+        size_t* out_length,
+        size_t out_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    asym_cipher_context* context = vctx;
+    const sa_provider_key_data* key_data = context->key_data;
+    if (out == NULL) {
+        *out_length = EVP_PKEY_get_size(key_data->public_key);
+        return 1;
+    }
+
+    sa_cipher_algorithm cipher_algorithm;
+    sa_cipher_parameters_rsa_oaep parameters_rsa_oaep;
+    void* parameters = NULL;
+    if (context->padding_mode == RSA_PKCS1_OAEP_PADDING) {
+        cipher_algorithm = SA_CIPHER_ALGORITHM_RSA_OAEP;
+        parameters_rsa_oaep.digest_algorithm = context->oaep_md == NULL ?
+                                                       SA_DIGEST_ALGORITHM_SHA1 :
+                                                       sa_provider_get_digest_algorithm(context->oaep_md);
+        const EVP_MD* mgf1_md = context->mgf1_md != NULL ? context->mgf1_md : context->oaep_md;
+        parameters_rsa_oaep.mgf1_digest_algorithm = mgf1_md == NULL ?
+                                                            SA_DIGEST_ALGORITHM_SHA1 :
+                                                            sa_provider_get_digest_algorithm(mgf1_md);
+        if (parameters_rsa_oaep.digest_algorithm == UINT32_MAX ||
+                parameters_rsa_oaep.mgf1_digest_algorithm == UINT32_MAX) {
+            ERROR("digest_algorithm unknown");
+            return 0;
+        }
+
+        parameters_rsa_oaep.label = context->oaep_label;
+        parameters_rsa_oaep.label_length = context->oaep_label_length;
+        parameters = &parameters_rsa_oaep;
+    } else {
+        cipher_algorithm = SA_CIPHER_ALGORITHM_RSA_PKCS1V15;
+    }
+
+    sa_crypto_cipher_context cipher_context = INVALID_HANDLE;
+    sa_status status = sa_crypto_cipher_init(&cipher_context, cipher_algorithm, SA_CIPHER_MODE_DECRYPT,
+            key_data->private_key, parameters);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_cipher_init failed %d", status);
+        return 0;
+    }
+
+    sa_buffer out_buffer = {SA_BUFFER_TYPE_CLEAR, {.clear = {out, out_size, 0}}};
+    sa_buffer in_buffer = {SA_BUFFER_TYPE_CLEAR, {.clear = {(void*) in, in_length, 0}}};
+    size_t length = in_length;
+    status = sa_crypto_cipher_process(&out_buffer, cipher_context, &in_buffer, &length);
+    sa_crypto_cipher_release(cipher_context);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_cipher_process failed %d", status);
+        return 0;
+    }
+
+    *out_length = length;
+    return 1;
+}
+
+const OSSL_DISPATCH sa_provider_asym_cipher_rsa_functions[] = {
+        {OSSL_FUNC_ASYM_CIPHER_NEWCTX, (void (*)(void)) asym_cipher_newctx},
+        {OSSL_FUNC_ASYM_CIPHER_FREECTX, (void (*)(void)) asym_cipher_freectx},
+        {OSSL_FUNC_ASYM_CIPHER_DUPCTX, (void (*)(void)) asym_cipher_dupctx},
+        {OSSL_FUNC_ASYM_CIPHER_ENCRYPT_INIT, (void (*)(void)) asym_cipher_encrypt_init},
+        {OSSL_FUNC_ASYM_CIPHER_ENCRYPT, (void (*)(void)) asym_cipher_encrypt},
+        {OSSL_FUNC_ASYM_CIPHER_DECRYPT_INIT, (void (*)(void)) asym_cipher_decrypt_init},
+        {OSSL_FUNC_ASYM_CIPHER_DECRYPT, (void (*)(void)) asym_cipher_decrypt},
+        {OSSL_FUNC_ASYM_CIPHER_GET_CTX_PARAMS, (void (*)(void)) asym_cipher_get_ctx_params},
+        {OSSL_FUNC_ASYM_CIPHER_GETTABLE_CTX_PARAMS, (void (*)(void)) asym_cipher_gettable_ctx_params_function},
+        {OSSL_FUNC_ASYM_CIPHER_SET_CTX_PARAMS, (void (*)(void)) asym_cipher_set_ctx_params},
+        {OSSL_FUNC_ASYM_CIPHER_SETTABLE_CTX_PARAMS, (void (*)(void)) asym_cipher_settable_ctx_params_function},
+        {0, NULL}};
+
+#endif
@@ -0,0 +1,589 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_internal.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "common.h"
+#include "log.h"
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <string.h>
+
+#define MAX_IV_LENGTH 16
+
+typedef struct {
+    sa_cipher_algorithm cipher_algorithm;
+    size_t key_length;
+    size_t block_size;
+    size_t iv_length;
+    unsigned int evp_mode;
+    bool aead;
+} cipher_info;
+
+typedef struct {
+    const cipher_info* info;
+    sa_cipher_mode mode;
+    bool key_set;
+    sa_key key;
+    size_t iv_length;
+    uint8_t iv[MAX_IV_LENGTH];
+    bool padding;
+    sa_crypto_cipher_context cipher_context;
+    size_t buffer_length;
+    uint8_t buffer[AES_BLOCK_SIZE];
+    size_t tag_length;
+    uint8_t tag[MAX_GCM_TAG_LENGTH];
+} cipher_context;
+
+static const OSSL_PARAM cipher_gettable_params[] = {
+        OSSL_PARAM_uint(OSSL_CIPHER_PARAM_MODE, NULL),
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_KEYLEN, NULL),
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_IVLEN, NULL),
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_BLOCK_SIZE, NULL),
+        OSSL_PARAM_int(OSSL_CIPHER_PARAM_AEAD, NULL),
+        OSSL_PARAM_int(OSSL_CIPHER_PARAM_CUSTOM_IV, NULL),
+        OSSL_PARAM_int(OSSL_CIPHER_PARAM_CTS, NULL),
+        OSSL_PARAM_int(OSSL_CIPHER_PARAM_TLS1_MULTIBLOCK, NULL),
+        OSSL_PARAM_int(OSSL_CIPHER_PARAM_HAS_RAND_KEY, NULL),
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM cipher_gettable_ctx_params[] = {
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_KEYLEN, NULL),
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_IVLEN, NULL),
+        OSSL_PARAM_uint(OSSL_CIPHER_PARAM_PADDING, NULL),
+        OSSL_PARAM_size_t(OSSL_CIPHER_PARAM_AEAD_TAGLEN, NULL),
+        OSSL_PARAM_octet_string(OSSL_CIPHER_PARAM_AEAD_TAG, NULL, 0),
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM cipher_settable_ctx_params[] = {
+        OSSL_PARAM_uint(OSSL_CIPHER_PARAM_PADDING, NULL),
+        OSSL_PARAM_octet_string(OSSL_CIPHER_PARAM_AEAD_TAG, NULL, 0),
+        OSSL_PARAM_END};
+
+static void* cipher_newctx(
+        void* provctx,
+        const cipher_info* info) {
+
+    cipher_context* context = OPENSSL_zalloc(sizeof(cipher_context));
+    if (context == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return NULL;
+    }
+
+    context->info = info;
+    context->key = INVALID_HANDLE;
+    context->iv_length = info->iv_length;
+    context->padding = info->block_size > 1;
+    context->cipher_context = INVALID_HANDLE;
+    context->tag_length = MAX_GCM_TAG_LENGTH;
+    return context;
+}
+
+static void cipher_reset(cipher_context* context) {
+    if (context->cipher_context != INVALID_HANDLE) {
+        sa_crypto_cipher_release(context->cipher_context);
+        context->cipher_context = INVALID_HANDLE;
+    }
+
+    context->buffer_length = 0;
+}
+
+static void cipher_freectx(void* vctx) {
+    cipher_context* context = vctx;
+    if (context != NULL) {
+        cipher_reset(context);
+        OPENSSL_clear_free(context, sizeof(cipher_context));
+    }
+}
+
+static int cipher_get_params(
+        const cipher_info* info,
+        OSSL_PARAM params[]) {
+
+    OSSL_PARAM* param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_MODE);
+    if (param != NULL && !OSSL_PARAM_set_uint(param, info->evp_mode))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_KEYLEN);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, info->key_length))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_IVLEN);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, info->iv_length))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_BLOCK_SIZE);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, info->block_size))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_AEAD);
+    if (param != NULL && !OSSL_PARAM_set_int(param, info->aead))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_CUSTOM_IV);
+    if (param != NULL && !OSSL_PARAM_set_int(param, info->aead))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_CTS);
+    if (param != NULL && !OSSL_PARAM_set_int(param, 0))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_TLS1_MULTIBLOCK);
+    if (param != NULL && !OSSL_PARAM_set_int(param, 0))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_HAS_RAND_KEY);
+    if (param != NULL && !OSSL_PARAM_set_int(param, 0))
+        return 0;
+
+    return 1;
+}
+
+static const OSSL_PARAM* cipher_gettable_params_function(void* provctx) {
+    return cipher_gettable_params;
+}
+
+static int cipher_get_ctx_params(
+        void* vctx,
+        OSSL_PARAM params[]) {
+
+    cipher_context* context = vctx;
+    OSSL_PARAM* param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_KEYLEN);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, context->info->key_length))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_IVLEN);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, context->iv_length))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_PADDING);
+    if (param != NULL && !OSSL_PARAM_set_uint(param, context->padding))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_AEAD_TAGLEN);
+    if (param != NULL && !OSSL_PARAM_set_size_t(param, context->tag_length))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_CIPHER_PARAM_AEAD_TAG);
+    if (param != NULL) {
+        if (!context->info->aead || context->mode != SA_CIPHER_MODE_ENCRYPT) {
+            ERROR("Tag is only available after an AEAD encryption");
+            return 0;
+        }
+
+        if (param->data_type != OSSL_PARAM_OCTET_STRING || param->data_size == 0 ||
+                param->data_size > MAX_GCM_TAG_LENGTH) {
+            ERROR("Invalid tag length");
+            return 0;
+        }
+
+        memcpy(param->data, context->tag, param->data_size);
+        param->return_size = param->data_size;
+    }
+
+    return 1;
+}
+
+static const OSSL_PARAM* cipher_gettable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return cipher_gettable_ctx_params;
+}
+
+static int cipher_set_ctx_params(
+        void* vctx,
+        const OSSL_PARAM params[]) {
+
+    cipher_context* context = vctx;
+    const OSSL_PARAM* param = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_PADDING);
+    if (param != NULL) {
+        unsigned int padding;
+        if (!OSSL_PARAM_get_uint(param, &padding)) {
+            ERROR("OSSL_PARAM_get_uint failed");
+            return 0;
+        }
+
+        if (context->cipher_context != INVALID_HANDLE && (padding != 0) != context->padding) {
+            ERROR("Padding can't be changed once processing has started");
+            return 0;
+        }
+
+        // Padding only applies to the block modes.
+        context->padding = padding != 0 && context->info->block_size > 1;
+    }
+
+    param = OSSL_PARAM_locate_const(params, OSSL_CIPHER_PARAM_AEAD_TAG);
+    if (param != NULL) {
+        if (!context->info->aead) {
+            ERROR("Tag is only supported by AEAD ciphers");
+            return 0;
+        }
+
+        size_t tag_length = 0;
+        void* tag = context->tag;
+        if (!OSSL_PARAM_get_octet_string(param, &tag, MAX_GCM_TAG_LENGTH, &tag_length) || tag_length == 0) {
+            ERROR("OSSL_PARAM_get_octet_string failed");
+            return 0;
+        }
+
+        context->tag_length = tag_length;
+    }
+
+    return 1;
+}
+
+static const OSSL_PARAM* cipher_settable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return cipher_settable_ctx_params;
+}
+
+static int cipher_init(
+        cipher_context* context,
+        sa_cipher_mode mode,
+        const unsigned char* key,
+        size_t key_length,
+        const unsigned char* iv,
+        size_t iv_length,
+        const OSSL_PARAM params[]) {
+
+    cipher_reset(context);
+    context->mode = mode;
+    if (key != NULL) {
+        // The key buffer holds an sa_key handle, not key bytes.
+        sa_key handle = *((const sa_key*) key);
+        sa_header header;
+        sa_status status = sa_key_header(&header, handle);
+        if (status != SA_STATUS_OK) {
+            ERROR("sa_key_header failed %d", status);
+            return 0;
+        }
+
+        if (header.size != context->info->key_length) {
+            ERROR("Key size mismatch for algorithm");
+            return 0;
+        }
+
+        context->key = handle;
+        context->key_set = true;
+    }
+
+    if (iv != NULL) {
+        if (iv_length != context->info->iv_length) {
+            ERROR("Invalid iv_length");
+            return 0;
+        }
+
+        memcpy(context->iv, iv, iv_length);
+        context->iv_length = iv_length;
+    }
+
+    return cipher_set_ctx_params(context, params);
+}
+
+static int cipher_encrypt_init(
+        void* vctx,
+        const unsigned char* key,
+        size_t key_length,
+        const unsigned char* iv,
+        size_t iv_length,
+        const OSSL_PARAM params[]) {
+    return cipher_init(vctx, SA_CIPHER_MODE_ENCRYPT, key, key_length, iv, iv_length, params);
+}
+
+static int cipher_decrypt_init(
+        void* vctx,
+        const unsigned char* key,
+        size_t key_length,
+        const unsigned char* iv,
+        size_t iv_length,
+        const OSSL_PARAM params[]) {
+    return cipher_init(vctx, SA_CIPHER_MODE_DECRYPT, key, key_length, iv, iv_length, params);
+}
+
+// The SecApi 3 cipher context is created on the first update because AEAD ciphers take the AAD as an init
+// parameter. The AAD therefore has to be supplied in a single update before any data.
+static int cipher_start(
+        cipher_context* context,
+        const void* aad,
+        size_t aad_length) {
+
+    if (context->cipher_context != INVALID_HANDLE)
+        return 1;
+
+    if (!context->key_set) {
+        ERROR("Key not set");
+        return 0;
+    }
+
+    sa_cipher_algorithm cipher_algorithm = context->info->cipher_algorithm;
+    sa_cipher_parameters_aes_cbc parameters_aes_cbc;
+    sa_cipher_parameters_aes_ctr parameters_aes_ctr;
+    sa_cipher_parameters_chacha20 parameters_chacha20;
+    sa_cipher_parameters_aes_gcm parameters_aes_gcm;
+    sa_cipher_parameters_chacha20_poly1305 parameters_chacha20_poly1305;
+    void* parameters;
+    switch (cipher_algorithm) {
+        case SA_CIPHER_ALGORITHM_AES_ECB:
+            if (context->padding)
+                cipher_algorithm = SA_CIPHER_ALGORITHM_AES_ECB_PKCS7;
+
+            parameters = NULL;
+            break;
+
+        case SA_CIPHER_ALGORITHM_AES_CBC:
+            if (context->padding)
+                cipher_algorithm = SA_CIPHER_ALGORITHM_AES_CBC_PKCS7;
+
+            parameters_aes_cbc.iv = context->iv;
+            parameters_aes_cbc.iv_length = context->iv_length;
+            parameters = &parameters_aes_cbc;
+            break;
+
+        case SA_CIPHER_ALGORITHM_AES_CTR:
+            parameters_aes_ctr.ctr = context->iv;
+            parameters_aes_ctr.ctr_length = context->iv_length;
+            parameters = &parameters_aes_ctr;
+            break;
+
+        case SA_CIPHER_ALGORITHM_CHACHA20:
+            parameters_chacha20.counter = context->iv;
+            parameters_chacha20.counter_length = CHACHA20_COUNTER_LENGTH;
+            parameters_chacha20.nonce = context->iv + CHACHA20_COUNTER_LENGTH;
+            parameters_chacha20.nonce_length = CHACHA20_NONCE_LENGTH;
+            parameters = &parameters_chacha20;
+            break;
+
+        case SA_CIPHER_ALGORITHM_AES_GCM:
+            parameters_aes_gcm.iv = context->iv;
+            parameters_aes_gcm.iv_length = context->iv_length;
+            parameters_aes_gcm.aad = aad;
+            parameters_aes_gcm.aad_length = aad_length;
+            parameters = &parameters_aes_gcm;
+            break;
+
+        case SA_CIPHER_ALGORITHM_CHACHA20_POLY1305:
+            parameters_chacha20_poly1305.nonce = context->iv;
+            parameters_chacha20_poly1305.nonce_length = context->iv_length;
+            parameters_chacha20_poly1305.aad = aad;
+            parameters_chacha20_poly1305.aad_length = aad_length;
+            parameters = &parameters_chacha20_poly1305;
+            break;
+
+        default:
+            ERROR("Unknown cipher algorithm");
+            return 0;
+    }
+
+    sa_status status = sa_crypto_cipher_init(&context->cipher_context, cipher_algorithm, context->mode, context->key,
+            parameters);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_cipher_init failed %d", status);
+        context->cipher_context = INVALID_HANDLE;
+        return 0;
+    }
+
+    return 1;
+}
+
+static int cipher_process(
+        cipher_context* context,
+        unsigned char* out,
+        size_t* written,
+        size_t out_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    if (*written + in_length > out_size) {
+        ERROR("Output buffer too small");
+        return 0;
+    }
+
+    sa_buffer out_buffer = {SA_BUFFER_TYPE_CLEAR, {.clear = {out + *written, in_length, 0}}};
+    sa_buffer in_buffer = {SA_BUFFER_TYPE_CLEAR, {.clear = {(void*) in, in_length, 0}}};
+    size_t bytes_to_process = in_length;
+    sa_status status = sa_crypto_cipher_process(&out_buffer, context->cipher_context, &in_buffer, &bytes_to_process);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_cipher_process failed %d", status);
+        return 0;
+    }
+
+    *written += bytes_to_process;
+    return 1;
+}
+
+static int cipher_update(
+        void* vctx,
+        unsigned char* out,
+        size_t* out_length,
+        size_t out_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    cipher_context* context = vctx;
+    if (out == NULL) {
+        // AAD
+        if (!context->info->aead || context->cipher_context != INVALID_HANDLE) {
+            ERROR("AAD must be supplied in one update before any data");
+            return 0;
+        }
+
+        if (!cipher_start(context, in, in_length))
+            return 0;
+
+        *out_length = in_length;
+        return 1;
+    }
+
+    if (!cipher_start(context, NULL, 0))
+        return 0;
+
+    size_t written = 0;
+    if (context->info->block_size == 1) {
+        if (in_length > 0 && !cipher_process(context, out, &written, out_size, in, in_length))
+            return 0;
+
+        *out_length = written;
+        return 1;
+    }
+
+    // Block modes only process whole blocks. A padded decryption holds back the last block for the final call,
+    // which strips the padding.
+    bool hold_back = context->padding && context->mode == SA_CIPHER_MODE_DECRYPT;
+    if (context->buffer_length > 0) {
+        size_t fill = AES_BLOCK_SIZE - context->buffer_length;
+        if (fill > in_length)
+            fill = in_length;
+
+        memcpy(context->buffer + context->buffer_length, in, fill);
+        context->buffer_length += fill;
+        in += fill;
+        in_length -= fill;
+        if (context->buffer_length == AES_BLOCK_SIZE && (in_length > 0 || !hold_back)) {
+            if (!cipher_process(context, out, &written, out_size, context->buffer, AES_BLOCK_SIZE))
+                return 0;
+
+            context->buffer_length = 0;
+        }
+    }
+
+    size_t blocks_length = in_length - in_length % AES_BLOCK_SIZE;
+    if (hold_back && blocks_length == in_length && blocks_length > 0)
+        blocks_length -= AES_BLOCK_SIZE;
+
+    if (blocks_length > 0) {
+        if (!cipher_process(context, out, &written, out_size, in, blocks_length))
+            return 0;
+
+        in += blocks_length;
+        in_length -= blocks_length;
+    }
+
+    memcpy(context->buffer + context->buffer_length, in, in_length);
+    context->buffer_length += in_length;
+    *out_length = written;
+    return 1;
+}
+
+static int cipher_final(
+        void* vctx,
+        unsigned char* out,
+        size_t* out_length,
+        size_t out_size) {
+
+    cipher_context* context = vctx;
+    if (!cipher_start(context, NULL, 0))
+        return 0;
+
+    *out_length = 0;
+    if (context->info->block_size > 1 && !context->padding) {
+        if (context->buffer_length != 0) {
+            ERROR("Data is not a multiple of the block size");
+            return 0;
+        }
+
+        return 1;
+    }
+
+    if (!context->padding && !context->info->aead)
+        return 1;
+
+    uint8_t empty;
+    sa_buffer out_buffer = {SA_BUFFER_TYPE_CLEAR, {.clear = {out, out_size, 0}}};
+    sa_buffer in_buffer = {SA_BUFFER_TYPE_CLEAR,
+            {.clear = {context->padding ? context->buffer : &empty, context->buffer_length, 0}}};
+    size_t bytes_to_process = context->buffer_length;
+    sa_cipher_end_parameters_aes_gcm end_parameters = {context->tag, context->tag_length};
+    sa_status status = sa_crypto_cipher_process_last(&out_buffer, context->cipher_context, &in_buffer,
+            &bytes_to_process, context->info->aead ? &end_parameters : NULL);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_cipher_process_last failed %d", status);
+        return 0;
+    }
+
+    context->buffer_length = 0;
+    *out_length = bytes_to_process;
+    return 1;
+}
+
+#define CIPHER_FUNCTIONS(name) \
+    static void* cipher_newctx_##name(void* provctx) { \
+        return cipher_newctx(provctx, &cipher_info_##name); \
+    } \
+    static int cipher_get_params_##name(OSSL_PARAM params[]) { \
+        return cipher_get_params(&cipher_info_##name, params); \
+    } \
+    const OSSL_DISPATCH sa_provider_cipher_##name##_functions[] = { \
+            {OSSL_FUNC_CIPHER_NEWCTX, (void (*)(void)) cipher_newctx_##name}, \
+            {OSSL_FUNC_CIPHER_FREECTX, (void (*)(void)) cipher_freectx}, \
+            {OSSL_FUNC_CIPHER_ENCRYPT_INIT, (void (*)(void)) cipher_encrypt_init}, \
+            {OSSL_FUNC_CIPHER_DECRYPT_INIT, (void (*)(void)) cipher_decrypt_init}, \
+            {OSSL_FUNC_CIPHER_UPDATE, (void (*)(void)) cipher_update}, \
+            {OSSL_FUNC_CIPHER_FINAL, (void (*)(void)) cipher_final}, \
+            {OSSL_FUNC_CIPHER_GET_PARAMS, (void (*)(void)) cipher_get_params_##name}, \
+            {OSSL_FUNC_CIPHER_GETTABLE_PARAMS, (void (*)(void)) cipher_gettable_params_function}, \
+            {OSSL_FUNC_CIPHER_GET_CTX_PARAMS, (void (*)(void)) cipher_get_ctx_params}, \
+            {OSSL_FUNC_CIPHER_GETTABLE_CTX_PARAMS, (void (*)(void)) cipher_gettable_ctx_params_function}, \
+            {OSSL_FUNC_CIPHER_SET_CTX_PARAMS, (void (*)(void)) cipher_set_ctx_params}, \
+            {OSSL_FUNC_CIPHER_SETTABLE_CTX_PARAMS, (void (*)(void)) cipher_settable_ctx_params_function}, \
+            {0, NULL}};
+
+#define DECLARE_CIPHER(name, cipher_algorithm, key_length, block_size, iv_length, evp_mode, aead) \
+    static const cipher_info cipher_info_##name = {cipher_algorithm, key_length, block_size, iv_length, evp_mode, \
+            aead}; \
+    CIPHER_FUNCTIONS(name)
+
+// clang-format off
+DECLARE_CIPHER(aes_128_ecb, SA_CIPHER_ALGORITHM_AES_ECB, SYM_128_KEY_SIZE, AES_BLOCK_SIZE, 0, EVP_CIPH_ECB_MODE, false)
+DECLARE_CIPHER(aes_256_ecb, SA_CIPHER_ALGORITHM_AES_ECB, SYM_256_KEY_SIZE, AES_BLOCK_SIZE, 0, EVP_CIPH_ECB_MODE, false)
+DECLARE_CIPHER(aes_128_cbc, SA_CIPHER_ALGORITHM_AES_CBC, SYM_128_KEY_SIZE, AES_BLOCK_SIZE, AES_BLOCK_SIZE,
+    EVP_CIPH_CBC_MODE, false)
+DECLARE_CIPHER(aes_256_cbc, SA_CIPHER_ALGORITHM_AES_CBC, SYM_256_KEY_SIZE, AES_BLOCK_SIZE, AES_BLOCK_SIZE,
+    EVP_CIPH_CBC_MODE, false)
+DECLARE_CIPHER(aes_128_ctr, SA_CIPHER_ALGORITHM_AES_CTR, SYM_128_KEY_SIZE, 1, AES_BLOCK_SIZE, EVP_CIPH_CTR_MODE, false)
+DECLARE_CIPHER(aes_256_ctr, SA_CIPHER_ALGORITHM_AES_CTR, SYM_256_KEY_SIZE, 1, AES_BLOCK_SIZE, EVP_CIPH_CTR_MODE, false)
+DECLARE_CIPHER(aes_128_gcm, SA_CIPHER_ALGORITHM_AES_GCM, SYM_128_KEY_SIZE, 1, GCM_IV_LENGTH, EVP_CIPH_GCM_MODE, true)
+DECLARE_CIPHER(aes_256_gcm, SA_CIPHER_ALGORITHM_AES_GCM, SYM_256_KEY_SIZE, 1, GCM_IV_LENGTH, EVP_CIPH_GCM_MODE, true)
+DECLARE_CIPHER(chacha20, SA_CIPHER_ALGORITHM_CHACHA20, SYM_256_KEY_SIZE, 1,
+    CHACHA20_COUNTER_LENGTH + CHACHA20_NONCE_LENGTH, EVP_CIPH_STREAM_CIPHER, false)
+DECLARE_CIPHER(chacha20_poly1305, SA_CIPHER_ALGORITHM_CHACHA20_POLY1305, SYM_256_KEY_SIZE, 1, CHACHA20_NONCE_LENGTH,
+    EVP_CIPH_STREAM_CIPHER, true)
+// clang-format on
+
+#endif
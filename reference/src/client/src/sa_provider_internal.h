@@ -0,0 +1,121 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SA_PROVIDER_INTERNAL_H
+#define SA_PROVIDER_INTERNAL_H
+
+#include "sa_provider.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+
+#include "sa.h"
+#include "sa_public_key.h"
+#include <openssl/core_dispatch.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Property definition of every algorithm published by the provider. */
+#define SA_PROVIDER_PROPERTIES "provider=" SA_PROVIDER_NAME
+
+/** Property query used by the provider when it needs an algorithm from another provider. */
+#define SA_PROVIDER_DELEGATE_PROPERTY_QUERY "provider!=" SA_PROVIDER_NAME
+
+typedef struct {
+    const OSSL_CORE_HANDLE* handle;
+    OSSL_LIB_CTX* libctx;
+} sa_provider_context;
+
+/**
+ * Key data of the provider key management. A key either references a SecApi 3 private key, in which case
+ * public_key holds its public part, or only holds a public key imported from another provider (a peer key).
+ */
+typedef struct {
+    sa_provider_context* provider_context;
+    int type;
+    sa_key private_key;
+    sa_header header;
+    EVP_PKEY* public_key;
+} sa_provider_key_data;
+
+extern const OSSL_DISPATCH sa_provider_cipher_aes_128_ecb_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_256_ecb_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_128_cbc_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_256_cbc_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_128_ctr_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_256_ctr_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_128_gcm_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_aes_256_gcm_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_chacha20_functions[];
+extern const OSSL_DISPATCH sa_provider_cipher_chacha20_poly1305_functions[];
+
+extern const OSSL_DISPATCH sa_provider_keymgmt_rsa_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_ec_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_ed25519_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_ed448_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_x25519_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_x448_functions[];
+extern const OSSL_DISPATCH sa_provider_keymgmt_dh_functions[];
+
+extern const OSSL_DISPATCH sa_provider_signature_functions[];
+
+extern const OSSL_DISPATCH sa_provider_asym_cipher_rsa_functions[];
+
+extern const OSSL_DISPATCH sa_provider_keyexch_functions[];
+
+/**
+ * Returns the SecApi 3 digest algorithm matching an OpenSSL digest.
+ *
+ * @param[in] evp_md the OpenSSL digest.
+ * @return the digest algorithm or UINT32_MAX if the digest is not supported.
+ */
+sa_digest_algorithm sa_provider_get_digest_algorithm(const EVP_MD* evp_md);
+
+/**
+ * Fetches the digest named by a parameter from the providers other than the SecApi 3 provider and replaces the
+ * digest held in evp_md.
+ *
+ * @param[in,out] evp_md the digest to replace.
+ * @param[in] provider_context the provider context.
+ * @param[in] param the parameter holding the digest name.
+ * @return 1 if successful and 0 if not.
+ */
+int sa_provider_set_digest(
+        EVP_MD** evp_md,
+        const sa_provider_context* provider_context,
+        const OSSL_PARAM* param);
+
+/**
+ * Parses an RSA padding mode parameter. OpenSSL sends the padding mode either as an integer or as a name.
+ *
+ * @param[out] padding_mode the RSA padding mode.
+ * @param[in] param the parameter.
+ * @return 1 if successful and 0 if not.
+ */
+int sa_provider_get_padding_mode(
+        int* padding_mode,
+        const OSSL_PARAM* param);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif //SA_PROVIDER_INTERNAL_H
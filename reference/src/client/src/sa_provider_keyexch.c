@@ -0,0 +1,198 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_internal.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "log.h"
+#include "sa_rights.h"
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <openssl/x509.h>
+#include <string.h>
+
+typedef struct {
+    sa_provider_context* provider_context;
+    sa_provider_key_data* key_data;
+    EVP_PKEY* peer_key;
+} keyexch_context;
+
+static const OSSL_PARAM keyexch_settable_ctx_params[] = {
+        OSSL_PARAM_uint(OSSL_EXCHANGE_PARAM_PAD, NULL),
+        OSSL_PARAM_END};
+
+static void* keyexch_newctx(void* provctx) {
+    keyexch_context* context = OPENSSL_zalloc(sizeof(keyexch_context));
+    if (context == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return NULL;
+    }
+
+    context->provider_context = provctx;
+    return context;
+}
+
+static void keyexch_freectx(void* vctx) {
+    keyexch_context* context = vctx;
+    if (context != NULL) {
+        EVP_PKEY_free(context->peer_key);
+        OPENSSL_free(context);
+    }
+}
+
+static void* keyexch_dupctx(void* vctx) {
+    keyexch_context* context = vctx;
+    keyexch_context* new_context = OPENSSL_memdup(context, sizeof(keyexch_context));
+    if (new_context == NULL) {
+        ERROR("OPENSSL_memdup failed");
+        return NULL;
+    }
+
+    if (new_context->peer_key != NULL)
+        EVP_PKEY_up_ref(new_context->peer_key);
+
+    return new_context;
+}
+
+// The derived secret is always a SecApi 3 key, so padding of the shared secret has no meaning here.
+static int keyexch_set_ctx_params(
+        void* vctx,
+        const OSSL_PARAM params[]) {
+    return 1;
+}
+
+static const OSSL_PARAM* keyexch_settable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return keyexch_settable_ctx_params;
+}
+
+static int keyexch_init(
+        void* vctx,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+
+    keyexch_context* context = vctx;
+    sa_provider_key_data* key_data = provkey;
+    if (key_data == NULL || key_data->private_key == INVALID_HANDLE) {
+        ERROR("Invalid key");
+        return 0;
+    }
+
+    if (key_data->type != EVP_PKEY_DH && key_data->type != EVP_PKEY_EC && key_data->type != EVP_PKEY_X25519 &&
+            key_data->type != EVP_PKEY_X448) {
+        ERROR("Invalid key type for key exchange");
+        return 0;
+    }
+
+    context->key_data = key_data;
+    return keyexch_set_ctx_params(context, params);
+}
+
+static int keyexch_set_peer(
+        void* vctx,
+        void* provkey) {
+
+    keyexch_context* context = vctx;
+    const sa_provider_key_data* peer_data = provkey;
+    if (peer_data == NULL || peer_data->public_key == NULL) {
+        ERROR("Invalid peer key");
+        return 0;
+    }
+
+    if (peer_data->type != context->key_data->type) {
+        ERROR("Invalid peer key type");
+        return 0;
+    }
+
+    if (EVP_PKEY_up_ref(peer_data->public_key) != 1) {
+        ERROR("EVP_PKEY_up_ref failed");
+        return 0;
+    }
+
+    EVP_PKEY_free(context->peer_key);
+    context->peer_key = peer_data->public_key;
+    return 1;
+}
+
+// The secret is the handle of a new SecApi 3 key holding the shared secret. The caller owns the key.
+static int keyexch_derive(
+        void* vctx,
+        unsigned char* secret,
+        size_t* secret_length,
+        size_t secret_size) {
+
+    keyexch_context* context = vctx;
+    if (secret == NULL) {
+        *secret_length = sizeof(sa_key);
+        return 1;
+    }
+
+    if (secret_size < sizeof(sa_key)) {
+        ERROR("Secret buffer too small");
+        return 0;
+    }
+
+    if (context->peer_key == NULL) {
+        ERROR("NULL peer_key");
+        return 0;
+    }
+
+    sa_key_exchange_algorithm key_exchange_algorithm = context->key_data->type == EVP_PKEY_DH ?
+                                                               SA_KEY_EXCHANGE_ALGORITHM_DH :
+                                                               SA_KEY_EXCHANGE_ALGORITHM_ECDH;
+    int result = 0;
+    uint8_t* other_public = NULL;
+    do {
+        int other_public_length = i2d_PUBKEY(context->peer_key, &other_public);
+        if (other_public_length <= 0) {
+            ERROR("i2d_PUBKEY failed");
+            break;
+        }
+
+        sa_key shared_secret_key;
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        sa_status status = sa_key_exchange(&shared_secret_key, &rights, key_exchange_algorithm,
+                context->key_data->private_key, other_public, other_public_length, NULL);
+        if (status != SA_STATUS_OK) {
+            ERROR("sa_key_exchange failed %d", status);
+            break;
+        }
+
+        memcpy(secret, &shared_secret_key, sizeof(sa_key));
+        *secret_length = sizeof(sa_key);
+        result = 1;
+    } while (false);
+
+    OPENSSL_free(other_public);
+    return result;
+}
+
+const OSSL_DISPATCH sa_provider_keyexch_functions[] = {
+        {OSSL_FUNC_KEYEXCH_NEWCTX, (void (*)(void)) keyexch_newctx},
+        {OSSL_FUNC_KEYEXCH_FREECTX, (void (*)(void)) keyexch_freectx},
+        {OSSL_FUNC_KEYEXCH_DUPCTX, (void (*)(void)) keyexch_dupctx},
+        {OSSL_FUNC_KEYEXCH_INIT, (void (*)(void)) keyexch_init},
+        {OSSL_FUNC_KEYEXCH_SET_PEER, (void (*)(void)) keyexch_set_peer},
+        {OSSL_FUNC_KEYEXCH_DERIVE, (void (*)(void)) keyexch_derive},
+        {OSSL_FUNC_KEYEXCH_SET_CTX_PARAMS, (void (*)(void)) keyexch_set_ctx_params},
+        {OSSL_FUNC_KEYEXCH_SETTABLE_CTX_PARAMS, (void (*)(void)) keyexch_settable_ctx_params_function},
+        {0, NULL}};
+
+#endif
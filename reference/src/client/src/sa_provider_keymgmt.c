@@ -0,0 +1,364 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_internal.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "log.h"
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+
+#define KEYMGMT_PUBLIC_KEY_TYPES \
+    OSSL_PARAM_BN(OSSL_PKEY_PARAM_RSA_N, NULL, 0), \
+            OSSL_PARAM_BN(OSSL_PKEY_PARAM_RSA_E, NULL, 0), \
+            OSSL_PARAM_BN(OSSL_PKEY_PARAM_FFC_P, NULL, 0), \
+            OSSL_PARAM_BN(OSSL_PKEY_PARAM_FFC_Q, NULL, 0), \
+            OSSL_PARAM_BN(OSSL_PKEY_PARAM_FFC_G, NULL, 0), \
+            OSSL_PARAM_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, NULL, 0), \
+            OSSL_PARAM_octet_string(OSSL_PKEY_PARAM_PUB_KEY, NULL, 0)
+
+static const OSSL_PARAM keymgmt_import_types[] = {
+        OSSL_PARAM_ulong(OSSL_PKEY_PARAM_SA_KEY, NULL),
+        KEYMGMT_PUBLIC_KEY_TYPES,
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM keymgmt_export_types[] = {
+        KEYMGMT_PUBLIC_KEY_TYPES,
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM keymgmt_gettable_params[] = {
+        OSSL_PARAM_int(OSSL_PKEY_PARAM_BITS, NULL),
+        OSSL_PARAM_int(OSSL_PKEY_PARAM_SECURITY_BITS, NULL),
+        OSSL_PARAM_int(OSSL_PKEY_PARAM_MAX_SIZE, NULL),
+        OSSL_PARAM_utf8_string(OSSL_PKEY_PARAM_DEFAULT_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_PKEY_PARAM_MANDATORY_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, NULL, 0),
+        OSSL_PARAM_octet_string(OSSL_PKEY_PARAM_ENCODED_PUBLIC_KEY, NULL, 0),
+        OSSL_PARAM_END};
+
+static const char* keymgmt_get_name(int type) {
+    switch (type) {
+        case EVP_PKEY_RSA:
+            return "RSA";
+
+        case EVP_PKEY_EC:
+            return "EC";
+
+        case EVP_PKEY_ED25519:
+            return "ED25519";
+
+        case EVP_PKEY_ED448:
+            return "ED448";
+
+        case EVP_PKEY_X25519:
+            return "X25519";
+
+        case EVP_PKEY_X448:
+            return "X448";
+
+        case EVP_PKEY_DH:
+            return "DH";
+
+        default:
+            return NULL;
+    }
+}
+
+static bool keymgmt_header_matches(
+        int type,
+        const sa_header* header) {
+
+    switch (type) {
+        case EVP_PKEY_RSA:
+            return header->type == SA_KEY_TYPE_RSA;
+
+        case EVP_PKEY_DH:
+            return header->type == SA_KEY_TYPE_DH;
+
+        case EVP_PKEY_EC:
+            return header->type == SA_KEY_TYPE_EC && is_pcurve(header->type_parameters.curve);
+
+        case EVP_PKEY_ED25519:
+            return header->type == SA_KEY_TYPE_EC && header->type_parameters.curve == SA_ELLIPTIC_CURVE_ED25519;
+
+        case EVP_PKEY_ED448:
+            return header->type == SA_KEY_TYPE_EC && header->type_parameters.curve == SA_ELLIPTIC_CURVE_ED448;
+
+        case EVP_PKEY_X25519:
+            return header->type == SA_KEY_TYPE_EC && header->type_parameters.curve == SA_ELLIPTIC_CURVE_X25519;
+
+        case EVP_PKEY_X448:
+            return header->type == SA_KEY_TYPE_EC && header->type_parameters.curve == SA_ELLIPTIC_CURVE_X448;
+
+        default:
+            return false;
+    }
+}
+
+static void* keymgmt_new(
+        void* provctx,
+        int type) {
+
+    sa_provider_key_data* key_data = OPENSSL_zalloc(sizeof(sa_provider_key_data));
+    if (key_data == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return NULL;
+    }
+
+    key_data->provider_context = provctx;
+    key_data->type = type;
+    key_data->private_key = INVALID_HANDLE;
+    return key_data;
+}
+
+static void keymgmt_free(void* keydata) {
+    sa_provider_key_data* key_data = keydata;
+    if (key_data != NULL) {
+        // The sa_key is owned by the caller of sa_provider_load_private_key.
+        EVP_PKEY_free(key_data->public_key);
+        OPENSSL_free(key_data);
+    }
+}
+
+static int keymgmt_has(
+        const void* keydata,
+        int selection) {
+
+    const sa_provider_key_data* key_data = keydata;
+    if (key_data == NULL)
+        return 0;
+
+    if ((selection & OSSL_KEYMGMT_SELECT_PRIVATE_KEY) != 0 && key_data->private_key == INVALID_HANDLE)
+        return 0;
+
+    if ((selection & (OSSL_KEYMGMT_SELECT_PUBLIC_KEY | OSSL_KEYMGMT_SELECT_ALL_PARAMETERS)) != 0 &&
+            key_data->public_key == NULL)
+        return 0;
+
+    return 1;
+}
+
+static int keymgmt_import_private_key(
+        sa_provider_key_data* key_data,
+        const OSSL_PARAM* param) {
+
+    unsigned long handle;
+    if (!OSSL_PARAM_get_ulong(param, &handle)) {
+        ERROR("OSSL_PARAM_get_ulong failed");
+        return 0;
+    }
+
+    sa_header header;
+    sa_status status = sa_key_header(&header, handle);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_key_header failed %d", status);
+        return 0;
+    }
+
+    if (!keymgmt_header_matches(key_data->type, &header)) {
+        ERROR("Key type does not match the key management");
+        return 0;
+    }
+
+    EVP_PKEY* public_key = sa_get_public_key(handle);
+    if (public_key == NULL) {
+        ERROR("sa_get_public_key failed");
+        return 0;
+    }
+
+    EVP_PKEY_free(key_data->public_key);
+    key_data->public_key = public_key;
+    key_data->private_key = handle;
+    key_data->header = header;
+    return 1;
+}
+
+// A key without an sa_key parameter is a peer key exported from another provider. Only its public part is kept, in
+// a key owned by the other provider.
+static int keymgmt_import_public_key(
+        sa_provider_key_data* key_data,
+        int selection,
+        const OSSL_PARAM params[]) {
+
+    int result = 0;
+    EVP_PKEY_CTX* evp_pkey_ctx = NULL;
+    EVP_PKEY* public_key = NULL;
+    do {
+        evp_pkey_ctx = EVP_PKEY_CTX_new_from_name(key_data->provider_context->libctx,
+                keymgmt_get_name(key_data->type), SA_PROVIDER_DELEGATE_PROPERTY_QUERY);
+        if (evp_pkey_ctx == NULL) {
+            ERROR("EVP_PKEY_CTX_new_from_name failed");
+            break;
+        }
+
+        if (EVP_PKEY_fromdata_init(evp_pkey_ctx) != 1) {
+            ERROR("EVP_PKEY_fromdata_init failed");
+            break;
+        }
+
+        int public_selection = (selection & OSSL_KEYMGMT_SELECT_PUBLIC_KEY) != 0 ? EVP_PKEY_PUBLIC_KEY :
+                                                                                   EVP_PKEY_KEY_PARAMETERS;
+        if (EVP_PKEY_fromdata(evp_pkey_ctx, &public_key, public_selection, (OSSL_PARAM*) params) != 1) {
+            ERROR("EVP_PKEY_fromdata failed");
+            break;
+        }
+
+        EVP_PKEY_free(key_data->public_key);
+        key_data->public_key = public_key;
+        public_key = NULL;
+        result = 1;
+    } while (false);
+
+    EVP_PKEY_free(public_key);
+    EVP_PKEY_CTX_free(evp_pkey_ctx);
+    return result;
+}
+
+static int keymgmt_import(
+        void* keydata,
+        int selection,
+        const OSSL_PARAM params[]) {
+
+    sa_provider_key_data* key_data = keydata;
+    if (key_data == NULL) {
+        ERROR("NULL key_data");
+        return 0;
+    }
+
+    const OSSL_PARAM* param = OSSL_PARAM_locate_const(params, OSSL_PKEY_PARAM_SA_KEY);
+    if (param != NULL)
+        return keymgmt_import_private_key(key_data, param);
+
+    return keymgmt_import_public_key(key_data, selection, params);
+}
+
+static const OSSL_PARAM* keymgmt_import_types_function(int selection) {
+    return keymgmt_import_types;
+}
+
+static const OSSL_PARAM* keymgmt_export_types_function(int selection) {
+    return keymgmt_export_types;
+}
+
+// Only the public part of a key can leave the provider. This is what lets OpenSSL hand the public key to the default
+// provider for encoding. A request for the private key is refused rather than answered with the public part, so that
+// OpenSSL falls back to the operations of this provider instead of running a private key operation elsewhere.
+static int keymgmt_export(
+        void* keydata,
+        int selection,
+        OSSL_CALLBACK* callback,
+        void* callback_arg) {
+
+    sa_provider_key_data* key_data = keydata;
+    if (key_data == NULL || key_data->public_key == NULL) {
+        ERROR("NULL public_key");
+        return 0;
+    }
+
+    if ((selection & OSSL_KEYMGMT_SELECT_PRIVATE_KEY) != 0 && key_data->private_key != INVALID_HANDLE)
+        return 0;
+
+    int public_selection = (selection & OSSL_KEYMGMT_SELECT_KEYPAIR) != 0 ? EVP_PKEY_PUBLIC_KEY :
+                                                                            EVP_PKEY_KEY_PARAMETERS;
+    OSSL_PARAM* params = NULL;
+    if (EVP_PKEY_todata(key_data->public_key, public_selection, &params) != 1) {
+        ERROR("EVP_PKEY_todata failed");
+        return 0;
+    }
+
+    int result = callback(params, callback_arg);
+    OSSL_PARAM_free(params);
+    return result;
+}
+
+static int keymgmt_get_params(
+        void* keydata,
+        OSSL_PARAM params[]) {
+
+    sa_provider_key_data* key_data = keydata;
+    if (key_data == NULL || key_data->public_key == NULL) {
+        ERROR("NULL public_key");
+        return 0;
+    }
+
+    return EVP_PKEY_get_params(key_data->public_key, params);
+}
+
+static const OSSL_PARAM* keymgmt_gettable_params_function(void* provctx) {
+    return keymgmt_gettable_params;
+}
+
+static int keymgmt_match(
+        const void* keydata1,
+        const void* keydata2,
+        int selection) {
+
+    const sa_provider_key_data* key_data1 = keydata1;
+    const sa_provider_key_data* key_data2 = keydata2;
+    if (key_data1 == NULL || key_data2 == NULL || key_data1->public_key == NULL || key_data2->public_key == NULL)
+        return 0;
+
+    if ((selection & OSSL_KEYMGMT_SELECT_KEYPAIR) != 0)
+        return EVP_PKEY_eq(key_data1->public_key, key_data2->public_key) == 1;
+
+    if ((selection & OSSL_KEYMGMT_SELECT_ALL_PARAMETERS) != 0)
+        return EVP_PKEY_parameters_eq(key_data1->public_key, key_data2->public_key) == 1;
+
+    return 1;
+}
+
+static const char* keymgmt_ec_query_operation_name(int operation_id) {
+    switch (operation_id) {
+        case OSSL_OP_SIGNATURE:
+            return "ECDSA";
+
+        case OSSL_OP_KEYEXCH:
+            return "ECDH";
+
+        default:
+            return NULL;
+    }
+}
+
+#define KEYMGMT_FUNCTIONS(name, type, ...) \
+    static void* keymgmt_new_##name(void* provctx) { \
+        return keymgmt_new(provctx, type); \
+    } \
+    const OSSL_DISPATCH sa_provider_keymgmt_##name##_functions[] = { \
+            {OSSL_FUNC_KEYMGMT_NEW, (void (*)(void)) keymgmt_new_##name}, \
+            {OSSL_FUNC_KEYMGMT_FREE, (void (*)(void)) keymgmt_free}, \
+            {OSSL_FUNC_KEYMGMT_HAS, (void (*)(void)) keymgmt_has}, \
+            {OSSL_FUNC_KEYMGMT_IMPORT, (void (*)(void)) keymgmt_import}, \
+            {OSSL_FUNC_KEYMGMT_IMPORT_TYPES, (void (*)(void)) keymgmt_import_types_function}, \
+            {OSSL_FUNC_KEYMGMT_EXPORT, (void (*)(void)) keymgmt_export}, \
+            {OSSL_FUNC_KEYMGMT_EXPORT_TYPES, (void (*)(void)) keymgmt_export_types_function}, \
+            {OSSL_FUNC_KEYMGMT_GET_PARAMS, (void (*)(void)) keymgmt_get_params}, \
+            {OSSL_FUNC_KEYMGMT_GETTABLE_PARAMS, (void (*)(void)) keymgmt_gettable_params_function}, \
+            {OSSL_FUNC_KEYMGMT_MATCH, (void (*)(void)) keymgmt_match}, \
+            __VA_ARGS__ {0, NULL}};
+
+KEYMGMT_FUNCTIONS(rsa, EVP_PKEY_RSA)
+KEYMGMT_FUNCTIONS(ec, EVP_PKEY_EC,
+        {OSSL_FUNC_KEYMGMT_QUERY_OPERATION_NAME, (void (*)(void)) keymgmt_ec_query_operation_name}, )
+KEYMGMT_FUNCTIONS(ed25519, EVP_PKEY_ED25519)
+KEYMGMT_FUNCTIONS(ed448, EVP_PKEY_ED448)
+KEYMGMT_FUNCTIONS(x25519, EVP_PKEY_X25519)
+KEYMGMT_FUNCTIONS(x448, EVP_PKEY_X448)
+KEYMGMT_FUNCTIONS(dh, EVP_PKEY_DH)
+
+#endif
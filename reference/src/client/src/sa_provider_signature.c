@@ -0,0 +1,635 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_internal.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include "common.h"
+#include "log.h"
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <openssl/rsa.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    sa_provider_context* provider_context;
+    sa_provider_key_data* key_data;
+    int padding_mode;
+    int pss_salt_length;
+    EVP_MD* evp_md;
+    EVP_MD* mgf1_md;
+    EVP_MD_CTX* evp_md_ctx;
+} signature_context;
+
+static const OSSL_PARAM signature_gettable_ctx_params[] = {
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_DIGEST, NULL, 0),
+        OSSL_PARAM_int(OSSL_SIGNATURE_PARAM_PAD_MODE, NULL),
+        OSSL_PARAM_int(OSSL_SIGNATURE_PARAM_PSS_SALTLEN, NULL),
+        OSSL_PARAM_END};
+
+static const OSSL_PARAM signature_settable_ctx_params[] = {
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_PROPERTIES, NULL, 0),
+        OSSL_PARAM_int(OSSL_SIGNATURE_PARAM_PAD_MODE, NULL),
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_PSS_SALTLEN, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_MGF1_DIGEST, NULL, 0),
+        OSSL_PARAM_utf8_string(OSSL_SIGNATURE_PARAM_MGF1_PROPERTIES, NULL, 0),
+        OSSL_PARAM_END};
+
+static bool is_eddsa(const sa_provider_key_data* key_data) {
+    return key_data->type == EVP_PKEY_ED25519 || key_data->type == EVP_PKEY_ED448;
+}
+
+static void* signature_newctx(
+        void* provctx,
+        const char* propq) {
+
+    signature_context* context = OPENSSL_zalloc(sizeof(signature_context));
+    if (context == NULL) {
+        ERROR("OPENSSL_zalloc failed");
+        return NULL;
+    }
+
+    context->provider_context = provctx;
+    context->padding_mode = RSA_PKCS1_PADDING;
+    context->pss_salt_length = RSA_PSS_SALTLEN_AUTO;
+    return context;
+}
+
+static void signature_freectx(void* vctx) {
+    signature_context* context = vctx;
+    if (context != NULL) {
+        EVP_MD_free(context->evp_md);
+        EVP_MD_free(context->mgf1_md);
+        EVP_MD_CTX_free(context->evp_md_ctx);
+        OPENSSL_free(context);
+    }
+}
+
+static void* signature_dupctx(void* vctx) {
+    signature_context* context = vctx;
+    signature_context* new_context = OPENSSL_memdup(context, sizeof(signature_context));
+    if (new_context == NULL) {
+        ERROR("OPENSSL_memdup failed");
+        return NULL;
+    }
+
+    new_context->evp_md_ctx = NULL;
+    if (new_context->evp_md != NULL)
+        EVP_MD_up_ref(new_context->evp_md);
+
+    if (new_context->mgf1_md != NULL)
+        EVP_MD_up_ref(new_context->mgf1_md);
+
+    if (context->evp_md_ctx != NULL) {
+        new_context->evp_md_ctx = EVP_MD_CTX_new();
+        if (new_context->evp_md_ctx == NULL || EVP_MD_CTX_copy_ex(new_context->evp_md_ctx, context->evp_md_ctx) != 1) {
+            ERROR("EVP_MD_CTX_copy_ex failed");
+            signature_freectx(new_context);
+            return NULL;
+        }
+    }
+
+    return new_context;
+}
+
+static int signature_set_ctx_params(
+        void* vctx,
+        const OSSL_PARAM params[]) {
+
+    signature_context* context = vctx;
+    if (params == NULL)
+        return 1;
+
+    const OSSL_PARAM* param = OSSL_PARAM_locate_const(params, OSSL_SIGNATURE_PARAM_DIGEST);
+    if (param != NULL && !sa_provider_set_digest(&context->evp_md, context->provider_context, param))
+        return 0;
+
+    param = OSSL_PARAM_locate_const(params, OSSL_SIGNATURE_PARAM_PAD_MODE);
+    if (param != NULL) {
+        int padding_mode;
+        if (!sa_provider_get_padding_mode(&padding_mode, param))
+            return 0;
+
+        if (padding_mode != RSA_PKCS1_PADDING && padding_mode != RSA_PKCS1_PSS_PADDING) {
+            ERROR("Invalid padding mode");
+            return 0;
+        }
+
+        context->padding_mode = padding_mode;
+    }
+
+    param = OSSL_PARAM_locate_const(params, OSSL_SIGNATURE_PARAM_PSS_SALTLEN);
+    if (param != NULL) {
+        if (param->data_type == OSSL_PARAM_UTF8_STRING) {
+            if (strcmp(param->data, OSSL_PKEY_RSA_PSS_SALT_LEN_DIGEST) == 0)
+                context->pss_salt_length = RSA_PSS_SALTLEN_DIGEST;
+            else if (strcmp(param->data, OSSL_PKEY_RSA_PSS_SALT_LEN_MAX) == 0)
+                context->pss_salt_length = RSA_PSS_SALTLEN_MAX;
+            else if (strcmp(param->data, OSSL_PKEY_RSA_PSS_SALT_LEN_AUTO) == 0)
+                context->pss_salt_length = RSA_PSS_SALTLEN_AUTO;
+            else
+                context->pss_salt_length = atoi(param->data);
+        } else if (!OSSL_PARAM_get_int(param, &context->pss_salt_length)) {
+            ERROR("OSSL_PARAM_get_int failed");
+            return 0;
+        }
+    }
+
+    param = OSSL_PARAM_locate_const(params, OSSL_SIGNATURE_PARAM_MGF1_DIGEST);
+    if (param != NULL && !sa_provider_set_digest(&context->mgf1_md, context->provider_context, param))
+        return 0;
+
+    return 1;
+}
+
+static const OSSL_PARAM* signature_settable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return signature_settable_ctx_params;
+}
+
+static int signature_get_ctx_params(
+        void* vctx,
+        OSSL_PARAM params[]) {
+
+    signature_context* context = vctx;
+    OSSL_PARAM* param = OSSL_PARAM_locate(params, OSSL_SIGNATURE_PARAM_DIGEST);
+    if (param != NULL && context->evp_md != NULL &&
+            !OSSL_PARAM_set_utf8_string(param, EVP_MD_get0_name(context->evp_md)))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_SIGNATURE_PARAM_PAD_MODE);
+    if (param != NULL && !OSSL_PARAM_set_int(param, context->padding_mode))
+        return 0;
+
+    param = OSSL_PARAM_locate(params, OSSL_SIGNATURE_PARAM_PSS_SALTLEN);
+    if (param != NULL && !OSSL_PARAM_set_int(param, context->pss_salt_length))
+        return 0;
+
+    return 1;
+}
+
+static const OSSL_PARAM* signature_gettable_ctx_params_function(
+        void* vctx,
+        void* provctx) {
+    return signature_gettable_ctx_params;
+}
+
+static int signature_init(
+        signature_context* context,
+        sa_provider_key_data* key_data,
+        bool sign,
+        const OSSL_PARAM params[]) {
+
+    if (key_data == NULL) {
+        ERROR("NULL key_data");
+        return 0;
+    }
+
+    if (key_data->type != EVP_PKEY_RSA && key_data->type != EVP_PKEY_EC && !is_eddsa(key_data)) {
+        ERROR("Invalid key type for sign or verify");
+        return 0;
+    }
+
+    if (sign ? key_data->private_key == INVALID_HANDLE : key_data->public_key == NULL) {
+        ERROR("Key can't be used for this operation");
+        return 0;
+    }
+
+    context->key_data = key_data;
+    return signature_set_ctx_params(context, params);
+}
+
+static int signature_sign_init(
+        void* vctx,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return signature_init(vctx, provkey, true, params);
+}
+
+static int signature_verify_init(
+        void* vctx,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return signature_init(vctx, provkey, false, params);
+}
+
+// RSA and EC signing of a precomputed digest
+static int signature_sign(
+        void* vctx,
+        unsigned char* signature,
+        size_t* signature_length,
+        size_t signature_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    signature_context* context = vctx;
+    const sa_provider_key_data* key_data = context->key_data;
+    int max_signature_length = EVP_PKEY_get_size(key_data->public_key);
+    if (signature == NULL) {
+        *signature_length = max_signature_length;
+        return 1;
+    }
+
+    if (signature_size < (size_t) max_signature_length) {
+        ERROR("Signature buffer too small");
+        return 0;
+    }
+
+    sa_signature_algorithm signature_algorithm;
+    sa_sign_parameters_rsa_pkcs1v15 parameters_rsa_pkcs1v15;
+    sa_sign_parameters_rsa_pss parameters_rsa_pss;
+    sa_sign_parameters_ecdsa parameters_ecdsa;
+    void* parameters;
+    sa_digest_algorithm digest_algorithm = sa_provider_get_digest_algorithm(context->evp_md);
+    if (digest_algorithm == UINT32_MAX) {
+        ERROR("digest_algorithm unknown");
+        return 0;
+    }
+
+    if (in_length != (size_t) EVP_MD_get_size(context->evp_md)) {
+        ERROR("Invalid digest length");
+        return 0;
+    }
+
+    if (key_data->type == EVP_PKEY_RSA) {
+        if (context->padding_mode == RSA_PKCS1_PADDING) {
+            signature_algorithm = SA_SIGNATURE_ALGORITHM_RSA_PKCS1V15;
+            parameters_rsa_pkcs1v15.digest_algorithm = digest_algorithm;
+            parameters_rsa_pkcs1v15.precomputed_digest = true;
+            parameters = &parameters_rsa_pkcs1v15;
+        } else {
+            signature_algorithm = SA_SIGNATURE_ALGORITHM_RSA_PSS;
+            parameters_rsa_pss.digest_algorithm = digest_algorithm;
+            parameters_rsa_pss.mgf1_digest_algorithm = context->mgf1_md == NULL ?
+                                                               digest_algorithm :
+                                                               sa_provider_get_digest_algorithm(context->mgf1_md);
+            if (parameters_rsa_pss.mgf1_digest_algorithm == UINT32_MAX) {
+                ERROR("mgf1_digest_algorithm unknown");
+                return 0;
+            }
+
+            int salt_length;
+            if (context->pss_salt_length == RSA_PSS_SALTLEN_DIGEST) {
+                salt_length = (int) in_length;
+            } else if (context->pss_salt_length == RSA_PSS_SALTLEN_AUTO ||
+                       context->pss_salt_length == RSA_PSS_SALTLEN_MAX) {
+                salt_length = max_signature_length - (int) in_length - 2;
+                if ((EVP_PKEY_get_bits(key_data->public_key) & 0x7) == 1)
+                    salt_length--;
+
+                if (salt_length < 0) {
+                    ERROR("salt_length unknown");
+                    return 0;
+                }
+            } else {
+                salt_length = context->pss_salt_length;
+            }
+
+            parameters_rsa_pss.precomputed_digest = true;
+            parameters_rsa_pss.salt_length = salt_length;
+            parameters = &parameters_rsa_pss;
+        }
+    } else if (key_data->type == EVP_PKEY_EC) {
+        signature_algorithm = SA_SIGNATURE_ALGORITHM_ECDSA;
+        parameters_ecdsa.digest_algorithm = digest_algorithm;
+        parameters_ecdsa.precomputed_digest = true;
+        parameters = &parameters_ecdsa;
+    } else {
+        ERROR("Invalid key type");
+        return 0;
+    }
+
+    uint8_t local_signature[MAX_SIGNATURE_LENGTH];
+    size_t local_signature_length = sizeof(local_signature);
+    sa_status status = sa_crypto_sign(local_signature, &local_signature_length, signature_algorithm,
+            key_data->private_key, in, in_length, parameters);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_sign failed %d", status);
+        return 0;
+    }
+
+    if (key_data->type == EVP_PKEY_EC) {
+        // SecApi 3 returns {r,s}. OpenSSL expects the ASN.1 encoding.
+        if (!ec_encode_signature(signature, signature_length, local_signature, local_signature_length)) {
+            ERROR("ec_encode_signature failed");
+            return 0;
+        }
+    } else {
+        memcpy(signature, local_signature, local_signature_length);
+        *signature_length = local_signature_length;
+    }
+
+    return 1;
+}
+
+// Verification only needs the public key, so it is handed to the providers that own it.
+static int signature_verify(
+        void* vctx,
+        const unsigned char* signature,
+        size_t signature_length,
+        const unsigned char* in,
+        size_t in_length) {
+
+    signature_context* context = vctx;
+    const sa_provider_key_data* key_data = context->key_data;
+    int result = 0;
+    EVP_PKEY_CTX* verify_pkey_ctx = NULL;
+    do {
+        verify_pkey_ctx = EVP_PKEY_CTX_new_from_pkey(context->provider_context->libctx, key_data->public_key,
+                SA_PROVIDER_DELEGATE_PROPERTY_QUERY);
+        if (verify_pkey_ctx == NULL) {
+            ERROR("EVP_PKEY_CTX_new_from_pkey failed");
+            break;
+        }
+
+        if (EVP_PKEY_verify_init(verify_pkey_ctx) != 1) {
+            ERROR("EVP_PKEY_verify_init failed");
+            break;
+        }
+
+        if (key_data->type == EVP_PKEY_RSA) {
+            if (EVP_PKEY_CTX_set_rsa_padding(verify_pkey_ctx, context->padding_mode) != 1) {
+                ERROR("EVP_PKEY_CTX_set_rsa_padding failed");
+                break;
+            }
+
+            if (context->padding_mode == RSA_PKCS1_PSS_PADDING) {
+                if (context->mgf1_md != NULL && EVP_PKEY_CTX_set_rsa_mgf1_md(verify_pkey_ctx, context->mgf1_md) != 1) {
+                    ERROR("EVP_PKEY_CTX_set_rsa_mgf1_md failed");
+                    break;
+                }
+
+                if (EVP_PKEY_CTX_set_rsa_pss_saltlen(verify_pkey_ctx, context->pss_salt_length) != 1) {
+                    ERROR("EVP_PKEY_CTX_set_rsa_pss_saltlen failed");
+                    break;
+                }
+            }
+        }
+
+        if (EVP_PKEY_CTX_set_signature_md(verify_pkey_ctx, context->evp_md) != 1) {
+            ERROR("EVP_PKEY_CTX_set_signature_md failed");
+            break;
+        }
+
+        if (EVP_PKEY_verify(verify_pkey_ctx, signature, signature_length, in, in_length) != 1) {
+            ERROR("EVP_PKEY_verify failed");
+            break;
+        }
+
+        result = 1;
+    } while (false);
+
+    EVP_PKEY_CTX_free(verify_pkey_ctx);
+    return result;
+}
+
+static int signature_digest_init(
+        signature_context* context,
+        const char* md_name,
+        sa_provider_key_data* key_data,
+        bool sign,
+        const OSSL_PARAM params[]) {
+
+    if (!signature_init(context, key_data, sign, params))
+        return 0;
+
+    EVP_MD_CTX_free(context->evp_md_ctx);
+    context->evp_md_ctx = NULL;
+    if (is_eddsa(key_data)) {
+        if (md_name != NULL && md_name[0] != '\0') {
+            ERROR("EdDSA does not take a digest");
+            return 0;
+        }
+
+        // EdDSA is one shot. Digest sign and verify go through signature_digest_sign and signature_digest_verify.
+        return 1;
+    }
+
+    if (md_name != NULL) {
+        OSSL_PARAM md_params[] = {
+                OSSL_PARAM_construct_utf8_string(OSSL_SIGNATURE_PARAM_DIGEST, (char*) md_name, 0),
+                OSSL_PARAM_construct_end()};
+        if (!sa_provider_set_digest(&context->evp_md, context->provider_context, md_params))
+            return 0;
+    }
+
+    if (context->evp_md == NULL) {
+        ERROR("NULL evp_md");
+        return 0;
+    }
+
+    context->evp_md_ctx = EVP_MD_CTX_new();
+    if (context->evp_md_ctx == NULL) {
+        ERROR("EVP_MD_CTX_new failed");
+        return 0;
+    }
+
+    if (EVP_DigestInit_ex(context->evp_md_ctx, context->evp_md, NULL) != 1) {
+        ERROR("EVP_DigestInit_ex failed");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int signature_digest_sign_init(
+        void* vctx,
+        const char* md_name,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return signature_digest_init(vctx, md_name, provkey, true, params);
+}
+
+static int signature_digest_verify_init(
+        void* vctx,
+        const char* md_name,
+        void* provkey,
+        const OSSL_PARAM params[]) {
+    return signature_digest_init(vctx, md_name, provkey, false, params);
+}
+
+static int signature_digest_update(
+        void* vctx,
+        const unsigned char* data,
+        size_t data_length) {
+
+    signature_context* context = vctx;
+    if (context->evp_md_ctx == NULL) {
+        ERROR("Digest not initialized");
+        return 0;
+    }
+
+    if (EVP_DigestUpdate(context->evp_md_ctx, data, data_length) != 1) {
+        ERROR("EVP_DigestUpdate failed");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int signature_digest_final(
+        signature_context* context,
+        unsigned char* digest,
+        unsigned int* digest_length) {
+
+    if (context->evp_md_ctx == NULL) {
+        ERROR("Digest not initialized");
+        return 0;
+    }
+
+    if (EVP_DigestFinal_ex(context->evp_md_ctx, digest, digest_length) != 1) {
+        ERROR("EVP_DigestFinal_ex failed");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int signature_digest_sign_final(
+        void* vctx,
+        unsigned char* signature,
+        size_t* signature_length,
+        size_t signature_size) {
+
+    signature_context* context = vctx;
+    if (signature == NULL)
+        return signature_sign(context, NULL, signature_length, 0, NULL, 0);
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length;
+    if (!signature_digest_final(context, digest, &digest_length))
+        return 0;
+
+    return signature_sign(context, signature, signature_length, signature_size, digest, digest_length);
+}
+
+static int signature_digest_verify_final(
+        void* vctx,
+        const unsigned char* signature,
+        size_t signature_length) {
+
+    signature_context* context = vctx;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length;
+    if (!signature_digest_final(context, digest, &digest_length))
+        return 0;
+
+    return signature_verify(context, signature, signature_length, digest, digest_length);
+}
+
+static int signature_digest_sign(
+        void* vctx,
+        unsigned char* signature,
+        size_t* signature_length,
+        size_t signature_size,
+        const unsigned char* in,
+        size_t in_length) {
+
+    signature_context* context = vctx;
+    if (!is_eddsa(context->key_data)) {
+        if (signature != NULL && !signature_digest_update(context, in, in_length))
+            return 0;
+
+        return signature_digest_sign_final(context, signature, signature_length, signature_size);
+    }
+
+    if (signature == NULL) {
+        *signature_length = EVP_PKEY_get_size(context->key_data->public_key);
+        return 1;
+    }
+
+    size_t length = signature_size;
+    sa_status status = sa_crypto_sign(signature, &length, SA_SIGNATURE_ALGORITHM_EDDSA,
+            context->key_data->private_key, in, in_length, NULL);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_crypto_sign failed %d", status);
+        return 0;
+    }
+
+    *signature_length = length;
+    return 1;
+}
+
+static int signature_digest_verify(
+        void* vctx,
+        const unsigned char* signature,
+        size_t signature_length,
+        const unsigned char* in,
+        size_t in_length) {
+
+    signature_context* context = vctx;
+    if (!is_eddsa(context->key_data)) {
+        if (!signature_digest_update(context, in, in_length))
+            return 0;
+
+        return signature_digest_verify_final(context, signature, signature_length);
+    }
+
+    int result = 0;
+    EVP_MD_CTX* verify_md_ctx = NULL;
+    do {
+        verify_md_ctx = EVP_MD_CTX_new();
+        if (verify_md_ctx == NULL) {
+            ERROR("EVP_MD_CTX_new failed");
+            break;
+        }
+
+        if (EVP_DigestVerifyInit_ex(verify_md_ctx, NULL, NULL, context->provider_context->libctx,
+                    SA_PROVIDER_DELEGATE_PROPERTY_QUERY, context->key_data->public_key, NULL) != 1) {
+            ERROR("EVP_DigestVerifyInit_ex failed");
+            break;
+        }
+
+        if (EVP_DigestVerify(verify_md_ctx, signature, signature_length, in, in_length) != 1) {
+            ERROR("EVP_DigestVerify failed");
+            break;
+        }
+
+        result = 1;
+    } while (false);
+
+    EVP_MD_CTX_free(verify_md_ctx);
+    return result;
+}
+
+const OSSL_DISPATCH sa_provider_signature_functions[] = {
+        {OSSL_FUNC_SIGNATURE_NEWCTX, (void (*)(void)) signature_newctx},
+        {OSSL_FUNC_SIGNATURE_FREECTX, (void (*)(void)) signature_freectx},
+        {OSSL_FUNC_SIGNATURE_DUPCTX, (void (*)(void)) signature_dupctx},
+        {OSSL_FUNC_SIGNATURE_SIGN_INIT, (void (*)(void)) signature_sign_init},
+        {OSSL_FUNC_SIGNATURE_SIGN, (void (*)(void)) signature_sign},
+        {OSSL_FUNC_SIGNATURE_VERIFY_INIT, (void (*)(void)) signature_verify_init},
+        {OSSL_FUNC_SIGNATURE_VERIFY, (void (*)(void)) signature_verify},
+        {OSSL_FUNC_SIGNATURE_DIGEST_SIGN_INIT, (void (*)(void)) signature_digest_sign_init},
+        {OSSL_FUNC_SIGNATURE_DIGEST_SIGN_UPDATE, (void (*)(void)) signature_digest_update},
+        {OSSL_FUNC_SIGNATURE_DIGEST_SIGN_FINAL, (void (*)(void)) signature_digest_sign_final},
+        {OSSL_FUNC_SIGNATURE_DIGEST_SIGN, (void (*)(void)) signature_digest_sign},
+        {OSSL_FUNC_SIGNATURE_DIGEST_VERIFY_INIT, (void (*)(void)) signature_digest_verify_init},
+        {OSSL_FUNC_SIGNATURE_DIGEST_VERIFY_UPDATE, (void (*)(void)) signature_digest_update},
+        {OSSL_FUNC_SIGNATURE_DIGEST_VERIFY_FINAL, (void (*)(void)) signature_digest_verify_final},
+        {OSSL_FUNC_SIGNATURE_DIGEST_VERIFY, (void (*)(void)) signature_digest_verify},
+        {OSSL_FUNC_SIGNATURE_GET_CTX_PARAMS, (void (*)(void)) signature_get_ctx_params},
+        {OSSL_FUNC_SIGNATURE_GETTABLE_CTX_PARAMS, (void (*)(void)) signature_gettable_ctx_params_function},
+        {OSSL_FUNC_SIGNATURE_SET_CTX_PARAMS, (void (*)(void)) signature_set_ctx_params},
+        {OSSL_FUNC_SIGNATURE_SETTABLE_CTX_PARAMS, (void (*)(void)) signature_settable_ctx_params_function},
+        {0, NULL}};
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace client_test_helpers;
+
+namespace {
+    class SaCoalesceReleasesTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_EQ(sa_coalesce_releases(true), SA_STATUS_OK);
+        }
+
+        void TearDown() override {
+            sa_coalesce_releases(false);
+        }
+
+        static sa_key generate_key() {
+            sa_rights rights;
+            sa_rights_set_allow_all(&rights);
+            sa_generate_parameters_symmetric parameters = {SYM_128_KEY_SIZE};
+            sa_key key = INVALID_HANDLE;
+            if (sa_key_generate(&key, &rights, SA_KEY_TYPE_SYMMETRIC, &parameters) != SA_STATUS_OK)
+                return INVALID_HANDLE;
+
+            return key;
+        }
+    };
+
+    TEST_F(SaCoalesceReleasesTest, nominal) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_OK);
+
+        sa_header header;
+        ASSERT_EQ(sa_key_header(&header, key), SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaCoalesceReleasesTest, nominalSentBeforeNextCall) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        // Populates the key header cache, which must not answer for the key once it is released.
+        sa_header header;
+        ASSERT_EQ(sa_key_header(&header, key), SA_STATUS_OK);
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+        ASSERT_EQ(sa_key_header(&header, key), SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaCoalesceReleasesTest, nominalMoreThanQueueCapacity) {
+        std::vector<sa_key> keys;
+        for (size_t i = 0; i < 150; i++) {
+            sa_key key = generate_key();
+            ASSERT_NE(key, INVALID_HANDLE);
+            keys.push_back(key);
+        }
+
+        for (sa_key key : keys)
+            ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_OK);
+        for (sa_key key : keys) {
+            sa_header header;
+            ASSERT_EQ(sa_key_header(&header, key), SA_STATUS_INVALID_PARAMETER);
+        }
+    }
+
+    TEST_F(SaCoalesceReleasesTest, nominalCipherAndMac) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        sa_crypto_cipher_context cipher;
+        ASSERT_EQ(sa_crypto_cipher_init(&cipher, SA_CIPHER_ALGORITHM_AES_ECB, SA_CIPHER_MODE_ENCRYPT, key, nullptr),
+                SA_STATUS_OK);
+
+        sa_crypto_mac_context mac;
+        ASSERT_EQ(sa_crypto_mac_init(&mac, SA_MAC_ALGORITHM_CMAC, key, nullptr), SA_STATUS_OK);
+
+        ASSERT_EQ(sa_crypto_cipher_release(cipher), SA_STATUS_OK);
+        ASSERT_EQ(sa_crypto_mac_release(mac), SA_STATUS_OK);
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+        ASSERT_EQ(sa_coalesce_releases(false), SA_STATUS_OK);
+
+        ASSERT_EQ(sa_crypto_cipher_release(cipher), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(sa_crypto_mac_release(mac), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaCoalesceReleasesTest, failsFlushInvalidHandle) {
+        ASSERT_EQ(sa_key_release(INVALID_HANDLE), SA_STATUS_OK);
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaCoalesceReleasesTest, failsSentBeforeNextCallReportedOnFlush) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+
+        // Sends both releases. The second one fails, which the call itself does not report.
+        sa_key other = generate_key();
+        ASSERT_NE(other, INVALID_HANDLE);
+
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_OK);
+        ASSERT_EQ(sa_key_release(other), SA_STATUS_OK);
+        ASSERT_EQ(sa_flush_releases(), SA_STATUS_OK);
+    }
+
+    TEST_F(SaCoalesceReleasesTest, failsSentBeforeNextCallReportedOnDisable) {
+        ASSERT_EQ(sa_key_release(INVALID_HANDLE), SA_STATUS_OK);
+
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        ASSERT_EQ(sa_coalesce_releases(false), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+    }
+} // namespace
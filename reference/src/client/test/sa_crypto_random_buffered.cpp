@@ -0,0 +1,93 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "gtest/gtest.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace client_test_helpers;
+
+namespace {
+    TEST(SaCryptoRandomBuffered, nominalSize0) {
+        auto out = std::vector<uint8_t>(1);
+        sa_status status = sa_crypto_random_buffered(out.data(), 0);
+        ASSERT_EQ(status, SA_STATUS_OK);
+    }
+
+    TEST(SaCryptoRandomBuffered, nominalSize12) {
+        auto out = std::vector<uint8_t>(12);
+        sa_status status = sa_crypto_random_buffered(out.data(), out.size());
+        ASSERT_EQ(status, SA_STATUS_OK);
+    }
+
+    TEST(SaCryptoRandomBuffered, nominalSize512) {
+        auto out = std::vector<uint8_t>(512);
+        sa_status status = sa_crypto_random_buffered(out.data(), out.size());
+        ASSERT_EQ(status, SA_STATUS_OK);
+    }
+
+    TEST(SaCryptoRandomBuffered, nominalUnique) {
+        // Crosses several block refills.
+        std::vector<std::vector<uint8_t>> nonces;
+        for (size_t i = 0; i < 1000; i++) {
+            auto out = std::vector<uint8_t>(32);
+            ASSERT_EQ(sa_crypto_random_buffered(out.data(), out.size()), SA_STATUS_OK);
+            for (auto& nonce : nonces)
+                ASSERT_NE(nonce, out);
+
+            nonces.push_back(out);
+        }
+    }
+
+    TEST(SaCryptoRandomBuffered, nominalFork) {
+        auto out = std::vector<uint8_t>(16);
+        ASSERT_EQ(sa_crypto_random_buffered(out.data(), out.size()), SA_STATUS_OK);
+
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            close(fds[0]);
+            std::vector<uint8_t> child(16);
+            bool ok = sa_crypto_random_buffered(child.data(), child.size()) == SA_STATUS_OK &&
+                      write(fds[1], child.data(), child.size()) == static_cast<ssize_t>(child.size());
+            _exit(ok ? 0 : 1);
+        }
+
+        close(fds[1]);
+        std::vector<uint8_t> child(16);
+        ssize_t length = read(fds[0], child.data(), child.size());
+        close(fds[0]);
+        int wstatus = 0;
+        ASSERT_EQ(waitpid(pid, &wstatus, 0), pid);
+        ASSERT_TRUE(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0);
+        ASSERT_EQ(length, static_cast<ssize_t>(child.size()));
+
+        std::vector<uint8_t> parent(16);
+        ASSERT_EQ(sa_crypto_random_buffered(parent.data(), parent.size()), SA_STATUS_OK);
+        ASSERT_NE(parent, child);
+    }
+
+    TEST(SaCryptoRandomBuffered, failsNullOut) {
+        sa_status status = sa_crypto_random_buffered(nullptr, 16);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,34 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa.h"
+#include "gtest/gtest.h"
+
+namespace {
+    TEST(SaGetKeyHeaderCacheStats, nominal) {
+        sa_key_header_cache_stats stats;
+        sa_status status = sa_get_key_header_cache_stats(&stats);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_LE(stats.invalidations, stats.inserts);
+    }
+
+    TEST(SaGetKeyHeaderCacheStats, failsNullStats) {
+        sa_status status = sa_get_key_header_cache_stats(nullptr);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "sa.h"
+#include "sa_ta_types.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+namespace {
+    std::vector<uint8_t> get_stats() {
+        size_t stats_length = 0;
+        EXPECT_EQ(sa_get_stats(nullptr, &stats_length), SA_STATUS_OK);
+        std::vector<uint8_t> stats(stats_length);
+        EXPECT_EQ(sa_get_stats(stats.data(), &stats_length), SA_STATUS_OK);
+        stats.resize(stats_length);
+        return stats;
+    }
+
+    // Returns the offset of the record for command_id, or 0 if the command has no record.
+    size_t find_command(
+            sa_stats_command& command,
+            const std::vector<uint8_t>& stats,
+            uint32_t command_id) {
+
+        sa_stats_header header;
+        memcpy(&header, stats.data(), sizeof(header));
+        size_t offset = header.header_length;
+        for (uint32_t i = 0; i < header.command_count; i++) {
+            memcpy(&command, stats.data() + offset, sizeof(command));
+            if (command.command_id == command_id)
+                return offset;
+
+            offset += command.record_length;
+        }
+
+        return 0;
+    }
+
+    TEST(SaGetStats, nominalNullStats) {
+        size_t stats_length = 0;
+        sa_status status = sa_get_stats(nullptr, &stats_length);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_GE(stats_length, sizeof(sa_stats_header));
+    }
+
+    TEST(SaGetStats, nominal) {
+        sa_version version;
+        ASSERT_EQ(sa_get_version(&version), SA_STATUS_OK);
+        auto stats = get_stats();
+        ASSERT_GE(stats.size(), sizeof(sa_stats_header));
+
+        sa_stats_header header;
+        memcpy(&header, stats.data(), sizeof(header));
+        ASSERT_EQ(header.version, static_cast<uint32_t>(SA_STATS_VERSION));
+        ASSERT_EQ(header.header_length, sizeof(sa_stats_header));
+        ASSERT_GT(header.status_count, static_cast<uint32_t>(SA_STATUS_OK));
+        ASSERT_GT(header.bucket_count, 0U);
+
+        sa_stats_command before;
+        ASSERT_NE(find_command(before, stats, SA_GET_VERSION), 0U);
+        ASSERT_GE(before.calls, 1U);
+        ASSERT_EQ(before.record_length,
+                sizeof(sa_stats_command) + (header.status_count + header.bucket_count) * sizeof(uint64_t));
+
+        ASSERT_EQ(sa_get_version(&version), SA_STATUS_OK);
+        sa_stats_command after;
+        ASSERT_NE(find_command(after, get_stats(), SA_GET_VERSION), 0U);
+        ASSERT_EQ(after.calls, before.calls + 1);
+    }
+
+    TEST(SaGetStats, countsErrors) {
+        size_t name_length = 0;
+        ASSERT_EQ(sa_get_name(nullptr, &name_length), SA_STATUS_OK);
+        std::vector<char> name(name_length);
+        name_length--;
+        ASSERT_EQ(sa_get_name(name.data(), &name_length), SA_STATUS_INVALID_PARAMETER);
+
+        auto stats = get_stats();
+        sa_stats_command command;
+        size_t offset = find_command(command, stats, SA_GET_NAME);
+        ASSERT_NE(offset, 0U);
+
+        uint64_t errors;
+        memcpy(&errors, stats.data() + offset + sizeof(command) + SA_STATUS_INVALID_PARAMETER * sizeof(uint64_t),
+                sizeof(errors));
+        ASSERT_GE(errors, 1U);
+    }
+
+    TEST(SaGetStats, failsNullStatsLength) {
+        std::vector<uint8_t> stats(1);
+        sa_status status = sa_get_stats(stats.data(), nullptr);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST(SaGetStats, failsInvalidStatsLength) {
+        size_t stats_length = 0;
+        sa_status status = sa_get_stats(nullptr, &stats_length);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        stats_length--;
+
+        std::vector<uint8_t> stats(stats_length);
+        status = sa_get_stats(stats.data(), &stats_length);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,390 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_key_derive_common.h"
+#include "gtest/gtest.h"
+
+using namespace client_test_helpers;
+
+#define BATCH_SIZE 8
+
+namespace {
+    std::vector<std::shared_ptr<sa_key>> take_keys(std::vector<sa_kdf_batch_entry>& entries) {
+        std::vector<std::shared_ptr<sa_key>> keys;
+        for (auto& entry : entries) {
+            auto key = create_uninitialized_sa_key();
+            *key = entry.key;
+            keys.push_back(key);
+        }
+
+        return keys;
+    }
+
+    std::vector<sa_kdf_batch_entry> create_entries(
+            const sa_rights* rights,
+            std::vector<std::vector<uint8_t>>& infos) {
+
+        std::vector<sa_kdf_batch_entry> entries;
+        for (auto& info : infos) {
+            sa_kdf_batch_entry entry = {
+                    .key = INVALID_HANDLE,
+                    .rights = rights,
+                    .info = info.data(),
+                    .info_length = info.size()};
+            entries.push_back(entry);
+        }
+
+        return entries;
+    }
+
+    std::vector<std::vector<uint8_t>> create_infos(size_t info_size) {
+        std::vector<std::vector<uint8_t>> infos;
+        for (size_t i = 0; i < BATCH_SIZE; i++)
+            infos.push_back(random(info_size));
+
+        return infos;
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, nominalHkdf) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_base_key = random(SYM_256_KEY_SIZE);
+        auto base_key = create_sa_key_symmetric(&rights, clear_base_key);
+        ASSERT_NE(base_key, nullptr);
+        if (*base_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        auto salt = random(AES_BLOCK_SIZE);
+        sa_kdf_parameters_hkdf kdf_parameters_hkdf = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .salt = salt.data(),
+                .salt_length = salt.size(),
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_HKDF,
+                &kdf_parameters_hkdf);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            std::vector<uint8_t> clear_key(SYM_128_KEY_SIZE);
+            ASSERT_TRUE(hkdf(clear_key, clear_base_key, salt, infos[i], SA_DIGEST_ALGORITHM_SHA256));
+            ASSERT_TRUE(key_check_sym(*keys[i], clear_key));
+        }
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, nominalConcat) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_base_key = random(SYM_128_KEY_SIZE);
+        auto base_key = create_sa_key_symmetric(&rights, clear_base_key);
+        ASSERT_NE(base_key, nullptr);
+        if (*base_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_256_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA1,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT,
+                &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            std::vector<uint8_t> clear_key(SYM_256_KEY_SIZE);
+            ASSERT_TRUE(concat_kdf(clear_key, clear_base_key, infos[i], SA_DIGEST_ALGORITHM_SHA1));
+            ASSERT_TRUE(key_check_sym(*keys[i], clear_key));
+        }
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, nominalAnsiX963) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_base_key = random(SYM_128_KEY_SIZE);
+        auto base_key = create_sa_key_symmetric(&rights, clear_base_key);
+        ASSERT_NE(base_key, nullptr);
+        if (*base_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        sa_kdf_parameters_ansi_x963 kdf_parameters_ansi_x963 = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA512,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_ANSI_X963,
+                &kdf_parameters_ansi_x963);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            std::vector<uint8_t> clear_key(SYM_128_KEY_SIZE);
+            ASSERT_TRUE(ansi_x963_kdf(clear_key, clear_base_key, infos[i], SA_DIGEST_ALGORITHM_SHA512));
+            ASSERT_TRUE(key_check_sym(*keys[i], clear_key));
+        }
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, nominalCmac) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_base_key = random(SYM_128_KEY_SIZE);
+        auto base_key = create_sa_key_symmetric(&rights, clear_base_key);
+        ASSERT_NE(base_key, nullptr);
+        if (*base_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        sa_kdf_parameters_cmac kdf_parameters_cmac = {
+                .key_length = SYM_128_KEY_SIZE,
+                .parent = *base_key,
+                .other_data = nullptr,
+                .other_data_length = 0,
+                .counter = 2};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CMAC,
+                &kdf_parameters_cmac);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        for (size_t i = 0; i < BATCH_SIZE; i++) {
+            std::vector<uint8_t> clear_key(SYM_128_KEY_SIZE);
+            ASSERT_TRUE(cmac_kdf(clear_key, clear_base_key, infos[i], 2));
+            ASSERT_TRUE(key_check_sym(*keys[i], clear_key));
+        }
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, nominalEmptyInfo) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_base_key = random(SYM_128_KEY_SIZE);
+        auto base_key = create_sa_key_symmetric(&rights, clear_base_key);
+        ASSERT_NE(base_key, nullptr);
+        if (*base_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(0);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT,
+                &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        std::vector<uint8_t> clear_key(SYM_128_KEY_SIZE);
+        ASSERT_TRUE(concat_kdf(clear_key, clear_base_key, infos[0], SA_DIGEST_ALGORITHM_SHA256));
+        for (size_t i = 0; i < BATCH_SIZE; i++)
+            ASSERT_TRUE(key_check_sym(*keys[i], clear_key));
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsNullEntries) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        sa_status status = sa_key_derive_batch(nullptr, BATCH_SIZE, SA_KDF_ALGORITHM_CONCAT, &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsZeroEntries) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), 0, SA_KDF_ALGORITHM_CONCAT, &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsNullRights) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        entries[BATCH_SIZE - 1].rights = nullptr;
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT,
+                &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsNullInfo) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        entries[0].info = nullptr;
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT,
+                &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsNullParameters) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT, nullptr);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsInvalidAlgorithm) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_netflix kdf_parameters_netflix = {
+                .kenc = *base_key,
+                .khmac = *base_key};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_NETFLIX,
+                &kdf_parameters_netflix);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsInvalidKeyLength) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto base_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_cmac kdf_parameters_cmac = {
+                .key_length = SYM_256_KEY_SIZE,
+                .parent = *base_key,
+                .other_data = nullptr,
+                .other_data_length = 0,
+                .counter = 4};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CMAC,
+                &kdf_parameters_cmac);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsInvalidParent) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        sa_kdf_parameters_concat kdf_parameters_concat = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = INVALID_HANDLE,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_CONCAT,
+                &kdf_parameters_concat);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyDeriveBatchTest, failsNoDeriveRights) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        sa_rights parent_rights = rights;
+        SA_USAGE_BIT_CLEAR(parent_rights.usage_flags, SA_USAGE_FLAG_DERIVE);
+
+        auto base_key = create_sa_key_symmetric(&parent_rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(base_key, nullptr);
+        sa_kdf_parameters_hkdf kdf_parameters_hkdf = {
+                .key_length = SYM_128_KEY_SIZE,
+                .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+                .parent = *base_key,
+                .salt = nullptr,
+                .salt_length = 0,
+                .info = nullptr,
+                .info_length = 0};
+
+        auto infos = create_infos(AES_BLOCK_SIZE);
+        auto entries = create_entries(&rights, infos);
+        sa_status status = sa_key_derive_batch(entries.data(), entries.size(), SA_KDF_ALGORITHM_HKDF,
+                &kdf_parameters_hkdf);
+        ASSERT_EQ(status, SA_STATUS_OPERATION_NOT_ALLOWED);
+        for (auto& entry : entries)
+            ASSERT_EQ(entry.key, INVALID_HANDLE);
+    }
+} // namespace
@@ -46,5 +46,7 @@ class SaKeyDeriveRootKeyLadderTest : public ::testing::Test, public SaKeyBase {}
 
 class SaKeyDeriveCommonRootKeyLadderTest : public ::testing::Test, public SaKeyBase {};
 
+class SaKeyDeriveBatchTest : public ::testing::Test, public SaKeyBase {};
+
 // clang-format on
 #endif // SA_KEY_DERIVE_COMMON_H
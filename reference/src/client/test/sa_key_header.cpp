@@ -20,6 +20,7 @@
 #include "sa.h"
 #include "sa_key_common.h"
 #include "gtest/gtest.h"
+#include <cstring>
 
 using namespace client_test_helpers;
 
@@ -38,6 +39,62 @@ namespace {
         ASSERT_EQ(status, SA_STATUS_OK);
     }
 
+    TEST_F(SaKeyHeaderTest, nominalCached) {
+        auto clear_key = random(SYM_128_KEY_SIZE);
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto key = create_sa_key_symmetric(&rights, clear_key);
+        ASSERT_NE(key, nullptr);
+
+        sa_header header;
+        sa_status status = sa_key_header(&header, *key);
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        sa_key_header_cache_stats before;
+        ASSERT_EQ(sa_get_key_header_cache_stats(&before), SA_STATUS_OK);
+
+        sa_header cached_header;
+        status = sa_key_header(&cached_header, *key);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_EQ(cached_header.type, header.type);
+        ASSERT_EQ(cached_header.size, header.size);
+        ASSERT_EQ(memcmp(&cached_header.rights, &header.rights, sizeof(sa_rights)), 0);
+
+        sa_key_header_cache_stats after;
+        ASSERT_EQ(sa_get_key_header_cache_stats(&after), SA_STATUS_OK);
+        ASSERT_GT(after.hits, before.hits);
+    }
+
+    TEST_F(SaKeyHeaderTest, failsReleasedKey) {
+        auto clear_key = random(SYM_128_KEY_SIZE);
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        sa_key key;
+        sa_import_parameters_symmetric params = {&rights};
+        sa_status status = sa_key_import(&key, SA_KEY_FORMAT_SYMMETRIC_BYTES, clear_key.data(), clear_key.size(),
+                &params);
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        sa_header header;
+        status = sa_key_header(&header, key);
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        sa_key_header_cache_stats before;
+        ASSERT_EQ(sa_get_key_header_cache_stats(&before), SA_STATUS_OK);
+
+        ASSERT_EQ(sa_key_release(key), SA_STATUS_OK);
+        status = sa_key_header(&header, key);
+        ASSERT_NE(status, SA_STATUS_OK);
+
+        sa_key_header_cache_stats after;
+        ASSERT_EQ(sa_get_key_header_cache_stats(&after), SA_STATUS_OK);
+        ASSERT_GT(after.invalidations, before.invalidations);
+    }
+
     TEST_F(SaKeyHeaderTest, failsInvalidKey) {
         sa_header header;
         sa_status status = sa_key_header(&header, INVALID_HANDLE);
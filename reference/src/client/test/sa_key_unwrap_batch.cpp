@@ -0,0 +1,340 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_key_unwrap_common.h"
+#include "gtest/gtest.h"
+
+using namespace client_test_helpers;
+
+#define BATCH_SIZE 8
+
+namespace {
+    INSTANTIATE_TEST_SUITE_P(
+            SaKeyUnwrapBatchTests,
+            SaKeyUnwrapBatchTest,
+            ::testing::Values(
+                    SA_CIPHER_ALGORITHM_AES_ECB,
+                    SA_CIPHER_ALGORITHM_AES_ECB_PKCS7,
+                    SA_CIPHER_ALGORITHM_AES_CBC,
+                    SA_CIPHER_ALGORITHM_AES_CBC_PKCS7,
+                    SA_CIPHER_ALGORITHM_AES_CTR,
+                    SA_CIPHER_ALGORITHM_AES_GCM));
+
+    struct wrapped_entry {
+        std::vector<uint8_t> clear_key;
+        std::vector<uint8_t> wrapped_key;
+        std::vector<uint8_t> iv;
+        std::vector<uint8_t> aad;
+        std::vector<uint8_t> tag;
+        sa_unwrap_parameters_aes_cbc parameters_aes_cbc;
+        sa_unwrap_parameters_aes_ctr parameters_aes_ctr;
+        sa_unwrap_parameters_aes_gcm parameters_aes_gcm;
+    };
+
+    bool wrap_entries(
+            std::vector<wrapped_entry>& wrapped,
+            std::vector<sa_unwrap_batch_entry>& entries,
+            const sa_rights* rights,
+            sa_cipher_algorithm cipher_algorithm,
+            const std::vector<uint8_t>& clear_wrapping_key) {
+
+        wrapped.resize(BATCH_SIZE);
+        for (auto& entry : wrapped) {
+            entry.clear_key = random(SYM_128_KEY_SIZE);
+            void* algorithm_parameters = nullptr;
+            switch (cipher_algorithm) {
+                case SA_CIPHER_ALGORITHM_AES_ECB:
+                case SA_CIPHER_ALGORITHM_AES_ECB_PKCS7:
+                    if (!encrypt_aes_ecb_openssl(entry.wrapped_key, entry.clear_key, clear_wrapping_key,
+                                cipher_algorithm == SA_CIPHER_ALGORITHM_AES_ECB_PKCS7))
+                        return false;
+
+                    break;
+
+                case SA_CIPHER_ALGORITHM_AES_CBC:
+                case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7:
+                    entry.iv = random(AES_BLOCK_SIZE);
+                    if (!encrypt_aes_cbc_openssl(entry.wrapped_key, entry.clear_key, entry.iv, clear_wrapping_key,
+                                cipher_algorithm == SA_CIPHER_ALGORITHM_AES_CBC_PKCS7))
+                        return false;
+
+                    entry.parameters_aes_cbc = {entry.iv.data(), entry.iv.size()};
+                    algorithm_parameters = &entry.parameters_aes_cbc;
+                    break;
+
+                case SA_CIPHER_ALGORITHM_AES_CTR:
+                    entry.iv = random(AES_BLOCK_SIZE);
+                    if (!encrypt_aes_ctr_openssl(entry.wrapped_key, entry.clear_key, entry.iv, clear_wrapping_key))
+                        return false;
+
+                    entry.parameters_aes_ctr = {entry.iv.data(), entry.iv.size()};
+                    algorithm_parameters = &entry.parameters_aes_ctr;
+                    break;
+
+                case SA_CIPHER_ALGORITHM_AES_GCM:
+                    entry.iv = random(GCM_IV_LENGTH);
+                    entry.aad = random(AES_BLOCK_SIZE);
+                    entry.tag.resize(AES_BLOCK_SIZE);
+                    if (!encrypt_aes_gcm_openssl(entry.wrapped_key, entry.clear_key, entry.iv, entry.aad, entry.tag,
+                                clear_wrapping_key))
+                        return false;
+
+                    entry.parameters_aes_gcm = {entry.iv.data(), entry.iv.size(), entry.aad.data(), entry.aad.size(),
+                            entry.tag.data(), entry.tag.size()};
+                    algorithm_parameters = &entry.parameters_aes_gcm;
+                    break;
+
+                default:
+                    return false;
+            }
+
+            sa_unwrap_batch_entry batch_entry = {
+                    .key = INVALID_HANDLE,
+                    .rights = rights,
+                    .in = entry.wrapped_key.data(),
+                    .in_length = entry.wrapped_key.size(),
+                    .algorithm_parameters = algorithm_parameters};
+            entries.push_back(batch_entry);
+        }
+
+        return true;
+    }
+
+    std::vector<std::shared_ptr<sa_key>> take_keys(std::vector<sa_unwrap_batch_entry>& entries) {
+        std::vector<std::shared_ptr<sa_key>> keys;
+        for (auto& entry : entries) {
+            auto key = create_uninitialized_sa_key();
+            *key = entry.key;
+            keys.push_back(key);
+        }
+
+        return keys;
+    }
+
+    TEST_P(SaKeyUnwrapBatchTest, nominal) {
+        sa_cipher_algorithm cipher_algorithm = GetParam();
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_256_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+        if (*wrapping_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, cipher_algorithm, clear_wrapping_key));
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), cipher_algorithm, *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        auto keys = take_keys(entries);
+
+        for (size_t i = 0; i < BATCH_SIZE; i++)
+            ASSERT_TRUE(key_check_sym(*keys[i], wrapped[i].clear_key));
+    }
+
+    TEST_P(SaKeyUnwrapBatchTest, failsCorruptedEntry) {
+        sa_cipher_algorithm cipher_algorithm = GetParam();
+        if (cipher_algorithm != SA_CIPHER_ALGORITHM_AES_GCM && cipher_algorithm != SA_CIPHER_ALGORITHM_AES_CBC_PKCS7)
+            GTEST_SKIP() << "corruption is not detectable";
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+        if (*wrapping_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, cipher_algorithm, clear_wrapping_key));
+
+        // Corrupt the padding or the tag of the last entry so that the earlier entries have to be rolled back.
+        if (cipher_algorithm == SA_CIPHER_ALGORITHM_AES_GCM)
+            wrapped[BATCH_SIZE - 1].tag[0]++;
+        else
+            wrapped[BATCH_SIZE - 1].wrapped_key.back()++;
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), cipher_algorithm, *wrapping_key);
+        ASSERT_NE(status, SA_STATUS_OK);
+        for (auto& entry : entries)
+            ASSERT_EQ(entry.key, INVALID_HANDLE);
+    }
+
+    TEST_P(SaKeyUnwrapBatchTest, failsNoUnwrapRights) {
+        sa_cipher_algorithm cipher_algorithm = GetParam();
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        sa_rights wrapping_key_rights = rights;
+        SA_USAGE_BIT_CLEAR(wrapping_key_rights.usage_flags, SA_USAGE_FLAG_UNWRAP);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&wrapping_key_rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+        if (*wrapping_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, cipher_algorithm, clear_wrapping_key));
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), cipher_algorithm, *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_OPERATION_NOT_ALLOWED);
+    }
+
+    TEST_P(SaKeyUnwrapBatchTest, failsNullAlgorithmParameters) {
+        sa_cipher_algorithm cipher_algorithm = GetParam();
+        if (cipher_algorithm == SA_CIPHER_ALGORITHM_AES_ECB || cipher_algorithm == SA_CIPHER_ALGORITHM_AES_ECB_PKCS7)
+            GTEST_SKIP() << "algorithm has no parameters";
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+        if (*wrapping_key == UNSUPPORTED_KEY)
+            GTEST_SKIP() << "key type, key size, or curve not supported";
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, cipher_algorithm, clear_wrapping_key));
+        entries[1].algorithm_parameters = nullptr;
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), cipher_algorithm, *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsNullEntries) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto wrapping_key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(wrapping_key, nullptr);
+
+        sa_status status = sa_key_unwrap_batch(nullptr, BATCH_SIZE, SA_CIPHER_ALGORITHM_AES_ECB, *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsZeroEntries) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, clear_wrapping_key));
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), 0, SA_CIPHER_ALGORITHM_AES_ECB, *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsNullRights) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, clear_wrapping_key));
+        entries[0].rights = nullptr;
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), SA_CIPHER_ALGORITHM_AES_ECB,
+                *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsNullIn) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, clear_wrapping_key));
+        entries[BATCH_SIZE - 1].in = nullptr;
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), SA_CIPHER_ALGORITHM_AES_ECB,
+                *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsInvalidInLength) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, clear_wrapping_key));
+        entries[2].in_length--;
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), SA_CIPHER_ALGORITHM_AES_ECB,
+                *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+        for (auto& entry : entries)
+            ASSERT_EQ(entry.key, INVALID_HANDLE);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsInvalidAlgorithm) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_wrapping_key = random(SYM_128_KEY_SIZE);
+        auto wrapping_key = create_sa_key_symmetric(&rights, clear_wrapping_key);
+        ASSERT_NE(wrapping_key, nullptr);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, clear_wrapping_key));
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), SA_CIPHER_ALGORITHM_RSA_OAEP,
+                *wrapping_key);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaKeyUnwrapBatchTest, failsInvalidWrappingKey) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        std::vector<wrapped_entry> wrapped;
+        std::vector<sa_unwrap_batch_entry> entries;
+        ASSERT_TRUE(wrap_entries(wrapped, entries, &rights, SA_CIPHER_ALGORITHM_AES_ECB, random(SYM_128_KEY_SIZE)));
+
+        sa_status status = sa_key_unwrap_batch(entries.data(), entries.size(), SA_CIPHER_ALGORITHM_AES_ECB,
+                INVALID_HANDLE);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
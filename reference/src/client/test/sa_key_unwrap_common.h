@@ -143,4 +143,6 @@ class SaKeyUnwrapRsaTest : public ::testing::TestWithParam<sa_cipher_algorithm>,
 
 class SaKeyUnwrapEcTest : public ::testing::Test, public SaKeyUnwrapBase {};
 
+class SaKeyUnwrapBatchTest : public ::testing::TestWithParam<sa_cipher_algorithm>, public SaKeyUnwrapBase {};
+
 #endif // SA_KEY_UNWRAP_COMMON_H
@@ -0,0 +1,213 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_provider_common.h"
+#include <gtest/gtest.h>
+#include <openssl/evp.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+using namespace client_test_helpers;
+
+#define DATA_LENGTH 1024
+#define UPDATE_LENGTH 100
+
+static bool is_aead(const char* name) {
+    return strstr(name, "GCM") != nullptr || strstr(name, "Poly1305") != nullptr;
+}
+
+static std::shared_ptr<sa_key> create_key(
+        const char* name,
+        std::vector<uint8_t>& clear_key) {
+
+    sa_rights rights;
+    sa_rights_set_allow_all(&rights);
+    auto key = create_sa_key_symmetric(&rights, clear_key);
+    if (key == nullptr || strncmp(name, "ChaCha20", 8) != 0)
+        return key;
+
+    // Check for algorithm support.
+    auto cipher_context = create_uninitialized_sa_crypto_cipher_context();
+    auto nonce = random(CHACHA20_NONCE_LENGTH);
+    auto counter = random(CHACHA20_COUNTER_LENGTH);
+    sa_cipher_parameters_chacha20 parameters = {counter.data(), counter.size(), nonce.data(), nonce.size()};
+    if (sa_crypto_cipher_init(cipher_context.get(), SA_CIPHER_ALGORITHM_CHACHA20, SA_CIPHER_MODE_ENCRYPT, *key,
+                &parameters) == SA_STATUS_OPERATION_NOT_SUPPORTED)
+        *key = UNSUPPORTED_KEY;
+
+    return key;
+}
+
+TEST_P(SaProviderCipherTest, encryptTest) {
+    const char* name = std::get<0>(GetParam());
+    int padded = std::get<1>(GetParam());
+    int key_length = std::get<2>(GetParam());
+    int iv_length = std::get<3>(GetParam());
+
+    ASSERT_NE(provider, nullptr);
+    std::shared_ptr<EVP_CIPHER> cipher(EVP_CIPHER_fetch(libctx, name, SA_PROVIDER_PROPERTY_QUERY), EVP_CIPHER_free);
+    ASSERT_NE(cipher, nullptr);
+    std::shared_ptr<EVP_CIPHER> clear_cipher(EVP_CIPHER_fetch(nullptr, name, nullptr), EVP_CIPHER_free);
+    ASSERT_NE(clear_cipher, nullptr);
+
+    auto clear_key = random(key_length);
+    auto key = create_key(name, clear_key);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "algorithm not supported";
+
+    auto data = random(DATA_LENGTH);
+    auto iv = random(iv_length);
+    auto aad = is_aead(name) ? random(256) : std::vector<uint8_t>(0);
+    std::vector<uint8_t> encrypted(DATA_LENGTH + AES_BLOCK_SIZE);
+
+    std::shared_ptr<EVP_CIPHER_CTX> cipher_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    ASSERT_EQ(EVP_EncryptInit_ex2(cipher_ctx.get(), cipher.get(), reinterpret_cast<const unsigned char*>(key.get()),
+                      iv.empty() ? nullptr : iv.data(), nullptr),
+            1);
+    ASSERT_EQ(EVP_CIPHER_CTX_set_padding(cipher_ctx.get(), padded), 1);
+
+    int length;
+    int total_length = 0;
+    if (!aad.empty()) {
+        ASSERT_EQ(EVP_EncryptUpdate(cipher_ctx.get(), nullptr, &length, aad.data(), static_cast<int>(aad.size())), 1);
+    }
+
+    // Uneven updates exercise the buffering of partial blocks.
+    for (size_t i = 0; i < data.size(); i += UPDATE_LENGTH) {
+        int update_length = static_cast<int>(std::min<size_t>(UPDATE_LENGTH, data.size() - i));
+        ASSERT_EQ(EVP_EncryptUpdate(cipher_ctx.get(), encrypted.data() + total_length, &length, data.data() + i,
+                          update_length),
+                1);
+        total_length += length;
+    }
+
+    ASSERT_EQ(EVP_EncryptFinal_ex(cipher_ctx.get(), encrypted.data() + total_length, &length), 1);
+    total_length += length;
+    encrypted.resize(total_length);
+
+    std::vector<uint8_t> tag;
+    if (is_aead(name)) {
+        tag.resize(MAX_GCM_TAG_LENGTH);
+        ASSERT_EQ(EVP_CIPHER_CTX_ctrl(cipher_ctx.get(), EVP_CTRL_AEAD_GET_TAG, static_cast<int>(tag.size()),
+                          tag.data()),
+                1);
+    }
+
+    ASSERT_TRUE(verifyEncrypt(encrypted, data, clear_key, iv, aad, tag, clear_cipher.get(), padded));
+}
+
+TEST_P(SaProviderCipherTest, decryptTest) {
+    const char* name = std::get<0>(GetParam());
+    int padded = std::get<1>(GetParam());
+    int key_length = std::get<2>(GetParam());
+    int iv_length = std::get<3>(GetParam());
+
+    ASSERT_NE(provider, nullptr);
+    std::shared_ptr<EVP_CIPHER> cipher(EVP_CIPHER_fetch(libctx, name, SA_PROVIDER_PROPERTY_QUERY), EVP_CIPHER_free);
+    ASSERT_NE(cipher, nullptr);
+    std::shared_ptr<EVP_CIPHER> clear_cipher(EVP_CIPHER_fetch(nullptr, name, nullptr), EVP_CIPHER_free);
+    ASSERT_NE(clear_cipher, nullptr);
+
+    auto clear_key = random(key_length);
+    auto key = create_key(name, clear_key);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "algorithm not supported";
+
+    auto data = random(DATA_LENGTH);
+    auto iv = random(iv_length);
+    auto aad = is_aead(name) ? random(256) : std::vector<uint8_t>(0);
+    std::vector<uint8_t> tag(is_aead(name) ? MAX_GCM_TAG_LENGTH : 0);
+    std::vector<uint8_t> encrypted(DATA_LENGTH + AES_BLOCK_SIZE);
+    ASSERT_TRUE(doEncrypt(encrypted, data, clear_key, iv, aad, tag, clear_cipher.get(), padded));
+
+    std::shared_ptr<EVP_CIPHER_CTX> cipher_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    ASSERT_EQ(EVP_DecryptInit_ex2(cipher_ctx.get(), cipher.get(), reinterpret_cast<const unsigned char*>(key.get()),
+                      iv.empty() ? nullptr : iv.data(), nullptr),
+            1);
+    ASSERT_EQ(EVP_CIPHER_CTX_set_padding(cipher_ctx.get(), padded), 1);
+
+    int length;
+    int total_length = 0;
+    if (!aad.empty()) {
+        ASSERT_EQ(EVP_DecryptUpdate(cipher_ctx.get(), nullptr, &length, aad.data(), static_cast<int>(aad.size())), 1);
+    }
+
+    std::vector<uint8_t> decrypted(encrypted.size() + AES_BLOCK_SIZE);
+    for (size_t i = 0; i < encrypted.size(); i += UPDATE_LENGTH) {
+        int update_length = static_cast<int>(std::min<size_t>(UPDATE_LENGTH, encrypted.size() - i));
+        ASSERT_EQ(EVP_DecryptUpdate(cipher_ctx.get(), decrypted.data() + total_length, &length, encrypted.data() + i,
+                          update_length),
+                1);
+        total_length += length;
+    }
+
+    if (!tag.empty()) {
+        ASSERT_EQ(EVP_CIPHER_CTX_ctrl(cipher_ctx.get(), EVP_CTRL_AEAD_SET_TAG, static_cast<int>(tag.size()),
+                          tag.data()),
+                1);
+    }
+
+    ASSERT_EQ(EVP_DecryptFinal_ex(cipher_ctx.get(), decrypted.data() + total_length, &length), 1);
+    total_length += length;
+    decrypted.resize(total_length);
+    ASSERT_EQ(decrypted, data);
+}
+
+TEST_P(SaProviderCipherTest, failsWrongKeySize) {
+    const char* name = std::get<0>(GetParam());
+    int key_length = std::get<2>(GetParam());
+    int iv_length = std::get<3>(GetParam());
+
+    ASSERT_NE(provider, nullptr);
+    std::shared_ptr<EVP_CIPHER> cipher(EVP_CIPHER_fetch(libctx, name, SA_PROVIDER_PROPERTY_QUERY), EVP_CIPHER_free);
+    ASSERT_NE(cipher, nullptr);
+
+    sa_rights rights;
+    sa_rights_set_allow_all(&rights);
+    auto key = create_sa_key_symmetric(&rights, random(key_length == SYM_128_KEY_SIZE ? SYM_256_KEY_SIZE :
+                                                                                        SYM_128_KEY_SIZE));
+    ASSERT_NE(key, nullptr);
+    auto iv = random(iv_length);
+    std::shared_ptr<EVP_CIPHER_CTX> cipher_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    ASSERT_NE(EVP_EncryptInit_ex2(cipher_ctx.get(), cipher.get(), reinterpret_cast<const unsigned char*>(key.get()),
+                      iv.empty() ? nullptr : iv.data(), nullptr),
+            1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderCipherTests,
+        SaProviderCipherTest,
+        ::testing::Values(
+                std::make_tuple("ChaCha20", true, 32, 16),
+                std::make_tuple("ChaCha20-Poly1305", true, 32, 12),
+                std::make_tuple("AES-128-ECB", true, 16, 0),
+                std::make_tuple("AES-128-ECB", false, 16, 0),
+                std::make_tuple("AES-256-ECB", true, 32, 0),
+                std::make_tuple("AES-256-ECB", false, 32, 0),
+                std::make_tuple("AES-128-CBC", true, 16, 16),
+                std::make_tuple("AES-128-CBC", false, 16, 16),
+                std::make_tuple("AES-256-CBC", true, 32, 16),
+                std::make_tuple("AES-256-CBC", false, 32, 16),
+                std::make_tuple("AES-128-CTR", false, 16, 16),
+                std::make_tuple("AES-256-CTR", false, 32, 16),
+                std::make_tuple("AES-128-GCM", false, 16, 12),
+                std::make_tuple("AES-256-GCM", false, 32, 12)));
+#endif
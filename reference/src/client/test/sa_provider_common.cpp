@@ -0,0 +1,38 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sa_provider_common.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+
+SaProviderBase::SaProviderBase() {
+    libctx = OSSL_LIB_CTX_new();
+    if (libctx != nullptr)
+        provider = sa_provider_load(libctx);
+}
+
+SaProviderBase::~SaProviderBase() {
+    sa_provider_unload(provider);
+    OSSL_LIB_CTX_free(libctx);
+}
+
+std::shared_ptr<EVP_PKEY> SaProviderBase::load_private_key(sa_key key) {
+    return {sa_provider_load_private_key(libctx, key), EVP_PKEY_free};
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_engine_common.h"
+#include "sa_provider.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef SA_PROVIDER_COMMON_H
+#define SA_PROVIDER_COMMON_H
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+
+// Each test gets its own library context with the provider loaded, so fetches never select another provider.
+class SaProviderBase : public SaEngineTest {
+protected:
+    SaProviderBase();
+
+    ~SaProviderBase();
+
+    std::shared_ptr<EVP_PKEY> load_private_key(sa_key key);
+
+    OSSL_LIB_CTX* libctx = nullptr;
+    OSSL_PROVIDER* provider = nullptr;
+};
+
+using SaProviderCipherTestType = std::tuple<const char*, int, int, int>;
+
+class SaProviderCipherTest : public ::testing::TestWithParam<SaProviderCipherTestType>,
+                             public SaProviderBase {};
+
+using SaProviderPkeySignTestType = std::tuple<sa_key_type, size_t, const char*, int>;
+
+class SaProviderPkeySignTest : public ::testing::TestWithParam<SaProviderPkeySignTestType>,
+                               public SaProviderBase {};
+
+using SaProviderPkeyDecryptTestType = std::tuple<size_t, int>;
+
+class SaProviderPkeyDecryptTest : public ::testing::TestWithParam<SaProviderPkeyDecryptTestType>,
+                                  public SaProviderBase {};
+
+using SaProviderPkeyDeriveTestType = std::tuple<sa_key_type, size_t>;
+
+class SaProviderPkeyDeriveTest : public ::testing::TestWithParam<SaProviderPkeyDeriveTestType>,
+                                 public SaProviderBase,
+                                 public SaKeyBase {};
+
+#endif
+
+#endif //SA_PROVIDER_COMMON_H
@@ -0,0 +1,339 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_provider_common.h"
+#include <gtest/gtest.h>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+using namespace client_test_helpers;
+
+// Returns the public key of key loaded into the default library context, independent of the provider.
+static std::shared_ptr<EVP_PKEY> get_public_key(sa_key key) {
+    size_t out_length = 0;
+    if (sa_key_get_public(nullptr, &out_length, key) != SA_STATUS_OK)
+        return nullptr;
+
+    std::vector<uint8_t> out(out_length);
+    if (sa_key_get_public(out.data(), &out_length, key) != SA_STATUS_OK)
+        return nullptr;
+
+    const uint8_t* p_out = out.data();
+    return {d2i_PUBKEY(nullptr, &p_out, static_cast<long>(out_length)), EVP_PKEY_free};
+}
+
+static bool set_sign_parameters(
+        EVP_PKEY_CTX* evp_pkey_ctx,
+        sa_key_type key_type,
+        int padding) {
+
+    if (key_type != SA_KEY_TYPE_RSA)
+        return true;
+
+    if (EVP_PKEY_CTX_set_rsa_padding(evp_pkey_ctx, padding) != 1)
+        return false;
+
+    return padding != RSA_PKCS1_PSS_PADDING ||
+           EVP_PKEY_CTX_set_rsa_pss_saltlen(evp_pkey_ctx, RSA_PSS_SALTLEN_AUTO) == 1;
+}
+
+TEST_P(SaProviderPkeySignTest, digestSignTest) {
+    auto key_type = std::get<0>(GetParam());
+    auto key_length = std::get<1>(GetParam());
+    const char* md_name = std::get<2>(GetParam());
+    auto padding = std::get<3>(GetParam());
+
+    std::vector<uint8_t> clear_key;
+    sa_elliptic_curve curve;
+    auto key = create_sa_key(key_type, key_length, clear_key, curve);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "key type, key size, or curve not supported";
+
+    ASSERT_NE(provider, nullptr);
+    auto evp_pkey = load_private_key(*key);
+    ASSERT_NE(evp_pkey, nullptr);
+
+    auto data = random(256);
+    std::shared_ptr<EVP_MD_CTX> evp_md_sign_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    ASSERT_NE(evp_md_sign_ctx, nullptr);
+    EVP_PKEY_CTX* evp_pkey_sign_ctx = nullptr;
+    ASSERT_EQ(EVP_DigestSignInit_ex(evp_md_sign_ctx.get(), &evp_pkey_sign_ctx, md_name, libctx, nullptr,
+                      evp_pkey.get(), nullptr),
+            1);
+    ASSERT_TRUE(set_sign_parameters(evp_pkey_sign_ctx, key_type, padding));
+    size_t signature_length = 0;
+    std::vector<uint8_t> signature;
+    if (md_name == nullptr) {
+        // EdDSA is one shot.
+        ASSERT_EQ(EVP_DigestSign(evp_md_sign_ctx.get(), nullptr, &signature_length, data.data(), data.size()), 1);
+        signature.resize(signature_length);
+        ASSERT_EQ(EVP_DigestSign(evp_md_sign_ctx.get(), signature.data(), &signature_length, data.data(),
+                          data.size()),
+                1);
+    } else {
+        ASSERT_EQ(EVP_DigestSignUpdate(evp_md_sign_ctx.get(), data.data(), data.size()), 1);
+        ASSERT_EQ(EVP_DigestSignFinal(evp_md_sign_ctx.get(), nullptr, &signature_length), 1);
+        signature.resize(signature_length);
+        ASSERT_EQ(EVP_DigestSignFinal(evp_md_sign_ctx.get(), signature.data(), &signature_length), 1);
+    }
+
+    signature.resize(signature_length);
+
+    // Verify through the provider.
+    std::shared_ptr<EVP_MD_CTX> evp_md_verify_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    ASSERT_NE(evp_md_verify_ctx, nullptr);
+    EVP_PKEY_CTX* evp_pkey_verify_ctx = nullptr;
+    ASSERT_EQ(EVP_DigestVerifyInit_ex(evp_md_verify_ctx.get(), &evp_pkey_verify_ctx, md_name, libctx, nullptr,
+                      evp_pkey.get(), nullptr),
+            1);
+    ASSERT_TRUE(set_sign_parameters(evp_pkey_verify_ctx, key_type, padding));
+    ASSERT_EQ(EVP_DigestVerify(evp_md_verify_ctx.get(), signature.data(), signature.size(), data.data(), data.size()),
+            1);
+
+    // Verify with the default provider.
+    auto public_key = get_public_key(*key);
+    ASSERT_NE(public_key, nullptr);
+    evp_md_verify_ctx = std::shared_ptr<EVP_MD_CTX>(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    ASSERT_EQ(EVP_DigestVerifyInit_ex(evp_md_verify_ctx.get(), &evp_pkey_verify_ctx, md_name, nullptr, nullptr,
+                      public_key.get(), nullptr),
+            1);
+    ASSERT_TRUE(set_sign_parameters(evp_pkey_verify_ctx, key_type, padding));
+    ASSERT_EQ(EVP_DigestVerify(evp_md_verify_ctx.get(), signature.data(), signature.size(), data.data(), data.size()),
+            1);
+}
+
+TEST_P(SaProviderPkeySignTest, signTest) {
+    auto key_type = std::get<0>(GetParam());
+    auto key_length = std::get<1>(GetParam());
+    const char* md_name = std::get<2>(GetParam());
+    auto padding = std::get<3>(GetParam());
+    if (md_name == nullptr)
+        GTEST_SKIP() << "EdDSA does not sign a digest";
+
+    std::vector<uint8_t> clear_key;
+    sa_elliptic_curve curve;
+    auto key = create_sa_key(key_type, key_length, clear_key, curve);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "key type, key size, or curve not supported";
+
+    ASSERT_NE(provider, nullptr);
+    auto evp_pkey = load_private_key(*key);
+    ASSERT_NE(evp_pkey, nullptr);
+
+    auto data = random(256);
+    std::vector<uint8_t> digest(EVP_MAX_MD_SIZE);
+    unsigned int digest_length;
+    std::shared_ptr<EVP_MD> evp_md(EVP_MD_fetch(nullptr, md_name, nullptr), EVP_MD_free);
+    ASSERT_EQ(EVP_Digest(data.data(), data.size(), digest.data(), &digest_length, evp_md.get(), nullptr), 1);
+    digest.resize(digest_length);
+
+    std::shared_ptr<EVP_PKEY_CTX> evp_pkey_ctx(EVP_PKEY_CTX_new_from_pkey(libctx, evp_pkey.get(), nullptr),
+            EVP_PKEY_CTX_free);
+    ASSERT_NE(evp_pkey_ctx, nullptr);
+    ASSERT_EQ(EVP_PKEY_sign_init(evp_pkey_ctx.get()), 1);
+    ASSERT_TRUE(set_sign_parameters(evp_pkey_ctx.get(), key_type, padding));
+    ASSERT_EQ(EVP_PKEY_CTX_set_signature_md(evp_pkey_ctx.get(), evp_md.get()), 1);
+    size_t signature_length = 0;
+    ASSERT_EQ(EVP_PKEY_sign(evp_pkey_ctx.get(), nullptr, &signature_length, digest.data(), digest.size()), 1);
+    std::vector<uint8_t> signature(signature_length);
+    ASSERT_EQ(EVP_PKEY_sign(evp_pkey_ctx.get(), signature.data(), &signature_length, digest.data(), digest.size()),
+            1);
+    signature.resize(signature_length);
+
+    auto public_key = get_public_key(*key);
+    ASSERT_NE(public_key, nullptr);
+    std::shared_ptr<EVP_PKEY_CTX> verify_pkey_ctx(EVP_PKEY_CTX_new(public_key.get(), nullptr), EVP_PKEY_CTX_free);
+    ASSERT_NE(verify_pkey_ctx, nullptr);
+    ASSERT_EQ(EVP_PKEY_verify_init(verify_pkey_ctx.get()), 1);
+    ASSERT_TRUE(set_sign_parameters(verify_pkey_ctx.get(), key_type, padding));
+    ASSERT_EQ(EVP_PKEY_CTX_set_signature_md(verify_pkey_ctx.get(), evp_md.get()), 1);
+    ASSERT_EQ(EVP_PKEY_verify(verify_pkey_ctx.get(), signature.data(), signature.size(), digest.data(),
+                      digest.size()),
+            1);
+}
+
+TEST_P(SaProviderPkeyDecryptTest, decryptTest) {
+    auto key_length = std::get<0>(GetParam());
+    auto padding = std::get<1>(GetParam());
+
+    std::vector<uint8_t> clear_key;
+    sa_elliptic_curve curve;
+    auto key = create_sa_key(SA_KEY_TYPE_RSA, key_length, clear_key, curve);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "key type or key size not supported";
+
+    ASSERT_NE(provider, nullptr);
+    auto evp_pkey = load_private_key(*key);
+    ASSERT_NE(evp_pkey, nullptr);
+
+    auto public_key = get_public_key(*key);
+    ASSERT_NE(public_key, nullptr);
+    auto data = random(32);
+    std::shared_ptr<EVP_PKEY_CTX> encrypt_pkey_ctx(EVP_PKEY_CTX_new(public_key.get(), nullptr), EVP_PKEY_CTX_free);
+    ASSERT_EQ(EVP_PKEY_encrypt_init(encrypt_pkey_ctx.get()), 1);
+    ASSERT_EQ(EVP_PKEY_CTX_set_rsa_padding(encrypt_pkey_ctx.get(), padding), 1);
+    size_t encrypted_length = 0;
+    ASSERT_EQ(EVP_PKEY_encrypt(encrypt_pkey_ctx.get(), nullptr, &encrypted_length, data.data(), data.size()), 1);
+    std::vector<uint8_t> encrypted(encrypted_length);
+    ASSERT_EQ(EVP_PKEY_encrypt(encrypt_pkey_ctx.get(), encrypted.data(), &encrypted_length, data.data(),
+                      data.size()),
+            1);
+    encrypted.resize(encrypted_length);
+
+    std::shared_ptr<EVP_PKEY_CTX> decrypt_pkey_ctx(EVP_PKEY_CTX_new_from_pkey(libctx, evp_pkey.get(), nullptr),
+            EVP_PKEY_CTX_free);
+    ASSERT_NE(decrypt_pkey_ctx, nullptr);
+    ASSERT_EQ(EVP_PKEY_decrypt_init(decrypt_pkey_ctx.get()), 1);
+    ASSERT_EQ(EVP_PKEY_CTX_set_rsa_padding(decrypt_pkey_ctx.get(), padding), 1);
+    size_t decrypted_length = 0;
+    ASSERT_EQ(EVP_PKEY_decrypt(decrypt_pkey_ctx.get(), nullptr, &decrypted_length, encrypted.data(),
+                      encrypted.size()),
+            1);
+    std::vector<uint8_t> decrypted(decrypted_length);
+    ASSERT_EQ(EVP_PKEY_decrypt(decrypt_pkey_ctx.get(), decrypted.data(), &decrypted_length, encrypted.data(),
+                      encrypted.size()),
+            1);
+    decrypted.resize(decrypted_length);
+    ASSERT_EQ(decrypted, data);
+}
+
+TEST_P(SaProviderPkeyDeriveTest, deriveTest) {
+    auto key_type = std::get<0>(GetParam());
+    auto key_length = std::get<1>(GetParam());
+
+    std::vector<uint8_t> clear_key;
+    sa_elliptic_curve curve;
+    auto key = create_sa_key(key_type, key_length, clear_key, curve);
+    ASSERT_NE(key, nullptr);
+    if (*key == UNSUPPORTED_KEY)
+        GTEST_SKIP() << "key type, key size, or curve not supported";
+
+    ASSERT_NE(provider, nullptr);
+    auto evp_pkey = load_private_key(*key);
+    ASSERT_NE(evp_pkey, nullptr);
+    auto public_key = get_public_key(*key);
+    ASSERT_NE(public_key, nullptr);
+
+    std::vector<uint8_t> clear_shared_secret;
+    std::shared_ptr<EVP_PKEY> other_private_key;
+    std::vector<uint8_t> other_public_key;
+    if (key_type == SA_KEY_TYPE_DH) {
+        std::tuple<std::vector<uint8_t>, std::vector<uint8_t>> dh_parameters = get_dh_parameters(key_length);
+        ASSERT_TRUE(dh_generate_key(other_private_key, other_public_key, std::get<0>(dh_parameters),
+                std::get<1>(dh_parameters)));
+        ASSERT_TRUE(dh_compute_secret(clear_shared_secret, other_private_key, public_key));
+    } else {
+        ASSERT_EQ(ec_generate_key(curve, other_private_key, other_public_key), SA_STATUS_OK);
+        ASSERT_TRUE(ecdh_compute_secret(clear_shared_secret, other_private_key, public_key));
+    }
+
+    std::vector<uint8_t> clear_derived_key(SYM_128_KEY_SIZE);
+    auto info = random(AES_BLOCK_SIZE);
+    ASSERT_TRUE(concat_kdf(clear_derived_key, clear_shared_secret, info, SA_DIGEST_ALGORITHM_SHA256));
+
+    std::shared_ptr<EVP_PKEY_CTX> evp_pkey_ctx(EVP_PKEY_CTX_new_from_pkey(libctx, evp_pkey.get(), nullptr),
+            EVP_PKEY_CTX_free);
+    ASSERT_NE(evp_pkey_ctx, nullptr);
+    ASSERT_EQ(EVP_PKEY_derive_init(evp_pkey_ctx.get()), 1);
+    ASSERT_EQ(EVP_PKEY_derive_set_peer(evp_pkey_ctx.get(), other_private_key.get()), 1);
+    size_t shared_secret_size = 0;
+    ASSERT_EQ(EVP_PKEY_derive(evp_pkey_ctx.get(), nullptr, &shared_secret_size), 1);
+    std::vector<uint8_t> shared_secret(shared_secret_size);
+    size_t written = shared_secret_size;
+    ASSERT_EQ(EVP_PKEY_derive(evp_pkey_ctx.get(), shared_secret.data(), &written), 1);
+    ASSERT_EQ(written, sizeof(sa_key));
+
+    auto shared_secret_key = std::shared_ptr<sa_key>(new sa_key(*reinterpret_cast<sa_key*>(shared_secret.data())),
+            [](const sa_key* p) {
+                sa_key_release(*p);
+                delete p;
+            });
+    sa_kdf_parameters_concat kdf_parameters_concat = {
+            .key_length = SYM_128_KEY_SIZE,
+            .digest_algorithm = SA_DIGEST_ALGORITHM_SHA256,
+            .parent = *shared_secret_key,
+            .info = info.data(),
+            .info_length = info.size()};
+    auto derived_key = create_uninitialized_sa_key();
+    ASSERT_NE(derived_key, nullptr);
+    sa_rights rights;
+    sa_rights_set_allow_all(&rights);
+    ASSERT_EQ(sa_key_derive(derived_key.get(), &rights, SA_KDF_ALGORITHM_CONCAT, &kdf_parameters_concat),
+            SA_STATUS_OK);
+    ASSERT_TRUE(key_check_sym(*derived_key, clear_derived_key));
+}
+
+// clang-format off
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyRsaTests,
+        SaProviderPkeySignTest,
+        ::testing::Combine(
+                ::testing::Values(SA_KEY_TYPE_RSA),
+                ::testing::Values(RSA_1024_BYTE_LENGTH, RSA_2048_BYTE_LENGTH),
+                ::testing::Values("SHA1", "SHA256", "SHA384", "SHA512"),
+                ::testing::Values(RSA_PKCS1_PADDING, RSA_PKCS1_PSS_PADDING)));
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyEcTests,
+        SaProviderPkeySignTest,
+        ::testing::Combine(
+                ::testing::Values(SA_KEY_TYPE_EC),
+                ::testing::Values(SA_ELLIPTIC_CURVE_NIST_P256, SA_ELLIPTIC_CURVE_NIST_P384,
+                    SA_ELLIPTIC_CURVE_NIST_P521),
+                ::testing::Values("SHA1", "SHA256", "SHA384", "SHA512"),
+                ::testing::Values(0)));
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyEdTests,
+        SaProviderPkeySignTest,
+        ::testing::Combine(
+                ::testing::Values(SA_KEY_TYPE_EC),
+                ::testing::Values(SA_ELLIPTIC_CURVE_ED25519, SA_ELLIPTIC_CURVE_ED448),
+                ::testing::Values(nullptr),
+                ::testing::Values(0)));
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyDecryptTests,
+        SaProviderPkeyDecryptTest,
+        ::testing::Combine(
+                ::testing::Values(RSA_1024_BYTE_LENGTH, RSA_2048_BYTE_LENGTH),
+                ::testing::Values(RSA_PKCS1_PADDING, RSA_PKCS1_OAEP_PADDING)));
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyDeriveDhTests,
+        SaProviderPkeyDeriveTest,
+        ::testing::Combine(
+                ::testing::Values(SA_KEY_TYPE_DH),
+                ::testing::Values(DH_2048_BYTE_LENGTH)));
+
+INSTANTIATE_TEST_SUITE_P(
+        SaProviderPkeyDeriveEcTests,
+        SaProviderPkeyDeriveTest,
+        ::testing::Combine(
+                ::testing::Values(SA_KEY_TYPE_EC),
+                ::testing::Values(SA_ELLIPTIC_CURVE_NIST_P256, SA_ELLIPTIC_CURVE_NIST_P384, SA_ELLIPTIC_CURVE_X25519,
+                    SA_ELLIPTIC_CURVE_X448)));
+// clang-format on
+#endif
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <future>
+
+using namespace client_test_helpers;
+
+namespace {
+    // The pool can only be created before the first SecApi call, so the pool mode tests only run when saclienttest is
+    // started with SA_SESSION_POOL_SIZE set.
+    size_t pool_size() {
+        const char* pool_size = getenv("SA_SESSION_POOL_SIZE");
+        return pool_size == nullptr ? 0 : strtoul(pool_size, nullptr, 10);
+    }
+
+    sa_status key_header_on_session(
+            size_t index,
+            sa_key key) {
+
+        sa_status status = sa_session_pool_bind(index);
+        if (status != SA_STATUS_OK)
+            return status;
+
+        sa_header header;
+        return sa_key_header(&header, key);
+    }
+
+    TEST(SaSessionPool, nominalSharedHandles) {
+        if (pool_size() == 0)
+            GTEST_SKIP() << "SA_SESSION_POOL_SIZE not set";
+
+        ASSERT_EQ(sa_session_pool_bind(0), SA_STATUS_OK);
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        auto key = create_sa_key_symmetric(&rights, random(SYM_128_KEY_SIZE));
+        ASSERT_NE(key, nullptr);
+
+        std::future<sa_status> future = std::async(std::launch::async, key_header_on_session, 0, *key);
+        ASSERT_EQ(future.get(), SA_STATUS_OK);
+
+        if (pool_size() > 1) {
+            future = std::async(std::launch::async, key_header_on_session, 1, *key);
+            ASSERT_EQ(future.get(), SA_STATUS_INVALID_PARAMETER);
+        }
+    }
+
+    TEST(SaSessionPool, failsInitAfterFirstCall) {
+        sa_version version;
+        ASSERT_EQ(sa_get_version(&version), SA_STATUS_OK);
+
+        sa_status status = sa_session_pool_init(2);
+        ASSERT_EQ(status, SA_STATUS_OPERATION_NOT_ALLOWED);
+    }
+
+    TEST(SaSessionPool, failsInitZeroSessions) {
+        sa_status status = sa_session_pool_init(0);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST(SaSessionPool, failsBindOutOfRange) {
+        sa_status status = sa_session_pool_bind(SIZE_MAX);
+        ASSERT_EQ(status, pool_size() == 0 ? SA_STATUS_OPERATION_NOT_ALLOWED : SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
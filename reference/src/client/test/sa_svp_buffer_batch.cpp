@@ -0,0 +1,118 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_svp_common.h"
+#include "gtest/gtest.h"
+
+using namespace client_test_helpers;
+
+namespace {
+    TEST_F(SaSvpBufferBatchTest, nominal) {
+        auto in_buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(in_buffer, nullptr);
+        auto out_buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(1024);
+
+        std::vector<sa_svp_offset> write_offsets = {{0, 512, 512}, {512, 0, 512}};
+        std::vector<sa_svp_offset> copy_offsets;
+        for (size_t offset = 0; offset < 1024; offset += 64)
+            copy_offsets.push_back({offset, offset, 64});
+
+        std::vector<sa_svp_batch_entry> entries = {
+                {*in_buffer, INVALID_HANDLE, write_offsets.data(), write_offsets.size()},
+                {*out_buffer, *in_buffer, copy_offsets.data(), copy_offsets.size()}};
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        // Contents verified in taimpltest.
+    }
+
+    TEST_F(SaSvpBufferBatchTest, nominalCopiesOnly) {
+        auto in_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(in_buffer, nullptr);
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        sa_svp_offset offset = {0, 0, AES_BLOCK_SIZE};
+        sa_svp_batch_entry entry = {*out_buffer, *in_buffer, &offset, 1};
+        sa_status status = sa_svp_buffer_batch(nullptr, 0, &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_OK);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsOutBufferTooSmall) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {1, 0, in.size()};
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, &offset, 1};
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_INVALID_SVP_BUFFER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsInBufferTooSmall) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(in_buffer, nullptr);
+        sa_svp_offset offset = {0, 1, AES_BLOCK_SIZE};
+        sa_svp_batch_entry entry = {*out_buffer, *in_buffer, &offset, 1};
+        sa_status status = sa_svp_buffer_batch(nullptr, 0, &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_INVALID_SVP_BUFFER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsNullIn) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        sa_svp_offset offset = {0, 0, 1};
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, &offset, 1};
+        sa_status status = sa_svp_buffer_batch(nullptr, 1, &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsNullEntries) {
+        auto in = random(AES_BLOCK_SIZE);
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), nullptr, 1);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsZeroEntries) {
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_batch_entry entry = {};
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), &entry, 0);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsNullOffsets) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, nullptr, 0};
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferBatchTest, failsInvalidOut) {
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {0, 0, in.size()};
+        sa_svp_batch_entry entry = {INVALID_HANDLE, INVALID_HANDLE, &offset, 1};
+        sa_status status = sa_svp_buffer_batch(in.data(), in.size(), &entry, 1);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_svp_common.h"
+#include "gtest/gtest.h"
+
+using namespace client_test_helpers;
+
+namespace {
+    TEST_F(SaSvpBufferCheckRangesTest, failsRee) {
+        auto buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<sa_svp_range> ranges = {{0, 512}, {512, 512}};
+        std::vector<uint8_t> hashes(ranges.size() * SHA256_DIGEST_LENGTH);
+        sa_status status = sa_svp_buffer_check_ranges(*buffer, ranges.data(), ranges.size(),
+                SA_DIGEST_ALGORITHM_SHA256, hashes.data(), hashes.size());
+        ASSERT_EQ(status, SA_STATUS_OPERATION_NOT_ALLOWED);
+    }
+
+    TEST_F(SaSvpBufferCheckRangesTest, failsNullRanges) {
+        auto buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = sa_svp_buffer_check_ranges(*buffer, nullptr, 1, SA_DIGEST_ALGORITHM_SHA256, hashes.data(),
+                hashes.size());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferCheckRangesTest, failsNullHashes) {
+        auto buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(buffer, nullptr);
+        sa_svp_range range = {0, 1024};
+        sa_status status = sa_svp_buffer_check_ranges(*buffer, &range, 1, SA_DIGEST_ALGORITHM_SHA256, nullptr, 0);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+} // namespace
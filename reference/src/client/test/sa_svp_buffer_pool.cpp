@@ -0,0 +1,131 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_test_helpers.h"
+#include "sa.h"
+#include "sa_svp_common.h"
+#include "gtest/gtest.h"
+
+using namespace client_test_helpers;
+
+namespace {
+    TEST_F(SaSvpBufferPoolTest, nominal) {
+        auto pool = create_sa_svp_buffer_pool({AES_BLOCK_SIZE, 1024}, 2, 4);
+        ASSERT_NE(pool, nullptr);
+
+        sa_svp_buffer_pool_stats stats;
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.free_buffers, 4U);
+
+        sa_buffer buffer;
+        sa_status status = sa_svp_buffer_pool_acquire(&buffer, pool.get(), 100);
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_EQ(buffer.buffer_type, SA_BUFFER_TYPE_SVP);
+        ASSERT_EQ(buffer.context.svp.offset, 0U);
+
+        // The buffer comes from the 1024 byte class.
+        auto in = random(1024);
+        sa_svp_offset offset = {0, 0, in.size()};
+        status = sa_svp_buffer_write(buffer.context.svp.buffer, in.data(), in.size(), &offset, 1);
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.acquires, 1U);
+        ASSERT_EQ(stats.hits, 1U);
+        ASSERT_EQ(stats.in_use_buffers, 1U);
+        ASSERT_EQ(stats.free_buffers, 3U);
+
+        status = sa_svp_buffer_pool_release(pool.get(), buffer.context.svp.buffer);
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.releases, 1U);
+        ASSERT_EQ(stats.in_use_buffers, 0U);
+        ASSERT_EQ(stats.free_buffers, 4U);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, nominalGrowAndShrink) {
+        auto pool = create_sa_svp_buffer_pool({AES_BLOCK_SIZE}, 1, 3);
+        ASSERT_NE(pool, nullptr);
+
+        std::vector<sa_buffer> buffers(5);
+        for (auto& buffer : buffers)
+            ASSERT_EQ(sa_svp_buffer_pool_acquire(&buffer, pool.get(), AES_BLOCK_SIZE), SA_STATUS_OK);
+
+        sa_svp_buffer_pool_stats stats;
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.hits, 1U);
+        ASSERT_EQ(stats.misses, 4U);
+        ASSERT_EQ(stats.in_use_buffers, 5U);
+
+        // The class holds up to 3 free buffers. The 4th release shrinks it back to 1.
+        for (size_t i = 0; i < 3; i++)
+            ASSERT_EQ(sa_svp_buffer_pool_release(pool.get(), buffers[i].context.svp.buffer), SA_STATUS_OK);
+
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.free_buffers, 3U);
+        ASSERT_EQ(stats.shrinks, 0U);
+
+        ASSERT_EQ(sa_svp_buffer_pool_release(pool.get(), buffers[3].context.svp.buffer), SA_STATUS_OK);
+        ASSERT_EQ(sa_svp_buffer_pool_get_stats(&stats, pool.get()), SA_STATUS_OK);
+        ASSERT_EQ(stats.free_buffers, 1U);
+        ASSERT_EQ(stats.shrinks, 3U);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsNullPool) {
+        std::vector<size_t> size_classes = {AES_BLOCK_SIZE};
+        sa_svp_buffer_pool_parameters parameters = {size_classes.data(), size_classes.size(), 0, 0};
+        sa_status status = sa_svp_buffer_pool_create(nullptr, &parameters);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsNullParameters) {
+        sa_svp_buffer_pool* pool = nullptr;
+        sa_status status = sa_svp_buffer_pool_create(&pool, nullptr);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsUnorderedSizeClasses) {
+        auto pool = create_sa_svp_buffer_pool({1024, AES_BLOCK_SIZE}, 0, 0);
+        ASSERT_EQ(pool, nullptr);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsMaxFreeLessThanMinFree) {
+        auto pool = create_sa_svp_buffer_pool({AES_BLOCK_SIZE}, 2, 1);
+        ASSERT_EQ(pool, nullptr);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsSizeTooLarge) {
+        auto pool = create_sa_svp_buffer_pool({AES_BLOCK_SIZE}, 0, 1);
+        ASSERT_NE(pool, nullptr);
+
+        sa_buffer buffer;
+        sa_status status = sa_svp_buffer_pool_acquire(&buffer, pool.get(), AES_BLOCK_SIZE + 1);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(SaSvpBufferPoolTest, failsReleaseUnknownBuffer) {
+        auto pool = create_sa_svp_buffer_pool({AES_BLOCK_SIZE}, 0, 1);
+        ASSERT_NE(pool, nullptr);
+
+        auto svp_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(svp_buffer, nullptr);
+        sa_status status = sa_svp_buffer_pool_release(pool.get(), *svp_buffer);
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
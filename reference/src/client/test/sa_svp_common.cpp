@@ -48,6 +48,19 @@ std::shared_ptr<sa_svp_buffer> SaSvpBase::create_sa_svp_buffer(size_t size) {
     return svp_buffer;
 }
 
+std::shared_ptr<sa_svp_buffer_pool> SaSvpBufferPoolTest::create_sa_svp_buffer_pool(
+        const std::vector<size_t>& size_classes,
+        size_t min_free,
+        size_t max_free) {
+
+    sa_svp_buffer_pool_parameters parameters = {size_classes.data(), size_classes.size(), min_free, max_free};
+    sa_svp_buffer_pool* pool = nullptr;
+    if (sa_svp_buffer_pool_create(&pool, &parameters) != SA_STATUS_OK)
+        return nullptr;
+
+    return {pool, sa_svp_buffer_pool_destroy};
+}
+
 INSTANTIATE_TEST_SUITE_P(
         SaSvpBufferCopyTests,
         SaSvpBufferCopyTest,
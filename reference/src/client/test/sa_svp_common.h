@@ -23,6 +23,7 @@
 #include <cstddef>
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
 
 class SaSvpBase : public ::testing::Test {
 protected:
@@ -36,10 +37,22 @@ using SaSvpBufferTestType = std::tuple<long>;
 
 class SaSvpBufferCopyTest : public ::testing::WithParamInterface<SaSvpBufferTestType>, public SaSvpBase {};
 
+class SaSvpBufferBatchTest : public SaSvpBase {};
+
 class SaSvpBufferCheckTest : public SaSvpBase {};
 
+class SaSvpBufferCheckRangesTest : public SaSvpBase {};
+
 class SaSvpBufferCreateTest : public SaSvpBase {};
 
+class SaSvpBufferPoolTest : public SaSvpBase {
+protected:
+    static std::shared_ptr<sa_svp_buffer_pool> create_sa_svp_buffer_pool(
+            const std::vector<size_t>& size_classes,
+            size_t min_free,
+            size_t max_free);
+};
+
 class SaSvpBufferReleaseTest : public SaSvpBase {};
 
 class SaSvpBufferWriteTest : public ::testing::WithParamInterface<SaSvpBufferTestType>, public SaSvpBase {};
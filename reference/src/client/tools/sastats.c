@@ -0,0 +1,216 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// Dumps the TA command statistics obtained with sa_get_stats.
+//
+// Usage: sastats [-r]
+//   -r  write the raw snapshot to stdout instead of a table.
+
+#include "sa.h"
+#include "sa_ta_types.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* command_name(uint32_t command_id) {
+    static const char* names[] = {
+            [SA_GET_VERSION] = "sa_get_version",
+            [SA_GET_NAME] = "sa_get_name",
+            [SA_GET_DEVICE_ID] = "sa_get_device_id",
+            [SA_GET_TA_UUID] = "sa_get_ta_uuid",
+            [SA_KEY_GENERATE] = "sa_key_generate",
+            [SA_KEY_EXPORT] = "sa_key_export",
+            [SA_KEY_IMPORT] = "sa_key_import",
+            [SA_KEY_UNWRAP] = "sa_key_unwrap",
+            [SA_KEY_GET_PUBLIC] = "sa_key_get_public",
+            [SA_KEY_DERIVE] = "sa_key_derive",
+            [SA_KEY_EXCHANGE] = "sa_key_exchange",
+            [SA_KEY_RELEASE] = "sa_key_release",
+            [SA_KEY_HEADER] = "sa_key_header",
+            [SA_KEY_DIGEST] = "sa_key_digest",
+            [SA_CRYPTO_RANDOM] = "sa_crypto_random",
+            [SA_CRYPTO_CIPHER_INIT] = "sa_crypto_cipher_init",
+            [SA_CRYPTO_CIPHER_UPDATE_IV] = "sa_crypto_cipher_update_iv",
+            [SA_CRYPTO_CIPHER_PROCESS] = "sa_crypto_cipher_process",
+            [SA_CRYPTO_CIPHER_PROCESS_LAST] = "sa_crypto_cipher_process_last",
+            [SA_CRYPTO_CIPHER_RELEASE] = "sa_crypto_cipher_release",
+            [SA_CRYPTO_MAC_INIT] = "sa_crypto_mac_init",
+            [SA_CRYPTO_MAC_PROCESS] = "sa_crypto_mac_process",
+            [SA_CRYPTO_MAC_PROCESS_KEY] = "sa_crypto_mac_process_key",
+            [SA_CRYPTO_MAC_COMPUTE] = "sa_crypto_mac_compute",
+            [SA_CRYPTO_MAC_RELEASE] = "sa_crypto_mac_release",
+            [SA_CRYPTO_SIGN] = "sa_crypto_sign",
+            [SA_SVP_SUPPORTED] = "sa_svp_supported",
+            [SA_SVP_BUFFER_ALLOC] = "sa_svp_buffer_alloc",
+            [SA_SVP_BUFFER_CREATE] = "sa_svp_buffer_create",
+            [SA_SVP_BUFFER_FREE] = "sa_svp_buffer_free",
+            [SA_SVP_BUFFER_RELEASE] = "sa_svp_buffer_release",
+            [SA_SVP_BUFFER_WRITE] = "sa_svp_buffer_write",
+            [SA_SVP_BUFFER_COPY] = "sa_svp_buffer_copy",
+            [SA_SVP_KEY_CHECK] = "sa_svp_key_check",
+            [SA_SVP_BUFFER_CHECK] = "sa_svp_buffer_check",
+            [SA_PROCESS_COMMON_ENCRYPTION] = "sa_process_common_encryption",
+            [SA_KEY_DERIVE_BATCH] = "sa_key_derive_batch",
+            [SA_KEY_UNWRAP_BATCH] = "sa_key_unwrap_batch",
+            [SA_GET_STATS] = "sa_get_stats",
+            [SA_SVP_BUFFER_BATCH] = "sa_svp_buffer_batch",
+            [SA_SVP_BUFFER_CHECK_RANGES] = "sa_svp_buffer_check_ranges",
+            [SA_COMMAND_BATCH] = "sa_command_batch"};
+
+    if (command_id < sizeof(names) / sizeof(names[0]) && names[command_id] != NULL)
+        return names[command_id];
+
+    return "unknown";
+}
+
+// Upper bound of a histogram bucket, see sa_stats_header.
+static uint64_t bucket_upper_bound(
+        size_t bucket,
+        uint32_t sub_bucket_bits) {
+
+    const size_t sub_buckets = (size_t) 1 << sub_bucket_bits;
+    size_t next = bucket + 1;
+    if (next < sub_buckets)
+        return next - 1;
+
+    return (((uint64_t) sub_buckets + next % sub_buckets) << (next / sub_buckets - 1)) - 1;
+}
+
+// Percentile latency, reported as the upper bound of the bucket holding it but no more than the
+// longest call.
+static uint64_t percentile(
+        const uint64_t* histogram,
+        const sa_stats_header* header,
+        const sa_stats_command* command,
+        double fraction) {
+
+    uint64_t target = (uint64_t) (fraction * (double) command->timed_calls);
+    uint64_t count = 0;
+    size_t bucket = header->bucket_count - 1;
+    for (size_t i = 0; i < header->bucket_count; i++) {
+        count += histogram[i];
+        if (count > target) {
+            bucket = i;
+            break;
+        }
+    }
+
+    uint64_t upper_bound = bucket_upper_bound(bucket, header->sub_bucket_bits);
+    return upper_bound < command->max_ns ? upper_bound : command->max_ns;
+}
+
+static int print_table(
+        const uint8_t* stats,
+        size_t stats_length) {
+
+    sa_stats_header header;
+    if (stats_length < sizeof(header)) {
+        fprintf(stderr, "Snapshot too short\n");
+        return EXIT_FAILURE;
+    }
+
+    memcpy(&header, stats, sizeof(header));
+    if (header.version != SA_STATS_VERSION) {
+        fprintf(stderr, "Unsupported snapshot version %" PRIu32 "\n", header.version);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-30s %10s %10s %14s %10s %10s %10s %10s\n", "command", "calls", "errors", "param_bytes", "mean_us",
+            "p50_us", "p99_us", "max_us");
+
+    size_t offset = header.header_length;
+    for (uint32_t i = 0; i < header.command_count; i++) {
+        sa_stats_command command;
+        if (offset + sizeof(command) > stats_length) {
+            fprintf(stderr, "Snapshot truncated\n");
+            return EXIT_FAILURE;
+        }
+
+        memcpy(&command, stats + offset, sizeof(command));
+        size_t counters_length = (size_t) (header.status_count + header.bucket_count) * sizeof(uint64_t);
+        if (command.record_length < sizeof(command) + counters_length ||
+                offset + command.record_length > stats_length) {
+            fprintf(stderr, "Snapshot truncated\n");
+            return EXIT_FAILURE;
+        }
+
+        uint64_t* counters = malloc(counters_length);
+        if (counters == NULL) {
+            fprintf(stderr, "malloc failed\n");
+            return EXIT_FAILURE;
+        }
+
+        memcpy(counters, stats + offset + sizeof(command), counters_length);
+        uint64_t errors = 0;
+        for (size_t j = 0; j < header.status_count; j++) {
+            if (j != SA_STATUS_OK)
+                errors += counters[j];
+        }
+
+        const uint64_t* histogram = counters + header.status_count;
+        printf("%-30s %10" PRIu64 " %10" PRIu64 " %14" PRIu64 " %10.2f %10.2f %10.2f %10.2f\n",
+                command_name(command.command_id), command.calls, errors, command.param_bytes,
+                command.timed_calls == 0 ? 0.0 : (double) command.total_ns / (double) command.timed_calls / 1000.0,
+                (double) percentile(histogram, &header, &command, 0.50) / 1000.0,
+                (double) percentile(histogram, &header, &command, 0.99) / 1000.0,
+                (double) command.max_ns / 1000.0);
+
+        free(counters);
+        offset += command.record_length;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(
+        int argc,
+        char** argv) {
+
+    int raw = argc > 1 && strcmp(argv[1], "-r") == 0;
+    if (argc > 2 || (argc == 2 && !raw)) {
+        fprintf(stderr, "Usage: %s [-r]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t stats_length = 0;
+    sa_status status = sa_get_stats(NULL, &stats_length);
+    if (status != SA_STATUS_OK) {
+        fprintf(stderr, "sa_get_stats failed: %d\n", status);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t* stats = malloc(stats_length);
+    if (stats == NULL) {
+        fprintf(stderr, "malloc failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_FAILURE;
+    status = sa_get_stats(stats, &stats_length);
+    if (status != SA_STATUS_OK)
+        fprintf(stderr, "sa_get_stats failed: %d\n", status);
+    else if (raw)
+        result = fwrite(stats, 1, stats_length, stdout) == stats_length ? EXIT_SUCCESS : EXIT_FAILURE;
+    else
+        result = print_table(stats, stats_length);
+
+    free(stats);
+    return result;
+}
@@ -17,30 +17,170 @@
  */
 
 #include "client.h"
+#include "command_batch.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "ta_client.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <threads.h>
 
+#define MAX_POOL_SESSIONS 64
+#define MAX_QUEUED_RELEASES 64
+
 static thread_local void* session = NULL;
+static thread_local uint64_t session_id = 0;
+static atomic_ullong next_session_id = 1;
 static tss_t thread_session;
 static once_flag flag = ONCE_FLAG_INIT;
 static mtx_t mutex;
 
+// Number of per thread sessions opened so far. A pool can only be created before the first one is opened, so that
+// handles from both modes never coexist.
+static size_t thread_sessions_opened = 0;
+
+// Session pool. pool_count is published last, so a thread that reads a non zero count sees the sessions.
+static void* pool_sessions[MAX_POOL_SESSIONS];
+static uint64_t pool_session_ids[MAX_POOL_SESSIONS];
+static atomic_size_t pool_count = 0;
+static atomic_size_t pool_next = 0;
+
+// Release coalescing. Each thread queues its releases for the session it is bound to. The keys are kept so that their
+// headers can be dropped from the key header cache once the TA has released them. Releases are mostly sent implicitly,
+// by the thread's next command, so the first error is kept until the thread collects it with client_flush_releases.
+typedef struct {
+    command_batch* batch;
+    sa_key keys[MAX_QUEUED_RELEASES];
+    size_t keys_length;
+    sa_status status;
+} release_queue;
+
+static atomic_bool coalesce_releases = false;
+static thread_local release_queue* releases = NULL;
+static tss_t thread_releases;
+
+static sa_status releases_flush() {
+    if (releases == NULL || command_batch_length(releases->batch) == 0 || session == NULL)
+        return SA_STATUS_OK;
+
+    size_t length = command_batch_length(releases->batch);
+    sa_status statuses[MAX_QUEUED_RELEASES];
+    sa_status status = command_batch_invoke(releases->batch, session, statuses);
+    if (status != SA_STATUS_OK) {
+        ERROR("command_batch_invoke failed: %d", status);
+    } else {
+        for (size_t i = 0; i < length; i++) {
+            if (statuses[i] != SA_STATUS_OK) {
+                ERROR("Queued release %zu failed: %d", i, statuses[i]);
+                if (status == SA_STATUS_OK)
+                    status = statuses[i];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < releases->keys_length; i++)
+        key_header_cache_invalidate(session_id, releases->keys[i]);
+
+    releases->keys_length = 0;
+    if (releases->status == SA_STATUS_OK)
+        releases->status = status;
+
+    return status;
+}
+
+// Flushes the queue and returns the first error of every release sent since the last call, clearing it.
+static sa_status releases_collect() {
+    sa_status status = releases_flush();
+    if (releases == NULL)
+        return status;
+
+    status = releases->status;
+    releases->status = SA_STATUS_OK;
+    return status;
+}
+
+static void releases_shutdown(void* thread_queue) {
+    release_queue* queue = thread_queue;
+    if (queue == releases)
+        releases_flush();
+
+    command_batch_free(queue->batch);
+    free(queue);
+    releases = NULL;
+}
+
 static void client_thread_shutdown(void* client_session) {
     if (client_session != NULL) {
+        // The release queue of the thread may still hold releases for this session.
+        if (client_session == session) {
+            releases_flush();
+            session = NULL;
+        }
+
         ta_close_session(client_session);
     }
 }
 
 static void client_shutdown() {
+    releases_flush();
+
+    size_t count = atomic_load(&pool_count);
+    if (count > 0) {
+        atomic_store(&pool_count, 0);
+        for (size_t i = 0; i < count; i++) {
+            client_thread_shutdown(pool_sessions[i]);
+            pool_sessions[i] = NULL;
+        }
+
+        session = NULL;
+        return;
+    }
+
     if (session != NULL) {
         client_thread_shutdown(session);
         session = NULL;
     }
 }
 
+static void pool_bind(size_t index) {
+    // Queued releases belong to the session the thread was bound to.
+    releases_flush();
+    session_id = pool_session_ids[index];
+    session = pool_sessions[index];
+}
+
+// Must be called with the mutex held or from client_create.
+static sa_status pool_create(size_t session_count) {
+    if (session_count == 0 || session_count > MAX_POOL_SESSIONS) {
+        ERROR("Invalid session_count %zu", session_count);
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (atomic_load(&pool_count) != 0 || thread_sessions_opened != 0) {
+        ERROR("Sessions already opened");
+        return SA_STATUS_OPERATION_NOT_ALLOWED;
+    }
+
+    for (size_t i = 0; i < session_count; i++) {
+        sa_status status = ta_open_session(&pool_sessions[i]);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_open_session failed: %d", status);
+            for (size_t j = 0; j < i; j++) {
+                ta_close_session(pool_sessions[j]);
+                pool_sessions[j] = NULL;
+            }
+
+            return status;
+        }
+
+        pool_session_ids[i] = atomic_fetch_add(&next_session_id, 1);
+    }
+
+    atomic_store(&pool_count, session_count);
+    return SA_STATUS_OK;
+}
+
 static void client_create() {
     if (mtx_init(&mutex, mtx_recursive) != thrd_success) {
         ERROR("mtx_init failed");
@@ -58,15 +198,42 @@ static void client_create() {
         ERROR("atexit failed");
         return;
     }
+
+    // Calls releases_shutdown when a thread that queued releases exits.
+    if (tss_create(&thread_releases, releases_shutdown) != 0) {
+        ERROR("tss_create failed");
+        return;
+    }
+
+    // Release coalescing can be enabled without code changes by setting SA_COALESCE_RELEASES.
+    const char* coalesce = getenv("SA_COALESCE_RELEASES");
+    if (coalesce != NULL && strtoul(coalesce, NULL, 10) != 0)
+        atomic_store(&coalesce_releases, true);
+
+    // Pool mode can be enabled without code changes by setting SA_SESSION_POOL_SIZE.
+    const char* pool_size = getenv("SA_SESSION_POOL_SIZE");
+    if (pool_size != NULL) {
+        size_t session_count = strtoul(pool_size, NULL, 10);
+        if (pool_create(session_count) != SA_STATUS_OK)
+            ERROR("pool_create failed");
+    }
 }
 
-void* client_session() {
+// Returns the session of the thread without sending its queued releases.
+static void* thread_session_get() {
     if (session != NULL) {
         return session;
     }
 
     call_once(&flag, client_create);
 
+    // Threads that have not been bound explicitly are spread over the pool round robin.
+    size_t count = atomic_load(&pool_count);
+    if (count > 0) {
+        pool_bind(atomic_fetch_add(&pool_next, 1) % count);
+        return session;
+    }
+
     if (mtx_lock(&mutex) != thrd_success) {
         ERROR("mtx_lock failed");
         return NULL;
@@ -78,12 +245,22 @@ void* client_session() {
             break;
         }
 
+        // or a pool
+        count = atomic_load(&pool_count);
+        if (count > 0) {
+            pool_bind(atomic_fetch_add(&pool_next, 1) % count);
+            break;
+        }
+
         sa_status status = ta_open_session(&session);
         if (status != SA_STATUS_OK) {
             ERROR("ta_sa_init failed: %d", status);
             break;
         }
 
+        session_id = atomic_fetch_add(&next_session_id, 1);
+        thread_sessions_opened++;
+
         // Store the session in thread specific storage so that it can be cleaned up automatically when the thread
         // exits.
         void* thread_session_ptr = session;
@@ -99,3 +276,113 @@ void* client_session() {
 
     return session;
 }
+
+void* client_session() {
+    void* current = thread_session_get();
+    if (releases != NULL && command_batch_length(releases->batch) > 0)
+        releases_flush();
+
+    return current;
+}
+
+uint64_t client_session_id() {
+    return client_session() != NULL ? session_id : 0;
+}
+
+sa_status client_session_pool_init(size_t session_count) {
+    call_once(&flag, client_create);
+
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_status status = pool_create(session_count);
+
+    if (mtx_unlock(&mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+
+    return status;
+}
+
+sa_status client_session_pool_bind(size_t index) {
+    call_once(&flag, client_create);
+
+    size_t count = atomic_load(&pool_count);
+    if (count == 0) {
+        ERROR("No session pool");
+        return SA_STATUS_OPERATION_NOT_ALLOWED;
+    }
+
+    if (index >= count) {
+        ERROR("Invalid index %zu", index);
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    pool_bind(index);
+    return SA_STATUS_OK;
+}
+
+bool client_defer_release(
+        SA_COMMAND_ID command_id,
+        const void* command,
+        size_t command_size) {
+
+    call_once(&flag, client_create);
+    if (!atomic_load(&coalesce_releases))
+        return false;
+
+    if (thread_session_get() == NULL) {
+        ERROR("thread_session_get failed");
+        return false;
+    }
+
+    if (releases == NULL) {
+        release_queue* queue = calloc(1, sizeof(release_queue));
+        if (queue == NULL) {
+            ERROR("calloc failed");
+            return false;
+        }
+
+        queue->batch = command_batch_create(MAX_QUEUED_RELEASES);
+        if (queue->batch == NULL || tss_set(thread_releases, queue) != thrd_success) {
+            ERROR("Release queue creation failed");
+            command_batch_free(queue->batch);
+            free(queue);
+            return false;
+        }
+
+        releases = queue;
+    }
+
+    if (command_batch_full(releases->batch))
+        releases_flush();
+
+    // clang-format off
+    ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_IN, TA_PARAM_NULL, TA_PARAM_NULL, TA_PARAM_NULL};
+    ta_param params[NUM_TA_PARAMS] = {{(void*) command, command_size},
+                                      {NULL, 0},
+                                      {NULL, 0},
+                                      {NULL, 0}};
+    // clang-format on
+    if (command_batch_add(releases->batch, command_id, param_types, params) != SA_STATUS_OK) {
+        ERROR("command_batch_add failed");
+        return false;
+    }
+
+    if (command_id == SA_KEY_RELEASE)
+        releases->keys[releases->keys_length++] = ((const sa_key_release_s*) command)->key;
+
+    return true;
+}
+
+sa_status client_coalesce_releases(bool enable) {
+    call_once(&flag, client_create);
+    atomic_store(&coalesce_releases, enable);
+    return enable ? SA_STATUS_OK : releases_collect();
+}
+
+sa_status client_flush_releases() {
+    return releases_collect();
+}
@@ -19,7 +19,7 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
-#include "sa_types.h"
+#include "sa_ta_types.h"
 
 #ifdef __cplusplus
 #include <cstdio>
@@ -36,6 +36,74 @@ extern "C" {
  */
 void* client_session();
 
+/**
+ * Returns the ID of the session returned by client_session for the thread. Handles are only unique within a session
+ * and session contexts may be reused after they are closed, but IDs are never reused, so the pair of session ID and
+ * handle identifies an object for the lifetime of the process.
+ *
+ * @return client session ID, or 0 if no session could be opened.
+ */
+uint64_t client_session_id();
+
+/**
+ * Switches the client to session pool mode. session_count sessions are opened immediately and every thread that
+ * subsequently calls into the TA is bound to one of them instead of opening its own session. Threads are bound round
+ * robin unless they call client_session_pool_bind first. Pool sessions are closed when the process exits. Setting the
+ * SA_SESSION_POOL_SIZE environment variable has the same effect as calling this function before the first call into
+ * the TA.
+ *
+ * @param[in] session_count number of sessions in the pool.
+ * @return SA_STATUS_OK, SA_STATUS_INVALID_PARAMETER if session_count is 0 or too large, or
+ * SA_STATUS_OPERATION_NOT_ALLOWED if a pool or a per thread session already exists.
+ */
+sa_status client_session_pool_init(size_t session_count);
+
+/**
+ * Binds the calling thread to a pool session. Threads bound to the same session share key, cipher, MAC, and SVP
+ * handles.
+ *
+ * @param[in] index index of the pool session.
+ * @return SA_STATUS_OK, SA_STATUS_INVALID_PARAMETER if index is out of range, or SA_STATUS_OPERATION_NOT_ALLOWED if
+ * the client is not in session pool mode.
+ */
+sa_status client_session_pool_bind(size_t index);
+
+/**
+ * Queues a release command on the calling thread's release queue if release coalescing is enabled. The command is
+ * copied, so it does not have to outlive the call. Queued releases are sent to the TA in a single SA_COMMAND_BATCH
+ * when the queue is full, on the thread's next client_session call, on client_flush_releases, and on thread exit.
+ * There is no time bound: an idle thread keeps its queued handles allocated in the TA until one of these happens.
+ *
+ * @param[in] command_id SA_KEY_RELEASE, SA_CRYPTO_CIPHER_RELEASE, or SA_CRYPTO_MAC_RELEASE.
+ * @param[in] command the release command, passed to the TA as params[0].
+ * @param[in] command_size size of the release command.
+ * @return true if the release was queued. false if release coalescing is disabled or the release could not be queued,
+ * in which case the caller must invoke it.
+ */
+bool client_defer_release(
+        SA_COMMAND_ID command_id,
+        const void* command,
+        size_t command_size);
+
+/**
+ * Enables or disables release coalescing for all threads. Disabling it flushes the calling thread's release queue only;
+ * releases queued by other threads are sent on their next client_session call or when they exit.
+ * Setting the SA_COALESCE_RELEASES environment variable to a non zero value has the same effect as enabling it before
+ * the first call into the TA.
+ *
+ * @param[in] enable whether releases are queued.
+ * @return the status returned by client_flush_releases.
+ */
+sa_status client_coalesce_releases(bool enable);
+
+/**
+ * Sends the calling thread's queued releases to the TA and collects the first error of the releases sent since the
+ * previous call, including those sent on a client_session call or because the queue was full. The error is cleared.
+ *
+ * @return SA_STATUS_OK if every release succeeded, otherwise the status of the first one that failed.
+ */
+sa_status client_flush_releases();
+
 #ifdef __cplusplus
 }
 #endif
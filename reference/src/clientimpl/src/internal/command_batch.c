@@ -0,0 +1,260 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "command_batch.h" // NOLINT
+#include "log.h"
+#include <stdint.h>
+#include <string.h>
+
+#define INITIAL_DATA_CAPACITY 1024
+
+typedef struct {
+    void* output;
+    size_t offset;
+    size_t size;
+} command_batch_output;
+
+struct command_batch_s {
+    size_t max_commands;
+    size_t commands_length;
+    sa_command_batch_entry_s* entries;
+    uint8_t* data;
+    size_t data_length;
+    size_t data_capacity;
+    command_batch_output* outputs;
+    size_t outputs_length;
+};
+
+static size_t align_offset(size_t offset) {
+    return (offset + COMMAND_BATCH_ALIGNMENT - 1) & ~((size_t) COMMAND_BATCH_ALIGNMENT - 1);
+}
+
+// The data buffer is passed to the TA, so it is reallocated with CREATE_BUFFER to stay in shared memory.
+static bool grow_data(
+        command_batch* batch,
+        size_t required) {
+
+    if (required <= batch->data_capacity)
+        return true;
+
+    size_t capacity = batch->data_capacity == 0 ? INITIAL_DATA_CAPACITY : batch->data_capacity;
+    while (capacity < required) {
+        if (capacity > SIZE_MAX / 2)
+            return false;
+
+        capacity *= 2;
+    }
+
+    uint8_t* data;
+    CREATE_BUFFER(data, capacity);
+    if (data == NULL) {
+        ERROR("CREATE_BUFFER failed");
+        return false;
+    }
+
+    if (batch->data_length > 0)
+        memcpy(data, batch->data, batch->data_length);
+
+    RELEASE_BUFFER(batch->data);
+    batch->data = data;
+    batch->data_capacity = capacity;
+    return true;
+}
+
+static void reset(command_batch* batch) {
+    batch->commands_length = 0;
+    batch->data_length = 0;
+    batch->outputs_length = 0;
+}
+
+command_batch* command_batch_create(size_t max_commands) {
+    if (max_commands == 0 || max_commands > SIZE_MAX / (NUM_TA_PARAMS * sizeof(command_batch_output))) {
+        ERROR("Invalid max_commands");
+        return NULL;
+    }
+
+    command_batch* batch = calloc(1, sizeof(command_batch));
+    if (batch == NULL) {
+        ERROR("calloc failed");
+        return NULL;
+    }
+
+    batch->max_commands = max_commands;
+    CREATE_BUFFER(batch->entries, max_commands * sizeof(sa_command_batch_entry_s));
+    batch->outputs = malloc(max_commands * NUM_TA_PARAMS * sizeof(command_batch_output));
+    if (batch->entries == NULL || batch->outputs == NULL) {
+        ERROR("Allocation failed");
+        command_batch_free(batch);
+        return NULL;
+    }
+
+    return batch;
+}
+
+void command_batch_free(command_batch* batch) {
+    if (batch == NULL)
+        return;
+
+    RELEASE_BUFFER(batch->entries);
+    RELEASE_BUFFER(batch->data);
+    free(batch->outputs);
+    free(batch);
+}
+
+size_t command_batch_length(const command_batch* batch) {
+    return batch == NULL ? 0 : batch->commands_length;
+}
+
+bool command_batch_full(const command_batch* batch) {
+    return batch != NULL && batch->commands_length == batch->max_commands;
+}
+
+sa_status command_batch_add(
+        command_batch* batch,
+        SA_COMMAND_ID command_id,
+        const ta_param_type param_types[NUM_TA_PARAMS],
+        ta_param params[NUM_TA_PARAMS]) {
+
+    if (batch == NULL || param_types == NULL || params == NULL) {
+        ERROR("NULL parameter");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (command_id == SA_COMMAND_BATCH) {
+        ERROR("Nested command batch");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (batch->commands_length == batch->max_commands) {
+        ERROR("Command batch is full");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t required = batch->data_length;
+    for (size_t i = 0; i < NUM_TA_PARAMS; i++) {
+        if (param_types[i] == TA_PARAM_NULL || params[i].mem_ref_size == 0)
+            continue;
+
+        if (params[i].mem_ref == NULL) {
+            ERROR("NULL params[%zu].mem_ref", i);
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        required = align_offset(required);
+        if (params[i].mem_ref_size > SIZE_MAX - required) {
+            ERROR("Integer overflow");
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+
+        required += params[i].mem_ref_size;
+    }
+
+    if (!grow_data(batch, required)) {
+        ERROR("grow_data failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_command_batch_entry_s* entry = &batch->entries[batch->commands_length];
+    entry->command_id = command_id;
+    for (size_t i = 0; i < NUM_TA_PARAMS; i++) {
+        entry->param_offsets[i] = 0;
+        entry->param_sizes[i] = 0;
+        if (param_types[i] == TA_PARAM_NULL || params[i].mem_ref_size == 0)
+            continue;
+
+        size_t offset = align_offset(batch->data_length);
+        size_t size = params[i].mem_ref_size;
+        if (param_types[i] == TA_PARAM_OUT)
+            memset(batch->data + offset, 0, size);
+        else
+            memcpy(batch->data + offset, params[i].mem_ref, size);
+
+        if (param_types[i] == TA_PARAM_OUT || param_types[i] == TA_PARAM_INOUT) {
+            command_batch_output* output = &batch->outputs[batch->outputs_length++];
+            output->output = params[i].mem_ref;
+            output->offset = offset;
+            output->size = size;
+        }
+
+        entry->param_offsets[i] = offset;
+        entry->param_sizes[i] = size;
+        batch->data_length = offset + size;
+    }
+
+    batch->commands_length++;
+    return SA_STATUS_OK;
+}
+
+sa_status command_batch_invoke(
+        command_batch* batch,
+        void* session,
+        sa_status* statuses) {
+
+    if (batch == NULL || statuses == NULL) {
+        ERROR("NULL parameter");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (batch->commands_length == 0)
+        return SA_STATUS_OK;
+
+    sa_command_batch_s* command_batch = NULL;
+    void* param3 = NULL;
+    size_t param3_size = batch->commands_length * sizeof(sa_status);
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_command_batch_s, command_batch);
+        if (command_batch == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        command_batch->api_version = API_VERSION;
+        command_batch->commands_length = batch->commands_length;
+
+        CREATE_OUT_PARAM(param3, statuses, param3_size);
+        if (param3 == NULL) {
+            ERROR("CREATE_OUT_PARAM failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_IN, TA_PARAM_IN, TA_PARAM_INOUT, TA_PARAM_OUT};
+        ta_param params[NUM_TA_PARAMS] = {{command_batch, sizeof(sa_command_batch_s)},
+                                          {batch->entries, batch->commands_length * sizeof(sa_command_batch_entry_s)},
+                                          {batch->data, batch->data_length},
+                                          {param3, param3_size}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_COMMAND_BATCH, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+
+        COPY_OUT_PARAM(statuses, param3, param3_size);
+        for (size_t i = 0; i < batch->outputs_length; i++)
+            memcpy(batch->outputs[i].output, batch->data + batch->outputs[i].offset, batch->outputs[i].size);
+    } while (false);
+
+    reset(batch);
+    RELEASE_PARAM(param3);
+    RELEASE_COMMAND(command_batch);
+    return status;
+}
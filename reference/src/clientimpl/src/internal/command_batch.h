@@ -0,0 +1,106 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @section Description
+ * @file command_batch.h
+ *
+ * This file contains the functions that encode several TA commands into a single SA_COMMAND_BATCH envelope, so that
+ * they cost one ta_invoke_command instead of one each. The parameters of every sub-command are copied into one data
+ * buffer when the command is added. OUT and INOUT parameters are copied back to the memory passed to
+ * command_batch_add when the batch is invoked, so that memory must stay valid until then.
+ */
+
+#ifndef COMMAND_BATCH_H
+#define COMMAND_BATCH_H
+
+#include "ta_client.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct command_batch_s command_batch;
+
+/**
+ * Creates an empty command batch.
+ *
+ * @param[in] max_commands maximum number of commands in the batch.
+ * @return the command batch, or NULL if it could not be allocated.
+ */
+command_batch* command_batch_create(size_t max_commands);
+
+/**
+ * Frees a command batch. Commands that have not been invoked are dropped.
+ *
+ * @param[in] batch command batch.
+ */
+void command_batch_free(command_batch* batch);
+
+/**
+ * Returns the number of commands added since the batch was created or last invoked.
+ *
+ * @param[in] batch command batch.
+ * @return number of commands.
+ */
+size_t command_batch_length(const command_batch* batch);
+
+/**
+ * Returns whether the batch holds max_commands commands.
+ *
+ * @param[in] batch command batch.
+ * @return true if no more commands can be added.
+ */
+bool command_batch_full(const command_batch* batch);
+
+/**
+ * Adds a command to the batch. Takes the same arguments as ta_invoke_command.
+ *
+ * @param[in] batch command batch.
+ * @param[in] command_id the id of the command. Must not be SA_COMMAND_BATCH.
+ * @param[in] param_types the types of the 4 parameters.
+ * @param[in] params the 4 command parameters.
+ * @return SA_STATUS_OK, SA_STATUS_INVALID_PARAMETER if the batch is full or a parameter is invalid, or
+ * SA_STATUS_INTERNAL_ERROR if the data buffer could not be grown.
+ */
+sa_status command_batch_add(
+        command_batch* batch,
+        SA_COMMAND_ID command_id,
+        const ta_param_type param_types[NUM_TA_PARAMS],
+        ta_param params[NUM_TA_PARAMS]);
+
+/**
+ * Sends all the commands of the batch to the TA in one SA_COMMAND_BATCH command and empties the batch. On success, the
+ * status of every command is written to statuses and the OUT and INOUT parameters are copied back.
+ *
+ * @param[in] batch command batch.
+ * @param[in] session the session to invoke the commands on.
+ * @param[out] statuses one status per command, in the order the commands were added.
+ * @return SA_STATUS_OK if the envelope was processed, even if some of the commands failed, or the error status of the
+ * envelope.
+ */
+sa_status command_batch_invoke(
+        command_batch* batch,
+        void* session,
+        sa_status* statuses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMMAND_BATCH_H
@@ -0,0 +1,216 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "key_header_cache.h" // NOLINT
+#include "log.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <threads.h>
+
+// Direct mapped table. The key store of a session has 256 slots, so a single session rarely sees conflicts.
+#define CACHE_SLOT_BITS 8
+#define NUM_CACHE_SLOTS (1U << CACHE_SLOT_BITS)
+#define NUM_HEADER_WORDS ((sizeof(sa_header) + sizeof(unsigned long) - 1) / sizeof(unsigned long))
+
+// Each slot is a sequence lock. The sequence is odd while a writer updates the slot. Readers copy the slot and retry if
+// the sequence changed during the copy. The slot contents are atomics accessed with relaxed ordering so that the racing
+// copy is well defined.
+typedef struct {
+    atomic_uint sequence;
+    atomic_ullong session_id;
+    atomic_ulong key;
+    atomic_ulong header[NUM_HEADER_WORDS];
+} cache_slot;
+
+static cache_slot slots[NUM_CACHE_SLOTS];
+
+static once_flag flag = ONCE_FLAG_INIT;
+static mtx_t mutex;
+static bool mutex_initialized;
+
+static struct {
+    atomic_ullong hits;
+    atomic_ullong misses;
+    atomic_ullong inserts;
+    atomic_ullong invalidations;
+} cache_stats;
+
+static void cache_create() {
+    mutex_initialized = mtx_init(&mutex, mtx_plain) == thrd_success;
+    if (!mutex_initialized)
+        ERROR("mtx_init failed");
+}
+
+static cache_slot* get_slot(
+        uint64_t session_id,
+        sa_key key) {
+
+    uint64_t hash = ((uint64_t) key ^ (session_id << CACHE_SLOT_BITS)) * 0x9E3779B97F4A7C15ULL;
+    return &slots[hash >> (64 - CACHE_SLOT_BITS)];
+}
+
+// Must be called with the mutex held. Session ID 0 marks an empty slot, which is the zero initialized state of the
+// table. A NULL header leaves the header words unchanged.
+static void write_slot(
+        cache_slot* slot,
+        uint64_t session_id,
+        sa_key key,
+        const sa_header* header) {
+
+    unsigned int sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->session_id, session_id, memory_order_relaxed);
+    atomic_store_explicit(&slot->key, key, memory_order_relaxed);
+    if (header != NULL) {
+        unsigned long words[NUM_HEADER_WORDS] = {0};
+        memcpy(words, header, sizeof(sa_header));
+        for (size_t i = 0; i < NUM_HEADER_WORDS; i++)
+            atomic_store_explicit(&slot->header[i], words[i], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&slot->sequence, sequence + 2, memory_order_release);
+}
+
+bool key_header_cache_lookup(
+        sa_header* header,
+        uint32_t* epoch,
+        uint64_t session_id,
+        sa_key key) {
+
+    if (header == NULL) {
+        ERROR("NULL header");
+        return false;
+    }
+
+    if (epoch == NULL) {
+        ERROR("NULL epoch");
+        return false;
+    }
+
+    *epoch = UINT32_MAX;
+    if (session_id == 0 || key == INVALID_HANDLE)
+        return false;
+
+    cache_slot* slot = get_slot(session_id, key);
+    unsigned long words[NUM_HEADER_WORDS];
+    while (true) {
+        unsigned int sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence & 1U) {
+            // A writer is updating the slot. Treat this as a miss with an epoch that can never be inserted.
+            atomic_fetch_add(&cache_stats.misses, 1);
+            return false;
+        }
+
+        bool found = atomic_load_explicit(&slot->session_id, memory_order_relaxed) == session_id &&
+                     atomic_load_explicit(&slot->key, memory_order_relaxed) == key;
+        if (found) {
+            for (size_t i = 0; i < NUM_HEADER_WORDS; i++)
+                words[i] = atomic_load_explicit(&slot->header[i], memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != sequence)
+            continue;
+
+        if (!found) {
+            *epoch = sequence;
+            atomic_fetch_add(&cache_stats.misses, 1);
+            return false;
+        }
+
+        memcpy(header, words, sizeof(sa_header));
+        atomic_fetch_add(&cache_stats.hits, 1);
+        return true;
+    }
+}
+
+void key_header_cache_insert(
+        uint64_t session_id,
+        sa_key key,
+        const sa_header* header,
+        uint32_t epoch) {
+
+    if (header == NULL) {
+        ERROR("NULL header");
+        return;
+    }
+
+    if (session_id == 0 || key == INVALID_HANDLE)
+        return;
+
+    call_once(&flag, cache_create);
+    if (!mutex_initialized)
+        return;
+
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return;
+    }
+
+    cache_slot* slot = get_slot(session_id, key);
+    if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == epoch) {
+        write_slot(slot, session_id, key, header);
+        atomic_fetch_add(&cache_stats.inserts, 1);
+    }
+
+    mtx_unlock(&mutex);
+}
+
+void key_header_cache_invalidate(
+        uint64_t session_id,
+        sa_key key) {
+
+    if (session_id == 0 || key == INVALID_HANDLE)
+        return;
+
+    call_once(&flag, cache_create);
+    if (!mutex_initialized)
+        return;
+
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return;
+    }
+
+    // The sequence is bumped even if the slot holds another key, which voids any insert racing with the invalidation.
+    cache_slot* slot = get_slot(session_id, key);
+    uint64_t slot_session_id = atomic_load_explicit(&slot->session_id, memory_order_relaxed);
+    sa_key slot_key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+    if (slot_session_id == session_id && slot_key == key) {
+        slot_session_id = 0;
+        atomic_fetch_add(&cache_stats.invalidations, 1);
+    }
+
+    write_slot(slot, slot_session_id, slot_key, NULL);
+
+    mtx_unlock(&mutex);
+}
+
+void key_header_cache_get_stats(sa_key_header_cache_stats* stats) {
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return;
+    }
+
+    stats->hits = atomic_load(&cache_stats.hits);
+    stats->misses = atomic_load(&cache_stats.misses);
+    stats->inserts = atomic_load(&cache_stats.inserts);
+    stats->invalidations = atomic_load(&cache_stats.invalidations);
+}
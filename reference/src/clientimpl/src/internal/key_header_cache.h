@@ -0,0 +1,91 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @section Description
+ * @file key_header_cache.h
+ *
+ * This file contains the functions implementing the client side key header cache. Key headers are
+ * immutable for the lifetime of a key, so a header retrieved from the TA once can be returned for
+ * every subsequent sa_key_header call on the same handle until the key is released. Handles are
+ * only unique within a session, so entries are keyed by the session ID and the handle. Lookups
+ * are lock free. Inserts and invalidations are serialized with a mutex.
+ */
+
+#ifndef KEY_HEADER_CACHE_H
+#define KEY_HEADER_CACHE_H
+
+#include "sa_types.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Looks up the header of a key in the cache.
+ *
+ * @param[out] header the cached header. Only written on a hit.
+ * @param[out] epoch slot epoch to pass to key_header_cache_insert after a miss.
+ * @param[in] session_id client session ID.
+ * @param[in] key key handle.
+ * @return true if the header was found in the cache.
+ */
+bool key_header_cache_lookup(
+        sa_header* header,
+        uint32_t* epoch,
+        uint64_t session_id,
+        sa_key key);
+
+/**
+ * Stores the header of a key in the cache. The header is dropped if the slot has been modified since the epoch was
+ * obtained from key_header_cache_lookup, so that a header retrieved concurrently with the release of the key is never
+ * cached.
+ *
+ * @param[in] session_id client session ID.
+ * @param[in] key key handle.
+ * @param[in] header header of the key.
+ * @param[in] epoch slot epoch returned by key_header_cache_lookup.
+ */
+void key_header_cache_insert(
+        uint64_t session_id,
+        sa_key key,
+        const sa_header* header,
+        uint32_t epoch);
+
+/**
+ * Removes the header of a key from the cache. Called whenever a key handle is released or (re)assigned.
+ *
+ * @param[in] session_id client session ID.
+ * @param[in] key key handle.
+ */
+void key_header_cache_invalidate(
+        uint64_t session_id,
+        sa_key key);
+
+/**
+ * Retrieves the cache statistics.
+ *
+ * @param[out] stats cache statistics.
+ */
+void key_header_cache_get_stats(sa_key_header_cache_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KEY_HEADER_CACHE_H
@@ -30,11 +30,20 @@ sa_status sa_svp_memory_alloc(
     }
 
     // TODO Soc Vendor: replace this call with a call to allocate secure memory.
+#ifdef ENABLE_TA_SIMULATOR
+    // The TA runs in the ta_simulator process, which can only reach SVP memory that is shared with it.
+    *svp_memory = ta_alloc_shared_memory(size);
+    if (*svp_memory == NULL) {
+        ERROR("ta_alloc_shared_memory failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+#else
     *svp_memory = malloc(size);
     if (*svp_memory == NULL) {
         ERROR("malloc failed");
         return SA_STATUS_INTERNAL_ERROR;
     }
+#endif
 
     return SA_STATUS_OK;
 }
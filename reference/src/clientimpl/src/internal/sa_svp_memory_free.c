@@ -22,8 +22,12 @@
 sa_status sa_svp_memory_free(void* svp_memory) {
 
     // TODO Soc Vendor: replace this call to a call to free secure memory.
+#ifdef ENABLE_TA_SIMULATOR
+    ta_free_shared_memory(svp_memory);
+#else
     if (svp_memory != NULL)
         free(svp_memory);
+#endif
 
     return SA_STATUS_OK;
 }
@@ -69,7 +69,9 @@ sa_status ta_invoke_command(
 #endif
 
     // Handler does not need the param types. These are used at the TA interface level.
+    bool span = TRACE_SPAN_BEGIN_ARG("ta_invoke_command", command_id);
     sa_status status = ta_invoke_command_handler(session_context, command_id, params);
+    TRACE_SPAN_END(span);
 
 #ifdef TA_CLIENT_TEST
     // This is for testing purposes to check for implementation errors.
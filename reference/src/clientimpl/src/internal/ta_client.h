@@ -29,9 +29,10 @@
 #define TA_CLIENT_H
 
 #include "sa_ta_types.h"
+#include "trace.h"
 #ifdef __cplusplus
 
-#include <cmemory>
+#include <cstring>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -57,19 +58,31 @@ extern "C" {
     ta_free_shared_memory(command)
 
 #define CREATE_PARAM(param, input, size) \
-    param = ta_alloc_shared_memory(size); \
-    if ((param) != NULL) \
-    memcpy(param, input, size)
+    do { \
+        TRACE_SPAN_SCOPE("CREATE_PARAM"); \
+        param = ta_alloc_shared_memory(size); \
+        if ((param) != NULL) \
+            memcpy(param, input, size); \
+    } while (0)
 
 #define CREATE_OUT_PARAM(param, output, size) \
     param = ta_alloc_shared_memory(size)
 
 #define COPY_OUT_PARAM(output, param, size) \
-    memcpy(output, param, size)
+    do { \
+        TRACE_SPAN_SCOPE("COPY_OUT_PARAM"); \
+        memcpy(output, param, size); \
+    } while (0)
 
 #define RELEASE_PARAM(param) \
     ta_free_shared_memory(param)
 
+#define CREATE_BUFFER(buffer, size) \
+    buffer = ta_alloc_shared_memory(size)
+
+#define RELEASE_BUFFER(buffer) \
+    ta_free_shared_memory(buffer)
+
 #else
 
 #define CREATE_COMMAND(type, command) \
@@ -95,6 +108,13 @@ extern "C" {
     do { \
     } while (0)
 
+#define CREATE_BUFFER(buffer, size) \
+    buffer = malloc(size)
+
+#define RELEASE_BUFFER(buffer) \
+    if ((buffer) != NULL) \
+    free(buffer)
+
 #endif
 
 /**
@@ -0,0 +1,482 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @section Description
+ * @file ta_client_simulator.c
+ * This file implements the TA client interfaces on top of the ta_simulator daemon, which runs the TA in a separate
+ * process. It is selected instead of ta_client.c with ENABLE_TA_SIMULATOR, so that the cost of crossing into the TA
+ * and of copying parameters is included in benchmarks on a plain Linux host. See ta_simulator.h for the protocol.
+ */
+
+#include "ta_client.h" // NOLINT
+#include "log.h"
+#include "ta_simulator.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Small shared memory blocks, such as command structures, are carved from one arena that is mapped into the daemon
+// once. Larger blocks, such as SVP memory, get a mapping of their own.
+#define SHARED_ARENA_SIZE (16 * 1024 * 1024)
+#define SHARED_MIN_CLASS 6
+#define SHARED_MAX_CLASS 16
+#define SHARED_CLASSES (SHARED_MAX_CLASS - SHARED_MIN_CLASS + 1)
+
+typedef struct {
+    int fd;
+    pthread_mutex_t mutex;
+} simulator_session;
+
+// Precedes every arena block. Keeps the block 16 byte aligned.
+typedef struct {
+    size_t class_index;
+    size_t reserved;
+} shared_block_header;
+
+typedef struct shared_region_s {
+    uint8_t* address;
+    size_t size;
+    struct shared_region_s* next;
+} shared_region;
+
+// Protects the control connection, the arena free lists, and the region list.
+static pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int control_fd = -1;
+static _Atomic(uint8_t*) arena = NULL;
+static size_t arena_used = 0;
+static void* free_lists[SHARED_CLASSES];
+static shared_region* regions = NULL;
+static atomic_size_t region_count = 0;
+
+static bool send_all(
+        int fd,
+        struct iovec* iov,
+        size_t iov_count,
+        int fd_to_pass) {
+
+    union {
+        struct cmsghdr header;
+        uint8_t buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    struct msghdr message = {0};
+    message.msg_iov = iov;
+    message.msg_iovlen = iov_count;
+    if (fd_to_pass >= 0) {
+        memset(&control, 0, sizeof(control));
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd_to_pass, sizeof(int));
+    }
+
+    while (message.msg_iovlen > 0) {
+        ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+
+            ERROR("sendmsg failed: %d", errno);
+            return false;
+        }
+
+        // The descriptor is only passed with the first chunk.
+        message.msg_control = NULL;
+        message.msg_controllen = 0;
+        size_t remaining = (size_t) sent;
+        while (message.msg_iovlen > 0 && remaining >= message.msg_iov->iov_len) {
+            remaining -= message.msg_iov->iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+
+        if (message.msg_iovlen > 0) {
+            message.msg_iov->iov_base = (uint8_t*) message.msg_iov->iov_base + remaining;
+            message.msg_iov->iov_len -= remaining;
+        }
+    }
+
+    return true;
+}
+
+static bool receive_all(
+        int fd,
+        void* buffer,
+        size_t length) {
+
+    uint8_t* position = buffer;
+    while (length > 0) {
+        ssize_t received = recv(fd, position, length, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+
+        if (received <= 0) {
+            ERROR("recv failed: %d", received < 0 ? errno : 0);
+            return false;
+        }
+
+        position += received;
+        length -= (size_t) received;
+    }
+
+    return true;
+}
+
+static int connect_simulator() {
+    const char* path = getenv(TA_SIMULATOR_SOCKET_ENV);
+    if (path == NULL)
+        path = TA_SIMULATOR_DEFAULT_SOCKET;
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        ERROR("Socket path too long");
+        return -1;
+    }
+
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        ERROR("socket failed: %d", errno);
+        return -1;
+    }
+
+    if (connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        ERROR("connect to %s failed: %d", path, errno);
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// Sends a request without inline parameters and waits for the response status.
+static sa_status simulator_request(
+        int fd,
+        ta_simulator_request* request,
+        int fd_to_pass) {
+
+    request->magic = TA_SIMULATOR_MAGIC;
+    struct iovec iov = {request, sizeof(ta_simulator_request)};
+    ta_simulator_response response;
+    if (!send_all(fd, &iov, 1, fd_to_pass) || !receive_all(fd, &response, sizeof(response)) ||
+            response.magic != TA_SIMULATOR_MAGIC) {
+        ERROR("ta_simulator request %d failed", request->message_type);
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    return (sa_status) response.status;
+}
+
+// Creates a memfd mapping and maps it at the same address in the daemon. Called with shared_mutex held.
+static void* map_shared_region(size_t size) {
+    if (control_fd < 0) {
+        control_fd = connect_simulator();
+        if (control_fd < 0) {
+            ERROR("connect_simulator failed");
+            return NULL;
+        }
+    }
+
+    int memfd = memfd_create("ta_simulator", MFD_CLOEXEC);
+    if (memfd < 0) {
+        ERROR("memfd_create failed: %d", errno);
+        return NULL;
+    }
+
+    void* address = MAP_FAILED;
+    do {
+        if (ftruncate(memfd, (off_t) size) != 0) {
+            ERROR("ftruncate failed: %d", errno);
+            break;
+        }
+
+        address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (address == MAP_FAILED) {
+            ERROR("mmap failed: %d", errno);
+            break;
+        }
+
+        ta_simulator_request request = {0};
+        request.message_type = TA_SIMULATOR_MAP_SHARED_MEMORY;
+        request.address = (uintptr_t) address;
+        request.size = size;
+        if (simulator_request(control_fd, &request, memfd) != SA_STATUS_OK) {
+            ERROR("ta_simulator could not map shared memory");
+            munmap(address, size);
+            address = MAP_FAILED;
+            break;
+        }
+    } while (false);
+
+    close(memfd);
+    return address == MAP_FAILED ? NULL : address;
+}
+
+// Called with shared_mutex held.
+static void unmap_shared_region(
+        void* address,
+        size_t size) {
+
+    ta_simulator_request request = {0};
+    request.message_type = TA_SIMULATOR_UNMAP_SHARED_MEMORY;
+    request.address = (uintptr_t) address;
+    request.size = size;
+    if (simulator_request(control_fd, &request, -1) != SA_STATUS_OK)
+        ERROR("ta_simulator could not unmap shared memory");
+
+    munmap(address, size);
+}
+
+static bool is_shared(
+        const void* buffer,
+        size_t size) {
+
+    const uint8_t* start = buffer;
+    const uint8_t* arena_start = atomic_load(&arena);
+    if (arena_start != NULL && start >= arena_start && size <= SHARED_ARENA_SIZE &&
+            (size_t) (start - arena_start) <= SHARED_ARENA_SIZE - size)
+        return true;
+
+    if (atomic_load(&region_count) == 0)
+        return false;
+
+    bool found = false;
+    pthread_mutex_lock(&shared_mutex);
+    for (shared_region* region = regions; region != NULL && !found; region = region->next) {
+        found = start >= region->address && size <= region->size &&
+                (size_t) (start - region->address) <= region->size - size;
+    }
+
+    pthread_mutex_unlock(&shared_mutex);
+    return found;
+}
+
+sa_status ta_open_session(void** session_context) {
+    if (session_context == NULL) {
+        ERROR("NULL session_context");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    simulator_session* session = malloc(sizeof(simulator_session));
+    if (session == NULL) {
+        ERROR("malloc failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    session->fd = connect_simulator();
+    if (session->fd < 0) {
+        ERROR("connect_simulator failed");
+        free(session);
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    ta_simulator_request request = {0};
+    request.message_type = TA_SIMULATOR_OPEN_SESSION;
+    sa_status status = simulator_request(session->fd, &request, -1);
+    if (status != SA_STATUS_OK) {
+        ERROR("ta_simulator open session failed: %d", status);
+        close(session->fd);
+        free(session);
+        return status;
+    }
+
+    pthread_mutex_init(&session->mutex, NULL);
+    *session_context = session;
+    return SA_STATUS_OK;
+}
+
+void ta_close_session(void* session_context) {
+    simulator_session* session = session_context;
+    if (session == NULL)
+        return;
+
+    ta_simulator_request request = {0};
+    request.message_type = TA_SIMULATOR_CLOSE_SESSION;
+    if (simulator_request(session->fd, &request, -1) != SA_STATUS_OK)
+        ERROR("ta_simulator close session failed");
+
+    close(session->fd);
+    pthread_mutex_destroy(&session->mutex);
+    free(session);
+}
+
+sa_status ta_invoke_command(
+        void* session_context,
+        SA_COMMAND_ID command_id,
+        const ta_param_type param_types[NUM_TA_PARAMS],
+        ta_param params[NUM_TA_PARAMS]) {
+
+    simulator_session* session = session_context;
+    if (session == NULL) {
+        ERROR("NULL session");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    ta_simulator_request request = {0};
+    request.magic = TA_SIMULATOR_MAGIC;
+    request.message_type = TA_SIMULATOR_INVOKE_COMMAND;
+    request.command_id = command_id;
+
+    struct iovec in_iov[NUM_TA_PARAMS + 1] = {{&request, sizeof(request)}};
+    size_t in_iov_count = 1;
+    ta_simulator_response response;
+    struct iovec out_iov[NUM_TA_PARAMS + 1] = {{&response, sizeof(response)}};
+    size_t out_iov_count = 1;
+    for (size_t i = 0; i < NUM_TA_PARAMS; i++) {
+        ta_simulator_param* param = &request.params[i];
+        param->type = param_types[i];
+        param->size = params[i].mem_ref_size;
+        if ((params[i].mem_ref == NULL) != (param_types[i] == TA_PARAM_NULL)) {
+            // A TEE does not pass a parameter whose type is TA_PARAM_NULL, so neither does the simulator.
+            ERROR("param_types[%zu] does not match params[%zu].mem_ref for command %d", i, i, command_id);
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+
+        if (params[i].mem_ref == NULL) {
+            param->location = TA_SIMULATOR_PARAM_ABSENT;
+        } else if (is_shared(params[i].mem_ref, params[i].mem_ref_size)) {
+            param->location = TA_SIMULATOR_PARAM_SHARED;
+            param->address = (uintptr_t) params[i].mem_ref;
+        } else {
+            param->location = TA_SIMULATOR_PARAM_INLINE;
+            struct iovec iov = {params[i].mem_ref, params[i].mem_ref_size};
+            if (param_types[i] == TA_PARAM_IN || param_types[i] == TA_PARAM_INOUT)
+                in_iov[in_iov_count++] = iov;
+
+            if (param_types[i] == TA_PARAM_OUT || param_types[i] == TA_PARAM_INOUT)
+                out_iov[out_iov_count++] = iov;
+        }
+    }
+
+    bool span = TRACE_SPAN_BEGIN_ARG("ta_invoke_command", command_id);
+    sa_status status = SA_STATUS_OK;
+    pthread_mutex_lock(&session->mutex);
+    if (!send_all(session->fd, in_iov, in_iov_count, -1) ||
+            !receive_all(session->fd, &response, sizeof(response)) || response.magic != TA_SIMULATOR_MAGIC) {
+        ERROR("ta_simulator invoke command failed");
+        status = SA_STATUS_INTERNAL_ERROR;
+    } else {
+        // The contents of inline OUT and INOUT parameters follow the response whatever the status.
+        status = (sa_status) response.status;
+        for (size_t i = 1; i < out_iov_count; i++) {
+            if (!receive_all(session->fd, out_iov[i].iov_base, out_iov[i].iov_len)) {
+                ERROR("receive_all failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&session->mutex);
+    TRACE_SPAN_END(span);
+    return status;
+}
+
+void* ta_alloc_shared_memory(size_t size) {
+    size_t class_index = 0;
+    while (class_index < SHARED_CLASSES &&
+            ((size_t) 1 << (class_index + SHARED_MIN_CLASS)) < size + sizeof(shared_block_header))
+        class_index++;
+
+    void* buffer = NULL;
+    pthread_mutex_lock(&shared_mutex);
+    do {
+        if (class_index < SHARED_CLASSES) {
+            if (free_lists[class_index] != NULL) {
+                shared_block_header* header = free_lists[class_index];
+                memcpy(&free_lists[class_index], header + 1, sizeof(void*));
+                buffer = header + 1;
+                break;
+            }
+
+            if (atomic_load(&arena) == NULL)
+                atomic_store(&arena, map_shared_region(SHARED_ARENA_SIZE));
+
+            size_t block_size = (size_t) 1 << (class_index + SHARED_MIN_CLASS);
+            uint8_t* arena_start = atomic_load(&arena);
+            if (arena_start != NULL && SHARED_ARENA_SIZE - arena_used >= block_size) {
+                shared_block_header* header = (shared_block_header*) (arena_start + arena_used);
+                header->class_index = class_index;
+                arena_used += block_size;
+                buffer = header + 1;
+                break;
+            }
+        }
+
+        // Large blocks, and small blocks once the arena is exhausted, get a mapping of their own.
+        shared_region* region = malloc(sizeof(shared_region));
+        if (region == NULL) {
+            ERROR("malloc failed");
+            break;
+        }
+
+        region->size = size == 0 ? 1 : size;
+        region->address = map_shared_region(region->size);
+        if (region->address == NULL) {
+            ERROR("map_shared_region failed");
+            free(region);
+            break;
+        }
+
+        region->next = regions;
+        regions = region;
+        atomic_fetch_add(&region_count, 1);
+        buffer = region->address;
+    } while (false);
+
+    pthread_mutex_unlock(&shared_mutex);
+    return buffer;
+}
+
+void ta_free_shared_memory(void* buffer) {
+    if (buffer == NULL)
+        return;
+
+    pthread_mutex_lock(&shared_mutex);
+    uint8_t* arena_start = atomic_load(&arena);
+    if (arena_start != NULL && (uint8_t*) buffer > arena_start &&
+            (uint8_t*) buffer < arena_start + SHARED_ARENA_SIZE) {
+        shared_block_header* header = (shared_block_header*) buffer - 1;
+        memcpy(buffer, &free_lists[header->class_index], sizeof(void*));
+        free_lists[header->class_index] = header;
+    } else {
+        for (shared_region** region = &regions; *region != NULL; region = &(*region)->next) {
+            if ((*region)->address == buffer) {
+                shared_region* found = *region;
+                *region = found->next;
+                atomic_fetch_sub(&region_count, 1);
+                unmap_shared_region(found->address, found->size);
+                free(found);
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&shared_mutex);
+}
@@ -0,0 +1,29 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "log.h"
+#include "sa.h"
+
+sa_status sa_coalesce_releases(bool enable) {
+    sa_status status = client_coalesce_releases(enable);
+    if (status != SA_STATUS_OK)
+        ERROR("client_coalesce_releases failed: %d", status);
+
+    return status;
+}
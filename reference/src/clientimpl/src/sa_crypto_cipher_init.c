@@ -293,7 +293,7 @@ sa_status sa_crypto_cipher_init(
                 param1_type = TA_PARAM_IN;
                 if (parameters_rsa_oaep->label != NULL) {
                     CREATE_PARAM(param2, (void*) parameters_rsa_oaep->label,
-                            parameters_rsa_oaep_s->label_length);
+                            parameters_rsa_oaep->label_length);
                     if (param2 == NULL) {
                         ERROR("CREATE_PARAM failed");
                         status = SA_STATUS_INTERNAL_ERROR;
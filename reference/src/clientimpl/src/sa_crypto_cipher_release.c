@@ -24,6 +24,11 @@
 
 sa_status sa_crypto_cipher_release(sa_crypto_cipher_context context) {
 
+    // With release coalescing the release is sent to the TA later, batched with others. See sa_coalesce_releases.
+    sa_crypto_cipher_release_s queued_release = {.api_version = API_VERSION, .cipher_context = context};
+    if (client_defer_release(SA_CRYPTO_CIPHER_RELEASE, &queued_release, sizeof(sa_crypto_cipher_release_s)))
+        return SA_STATUS_OK;
+
     void* session = client_session();
     if (session == NULL) {
         ERROR("client_session failed");
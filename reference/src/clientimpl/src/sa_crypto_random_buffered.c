@@ -0,0 +1,158 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "log.h"
+#include "sa.h"
+#include <openssl/crypto.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+// Number of bytes fetched from the TA at a time.
+#define RANDOM_BLOCK_SIZE 4096
+
+// Requests larger than this are forwarded to sa_crypto_random so that a single request cannot drain the block.
+#define MAX_BUFFERED_REQUEST 256
+
+typedef struct {
+    uint8_t block[RANDOM_BLOCK_SIZE];
+    // offset of the first unused byte in block.
+    size_t offset;
+    unsigned int fork_generation;
+} random_buffer;
+
+static thread_local random_buffer* buffer = NULL;
+static tss_t thread_buffer;
+static once_flag flag = ONCE_FLAG_INIT;
+static bool initialized = false;
+
+// Incremented in the child after a fork. A buffer filled before the fork would otherwise hand out the same bytes in
+// the parent and in the child.
+static atomic_uint fork_generation = 0;
+
+static void buffer_free(void* thread_buffer_ptr) {
+    random_buffer* random_buffer_ptr = thread_buffer_ptr;
+    if (random_buffer_ptr != NULL) {
+        OPENSSL_cleanse(random_buffer_ptr, sizeof(random_buffer));
+        free(random_buffer_ptr);
+    }
+}
+
+static void fork_child() {
+    atomic_fetch_add(&fork_generation, 1);
+}
+
+static void buffer_create() {
+    // Calls buffer_free when the thread exits.
+    if (tss_create(&thread_buffer, buffer_free) != thrd_success) {
+        ERROR("tss_create failed");
+        return;
+    }
+
+    if (pthread_atfork(NULL, NULL, fork_child) != 0) {
+        ERROR("pthread_atfork failed");
+        return;
+    }
+
+    initialized = true;
+}
+
+static random_buffer* buffer_get() {
+    if (buffer != NULL)
+        return buffer;
+
+    call_once(&flag, buffer_create);
+    if (!initialized)
+        return NULL;
+
+    random_buffer* new_buffer = malloc(sizeof(random_buffer));
+    if (new_buffer == NULL) {
+        ERROR("malloc failed");
+        return NULL;
+    }
+
+    // An empty buffer is refilled on first use.
+    new_buffer->offset = RANDOM_BLOCK_SIZE;
+    new_buffer->fork_generation = atomic_load(&fork_generation);
+    if (tss_set(thread_buffer, new_buffer) != thrd_success) {
+        ERROR("tss_set failed");
+        free(new_buffer);
+        return NULL;
+    }
+
+    buffer = new_buffer;
+    return buffer;
+}
+
+// Copies length bytes out of the buffer and wipes them, so that random data that has been handed out does not linger
+// in memory.
+static size_t buffer_take(
+        uint8_t* out,
+        size_t length) {
+
+    size_t available = RANDOM_BLOCK_SIZE - buffer->offset;
+    size_t taken = length < available ? length : available;
+    memcpy(out, buffer->block + buffer->offset, taken);
+    OPENSSL_cleanse(buffer->block + buffer->offset, taken);
+    buffer->offset += taken;
+    return taken;
+}
+
+sa_status sa_crypto_random_buffered(
+        void* out,
+        size_t length) {
+
+    if (out == NULL) {
+        ERROR("NULL out");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (length > MAX_BUFFERED_REQUEST)
+        return sa_crypto_random(out, length);
+
+    if (buffer_get() == NULL) {
+        ERROR("buffer_get failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    unsigned int generation = atomic_load(&fork_generation);
+    if (buffer->fork_generation != generation) {
+        OPENSSL_cleanse(buffer->block, RANDOM_BLOCK_SIZE);
+        buffer->offset = RANDOM_BLOCK_SIZE;
+        buffer->fork_generation = generation;
+    }
+
+    uint8_t* out_bytes = out;
+    size_t taken = buffer_take(out_bytes, length);
+    if (taken < length) {
+        sa_status status = sa_crypto_random(buffer->block, RANDOM_BLOCK_SIZE);
+        if (status != SA_STATUS_OK) {
+            ERROR("sa_crypto_random failed: %d", status);
+            OPENSSL_cleanse(out, taken);
+            return status;
+        }
+
+        buffer->offset = 0;
+        buffer_take(out_bytes + taken, length - taken);
+    }
+
+    return SA_STATUS_OK;
+}
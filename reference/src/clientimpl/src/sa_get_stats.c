@@ -0,0 +1,89 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "log.h"
+#include "sa.h"
+#include "ta_client.h"
+#include <stdbool.h>
+
+sa_status sa_get_stats(
+        void* stats,
+        size_t* stats_length) {
+
+    if (stats_length == NULL) {
+        ERROR("NULL stats_length");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    void* session = client_session();
+    if (session == NULL) {
+        ERROR("client_session failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_get_stats_s* get_stats = NULL;
+    void* param1 = NULL;
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_get_stats_s, get_stats);
+        if (get_stats == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        get_stats->api_version = API_VERSION;
+        get_stats->stats_length = *stats_length;
+
+        size_t param1_size = 0;
+        ta_param_type param1_type = TA_PARAM_NULL;
+        if (stats != NULL) {
+            CREATE_OUT_PARAM(param1, stats, *stats_length);
+            if (param1 == NULL) {
+                ERROR("CREATE_OUT_PARAM failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            param1_type = TA_PARAM_OUT;
+            param1_size = *stats_length;
+        }
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, param1_type, TA_PARAM_NULL, TA_PARAM_NULL};
+        ta_param params[NUM_TA_PARAMS] = {{get_stats, sizeof(sa_get_stats_s)},
+                                          {param1, param1_size},
+                                          {NULL, 0},
+                                          {NULL, 0}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_GET_STATS, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+
+        *stats_length = get_stats->stats_length;
+        if (stats != NULL)
+            COPY_OUT_PARAM(stats, param1, get_stats->stats_length);
+    } while (false);
+
+    RELEASE_COMMAND(get_stats);
+    RELEASE_PARAM(param1);
+    return status;
+}
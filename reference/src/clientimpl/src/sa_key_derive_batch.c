@@ -0,0 +1,239 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "key_header_cache.h"
+#include "log.h"
+#include "sa.h"
+#include "ta_client.h"
+#include <stdbool.h>
+
+sa_status sa_key_derive_batch(
+        sa_kdf_batch_entry* entries,
+        size_t entries_length,
+        sa_kdf_algorithm kdf_algorithm,
+        void* parameters) {
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length < 1) {
+        ERROR("entries_length < 1");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (entries_length > SIZE_MAX / sizeof(sa_kdf_batch_entry_s)) {
+        ERROR("entries_length is too large");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (parameters == NULL) {
+        ERROR("NULL parameters");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    const void* salt = NULL;
+    size_t salt_length = 0;
+    if (kdf_algorithm == SA_KDF_ALGORITHM_HKDF) {
+        sa_kdf_parameters_hkdf* parameters_hkdf = (sa_kdf_parameters_hkdf*) parameters;
+        if (parameters_hkdf->salt == NULL && parameters_hkdf->salt_length > 0) {
+            ERROR("NULL salt");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        salt = parameters_hkdf->salt;
+        salt_length = parameters_hkdf->salt_length;
+    }
+
+    size_t data_length = salt_length;
+    for (size_t i = 0; i < entries_length; i++) {
+        if (entries[i].rights == NULL) {
+            ERROR("NULL rights");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].info == NULL && entries[i].info_length > 0) {
+            ERROR("NULL info");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].info_length > SIZE_MAX - data_length) {
+            ERROR("info_length is too large");
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+
+        data_length += entries[i].info_length;
+    }
+
+    void* session = client_session();
+    if (session == NULL) {
+        ERROR("client_session failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_key_derive_batch_s* key_derive_batch = NULL;
+    void* param1 = NULL;
+    sa_kdf_batch_entry_s* param2 = NULL;
+    uint8_t* param3 = NULL;
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_key_derive_batch_s, key_derive_batch);
+        if (key_derive_batch == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        key_derive_batch->api_version = API_VERSION;
+        key_derive_batch->kdf_algorithm = kdf_algorithm;
+        key_derive_batch->entries_length = entries_length;
+        key_derive_batch->salt_length = salt_length;
+
+        size_t param1_size;
+        switch (kdf_algorithm) {
+            case SA_KDF_ALGORITHM_HKDF: {
+                sa_kdf_parameters_hkdf* parameters_hkdf = (sa_kdf_parameters_hkdf*) parameters;
+                CREATE_COMMAND(sa_kdf_parameters_hkdf_s, param1);
+                if (param1 == NULL) {
+                    ERROR("CREATE_COMMAND failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    continue; // NOLINT
+                }
+
+                sa_kdf_parameters_hkdf_s* parameters_hkdf_s = (sa_kdf_parameters_hkdf_s*) param1;
+                parameters_hkdf_s->key_length = parameters_hkdf->key_length;
+                parameters_hkdf_s->digest_algorithm = parameters_hkdf->digest_algorithm;
+                parameters_hkdf_s->parent = parameters_hkdf->parent;
+                param1_size = sizeof(sa_kdf_parameters_hkdf_s);
+                break;
+            }
+            case SA_KDF_ALGORITHM_CONCAT: {
+                sa_kdf_parameters_concat* parameters_concat = (sa_kdf_parameters_concat*) parameters;
+                CREATE_COMMAND(sa_kdf_parameters_concat_s, param1);
+                if (param1 == NULL) {
+                    ERROR("CREATE_COMMAND failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    continue; // NOLINT
+                }
+
+                sa_kdf_parameters_concat_s* parameters_concat_s = (sa_kdf_parameters_concat_s*) param1;
+                parameters_concat_s->key_length = parameters_concat->key_length;
+                parameters_concat_s->digest_algorithm = parameters_concat->digest_algorithm;
+                parameters_concat_s->parent = parameters_concat->parent;
+                param1_size = sizeof(sa_kdf_parameters_concat_s);
+                break;
+            }
+            case SA_KDF_ALGORITHM_ANSI_X963: {
+                sa_kdf_parameters_ansi_x963* parameters_ansi_x963 = (sa_kdf_parameters_ansi_x963*) parameters;
+                CREATE_COMMAND(sa_kdf_parameters_ansi_x963_s, param1);
+                if (param1 == NULL) {
+                    ERROR("CREATE_COMMAND failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    continue; // NOLINT
+                }
+
+                sa_kdf_parameters_ansi_x963_s* parameters_ansi_x963_s = (sa_kdf_parameters_ansi_x963_s*) param1;
+                parameters_ansi_x963_s->key_length = parameters_ansi_x963->key_length;
+                parameters_ansi_x963_s->digest_algorithm = parameters_ansi_x963->digest_algorithm;
+                parameters_ansi_x963_s->parent = parameters_ansi_x963->parent;
+                param1_size = sizeof(sa_kdf_parameters_ansi_x963_s);
+                break;
+            }
+            case SA_KDF_ALGORITHM_CMAC: {
+                sa_kdf_parameters_cmac* parameters_cmac = (sa_kdf_parameters_cmac*) parameters;
+                CREATE_COMMAND(sa_kdf_parameters_cmac_s, param1);
+                if (param1 == NULL) {
+                    ERROR("CREATE_COMMAND failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    continue; // NOLINT
+                }
+
+                sa_kdf_parameters_cmac_s* parameters_cmac_s = (sa_kdf_parameters_cmac_s*) param1;
+                parameters_cmac_s->key_length = parameters_cmac->key_length;
+                parameters_cmac_s->parent = parameters_cmac->parent;
+                parameters_cmac_s->counter = parameters_cmac->counter;
+                param1_size = sizeof(sa_kdf_parameters_cmac_s);
+                break;
+            }
+            default:
+                status = SA_STATUS_INVALID_PARAMETER;
+                continue; // NOLINT
+        }
+
+        size_t param2_size = entries_length * sizeof(sa_kdf_batch_entry_s);
+        CREATE_BUFFER(param2, param2_size);
+        if (param2 == NULL) {
+            ERROR("CREATE_BUFFER failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        ta_param_type param3_type = TA_PARAM_NULL;
+        if (data_length > 0) {
+            CREATE_BUFFER(param3, data_length);
+            if (param3 == NULL) {
+                ERROR("CREATE_BUFFER failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            param3_type = TA_PARAM_IN;
+            if (salt_length > 0)
+                memcpy(param3, salt, salt_length);
+        }
+
+        // Pack all info values after the salt so that the whole batch fits in a single command.
+        size_t offset = salt_length;
+        for (size_t i = 0; i < entries_length; i++) {
+            param2[i].key = INVALID_HANDLE;
+            param2[i].rights = *entries[i].rights;
+            param2[i].info_offset = offset;
+            param2[i].info_length = entries[i].info_length;
+            if (entries[i].info_length > 0) {
+                memcpy(param3 + offset, entries[i].info, entries[i].info_length);
+                offset += entries[i].info_length;
+            }
+        }
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, TA_PARAM_IN, TA_PARAM_INOUT, param3_type};
+        ta_param params[NUM_TA_PARAMS] = {{key_derive_batch, sizeof(sa_key_derive_batch_s)},
+                                          {param1, param1_size},
+                                          {param2, param2_size},
+                                          {param3, data_length}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_KEY_DERIVE_BATCH, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+
+        for (size_t i = 0; i < entries_length; i++) {
+            entries[i].key = param2[i].key;
+            key_header_cache_invalidate(client_session_id(), entries[i].key);
+        }
+    } while (false);
+
+    RELEASE_COMMAND(key_derive_batch);
+    RELEASE_COMMAND(param1);
+    RELEASE_BUFFER(param2);
+    RELEASE_BUFFER(param3);
+    return status;
+}
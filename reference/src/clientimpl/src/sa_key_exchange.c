@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -152,6 +153,7 @@ sa_status sa_key_exchange(
         }
 
         *key = key_exchange->key;
+        key_header_cache_invalidate(client_session_id(), *key);
         if (key_exchange_algorithm == SA_KEY_EXCHANGE_ALGORITHM_NETFLIX_AUTHENTICATED_DH) {
             *netflix_authenticated_dh->out_ke = netflix_authenticated_dh_s->out_ke;
             *netflix_authenticated_dh->out_kh = netflix_authenticated_dh_s->out_kh;
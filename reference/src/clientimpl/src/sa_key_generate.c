@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -132,6 +133,7 @@ sa_status sa_key_generate(
         }
 
         *key = key_generate->key;
+        key_header_cache_invalidate(client_session_id(), *key);
     } while (false);
 
     RELEASE_COMMAND(key_generate);
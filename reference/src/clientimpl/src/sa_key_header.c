@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -37,6 +38,10 @@ sa_status sa_key_header(
         return SA_STATUS_INTERNAL_ERROR;
     }
 
+    uint32_t epoch;
+    if (key_header_cache_lookup(header, &epoch, client_session_id(), key))
+        return SA_STATUS_OK;
+
     sa_key_header_s* key_header = NULL;
     sa_status status;
     do {
@@ -65,6 +70,7 @@ sa_status sa_key_header(
         }
 
         *header = key_header->header;
+        key_header_cache_insert(client_session_id(), key, header, epoch);
     } while (false);
 
     RELEASE_COMMAND(key_header);
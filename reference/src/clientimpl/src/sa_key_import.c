@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -221,6 +222,7 @@ sa_status sa_key_import(
         }
 
         *key = key_import->key;
+        key_header_cache_invalidate(client_session_id(), *key);
     } while (false);
 
     RELEASE_COMMAND(key_import);
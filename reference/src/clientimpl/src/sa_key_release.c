@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -24,6 +25,11 @@
 
 sa_status sa_key_release(sa_key key) {
 
+    // With release coalescing the release is sent to the TA later, batched with others. See sa_coalesce_releases.
+    sa_key_release_s queued_release = {.api_version = API_VERSION, .key = key};
+    if (client_defer_release(SA_KEY_RELEASE, &queued_release, sizeof(sa_key_release_s)))
+        return SA_STATUS_OK;
+
     void* session = client_session();
     if (session == NULL) {
         ERROR("client_session failed");
@@ -57,6 +63,8 @@ sa_status sa_key_release(sa_key key) {
         }
     } while (false);
 
+    // The handle can be reassigned to a new key as soon as the TA has released it.
+    key_header_cache_invalidate(client_session_id(), key);
     RELEASE_COMMAND(key_release);
     return status;
 }
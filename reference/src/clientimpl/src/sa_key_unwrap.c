@@ -17,6 +17,7 @@
  */
 
 #include "client.h"
+#include "key_header_cache.h"
 #include "log.h"
 #include "sa.h"
 #include "ta_client.h"
@@ -444,7 +445,7 @@ sa_status sa_key_unwrap(
                 param2_type = TA_PARAM_IN;
                 if (parameters_rsa_oaep->label != NULL) {
                     CREATE_PARAM(param3, (void*) parameters_rsa_oaep->label,
-                            parameters_rsa_oaep_s->label_length);
+                            parameters_rsa_oaep->label_length);
                     if (param3 == NULL) {
                         ERROR("CREATE_PARAM failed");
                         status = SA_STATUS_INTERNAL_ERROR;
@@ -479,6 +480,7 @@ sa_status sa_key_unwrap(
         }
 
         *key = key_unwrap->key;
+        key_header_cache_invalidate(client_session_id(), *key);
     } while (false);
 
     RELEASE_COMMAND(key_unwrap);
@@ -0,0 +1,267 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "key_header_cache.h"
+#include "log.h"
+#include "sa.h"
+#include "ta_client.h"
+#include <stdbool.h>
+
+
+static sa_status copy_parameters(
+        sa_unwrap_batch_entry_s* entry_s,
+        size_t* aad_length,
+        const void** aad,
+        sa_cipher_algorithm cipher_algorithm,
+        const void* algorithm_parameters) {
+
+    *aad = NULL;
+    *aad_length = 0;
+    switch (cipher_algorithm) {
+        case SA_CIPHER_ALGORITHM_AES_ECB:
+        case SA_CIPHER_ALGORITHM_AES_ECB_PKCS7:
+            return SA_STATUS_OK;
+
+        case SA_CIPHER_ALGORITHM_AES_CBC:
+        case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7: {
+            const sa_unwrap_parameters_aes_cbc* parameters_aes_cbc =
+                    (const sa_unwrap_parameters_aes_cbc*) algorithm_parameters;
+            if (parameters_aes_cbc == NULL || parameters_aes_cbc->iv == NULL) {
+                ERROR("NULL iv");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_cbc->iv_length != AES_BLOCK_SIZE) {
+                ERROR("Invalid iv_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            memcpy(entry_s->iv, parameters_aes_cbc->iv, parameters_aes_cbc->iv_length);
+            entry_s->iv_length = parameters_aes_cbc->iv_length;
+            return SA_STATUS_OK;
+        }
+        case SA_CIPHER_ALGORITHM_AES_CTR: {
+            const sa_unwrap_parameters_aes_ctr* parameters_aes_ctr =
+                    (const sa_unwrap_parameters_aes_ctr*) algorithm_parameters;
+            if (parameters_aes_ctr == NULL || parameters_aes_ctr->ctr == NULL) {
+                ERROR("NULL ctr");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_ctr->ctr_length != AES_BLOCK_SIZE) {
+                ERROR("Invalid ctr_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            memcpy(entry_s->iv, parameters_aes_ctr->ctr, parameters_aes_ctr->ctr_length);
+            entry_s->iv_length = parameters_aes_ctr->ctr_length;
+            return SA_STATUS_OK;
+        }
+        case SA_CIPHER_ALGORITHM_AES_GCM: {
+            const sa_unwrap_parameters_aes_gcm* parameters_aes_gcm =
+                    (const sa_unwrap_parameters_aes_gcm*) algorithm_parameters;
+            if (parameters_aes_gcm == NULL || parameters_aes_gcm->iv == NULL) {
+                ERROR("NULL iv");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->iv_length != GCM_IV_LENGTH) {
+                ERROR("Invalid iv_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->aad == NULL && parameters_aes_gcm->aad_length > 0) {
+                ERROR("NULL aad");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->tag == NULL) {
+                ERROR("NULL tag");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->tag_length > MAX_GCM_TAG_LENGTH) {
+                ERROR("Invalid tag_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            memcpy(entry_s->iv, parameters_aes_gcm->iv, parameters_aes_gcm->iv_length);
+            entry_s->iv_length = parameters_aes_gcm->iv_length;
+            memcpy(entry_s->tag, parameters_aes_gcm->tag, parameters_aes_gcm->tag_length);
+            entry_s->tag_length = parameters_aes_gcm->tag_length;
+            *aad = parameters_aes_gcm->aad;
+            *aad_length = parameters_aes_gcm->aad_length;
+            return SA_STATUS_OK;
+        }
+        default:
+            ERROR("Invalid algorithm");
+            return SA_STATUS_INVALID_PARAMETER;
+    }
+}
+
+sa_status sa_key_unwrap_batch(
+        sa_unwrap_batch_entry* entries,
+        size_t entries_length,
+        sa_cipher_algorithm cipher_algorithm,
+        sa_key wrapping_key) {
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length < 1) {
+        ERROR("entries_length < 1");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (entries_length > SIZE_MAX / sizeof(sa_unwrap_batch_entry_s)) {
+        ERROR("entries_length is too large");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t data_length = 0;
+    for (size_t i = 0; i < entries_length; i++) {
+        if (entries[i].rights == NULL) {
+            ERROR("NULL rights");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].in == NULL) {
+            ERROR("NULL in");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].in_length > SIZE_MAX - data_length) {
+            ERROR("in_length is too large");
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+
+        data_length += entries[i].in_length;
+        if (cipher_algorithm == SA_CIPHER_ALGORITHM_AES_GCM && entries[i].algorithm_parameters != NULL) {
+            const sa_unwrap_parameters_aes_gcm* parameters_aes_gcm =
+                    (const sa_unwrap_parameters_aes_gcm*) entries[i].algorithm_parameters;
+            if (parameters_aes_gcm->aad_length > SIZE_MAX - data_length) {
+                ERROR("aad_length is too large");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            data_length += parameters_aes_gcm->aad_length;
+        }
+    }
+
+    if (data_length == 0) {
+        ERROR("Invalid in_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    void* session = client_session();
+    if (session == NULL) {
+        ERROR("client_session failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_key_unwrap_batch_s* key_unwrap_batch = NULL;
+    sa_unwrap_batch_entry_s* param1 = NULL;
+    uint8_t* param2 = NULL;
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_key_unwrap_batch_s, key_unwrap_batch);
+        if (key_unwrap_batch == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        key_unwrap_batch->api_version = API_VERSION;
+        key_unwrap_batch->cipher_algorithm = cipher_algorithm;
+        key_unwrap_batch->wrapping_key = wrapping_key;
+        key_unwrap_batch->entries_length = entries_length;
+
+        size_t param1_size = entries_length * sizeof(sa_unwrap_batch_entry_s);
+        CREATE_BUFFER(param1, param1_size);
+        if (param1 == NULL) {
+            ERROR("CREATE_BUFFER failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        CREATE_BUFFER(param2, data_length);
+        if (param2 == NULL) {
+            ERROR("CREATE_BUFFER failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        // Pack all wrapped keys and aad values so that the whole batch fits in a single command.
+        size_t offset = 0;
+        status = SA_STATUS_OK;
+        for (size_t i = 0; i < entries_length; i++) {
+            memset(&param1[i], 0, sizeof(sa_unwrap_batch_entry_s));
+            param1[i].key = INVALID_HANDLE;
+            param1[i].rights = *entries[i].rights;
+            param1[i].in_offset = offset;
+            param1[i].in_length = entries[i].in_length;
+            memcpy(param2 + offset, entries[i].in, entries[i].in_length);
+            offset += entries[i].in_length;
+
+            const void* aad;
+            size_t aad_length;
+            status = copy_parameters(&param1[i], &aad_length, &aad, cipher_algorithm,
+                    entries[i].algorithm_parameters);
+            if (status != SA_STATUS_OK) {
+                ERROR("copy_parameters failed");
+                break;
+            }
+
+            param1[i].aad_offset = offset;
+            param1[i].aad_length = aad_length;
+            if (aad_length > 0) {
+                memcpy(param2 + offset, aad, aad_length);
+                offset += aad_length;
+            }
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, TA_PARAM_INOUT, TA_PARAM_IN, TA_PARAM_NULL};
+        ta_param params[NUM_TA_PARAMS] = {{key_unwrap_batch, sizeof(sa_key_unwrap_batch_s)},
+                                          {param1, param1_size},
+                                          {param2, data_length},
+                                          {NULL, 0}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_KEY_UNWRAP_BATCH, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+
+        for (size_t i = 0; i < entries_length; i++) {
+            entries[i].key = param1[i].key;
+            key_header_cache_invalidate(client_session_id(), entries[i].key);
+        }
+    } while (false);
+
+    RELEASE_COMMAND(key_unwrap_batch);
+    RELEASE_BUFFER(param1);
+    RELEASE_BUFFER(param2);
+    return status;
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "log.h"
+#include "sa.h"
+#include "ta_client.h"
+#include <stdbool.h>
+
+sa_status sa_svp_buffer_batch(
+        const void* in,
+        size_t in_length,
+        const sa_svp_batch_entry* entries,
+        size_t entries_length) {
+
+    if (in == NULL && in_length > 0) {
+        ERROR("NULL in");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length < 1) {
+        ERROR("entries_length < 1");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (entries_length > SIZE_MAX / sizeof(sa_svp_batch_entry_s)) {
+        ERROR("entries_length is too large");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t offsets_count = 0;
+    for (size_t i = 0; i < entries_length; i++) {
+        if (entries[i].offsets == NULL) {
+            ERROR("NULL offsets");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].offsets_length > SIZE_MAX / sizeof(sa_svp_offset) - offsets_count) {
+            ERROR("offsets_length is too large");
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+
+        offsets_count += entries[i].offsets_length;
+    }
+
+    void* session = client_session();
+    if (session == NULL) {
+        ERROR("client_session failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_svp_buffer_batch_s* svp_buffer_batch = NULL;
+    sa_svp_batch_entry_s* param1 = NULL;
+    sa_svp_offset* param2 = NULL;
+    void* param3 = NULL;
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_svp_buffer_batch_s, svp_buffer_batch);
+        if (svp_buffer_batch == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        svp_buffer_batch->api_version = API_VERSION;
+        svp_buffer_batch->entries_length = entries_length;
+
+        size_t param1_size = entries_length * sizeof(sa_svp_batch_entry_s);
+        CREATE_BUFFER(param1, param1_size);
+        if (param1 == NULL) {
+            ERROR("CREATE_BUFFER failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        // Always allocate at least one offset so that the TA sees a non NULL offsets parameter.
+        size_t param2_size = offsets_count * sizeof(sa_svp_offset);
+        CREATE_BUFFER(param2, param2_size > 0 ? param2_size : sizeof(sa_svp_offset));
+        if (param2 == NULL) {
+            ERROR("CREATE_BUFFER failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        // Pack the offsets of all entries so that the whole batch fits in a single command.
+        size_t offsets_index = 0;
+        for (size_t i = 0; i < entries_length; i++) {
+            memset(&param1[i], 0, sizeof(sa_svp_batch_entry_s));
+            param1[i].out = entries[i].out;
+            param1[i].in = entries[i].in;
+            param1[i].offsets_index = offsets_index;
+            param1[i].offsets_length = entries[i].offsets_length;
+            memcpy(param2 + offsets_index, entries[i].offsets, entries[i].offsets_length * sizeof(sa_svp_offset));
+            offsets_index += entries[i].offsets_length;
+        }
+
+        size_t param3_size;
+        ta_param_type param3_type;
+        if (in != NULL) {
+            CREATE_PARAM(param3, (void*) in, in_length);
+            if (param3 == NULL) {
+                ERROR("CREATE_PARAM failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            param3_size = in_length;
+            param3_type = TA_PARAM_IN;
+        } else {
+            param3_size = 0;
+            param3_type = TA_PARAM_NULL;
+        }
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, TA_PARAM_IN, TA_PARAM_IN, param3_type};
+        ta_param params[NUM_TA_PARAMS] = {{svp_buffer_batch, sizeof(sa_svp_buffer_batch_s)},
+                                          {param1, param1_size},
+                                          {param2, param2_size},
+                                          {param3, param3_size}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_SVP_BUFFER_BATCH, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+    } while (false);
+
+    RELEASE_COMMAND(svp_buffer_batch);
+    RELEASE_BUFFER(param1);
+    RELEASE_BUFFER(param2);
+    RELEASE_PARAM(param3);
+    return status;
+}
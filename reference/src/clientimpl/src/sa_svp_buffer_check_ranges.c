@@ -0,0 +1,104 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client.h"
+#include "log.h"
+#include "sa.h"
+#include "ta_client.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+sa_status sa_svp_buffer_check_ranges(
+        sa_svp_buffer svp_buffer,
+        const sa_svp_range* ranges,
+        size_t ranges_length,
+        sa_digest_algorithm digest_algorithm,
+        const void* hashes,
+        size_t hashes_length) {
+
+    if (ranges == NULL) {
+        ERROR("NULL ranges");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (hashes == NULL) {
+        ERROR("NULL hashes");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (ranges_length == 0 || ranges_length > SIZE_MAX / sizeof(sa_svp_range)) {
+        ERROR("Invalid ranges_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    void* session = client_session();
+    if (session == NULL) {
+        ERROR("client_session failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_svp_buffer_check_ranges_s* svp_buffer_check_ranges = NULL;
+    void* param1 = NULL;
+    void* param2 = NULL;
+    sa_status status;
+    do {
+        CREATE_COMMAND(sa_svp_buffer_check_ranges_s, svp_buffer_check_ranges);
+        if (svp_buffer_check_ranges == NULL) {
+            ERROR("CREATE_COMMAND failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        svp_buffer_check_ranges->api_version = API_VERSION;
+        svp_buffer_check_ranges->svp_buffer = svp_buffer;
+        svp_buffer_check_ranges->digest_algorithm = digest_algorithm;
+
+        size_t param1_size = ranges_length * sizeof(sa_svp_range);
+        CREATE_PARAM(param1, (void*) ranges, param1_size);
+        if (param1 == NULL) {
+            ERROR("CREATE_PARAM failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        CREATE_PARAM(param2, (void*) hashes, hashes_length);
+        if (param2 == NULL) {
+            ERROR("CREATE_PARAM failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        // clang-format off
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_IN, TA_PARAM_IN, TA_PARAM_IN, TA_PARAM_NULL};
+        ta_param params[NUM_TA_PARAMS] = {{svp_buffer_check_ranges, sizeof(sa_svp_buffer_check_ranges_s)},
+                                          {param1, param1_size},
+                                          {param2, hashes_length},
+                                          {NULL, 0}};
+        // clang-format on
+        status = ta_invoke_command(session, SA_SVP_BUFFER_CHECK_RANGES, param_types, params);
+        if (status != SA_STATUS_OK) {
+            ERROR("ta_invoke_command failed: %d", status);
+            break;
+        }
+    } while (false);
+
+    RELEASE_COMMAND(svp_buffer_check_ranges);
+    RELEASE_PARAM(param1);
+    RELEASE_PARAM(param2);
+    return status;
+}
@@ -0,0 +1,351 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "log.h"
+#include "sa.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <threads.h>
+
+typedef struct {
+    size_t size;
+    // stack of free buffers.
+    sa_svp_buffer* free_buffers;
+    size_t free_count;
+    size_t free_capacity;
+} size_class;
+
+typedef struct {
+    sa_svp_buffer svp_buffer;
+    size_t class_index;
+} in_use_buffer;
+
+struct sa_svp_buffer_pool_s {
+    mtx_t mutex;
+    size_class* classes;
+    size_t class_count;
+    size_t min_free;
+    size_t max_free;
+    in_use_buffer* in_use;
+    size_t in_use_count;
+    size_t in_use_capacity;
+    sa_svp_buffer_pool_stats stats;
+};
+
+static bool grow(
+        void** array,
+        size_t* capacity,
+        size_t count,
+        size_t element_size) {
+
+    if (count < *capacity)
+        return true;
+
+    size_t new_capacity = *capacity == 0 ? 8 : *capacity * 2;
+    void* new_array = realloc(*array, new_capacity * element_size);
+    if (new_array == NULL) {
+        ERROR("realloc failed");
+        return false;
+    }
+
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+static sa_status push_free(
+        sa_svp_buffer_pool* pool,
+        size_t class_index,
+        sa_svp_buffer svp_buffer) {
+
+    size_class* buffer_class = &pool->classes[class_index];
+    if (!grow((void**) &buffer_class->free_buffers, &buffer_class->free_capacity, buffer_class->free_count,
+                sizeof(sa_svp_buffer))) {
+        ERROR("grow failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    buffer_class->free_buffers[buffer_class->free_count++] = svp_buffer;
+    pool->stats.free_buffers++;
+    return SA_STATUS_OK;
+}
+
+static sa_status create_free(
+        sa_svp_buffer_pool* pool,
+        size_t class_index) {
+
+    sa_svp_buffer svp_buffer;
+    sa_status status = sa_svp_buffer_alloc(&svp_buffer, pool->classes[class_index].size);
+    if (status != SA_STATUS_OK) {
+        ERROR("sa_svp_buffer_alloc failed");
+        return status;
+    }
+
+    status = push_free(pool, class_index, svp_buffer);
+    if (status != SA_STATUS_OK) {
+        ERROR("push_free failed");
+        sa_svp_buffer_free(svp_buffer);
+    }
+
+    return status;
+}
+
+sa_status sa_svp_buffer_pool_create(
+        sa_svp_buffer_pool** pool,
+        const sa_svp_buffer_pool_parameters* parameters) {
+
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (parameters == NULL) {
+        ERROR("NULL parameters");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (parameters->size_classes == NULL) {
+        ERROR("NULL size_classes");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (parameters->size_classes_length == 0) {
+        ERROR("Empty size_classes");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    for (size_t i = 0; i < parameters->size_classes_length; i++) {
+        if (parameters->size_classes[i] == 0 ||
+                (i > 0 && parameters->size_classes[i] <= parameters->size_classes[i - 1])) {
+            ERROR("Invalid size_classes");
+            return SA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    if (parameters->max_free < parameters->min_free) {
+        ERROR("Invalid max_free");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_svp_buffer_pool* new_pool = calloc(1, sizeof(sa_svp_buffer_pool));
+    if (new_pool == NULL) {
+        ERROR("calloc failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    if (mtx_init(&new_pool->mutex, mtx_plain) != thrd_success) {
+        ERROR("mtx_init failed");
+        free(new_pool);
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_status status = SA_STATUS_OK;
+    do {
+        new_pool->classes = calloc(parameters->size_classes_length, sizeof(size_class));
+        if (new_pool->classes == NULL) {
+            ERROR("calloc failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        new_pool->class_count = parameters->size_classes_length;
+        new_pool->min_free = parameters->min_free;
+        new_pool->max_free = parameters->max_free;
+        for (size_t i = 0; i < new_pool->class_count && status == SA_STATUS_OK; i++) {
+            new_pool->classes[i].size = parameters->size_classes[i];
+            for (size_t j = 0; j < new_pool->min_free && status == SA_STATUS_OK; j++)
+                status = create_free(new_pool, i);
+        }
+    } while (false);
+
+    if (status != SA_STATUS_OK) {
+        sa_svp_buffer_pool_destroy(new_pool);
+        return status;
+    }
+
+    *pool = new_pool;
+    return SA_STATUS_OK;
+}
+
+sa_status sa_svp_buffer_pool_acquire(
+        sa_buffer* buffer,
+        sa_svp_buffer_pool* pool,
+        size_t size) {
+
+    if (buffer == NULL) {
+        ERROR("NULL buffer");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    size_t class_index = 0;
+    while (class_index < pool->class_count && pool->classes[class_index].size < size)
+        class_index++;
+
+    if (class_index == pool->class_count) {
+        ERROR("Invalid size");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_status status = SA_STATUS_OK;
+    do {
+        if (!grow((void**) &pool->in_use, &pool->in_use_capacity, pool->in_use_count, sizeof(in_use_buffer))) {
+            ERROR("grow failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        size_class* buffer_class = &pool->classes[class_index];
+        if (buffer_class->free_count > 0) {
+            pool->stats.hits++;
+        } else {
+            status = create_free(pool, class_index);
+            if (status != SA_STATUS_OK) {
+                ERROR("create_free failed");
+                break;
+            }
+
+            pool->stats.misses++;
+        }
+
+        sa_svp_buffer svp_buffer = buffer_class->free_buffers[--buffer_class->free_count];
+        pool->stats.free_buffers--;
+        pool->in_use[pool->in_use_count].svp_buffer = svp_buffer;
+        pool->in_use[pool->in_use_count].class_index = class_index;
+        pool->in_use_count++;
+        pool->stats.in_use_buffers++;
+        pool->stats.acquires++;
+
+        buffer->buffer_type = SA_BUFFER_TYPE_SVP;
+        buffer->context.svp.buffer = svp_buffer;
+        buffer->context.svp.offset = 0;
+    } while (false);
+
+    mtx_unlock(&pool->mutex);
+    return status;
+}
+
+sa_status sa_svp_buffer_pool_release(
+        sa_svp_buffer_pool* pool,
+        sa_svp_buffer svp_buffer) {
+
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    sa_status status = SA_STATUS_OK;
+    do {
+        size_t i = 0;
+        while (i < pool->in_use_count && pool->in_use[i].svp_buffer != svp_buffer)
+            i++;
+
+        if (i == pool->in_use_count) {
+            ERROR("Unknown svp_buffer");
+            status = SA_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        size_t class_index = pool->in_use[i].class_index;
+        pool->in_use[i] = pool->in_use[--pool->in_use_count];
+        pool->stats.in_use_buffers--;
+        pool->stats.releases++;
+
+        status = push_free(pool, class_index, svp_buffer);
+        if (status != SA_STATUS_OK) {
+            ERROR("push_free failed");
+            sa_svp_buffer_free(svp_buffer);
+            break;
+        }
+
+        // Shrinking all the way down to min_free rather than to max_free keeps a burst of releases from freeing one
+        // buffer per release.
+        size_class* buffer_class = &pool->classes[class_index];
+        if (buffer_class->free_count > pool->max_free) {
+            while (buffer_class->free_count > pool->min_free) {
+                sa_svp_buffer_free(buffer_class->free_buffers[--buffer_class->free_count]);
+                pool->stats.free_buffers--;
+                pool->stats.shrinks++;
+            }
+        }
+    } while (false);
+
+    mtx_unlock(&pool->mutex);
+    return status;
+}
+
+sa_status sa_svp_buffer_pool_get_stats(
+        sa_svp_buffer_pool_stats* stats,
+        sa_svp_buffer_pool* pool) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    *stats = pool->stats;
+    mtx_unlock(&pool->mutex);
+    return SA_STATUS_OK;
+}
+
+sa_status sa_svp_buffer_pool_destroy(sa_svp_buffer_pool* pool) {
+    if (pool == NULL)
+        return SA_STATUS_OK;
+
+    for (size_t i = 0; i < pool->in_use_count; i++)
+        sa_svp_buffer_free(pool->in_use[i].svp_buffer);
+
+    if (pool->classes != NULL) {
+        for (size_t i = 0; i < pool->class_count; i++) {
+            for (size_t j = 0; j < pool->classes[i].free_count; j++)
+                sa_svp_buffer_free(pool->classes[i].free_buffers[j]);
+
+            free(pool->classes[i].free_buffers);
+        }
+    }
+
+    free(pool->classes);
+    free(pool->in_use);
+    mtx_destroy(&pool->mutex);
+    free(pool);
+    return SA_STATUS_OK;
+}
@@ -81,7 +81,7 @@ sa_status sa_svp_buffer_write(
         CREATE_PARAM(param2, offsets, param2_size);
 
         // clang-format off
-        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, param1_type, TA_PARAM_NULL, TA_PARAM_NULL};
+        ta_param_type param_types[NUM_TA_PARAMS] = {TA_PARAM_INOUT, param1_type, TA_PARAM_IN, TA_PARAM_NULL};
         ta_param params[NUM_TA_PARAMS] = {{svp_buffer_write, sizeof(sa_svp_buffer_write_s)},
                                           {param1, param1_size},
                                           {param2, param2_size},
@@ -0,0 +1,113 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Cost of reading the fields of a TypeJ key container payload with the DOM parser and with the field
+// extractor.
+
+#include "json.h"
+#include "porting/memory.h"
+#include "sa_types.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+    const std::string PAYLOAD =
+            R"({"contentKeyId":"f0e1d2c3-b4a5-9687-7869-5a4b3c2d1e0f",)"
+            R"("contentKeyRights":"AAAAAAAAAAAAAAAAAAAAAA==",)"
+            R"("contentKeyNotBefore":"1970-01-01T00:00:00Z",)"
+            R"("contentKeyNotOnOrAfter":"2038-01-19T03:14:07Z",)"
+            R"("contentKeyTransportAlgorithm":"aesCbcPkcs5",)"
+            R"("contentKeyTransportIv":"AAECAwQFBgcICQoLDA0ODw==",)"
+            R"("contentKey":"mM7TnGDZCk+8LqT3w1y4Jt6W2oAx8sUf0KdEhvPnHc4=",)"
+            R"("contentKeyLength":16,"contentKeyUsage":0,"contentKeyCacheable":true,)"
+            R"("contentKeyContainerVersion":3,)"
+            R"("entitledTaIds":["00000000-0000-0000-0000-000000000001","00000000-0000-0000-0000-000000000002"]})";
+
+    const char* const KEYS[] = {"contentKeyId", "contentKeyRights", "contentKeyNotBefore", "contentKeyNotOnOrAfter",
+            "contentKeyTransportAlgorithm", "contentKeyTransportIv", "contentKey", "contentKeyLength",
+            "contentKeyUsage", "contentKeyCacheable", "contentKeyContainerVersion", "entitledTaIds"};
+
+    json_field_t make_field(
+            const char* key,
+            json_field_type_e type,
+            json_slice_t* strings = nullptr,
+            size_t strings_capacity = 0) {
+
+        json_field_t field = {};
+        field.key = key;
+        field.type = type;
+        field.strings = strings;
+        field.strings_capacity = strings_capacity;
+        return field;
+    }
+
+    void BM_JsonParseBytes(benchmark::State& state) {
+        for (auto _ : state) {
+            json_value_t* value = json_parse_bytes(PAYLOAD.data(), PAYLOAD.size());
+            size_t fields_count = 0;
+            json_key_value_t* fields = json_value_as_map(&fields_count, value);
+            if (fields == nullptr) {
+                json_value_free(value);
+                state.SkipWithError("json_value_as_map failed");
+                break;
+            }
+
+            for (const char* key : KEYS)
+                benchmark::DoNotOptimize(json_key_value_find(key, fields, fields_count));
+
+            memory_internal_free(fields);
+            json_value_free(value);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * PAYLOAD.size()));
+    }
+
+    void BM_JsonExtractFields(benchmark::State& state) {
+        // The extractor writes into its input, so every iteration starts from a fresh copy.
+        std::string in = PAYLOAD;
+        json_slice_t entitled_ta_ids[MAX_NUM_ALLOWED_TA_IDS];
+        json_field_t fields[] = {
+                make_field("contentKeyId", JSON_FIELD_STRING),
+                make_field("contentKeyRights", JSON_FIELD_STRING),
+                make_field("contentKeyNotBefore", JSON_FIELD_STRING),
+                make_field("contentKeyNotOnOrAfter", JSON_FIELD_STRING),
+                make_field("contentKeyTransportAlgorithm", JSON_FIELD_STRING),
+                make_field("contentKeyTransportIv", JSON_FIELD_STRING),
+                make_field("contentKey", JSON_FIELD_STRING),
+                make_field("contentKeyLength", JSON_FIELD_INTEGER),
+                make_field("contentKeyUsage", JSON_FIELD_INTEGER),
+                make_field("contentKeyCacheable", JSON_FIELD_BOOL),
+                make_field("contentKeyContainerVersion", JSON_FIELD_INTEGER),
+                make_field("entitledTaIds", JSON_FIELD_STRING_ARRAY, entitled_ta_ids, MAX_NUM_ALLOWED_TA_IDS)};
+
+        for (auto _ : state) {
+            in.assign(PAYLOAD);
+            if (!json_extract_fields(fields, sizeof(fields) / sizeof(json_field_t), &in[0], in.size())) {
+                state.SkipWithError("json_extract_fields failed");
+                break;
+            }
+
+            benchmark::DoNotOptimize(fields);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * PAYLOAD.size()));
+    }
+} // namespace
+
+BENCHMARK(BM_JsonParseBytes);
+BENCHMARK(BM_JsonExtractFields);
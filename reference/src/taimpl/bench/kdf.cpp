@@ -0,0 +1,111 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Throughput of the KDF expand step for each supported KDF, from 32 bytes up to 4 KB of output.
+
+#include "common.h"
+#include "hmac_internal.h"
+#include "prf.h"
+#include "sa_types.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace {
+    std::vector<uint8_t> KEY(SYM_256_KEY_SIZE, 0x5a);
+    std::vector<uint8_t> INFO(AES_BLOCK_SIZE, 0xa5);
+
+    void run_expand(
+            benchmark::State& state,
+            prf_t* prf,
+            size_t counter_length,
+            bool counter_first,
+            bool feedback,
+            const std::vector<uint8_t>& in1,
+            const std::vector<uint8_t>& in2) {
+
+        std::shared_ptr<prf_t> guard(prf, prf_free);
+        if (prf == nullptr) {
+            state.SkipWithError("prf_create failed");
+            return;
+        }
+
+        std::vector<uint8_t> out(state.range(0));
+        for (auto _ : state) {
+            if (prf_expand(out.data(), out.size(), prf, 1, counter_length, counter_first, feedback, in1.data(),
+                        in1.size(), in2.data(), in2.size()) != SA_STATUS_OK) {
+                state.SkipWithError("prf_expand failed");
+                break;
+            }
+
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+    }
+
+    void BM_HkdfExpand(benchmark::State& state) {
+        run_expand(state, prf_create_hmac(SA_DIGEST_ALGORITHM_SHA256, KEY.data(), KEY.size()), 1, false, true, INFO,
+                {});
+    }
+
+    // Reference for BM_HkdfExpand: rekeys HMAC for every block the way kdf.c used to.
+    void BM_HkdfExpandUnkeyed(benchmark::State& state) {
+        std::vector<uint8_t> out(state.range(0));
+        uint8_t tag[32];
+        for (auto _ : state) {
+            size_t blocks = (out.size() + sizeof(tag) - 1) / sizeof(tag);
+            for (size_t i = 1; i <= blocks; i++) {
+                uint8_t counter = i;
+                size_t tag_length = sizeof(tag);
+                if (!hmac_internal(tag, &tag_length, SA_DIGEST_ALGORITHM_SHA256, tag, i == 1 ? 0 : sizeof(tag),
+                            INFO.data(), INFO.size(), &counter, 1, KEY.data(), KEY.size())) {
+                    state.SkipWithError("hmac_internal failed");
+                    return;
+                }
+
+                size_t offset = (i - 1) * sizeof(tag);
+                std::copy(tag, tag + std::min(sizeof(tag), out.size() - offset), out.begin() + offset);
+            }
+
+            benchmark::DoNotOptimize(out.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * out.size()));
+    }
+
+    void BM_ConcatKdf(benchmark::State& state) {
+        run_expand(state, prf_create_digest(SA_DIGEST_ALGORITHM_SHA256, nullptr, 0), 4, true, false, KEY, INFO);
+    }
+
+    void BM_AnsiX963Kdf(benchmark::State& state) {
+        run_expand(state, prf_create_digest(SA_DIGEST_ALGORITHM_SHA256, KEY.data(), KEY.size()), 4, true, false,
+                INFO, {});
+    }
+
+    void BM_CmacKdf(benchmark::State& state) {
+        run_expand(state, prf_create_cmac(KEY.data(), SYM_128_KEY_SIZE), 1, true, false, INFO, {});
+    }
+} // namespace
+
+BENCHMARK(BM_HkdfExpand)->RangeMultiplier(2)->Range(32, 4096);
+BENCHMARK(BM_HkdfExpandUnkeyed)->RangeMultiplier(2)->Range(32, 4096);
+BENCHMARK(BM_ConcatKdf)->RangeMultiplier(2)->Range(32, 4096);
+BENCHMARK(BM_AnsiX963Kdf)->RangeMultiplier(2)->Range(32, 4096);
+// A 1 byte counter limits CMAC output to PRF_MAX_BLOCKS * 16 bytes.
+BENCHMARK(BM_CmacKdf)->RangeMultiplier(2)->Range(32, 2048);
@@ -0,0 +1,199 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// Secure heap allocation rate against the previous malloc and byte wise clear path, OpenSSL operations
+// that allocate heavily through the TA allocator, each implementation of the constant time memory
+// primitives, and the streaming copy against memcpy.
+
+#include "porting/init.h"
+#include "porting/memory.h"
+#include "porting/memory_internal.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <vector>
+
+namespace {
+    // Route OpenSSL through the TA allocator before any OpenSSL allocation is made, as ta_sa_init does.
+    const bool OPENSSL_ALLOCATOR_INITED = [] {
+        init_openssl_allocator();
+        return true;
+    }();
+
+    void BM_SecureAllocFree(benchmark::State& state) {
+        size_t size = state.range(0);
+        for (auto _ : state) {
+            void* buffer = memory_secure_alloc(size);
+            benchmark::DoNotOptimize(buffer);
+            memory_secure_free(buffer);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    // Reference for BM_SecureAllocFree: the allocation path OpenSSL used before the secure heap.
+    void BM_MallocClearFree(benchmark::State& state) {
+        size_t size = state.range(0);
+        for (auto _ : state) {
+            void* buffer = malloc(size);
+            memory_memset_unoptimizable(buffer, 0, size);
+            benchmark::DoNotOptimize(buffer);
+            free(buffer);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    std::shared_ptr<EVP_PKEY> generate_key(
+            int id,
+            int parameter) {
+
+        std::shared_ptr<EVP_PKEY_CTX> ctx(EVP_PKEY_CTX_new_id(id, nullptr), EVP_PKEY_CTX_free);
+        if (ctx == nullptr || EVP_PKEY_keygen_init(ctx.get()) != 1)
+            return nullptr;
+
+        if (id == EVP_PKEY_RSA && EVP_PKEY_CTX_set_rsa_keygen_bits(ctx.get(), parameter) != 1)
+            return nullptr;
+
+        if (id == EVP_PKEY_EC && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), parameter) != 1)
+            return nullptr;
+
+        EVP_PKEY* key = nullptr;
+        if (EVP_PKEY_keygen(ctx.get(), &key) != 1)
+            return nullptr;
+
+        return {key, EVP_PKEY_free};
+    }
+
+    void BM_RsaSign(benchmark::State& state) {
+        auto key = generate_key(EVP_PKEY_RSA, 2048);
+        if (key == nullptr) {
+            state.SkipWithError("generate_key failed");
+            return;
+        }
+
+        std::vector<uint8_t> in(32, 0x5a);
+        std::vector<uint8_t> signature(EVP_PKEY_size(key.get()));
+        for (auto _ : state) {
+            std::shared_ptr<EVP_MD_CTX> ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+            size_t signature_length = signature.size();
+            if (ctx == nullptr || EVP_DigestSignInit(ctx.get(), nullptr, EVP_sha256(), nullptr, key.get()) != 1 ||
+                    EVP_DigestSign(ctx.get(), signature.data(), &signature_length, in.data(), in.size()) != 1) {
+                state.SkipWithError("EVP_DigestSign failed");
+                break;
+            }
+        }
+    }
+
+    void BM_Ecdh(benchmark::State& state) {
+        auto key = generate_key(EVP_PKEY_EC, NID_X9_62_prime256v1);
+        auto peer = generate_key(EVP_PKEY_EC, NID_X9_62_prime256v1);
+        if (key == nullptr || peer == nullptr) {
+            state.SkipWithError("generate_key failed");
+            return;
+        }
+
+        std::vector<uint8_t> shared_secret(32);
+        for (auto _ : state) {
+            std::shared_ptr<EVP_PKEY_CTX> ctx(EVP_PKEY_CTX_new(key.get(), nullptr), EVP_PKEY_CTX_free);
+            size_t shared_secret_length = shared_secret.size();
+            if (ctx == nullptr || EVP_PKEY_derive_init(ctx.get()) != 1 ||
+                    EVP_PKEY_derive_set_peer(ctx.get(), peer.get()) != 1 ||
+                    EVP_PKEY_derive(ctx.get(), shared_secret.data(), &shared_secret_length) != 1) {
+                state.SkipWithError("EVP_PKEY_derive failed");
+                break;
+            }
+        }
+    }
+    void run_primitive(
+            benchmark::State& state,
+            bool compare) {
+
+        auto implementation = static_cast<memory_implementation_e>(state.range(0));
+        memory_implementation_e previous = memory_get_implementation();
+        if (!memory_set_implementation(implementation)) {
+            state.SkipWithError("Implementation not supported on this CPU");
+            return;
+        }
+
+        std::vector<uint8_t> a(state.range(1), 0x5a);
+        std::vector<uint8_t> b(a);
+        for (auto _ : state) {
+            if (compare)
+                benchmark::DoNotOptimize(memory_memcmp_constant(a.data(), b.data(), a.size()));
+            else
+                memory_memset_unoptimizable(a.data(), 0, a.size());
+        }
+
+        memory_set_implementation(previous);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * a.size()));
+    }
+
+    void BM_MemcmpConstant(benchmark::State& state) {
+        run_primitive(state, true);
+    }
+
+    void BM_MemsetUnoptimizable(benchmark::State& state) {
+        run_primitive(state, false);
+    }
+
+    void primitive_arguments(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgNames({"implementation", "size"});
+        for (int implementation = 0; implementation < MEMORY_IMPLEMENTATION_COUNT; implementation++) {
+            if (!memory_implementation_supported(static_cast<memory_implementation_e>(implementation)))
+                continue;
+
+            for (int64_t size = 16; size <= 1024 * 1024; size *= 16)
+                benchmark->Args({implementation, size});
+        }
+    }
+
+    // Mode 0 copies with memcpy, mode 1 with memory_memcpy_streaming. Buffers larger than the last level cache
+    // are where non-temporal stores pay off.
+    void BM_MemcpyStreaming(benchmark::State& state) {
+        size_t size = state.range(0);
+        bool streaming = state.range(1) != 0;
+        std::vector<uint8_t> source(size, 0x5a);
+        std::vector<uint8_t> destination(size);
+        for (auto _ : state) {
+            if (streaming)
+                memory_memcpy_streaming(destination.data(), source.data(), size);
+            else
+                memcpy(destination.data(), source.data(), size);
+
+            benchmark::ClobberMemory();
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    }
+} // namespace
+
+BENCHMARK(BM_SecureAllocFree)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_MallocClearFree)->RangeMultiplier(4)->Range(16, 4096);
+BENCHMARK(BM_RsaSign);
+BENCHMARK(BM_Ecdh);
+BENCHMARK(BM_MemcmpConstant)->Apply(primitive_arguments);
+BENCHMARK(BM_MemsetUnoptimizable)->Apply(primitive_arguments);
+BENCHMARK(BM_MemcpyStreaming)
+        ->ArgNames({"size", "streaming"})
+        ->ArgsProduct({{64 << 10, 1 << 20, 16 << 20, 64 << 20}, {0, 1}});
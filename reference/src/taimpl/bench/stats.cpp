@@ -0,0 +1,104 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// Cost of recording a command in the TA statistics against the command it is recording, a 1 KB
+// SA_CRYPTO_CIPHER_PROCESS command invoked through ta_invoke_command_handler, which records it.
+
+#include "stats.h" // NOLINT
+#include "common.h"
+#include "sa_rights.h"
+#include "ta.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+    void BM_StatsRecord(benchmark::State& state) {
+        for (auto _ : state) {
+            stats_call_t call = stats_begin(SA_CRYPTO_CIPHER_PROCESS);
+            stats_record(call, SA_STATUS_OK, 2048);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    }
+
+    void BM_CipherProcess(benchmark::State& state) {
+        void* session = nullptr;
+        if (ta_open_session_handler(&session) != SA_STATUS_OK) {
+            state.SkipWithError("ta_open_session_handler failed");
+            return;
+        }
+
+        sa_key_generate_s key_generate = {API_VERSION, INVALID_HANDLE, {}, SA_KEY_TYPE_SYMMETRIC, SYM_128_KEY_SIZE};
+        sa_rights_set_allow_all(&key_generate.rights);
+        ta_param key_params[NUM_TA_PARAMS] = {{&key_generate, sizeof(key_generate)}, {}, {}, {}};
+        sa_crypto_cipher_init_s cipher_init = {API_VERSION, INVALID_HANDLE, SA_CIPHER_ALGORITHM_AES_ECB,
+                SA_CIPHER_MODE_ENCRYPT, INVALID_HANDLE};
+        ta_param init_params[NUM_TA_PARAMS] = {{&cipher_init, sizeof(cipher_init)}, {}, {}, {}};
+        if (ta_invoke_command_handler(session, SA_KEY_GENERATE, key_params) != SA_STATUS_OK) {
+            state.SkipWithError("key setup failed");
+            ta_close_session_handler(session);
+            return;
+        }
+
+        cipher_init.key = key_generate.key;
+        sa_key_release_s key_release = {API_VERSION, key_generate.key};
+        ta_param release_params[NUM_TA_PARAMS] = {{&key_release, sizeof(key_release)}, {}, {}, {}};
+        if (ta_invoke_command_handler(session, SA_CRYPTO_CIPHER_INIT, init_params) != SA_STATUS_OK) {
+            state.SkipWithError("cipher setup failed");
+            ta_invoke_command_handler(session, SA_KEY_RELEASE, release_params);
+            ta_close_session_handler(session);
+            return;
+        }
+
+        size_t size = state.range(0);
+        std::vector<uint8_t> in_data(size);
+        std::vector<uint8_t> out_data(size);
+        sa_crypto_cipher_process_s cipher_process = {};
+        cipher_process.api_version = API_VERSION;
+        cipher_process.context = cipher_init.context;
+        cipher_process.out_buffer_type = SA_BUFFER_TYPE_CLEAR;
+        cipher_process.in_buffer_type = SA_BUFFER_TYPE_CLEAR;
+        ta_param params[NUM_TA_PARAMS] = {
+                {&cipher_process, sizeof(cipher_process)},
+                {out_data.data(), out_data.size()},
+                {in_data.data(), in_data.size()},
+                {}};
+        for (auto _ : state) {
+            cipher_process.out_offset = 0;
+            cipher_process.in_offset = 0;
+            cipher_process.bytes_to_process = size;
+            if (ta_invoke_command_handler(session, SA_CRYPTO_CIPHER_PROCESS, params) != SA_STATUS_OK) {
+                state.SkipWithError("SA_CRYPTO_CIPHER_PROCESS failed");
+                break;
+            }
+
+            benchmark::DoNotOptimize(out_data.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+        sa_crypto_cipher_release_s cipher_release = {API_VERSION, cipher_init.context};
+        ta_param cipher_release_params[NUM_TA_PARAMS] = {{&cipher_release, sizeof(cipher_release)}, {}, {}, {}};
+        ta_invoke_command_handler(session, SA_CRYPTO_CIPHER_RELEASE, cipher_release_params);
+        ta_invoke_command_handler(session, SA_KEY_RELEASE, release_params);
+        ta_close_session_handler(session);
+    }
+} // namespace
+
+BENCHMARK(BM_StatsRecord);
+BENCHMARK(BM_CipherProcess)->Arg(1024);
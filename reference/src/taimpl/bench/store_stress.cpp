@@ -0,0 +1,536 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Concurrency stress test of the client, key, cipher, and SVP stores.
+//
+// N threads share M sessions, each holding K keys, cipher contexts, and SVP buffers. Every thread runs a mixed
+// workload against random contexts: processing, lookups, replacing contexts (which releases them while other threads
+// may still be processing them), and opening and closing private sessions. Reports throughput and tail latency per
+// operation and lock wait time per store. Exits with an error if a release fails, if an unexpected status is
+// returned, or if the stores log a leaked slot or a reference count error, including on slots_shutdown.
+//
+// Usage: taimplstress [-t threads] [-s sessions] [-c contexts] [-d seconds] [-b bytes]
+
+#include "cipher_store.h"
+#include "client_store.h"
+#include "log.h"
+#include "sa_rights.h"
+#include "ta_sa.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    const sa_uuid UUID = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+    enum operation {
+        OP_CIPHER_PROCESS = 0,
+        OP_KEY_HEADER,
+        OP_SVP_WRITE,
+        OP_CIPHER_REPLACE,
+        OP_KEY_REPLACE,
+        OP_SVP_REPLACE,
+        OP_SESSION_CHURN,
+        OP_COUNT
+    };
+
+    const char* const OPERATION_NAMES[OP_COUNT] = {
+            "cipher_process",
+            "key_header",
+            "svp_write",
+            "cipher_replace",
+            "key_replace",
+            "svp_replace",
+            "session_churn"};
+
+    // Relative frequency of every operation.
+    const int OPERATION_WEIGHTS[OP_COUNT] = {40, 15, 15, 10, 10, 5, 5};
+
+    struct options {
+        size_t threads = 8;
+        size_t sessions = 4;
+        size_t contexts = 16;
+        double seconds = 5.0;
+        size_t bytes = 1024;
+        bool svp = true;
+    };
+
+    struct session {
+        ta_client client = INVALID_HANDLE;
+        std::vector<std::atomic<sa_key>> keys;
+        std::vector<std::atomic<sa_crypto_cipher_context>> ciphers;
+        std::vector<std::atomic<sa_svp_buffer>> svp_buffers;
+
+        explicit session(size_t contexts) :
+            keys(contexts), ciphers(contexts), svp_buffers(contexts) {
+            for (size_t i = 0; i < contexts; ++i) {
+                keys[i] = INVALID_HANDLE;
+                ciphers[i] = INVALID_HANDLE;
+                svp_buffers[i] = INVALID_HANDLE;
+            }
+        }
+    };
+
+    struct thread_result {
+        std::vector<uint64_t> latencies[OP_COUNT];
+        // Handles released by another thread between load and use.
+        uint64_t stale[OP_COUNT] = {};
+        uint64_t errors[OP_COUNT] = {};
+    };
+
+    // Store diagnostics counted from the log.
+    std::atomic<uint64_t> leaked_count{0};
+    std::atomic<uint64_t> reference_error_count{0};
+
+    void log_sink(
+            log_level_e level,
+            const char* line,
+            void* context) {
+
+        if (strstr(line, "still allocated on slots_shutdown") != nullptr ||
+                strstr(line, "on shutdown") != nullptr) {
+            leaked_count++;
+            fprintf(stderr, "%s\n", line);
+        } else if (strstr(line, "ref_count is already at 0") != nullptr ||
+                   strstr(line, "does not match the store entry") != nullptr ||
+                   strstr(line, "Attempting to release a slot") != nullptr) {
+            reference_error_count++;
+            fprintf(stderr, "%s\n", line);
+        }
+    }
+
+    sa_status key_create(
+            sa_key* key,
+            ta_client client) {
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        sa_import_parameters_symmetric parameters = {&rights};
+        uint8_t clear_key[16] = {};
+        return ta_sa_key_import(key, SA_KEY_FORMAT_SYMMETRIC_BYTES, clear_key, sizeof(clear_key), &parameters, client,
+                &UUID);
+    }
+
+    sa_status svp_buffer_create(
+            sa_svp_buffer* svp_buffer,
+            size_t size,
+            ta_client client) {
+
+        void* memory = malloc(size);
+        if (memory == nullptr)
+            return SA_STATUS_INTERNAL_ERROR;
+
+        sa_status status = ta_sa_svp_buffer_create(svp_buffer, memory, size, client, &UUID);
+        if (status != SA_STATUS_OK)
+            free(memory);
+
+        return status;
+    }
+
+    sa_status svp_buffer_release(
+            sa_svp_buffer svp_buffer,
+            ta_client client) {
+
+        void* memory = nullptr;
+        size_t memory_length = 0;
+        sa_status status = ta_sa_svp_buffer_release(&memory, &memory_length, svp_buffer, client, &UUID);
+        free(memory);
+        return status;
+    }
+
+    // Runs one operation. Returns SA_STATUS_INVALID_PARAMETER if the context was released by another thread. An SVP
+    // buffer that is being released has no memory attached until it is removed from the store, so writes to it return
+    // SA_STATUS_INVALID_SVP_BUFFER.
+    sa_status run_operation(
+            operation op,
+            session& session,
+            size_t index,
+            const options& options,
+            std::vector<uint8_t>& in_data,
+            std::vector<uint8_t>& out_data) {
+
+        ta_client client = session.client;
+        switch (op) {
+            case OP_CIPHER_PROCESS: {
+                sa_crypto_cipher_context cipher = session.ciphers[index].load();
+                if (cipher == INVALID_HANDLE)
+                    return SA_STATUS_INVALID_PARAMETER;
+
+                sa_buffer in = {};
+                in.buffer_type = SA_BUFFER_TYPE_CLEAR;
+                in.context.clear.buffer = in_data.data();
+                in.context.clear.length = in_data.size();
+                sa_buffer out = {};
+                out.buffer_type = SA_BUFFER_TYPE_CLEAR;
+                out.context.clear.buffer = out_data.data();
+                out.context.clear.length = out_data.size();
+                size_t bytes_to_process = in_data.size();
+                return ta_sa_crypto_cipher_process(&out, cipher, &in, &bytes_to_process, client, &UUID);
+            }
+
+            case OP_KEY_HEADER: {
+                sa_key key = session.keys[index].load();
+                if (key == INVALID_HANDLE)
+                    return SA_STATUS_INVALID_PARAMETER;
+
+                sa_header header;
+                return ta_sa_key_header(&header, key, client, &UUID);
+            }
+
+            case OP_SVP_WRITE: {
+                sa_svp_buffer svp_buffer = session.svp_buffers[index].load();
+                if (svp_buffer == INVALID_HANDLE)
+                    return SA_STATUS_INVALID_PARAMETER;
+
+                sa_svp_offset offset = {0, 0, in_data.size()};
+                return ta_sa_svp_buffer_write(svp_buffer, in_data.data(), in_data.size(), &offset, 1, client,
+                        &UUID);
+            }
+
+            case OP_CIPHER_REPLACE: {
+                // Other threads may still be processing the old context while it is released.
+                sa_crypto_cipher_context cipher = session.ciphers[index].exchange(INVALID_HANDLE);
+                if (cipher != INVALID_HANDLE && ta_sa_crypto_cipher_release(cipher, client, &UUID) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                sa_key key = session.keys[index].load();
+                if (key == INVALID_HANDLE)
+                    return SA_STATUS_INVALID_PARAMETER;
+
+                sa_status status = ta_sa_crypto_cipher_init(&cipher, SA_CIPHER_ALGORITHM_AES_ECB,
+                        SA_CIPHER_MODE_ENCRYPT, key, nullptr, client, &UUID);
+                if (status != SA_STATUS_OK)
+                    return status;
+
+                // Another replace may have raced this one; keep the context that got there first.
+                sa_crypto_cipher_context expected = INVALID_HANDLE;
+                if (!session.ciphers[index].compare_exchange_strong(expected, cipher) &&
+                        ta_sa_crypto_cipher_release(cipher, client, &UUID) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                return SA_STATUS_OK;
+            }
+
+            case OP_KEY_REPLACE: {
+                sa_key key = session.keys[index].exchange(INVALID_HANDLE);
+                if (key != INVALID_HANDLE && ta_sa_key_release(key, client, &UUID) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                sa_status status = key_create(&key, client);
+                if (status != SA_STATUS_OK)
+                    return status;
+
+                sa_key expected = INVALID_HANDLE;
+                if (!session.keys[index].compare_exchange_strong(expected, key) &&
+                        ta_sa_key_release(key, client, &UUID) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                return SA_STATUS_OK;
+            }
+
+            case OP_SVP_REPLACE: {
+                sa_svp_buffer svp_buffer = session.svp_buffers[index].exchange(INVALID_HANDLE);
+                if (svp_buffer != INVALID_HANDLE && svp_buffer_release(svp_buffer, client) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                sa_status status = svp_buffer_create(&svp_buffer, options.bytes, client);
+                if (status != SA_STATUS_OK)
+                    return status;
+
+                sa_svp_buffer expected = INVALID_HANDLE;
+                if (!session.svp_buffers[index].compare_exchange_strong(expected, svp_buffer) &&
+                        svp_buffer_release(svp_buffer, client) != SA_STATUS_OK)
+                    return SA_STATUS_INTERNAL_ERROR;
+
+                return SA_STATUS_OK;
+            }
+
+            default: {
+                ta_client private_client = INVALID_HANDLE;
+                sa_status status = ta_sa_init(&private_client, &UUID);
+                if (status != SA_STATUS_OK)
+                    return status;
+
+                sa_key key = INVALID_HANDLE;
+                status = key_create(&key, private_client);
+                if (status == SA_STATUS_OK)
+                    status = ta_sa_key_release(key, private_client, &UUID);
+
+                sa_status close_status = ta_sa_close(private_client, &UUID);
+                return status == SA_STATUS_OK ? close_status : status;
+            }
+        }
+    }
+
+    void worker(
+            size_t thread_index,
+            std::vector<std::unique_ptr<session>>& sessions,
+            const options& options,
+            std::chrono::steady_clock::time_point deadline,
+            thread_result& result) {
+
+        std::vector<int> weights(std::begin(OPERATION_WEIGHTS), std::end(OPERATION_WEIGHTS));
+        if (!options.svp) {
+            weights[OP_SVP_WRITE] = 0;
+            weights[OP_SVP_REPLACE] = 0;
+        }
+
+        std::mt19937_64 random(thread_index + 1);
+        std::discrete_distribution<int> operation_distribution(weights.begin(), weights.end());
+        std::vector<uint8_t> in_data(options.bytes, static_cast<uint8_t>(thread_index));
+        std::vector<uint8_t> out_data(options.bytes);
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto op = static_cast<operation>(operation_distribution(random));
+            session& session = *sessions[random() % sessions.size()];
+            size_t index = random() % options.contexts;
+
+            auto start = std::chrono::steady_clock::now();
+            sa_status status = run_operation(op, session, index, options, in_data, out_data);
+            auto end = std::chrono::steady_clock::now();
+            if (status == SA_STATUS_INVALID_PARAMETER ||
+                    (op == OP_SVP_WRITE && status == SA_STATUS_INVALID_SVP_BUFFER)) {
+                result.stale[op]++;
+                continue;
+            }
+
+            if (status != SA_STATUS_OK) {
+                if (result.errors[op]++ == 0)
+                    fprintf(stderr, "%s returned %d\n", OPERATION_NAMES[op], status);
+
+                continue;
+            }
+
+            result.latencies[op].push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+
+    double percentile(
+            const std::vector<uint64_t>& sorted,
+            double p) {
+
+        if (sorted.empty())
+            return 0.0;
+
+        auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+        return static_cast<double>(sorted[index]) / 1000.0;
+    }
+
+    void add_lock_stats(
+            object_store_lock_stats_t& total,
+            const object_store_lock_stats_t& stats) {
+
+        total.lock_count += stats.lock_count;
+        total.contended_count += stats.contended_count;
+        total.wait_ns += stats.wait_ns;
+        total.max_wait_ns = std::max(total.max_wait_ns, stats.max_wait_ns);
+    }
+
+    void print_lock_stats(
+            const char* name,
+            const object_store_lock_stats_t& stats) {
+
+        printf("%-14s %12" PRIu64 " %9.2f%% %12.3f %12.1f\n", name, stats.lock_count,
+                stats.lock_count == 0 ? 0.0 : 100.0 * stats.contended_count / stats.lock_count,
+                stats.wait_ns / 1e6, stats.max_wait_ns / 1e3);
+    }
+
+    bool parse_options(
+            int argc,
+            char** argv,
+            options& options) {
+
+        int opt;
+        while ((opt = getopt(argc, argv, "t:s:c:d:b:")) != -1) {
+            switch (opt) {
+                case 't':
+                    options.threads = strtoul(optarg, nullptr, 10);
+                    break;
+
+                case 's':
+                    options.sessions = strtoul(optarg, nullptr, 10);
+                    break;
+
+                case 'c':
+                    options.contexts = strtoul(optarg, nullptr, 10);
+                    break;
+
+                case 'd':
+                    options.seconds = strtod(optarg, nullptr);
+                    break;
+
+                case 'b':
+                    options.bytes = strtoul(optarg, nullptr, 10);
+                    break;
+
+                default:
+                    return false;
+            }
+        }
+
+        // AES-ECB processes whole blocks.
+        return options.threads > 0 && options.sessions > 0 && options.contexts > 0 && options.bytes > 0 &&
+               options.bytes % 16 == 0;
+    }
+} // namespace
+
+int main(
+        int argc,
+        char** argv) {
+
+    options options;
+    if (!parse_options(argc, argv, options)) {
+        fprintf(stderr, "Usage: %s [-t threads] [-s sessions] [-c contexts] [-d seconds] [-b bytes]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    log_set_sink_callback(log_sink, nullptr);
+
+    int exit_code = EXIT_SUCCESS;
+    std::vector<std::unique_ptr<session>> sessions;
+    for (size_t i = 0; i < options.sessions; ++i) {
+        std::unique_ptr<session> new_session(new session(options.contexts));
+        if (ta_sa_init(&new_session->client, &UUID) != SA_STATUS_OK) {
+            fprintf(stderr, "ta_sa_init failed\n");
+            return EXIT_FAILURE;
+        }
+
+        options.svp = ta_sa_svp_supported(new_session->client, &UUID) == SA_STATUS_OK;
+        for (size_t j = 0; j < options.contexts; ++j) {
+            std::vector<uint8_t> unused;
+            sa_status status = SA_STATUS_OK;
+            for (auto op : {OP_KEY_REPLACE, OP_CIPHER_REPLACE, OP_SVP_REPLACE}) {
+                if (status == SA_STATUS_OK && (op != OP_SVP_REPLACE || options.svp))
+                    status = run_operation(op, *new_session, j, options, unused, unused);
+            }
+
+            if (status != SA_STATUS_OK) {
+                fprintf(stderr, "context setup failed: %d\n", status);
+                return EXIT_FAILURE;
+            }
+        }
+
+        sessions.push_back(std::move(new_session));
+    }
+
+    printf("threads %zu, sessions %zu, contexts %zu, %zu bytes, %.1f s\n", options.threads, options.sessions,
+            options.contexts, options.bytes, options.seconds);
+
+    std::vector<thread_result> results(options.threads);
+    std::vector<std::thread> threads;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(options.seconds));
+    for (size_t i = 0; i < options.threads; ++i)
+        threads.emplace_back(worker, i, std::ref(sessions), std::cref(options), deadline, std::ref(results[i]));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    printf("\n%-14s %12s %12s %10s %10s %10s %10s %8s %6s\n", "operation", "ops", "ops/s", "p50 us", "p99 us",
+            "p99.9 us", "max us", "stale", "errors");
+    for (int op = 0; op < OP_COUNT; ++op) {
+        std::vector<uint64_t> latencies;
+        uint64_t stale = 0;
+        uint64_t errors = 0;
+        for (auto& result : results) {
+            latencies.insert(latencies.end(), result.latencies[op].begin(), result.latencies[op].end());
+            stale += result.stale[op];
+            errors += result.errors[op];
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        printf("%-14s %12zu %12.0f %10.1f %10.1f %10.1f %10.1f %8" PRIu64 " %6" PRIu64 "\n", OPERATION_NAMES[op],
+                latencies.size(), static_cast<double>(latencies.size()) / options.seconds,
+                percentile(latencies, 0.5), percentile(latencies, 0.99), percentile(latencies, 0.999),
+                percentile(latencies, 1.0), stale, errors);
+        if (errors != 0)
+            exit_code = EXIT_FAILURE;
+    }
+
+    object_store_lock_stats_t client_stats = {};
+    object_store_lock_stats_t key_stats = {};
+    object_store_lock_stats_t cipher_stats = {};
+    object_store_lock_stats_t svp_stats = {};
+    object_store_get_lock_stats(&client_stats, client_store_global());
+    for (auto& session : sessions) {
+        client_t* client = nullptr;
+        if (client_store_acquire(&client, client_store_global(), session->client, &UUID) != SA_STATUS_OK)
+            continue;
+
+        object_store_lock_stats_t stats;
+        if (object_store_get_lock_stats(&stats, client_get_key_store(client)) == SA_STATUS_OK)
+            add_lock_stats(key_stats, stats);
+
+        if (cipher_store_get_lock_stats(&stats, client_get_cipher_store(client)) == SA_STATUS_OK)
+            add_lock_stats(cipher_stats, stats);
+
+        if (object_store_get_lock_stats(&stats, client_get_svp_store(client)) == SA_STATUS_OK)
+            add_lock_stats(svp_stats, stats);
+
+        client_store_release(client_store_global(), session->client, client, &UUID);
+    }
+
+    printf("\n%-14s %12s %10s %12s %12s\n", "store", "locks", "contended", "wait ms", "max wait us");
+    print_lock_stats("client_store", client_stats);
+    print_lock_stats("key_store", key_stats);
+    print_lock_stats("cipher_store", cipher_stats);
+    print_lock_stats("svp_store", svp_stats);
+
+    // Release everything so that any object left behind by a store is reported when the sessions are closed.
+    for (auto& session : sessions) {
+        for (size_t i = 0; i < options.contexts; ++i) {
+            sa_crypto_cipher_context cipher = session->ciphers[i].exchange(INVALID_HANDLE);
+            sa_key key = session->keys[i].exchange(INVALID_HANDLE);
+            sa_svp_buffer svp_buffer = session->svp_buffers[i].exchange(INVALID_HANDLE);
+            if ((cipher != INVALID_HANDLE && ta_sa_crypto_cipher_release(cipher, session->client, &UUID) !=
+                                                     SA_STATUS_OK) ||
+                    (key != INVALID_HANDLE && ta_sa_key_release(key, session->client, &UUID) != SA_STATUS_OK) ||
+                    (svp_buffer != INVALID_HANDLE && svp_buffer_release(svp_buffer, session->client) !=
+                                                             SA_STATUS_OK)) {
+                fprintf(stderr, "release failed\n");
+                exit_code = EXIT_FAILURE;
+            }
+        }
+
+        if (ta_sa_close(session->client, &UUID) != SA_STATUS_OK) {
+            fprintf(stderr, "ta_sa_close failed\n");
+            exit_code = EXIT_FAILURE;
+        }
+    }
+
+    log_flush();
+    printf("\nleaked objects %" PRIu64 ", reference count errors %" PRIu64 "\n", leaked_count.load(),
+            reference_error_count.load());
+    if (leaked_count != 0 || reference_error_count != 0)
+        exit_code = EXIT_FAILURE;
+
+    log_set_sink_stderr();
+    return exit_code;
+}
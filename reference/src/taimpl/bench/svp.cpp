@@ -0,0 +1,133 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Per-frame cost of verifying a decoded NV12 frame in an SVP buffer against reference digests. Compares one digest
+// over the whole frame, one ta_sa_svp_buffer_check call per 16 line slice, and one ta_sa_svp_buffer_check_ranges call
+// covering all slices.
+
+#include "common.h"
+#include "digest.h"
+#include "ta_sa.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const sa_uuid UUID = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+    enum check_mode {
+        CHECK_FRAME = 0,
+        CHECK_SLICES,
+        CHECK_RANGES
+    };
+
+    const size_t SLICE_LINES = 16;
+
+    // Luma and chroma planes of an NV12 frame split into slices of SLICE_LINES luma lines.
+    std::vector<sa_svp_range> frame_slices(
+            size_t width,
+            size_t height) {
+
+        std::vector<sa_svp_range> ranges;
+        size_t luma_size = width * height;
+        for (size_t line = 0; line < height; line += SLICE_LINES) {
+            size_t lines = std::min(SLICE_LINES, height - line);
+            ranges.push_back({line * width, lines * width});
+            ranges.push_back({luma_size + line / 2 * width, (lines + 1) / 2 * width});
+        }
+
+        return ranges;
+    }
+
+    void BM_SvpFrameCheck(benchmark::State& state) {
+        ta_client client = INVALID_HANDLE;
+        if (ta_sa_init(&client, &UUID) != SA_STATUS_OK) {
+            state.SkipWithError("ta_sa_init failed");
+            return;
+        }
+
+        auto width = static_cast<size_t>(state.range(0));
+        auto height = static_cast<size_t>(state.range(1));
+        auto mode = static_cast<check_mode>(state.range(2));
+        size_t frame_size = width * height * 3 / 2;
+        std::vector<sa_svp_range> ranges = mode == CHECK_FRAME ? std::vector<sa_svp_range>{{0, frame_size}} :
+                                                                 frame_slices(width, height);
+
+        // The reference SVP implementation uses ordinary memory, as the taimpl tests do.
+        void* svp_memory = malloc(frame_size);
+        sa_svp_buffer svp_buffer = INVALID_HANDLE;
+        std::vector<uint8_t> frame(frame_size, 0x5a);
+        sa_svp_offset offset = {0, 0, frame_size};
+        if (svp_memory == nullptr ||
+                ta_sa_svp_buffer_create(&svp_buffer, svp_memory, frame_size, client, &UUID) != SA_STATUS_OK ||
+                ta_sa_svp_buffer_write(svp_buffer, frame.data(), frame.size(), &offset, 1, client, &UUID) !=
+                        SA_STATUS_OK) {
+            state.SkipWithError("SVP buffer setup failed");
+            free(svp_memory);
+            ta_sa_close(client, &UUID);
+            return;
+        }
+
+        std::vector<uint8_t> hashes;
+        for (const auto& range : ranges) {
+            uint8_t hash[SHA256_DIGEST_LENGTH];
+            size_t hash_length = sizeof(hash);
+            digest_sha(hash, &hash_length, SA_DIGEST_ALGORITHM_SHA256, frame.data() + range.offset, range.length,
+                    nullptr, 0, nullptr, 0);
+            hashes.insert(hashes.end(), hash, hash + hash_length);
+        }
+
+        for (auto _ : state) {
+            sa_status status = SA_STATUS_OK;
+            if (mode == CHECK_RANGES) {
+                status = ta_sa_svp_buffer_check_ranges(svp_buffer, ranges.data(), ranges.size(),
+                        SA_DIGEST_ALGORITHM_SHA256, hashes.data(), hashes.size(), client, &UUID);
+            } else {
+                for (size_t i = 0; i < ranges.size() && status == SA_STATUS_OK; i++) {
+                    status = ta_sa_svp_buffer_check(svp_buffer, ranges[i].offset, ranges[i].length,
+                            SA_DIGEST_ALGORITHM_SHA256, hashes.data() + i * SHA256_DIGEST_LENGTH,
+                            SHA256_DIGEST_LENGTH, client, &UUID);
+                }
+            }
+
+            if (status != SA_STATUS_OK) {
+                state.SkipWithError("check failed");
+                break;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame_size));
+        state.counters["ranges"] = static_cast<double>(ranges.size());
+
+        void* released_memory = nullptr;
+        size_t released_memory_size = 0;
+        ta_sa_svp_buffer_release(&released_memory, &released_memory_size, svp_buffer, client, &UUID);
+        free(released_memory);
+        ta_sa_close(client, &UUID);
+    }
+} // namespace
+
+BENCHMARK(BM_SvpFrameCheck)
+        ->ArgNames({"width", "height", "mode"})
+        ->ArgsProduct({{1920}, {1080}, {CHECK_FRAME, CHECK_SLICES, CHECK_RANGES}})
+        ->ArgsProduct({{3840}, {2160}, {CHECK_FRAME, CHECK_SLICES, CHECK_RANGES}})
+        ->Unit(benchmark::kMicrosecond);
@@ -28,7 +28,9 @@
 #ifndef CIPHER_STORE_H
 #define CIPHER_STORE_H
 
+#include "object_pool.h"
 #include "object_store.h"
+#include "rights.h"
 #include "sa_types.h"
 #include "symmetric.h"
 
@@ -38,7 +40,7 @@ extern "C" {
 
 typedef struct cipher_s cipher_t;
 
-typedef object_store_t cipher_store_t;
+typedef struct cipher_store_s cipher_store_t;
 
 /**
  * Get the cipher algorithm.
@@ -88,6 +90,15 @@ size_t cipher_get_key_size(const cipher_t* cipher);
  */
 const sa_rights* cipher_get_key_rights(const cipher_t* cipher);
 
+/**
+ * Get the rights verdict precomputed when a symmetric cipher was added to the store. The verdict
+ * may be refreshed by the rights_verdict_* checks, so the cipher has to be held exclusively.
+ *
+ * @param[in] cipher cipher.
+ * @return rights verdict.
+ */
+rights_verdict_t* cipher_get_rights_verdict(cipher_t* cipher);
+
 /**
  * Sets the OAEP parameters on the cipher context.
  *
@@ -123,12 +134,16 @@ sa_status cipher_get_oaep_parameters(
         size_t* label_length);
 
 /**
- * Create and initialize a new cipher store.
+ * Create and initialize a new cipher store. Released ciphers are kept on a free list of up to
+ * pool_size entries and recycled by subsequent adds.
  *
  * @param[in] size number of cipher slots in the store.
+ * @param[in] pool_size number of released ciphers to keep for reuse.
  * @return store instance.
  */
-cipher_store_t* cipher_store_init(size_t size);
+cipher_store_t* cipher_store_init(
+        size_t size,
+        size_t pool_size);
 
 /**
  * Release a store. If any ciphers are still contained in it, they will be released.
@@ -137,6 +152,28 @@ cipher_store_t* cipher_store_init(size_t size);
  */
 void cipher_store_shutdown(cipher_store_t* store);
 
+/**
+ * Obtain the allocation counters of the cipher pool.
+ *
+ * @param[out] stats pool statistics.
+ * @param[in] store store instance.
+ * @return status of the operation.
+ */
+sa_status cipher_store_get_pool_stats(
+        object_pool_stats_t* stats,
+        cipher_store_t* store);
+
+/**
+ * Obtain the mutex counters of the cipher store.
+ *
+ * @param[out] stats lock statistics.
+ * @param[in] store store instance.
+ * @return status of the operation.
+ */
+sa_status cipher_store_get_lock_stats(
+        object_store_lock_stats_t* stats,
+        cipher_store_t* store);
+
 /**
  * Add a symmetric cipher to the store.
  *
@@ -178,7 +215,8 @@ sa_status cipher_store_add_asymmetric_key(
         const sa_uuid* caller_uuid);
 
 /**
- * Remove a cipher from the store.
+ * Remove a cipher from the store. Does not wait for commands that still hold the cipher: it is freed by the
+ * reclaimer after the last one releases it.
  *
  * @param[in] store store.
  * @param[in] context slot of the cipher to remove.
@@ -49,6 +49,15 @@ typedef struct cmac_context_s cmac_context_t;
  */
 cmac_context_t* cmac_context_create(const stored_key_t* stored_key);
 
+/**
+ * Create a new CMAC context from the keyed state of an existing context. The source context must not have been
+ * updated or computed.
+ *
+ * @param[in] context context to duplicate.
+ * @return created context.
+ */
+cmac_context_t* cmac_context_duplicate(const cmac_context_t* context);
+
 /**
  * Compute an CMAC over the input data.
  *
@@ -42,6 +42,8 @@ extern "C" {
 
 #define DIGEST_MAX_LENGTH 64
 
+typedef struct digest_context_s digest_context_t;
+
 /**
  * Obtain digest length for specified algorithm.
  *
@@ -76,6 +78,56 @@ bool digest_sha(
         const void* in3,
         size_t in3_length);
 
+/**
+ * Create an incremental SHA digest context. Data is added with digest_context_update and the digest value is produced
+ * with digest_context_compute, after which the context can be reused for a new digest with the same algorithm.
+ *
+ * @param[in] digest_algorithm the digest algorithm to use.
+ * @return created context. NULL if the digest algorithm is invalid or the context could not be allocated.
+ */
+digest_context_t* digest_context_create(sa_digest_algorithm digest_algorithm);
+
+/**
+ * Obtain the digest algorithm of the context.
+ *
+ * @param[in] context context.
+ * @return digest algorithm. -1 if the context is NULL.
+ */
+sa_digest_algorithm digest_context_get_digest(const digest_context_t* context);
+
+/**
+ * Add data to the digest.
+ *
+ * @param[in] context context.
+ * @param[in] in input data.
+ * @param[in] in_length input data length.
+ * @return status of the operation.
+ */
+bool digest_context_update(
+        digest_context_t* context,
+        const void* in,
+        size_t in_length);
+
+/**
+ * Compute the digest value over all data added since the context was created or last computed and reset the context.
+ *
+ * @param[out] out output buffer for computed digest value.
+ * @param[in,out] out_length output buffer length. Set to number of bytes written on exit.
+ * @param[in] context context.
+ * @return status of the operation.
+ */
+bool digest_context_compute(
+        void* out,
+        size_t* out_length,
+        digest_context_t* context);
+
+/**
+ * Release the digest context.
+ *
+ * @param[in] context context.
+ */
+void digest_context_free(digest_context_t* context);
+
 /**
  * Computes a SHA digest over a key.
  *
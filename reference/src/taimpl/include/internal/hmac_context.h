@@ -52,6 +52,15 @@ hmac_context_t* hmac_context_create(
         sa_digest_algorithm digest_algorithm,
         const stored_key_t* stored_key);
 
+/**
+ * Create a new HMAC context from the keyed state of an existing context. The source context must not have been
+ * updated or computed.
+ *
+ * @param[in] context context to duplicate.
+ * @return created context.
+ */
+hmac_context_t* hmac_context_duplicate(const hmac_context_t* context);
+
 /**
  * Obtain HMAC context digest algorithm.
  *
@@ -67,4 +67,8 @@ bool hmac_internal(
         const void* key,
         size_t key_length);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // HMAC_INTERNAL_H
@@ -60,6 +60,37 @@ typedef struct {
     const json_value_t* value;
 } json_key_value_t;
 
+typedef enum {
+    JSON_FIELD_STRING = 0,
+    JSON_FIELD_INTEGER,
+    JSON_FIELD_BOOL,
+    JSON_FIELD_STRING_ARRAY
+} json_field_type_e;
+
+/**
+ * Null terminated string located inside the buffer passed to json_extract_fields.
+ */
+typedef struct {
+    const char* string;
+    size_t length;
+} json_slice_t;
+
+/**
+ * Top level map entry to extract with json_extract_fields. key, type and, for string arrays, strings and
+ * strings_capacity are set by the caller. The remaining members are written by the extractor.
+ */
+typedef struct {
+    const char* key;
+    json_field_type_e type;
+    bool found;
+    json_slice_t string;
+    int64_t integer;
+    bool boolean;
+    json_slice_t* strings;
+    size_t strings_capacity;
+    size_t strings_length;
+} json_field_t;
+
 /**
  * Parse JSON bytes.
  *
@@ -71,6 +102,26 @@ json_value_t* json_parse_bytes(
         const void* in,
         size_t in_length);
 
+/**
+ * Extract the requested entries of a top level JSON map in a single pass without building a document
+ * tree. String values are returned as slices of in, which is modified in place: every extracted string
+ * is null terminated and escaped strings are decoded over their encoded form. Entries that are not
+ * requested are skipped, and only the first occurrence of a repeated key is used. Extraction fails if in
+ * is not a map, if a requested entry has a different type, or if a string array holds a non string
+ * value or more than strings_capacity values.
+ *
+ * @param[in,out] fields entries to extract.
+ * @param[in] fields_length number of entries.
+ * @param[in,out] in input buffer.
+ * @param[in] in_length input buffer length.
+ * @return true if the extraction was successful.
+ */
+bool json_extract_fields(
+        json_field_t* fields,
+        size_t fields_length,
+        void* in,
+        size_t in_length);
+
 /**
  * Free parsed value. Noop on NULL value.
  *
@@ -54,6 +54,41 @@ sa_status kdf_hkdf_hmac(
         sa_kdf_parameters_hkdf* parameters,
         const stored_key_t* stored_key_parent);
 
+/**
+ * Perform the HKDF extract step. The resulting pseudo random key only depends on the parent key, the digest and the
+ * salt, so it can be expanded multiple times with different info values.
+ *
+ * @param[out] prk pseudo random key.
+ * @param[in,out] prk_length pseudo random key length. Set to number of bytes written on exit.
+ * @param[in] parameters HKDF derivation parameters. key_length, info and info_length are ignored.
+ * @param[in] stored_key_parent the parent key.
+ * @return status of the operation
+ */
+sa_status kdf_hkdf_hmac_extract(
+        void* prk,
+        size_t* prk_length,
+        const sa_kdf_parameters_hkdf* parameters,
+        const stored_key_t* stored_key_parent);
+
+/**
+ * Perform the HKDF expand step using a pseudo random key computed by kdf_hkdf_hmac_extract.
+ *
+ * @param[out] stored_key_derived the derived key.
+ * @param[in] rights rights for the derived key.
+ * @param[in] parameters HKDF derivation parameters. salt and salt_length are ignored.
+ * @param[in] prk pseudo random key.
+ * @param[in] prk_length pseudo random key length.
+ * @param[in] stored_key_parent the parent key.
+ * @return status of the operation
+ */
+sa_status kdf_hkdf_hmac_expand(
+        stored_key_t** stored_key_derived,
+        const sa_rights* rights,
+        const sa_kdf_parameters_hkdf* parameters,
+        const void* prk,
+        size_t prk_length,
+        const stored_key_t* stored_key_parent);
+
 /**
  * Derive a key using Concat KDF derivation.
  *
@@ -31,6 +31,8 @@
 #ifndef KEY_STORE_H
 #define KEY_STORE_H
 
+#include "cmac_context.h"
+#include "hmac_context.h"
 #include "object_store.h"
 #include "sa_types.h"
 #include "stored_key.h"
@@ -41,6 +43,20 @@ extern "C" {
 
 typedef object_store_t key_store_t;
 
+/**
+ * Keyed MAC context cache statistics.
+ */
+typedef struct {
+    /** Number of MAC contexts created from a cached keyed context. */
+    uint64_t hits;
+    /** Number of MAC contexts that required the key to be unwrapped and a new keyed context to be cached. */
+    uint64_t misses;
+    /** Number of cached keyed contexts released together with their key. */
+    uint64_t evictions;
+    /** Number of keyed contexts currently cached. */
+    uint64_t entries;
+} key_store_mac_cache_stats_t;
+
 /**
  * Create and initialize a new keystore.
  *
@@ -125,6 +141,49 @@ sa_status key_store_unwrap(
         sa_key key,
         const sa_uuid* caller_uuid);
 
+/**
+ * Create an HMAC context for a keystore key. The first call for a key and digest unwraps the key and caches a keyed
+ * HMAC context in the key slot. Subsequent calls duplicate the cached context, so the key is not unwrapped and the
+ * HMAC pads are not recomputed. The cached contexts are released when the key is removed. The key usage rights are
+ * not checked by this function.
+ *
+ * @param[out] context the created HMAC context.
+ * @param[in] store key store.
+ * @param[in] key key slot.
+ * @param[in] digest_algorithm digest algorithm.
+ * @param[in] caller_uuid caller UUID.
+ * @return status of the operation.
+ */
+sa_status key_store_create_hmac_context(
+        hmac_context_t** context,
+        key_store_t* store,
+        sa_key key,
+        sa_digest_algorithm digest_algorithm,
+        const sa_uuid* caller_uuid);
+
+/**
+ * Create a CMAC context for a keystore key. The keyed CMAC context, including its derived subkeys, is cached in the
+ * key slot the same way as in key_store_create_hmac_context.
+ *
+ * @param[out] context the created CMAC context.
+ * @param[in] store key store.
+ * @param[in] key key slot.
+ * @param[in] caller_uuid caller UUID.
+ * @return status of the operation.
+ */
+sa_status key_store_create_cmac_context(
+        cmac_context_t** context,
+        key_store_t* store,
+        sa_key key,
+        const sa_uuid* caller_uuid);
+
+/**
+ * Retrieves the keyed MAC context cache statistics for all key stores.
+ *
+ * @param[out] stats the statistics.
+ */
+void key_store_get_mac_cache_stats(key_store_mac_cache_stats_t* stats);
+
 /**
  * Retrieves the header of a keystore key.
  *
@@ -141,7 +200,8 @@ sa_status key_store_get_header(
         const sa_uuid* caller_uuid);
 
 /**
- * Release the key in the key slot.
+ * Release the key in the key slot. The slot is invalid on return. The key itself is wiped and freed by the
+ * reclaimer once no command is using it.
  *
  * @param[in] store key store.
  * @param[in] key key slot.
@@ -30,6 +30,7 @@
 
 #include "cmac_context.h"
 #include "hmac_context.h"
+#include "object_pool.h"
 #include "object_store.h"
 #include "sa_types.h"
 
@@ -63,15 +64,19 @@ hmac_context_t* mac_get_hmac_context(const mac_t* mac);
  */
 cmac_context_t* mac_get_cmac_context(const mac_t* mac);
 
-typedef object_store_t mac_store_t;
+typedef struct mac_store_s mac_store_t;
 
 /**
- * Create and initialize a new mac store.
+ * Create and initialize a new mac store. Released macs are kept on a free list of up to pool_size
+ * entries and recycled by subsequent adds.
  *
  * @param[in] size number of mac slots in the store.
+ * @param[in] pool_size number of released macs to keep for reuse.
  * @return store instance.
  */
-mac_store_t* mac_store_init(size_t size);
+mac_store_t* mac_store_init(
+        size_t size,
+        size_t pool_size);
 
 /**
  * Release a store. If any macs are still contained in it, they will be released.
@@ -80,6 +85,17 @@ mac_store_t* mac_store_init(size_t size);
  */
 void mac_store_shutdown(mac_store_t* store);
 
+/**
+ * Obtain the allocation counters of the mac pool.
+ *
+ * @param[out] stats pool statistics.
+ * @param[in] store store instance.
+ * @return status of the operation.
+ */
+sa_status mac_store_get_pool_stats(
+        object_pool_stats_t* stats,
+        mac_store_t* store);
+
 /**
  * Add an HMAC to the store.
  *
@@ -111,7 +127,7 @@ sa_status mac_store_add_cmac_context(
         const sa_uuid* caller_uuid);
 
 /**
- * Remove a mac from the store.
+ * Remove a mac from the store. The mac is freed by the reclaimer when it is no longer in use.
  *
  * @param[in] store store
  * @param[in] context slot of the cipher to remove
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/** @section Description
+ * @file object_pool.h
+ *
+ * This file contains the functions and structures implementing a bounded object pool. An object
+ * pool keeps released objects on a free list so that they can be handed out again without going
+ * back to the allocator. Objects are constructed and destroyed through the functions supplied when
+ * the pool is created. Owners are responsible for scrubbing any sensitive state from an object
+ * before returning it to the pool.
+ */
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include "object_store.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct object_pool_s object_pool_t;
+
+typedef void* (*object_create_function)(void);
+
+typedef struct {
+    /** Maximum number of objects kept on the free list. */
+    size_t capacity;
+    /** Number of objects currently on the free list. */
+    size_t available;
+    /** Number of objects constructed because the free list was empty. */
+    uint64_t created;
+    /** Number of objects handed out from the free list. */
+    uint64_t reused;
+    /** Number of objects destroyed because the free list was full. */
+    uint64_t destroyed;
+} object_pool_stats_t;
+
+/**
+ * Create an object pool.
+ *
+ * @param[in] object_create function to be used for constructing new objects.
+ * @param[in] object_free function to be used for destroying objects.
+ * @param[in] capacity maximum number of objects kept on the free list. 0 disables pooling.
+ * @return created pool instance.
+ */
+object_pool_t* object_pool_init(
+        object_create_function object_create,
+        object_free_function object_free,
+        size_t capacity);
+
+/**
+ * Shutdown object pool. Destroys all objects remaining on the free list.
+ *
+ * @param[in] pool pool instance.
+ */
+void object_pool_shutdown(object_pool_t* pool);
+
+/**
+ * Obtain an object from the pool. An object from the free list is returned if one is available,
+ * otherwise a new object is constructed.
+ *
+ * @param[in] pool pool instance.
+ * @return object or NULL if a new object could not be constructed.
+ */
+void* object_pool_acquire(object_pool_t* pool);
+
+/**
+ * Return an object to the pool. The object is destroyed if the free list is full.
+ *
+ * @param[in] pool pool instance.
+ * @param[in] object object to return.
+ */
+void object_pool_release(
+        object_pool_t* pool,
+        void* object);
+
+/**
+ * Obtain the allocation counters of the pool.
+ *
+ * @param[out] stats pool statistics.
+ * @param[in] pool pool instance.
+ * @return status of the operation.
+ */
+sa_status object_pool_get_stats(
+        object_pool_stats_t* stats,
+        object_pool_t* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OBJECT_POOL_H
@@ -24,6 +24,10 @@
  *
  * Object store ensures that only the owner of a specific object can access it. Additionally, it
  * provides a mechanism for ensuring that the contained objects are not deleted while in use.
+ *
+ * In a store created with object_store_init_deferred, removing an object invalidates its slot
+ * immediately, but the object is only freed once its last reference is released, and then by the
+ * reclaimer thread rather than by the thread that removed it.
  */
 
 #ifndef OBJECT_STORE_H
@@ -40,6 +44,17 @@ typedef struct object_store_s object_store_t;
 
 typedef void (*object_free_function)(void*);
 
+/**
+ * Store mutex counters. A lock is contended if the mutex was held by another thread when it was requested; only
+ * contended locks are timed.
+ */
+typedef struct {
+    uint64_t lock_count;
+    uint64_t contended_count;
+    uint64_t wait_ns;
+    uint64_t max_wait_ns;
+} object_store_lock_stats_t;
+
 /**
  * Create an object store.
  *
@@ -51,6 +66,19 @@ object_store_t* object_store_init(
         object_free_function object_free,
         size_t count);
 
+/**
+ * Create an object store whose objects are freed by the reclaimer. object_store_remove does not wait for the
+ * reference count of the object to reach 0: the slot can no longer be acquired once it returns, and the object is
+ * queued on the reclaimer when the last reference is released.
+ *
+ * @param[in] object_free function to be used for freeing contained objects. Called on the reclaimer thread.
+ * @param[in] count size of the object store.
+ * @return create store instance.
+ */
+object_store_t* object_store_init_deferred(
+        object_free_function object_free,
+        size_t count);
+
 /**
  * Shutdown object store. Releases any remaining objects.
  *
@@ -130,6 +158,17 @@ sa_status object_store_release(
  */
 size_t object_store_size(object_store_t* store);
 
+/**
+ * Obtain the mutex counters of the store.
+ *
+ * @param[out] stats lock statistics.
+ * @param[in] store store.
+ * @return status of the operation.
+ */
+sa_status object_store_get_lock_stats(
+        object_store_lock_stats_t* stats,
+        object_store_t* store);
+
 #ifdef __cplusplus
 }
 #endif
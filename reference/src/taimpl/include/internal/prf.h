@@ -0,0 +1,164 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @section Description
+ * @file prf.h
+ *
+ * This file contains the functions and structures implementing the keyed pseudo random functions used by the key
+ * derivation algorithms. A PRF is keyed once, which precomputes the HMAC inner and outer pads, the CMAC subkeys or the
+ * digest state over a fixed prefix. Every block computation starts from a copy of that state, so the key schedule is
+ * not repeated for each counter block.
+ */
+
+#ifndef PRF_H
+#define PRF_H
+
+#include "sa_types.h"
+
+#ifdef __cplusplus
+
+#include <cstdbool>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+/**
+ * Maximum number of blocks that prf_expand will generate.
+ */
+#define PRF_MAX_BLOCKS 0xff
+
+typedef struct prf_s prf_t;
+
+/**
+ * Create an HMAC PRF.
+ *
+ * @param[in] digest_algorithm the digest algorithm.
+ * @param[in] key the HMAC key.
+ * @param[in] key_length the length of the HMAC key.
+ * @return the PRF or NULL if the PRF could not be created.
+ */
+prf_t* prf_create_hmac(
+        sa_digest_algorithm digest_algorithm,
+        const void* key,
+        size_t key_length);
+
+/**
+ * Create an AES CMAC PRF.
+ *
+ * @param[in] key the AES key.
+ * @param[in] key_length the length of the AES key. Must be 16 or 32 bytes.
+ * @return the PRF or NULL if the PRF could not be created.
+ */
+prf_t* prf_create_cmac(
+        const void* key,
+        size_t key_length);
+
+/**
+ * Create a digest PRF. The prefix is absorbed once and is implicitly prepended to the input of every block.
+ *
+ * @param[in] digest_algorithm the digest algorithm.
+ * @param[in] prefix the data to prepend to every block input.
+ * @param[in] prefix_length the length of the prefix.
+ * @return the PRF or NULL if the PRF could not be created.
+ */
+prf_t* prf_create_digest(
+        sa_digest_algorithm digest_algorithm,
+        const void* prefix,
+        size_t prefix_length);
+
+/**
+ * Returns the output length of a single PRF block.
+ *
+ * @param[in] prf the PRF.
+ * @return the block length.
+ */
+size_t prf_get_length(const prf_t* prf);
+
+/**
+ * Compute a single PRF block over the concatenation of the inputs. The PRF can be used again after this call.
+ *
+ * @param[out] out the output block. Must be at least prf_get_length bytes.
+ * @param[in] prf the PRF.
+ * @param[in] in1 first input data.
+ * @param[in] in1_length first input data length.
+ * @param[in] in2 second input data.
+ * @param[in] in2_length second input data length.
+ * @param[in] in3 third input data.
+ * @param[in] in3_length third input data length.
+ * @return status of the operation.
+ */
+sa_status prf_compute(
+        void* out,
+        prf_t* prf,
+        const void* in1,
+        size_t in1_length,
+        const void* in2,
+        size_t in2_length,
+        const void* in3,
+        size_t in3_length);
+
+/**
+ * Generate output using the PRF in counter mode. Block i is computed as PRF([feedback] || counter || in1 || in2) when
+ * counter_first is set or PRF([feedback] || in1 || in2 || counter) otherwise, where feedback is the previous block
+ * when feedback mode is requested (and empty for the first block) and the counter is encoded big endian in
+ * counter_length bytes. The counter starts at counter_start and is incremented for each block.
+ *
+ * @param[out] out the output buffer.
+ * @param[in] out_length the number of bytes to generate. At most PRF_MAX_BLOCKS blocks can be generated.
+ * @param[in] prf the PRF.
+ * @param[in] counter_start the counter value of the first block.
+ * @param[in] counter_length the encoded length of the counter. Must be 1 or 4.
+ * @param[in] counter_first whether the counter is placed before or after the input data.
+ * @param[in] feedback whether the previous block is prepended to the input of the next block.
+ * @param[in] in1 first input data.
+ * @param[in] in1_length first input data length.
+ * @param[in] in2 second input data.
+ * @param[in] in2_length second input data length.
+ * @return status of the operation.
+ */
+sa_status prf_expand(
+        void* out,
+        size_t out_length,
+        prf_t* prf,
+        uint32_t counter_start,
+        size_t counter_length,
+        bool counter_first,
+        bool feedback,
+        const void* in1,
+        size_t in1_length,
+        const void* in2,
+        size_t in2_length);
+
+/**
+ * Release the PRF and wipe its key state.
+ *
+ * @param[in] prf the PRF.
+ */
+void prf_free(prf_t* prf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRF_H
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @section Description
+ * @file reclaimer.h
+ *
+ * This file contains the functions implementing the background reclaimer. Objects removed from a
+ * store created with object_store_init_deferred are handed to the reclaimer, which wipes and frees
+ * them on its own thread, so that the destruction is not on the path of the command that released
+ * them. The reclaim queue is bounded. When it is full, when the reclaimer thread could not be
+ * started, or after the process has started exiting, the object is freed by the calling thread
+ * instead. Objects still queued at exit are freed by an exit handler, and a forked child starts its
+ * own reclaimer thread.
+ */
+
+#ifndef RECLAIMER_H
+#define RECLAIMER_H
+
+#include "object_store.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RECLAIMER_QUEUE_SIZE 256
+
+typedef struct {
+    /** Number of objects freed by the reclaimer thread. */
+    uint64_t deferred;
+    /** Number of objects freed by the calling thread because they could not be queued. */
+    uint64_t freed_inline;
+    /** Number of objects currently waiting in the queue. */
+    size_t queued;
+} reclaimer_stats_t;
+
+/**
+ * Queue an object to be freed by the reclaimer thread. Never fails: the object is freed before returning if it
+ * cannot be queued.
+ *
+ * @param[in] object_free function used to free the object.
+ * @param[in] object object to free.
+ */
+void reclaimer_defer(
+        object_free_function object_free,
+        void* object);
+
+/**
+ * Wait until every object queued so far has been freed. Used by object_store_shutdown, so that no object outlives its
+ * store, and by tests that check the effects of freeing an object.
+ */
+void reclaimer_flush();
+
+/**
+ * Obtain the reclaimer counters.
+ *
+ * @param[out] stats reclaimer statistics.
+ * @return status of the operation.
+ */
+sa_status reclaimer_get_stats(reclaimer_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RECLAIMER_H
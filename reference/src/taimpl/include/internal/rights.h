@@ -64,6 +64,24 @@ typedef enum {
     CHACHA20_SUBTYPE
 } key_subtype;
 
+/**
+ * Bits of a precomputed rights verdict.
+ */
+#define RIGHTS_VERDICT_ENCRYPT 0x1U
+#define RIGHTS_VERDICT_DECRYPT 0x2U
+#define RIGHTS_VERDICT_VIDEO_OUTPUT 0x4U
+
+/**
+ * Rights decision for symmetric encrypt and decrypt operations, evaluated once when a cipher is
+ * created. The video output bit is only valid for the recorded video output generation.
+ */
+typedef struct {
+    uint32_t verdict;
+    uint64_t not_before;
+    uint64_t not_on_or_after;
+    uint64_t video_output_generation;
+} rights_verdict_t;
+
 /**
  * UUID value that matches no TA IDs.
  */
@@ -164,6 +182,42 @@ bool rights_allowed_video_output_state(
         const sa_rights* rights,
         const video_output_state_t* video_output_state);
 
+/**
+ * Evaluate the symmetric encrypt and decrypt rights against the current video output state.
+ *
+ * @param[out] verdict precomputed verdict.
+ * @param[in] rights rights.
+ */
+void rights_verdict_init(
+        rights_verdict_t* verdict,
+        const sa_rights* rights);
+
+/**
+ * Check whether symmetric encrypt operation is allowed using a precomputed verdict. Only the
+ * validity window is checked unless the video output generation has moved since the verdict was
+ * last evaluated, in which case the video output state is re-evaluated and the verdict updated.
+ * Equivalent to rights_allowed_encrypt for SA_KEY_TYPE_SYMMETRIC.
+ *
+ * @param[in,out] verdict precomputed verdict.
+ * @param[in] rights rights the verdict was computed from.
+ * @return true if allowed, false otherwise.
+ */
+bool rights_verdict_allowed_encrypt(
+        rights_verdict_t* verdict,
+        const sa_rights* rights);
+
+/**
+ * Check whether symmetric decrypt operation is allowed using a precomputed verdict. Equivalent to
+ * rights_allowed_decrypt for SA_KEY_TYPE_SYMMETRIC.
+ *
+ * @param[in,out] verdict precomputed verdict.
+ * @param[in] rights rights the verdict was computed from.
+ * @return true if allowed, false otherwise.
+ */
+bool rights_verdict_allowed_decrypt(
+        rights_verdict_t* verdict,
+        const sa_rights* rights);
+
 /**
  * Check whether the uuid is in allowed TA list.
  *
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/** @section Description
+ * @file stats.h
+ *
+ * This file contains the functions implementing the TA command statistics. Every thread invoking
+ * commands records into its own shard, so recording a call never contends with other threads. A
+ * snapshot aggregates all shards into the layout described by sa_stats_header. Calls, parameter
+ * bytes and statuses are counted for every call, latencies are sampled.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "sa_ta_types.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Every STATS_SAMPLE_INTERVAL-th call of a command is timed. 1 times every call. */
+#ifndef STATS_SAMPLE_INTERVAL
+#define STATS_SAMPLE_INTERVAL 64
+#endif
+
+/** Commands with an ID at or above this value are not tracked. */
+#define STATS_MAX_COMMANDS 64
+
+/** Number of status counters kept for each command. */
+#define STATS_STATUS_COUNT (SA_STATUS_HW_ERROR + 1)
+
+/** Number of bits used to split each power of two latency range. */
+#define STATS_SUB_BUCKET_BITS 3
+
+/** Latencies of 2^STATS_MAX_MAGNITUDE ns and above are counted in the last bucket. */
+#define STATS_MAX_MAGNITUDE 32
+
+/** Number of latency histogram buckets kept for each command. */
+#define STATS_BUCKET_COUNT ((STATS_MAX_MAGNITUDE - STATS_SUB_BUCKET_BITS + 1) << STATS_SUB_BUCKET_BITS)
+
+typedef struct stats_command_s stats_command_t;
+
+typedef struct {
+    /** Counters of the command in the shard of the calling thread. NULL if the call is not recorded. */
+    stats_command_t* command;
+    /** Start time of the call in ns. 0 if the call is not timed. */
+    uint64_t start;
+} stats_call_t;
+
+/**
+ * Start recording a call in the shard of the calling thread. Only sampled calls are timed.
+ *
+ * @param[in] command_id command that is being invoked.
+ * @return call to be passed to stats_record.
+ */
+stats_call_t stats_begin(SA_COMMAND_ID command_id);
+
+/**
+ * Finish recording a call.
+ *
+ * @param[in] call call obtained from stats_begin.
+ * @param[in] status status returned by the command.
+ * @param[in] param_bytes total size of the memory reference parameters passed to the command.
+ */
+void stats_record(
+        stats_call_t call,
+        sa_status status,
+        size_t param_bytes);
+
+/**
+ * Obtain the histogram bucket of a latency.
+ *
+ * @param[in] ns latency in ns.
+ * @return bucket index.
+ */
+size_t stats_bucket(uint64_t ns);
+
+/**
+ * Aggregate all shards into a snapshot.
+ *
+ * @param[out] stats buffer where the snapshot will be written. Can be set to NULL to obtain the
+ * required length.
+ * @param[in,out] stats_length length of the stats buffer. Set to number of bytes required to store
+ * the snapshot if stats is NULL, or to the number of bytes written otherwise.
+ * @return status of the operation.
+ */
+sa_status stats_snapshot(
+        void* stats,
+        size_t* stats_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_H
@@ -25,6 +25,7 @@
 #ifndef SYMMETRIC_H
 #define SYMMETRIC_H
 
+#include "object_pool.h"
 #include "stored_key.h"
 
 #ifdef __cplusplus
@@ -354,12 +355,21 @@ sa_status symmetric_context_set_tag(
         size_t tag_length);
 
 /**
- * Free the AES context. Operation is a NOOP if context is NULL.
+ * Free the AES context. The underlying EVP context is reset and the context is returned to a shared
+ * pool for reuse by subsequent symmetric_create_* calls. Operation is a NOOP if context is NULL.
  *
  * @param[in] context AES context.
  */
 void symmetric_context_free(symmetric_context_t* context);
 
+/**
+ * Obtain the allocation counters of the symmetric context pool.
+ *
+ * @param[out] stats pool statistics.
+ * @return status of the operation.
+ */
+sa_status symmetric_get_pool_stats(object_pool_stats_t* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -227,6 +227,54 @@ sa_status unwrap_ec(
         sa_unwrap_parameters_ec_elgamal* algorithm_parameters,
         const stored_key_t* stored_key_wrapping);
 
+typedef struct unwrap_context_s unwrap_context_t;
+
+/**
+ * Create an AES unwrap context. The wrapping key is scheduled once and the context can then be used to unwrap any
+ * number of keys wrapped with it, which avoids repeating the key setup for every key of a license response.
+ *
+ * @param[in] cipher_algorithm the unwrap algorithm. SA_CIPHER_ALGORITHM_AES_ECB, SA_CIPHER_ALGORITHM_AES_ECB_PKCS7,
+ * SA_CIPHER_ALGORITHM_AES_CBC, SA_CIPHER_ALGORITHM_AES_CBC_PKCS7, SA_CIPHER_ALGORITHM_AES_CTR and
+ * SA_CIPHER_ALGORITHM_AES_GCM are supported.
+ * @param[in] stored_key_wrapping the unwrapping key.
+ * @return the unwrap context or NULL if the context could not be created.
+ */
+unwrap_context_t* unwrap_context_create(
+        sa_cipher_algorithm cipher_algorithm,
+        const stored_key_t* stored_key_wrapping);
+
+/**
+ * Unwrap data using an AES unwrap context.
+ *
+ * @param[out] stored_key_unwrapped the stored unwrapped key.
+ * @param[in] context the unwrap context.
+ * @param[in] in ciphertext.
+ * @param[in] in_length ciphertext length.
+ * @param[in] rights the key rights.
+ * @param[in] key_type the key type.
+ * @param[in] type_parameters the key type parameters.
+ * @param[in] algorithm_parameters the unwrap parameters. sa_unwrap_parameters_aes_cbc for the CBC algorithms,
+ * sa_unwrap_parameters_aes_ctr for SA_CIPHER_ALGORITHM_AES_CTR, sa_unwrap_parameters_aes_gcm for
+ * SA_CIPHER_ALGORITHM_AES_GCM and ignored for the ECB algorithms.
+ * @return status of the operation.
+ */
+sa_status unwrap_context_unwrap(
+        stored_key_t** stored_key_unwrapped,
+        unwrap_context_t* context,
+        const void* in,
+        size_t in_length,
+        const sa_rights* rights,
+        sa_key_type key_type,
+        void* type_parameters,
+        const void* algorithm_parameters);
+
+/**
+ * Release the unwrap context.
+ *
+ * @param[in] context the unwrap context.
+ */
+void unwrap_context_free(unwrap_context_t* context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/** @section Description
+ * @file video_output_state.h
+ *
+ * This file contains the functions implementing the TA side of the video output subscription. The
+ * TA subscribes to the platform on first use and keeps the most recent video output state as a
+ * versioned snapshot. Readers obtain the snapshot without taking a lock, and the generation of the
+ * snapshot changes every time the platform reports a new state.
+ */
+
+#ifndef VIDEO_OUTPUT_STATE_H
+#define VIDEO_OUTPUT_STATE_H
+
+#include "porting/video_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Obtain the current video output state snapshot.
+ *
+ * @param[out] state state of the video outputs.
+ * @param[out] generation generation of the returned state. May be NULL.
+ * @return true if the call succeeded, false otherwise.
+ */
+bool video_output_state_get(
+        video_output_state_t* state,
+        uint64_t* generation);
+
+/**
+ * Obtain the generation of the current video output state snapshot.
+ *
+ * @return current generation. 0 if no state has been published.
+ */
+uint64_t video_output_state_generation();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VIDEO_OUTPUT_STATE_H
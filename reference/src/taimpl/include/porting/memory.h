@@ -42,6 +42,7 @@ extern "C" {
 /**
  * Allocate memory from a secure heap. If no such heap exists for a given platform, allocate
  * using memory_internal_alloc. Secure heap is preferred to general heap for storage of key material.
+ * The returned buffer is zero filled. Secure heap buffers are cleared when they are released.
  *
  * @param[in] size size in bytes to allocate.
  * @return pointer to allocated buffer. NULL if the allocation failed.
@@ -90,6 +91,7 @@ void* memory_internal_realloc(
 
 /**
  * Release memory back to the general purpose heap. This operation is a NOOP if the buffer is NULL.
+ * Buffers allocated with memory_secure_alloc are returned to the secure heap.
  *
  * @param[in] buffer buffer to release
  */
@@ -121,6 +123,21 @@ void* memory_memset_unoptimizable(
         uint8_t value,
         size_t size);
 
+/**
+ * Memory copy function with same semantics as the standard memcpy that writes the destination with
+ * non-temporal stores where the CPU supports them, so that copying a large block does not evict the
+ * working set from the cache. Copies that fit in the cache are faster with memcpy.
+ *
+ * @param[out] destination destination buffer.
+ * @param[in] source source buffer.
+ * @param[in] size number of bytes to copy.
+ * @return destination pointer.
+ */
+void* memory_memcpy_streaming(
+        void* destination,
+        const void* source,
+        size_t size);
+
 #ifdef __cplusplus
 }
 #endif
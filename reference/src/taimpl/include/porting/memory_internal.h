@@ -0,0 +1,81 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/** @section Description
+ * @file memory_internal.h
+ *
+ * This file contains functions selecting the implementation of the constant time and streaming memory
+ * primitives declared in memory.h. The fastest implementation supported by the CPU is selected on
+ * first use.
+ */
+
+#ifndef MEMORY_INTERNAL_H
+#define MEMORY_INTERNAL_H
+
+#ifdef __cplusplus
+
+#include <cstdbool>
+
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+typedef enum {
+    /** One byte per iteration. Reference implementation. */
+    MEMORY_IMPLEMENTATION_BYTE = 0,
+    /** 64 bit words. Available on every platform. */
+    MEMORY_IMPLEMENTATION_PORTABLE,
+    MEMORY_IMPLEMENTATION_SSE2,
+    MEMORY_IMPLEMENTATION_AVX2,
+    MEMORY_IMPLEMENTATION_NEON,
+    MEMORY_IMPLEMENTATION_COUNT
+} memory_implementation_e;
+
+/**
+ * Check whether an implementation can run on this CPU.
+ *
+ * @param[in] implementation implementation to check.
+ * @return true if the implementation is supported.
+ */
+bool memory_implementation_supported(memory_implementation_e implementation);
+
+/**
+ * Get the implementation used by memory_memcmp_constant, memory_memset_unoptimizable and
+ * memory_memcpy_streaming.
+ *
+ * @return selected implementation.
+ */
+memory_implementation_e memory_get_implementation();
+
+/**
+ * Replace the implementation used by memory_memcmp_constant, memory_memset_unoptimizable and
+ * memory_memcpy_streaming. The selection replaces the default one and is not replaced by it. This is
+ * intended for tests and benchmarks.
+ *
+ * @param[in] implementation implementation to use.
+ * @return true if the implementation is supported and was selected.
+ */
+bool memory_set_implementation(memory_implementation_e implementation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMORY_INTERNAL_H
@@ -27,6 +27,7 @@
 #ifndef SVP_H
 #define SVP_H
 
+#include "digest.h"
 #include "sa_types.h"
 
 #ifdef __cplusplus
@@ -43,6 +44,19 @@ extern "C" {
 
 typedef struct svp_buffer_s svp_buffer_t;
 
+/**
+ * One operation of svp_batch. Copies ranges from in_svp_buffer, or from in if in_svp_buffer is NULL, into
+ * out_svp_buffer.
+ */
+typedef struct {
+    svp_buffer_t* out_svp_buffer;
+    const svp_buffer_t* in_svp_buffer;
+    const void* in;
+    size_t in_length;
+    const sa_svp_offset* offsets;
+    size_t offsets_length;
+} svp_batch_operation_t;
+
 /**
  * Creates a protected SVP buffer from a previously allocated SVP memory region and its size.
  *
@@ -101,6 +115,18 @@ bool svp_copy(
         sa_svp_offset* offsets,
         size_t offsets_length);
 
+/**
+ * Perform a list of writes and copies into protected SVP buffers. Every range of every operation is validated before
+ * any data is moved, so nothing is written if the batch is rejected. Operations are applied in order.
+ *
+ * @param[in] operations the operations to perform.
+ * @param[in] operations_length the number of operations.
+ * @return true if successful.
+ */
+bool svp_batch(
+        const svp_batch_operation_t* operations,
+        size_t operations_length);
+
 /**
  * Perform a key check by decrypting input data with an AES ECB into restricted memory and comparing with reference
  * value. This operation allows validation of keys that cannot decrypt into non-SVP buffers.
@@ -136,6 +162,22 @@ bool svp_digest(
         size_t offset,
         size_t length);
 
+/**
+ * Adds a range of the protected SVP buffer to an incremental digest without exposing the SVP memory. This is a TA
+ * internal hook used by ta_sa_svp_buffer_check_ranges; there is no client API that keeps a digest open across calls.
+ *
+ * @param[in] context the digest context created with digest_context_create.
+ * @param[in] svp_buffer the SVP buffer to digest.
+ * @param[in] offset the offset into SVP at which to start.
+ * @param[in] length the number of bytes in the SVP buffer to include in the digest.
+ * @return true if the range is inside the buffer and was added to the digest.
+ */
+bool svp_digest_update(
+        digest_context_t* context,
+        const svp_buffer_t* svp_buffer,
+        size_t offset,
+        size_t length);
+
 /**
  * Get the protected SVP memory location.
  *
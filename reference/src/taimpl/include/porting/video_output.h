@@ -19,8 +19,10 @@
 /** @section Description
  * @file video_output.h
  *
- * This file contains the functions and structures implementing querying of video output protection
- * levels. Implementors shall replace this functionality with platform dependent functions.
+ * This file contains the functions and structures implementing notification of video output
+ * protection level changes. Implementors shall replace this functionality with platform dependent
+ * functions that push state changes to the subscribed listener as they are reported by the
+ * drivers.
  */
 
 #ifndef VIDEO_OUTPUT_H
@@ -58,12 +60,31 @@ typedef struct {
 } video_output_state_t;
 
 /**
- * Poll the state of the video outputs.
+ * Listener notified of video output state changes.
  *
- * @param[out] current state of the video outputs.
+ * @param[in] state new state of the video outputs.
+ */
+typedef void (*video_output_listener)(const video_output_state_t* state);
+
+/**
+ * Subscribe to video output state changes. Implementations shall invoke the listener with the
+ * current state before returning and then again every time the output protection state changes.
+ * Only a single listener is supported, a subsequent subscription replaces the previous one.
+ *
+ * @param[in] listener listener to notify. NULL unsubscribes.
+ * @return true if the call succeeded, false otherwise.
+ */
+bool video_output_subscribe(video_output_listener listener);
+
+/**
+ * Simulate a video output state change. The reference implementation has no outputs to watch, so
+ * this function stands in for the platform driver event and notifies the subscribed listener from
+ * the calling thread. Not part of the porting interface.
+ *
+ * @param[in] state new state of the video outputs.
  * @return true if the call succeeded, false otherwise.
  */
-bool video_output_poll(video_output_state_t* state);
+bool video_output_simulate(const video_output_state_t* state);
 
 #ifdef __cplusplus
 }
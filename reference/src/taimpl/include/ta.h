@@ -29,6 +29,10 @@
 
 #include "sa_ta_types.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define NUM_TA_PARAMS 4
 
 /**
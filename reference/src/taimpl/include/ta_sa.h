@@ -117,6 +117,30 @@ sa_status ta_sa_get_name(
         ta_client client_slot,
         const sa_uuid* caller_uuid);
 
+/**
+ * Obtain the TA command statistics.
+ *
+ * @param[out] stats Buffer where the statistics snapshot will be written. Can be set to NULL to
+ * obtain the required length.
+ * @param[in,out] stats_length Length of the stats buffer. Set to number of bytes required to
+ * store the snapshot if stats is NULL, or to the number of bytes written otherwise.
+ * @param[in] client_slot the client slot ID.
+ * @param[in] caller_uuid the UUID of the caller.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - stats_length is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - stats is not NULL and *stats_length value is smaller than required
+ * to store the snapshot.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status ta_sa_get_stats(
+        void* stats,
+        size_t* stats_length,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid);
+
 /**
  * Obtain the device ID. ID will be formatted according to the "SOC Identifier Specification"
  * specification.
@@ -195,6 +195,45 @@ sa_status ta_sa_key_unwrap(
         ta_client client_slot,
         const sa_uuid* caller_uuid);
 
+/**
+ * Unwrap multiple symmetric keys wrapped with the same key. The wrapping key is loaded and scheduled once for the
+ * whole batch. If any key fails to unwrap, the keys unwrapped so far are released and no keys are returned.
+ *
+ * @param[in,out] entries Per key rights, wrapped key and algorithm parameters. Unwrapped key handles are returned in
+ * the key field of each entry.
+ * @param[in] entries_length Number of entries.
+ * @param[in] cipher_algorithm Wrapping algorithm. Only the AES algorithms are supported.
+ * @param[in] wrapping_key Wrapping key.
+ * @param[in] client_slot the client slot ID.
+ * @param[in] caller_uuid the UUID of the caller.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - There are no available key slots.
+ * + SA_STATUS_INVALID_KEY_FORMAT - Input data failed the format validation.
+ * + SA_STATUS_INVALID_KEY_TYPE - Wrapping key type is not valid for the specified algorithm.
+ * + SA_STATUS_NULL_PARAMETER - entries, rights, in, or algorithm_parameters (if required) is NULL.
+ * + SA_STATUS_INVALID_PARAMETER
+ *   + entries_length is 0.
+ *   + in_length is not valid for specified algorithm.
+ *   + Invalid algorithm.
+ *   + Invalid algorithm specific parameter value encountered.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - Wrapping key usage requirements are not met for the specified
+ * operation.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_VERIFICATION_FAILED
+ *   + Invalid padding value has been encountered.
+ *   + Tag verification has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status ta_sa_key_unwrap_batch(
+        sa_unwrap_batch_entry* entries,
+        size_t entries_length,
+        sa_cipher_algorithm cipher_algorithm,
+        sa_key wrapping_key,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid);
+
 /**
  * Obtain the public component of an asymmetric key.
  *
@@ -255,6 +294,43 @@ sa_status ta_sa_key_derive(
         ta_client client_slot,
         const sa_uuid* caller_uuid);
 
+/**
+ * Derive multiple symmetric keys from the same parent key using the specified KDF. The parent key is unwrapped once
+ * for the whole batch.
+ *
+ * @param[in,out] entries Per key rights and info (or other data) values. Derived key handles are returned in the key
+ * field of each entry.
+ * @param[in] entries_length Number of entries.
+ * @param[in] kdf_algorithm KDF algorithm.
+ * @param[in] parameters Algorithm specific parameters shared by all entries. Use sa_kdf_parameters_hkdf with
+ * SA_KDF_ALGORITHM_HKDF, sa_kdf_parameters_concat with SA_KDF_ALGORITHM_CONCAT, sa_kdf_parameters_ansi_x963 with
+ * SA_KDF_ALGORITHM_ANSI_X963, sa_kdf_parameters_cmac with SA_KDF_ALGORITHM_CMAC. The info (or other data) fields
+ * of the parameters are ignored.
+ * @param[in] client_slot the client slot ID.
+ * @param[in] caller_uuid the UUID of the caller.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NO_AVAILABLE_RESOURCE_SLOT - There are no available key slots.
+ * + SA_STATUS_INVALID_KEY_TYPE - Key type is not valid for the specified operation.
+ * + SA_STATUS_NULL_PARAMETER - entries, rights, or parameters is NULL.
+ * + SA_STATUS_INVALID_PARAMETER
+ *   + Invalid algorithm value.
+ *   + Invalid algorithm specific parameter value encountered.
+ *   + entries_length is 0.
+ * + SA_STATUS_OPERATION_NOT_ALLOWED - Key usage requirements are not met for the specified
+ * operation.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status ta_sa_key_derive_batch(
+        sa_kdf_batch_entry* entries,
+        size_t entries_length,
+        sa_kdf_algorithm kdf_algorithm,
+        void* parameters,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid);
+
 /**
  * Compute a shared secret using specified key exchange algorithm.
  *
@@ -159,6 +159,35 @@ sa_status ta_sa_svp_buffer_copy(
         ta_client client_slot,
         const sa_uuid* caller_uuid);
 
+/**
+ * Perform a list of writes and copies into SVP buffers. Every SVP buffer referenced by the batch is held for the
+ * duration of the call, and every range is validated before any data is moved, so nothing is written if the batch is
+ * rejected. Operations are applied in order.
+ *
+ * @param[in] in Source data of the writes.
+ * @param[in] in_length The length of the source data.
+ * @param[in] entries the operations to perform. An entry with an in of INVALID_HANDLE writes from in.
+ * @param[in] entries_length the number of entries.
+ * @param[in] client_slot the client slot ID.
+ * @param[in] caller_uuid the UUID of the caller.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded.
+ * + SA_STATUS_NULL_PARAMETER - entries or an entry's offsets is NULL, or in is NULL and in_length is not 0.
+ * + SA_STATUS_INVALID_PARAMETER - entries_length is 0 or an SVP buffer handle is invalid.
+ * + SA_STATUS_INVALID_SVP_BUFFER - Reading or writing past the end of a buffer detected, or SVP buffer is not fully
+ * contained withing SVP memory region.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status ta_sa_svp_buffer_batch(
+        const void* in,
+        size_t in_length,
+        const sa_svp_batch_entry* entries,
+        size_t entries_length,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid);
+
 /**
  * Perform a key check by decrypting input data with an AES ECB into restricted memory and comparing with reference
  * value. This operation allows validation of keys that cannot decrypt into non-SVP buffers.
@@ -222,6 +251,38 @@ sa_status ta_sa_svp_buffer_check(
         ta_client client_slot,
         const sa_uuid* caller_uuid);
 
+/**
+ * Perform a buffer check over several ranges of a buffer in one call. Each range is digested separately and compared
+ * with its own hash. All ranges are validated before any digest is computed.
+ *
+ * @param[in] svp_buffer the buffer to hash.
+ * @param[in] ranges the ranges to hash.
+ * @param[in] ranges_length the number of ranges.
+ * @param[in] digest_algorithm the digest algorithm to use.
+ * @param[in] hashes the hashes to compare against, one digest per range in the order of the ranges.
+ * @param[in] hashes_length the length of the hashes. Must be ranges_length times the digest length.
+ * @param[in] client_slot the client slot ID.
+ * @param[in] caller_uuid the UUID of the caller.
+ * @return Operation status. Possible values are:
+ * + SA_STATUS_OK - Operation succeeded. All ranges passed the check.
+ * + SA_STATUS_NULL_PARAMETER - ranges or hashes is NULL.
+ * + SA_STATUS_INVALID_PARAMETER - A range is outside the buffer or hashes_length is invalid.
+ * + SA_STATUS_OPERATION_NOT_SUPPORTED - Implementation does not support the specified operation.
+ * + SA_STATUS_INVALID_SVP_BUFFER - invalid SVP buffer.
+ * + SA_STATUS_SELF_TEST - Implementation self-test has failed.
+ * + SA_STATUS_VERIFICATION_FAILED - The computed value of at least one range does not match the expected one.
+ * + SA_STATUS_INTERNAL_ERROR - An unexpected error has occurred.
+ */
+sa_status ta_sa_svp_buffer_check_ranges(
+        sa_svp_buffer svp_buffer,
+        const sa_svp_range* ranges,
+        size_t ranges_length,
+        sa_digest_algorithm digest_algorithm,
+        const void* hashes,
+        size_t hashes_length,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @section Description
+ * @file ta_simulator.h
+ *
+ * This file contains the wire protocol between the simulator ta_client backend and the ta_simulator daemon, which
+ * hosts the TA in a separate process on a plain Linux host. Each TA session is a Unix domain socket connection. A
+ * request is a ta_simulator_request, followed by the contents of the inline IN and INOUT parameters. A response is a
+ * ta_simulator_response, followed by the contents of the inline OUT and INOUT parameters.
+ *
+ * Shared memory is created with memfd_create and is mapped at the same address in the client and in the daemon, so a
+ * parameter that lies in shared memory is passed by address and is not copied. Addresses of shared memory embedded
+ * in command structures, such as SVP memory, are valid in the daemon for the same reason.
+ */
+
+#ifndef TA_SIMULATOR_H
+#define TA_SIMULATOR_H
+
+#include "sa_ta_types.h"
+
+#ifdef __cplusplus
+
+#include <cstdint>
+
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+#define TA_SIMULATOR_MAGIC 0x53415349
+
+// Environment variable holding the socket path used by the client. Defaults to TA_SIMULATOR_DEFAULT_SOCKET.
+#define TA_SIMULATOR_SOCKET_ENV "TA_SIMULATOR_SOCKET"
+
+#define TA_SIMULATOR_DEFAULT_SOCKET "/tmp/ta_simulator.sock"
+
+#define TA_SIMULATOR_NUM_PARAMS 4
+
+typedef enum {
+    TA_SIMULATOR_OPEN_SESSION = 0,
+    TA_SIMULATOR_CLOSE_SESSION,
+    TA_SIMULATOR_INVOKE_COMMAND,
+    // The memfd is passed with SCM_RIGHTS. address and size give the mapping in the client.
+    TA_SIMULATOR_MAP_SHARED_MEMORY,
+    TA_SIMULATOR_UNMAP_SHARED_MEMORY
+} ta_simulator_message_type;
+
+typedef enum {
+    // The parameter is NULL.
+    TA_SIMULATOR_PARAM_ABSENT = 0,
+    // The parameter contents follow the request and, for OUT and INOUT parameters, the response.
+    TA_SIMULATOR_PARAM_INLINE,
+    // The parameter lies in shared memory at address.
+    TA_SIMULATOR_PARAM_SHARED
+} ta_simulator_param_location;
+
+typedef struct {
+    uint32_t type;
+    uint32_t location;
+    uint64_t address;
+    uint64_t size;
+} ta_simulator_param;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t message_type;
+    uint32_t command_id;
+    uint32_t reserved;
+    // Shared memory mapping of TA_SIMULATOR_MAP_SHARED_MEMORY and TA_SIMULATOR_UNMAP_SHARED_MEMORY.
+    uint64_t address;
+    uint64_t size;
+    ta_simulator_param params[TA_SIMULATOR_NUM_PARAMS];
+} ta_simulator_request;
+
+typedef struct {
+    uint32_t magic;
+    int32_t status;
+} ta_simulator_response;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TA_SIMULATOR_H
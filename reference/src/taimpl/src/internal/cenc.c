@@ -23,6 +23,7 @@
 #include "sa_cenc.h"
 #include "sa_types.h"
 #include "symmetric.h"
+#include "trace.h"
 #include <arpa/inet.h>
 #include <memory.h>
 
@@ -145,6 +146,7 @@ sa_status cenc_process_sample(
         cipher_store_t* cipher_store,
         const sa_uuid* caller_uuid) {
 
+    TRACE_SPAN_SCOPE("cenc_process_sample");
     sa_status status;
     cipher_t* cipher = NULL;
     svp_t* out_svp = NULL;
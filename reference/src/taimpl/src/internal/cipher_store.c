@@ -20,9 +20,16 @@
 #include "log.h"
 #include "porting/memory.h"
 #include "symmetric.h"
+#include "trace.h"
 #include <memory.h>
+#include <stddef.h>
 #include <threads.h>
 
+struct cipher_store_s {
+    object_store_t* object_store;
+    object_pool_t* pool;
+};
+
 struct cipher_s {
     sa_cipher_algorithm cipher_algorithm;
     sa_cipher_mode cipher_mode;
@@ -32,7 +39,10 @@ struct cipher_s {
     sa_digest_algorithm oaep_mgf1_digest_algorithm;
     void* oaep_label;
     size_t oaep_label_length;
+    rights_verdict_t rights_verdict;
+    // fields below are preserved while the cipher is parked in the pool
     mtx_t mutex;
+    object_pool_t* pool;
 };
 
 sa_cipher_algorithm cipher_get_algorithm(const cipher_t* cipher) {
@@ -101,6 +111,15 @@ const sa_rights* cipher_get_key_rights(const cipher_t* cipher) {
     return &header->rights;
 }
 
+rights_verdict_t* cipher_get_rights_verdict(cipher_t* cipher) {
+    if (cipher == NULL) {
+        ERROR("NULL cipher");
+        return NULL;
+    }
+
+    return &cipher->rights_verdict;
+}
+
 sa_status cipher_set_oaep_parameters(
         cipher_t* cipher,
         sa_digest_algorithm digest_algorithm,
@@ -171,7 +190,7 @@ sa_status cipher_get_oaep_parameters(
     return SA_STATUS_OK;
 }
 
-static cipher_t* cipher_alloc() {
+static void* cipher_create() {
     bool status = false;
     cipher_t* cipher = NULL;
     do {
@@ -199,6 +218,29 @@ static cipher_t* cipher_alloc() {
     return cipher;
 }
 
+static void cipher_destroy(void* object) {
+    if (object == NULL) {
+        return;
+    }
+
+    cipher_t* cipher = (cipher_t*) object;
+    mtx_destroy(&cipher->mutex);
+
+    memory_memset_unoptimizable(cipher, 0, sizeof(cipher_t));
+    memory_internal_free(cipher);
+}
+
+static cipher_t* cipher_alloc(cipher_store_t* store) {
+    cipher_t* cipher = object_pool_acquire(store->pool);
+    if (cipher == NULL) {
+        ERROR("object_pool_acquire failed");
+        return NULL;
+    }
+
+    cipher->pool = store->pool;
+    return cipher;
+}
+
 static void cipher_free(void* object) {
     if (object == NULL) {
         return;
@@ -211,13 +253,13 @@ static void cipher_free(void* object) {
     if (cipher->oaep_label != NULL)
         memory_secure_free(cipher->oaep_label);
 
-    mtx_destroy(&cipher->mutex);
-
-    memory_memset_unoptimizable(cipher, 0, sizeof(cipher_t));
-    memory_internal_free(cipher);
+    // scrub everything but the initialized mutex and the owning pool
+    memory_memset_unoptimizable(cipher, 0, offsetof(cipher_t, mutex));
+    object_pool_release(cipher->pool, cipher);
 }
 
 static bool cipher_lock(cipher_t* cipher) {
+    TRACE_SPAN_SCOPE("cipher_lock");
     if (cipher == NULL) {
         return false;
     }
@@ -240,11 +282,39 @@ static void cipher_unlock(cipher_t* cipher) {
     }
 }
 
-cipher_store_t* cipher_store_init(size_t size) {
-    cipher_store_t* store = object_store_init(cipher_free, size);
-    if (store == NULL) {
-        ERROR("object_store_init failed");
-        return NULL;
+cipher_store_t* cipher_store_init(
+        size_t size,
+        size_t pool_size) {
+
+    bool status = false;
+    cipher_store_t* store = NULL;
+    do {
+        store = memory_internal_alloc(sizeof(cipher_store_t));
+        if (store == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(store, 0, sizeof(cipher_store_t));
+
+        store->pool = object_pool_init(cipher_create, cipher_destroy, pool_size);
+        if (store->pool == NULL) {
+            ERROR("object_pool_init failed");
+            break;
+        }
+
+        store->object_store = object_store_init_deferred(cipher_free, size);
+        if (store->object_store == NULL) {
+            ERROR("object_store_init failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+
+    if (!status) {
+        cipher_store_shutdown(store);
+        store = NULL;
     }
 
     return store;
@@ -255,7 +325,44 @@ void cipher_store_shutdown(cipher_store_t* store) {
         return;
     }
 
-    object_store_shutdown(store);
+    // remaining ciphers are returned to the pool, so the pool has to go last
+    object_store_shutdown(store->object_store);
+    object_pool_shutdown(store->pool);
+    memory_internal_free(store);
+}
+
+sa_status cipher_store_get_pool_stats(
+        object_pool_stats_t* stats,
+        cipher_store_t* store) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (store == NULL) {
+        ERROR("NULL store");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    return object_pool_get_stats(stats, store->pool);
+}
+
+sa_status cipher_store_get_lock_stats(
+        object_store_lock_stats_t* stats,
+        cipher_store_t* store) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (store == NULL) {
+        ERROR("NULL store");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    return object_store_get_lock_stats(stats, store->object_store);
 }
 
 sa_status cipher_store_add_symmetric_context(
@@ -305,7 +412,7 @@ sa_status cipher_store_add_symmetric_context(
     sa_status status = SA_STATUS_INTERNAL_ERROR;
     cipher_t* cipher = NULL;
     do {
-        cipher = cipher_alloc();
+        cipher = cipher_alloc(store);
         if (cipher == NULL) {
             ERROR("cipher_alloc failed");
             break;
@@ -320,7 +427,15 @@ sa_status cipher_store_add_symmetric_context(
             break;
         }
 
-        status = object_store_add(context, store, cipher, caller_uuid);
+        const sa_header* header = stored_key_get_header(cipher->stored_key);
+        if (header == NULL) {
+            ERROR("stored_key_get_header failed");
+            break;
+        }
+
+        rights_verdict_init(&cipher->rights_verdict, &header->rights);
+
+        status = object_store_add(context, store->object_store, cipher, caller_uuid);
         if (status != SA_STATUS_OK) {
             // Let the caller free the symmetric_context and stored_key to avoid a crash.
             cipher->symmetric_context = NULL;
@@ -381,7 +496,7 @@ sa_status cipher_store_add_asymmetric_key(
     sa_status status = SA_STATUS_INTERNAL_ERROR;
     cipher_t* cipher = NULL;
     do {
-        cipher = cipher_alloc();
+        cipher = cipher_alloc(store);
         if (cipher == NULL) {
             ERROR("cipher_alloc failed");
             break;
@@ -395,7 +510,7 @@ sa_status cipher_store_add_asymmetric_key(
             break;
         }
 
-        status = object_store_add(context, store, cipher, caller_uuid);
+        status = object_store_add(context, store->object_store, cipher, caller_uuid);
         if (status != SA_STATUS_OK) {
             // Let the caller free the stored_key to avoid a crash.
             cipher->stored_key = NULL;
@@ -427,7 +542,7 @@ sa_status cipher_store_remove(
         return SA_STATUS_NULL_PARAMETER;
     }
 
-    sa_status status = object_store_remove(store, context, caller_uuid);
+    sa_status status = object_store_remove(store->object_store, context, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_remove failed");
         return status;
@@ -459,7 +574,7 @@ sa_status cipher_store_acquire_exclusive(
     }
 
     void* object = NULL;
-    sa_status status = object_store_acquire(&object, store, context, caller_uuid);
+    sa_status status = object_store_acquire(&object, store->object_store, context, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_acquire failed");
         return status;
@@ -498,7 +613,7 @@ sa_status cipher_store_release_exclusive(
 
     cipher_unlock(cipher);
 
-    sa_status status = object_store_release(store, context, cipher, caller_uuid);
+    sa_status status = object_store_release(store->object_store, context, cipher, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_release failed");
         return status;
@@ -28,6 +28,11 @@
 #define NUM_MAC_SLOTS 256
 #define NUM_SVP_SLOTS 256
 
+// number of released cipher and mac contexts each client keeps for reuse
+#ifndef OBJECT_POOL_SIZE
+#define OBJECT_POOL_SIZE 16
+#endif
+
 static once_flag flag = ONCE_FLAG_INIT;
 static mtx_t mutex;
 static bool global_shutdown = false;
@@ -118,13 +123,13 @@ static client_t* client_init(
             break;
         }
 
-        client->cipher_store = cipher_store_init(cipher_store_size);
+        client->cipher_store = cipher_store_init(cipher_store_size, OBJECT_POOL_SIZE);
         if (client->cipher_store == NULL) {
             ERROR("cipher_store_init failed");
             break;
         }
 
-        client->mac_store = mac_store_init(mac_store_size);
+        client->mac_store = mac_store_init(mac_store_size, OBJECT_POOL_SIZE);
         if (client->mac_store == NULL) {
             ERROR("mac_store_init failed");
             break;
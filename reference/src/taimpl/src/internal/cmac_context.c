@@ -142,6 +142,73 @@ cmac_context_t* cmac_context_create(const stored_key_t* stored_key) {
     return context;
 }
 
+cmac_context_t* cmac_context_duplicate(const cmac_context_t* context) {
+    if (context == NULL) {
+        ERROR("NULL context");
+        return NULL;
+    }
+
+    if (context->done) {
+        ERROR("Mac value has already been computed on this context");
+        return NULL;
+    }
+
+    cmac_context_t* duplicate = NULL;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    EVP_MAC_CTX* evp_mac_ctx = NULL;
+    do {
+        evp_mac_ctx = EVP_MAC_CTX_dup(context->evp_mac_ctx);
+        if (evp_mac_ctx == NULL) {
+            ERROR("EVP_MAC_CTX_dup failed");
+            break;
+        }
+
+        duplicate = memory_internal_alloc(sizeof(cmac_context_t));
+        if (duplicate == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(duplicate, 0, sizeof(cmac_context_t));
+        duplicate->evp_mac_ctx = evp_mac_ctx;
+        evp_mac_ctx = NULL;
+    } while (false);
+
+    EVP_MAC_CTX_free(evp_mac_ctx);
+#else
+    CMAC_CTX* openssl_context = NULL;
+    do {
+        openssl_context = CMAC_CTX_new();
+        if (openssl_context == NULL) {
+            ERROR("CMAC_CTX_new failed");
+            break;
+        }
+
+        if (CMAC_CTX_copy(openssl_context, context->openssl_context) != 1) {
+            ERROR("CMAC_CTX_copy failed");
+            break;
+        }
+
+        duplicate = memory_internal_alloc(sizeof(cmac_context_t));
+        if (duplicate == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(duplicate, 0, sizeof(cmac_context_t));
+        duplicate->openssl_context = openssl_context;
+
+        // openssl_context is now owned by the context
+        openssl_context = NULL;
+    } while (false);
+
+    if (openssl_context != NULL)
+        CMAC_CTX_free(openssl_context);
+#endif
+
+    return duplicate;
+}
+
 sa_status cmac_context_update(
         cmac_context_t* context,
         const void* in,
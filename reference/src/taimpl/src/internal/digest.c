@@ -20,9 +20,15 @@
 #include "common.h"
 #include "digest_internal.h"
 #include "log.h"
+#include "porting/memory.h"
 #include "stored_key_internal.h"
 #include <openssl/evp.h>
 
+struct digest_context_s {
+    EVP_MD_CTX* evp_md_ctx;
+    sa_digest_algorithm digest_algorithm;
+};
+
 const EVP_MD* digest_mechanism(sa_digest_algorithm digest_algorithm) {
     switch (digest_algorithm) {
         case SA_DIGEST_ALGORITHM_SHA1:
@@ -182,6 +188,128 @@ bool digest_sha(
     return status;
 }
 
+digest_context_t* digest_context_create(sa_digest_algorithm digest_algorithm) {
+    const EVP_MD* md = digest_mechanism(digest_algorithm);
+    if (md == NULL) {
+        ERROR("digest_mechanism failed");
+        return NULL;
+    }
+
+    digest_context_t* context = NULL;
+    EVP_MD_CTX* evp_md_ctx = NULL;
+    do {
+        evp_md_ctx = EVP_MD_CTX_create();
+        if (evp_md_ctx == NULL) {
+            ERROR("EVP_MD_CTX_create failed");
+            break;
+        }
+
+        if (EVP_DigestInit_ex(evp_md_ctx, md, NULL) != 1) {
+            ERROR("EVP_DigestInit_ex failed");
+            break;
+        }
+
+        context = memory_internal_alloc(sizeof(digest_context_t));
+        if (context == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        context->evp_md_ctx = evp_md_ctx;
+        context->digest_algorithm = digest_algorithm;
+        evp_md_ctx = NULL;
+    } while (false);
+
+    EVP_MD_CTX_destroy(evp_md_ctx);
+    return context;
+}
+
+sa_digest_algorithm digest_context_get_digest(const digest_context_t* context) {
+    if (context == NULL) {
+        ERROR("NULL context");
+        return (sa_digest_algorithm) -1;
+    }
+
+    return context->digest_algorithm;
+}
+
+bool digest_context_update(
+        digest_context_t* context,
+        const void* in,
+        size_t in_length) {
+
+    if (context == NULL) {
+        ERROR("NULL context");
+        return false;
+    }
+
+    if (in_length == 0)
+        return true;
+
+    if (in == NULL) {
+        ERROR("NULL in");
+        return false;
+    }
+
+    if (EVP_DigestUpdate(context->evp_md_ctx, in, in_length) != 1) {
+        ERROR("EVP_DigestUpdate failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool digest_context_compute(
+        void* out,
+        size_t* out_length,
+        digest_context_t* context) {
+
+    if (out == NULL) {
+        ERROR("NULL out");
+        return false;
+    }
+
+    if (out_length == NULL) {
+        ERROR("NULL out_length");
+        return false;
+    }
+
+    if (context == NULL) {
+        ERROR("NULL context");
+        return false;
+    }
+
+    size_t required_length = digest_length(context->digest_algorithm);
+    if (*out_length < required_length) {
+        ERROR("Invalid out_length");
+        return false;
+    }
+
+    unsigned int length = required_length;
+    if (EVP_DigestFinal_ex(context->evp_md_ctx, (unsigned char*) out, &length) != 1) {
+        ERROR("EVP_DigestFinal_ex failed");
+        return false;
+    }
+
+    *out_length = length;
+
+    // Passing a NULL type keeps the digest implementation that was fetched when the context was created.
+    if (EVP_DigestInit_ex(context->evp_md_ctx, NULL, NULL) != 1) {
+        ERROR("EVP_DigestInit_ex failed");
+        return false;
+    }
+
+    return true;
+}
+
+void digest_context_free(digest_context_t* context) {
+    if (context == NULL)
+        return;
+
+    EVP_MD_CTX_destroy(context->evp_md_ctx);
+    memory_internal_free(context);
+}
+
 sa_status digest_key(
         void* out,
         size_t* out_length,
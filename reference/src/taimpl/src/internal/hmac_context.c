@@ -148,6 +148,72 @@ hmac_context_t* hmac_context_create(
     return context;
 }
 
+hmac_context_t* hmac_context_duplicate(const hmac_context_t* context) {
+    if (context == NULL) {
+        ERROR("NULL context");
+        return NULL;
+    }
+
+    if (context->done) {
+        ERROR("Mac value has already been computed on this context");
+        return NULL;
+    }
+
+    hmac_context_t* duplicate = NULL;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    EVP_MAC_CTX* evp_mac_ctx = NULL;
+    do {
+        evp_mac_ctx = EVP_MAC_CTX_dup(context->evp_mac_ctx);
+        if (evp_mac_ctx == NULL) {
+            ERROR("EVP_MAC_CTX_dup failed");
+            break;
+        }
+
+        duplicate = memory_internal_alloc(sizeof(hmac_context_t));
+        if (duplicate == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(duplicate, 0, sizeof(hmac_context_t));
+        duplicate->evp_mac_ctx = evp_mac_ctx;
+        duplicate->digest_algorithm = context->digest_algorithm;
+        evp_mac_ctx = NULL;
+    } while (false);
+
+    EVP_MAC_CTX_free(evp_mac_ctx);
+#else
+    EVP_MD_CTX* openssl_context = NULL;
+    do {
+        openssl_context = EVP_MD_CTX_create();
+        if (openssl_context == NULL) {
+            ERROR("EVP_MD_CTX_create failed");
+            break;
+        }
+
+        if (EVP_MD_CTX_copy_ex(openssl_context, context->openssl_context) != 1) {
+            ERROR("EVP_MD_CTX_copy_ex failed");
+            break;
+        }
+
+        duplicate = memory_internal_alloc(sizeof(hmac_context_t));
+        if (duplicate == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(duplicate, 0, sizeof(hmac_context_t));
+        duplicate->openssl_context = openssl_context;
+        duplicate->digest_algorithm = context->digest_algorithm;
+        openssl_context = NULL;
+    } while (false);
+
+    EVP_MD_CTX_destroy(openssl_context);
+#endif
+
+    return duplicate;
+}
+
 sa_digest_algorithm hmac_context_get_digest(const hmac_context_t* context) {
     if (context == NULL) {
         ERROR("NULL context");
@@ -1136,6 +1136,338 @@ const json_key_value_t* json_key_value_find(
     return NULL;
 }
 
+typedef struct {
+    yajl_handle yajl;
+    uint8_t* in;
+    size_t in_length;
+    json_field_t* fields;
+    size_t fields_length;
+    size_t depth;
+    json_field_t* field;
+} json_extract_context_t;
+
+static bool json_extract_slice(
+        json_slice_t* slice,
+        json_extract_context_t* context,
+        const unsigned char* string,
+        size_t string_length) {
+
+    const uint8_t* in_end = context->in + context->in_length;
+    if (string >= context->in && string + string_length < in_end) {
+        // Unescaped strings are passed straight from the input and are followed by the closing quote.
+        size_t offset = string - context->in;
+        context->in[offset + string_length] = '\0';
+        slice->string = (const char*) context->in + offset;
+        slice->length = string_length;
+        return true;
+    }
+
+    // Escaped strings are decoded into a yajl buffer. Find the encoded token in the input and copy the
+    // decoded value over it, it is never longer than its encoding.
+    size_t consumed = yajl_get_bytes_consumed(context->yajl);
+    if (consumed == 0 || consumed > context->in_length || context->in[consumed - 1] != '"') {
+        ERROR("Invalid string token");
+        return false;
+    }
+
+    size_t end = consumed - 1;
+    size_t start = end;
+    while (start > 0) {
+        start--;
+        if (context->in[start] != '"')
+            continue;
+
+        size_t backslashes = 0;
+        while (backslashes < start && context->in[start - backslashes - 1] == '\\')
+            backslashes++;
+
+        if (backslashes % 2 == 0)
+            break;
+    }
+
+    if (context->in[start] != '"' || string_length >= end - start) {
+        ERROR("Invalid string token");
+        return false;
+    }
+
+    memcpy(context->in + start + 1, string, string_length);
+    context->in[start + 1 + string_length] = '\0';
+    slice->string = (const char*) context->in + start + 1;
+    slice->length = string_length;
+    return true;
+}
+
+static int extract_scalar(
+        json_extract_context_t* context,
+        json_field_type_e type) {
+
+    if (context->depth == 0) {
+        ERROR("Top level value is not a map");
+        return 0;
+    }
+
+    if (context->field == NULL)
+        return 1;
+
+    if (context->depth == 1 && context->field->type == type) {
+        context->field->found = true;
+        context->field = NULL;
+        return 1;
+    }
+
+    ERROR("Invalid type for %s", context->field->key);
+    return 0;
+}
+
+static int extract_bool_callback(
+        void* context,
+        int boolean_value) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    json_field_t* field = extract->field;
+    if (!extract_scalar(extract, JSON_FIELD_BOOL))
+        return 0;
+
+    if (field != NULL)
+        field->boolean = boolean_value != 0;
+
+    return 1;
+}
+
+static int extract_double_callback(
+        void* context,
+        double double_value) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+
+    // No field is extracted as a double.
+    return extract_scalar(extract, (json_field_type_e) -1);
+}
+
+#if YAJL_MAJOR < 2
+static int extract_integer_callback(
+        void* context,
+        long integer_value) {
+#else
+static int extract_integer_callback(
+        void* context,
+        long long integer_value) {
+#endif
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    json_field_t* field = extract->field;
+    if (!extract_scalar(extract, JSON_FIELD_INTEGER))
+        return 0;
+
+    if (field != NULL)
+        field->integer = integer_value;
+
+    return 1;
+}
+
+static int extract_null_callback(void* context) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    return extract_scalar(extract, (json_field_type_e) -1);
+}
+
+#if YAJL_MAJOR < 2
+static int extract_string_callback(
+        void* context,
+        const unsigned char* string,
+        unsigned int string_length) {
+#else
+static int extract_string_callback(
+        void* context,
+        const unsigned char* string,
+        size_t string_length) {
+#endif
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    json_field_t* field = extract->field;
+    if (field != NULL && extract->depth == 2) {
+        // Element of an extracted string array.
+        if (field->strings_length >= field->strings_capacity) {
+            ERROR("Too many values in %s", field->key);
+            return 0;
+        }
+
+        if (!json_extract_slice(&field->strings[field->strings_length], extract, string, string_length)) {
+            ERROR("json_extract_slice failed");
+            return 0;
+        }
+
+        field->strings_length++;
+        return 1;
+    }
+
+    if (!extract_scalar(extract, JSON_FIELD_STRING))
+        return 0;
+
+    if (field != NULL && !json_extract_slice(&field->string, extract, string, string_length)) {
+        ERROR("json_extract_slice failed");
+        return 0;
+    }
+
+    return 1;
+}
+
+#if YAJL_MAJOR < 2
+static int extract_map_key_callback(
+        void* context,
+        const unsigned char* key,
+        unsigned int key_length) {
+#else
+static int extract_map_key_callback(
+        void* context,
+        const unsigned char* key,
+        size_t key_length) {
+#endif
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    if (extract->depth != 1)
+        return 1;
+
+    extract->field = NULL;
+    for (size_t i = 0; i < extract->fields_length; i++) {
+        json_field_t* field = &extract->fields[i];
+        if (!field->found && strlen(field->key) == key_length && memcmp(field->key, key, key_length) == 0) {
+            extract->field = field;
+            break;
+        }
+    }
+
+    return 1;
+}
+
+static int extract_start_map_callback(void* context) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    if (extract->field != NULL) {
+        ERROR("Invalid type for %s", extract->field->key);
+        return 0;
+    }
+
+    extract->depth++;
+    return 1;
+}
+
+static int extract_end_map_callback(void* context) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    extract->depth--;
+    return 1;
+}
+
+static int extract_start_array_callback(void* context) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    if (extract->depth == 0) {
+        ERROR("Top level value is not a map");
+        return 0;
+    }
+
+    json_field_t* field = extract->field;
+    if (field != NULL) {
+        if (extract->depth != 1 || field->type != JSON_FIELD_STRING_ARRAY) {
+            ERROR("Invalid type for %s", field->key);
+            return 0;
+        }
+
+        field->found = true;
+        field->strings_length = 0;
+    }
+
+    extract->depth++;
+    return 1;
+}
+
+static int extract_end_array_callback(void* context) {
+    json_extract_context_t* extract = (json_extract_context_t*) context;
+    extract->depth--;
+    if (extract->depth == 1)
+        extract->field = NULL;
+
+    return 1;
+}
+
+static const yajl_callbacks extract_callbacks = {
+        .yajl_boolean = extract_bool_callback,
+        .yajl_double = extract_double_callback,
+        .yajl_end_array = extract_end_array_callback,
+        .yajl_end_map = extract_end_map_callback,
+        .yajl_integer = extract_integer_callback,
+        .yajl_map_key = extract_map_key_callback,
+        .yajl_null = extract_null_callback,
+        .yajl_number = NULL,
+        .yajl_start_array = extract_start_array_callback,
+        .yajl_start_map = extract_start_map_callback,
+        .yajl_string = extract_string_callback};
+
+bool json_extract_fields(
+        json_field_t* fields,
+        size_t fields_length,
+        void* in,
+        size_t in_length) {
+
+    if (fields == NULL) {
+        ERROR("NULL fields");
+        return false;
+    }
+
+    if (in == NULL) {
+        ERROR("NULL in");
+        return false;
+    }
+
+    for (size_t i = 0; i < fields_length; i++) {
+        if (fields[i].key == NULL || strnlen(fields[i].key, MAX_KEY_LENGTH + 1) > MAX_KEY_LENGTH) {
+            ERROR("Invalid key");
+            return false;
+        }
+
+        if (fields[i].type == JSON_FIELD_STRING_ARRAY && fields[i].strings == NULL && fields[i].strings_capacity > 0) {
+            ERROR("NULL strings");
+            return false;
+        }
+
+        fields[i].found = false;
+        fields[i].strings_length = 0;
+    }
+
+    bool status = false;
+    json_extract_context_t context = {
+            .in = in,
+            .in_length = in_length,
+            .fields = fields,
+            .fields_length = fields_length};
+    do {
+#if YAJL_MAJOR < 2
+        context.yajl = yajl_alloc(&extract_callbacks, &global_json.parser_configuration, NULL, &context);
+#else
+        context.yajl = yajl_alloc(&extract_callbacks, NULL, &context);
+#endif
+        if (context.yajl == NULL) {
+            ERROR("yajl_alloc failed");
+            break;
+        }
+
+        yajl_status yajlstatus = yajl_parse(context.yajl, (const unsigned char*) in, in_length);
+        if (yajl_status_ok != yajlstatus) {
+            ERROR("yajl_parse failed");
+            break;
+        }
+
+#if YAJL_MAJOR < 2
+        yajlstatus = yajl_parse_complete(context.yajl);
+#else
+        yajlstatus = yajl_complete_parse(context.yajl);
+#endif
+        if (yajl_status_ok != yajlstatus) {
+            ERROR("yajl_parse_complete failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+
+    if (context.yajl != NULL)
+        yajl_free(context.yajl);
+
+    return status;
+}
+
 bool b64_decode(
         void* out,
         size_t* out_length,
@@ -26,9 +26,14 @@
 #include "porting/rand.h"
 #include "rights.h"
 #include "stored_key_internal.h"
+#include "video_output_state.h"
 #include <memory.h>
+#include <stdatomic.h>
+#include <threads.h>
 #include <time.h>
 
+#define NUM_HMAC_DIGESTS (SA_DIGEST_ALGORITHM_SHA512 + 1)
+
 /**
  * Key ladder inputs for Kwrap (Key wrapping key) and Kint (Key integrity key). These keys are used
  * for confidentiality and integrity envelopes around exported key material.
@@ -78,8 +83,19 @@ typedef struct {
     void* ciphertext;
     signature_t signature;
     derivation_inputs_t derivation_inputs;
+    // Keyed MAC contexts used as templates for new MAC contexts. Released together with the key.
+    mtx_t mac_cache_mutex;
+    hmac_context_t* hmac_cache[NUM_HMAC_DIGESTS];
+    cmac_context_t* cmac_cache;
 } wrapped_key_t;
 
+static struct {
+    atomic_ullong hits;
+    atomic_ullong misses;
+    atomic_ullong evictions;
+    atomic_ullong entries;
+} mac_cache_stats;
+
 // clang-format off
 static void xor(
         uint8_t* out,
@@ -253,6 +269,26 @@ static void wrapped_key_free(void* obj) {
 
     wrapped_key_t* wrapped_key = (wrapped_key_t*) obj;
 
+    size_t evicted = 0;
+    for (size_t i = 0; i < NUM_HMAC_DIGESTS; i++) {
+        if (wrapped_key->hmac_cache[i] != NULL) {
+            hmac_context_free(wrapped_key->hmac_cache[i]);
+            evicted++;
+        }
+    }
+
+    if (wrapped_key->cmac_cache != NULL) {
+        cmac_context_free(wrapped_key->cmac_cache);
+        evicted++;
+    }
+
+    if (evicted > 0) {
+        atomic_fetch_add(&mac_cache_stats.evictions, evicted);
+        atomic_fetch_sub(&mac_cache_stats.entries, evicted);
+    }
+
+    mtx_destroy(&wrapped_key->mac_cache_mutex);
+
     memory_memset_unoptimizable(wrapped_key->ciphertext, 0, wrapped_key->cipher_parameters.ciphertext_length);
     memory_secure_free(wrapped_key->ciphertext);
 
@@ -285,6 +321,13 @@ static wrapped_key_t* wrapped_key_create(
         }
         memory_memset_unoptimizable(wrapped_key, 0, sizeof(wrapped_key_t));
 
+        if (mtx_init(&wrapped_key->mac_cache_mutex, mtx_plain) != thrd_success) {
+            ERROR("mtx_init failed");
+            memory_secure_free(wrapped_key);
+            wrapped_key = NULL;
+            break;
+        }
+
         // copy key derivation inputs
         memcpy(&wrapped_key->derivation_inputs, derivation_inputs, sizeof(derivation_inputs_t));
 
@@ -361,8 +404,36 @@ static stored_key_t* wrapped_key_unwrap(const wrapped_key_t* wrapped_key) {
     return stored_key;
 }
 
+static bool wrapped_key_allowed(
+        const wrapped_key_t* wrapped_key,
+        const sa_uuid* caller_uuid) {
+
+    if (!rights_allowed_uuid(&wrapped_key->header.rights, caller_uuid)) {
+        ERROR("caller_uuid in not in the allowed TA list");
+        return false;
+    }
+
+    if (!rights_allowed_time(&wrapped_key->header.rights, time(NULL))) {
+        ERROR("rights_allowed_time failed");
+        return false;
+    }
+
+    video_output_state_t video_output_state;
+    if (!video_output_state_get(&video_output_state, NULL)) {
+        ERROR("video_output_state_get failed");
+        return false;
+    }
+
+    if (!rights_allowed_video_output_state(&wrapped_key->header.rights, &video_output_state)) {
+        ERROR("rights_allowed_video_output_state failed");
+        return false;
+    }
+
+    return true;
+}
+
 key_store_t* key_store_init(size_t size) {
-    key_store_t* store = object_store_init(wrapped_key_free, size);
+    key_store_t* store = object_store_init_deferred(wrapped_key_free, size);
     if (store == NULL) {
         ERROR("object_store_init failed");
         return NULL;
@@ -583,46 +654,184 @@ sa_status key_store_unwrap(
         }
         wrapped_key = object;
 
-        if (!rights_allowed_uuid(&wrapped_key->header.rights, caller_uuid)) {
-            ERROR("caller_uuid in not in the allowed TA list");
+        if (!wrapped_key_allowed(wrapped_key, caller_uuid)) {
+            ERROR("wrapped_key_allowed failed");
             status = SA_STATUS_OPERATION_NOT_ALLOWED;
             break;
         }
 
-        if (!rights_allowed_time(&wrapped_key->header.rights, time(NULL))) {
-            ERROR("rights_allowed_time failed");
-            status = SA_STATUS_OPERATION_NOT_ALLOWED;
+        *stored_key = wrapped_key_unwrap(wrapped_key);
+        if (!*stored_key) {
+            ERROR("wrapped_key_unwrap failed");
+            status = SA_STATUS_INTERNAL_ERROR;
             break;
         }
 
-        video_output_state_t video_output_state;
-        if (!video_output_poll(&video_output_state)) {
-            ERROR("video_output_poll failed");
-            status = SA_STATUS_OPERATION_NOT_ALLOWED;
+        status = SA_STATUS_OK;
+    } while (false);
+
+    object_store_release(store, key, wrapped_key, caller_uuid);
+
+    return status;
+}
+
+static sa_status key_store_create_mac_context(
+        hmac_context_t** hmac_context,
+        cmac_context_t** cmac_context,
+        key_store_t* store,
+        sa_key key,
+        sa_digest_algorithm digest_algorithm,
+        const sa_uuid* caller_uuid) {
+
+    if (store == NULL) {
+        ERROR("NULL store");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (key >= object_store_size(store)) {
+        ERROR("Invalid id");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (caller_uuid == NULL) {
+        ERROR("NULL caller_uuid");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    sa_status status;
+    wrapped_key_t* wrapped_key = NULL;
+    stored_key_t* stored_key = NULL;
+    bool locked = false;
+    do {
+        void* object = NULL;
+        status = object_store_acquire(&object, store, key, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("object_store_acquire failed");
             break;
         }
+        wrapped_key = object;
 
-        if (!rights_allowed_video_output_state(&wrapped_key->header.rights, &video_output_state)) {
-            ERROR("rights_allowed_video_output_state failed");
+        if (!wrapped_key_allowed(wrapped_key, caller_uuid)) {
+            ERROR("wrapped_key_allowed failed");
             status = SA_STATUS_OPERATION_NOT_ALLOWED;
             break;
         }
 
-        *stored_key = wrapped_key_unwrap(wrapped_key);
-        if (!*stored_key) {
-            ERROR("wrapped_key_unwrap failed");
+        if (mtx_lock(&wrapped_key->mac_cache_mutex) != thrd_success) {
+            ERROR("mtx_lock failed");
             status = SA_STATUS_INTERNAL_ERROR;
             break;
         }
+        locked = true;
+
+        bool cached = (hmac_context != NULL) ? wrapped_key->hmac_cache[digest_algorithm] != NULL :
+                                               wrapped_key->cmac_cache != NULL;
+        if (cached) {
+            atomic_fetch_add(&mac_cache_stats.hits, 1);
+        } else {
+            atomic_fetch_add(&mac_cache_stats.misses, 1);
+            stored_key = wrapped_key_unwrap(wrapped_key);
+            if (stored_key == NULL) {
+                ERROR("wrapped_key_unwrap failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            if (hmac_context != NULL) {
+                wrapped_key->hmac_cache[digest_algorithm] = hmac_context_create(digest_algorithm, stored_key);
+                if (wrapped_key->hmac_cache[digest_algorithm] == NULL) {
+                    ERROR("hmac_context_create failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    break;
+                }
+            } else {
+                wrapped_key->cmac_cache = cmac_context_create(stored_key);
+                if (wrapped_key->cmac_cache == NULL) {
+                    ERROR("cmac_context_create failed");
+                    status = SA_STATUS_INTERNAL_ERROR;
+                    break;
+                }
+            }
+
+            atomic_fetch_add(&mac_cache_stats.entries, 1);
+        }
+
+        if (hmac_context != NULL) {
+            *hmac_context = hmac_context_duplicate(wrapped_key->hmac_cache[digest_algorithm]);
+            if (*hmac_context == NULL) {
+                ERROR("hmac_context_duplicate failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+        } else {
+            *cmac_context = cmac_context_duplicate(wrapped_key->cmac_cache);
+            if (*cmac_context == NULL) {
+                ERROR("cmac_context_duplicate failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+        }
 
         status = SA_STATUS_OK;
     } while (false);
 
+    if (locked)
+        mtx_unlock(&wrapped_key->mac_cache_mutex);
+
+    stored_key_free(stored_key);
     object_store_release(store, key, wrapped_key, caller_uuid);
 
     return status;
 }
 
+sa_status key_store_create_hmac_context(
+        hmac_context_t** context,
+        key_store_t* store,
+        sa_key key,
+        sa_digest_algorithm digest_algorithm,
+        const sa_uuid* caller_uuid) {
+
+    if (context == NULL) {
+        ERROR("NULL context");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+    *context = NULL;
+
+    if (digest_algorithm < SA_DIGEST_ALGORITHM_SHA1 || digest_algorithm >= NUM_HMAC_DIGESTS) {
+        ERROR("Invalid digest_algorithm");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    return key_store_create_mac_context(context, NULL, store, key, digest_algorithm, caller_uuid);
+}
+
+sa_status key_store_create_cmac_context(
+        cmac_context_t** context,
+        key_store_t* store,
+        sa_key key,
+        const sa_uuid* caller_uuid) {
+
+    if (context == NULL) {
+        ERROR("NULL context");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+    *context = NULL;
+
+    return key_store_create_mac_context(NULL, context, store, key, 0, caller_uuid);
+}
+
+void key_store_get_mac_cache_stats(key_store_mac_cache_stats_t* stats) {
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return;
+    }
+
+    stats->hits = atomic_load(&mac_cache_stats.hits);
+    stats->misses = atomic_load(&mac_cache_stats.misses);
+    stats->evictions = atomic_load(&mac_cache_stats.evictions);
+    stats->entries = atomic_load(&mac_cache_stats.entries);
+}
+
 sa_status key_store_get_header(
         sa_header* header,
         key_store_t* store,
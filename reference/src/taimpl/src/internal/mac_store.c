@@ -19,13 +19,21 @@
 #include "mac_store.h" // NOLINT
 #include "log.h"
 #include "porting/memory.h"
+#include <stddef.h>
 #include <threads.h>
 
+struct mac_store_s {
+    object_store_t* object_store;
+    object_pool_t* pool;
+};
+
 struct mac_s {
     sa_mac_algorithm mac_algorithm;
     hmac_context_t* hmac_context;
     cmac_context_t* cmac_context;
+    // fields below are preserved while the mac is parked in the pool
     mtx_t mutex;
+    object_pool_t* pool;
 };
 
 sa_mac_algorithm mac_get_algorithm(const mac_t* mac) {
@@ -55,7 +63,7 @@ cmac_context_t* mac_get_cmac_context(const mac_t* mac) {
     return mac->cmac_context;
 }
 
-static mac_t* mac_allocate() {
+static void* mac_create() {
     bool status = false;
     mac_t* mac = NULL;
     do {
@@ -83,6 +91,29 @@ static mac_t* mac_allocate() {
     return mac;
 }
 
+static void mac_destroy(void* object) {
+    if (object == NULL) {
+        return;
+    }
+
+    mac_t* mac = (mac_t*) object;
+    mtx_destroy(&mac->mutex);
+
+    memory_memset_unoptimizable(mac, 0, sizeof(mac_t));
+    memory_internal_free(mac);
+}
+
+static mac_t* mac_allocate(mac_store_t* store) {
+    mac_t* mac = object_pool_acquire(store->pool);
+    if (mac == NULL) {
+        ERROR("object_pool_acquire failed");
+        return NULL;
+    }
+
+    mac->pool = store->pool;
+    return mac;
+}
+
 static void mac_free(void* object) {
     if (object == NULL) {
         return;
@@ -93,10 +124,9 @@ static void mac_free(void* object) {
     hmac_context_free(mac->hmac_context);
     cmac_context_free(mac->cmac_context);
 
-    mtx_destroy(&mac->mutex);
-
-    memory_memset_unoptimizable(mac, 0, sizeof(mac_t));
-    memory_internal_free(mac);
+    // scrub everything but the initialized mutex and the owning pool
+    memory_memset_unoptimizable(mac, 0, offsetof(mac_t, mutex));
+    object_pool_release(mac->pool, mac);
 }
 
 static bool mac_lock(mac_t* mac) {
@@ -122,11 +152,39 @@ static void mac_unlock(mac_t* mac) {
     }
 }
 
-mac_store_t* mac_store_init(size_t size) {
-    mac_store_t* store = object_store_init(mac_free, size);
-    if (store == NULL) {
-        ERROR("object_store_init failed");
-        return NULL;
+mac_store_t* mac_store_init(
+        size_t size,
+        size_t pool_size) {
+
+    bool status = false;
+    mac_store_t* store = NULL;
+    do {
+        store = memory_internal_alloc(sizeof(mac_store_t));
+        if (store == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(store, 0, sizeof(mac_store_t));
+
+        store->pool = object_pool_init(mac_create, mac_destroy, pool_size);
+        if (store->pool == NULL) {
+            ERROR("object_pool_init failed");
+            break;
+        }
+
+        store->object_store = object_store_init_deferred(mac_free, size);
+        if (store->object_store == NULL) {
+            ERROR("object_store_init failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+
+    if (!status) {
+        mac_store_shutdown(store);
+        store = NULL;
     }
 
     return store;
@@ -137,7 +195,27 @@ void mac_store_shutdown(mac_store_t* store) {
         return;
     }
 
-    object_store_shutdown(store);
+    // remaining macs are returned to the pool, so the pool has to go last
+    object_store_shutdown(store->object_store);
+    object_pool_shutdown(store->pool);
+    memory_internal_free(store);
+}
+
+sa_status mac_store_get_pool_stats(
+        object_pool_stats_t* stats,
+        mac_store_t* store) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (store == NULL) {
+        ERROR("NULL store");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    return object_pool_get_stats(stats, store->pool);
 }
 
 sa_status mac_store_add_hmac_context(
@@ -170,7 +248,7 @@ sa_status mac_store_add_hmac_context(
     mac_t* mac = NULL;
     sa_status status = SA_STATUS_INTERNAL_ERROR;
     do {
-        mac = mac_allocate();
+        mac = mac_allocate(store);
         if (mac == NULL) {
             ERROR("mac_allocate failed");
             break;
@@ -179,7 +257,7 @@ sa_status mac_store_add_hmac_context(
         mac->mac_algorithm = SA_MAC_ALGORITHM_HMAC;
         mac->hmac_context = hmac_context;
 
-        status = object_store_add(context, store, mac, caller_uuid);
+        status = object_store_add(context, store->object_store, mac, caller_uuid);
         if (status != SA_STATUS_OK) {
             // Let the caller free the hmac_context to avoid a crash.
             mac->hmac_context = NULL;
@@ -226,7 +304,7 @@ sa_status mac_store_add_cmac_context(
     mac_t* mac = NULL;
     sa_status status = SA_STATUS_INTERNAL_ERROR;
     do {
-        mac = mac_allocate();
+        mac = mac_allocate(store);
         if (mac == NULL) {
             ERROR("mac_allocate failed");
             break;
@@ -235,7 +313,7 @@ sa_status mac_store_add_cmac_context(
         mac->mac_algorithm = SA_MAC_ALGORITHM_CMAC;
         mac->cmac_context = cmac_context;
 
-        status = object_store_add(context, store, mac, caller_uuid);
+        status = object_store_add(context, store->object_store, mac, caller_uuid);
         if (status != SA_STATUS_OK) {
             // Let the caller free the cmac_context to avoid a crash.
             mac->cmac_context = NULL;
@@ -267,7 +345,7 @@ sa_status mac_store_remove(
         return SA_STATUS_NULL_PARAMETER;
     }
 
-    sa_status status = object_store_remove(store, context, caller_uuid);
+    sa_status status = object_store_remove(store->object_store, context, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_remove failed");
         return status;
@@ -299,7 +377,7 @@ sa_status mac_store_acquire_exclusive(
     }
 
     void* object = NULL;
-    sa_status status = object_store_acquire(&object, store, slot, caller_uuid);
+    sa_status status = object_store_acquire(&object, store->object_store, slot, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_acquire failed");
         return status;
@@ -338,7 +416,7 @@ sa_status mac_store_release_exclusive(
 
     mac_unlock(mac);
 
-    sa_status status = object_store_release(store, context, mac, caller_uuid);
+    sa_status status = object_store_release(store->object_store, context, mac, caller_uuid);
     if (status != SA_STATUS_OK) {
         ERROR("object_store_release failed");
         return status;
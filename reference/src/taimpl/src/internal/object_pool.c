@@ -0,0 +1,205 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "object_pool.h" // NOLINT
+#include "log.h"
+#include "porting/memory.h"
+#include <threads.h>
+
+struct object_pool_s {
+    mtx_t mutex;
+    object_create_function object_create;
+    object_free_function object_free;
+    void** objects;
+    size_t capacity;
+    size_t available;
+    uint64_t created;
+    uint64_t reused;
+    uint64_t destroyed;
+};
+
+object_pool_t* object_pool_init(
+        object_create_function object_create,
+        object_free_function object_free,
+        size_t capacity) {
+
+    if (object_create == NULL) {
+        ERROR("NULL object_create");
+        return NULL;
+    }
+
+    if (object_free == NULL) {
+        ERROR("NULL object_free");
+        return NULL;
+    }
+
+    bool status = false;
+    object_pool_t* pool = NULL;
+    do {
+        pool = memory_internal_alloc(sizeof(object_pool_t));
+        if (pool == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(pool, 0, sizeof(object_pool_t));
+        pool->object_create = object_create;
+        pool->object_free = object_free;
+        pool->capacity = capacity;
+
+        if (capacity > 0) {
+            pool->objects = memory_internal_alloc(sizeof(void*) * capacity);
+            if (pool->objects == NULL) {
+                ERROR("memory_internal_alloc failed");
+                break;
+            }
+        }
+
+        if (mtx_init(&pool->mutex, mtx_plain) != thrd_success) {
+            ERROR("mtx_init failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+
+    if (!status) {
+        if (pool != NULL)
+            memory_internal_free(pool->objects);
+
+        memory_internal_free(pool);
+        pool = NULL;
+    }
+
+    return pool;
+}
+
+void object_pool_shutdown(object_pool_t* pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < pool->available; i++) {
+        pool->object_free(pool->objects[i]);
+    }
+
+    mtx_destroy(&pool->mutex);
+    memory_internal_free(pool->objects);
+    memory_internal_free(pool);
+}
+
+void* object_pool_acquire(object_pool_t* pool) {
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return NULL;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return NULL;
+    }
+
+    void* object = NULL;
+    if (pool->available > 0) {
+        pool->available -= 1;
+        object = pool->objects[pool->available];
+        pool->objects[pool->available] = NULL;
+        pool->reused += 1;
+    } else {
+        pool->created += 1;
+    }
+
+    if (mtx_unlock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+
+    // construct outside of the lock, the free list was empty
+    if (object == NULL) {
+        object = pool->object_create();
+        if (object == NULL) {
+            ERROR("object_create failed");
+        }
+    }
+
+    return object;
+}
+
+void object_pool_release(
+        object_pool_t* pool,
+        void* object) {
+
+    if (pool == NULL || object == NULL) {
+        return;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        pool->object_free(object);
+        return;
+    }
+
+    if (pool->available < pool->capacity) {
+        pool->objects[pool->available] = object;
+        pool->available += 1;
+        object = NULL;
+    } else {
+        pool->destroyed += 1;
+    }
+
+    if (mtx_unlock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+
+    // free list is full
+    if (object != NULL) {
+        pool->object_free(object);
+    }
+}
+
+sa_status object_pool_get_stats(
+        object_pool_stats_t* stats,
+        object_pool_t* pool) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (pool == NULL) {
+        ERROR("NULL pool");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (mtx_lock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    stats->capacity = pool->capacity;
+    stats->available = pool->available;
+    stats->created = pool->created;
+    stats->reused = pool->reused;
+    stats->destroyed = pool->destroyed;
+
+    if (mtx_unlock(&pool->mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+
+    return SA_STATUS_OK;
+}
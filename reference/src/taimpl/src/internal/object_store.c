@@ -19,21 +19,28 @@
 #include "object_store.h" // NOLINT
 #include "log.h"
 #include "porting/memory.h"
+#include "reclaimer.h"
 #include "slots.h"
+#include "trace.h"
 #include <inttypes.h>
 #include <memory.h>
 #include <threads.h>
+#include <time.h>
 #include <unistd.h>
 
 typedef struct {
     void* object;
     size_t reference_count;
     sa_uuid owner_uuid;
+    // removed while still referenced, freed when the reference count goes to 0
+    bool released;
 } store_object_t;
 
 struct object_store_s {
     mtx_t mutex;
     object_free_function object_free;
+    // objects are freed by the reclaimer instead of by the thread removing them
+    bool deferred_free;
     slots_t* slots;
     store_object_t* objects;
     size_t slot_count;
@@ -41,11 +48,14 @@ struct object_store_s {
     bool is_shutting_down;
     // track how many release operations are currently running
     size_t release_count;
+    // protected by mutex
+    object_store_lock_stats_t lock_stats;
 };
 
-object_store_t* object_store_init(
+static object_store_t* store_init(
         object_free_function object_free,
-        size_t count) {
+        size_t count,
+        bool deferred_free) {
 
     if (object_free == NULL) {
         ERROR("NULL object_free");
@@ -82,11 +92,13 @@ object_store_t* object_store_init(
         }
 
         store->object_free = object_free;
+        store->deferred_free = deferred_free;
         store->slots = slots;
         store->objects = objects;
         store->slot_count = count;
         store->is_shutting_down = false;
         store->release_count = 0;
+        memory_memset_unoptimizable(&store->lock_stats, 0, sizeof(object_store_lock_stats_t));
 
         // slots and objects are not owned by the store
         slots = NULL;
@@ -111,14 +123,61 @@ object_store_t* object_store_init(
     return store;
 }
 
+object_store_t* object_store_init(
+        object_free_function object_free,
+        size_t count) {
+    return store_init(object_free, count, false);
+}
+
+object_store_t* object_store_init_deferred(
+        object_free_function object_free,
+        size_t count) {
+    return store_init(object_free, count, true);
+}
+
+static uint64_t store_now() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static bool store_lock(object_store_t* store) {
+    // Try the uncontended case first so that only waits pay for reading the clock.
+    uint64_t wait_ns = 0;
+    int lock_status = mtx_trylock(&store->mutex);
+    bool contended = lock_status == thrd_busy;
+    if (contended) {
+        uint64_t start = store_now();
+        lock_status = mtx_lock(&store->mutex);
+        wait_ns = store_now() - start;
+    }
+
+    if (lock_status != thrd_success) {
+        ERROR("mtx_lock failed");
+        return false;
+    }
+
+    store->lock_stats.lock_count++;
+    if (contended) {
+        store->lock_stats.contended_count++;
+        store->lock_stats.wait_ns += wait_ns;
+        if (wait_ns > store->lock_stats.max_wait_ns)
+            store->lock_stats.max_wait_ns = wait_ns;
+    }
+
+    return true;
+}
+
 static bool increment_release_count(object_store_t* store) {
     if (store == NULL) {
         return false;
     }
 
     bool status = false;
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
         return false;
     }
 
@@ -145,8 +204,8 @@ static void decrement_release_count(object_store_t* store) {
         return;
     }
 
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
         return;
     }
 
@@ -185,15 +244,15 @@ static sa_status store_remove(
     sa_status status;
     void* object_to_free = NULL;
     do {
-        if (mtx_lock(&store->mutex) != thrd_success) {
-            ERROR("mtx_lock failed");
+        if (!store_lock(store)) {
+            ERROR("store_lock failed");
             status = SA_STATUS_INTERNAL_ERROR;
             break;
         }
 
         store_object_t* store_object = &store->objects[slot];
 
-        if (store_object->object == NULL) {
+        if (store_object->object == NULL || (!is_shutting_down && store_object->released)) {
             // empty slot, nothing to do
             status = SA_STATUS_INVALID_PARAMETER;
             break;
@@ -206,6 +265,13 @@ static sa_status store_remove(
             break;
         }
 
+        if (!is_shutting_down && store->deferred_free && store_object->reference_count > 0) {
+            // the last object_store_release frees the object
+            store_object->released = true;
+            status = SA_STATUS_OK;
+            break;
+        }
+
         if (store_object->reference_count == 0) {
             if (is_shutting_down) {
                 WARN("Releasing object %" PRIu32 " from the store %p on shutdown", slot, store);
@@ -214,6 +280,7 @@ static sa_status store_remove(
             // reference count is 0, ok to delete
             object_to_free = store_object->object;
             store_object->object = NULL;
+            store_object->released = false;
             slots_free(store->slots, slot);
 
             status = SA_STATUS_OK;
@@ -240,7 +307,10 @@ static sa_status store_remove(
 
     // free the resource
     if (object_to_free != NULL) {
-        store->object_free(object_to_free);
+        if (store->deferred_free && !is_shutting_down)
+            reclaimer_defer(store->object_free, object_to_free);
+        else
+            store->object_free(object_to_free);
     }
 
     return status;
@@ -252,8 +322,8 @@ void object_store_shutdown(object_store_t* store) {
     }
 
     // indicate that the store is shutting down, so all future requests will fail
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
         return;
     }
 
@@ -265,8 +335,8 @@ void object_store_shutdown(object_store_t* store) {
     // wait for release count to go to 0 before freeing all objects
     // release count is the number of non-shutdown release calls that are still processing.
     do {
-        if (mtx_lock(&store->mutex) != thrd_success) {
-            ERROR("mtx_lock failed");
+        if (!store_lock(store)) {
+            ERROR("store_lock failed");
             break;
         }
 
@@ -287,6 +357,10 @@ void object_store_shutdown(object_store_t* store) {
         store_remove(store, i, NULL);
     }
 
+    // objects handed to the reclaimer may still need resources that the owner of the store frees after shutdown
+    if (store->deferred_free)
+        reclaimer_flush();
+
     slots_shutdown(store->slots);
     store->slots = NULL;
     memory_internal_free(store->objects);
@@ -324,8 +398,8 @@ sa_status object_store_add(
         return SA_STATUS_NULL_PARAMETER;
     }
 
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
         return SA_STATUS_INTERNAL_ERROR;
     }
 
@@ -408,8 +482,11 @@ sa_status object_store_acquire(
         return SA_STATUS_INVALID_PARAMETER;
     }
 
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    bool span = TRACE_SPAN_BEGIN("object_store_lock");
+    bool locked = store_lock(store);
+    TRACE_SPAN_END(span);
+    if (!locked) {
+        ERROR("store_lock failed");
         return SA_STATUS_INTERNAL_ERROR;
     }
 
@@ -428,7 +505,8 @@ sa_status object_store_acquire(
         }
 
         *object = store_object->object;
-        if (*object == NULL) {
+        if (*object == NULL || store_object->released) {
+            *object = NULL;
             ERROR("No object at specified slot");
             status = SA_STATUS_INVALID_PARAMETER;
             break;
@@ -474,12 +552,13 @@ sa_status object_store_release(object_store_t* store, slot_t slot, void* object,
         return SA_STATUS_NULL_PARAMETER;
     }
 
-    if (mtx_lock(&store->mutex) != thrd_success) {
-        ERROR("mtx_lock failed");
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
         return SA_STATUS_INTERNAL_ERROR;
     }
 
     sa_status status = SA_STATUS_INTERNAL_ERROR;
+    void* object_to_free = NULL;
     store_object_t* store_object = &store->objects[slot];
     do {
         if (memory_memcmp_constant(&store_object->owner_uuid, caller_uuid, sizeof(sa_uuid)) != 0) {
@@ -499,6 +578,13 @@ sa_status object_store_release(object_store_t* store, slot_t slot, void* object,
         }
 
         store_object->reference_count -= 1;
+        if (store_object->released && store_object->reference_count == 0) {
+            // last reference to an object removed while in use
+            object_to_free = store_object->object;
+            store_object->object = NULL;
+            store_object->released = false;
+            slots_free(store->slots, slot);
+        }
 
         status = SA_STATUS_OK;
     } while (false);
@@ -507,6 +593,9 @@ sa_status object_store_release(object_store_t* store, slot_t slot, void* object,
         ERROR("mtx_unlock failed");
     }
 
+    if (object_to_free != NULL)
+        reclaimer_defer(store->object_free, object_to_free);
+
     return status;
 }
 
@@ -518,3 +607,30 @@ size_t object_store_size(object_store_t* store) {
 
     return store->slot_count;
 }
+
+sa_status object_store_get_lock_stats(
+        object_store_lock_stats_t* stats,
+        object_store_t* store) {
+
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (store == NULL) {
+        ERROR("NULL store");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (!store_lock(store)) {
+        ERROR("store_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    *stats = store->lock_stats;
+    if (mtx_unlock(&store->mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+
+    return SA_STATUS_OK;
+}
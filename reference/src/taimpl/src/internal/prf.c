@@ -0,0 +1,586 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "prf.h" // NOLINT
+#include "common.h"
+#include "digest.h"
+#include "digest_internal.h"
+#include "log.h"
+#include "porting/memory.h"
+#include <memory.h>
+#include <openssl/evp.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include <openssl/core_names.h>
+#else
+#include <openssl/cmac.h>
+#endif
+
+typedef enum {
+    PRF_TYPE_HMAC,
+    PRF_TYPE_CMAC,
+    PRF_TYPE_DIGEST
+} prf_type;
+
+struct prf_s {
+    prf_type type;
+    size_t length;
+
+    // Keyed state for PRF_TYPE_DIGEST and, before OpenSSL 3, PRF_TYPE_HMAC.
+    EVP_MD_CTX* md_base;
+    EVP_MD_CTX* md_work;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    EVP_MAC_CTX* mac_base;
+    EVP_MAC_CTX* mac_work;
+#else
+    EVP_PKEY* hmac_key;
+    CMAC_CTX* cmac_base;
+    CMAC_CTX* cmac_work;
+#endif
+};
+
+static prf_t* prf_alloc(
+        prf_type type,
+        size_t length) {
+
+    prf_t* prf = memory_internal_alloc(sizeof(prf_t));
+    if (prf == NULL) {
+        ERROR("memory_internal_alloc failed");
+        return NULL;
+    }
+
+    memory_memset_unoptimizable(prf, 0, sizeof(prf_t));
+    prf->type = type;
+    prf->length = length;
+    return prf;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+static EVP_MAC_CTX* mac_create(
+        const char* name,
+        const OSSL_PARAM* params,
+        const void* key,
+        size_t key_length) {
+
+    EVP_MAC* evp_mac = NULL;
+    EVP_MAC_CTX* evp_mac_ctx = NULL;
+    EVP_MAC_CTX* result = NULL;
+    do {
+        evp_mac = EVP_MAC_fetch(NULL, name, NULL);
+        if (evp_mac == NULL) {
+            ERROR("EVP_MAC_fetch failed");
+            break;
+        }
+
+        evp_mac_ctx = EVP_MAC_CTX_new(evp_mac);
+        if (evp_mac_ctx == NULL) {
+            ERROR("EVP_MAC_CTX_new failed");
+            break;
+        }
+
+        if (EVP_MAC_init(evp_mac_ctx, key, key_length, params) != 1) {
+            ERROR("EVP_MAC_init failed");
+            break;
+        }
+
+        result = evp_mac_ctx;
+        evp_mac_ctx = NULL;
+    } while (false);
+
+    EVP_MAC_CTX_free(evp_mac_ctx);
+    EVP_MAC_free(evp_mac);
+    return result;
+}
+#endif
+
+prf_t* prf_create_hmac(
+        sa_digest_algorithm digest_algorithm,
+        const void* key,
+        size_t key_length) {
+
+    if (key == NULL && key_length > 0) {
+        ERROR("NULL key");
+        return NULL;
+    }
+
+    size_t length = digest_length(digest_algorithm);
+    if (length > DIGEST_MAX_LENGTH) {
+        ERROR("Invalid digest");
+        return NULL;
+    }
+
+    // An empty HMAC key is equivalent to a single zero byte key since the key is zero padded to the block size.
+    char zero = 0;
+    if (key == NULL || key_length == 0) {
+        key = &zero;
+        key_length = 1;
+    }
+
+    prf_t* prf = prf_alloc(PRF_TYPE_HMAC, length);
+    if (prf == NULL) {
+        ERROR("prf_alloc failed");
+        return NULL;
+    }
+
+    bool status = false;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    do {
+        OSSL_PARAM params[] = {
+                OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char*) digest_string(digest_algorithm), 0),
+                OSSL_PARAM_construct_end()};
+
+        prf->mac_base = mac_create("HMAC", params, key, key_length);
+        if (prf->mac_base == NULL) {
+            ERROR("mac_create failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+#else
+    do {
+        const EVP_MD* md = digest_mechanism(digest_algorithm);
+        if (md == NULL) {
+            ERROR("digest_mechanism failed");
+            break;
+        }
+
+        prf->hmac_key = EVP_PKEY_new_mac_key(EVP_PKEY_HMAC, NULL, key, (int) key_length);
+        if (prf->hmac_key == NULL) {
+            ERROR("EVP_PKEY_new_mac_key failed");
+            break;
+        }
+
+        prf->md_base = EVP_MD_CTX_create();
+        prf->md_work = EVP_MD_CTX_create();
+        if (prf->md_base == NULL || prf->md_work == NULL) {
+            ERROR("EVP_MD_CTX_create failed");
+            break;
+        }
+
+        if (EVP_DigestSignInit(prf->md_base, NULL, md, NULL, prf->hmac_key) != 1) {
+            ERROR("EVP_DigestSignInit failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+#endif
+
+    if (!status) {
+        prf_free(prf);
+        return NULL;
+    }
+
+    return prf;
+}
+
+prf_t* prf_create_cmac(
+        const void* key,
+        size_t key_length) {
+
+    if (key == NULL) {
+        ERROR("NULL key");
+        return NULL;
+    }
+
+    if (key_length != SYM_128_KEY_SIZE && key_length != SYM_256_KEY_SIZE) {
+        ERROR("Invalid key_length: %zu", key_length);
+        return NULL;
+    }
+
+    prf_t* prf = prf_alloc(PRF_TYPE_CMAC, AES_BLOCK_SIZE);
+    if (prf == NULL) {
+        ERROR("prf_alloc failed");
+        return NULL;
+    }
+
+    bool status = false;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    do {
+        OSSL_PARAM params[] = {
+                OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_CIPHER,
+                        (key_length == SYM_128_KEY_SIZE) ? "aes-128-cbc" : "aes-256-cbc", 0),
+                OSSL_PARAM_construct_end()};
+
+        prf->mac_base = mac_create("CMAC", params, key, key_length);
+        if (prf->mac_base == NULL) {
+            ERROR("mac_create failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+#else
+    do {
+        prf->cmac_base = CMAC_CTX_new();
+        prf->cmac_work = CMAC_CTX_new();
+        if (prf->cmac_base == NULL || prf->cmac_work == NULL) {
+            ERROR("CMAC_CTX_new failed");
+            break;
+        }
+
+        const EVP_CIPHER* cipher = (key_length == SYM_128_KEY_SIZE) ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+        if (CMAC_Init(prf->cmac_base, key, key_length, cipher, NULL) != 1) {
+            ERROR("CMAC_Init failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+#endif
+
+    if (!status) {
+        prf_free(prf);
+        return NULL;
+    }
+
+    return prf;
+}
+
+prf_t* prf_create_digest(
+        sa_digest_algorithm digest_algorithm,
+        const void* prefix,
+        size_t prefix_length) {
+
+    if (prefix == NULL && prefix_length > 0) {
+        ERROR("NULL prefix");
+        return NULL;
+    }
+
+    size_t length = digest_length(digest_algorithm);
+    if (length > DIGEST_MAX_LENGTH) {
+        ERROR("Invalid digest");
+        return NULL;
+    }
+
+    prf_t* prf = prf_alloc(PRF_TYPE_DIGEST, length);
+    if (prf == NULL) {
+        ERROR("prf_alloc failed");
+        return NULL;
+    }
+
+    bool status = false;
+    do {
+        const EVP_MD* md = digest_mechanism(digest_algorithm);
+        if (md == NULL) {
+            ERROR("digest_mechanism failed");
+            break;
+        }
+
+        prf->md_base = EVP_MD_CTX_create();
+        prf->md_work = EVP_MD_CTX_create();
+        if (prf->md_base == NULL || prf->md_work == NULL) {
+            ERROR("EVP_MD_CTX_create failed");
+            break;
+        }
+
+        if (EVP_DigestInit_ex(prf->md_base, md, NULL) != 1) {
+            ERROR("EVP_DigestInit_ex failed");
+            break;
+        }
+
+        if (prefix_length > 0) {
+            if (EVP_DigestUpdate(prf->md_base, prefix, prefix_length) != 1) {
+                ERROR("EVP_DigestUpdate failed");
+                break;
+            }
+        }
+
+        status = true;
+    } while (false);
+
+    if (!status) {
+        prf_free(prf);
+        return NULL;
+    }
+
+    return prf;
+}
+
+size_t prf_get_length(const prf_t* prf) {
+    if (prf == NULL) {
+        ERROR("NULL prf");
+        return 0;
+    }
+
+    return prf->length;
+}
+
+static bool prf_begin(prf_t* prf) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    if (prf->type != PRF_TYPE_DIGEST) {
+        EVP_MAC_CTX_free(prf->mac_work);
+        prf->mac_work = EVP_MAC_CTX_dup(prf->mac_base);
+        if (prf->mac_work == NULL) {
+            ERROR("EVP_MAC_CTX_dup failed");
+            return false;
+        }
+
+        return true;
+    }
+#else
+    if (prf->type == PRF_TYPE_CMAC) {
+        if (CMAC_CTX_copy(prf->cmac_work, prf->cmac_base) != 1) {
+            ERROR("CMAC_CTX_copy failed");
+            return false;
+        }
+
+        return true;
+    }
+#endif
+
+    if (EVP_MD_CTX_copy_ex(prf->md_work, prf->md_base) != 1) {
+        ERROR("EVP_MD_CTX_copy_ex failed");
+        return false;
+    }
+
+    return true;
+}
+
+static bool prf_update(
+        prf_t* prf,
+        const void* in,
+        size_t in_length) {
+
+    if (in_length == 0)
+        return true;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    if (prf->type != PRF_TYPE_DIGEST) {
+        if (EVP_MAC_update(prf->mac_work, in, in_length) != 1) {
+            ERROR("EVP_MAC_update failed");
+            return false;
+        }
+
+        return true;
+    }
+#else
+    if (prf->type == PRF_TYPE_CMAC) {
+        if (CMAC_Update(prf->cmac_work, in, in_length) != 1) {
+            ERROR("CMAC_Update failed");
+            return false;
+        }
+
+        return true;
+    }
+
+    if (prf->type == PRF_TYPE_HMAC) {
+        if (EVP_DigestSignUpdate(prf->md_work, in, in_length) != 1) {
+            ERROR("EVP_DigestSignUpdate failed");
+            return false;
+        }
+
+        return true;
+    }
+#endif
+
+    if (EVP_DigestUpdate(prf->md_work, in, in_length) != 1) {
+        ERROR("EVP_DigestUpdate failed");
+        return false;
+    }
+
+    return true;
+}
+
+static bool prf_finish(
+        void* out,
+        prf_t* prf) {
+
+    size_t length = prf->length;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    if (prf->type != PRF_TYPE_DIGEST) {
+        if (EVP_MAC_final(prf->mac_work, out, &length, prf->length) != 1) {
+            ERROR("EVP_MAC_final failed");
+            return false;
+        }
+
+        return true;
+    }
+#else
+    if (prf->type == PRF_TYPE_CMAC) {
+        if (CMAC_Final(prf->cmac_work, out, &length) != 1) {
+            ERROR("CMAC_Final failed");
+            return false;
+        }
+
+        return true;
+    }
+
+    if (prf->type == PRF_TYPE_HMAC) {
+        if (EVP_DigestSignFinal(prf->md_work, out, &length) != 1) {
+            ERROR("EVP_DigestSignFinal failed");
+            return false;
+        }
+
+        return true;
+    }
+#endif
+
+    unsigned int digest_length = length;
+    if (EVP_DigestFinal_ex(prf->md_work, out, &digest_length) != 1) {
+        ERROR("EVP_DigestFinal_ex failed");
+        return false;
+    }
+
+    return true;
+}
+
+sa_status prf_compute(
+        void* out,
+        prf_t* prf,
+        const void* in1,
+        size_t in1_length,
+        const void* in2,
+        size_t in2_length,
+        const void* in3,
+        size_t in3_length) {
+
+    if (out == NULL) {
+        ERROR("NULL out");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (prf == NULL) {
+        ERROR("NULL prf");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in1 == NULL && in1_length > 0) {
+        ERROR("NULL in1");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in2 == NULL && in2_length > 0) {
+        ERROR("NULL in2");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in3 == NULL && in3_length > 0) {
+        ERROR("NULL in3");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (!prf_begin(prf) ||
+            !prf_update(prf, in1, in1_length) ||
+            !prf_update(prf, in2, in2_length) ||
+            !prf_update(prf, in3, in3_length) ||
+            !prf_finish(out, prf)) {
+        ERROR("prf computation failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    return SA_STATUS_OK;
+}
+
+sa_status prf_expand(
+        void* out,
+        size_t out_length,
+        prf_t* prf,
+        uint32_t counter_start,
+        size_t counter_length,
+        bool counter_first,
+        bool feedback,
+        const void* in1,
+        size_t in1_length,
+        const void* in2,
+        size_t in2_length) {
+
+    if (out == NULL) {
+        ERROR("NULL out");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (prf == NULL) {
+        ERROR("NULL prf");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in1 == NULL && in1_length > 0) {
+        ERROR("NULL in1");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in2 == NULL && in2_length > 0) {
+        ERROR("NULL in2");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (counter_length != 1 && counter_length != 4) {
+        ERROR("Invalid counter_length: %zu", counter_length);
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t remainder = out_length % prf->length;
+    size_t blocks = out_length / prf->length + (remainder ? 1 : 0);
+    if (blocks > PRF_MAX_BLOCKS) {
+        ERROR("Invalid out_length: %zu", out_length);
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t counter_max = (counter_length == 1) ? 0xff : UINT32_MAX;
+    if (blocks > 0 && (counter_start > counter_max || blocks - 1 > counter_max - counter_start)) {
+        ERROR("Invalid counter_start: %u", counter_start);
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_status status = SA_STATUS_OK;
+    uint8_t block[DIGEST_MAX_LENGTH];
+    uint8_t* out_bytes = out;
+    for (size_t i = 0; i < blocks; i++) {
+        uint32_t counter = counter_start + i;
+        uint8_t encoded_counter[4] = {counter >> 24, counter >> 16, counter >> 8, counter};
+        const uint8_t* counter_bytes = encoded_counter + sizeof(encoded_counter) - counter_length;
+
+        if (!prf_begin(prf) ||
+                (feedback && i > 0 && !prf_update(prf, block, prf->length)) ||
+                (counter_first && !prf_update(prf, counter_bytes, counter_length)) ||
+                !prf_update(prf, in1, in1_length) ||
+                !prf_update(prf, in2, in2_length) ||
+                (!counter_first && !prf_update(prf, counter_bytes, counter_length)) ||
+                !prf_finish(block, prf)) {
+            ERROR("prf computation failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        size_t copy_length = (i == blocks - 1 && remainder > 0) ? remainder : prf->length;
+        memcpy(out_bytes, block, copy_length);
+        out_bytes += copy_length;
+    }
+
+    memory_memset_unoptimizable(block, 0, sizeof(block));
+    return status;
+}
+
+void prf_free(prf_t* prf) {
+    if (prf == NULL) {
+        return;
+    }
+
+    EVP_MD_CTX_destroy(prf->md_base);
+    EVP_MD_CTX_destroy(prf->md_work);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+    EVP_MAC_CTX_free(prf->mac_base);
+    EVP_MAC_CTX_free(prf->mac_work);
+#else
+    EVP_PKEY_free(prf->hmac_key);
+    CMAC_CTX_free(prf->cmac_base);
+    CMAC_CTX_free(prf->cmac_work);
+#endif
+    memory_internal_free(prf);
+}
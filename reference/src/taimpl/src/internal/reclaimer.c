@@ -0,0 +1,268 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "reclaimer.h" // NOLINT
+#include "log.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+
+// Waking the reclaimer costs a futex call per wake, more than most frees, so it is woken once per burst of releases
+// and then collects entries for up to RECLAIMER_BATCH_DELAY_NS, or until RECLAIMER_WAKE_THRESHOLD are queued, before
+// draining the queue.
+#define RECLAIMER_WAKE_THRESHOLD 32
+#define RECLAIMER_BATCH_DELAY_NS 1000000
+
+typedef struct {
+    object_free_function object_free;
+    void* object;
+} reclaim_entry_t;
+
+static once_flag flag = ONCE_FLAG_INIT;
+static mtx_t mutex;
+// signaled when the queue stops being empty, when it reaches RECLAIMER_WAKE_THRESHOLD, and on flush
+static cnd_t queued;
+// signaled when the queue is empty and no entry is being freed
+static cnd_t idle;
+// set once the mutex and condition variables can be used
+static atomic_bool initialized = false;
+
+// protected by mutex
+static reclaim_entry_t queue[RECLAIMER_QUEUE_SIZE];
+static size_t head = 0;
+static size_t length = 0;
+static size_t in_flight = 0;
+static size_t flush_waiters = 0;
+static reclaimer_stats_t stats;
+// cleared in the child after a fork, which does not inherit the reclaimer thread
+static bool thread_started = false;
+// set on exit, after which objects are freed by the calling thread
+static bool stopped = false;
+
+static thread_local bool is_reclaimer_thread = false;
+
+// Must be called with the mutex held.
+static reclaim_entry_t pop() {
+    reclaim_entry_t entry = queue[head];
+    head = (head + 1) % RECLAIMER_QUEUE_SIZE;
+    length--;
+    return entry;
+}
+
+// Must be called with the mutex held, which is released while each object is freed.
+static void free_queued() {
+    while (length > 0) {
+        reclaim_entry_t entry = pop();
+        in_flight++;
+        mtx_unlock(&mutex);
+
+        entry.object_free(entry.object);
+
+        mtx_lock(&mutex);
+        in_flight--;
+        stats.deferred++;
+    }
+}
+
+static int reclaimer_main(void* arg) {
+    is_reclaimer_thread = true;
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return 0;
+    }
+
+    while (true) {
+        while (length == 0) {
+            if (cnd_wait(&queued, &mutex) != thrd_success) {
+                ERROR("cnd_wait failed");
+                mtx_unlock(&mutex);
+                return 0;
+            }
+        }
+
+        if (length < RECLAIMER_WAKE_THRESHOLD && flush_waiters == 0) {
+            struct timespec deadline;
+            timespec_get(&deadline, TIME_UTC);
+            deadline.tv_nsec += RECLAIMER_BATCH_DELAY_NS;
+            if (deadline.tv_nsec >= 1000000000) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            cnd_timedwait(&queued, &mutex, &deadline);
+        }
+
+        free_queued();
+        cnd_broadcast(&idle);
+    }
+}
+
+// Must be called with the mutex held.
+static bool start_thread() {
+    if (thread_started)
+        return true;
+
+    thrd_t thread;
+    if (thrd_create(&thread, reclaimer_main, NULL) != thrd_success) {
+        ERROR("thrd_create failed");
+        return false;
+    }
+
+    thrd_detach(thread);
+    thread_started = true;
+    return true;
+}
+
+// Must be called with the mutex held. Returns once every queued object has been freed.
+static void drain() {
+    if (is_reclaimer_thread || !thread_started) {
+        // A free function is flushing, for example by shutting down a store, or there is no reclaimer thread in a
+        // forked child. Waiting would never return, so drain the queue on this thread instead.
+        free_queued();
+        cnd_broadcast(&idle);
+        return;
+    }
+
+    flush_waiters++;
+    cnd_signal(&queued);
+    while (length > 0 || in_flight > 0) {
+        if (cnd_wait(&idle, &mutex) != thrd_success) {
+            ERROR("cnd_wait failed");
+            break;
+        }
+    }
+
+    flush_waiters--;
+}
+
+// Runs before the exit handlers registered earlier, such as the symmetric context pool shutdown, tear down what the
+// free functions use, so that no key is left unwiped in the queue.
+static void reclaimer_shutdown() {
+    if (mtx_lock(&mutex) != thrd_success)
+        return;
+
+    drain();
+    stopped = true;
+    mtx_unlock(&mutex);
+}
+
+// Holding the mutex across fork keeps the queue consistent in the child.
+static void fork_prepare() {
+    mtx_lock(&mutex);
+}
+
+static void fork_parent() {
+    mtx_unlock(&mutex);
+}
+
+// Only the forking thread exists in the child. The queue is kept, and is drained by a new reclaimer thread started on
+// the next reclaimer_defer or by reclaimer_flush. An object the parent's reclaimer was freeing is lost in the child.
+static void fork_child() {
+    thread_started = false;
+    in_flight = 0;
+    flush_waiters = 0;
+    cnd_init(&queued);
+    cnd_init(&idle);
+    mtx_unlock(&mutex);
+}
+
+static void reclaimer_init() {
+    if (mtx_init(&mutex, mtx_plain) != thrd_success) {
+        ERROR("mtx_init failed");
+        return;
+    }
+
+    if (cnd_init(&queued) != thrd_success || cnd_init(&idle) != thrd_success) {
+        ERROR("cnd_init failed");
+        return;
+    }
+
+    if (pthread_atfork(fork_prepare, fork_parent, fork_child) != 0) {
+        ERROR("pthread_atfork failed");
+        return;
+    }
+
+    if (atexit(reclaimer_shutdown) != 0) {
+        ERROR("atexit failed");
+        return;
+    }
+
+    atomic_store(&initialized, true);
+}
+
+void reclaimer_defer(
+        object_free_function object_free,
+        void* object) {
+
+    if (object_free == NULL || object == NULL)
+        return;
+
+    call_once(&flag, reclaimer_init);
+    bool deferred = false;
+    if (atomic_load(&initialized) && mtx_lock(&mutex) == thrd_success) {
+        if (!stopped && length < RECLAIMER_QUEUE_SIZE && start_thread()) {
+            queue[(head + length) % RECLAIMER_QUEUE_SIZE] = (reclaim_entry_t){object_free, object};
+            length++;
+            deferred = true;
+            if (length == 1 || length == RECLAIMER_WAKE_THRESHOLD)
+                cnd_signal(&queued);
+        } else {
+            stats.freed_inline++;
+        }
+
+        mtx_unlock(&mutex);
+    }
+
+    // back pressure: the caller pays for the free when the reclaimer cannot keep up
+    if (!deferred)
+        object_free(object);
+}
+
+void reclaimer_flush() {
+    // Nothing can have been queued before the reclaimer was initialized.
+    if (!atomic_load(&initialized) || mtx_lock(&mutex) != thrd_success)
+        return;
+
+    drain();
+    mtx_unlock(&mutex);
+}
+
+sa_status reclaimer_get_stats(reclaimer_stats_t* reclaimer_stats) {
+    if (reclaimer_stats == NULL) {
+        ERROR("NULL reclaimer_stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (!atomic_load(&initialized)) {
+        *reclaimer_stats = (reclaimer_stats_t){0};
+        return SA_STATUS_OK;
+    }
+
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    *reclaimer_stats = stats;
+    reclaimer_stats->queued = length;
+    mtx_unlock(&mutex);
+    return SA_STATUS_OK;
+}
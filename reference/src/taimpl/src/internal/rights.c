@@ -19,6 +19,7 @@
 #include "rights.h" // NOLINT
 #include "log.h"
 #include "porting/memory.h"
+#include "video_output_state.h"
 #include <memory.h>
 #include <time.h>
 
@@ -39,8 +40,8 @@ static bool validate_video_output_state(const sa_rights* rights) {
     }
 
     video_output_state_t video_output_state;
-    if (!video_output_poll(&video_output_state)) {
-        ERROR("video_output_poll failed");
+    if (!video_output_state_get(&video_output_state, NULL)) {
+        ERROR("video_output_state_get failed");
         return false;
     }
 
@@ -292,6 +293,112 @@ bool rights_allowed_video_output_state(
     return true;
 }
 
+static uint64_t coarse_time() {
+#ifdef CLOCK_REALTIME_COARSE
+    struct timespec now;
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &now) == 0)
+        return now.tv_sec;
+#endif
+
+    return time(NULL);
+}
+
+static void verdict_update_video_output(
+        rights_verdict_t* verdict,
+        const sa_rights* rights) {
+
+    // state and generation come from the same snapshot, so the verdict is exact for the generation
+    video_output_state_t video_output_state;
+    uint64_t generation;
+    if (!video_output_state_get(&video_output_state, &generation)) {
+        ERROR("video_output_state_get failed");
+        verdict->video_output_generation = 0;
+        verdict->verdict &= ~RIGHTS_VERDICT_VIDEO_OUTPUT;
+        return;
+    }
+
+    verdict->video_output_generation = generation;
+    if (rights_allowed_video_output_state(rights, &video_output_state))
+        verdict->verdict |= RIGHTS_VERDICT_VIDEO_OUTPUT;
+    else
+        verdict->verdict &= ~RIGHTS_VERDICT_VIDEO_OUTPUT;
+}
+
+static bool verdict_allowed(
+        rights_verdict_t* verdict,
+        const sa_rights* rights,
+        uint32_t operation) {
+
+    if (verdict == NULL) {
+        ERROR("NULL verdict");
+        return false;
+    }
+
+    if (rights == NULL) {
+        ERROR("NULL rights");
+        return false;
+    }
+
+    if ((verdict->verdict & operation) == 0) {
+        ERROR("Usage flag is not set");
+        return false;
+    }
+
+    uint64_t now = coarse_time();
+    if (now < verdict->not_before || now >= verdict->not_on_or_after) {
+        ERROR("Current time is outside of key validity window");
+        return false;
+    }
+
+    if (verdict->video_output_generation != video_output_state_generation())
+        verdict_update_video_output(verdict, rights);
+
+    if ((verdict->verdict & RIGHTS_VERDICT_VIDEO_OUTPUT) == 0) {
+        ERROR("validate_video_output_state failed");
+        return false;
+    }
+
+    return true;
+}
+
+void rights_verdict_init(
+        rights_verdict_t* verdict,
+        const sa_rights* rights) {
+
+    if (verdict == NULL) {
+        ERROR("NULL verdict");
+        return;
+    }
+
+    verdict->verdict = 0;
+    if (rights == NULL) {
+        ERROR("NULL rights");
+        return;
+    }
+
+    if (SA_USAGE_BIT_TEST(rights->usage_flags, SA_USAGE_FLAG_ENCRYPT))
+        verdict->verdict |= RIGHTS_VERDICT_ENCRYPT;
+
+    if (SA_USAGE_BIT_TEST(rights->usage_flags, SA_USAGE_FLAG_DECRYPT))
+        verdict->verdict |= RIGHTS_VERDICT_DECRYPT;
+
+    verdict->not_before = rights->not_before;
+    verdict->not_on_or_after = rights->not_on_or_after;
+    verdict_update_video_output(verdict, rights);
+}
+
+bool rights_verdict_allowed_encrypt(
+        rights_verdict_t* verdict,
+        const sa_rights* rights) {
+    return verdict_allowed(verdict, rights, RIGHTS_VERDICT_ENCRYPT);
+}
+
+bool rights_verdict_allowed_decrypt(
+        rights_verdict_t* verdict,
+        const sa_rights* rights) {
+    return verdict_allowed(verdict, rights, RIGHTS_VERDICT_DECRYPT);
+}
+
 bool rights_allowed_uuid(
         const sa_rights* rights,
         const sa_uuid* caller_uuid) {
@@ -296,15 +296,16 @@ sa_status rsa_decrypt_oaep(
         }
 
         if (label != NULL && label_length > 0) {
-            uint8_t* new_label = memory_secure_alloc(label_length);
+            // OpenSSL takes ownership of the label and releases it with OPENSSL_free.
+            uint8_t* new_label = OPENSSL_malloc(label_length);
             if (new_label == NULL) {
-                ERROR("memory_secure_alloc failed");
+                ERROR("OPENSSL_malloc failed");
                 break;
             }
 
             memcpy(new_label, label, label_length);
             if (EVP_PKEY_CTX_set0_rsa_oaep_label(evp_pkey_ctx, new_label, (int) label_length) != 1) {
-                memory_secure_free(new_label);
+                OPENSSL_free(new_label);
                 ERROR("EVP_PKEY_CTX_set0_rsa_oaep_label failed");
                 break;
             }
@@ -73,6 +73,20 @@ typedef struct {
     key_ladder_inputs_t key_ladder_inputs;
 } soc_kc_payload_t;
 
+typedef enum {
+    SOC_KC_PAYLOAD_FIELD_CONTAINER_VERSION = 0,
+    SOC_KC_PAYLOAD_FIELD_KEY_TYPE,
+    SOC_KC_PAYLOAD_FIELD_ENCRYPTED_KEY,
+    SOC_KC_PAYLOAD_FIELD_IV,
+    SOC_KC_PAYLOAD_FIELD_KEY_USAGE,
+    SOC_KC_PAYLOAD_FIELD_DECRYPTED_KEY_USAGE,
+    SOC_KC_PAYLOAD_FIELD_ENTITLED_TA_IDS,
+    SOC_KC_PAYLOAD_FIELD_C1,
+    SOC_KC_PAYLOAD_FIELD_C2,
+    SOC_KC_PAYLOAD_FIELD_C3,
+    SOC_KC_PAYLOAD_FIELD_COUNT
+} soc_kc_payload_field_e;
+
 static soc_kc_unpacked_t* soc_kc_unpacked_create() {
     soc_kc_unpacked_t* unpacked = memory_internal_alloc(sizeof(soc_kc_unpacked_t));
     if (unpacked == NULL) {
@@ -265,12 +279,12 @@ static sa_status fields_to_rights(
 }
 
 static sa_status parse_header(
-        json_key_value_t* fields,
-        size_t fields_count,
+        void* in,
+        size_t in_length,
         soc_kc_header_t* header) {
 
-    if (fields == NULL) {
-        ERROR("fields NULL");
+    if (in == NULL) {
+        ERROR("in NULL");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
@@ -279,29 +293,30 @@ static sa_status parse_header(
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    // read alg
-    const json_key_value_t* alg_field = json_key_value_find("alg", fields, fields_count);
-    if (alg_field == NULL) {
-        ERROR("json_key_value_find failed");
+    json_field_t alg_field = {.key = "alg", .type = JSON_FIELD_STRING};
+    if (!json_extract_fields(&alg_field, 1, in, in_length)) {
+        ERROR("json_extract_fields failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    header->alg = json_value_as_string(&header->alg_size, alg_field->value);
-    if (header->alg == NULL) {
-        ERROR("Invalid alg value value");
+    // read alg
+    if (!alg_field.found) {
+        ERROR("Missing alg");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
+    header->alg = alg_field.string.string;
+    header->alg_size = alg_field.string.length;
     return SA_STATUS_OK;
 }
 
 static sa_status parse_payload(
-        json_key_value_t* fields,
-        size_t fields_count,
+        void* in,
+        size_t in_length,
         soc_kc_payload_t* payload) {
 
-    if (fields == NULL) {
-        ERROR("fields NULL");
+    if (in == NULL) {
+        ERROR("in NULL");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
@@ -310,154 +325,153 @@ static sa_status parse_payload(
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    // read container version
-    const json_key_value_t* container_version_field = json_key_value_find("containerVersion", fields, fields_count);
-    if (container_version_field == NULL) {
-        ERROR("json_key_value_find failed");
+    json_slice_t entitled_ta_ids[MAX_NUM_ALLOWED_TA_IDS];
+    json_field_t fields[SOC_KC_PAYLOAD_FIELD_COUNT] = {
+            [SOC_KC_PAYLOAD_FIELD_CONTAINER_VERSION] = {.key = "containerVersion", .type = JSON_FIELD_INTEGER},
+            [SOC_KC_PAYLOAD_FIELD_KEY_TYPE] = {.key = "keyType", .type = JSON_FIELD_STRING},
+            [SOC_KC_PAYLOAD_FIELD_ENCRYPTED_KEY] = {.key = "encryptedKey", .type = JSON_FIELD_STRING},
+            [SOC_KC_PAYLOAD_FIELD_IV] = {.key = "iv", .type = JSON_FIELD_STRING},
+            [SOC_KC_PAYLOAD_FIELD_KEY_USAGE] = {.key = "keyUsage", .type = JSON_FIELD_INTEGER},
+            [SOC_KC_PAYLOAD_FIELD_DECRYPTED_KEY_USAGE] = {.key = "decryptedKeyUsage", .type = JSON_FIELD_INTEGER},
+            [SOC_KC_PAYLOAD_FIELD_ENTITLED_TA_IDS] = {.key = "entitledTaIds", .type = JSON_FIELD_STRING_ARRAY,
+                    .strings = entitled_ta_ids, .strings_capacity = MAX_NUM_ALLOWED_TA_IDS},
+            [SOC_KC_PAYLOAD_FIELD_C1] = {.key = "c1", .type = JSON_FIELD_STRING},
+            [SOC_KC_PAYLOAD_FIELD_C2] = {.key = "c2", .type = JSON_FIELD_STRING},
+            [SOC_KC_PAYLOAD_FIELD_C3] = {.key = "c3", .type = JSON_FIELD_STRING}};
+    if (!json_extract_fields(fields, SOC_KC_PAYLOAD_FIELD_COUNT, in, in_length)) {
+        ERROR("json_extract_fields failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    payload->container_version = json_value_as_integer(container_version_field->value);
-
-    // read key type
-    const json_key_value_t* key_type_field = json_key_value_find("keyType", fields, fields_count);
-    if (key_type_field == NULL) {
-        ERROR("json_key_value_find failed");
+    // read container version
+    const json_field_t* container_version_field = &fields[SOC_KC_PAYLOAD_FIELD_CONTAINER_VERSION];
+    if (!container_version_field->found) {
+        ERROR("Missing containerVersion");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    payload->key_type_string = json_value_as_string(&payload->key_type_string_length, key_type_field->value);
-    if (payload->key_type_string == NULL) {
+    payload->container_version = container_version_field->integer;
+
+    // read key type
+    const json_field_t* key_type_field = &fields[SOC_KC_PAYLOAD_FIELD_KEY_TYPE];
+    if (!key_type_field->found) {
         ERROR("Missing keyType");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
+    payload->key_type_string = key_type_field->string.string;
+    payload->key_type_string_length = key_type_field->string.length;
+
     // read encrypted key
-    const json_key_value_t* encrypted_key_field = json_key_value_find("encryptedKey", fields, fields_count);
-    if (encrypted_key_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* encrypted_key_field = &fields[SOC_KC_PAYLOAD_FIELD_ENCRYPTED_KEY];
+    if (!encrypted_key_field->found) {
+        ERROR("Missing encryptedKey");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t b64_encrypted_key_length;
-    const char* encrypted_key = json_value_as_string(&b64_encrypted_key_length, encrypted_key_field->value);
-    payload->encrypted_key_length = b64_decoded_length(b64_encrypted_key_length);
+    payload->encrypted_key_length = b64_decoded_length(encrypted_key_field->string.length);
     payload->encrypted_key = memory_internal_alloc(payload->encrypted_key_length);
     if (payload->encrypted_key == NULL) {
         ERROR("memory_internal_alloc failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    if (!b64_decode(payload->encrypted_key, &payload->encrypted_key_length, encrypted_key, b64_encrypted_key_length,
-                false)) {
+    if (!b64_decode(payload->encrypted_key, &payload->encrypted_key_length, encrypted_key_field->string.string,
+                encrypted_key_field->string.length, false)) {
         ERROR("b64_decode failed");
         memory_internal_free(payload->encrypted_key);
+        payload->encrypted_key = NULL;
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read iv
-    const json_key_value_t* iv_field = json_key_value_find("iv", fields, fields_count);
-    if (iv_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* iv_field = &fields[SOC_KC_PAYLOAD_FIELD_IV];
+    if (!iv_field->found) {
+        ERROR("Missing iv");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t b64_iv_length;
-    const char* iv = json_value_as_string(&b64_iv_length, iv_field->value);
-    size_t iv_length = b64_decoded_length(b64_iv_length);
-    if (!b64_decode(payload->iv, &iv_length, iv, b64_iv_length, false) && iv_length != GCM_IV_LENGTH) {
+    size_t iv_length = b64_decoded_length(iv_field->string.length);
+    if (!b64_decode(payload->iv, &iv_length, iv_field->string.string, iv_field->string.length, false) &&
+            iv_length != GCM_IV_LENGTH) {
         ERROR("b64_decode failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read key usage
-    const json_key_value_t* key_usage_field = json_key_value_find("keyUsage", fields, fields_count);
-    if (key_usage_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* key_usage_field = &fields[SOC_KC_PAYLOAD_FIELD_KEY_USAGE];
+    if (!key_usage_field->found) {
+        ERROR("Missing keyUsage");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    payload->key_usage = json_value_as_integer(key_usage_field->value);
+    payload->key_usage = key_usage_field->integer;
 
     if (payload->key_usage == KEY_ONLY) {
         // read decrypted key usage
-        const json_key_value_t* decrypted_key_usage_field = json_key_value_find("decryptedKeyUsage", fields,
-                fields_count);
-        if (decrypted_key_usage_field == NULL) {
-            ERROR("json_key_value_find failed");
+        const json_field_t* decrypted_key_usage_field = &fields[SOC_KC_PAYLOAD_FIELD_DECRYPTED_KEY_USAGE];
+        if (!decrypted_key_usage_field->found) {
+            ERROR("Missing decryptedKeyUsage");
             return SA_STATUS_INVALID_KEY_FORMAT;
         }
 
-        payload->decrypted_key_usage = json_value_as_integer(decrypted_key_usage_field->value);
+        payload->decrypted_key_usage = decrypted_key_usage_field->integer;
     } else {
         payload->decrypted_key_usage = 0;
     }
 
     // read entitled TA IDs
-    json_value_t** entitled_ta_ids = NULL;
-    const json_key_value_t* entitled_ta_ids_field = json_key_value_find("entitledTaIds", fields, fields_count);
-    if (entitled_ta_ids_field == NULL) {
-        payload->entitled_ta_ids_length = 0;
-    } else {
-        entitled_ta_ids = json_value_as_array(&payload->entitled_ta_ids_length, entitled_ta_ids_field->value);
-        for (size_t i = 0; i < payload->entitled_ta_ids_length; i++) {
-            size_t ta_id_length;
-            const char* ta_id = json_value_as_string(&ta_id_length, entitled_ta_ids[i]);
-            if (ta_id_length != UUID_LENGTH) {
-                memory_internal_free(entitled_ta_ids);
-                ERROR("Invalid ta_id");
-                return SA_STATUS_INVALID_KEY_FORMAT;
-            }
-
-            memcpy(payload->entitled_ta_ids[i].ta_id, ta_id, ta_id_length);
+    const json_field_t* entitled_ta_ids_field = &fields[SOC_KC_PAYLOAD_FIELD_ENTITLED_TA_IDS];
+    payload->entitled_ta_ids_length = entitled_ta_ids_field->strings_length;
+    for (size_t i = 0; i < payload->entitled_ta_ids_length; i++) {
+        if (entitled_ta_ids[i].length != UUID_LENGTH) {
+            ERROR("Invalid ta_id");
+            return SA_STATUS_INVALID_KEY_FORMAT;
         }
 
-        memory_internal_free(entitled_ta_ids);
+        memcpy(payload->entitled_ta_ids[i].ta_id, entitled_ta_ids[i].string, UUID_LENGTH);
     }
 
     // read c1
-    const json_key_value_t* c1_field = json_key_value_find("c1", fields, fields_count);
-    if (c1_field == NULL) {
+    const json_field_t* c1_field = &fields[SOC_KC_PAYLOAD_FIELD_C1];
+    if (!c1_field->found) {
         ERROR("Missing c1");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t b64_c1_length;
-    const char* c1 = json_value_as_string(&b64_c1_length, c1_field->value);
-    size_t c1_length = b64_decoded_length(b64_c1_length);
-    if (!b64_decode(payload->key_ladder_inputs.c1, &c1_length, c1, b64_c1_length, false) &&
+    size_t c1_length = b64_decoded_length(c1_field->string.length);
+    if (!b64_decode(payload->key_ladder_inputs.c1, &c1_length, c1_field->string.string, c1_field->string.length,
+                false) &&
             c1_length != AES_BLOCK_SIZE) {
         ERROR("b64_decode failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read c2
-    const json_key_value_t* c2_field = json_key_value_find("c2", fields, fields_count);
-    if (c2_field == NULL) {
+    const json_field_t* c2_field = &fields[SOC_KC_PAYLOAD_FIELD_C2];
+    if (!c2_field->found) {
         ERROR("Missing c2");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t b64_c2_length;
-    const char* c2 = json_value_as_string(&b64_c2_length, c2_field->value);
-    size_t c2_length = b64_decoded_length(b64_c2_length);
-    if (!b64_decode(payload->key_ladder_inputs.c2, &c2_length, c2, b64_c2_length, true) &&
+    size_t c2_length = b64_decoded_length(c2_field->string.length);
+    if (!b64_decode(payload->key_ladder_inputs.c2, &c2_length, c2_field->string.string, c2_field->string.length,
+                true) &&
             c2_length != AES_BLOCK_SIZE) {
         ERROR("b64_decode failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read c3
-    const json_key_value_t* c3_field = json_key_value_find("c3", fields, fields_count);
-    if (c3_field == NULL) {
+    const json_field_t* c3_field = &fields[SOC_KC_PAYLOAD_FIELD_C3];
+    if (!c3_field->found) {
         ERROR("Missing c3");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t b64_c3_length;
-    const char* c3 = json_value_as_string(&b64_c3_length, c3_field->value);
-    size_t c3_length = b64_decoded_length(b64_c3_length);
-    if (!b64_decode(payload->key_ladder_inputs.c3, &c3_length, c3, b64_c3_length, false) &&
+    size_t c3_length = b64_decoded_length(c3_field->string.length);
+    if (!b64_decode(payload->key_ladder_inputs.c3, &c3_length, c3_field->string.string, c3_field->string.length,
+                false) &&
             c3_length != AES_BLOCK_SIZE) {
         ERROR("b64_decode failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
@@ -846,10 +860,6 @@ sa_status soc_kc_unwrap(
     }
 
     soc_kc_unpacked_t* unpacked = NULL;
-    json_value_t* json_header_value = NULL;
-    json_key_value_t* header_fields = NULL;
-    json_value_t* json_payload_value = NULL;
-    json_key_value_t* payload_fields = NULL;
     soc_kc_header_t header;
     soc_kc_payload_t payload;
 
@@ -863,39 +873,13 @@ sa_status soc_kc_unwrap(
         }
 
         // parse the header
-        json_header_value = json_parse_bytes(unpacked->header, unpacked->header_length);
-        if (json_header_value == NULL) {
-            ERROR("json_parse_bytes failed");
-            break;
-        }
-
-        size_t header_fields_count;
-        header_fields = json_value_as_map(&header_fields_count, json_header_value);
-        if (header_fields == NULL) {
-            ERROR("json_value_as_map failed");
-            break;
-        }
-
-        if (parse_header(header_fields, header_fields_count, &header) != SA_STATUS_OK) {
+        if (parse_header(unpacked->header, unpacked->header_length, &header) != SA_STATUS_OK) {
             ERROR("unpack_soc_kc failed");
             break;
         }
 
         // parse the payload
-        json_payload_value = json_parse_bytes(unpacked->payload, unpacked->payload_length);
-        if (json_payload_value == NULL) {
-            ERROR("json_parse_bytes failed");
-            break;
-        }
-
-        size_t payload_fields_count;
-        payload_fields = json_value_as_map(&payload_fields_count, json_payload_value);
-        if (payload_fields == NULL) {
-            ERROR("json_value_as_map failed");
-            break;
-        }
-
-        if (parse_payload(payload_fields, payload_fields_count, &payload) != SA_STATUS_OK) {
+        if (parse_payload(unpacked->payload, unpacked->payload_length, &payload) != SA_STATUS_OK) {
             ERROR("unpack_soc_kc failed");
             break;
         }
@@ -908,14 +892,6 @@ sa_status soc_kc_unwrap(
     } while (false);
 
     soc_kc_unpacked_free(unpacked);
-    if (json_header_value != NULL)
-        json_value_free(json_header_value);
-    if (header_fields != NULL)
-        memory_internal_free(header_fields);
-    if (json_payload_value != NULL)
-        json_value_free(json_payload_value);
-    if (payload_fields != NULL)
-        memory_internal_free(payload_fields);
     if (payload.encrypted_key != NULL)
         memory_internal_free(payload.encrypted_key);
     return status;
@@ -0,0 +1,296 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "stats.h" // NOLINT
+#include "log.h"
+#include "porting/memory.h"
+#include <memory.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <threads.h>
+#include <time.h>
+
+struct stats_command_s {
+    uint32_t countdown;
+    atomic_uint_fast64_t calls;
+    atomic_uint_fast64_t timed_calls;
+    atomic_uint_fast64_t param_bytes;
+    atomic_uint_fast64_t total_ns;
+    atomic_uint_fast64_t max_ns;
+    atomic_uint_fast64_t status_counts[STATS_STATUS_COUNT];
+    atomic_uint_fast64_t histogram[STATS_BUCKET_COUNT];
+};
+
+typedef struct stats_shard_s {
+    struct stats_shard_s* next;
+    atomic_bool in_use;
+    _Atomic(stats_command_t*) commands[STATS_MAX_COMMANDS];
+} stats_shard_t;
+
+static struct {
+    once_flag flag;
+    bool initialized;
+    tss_t shard_key;
+    _Atomic(stats_shard_t*) shards;
+} global_stats = {.flag = ONCE_FLAG_INIT};
+
+// The TA is linked into a shared library, where the default TLS model resolves the variable through a
+// call on every access. The initial-exec model reduces this to a single load.
+static _Thread_local stats_shard_t* thread_shard __attribute__((tls_model("initial-exec"))) = NULL;
+
+static void stats_shard_return(void* object) {
+    stats_shard_t* shard = object;
+    if (shard != NULL)
+        atomic_store_explicit(&shard->in_use, false, memory_order_release);
+}
+
+static void stats_init() {
+    if (tss_create(&global_stats.shard_key, stats_shard_return) != thrd_success) {
+        ERROR("tss_create failed");
+        return;
+    }
+
+    global_stats.initialized = true;
+}
+
+static stats_shard_t* stats_shard_acquire() {
+    call_once(&global_stats.flag, stats_init);
+    if (!global_stats.initialized)
+        return NULL;
+
+    // Shards are never freed. A shard released by an exited thread is handed to the next new thread
+    // so that the counters it holds keep contributing to the totals.
+    stats_shard_t* shard = atomic_load_explicit(&global_stats.shards, memory_order_acquire);
+    for (; shard != NULL; shard = shard->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&shard->in_use, &expected, true, memory_order_acquire,
+                    memory_order_relaxed))
+            break;
+    }
+
+    if (shard == NULL) {
+        shard = memory_internal_alloc(sizeof(stats_shard_t));
+        if (shard == NULL) {
+            ERROR("memory_internal_alloc failed");
+            return NULL;
+        }
+
+        memory_memset_unoptimizable(shard, 0, sizeof(stats_shard_t));
+        atomic_init(&shard->in_use, true);
+        stats_shard_t* head = atomic_load_explicit(&global_stats.shards, memory_order_relaxed);
+        do {
+            shard->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&global_stats.shards, &head, shard, memory_order_release,
+                memory_order_relaxed));
+    }
+
+    if (tss_set(global_stats.shard_key, shard) != thrd_success) {
+        ERROR("tss_set failed");
+        stats_shard_return(shard);
+        return NULL;
+    }
+
+    thread_shard = shard;
+    return shard;
+}
+
+static stats_command_t* stats_command(
+        stats_shard_t* shard,
+        SA_COMMAND_ID command_id) {
+
+    stats_command_t* command = atomic_load_explicit(&shard->commands[command_id], memory_order_relaxed);
+    if (command != NULL)
+        return command;
+
+    command = memory_internal_alloc(sizeof(stats_command_t));
+    if (command == NULL) {
+        ERROR("memory_internal_alloc failed");
+        return NULL;
+    }
+
+    memory_memset_unoptimizable(command, 0, sizeof(stats_command_t));
+    atomic_store_explicit(&shard->commands[command_id], command, memory_order_release);
+    return command;
+}
+
+// Counters are only written by the thread owning the shard, so a plain load and store is enough and
+// avoids a locked read-modify-write on the hot path. Readers may observe a value that is one call
+// behind.
+static inline void stats_add(
+        atomic_uint_fast64_t* counter,
+        uint64_t value) {
+
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+            memory_order_relaxed);
+}
+
+static uint64_t stats_now() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static stats_command_t* stats_lookup(SA_COMMAND_ID command_id) {
+    if ((size_t) command_id >= STATS_MAX_COMMANDS)
+        return NULL;
+
+    stats_shard_t* shard = thread_shard;
+    if (shard == NULL) {
+        shard = stats_shard_acquire();
+        if (shard == NULL)
+            return NULL;
+    }
+
+    return stats_command(shard, command_id);
+}
+
+stats_call_t stats_begin(SA_COMMAND_ID command_id) {
+    stats_call_t call = {stats_lookup(command_id), 0};
+    if (call.command == NULL)
+        return call;
+
+    // Reading the clock costs a significant fraction of a small command, so only every
+    // STATS_SAMPLE_INTERVAL-th call of each command is timed. The first call is always timed.
+    if (call.command->countdown > 0) {
+        call.command->countdown--;
+        return call;
+    }
+
+    call.command->countdown = STATS_SAMPLE_INTERVAL - 1;
+    call.start = stats_now();
+    return call;
+}
+
+size_t stats_bucket(uint64_t ns) {
+    if (ns < (1 << STATS_SUB_BUCKET_BITS))
+        return (size_t) ns;
+
+    size_t magnitude = 63 - __builtin_clzll(ns);
+    if (magnitude >= STATS_MAX_MAGNITUDE)
+        return STATS_BUCKET_COUNT - 1;
+
+    return ((magnitude - STATS_SUB_BUCKET_BITS + 1) << STATS_SUB_BUCKET_BITS) +
+           (size_t) (ns >> (magnitude - STATS_SUB_BUCKET_BITS)) - (1 << STATS_SUB_BUCKET_BITS);
+}
+
+void stats_record(
+        stats_call_t call,
+        sa_status status,
+        size_t param_bytes) {
+
+    stats_command_t* command = call.command;
+    if (command == NULL)
+        return;
+
+    stats_add(&command->calls, 1);
+    stats_add(&command->param_bytes, param_bytes);
+    if ((size_t) status < STATS_STATUS_COUNT)
+        stats_add(&command->status_counts[status], 1);
+
+    if (call.start == 0)
+        return;
+
+    uint64_t end = stats_now();
+    uint64_t elapsed = end > call.start ? end - call.start : 0;
+    stats_add(&command->timed_calls, 1);
+    stats_add(&command->total_ns, elapsed);
+    if (elapsed > atomic_load_explicit(&command->max_ns, memory_order_relaxed))
+        atomic_store_explicit(&command->max_ns, elapsed, memory_order_relaxed);
+
+    stats_add(&command->histogram[stats_bucket(elapsed)], 1);
+}
+
+sa_status stats_snapshot(
+        void* stats,
+        size_t* stats_length) {
+
+    if (stats_length == NULL) {
+        ERROR("NULL stats_length");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    const size_t record_length = sizeof(sa_stats_command) +
+                                 (STATS_STATUS_COUNT + STATS_BUCKET_COUNT) * sizeof(uint64_t);
+
+    // The required length covers every trackable command, so that a buffer sized by a previous call
+    // remains large enough when new commands are invoked in between.
+    const size_t required_length = sizeof(sa_stats_header) + (STATS_MAX_COMMANDS - 1) * record_length;
+    if (stats == NULL) {
+        *stats_length = required_length;
+        return SA_STATUS_OK;
+    }
+
+    if (*stats_length < required_length) {
+        ERROR("Invalid stats_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    stats_shard_t* shards = atomic_load_explicit(&global_stats.shards, memory_order_acquire);
+    uint8_t* record = (uint8_t*) stats + sizeof(sa_stats_header);
+    uint32_t command_count = 0;
+    for (size_t command_id = 1; command_id < STATS_MAX_COMMANDS; command_id++) {
+        sa_stats_command command = {
+                .command_id = command_id,
+                .record_length = record_length};
+        uint64_t* status_counts = (uint64_t*) (record + sizeof(sa_stats_command));
+        uint64_t* histogram = status_counts + STATS_STATUS_COUNT;
+        memset(status_counts, 0, (STATS_STATUS_COUNT + STATS_BUCKET_COUNT) * sizeof(uint64_t));
+
+        for (stats_shard_t* shard = shards; shard != NULL; shard = shard->next) {
+            stats_command_t* shard_command = atomic_load_explicit(&shard->commands[command_id],
+                    memory_order_acquire);
+            if (shard_command == NULL)
+                continue;
+
+            command.calls += atomic_load_explicit(&shard_command->calls, memory_order_relaxed);
+            command.timed_calls += atomic_load_explicit(&shard_command->timed_calls, memory_order_relaxed);
+            command.param_bytes += atomic_load_explicit(&shard_command->param_bytes, memory_order_relaxed);
+            command.total_ns += atomic_load_explicit(&shard_command->total_ns, memory_order_relaxed);
+            uint64_t max_ns = atomic_load_explicit(&shard_command->max_ns, memory_order_relaxed);
+            if (max_ns > command.max_ns)
+                command.max_ns = max_ns;
+
+            for (size_t i = 0; i < STATS_STATUS_COUNT; i++)
+                status_counts[i] += atomic_load_explicit(&shard_command->status_counts[i], memory_order_relaxed);
+
+            for (size_t i = 0; i < STATS_BUCKET_COUNT; i++)
+                histogram[i] += atomic_load_explicit(&shard_command->histogram[i], memory_order_relaxed);
+        }
+
+        if (command.calls == 0)
+            continue;
+
+        memcpy(record, &command, sizeof(sa_stats_command));
+        record += record_length;
+        command_count++;
+    }
+
+    sa_stats_header header = {
+            .version = SA_STATS_VERSION,
+            .header_length = sizeof(sa_stats_header),
+            .command_count = command_count,
+            .status_count = STATS_STATUS_COUNT,
+            .bucket_count = STATS_BUCKET_COUNT,
+            .sub_bucket_bits = STATS_SUB_BUCKET_BITS};
+    memcpy(stats, &header, sizeof(sa_stats_header));
+    *stats_length = record - (uint8_t*) stats;
+    return SA_STATUS_OK;
+}
@@ -20,6 +20,7 @@
 #include "log.h"
 #include "porting/memory.h"
 #include "porting/svp.h"
+#include "trace.h"
 #include <threads.h>
 
 struct svp_s {
@@ -82,6 +83,7 @@ static svp_t* svp_create(
 }
 
 static bool svp_lock(svp_t* svp) {
+    TRACE_SPAN_SCOPE("svp_lock");
     if (svp == NULL) {
         return false;
     }
@@ -22,10 +22,19 @@
 #include "pad.h"
 #include "porting/memory.h"
 #include "porting/rand.h"
+#include "reclaimer.h"
 #include "sa_types.h"
 #include "stored_key_internal.h"
 #include <memory.h>
 #include <openssl/evp.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <threads.h>
+
+// number of released symmetric contexts kept for reuse across all clients
+#ifndef SYMMETRIC_CONTEXT_POOL_SIZE
+#define SYMMETRIC_CONTEXT_POOL_SIZE 64
+#endif
 
 struct symmetric_context_s {
     sa_cipher_algorithm cipher_algorithm;
@@ -33,6 +42,72 @@ struct symmetric_context_s {
     EVP_CIPHER_CTX* evp_cipher;
 };
 
+static once_flag pool_flag = ONCE_FLAG_INIT;
+// Cleared on exit. Contexts can be freed by the reclaimer thread, so it is read once per use.
+static _Atomic(object_pool_t*) context_pool = NULL;
+
+static void* symmetric_context_create() {
+    symmetric_context_t* context = memory_internal_alloc(sizeof(symmetric_context_t));
+    if (context == NULL) {
+        ERROR("memory_internal_alloc failed");
+        return NULL;
+    }
+
+    memory_memset_unoptimizable(context, 0, sizeof(symmetric_context_t));
+
+    context->evp_cipher = EVP_CIPHER_CTX_new();
+    if (context->evp_cipher == NULL) {
+        ERROR("EVP_CIPHER_CTX_new failed");
+        memory_internal_free(context);
+        return NULL;
+    }
+
+    return context;
+}
+
+static void symmetric_context_destroy(void* object) {
+    if (object == NULL) {
+        return;
+    }
+
+    symmetric_context_t* context = (symmetric_context_t*) object;
+    if (context->evp_cipher != NULL)
+        EVP_CIPHER_CTX_free(context->evp_cipher);
+
+    memory_internal_free(context);
+}
+
+static void symmetric_context_pool_shutdown() {
+    // Cipher contexts queued for the reclaimer are returned to the pool, so they must be freed before it goes away.
+    reclaimer_flush();
+
+    // contexts released after this point are destroyed directly
+    object_pool_t* pool = atomic_exchange(&context_pool, NULL);
+    object_pool_shutdown(pool);
+}
+
+static void symmetric_context_pool_create() {
+    object_pool_t* pool = object_pool_init(symmetric_context_create, symmetric_context_destroy,
+            SYMMETRIC_CONTEXT_POOL_SIZE);
+    if (pool == NULL) {
+        ERROR("object_pool_init failed");
+        return;
+    }
+
+    atomic_store(&context_pool, pool);
+    atexit(symmetric_context_pool_shutdown);
+}
+
+static symmetric_context_t* symmetric_context_alloc() {
+    call_once(&pool_flag, symmetric_context_pool_create);
+
+    object_pool_t* pool = atomic_load(&context_pool);
+    if (pool == NULL)
+        return symmetric_context_create();
+
+    return object_pool_acquire(pool);
+}
+
 sa_status symmetric_generate_key(
         stored_key_t** stored_key_generated,
         const sa_rights* rights,
@@ -125,21 +200,15 @@ symmetric_context_t* symmetric_create_aes_ecb_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = padded ? SA_CIPHER_ALGORITHM_AES_ECB_PKCS7 : SA_CIPHER_ALGORITHM_AES_ECB;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_ecb();
@@ -208,21 +277,15 @@ symmetric_context_t* symmetric_create_aes_cbc_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = padded ? SA_CIPHER_ALGORITHM_AES_CBC_PKCS7 : SA_CIPHER_ALGORITHM_AES_CBC;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_cbc();
@@ -290,21 +353,15 @@ symmetric_context_t* symmetric_create_aes_ctr_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_AES_CTR;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_ctr();
@@ -380,21 +437,15 @@ symmetric_context_t* symmetric_create_aes_gcm_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_AES_GCM;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_gcm();
@@ -500,21 +551,15 @@ symmetric_context_t* symmetric_create_chacha20_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_CHACHA20;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = EVP_chacha20();
         if (cipher == NULL) {
             ERROR("EVP_chacha20 failed");
@@ -592,21 +637,15 @@ symmetric_context_t* symmetric_create_chacha20_poly1305_encrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_CHACHA20_POLY1305;
         context->cipher_mode = SA_CIPHER_MODE_ENCRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = EVP_chacha20_poly1305();
         if (cipher == NULL) {
             ERROR("EVP_chacha20_poly1305 failed");
@@ -681,21 +720,15 @@ symmetric_context_t* symmetric_create_aes_ecb_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = padded ? SA_CIPHER_ALGORITHM_AES_ECB_PKCS7 : SA_CIPHER_ALGORITHM_AES_ECB;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_ecb();
@@ -764,21 +797,15 @@ symmetric_context_t* symmetric_create_aes_cbc_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = padded ? SA_CIPHER_ALGORITHM_AES_CBC_PKCS7 : SA_CIPHER_ALGORITHM_AES_CBC;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_cbc();
@@ -846,21 +873,15 @@ symmetric_context_t* symmetric_create_aes_ctr_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_AES_CTR;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_ctr();
@@ -936,21 +957,15 @@ symmetric_context_t* symmetric_create_aes_gcm_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_AES_GCM;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = NULL;
         if (key_length == SYM_128_KEY_SIZE)
             cipher = EVP_aes_128_gcm();
@@ -1056,21 +1071,15 @@ symmetric_context_t* symmetric_create_chacha20_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_CHACHA20;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = EVP_chacha20();
         if (cipher == NULL) {
             ERROR("EVP_chacha20 failed");
@@ -1148,21 +1157,15 @@ symmetric_context_t* symmetric_create_chacha20_poly1305_decrypt_context(
     bool status = false;
     symmetric_context_t* context = NULL;
     do {
-        context = memory_internal_alloc(sizeof(symmetric_context_t));
+        context = symmetric_context_alloc();
         if (context == NULL) {
-            ERROR("memory_internal_alloc failed");
+            ERROR("symmetric_context_alloc failed");
             break;
         }
 
         context->cipher_algorithm = SA_CIPHER_ALGORITHM_CHACHA20_POLY1305;
         context->cipher_mode = SA_CIPHER_MODE_DECRYPT;
 
-        context->evp_cipher = EVP_CIPHER_CTX_new();
-        if (context->evp_cipher == NULL) {
-            ERROR("EVP_CIPHER_CTX_new failed");
-            break;
-        }
-
         const EVP_CIPHER* cipher = EVP_chacha20_poly1305();
         if (cipher == NULL) {
             ERROR("EVP_chacha20_poly1305 failed");
@@ -1571,13 +1574,41 @@ sa_status symmetric_context_set_tag(
     return SA_STATUS_OK;
 }
 
+sa_status symmetric_get_pool_stats(object_pool_stats_t* stats) {
+    if (stats == NULL) {
+        ERROR("NULL stats");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    call_once(&pool_flag, symmetric_context_pool_create);
+
+    object_pool_t* pool = atomic_load(&context_pool);
+    if (pool == NULL) {
+        ERROR("NULL context_pool");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    return object_pool_get_stats(stats, pool);
+}
+
 void symmetric_context_free(symmetric_context_t* context) {
     if (context == NULL) {
         return;
     }
 
-    if (context->evp_cipher != NULL)
-        EVP_CIPHER_CTX_free(context->evp_cipher);
+    // resetting the EVP context cleans up the expanded key schedule
+    object_pool_t* pool = atomic_load(&context_pool);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+    bool reset = context->evp_cipher != NULL && EVP_CIPHER_CTX_reset(context->evp_cipher) == 1;
+#else
+    bool reset = context->evp_cipher != NULL && EVP_CIPHER_CTX_cleanup(context->evp_cipher) == 1;
+#endif
+    if (!reset || pool == NULL) {
+        symmetric_context_destroy(context);
+        return;
+    }
 
-    memory_internal_free(context);
+    context->cipher_algorithm = 0;
+    context->cipher_mode = 0;
+    object_pool_release(pool, context);
 }
@@ -18,10 +18,14 @@
 
 #include "ta.h" // NOLINT
 #include "log.h"
+#include "porting/memory.h"
+#include "stats.h"
 #include "ta_sa.h"
+#include "trace.h"
 #include "transport.h"
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 typedef struct {
     ta_client client;
@@ -75,6 +79,35 @@ static sa_status ta_invoke_get_name(
     return ta_sa_get_name((char*) params[1].mem_ref, &get_name->name_length, context->client, uuid);
 }
 
+static sa_status ta_invoke_get_stats(
+        ta_param params[NUM_TA_PARAMS],
+        const ta_session_context* context,
+        const sa_uuid* uuid) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_get_stats_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_get_stats_s* get_stats = (sa_get_stats_s*) params[0].mem_ref;
+    if (params[1].mem_ref != NULL && params[1].mem_ref_size < get_stats->stats_length) {
+        ERROR("params[1].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    return ta_sa_get_stats(params[1].mem_ref, &get_stats->stats_length, context->client, uuid);
+}
+
 static sa_status ta_invoke_get_device_id(
         ta_param params[NUM_TA_PARAMS],
         const ta_session_context* context,
@@ -601,6 +634,295 @@ static sa_status ta_invoke_key_derive(
             context->client, uuid);
 }
 
+static sa_status ta_invoke_key_derive_batch(
+        ta_param params[NUM_TA_PARAMS],
+        const ta_session_context* context,
+        const sa_uuid* uuid) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_key_derive_batch_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[1].mem_ref == NULL) {
+        ERROR("NULL params[1].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[2].mem_ref == NULL) {
+        ERROR("NULL params[2].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    // The params are in memory shared with the REE, so the values that are validated are copied first and only the
+    // copies are used.
+    sa_key_derive_batch_s key_derive_batch = *(sa_key_derive_batch_s*) params[0].mem_ref;
+    if (key_derive_batch.entries_length == 0 ||
+            key_derive_batch.entries_length > SIZE_MAX / sizeof(sa_kdf_batch_entry_s) ||
+            params[2].mem_ref_size != key_derive_batch.entries_length * sizeof(sa_kdf_batch_entry_s)) {
+        ERROR("params[2].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (key_derive_batch.salt_length > params[3].mem_ref_size) {
+        ERROR("params[3].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    const uint8_t* data = params[3].mem_ref;
+    void* algorithm_parameters;
+    sa_kdf_parameters_hkdf parameters_hkdf;
+    sa_kdf_parameters_concat parameters_concat;
+    sa_kdf_parameters_ansi_x963 parameters_ansi_x963;
+    sa_kdf_parameters_cmac parameters_cmac;
+    switch (key_derive_batch.kdf_algorithm) {
+        case SA_KDF_ALGORITHM_HKDF: {
+            if (params[1].mem_ref_size != sizeof(sa_kdf_parameters_hkdf_s)) {
+                ERROR("params[1].mem_ref_size is invalid");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            sa_kdf_parameters_hkdf_s* parameters_hkdf_s = (sa_kdf_parameters_hkdf_s*) params[1].mem_ref;
+            parameters_hkdf.key_length = parameters_hkdf_s->key_length;
+            parameters_hkdf.digest_algorithm = parameters_hkdf_s->digest_algorithm;
+            parameters_hkdf.parent = parameters_hkdf_s->parent;
+            parameters_hkdf.salt = key_derive_batch.salt_length > 0 ? data : NULL;
+            parameters_hkdf.salt_length = key_derive_batch.salt_length;
+            parameters_hkdf.info = NULL;
+            parameters_hkdf.info_length = 0;
+            algorithm_parameters = &parameters_hkdf;
+            break;
+        }
+        case SA_KDF_ALGORITHM_CONCAT: {
+            if (params[1].mem_ref_size != sizeof(sa_kdf_parameters_concat_s)) {
+                ERROR("params[1].mem_ref_size is invalid");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            sa_kdf_parameters_concat_s* parameters_concat_s = (sa_kdf_parameters_concat_s*) params[1].mem_ref;
+            parameters_concat.key_length = parameters_concat_s->key_length;
+            parameters_concat.digest_algorithm = parameters_concat_s->digest_algorithm;
+            parameters_concat.parent = parameters_concat_s->parent;
+            parameters_concat.info = NULL;
+            parameters_concat.info_length = 0;
+            algorithm_parameters = &parameters_concat;
+            break;
+        }
+        case SA_KDF_ALGORITHM_ANSI_X963: {
+            if (params[1].mem_ref_size != sizeof(sa_kdf_parameters_ansi_x963_s)) {
+                ERROR("params[1].mem_ref_size is invalid");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            sa_kdf_parameters_ansi_x963_s* parameters_ansi_x963_s = (sa_kdf_parameters_ansi_x963_s*) params[1].mem_ref;
+            parameters_ansi_x963.key_length = parameters_ansi_x963_s->key_length;
+            parameters_ansi_x963.digest_algorithm = parameters_ansi_x963_s->digest_algorithm;
+            parameters_ansi_x963.parent = parameters_ansi_x963_s->parent;
+            parameters_ansi_x963.info = NULL;
+            parameters_ansi_x963.info_length = 0;
+            algorithm_parameters = &parameters_ansi_x963;
+            break;
+        }
+        case SA_KDF_ALGORITHM_CMAC: {
+            if (params[1].mem_ref_size != sizeof(sa_kdf_parameters_cmac_s)) {
+                ERROR("params[1].mem_ref_size is invalid");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            sa_kdf_parameters_cmac_s* parameters_cmac_s = (sa_kdf_parameters_cmac_s*) params[1].mem_ref;
+            parameters_cmac.key_length = parameters_cmac_s->key_length;
+            parameters_cmac.counter = parameters_cmac_s->counter;
+            parameters_cmac.parent = parameters_cmac_s->parent;
+            parameters_cmac.other_data = NULL;
+            parameters_cmac.other_data_length = 0;
+            algorithm_parameters = &parameters_cmac;
+            break;
+        }
+        default:
+            return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_kdf_batch_entry_s* entries_s = (sa_kdf_batch_entry_s*) params[2].mem_ref;
+    sa_kdf_batch_entry_s* entries_copy = memory_internal_alloc(params[2].mem_ref_size);
+    sa_kdf_batch_entry* entries = memory_internal_alloc(key_derive_batch.entries_length * sizeof(sa_kdf_batch_entry));
+    sa_status status = SA_STATUS_OK;
+    do {
+        if (entries_copy == NULL || entries == NULL) {
+            ERROR("memory_internal_alloc failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        memcpy(entries_copy, entries_s, params[2].mem_ref_size);
+        for (size_t i = 0; i < key_derive_batch.entries_length; i++) {
+            if (entries_copy[i].info_offset > params[3].mem_ref_size ||
+                    entries_copy[i].info_length > params[3].mem_ref_size - entries_copy[i].info_offset) {
+                ERROR("Invalid info_offset or info_length");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            entries[i].key = INVALID_HANDLE;
+            entries[i].rights = &entries_copy[i].rights;
+            entries[i].info = entries_copy[i].info_length > 0 ? data + entries_copy[i].info_offset : NULL;
+            entries[i].info_length = entries_copy[i].info_length;
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        status = ta_sa_key_derive_batch(entries, key_derive_batch.entries_length, key_derive_batch.kdf_algorithm,
+                algorithm_parameters, context->client, uuid);
+        for (size_t i = 0; i < key_derive_batch.entries_length; i++)
+            entries_s[i].key = entries[i].key;
+    } while (false);
+
+    memory_internal_free(entries);
+    memory_internal_free(entries_copy);
+    return status;
+}
+
+typedef union {
+    sa_unwrap_parameters_aes_cbc aes_cbc;
+    sa_unwrap_parameters_aes_ctr aes_ctr;
+    sa_unwrap_parameters_aes_gcm aes_gcm;
+} unwrap_batch_parameters;
+
+static sa_status ta_invoke_key_unwrap_batch(
+        ta_param params[NUM_TA_PARAMS],
+        const ta_session_context* context,
+        const sa_uuid* uuid) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_key_unwrap_batch_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[1].mem_ref == NULL) {
+        ERROR("NULL params[1].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[2].mem_ref == NULL) {
+        ERROR("NULL params[2].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    // The params are in memory shared with the REE, so the values that are validated are copied first and only the
+    // copies are used.
+    sa_key_unwrap_batch_s key_unwrap_batch = *(sa_key_unwrap_batch_s*) params[0].mem_ref;
+    size_t entries_length = key_unwrap_batch.entries_length;
+    if (entries_length == 0 || entries_length > SIZE_MAX / sizeof(sa_unwrap_batch_entry_s) ||
+            params[1].mem_ref_size != entries_length * sizeof(sa_unwrap_batch_entry_s)) {
+        ERROR("params[1].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    const uint8_t* data = params[2].mem_ref;
+    sa_unwrap_batch_entry_s* entries_s = (sa_unwrap_batch_entry_s*) params[1].mem_ref;
+    sa_unwrap_batch_entry_s* entries_copy = memory_internal_alloc(params[1].mem_ref_size);
+    sa_unwrap_batch_entry* entries = memory_internal_alloc(entries_length * sizeof(sa_unwrap_batch_entry));
+    unwrap_batch_parameters* parameters = memory_internal_alloc(entries_length * sizeof(unwrap_batch_parameters));
+    sa_status status = SA_STATUS_OK;
+    do {
+        if (entries_copy == NULL || entries == NULL || parameters == NULL) {
+            ERROR("memory_internal_alloc failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        memcpy(entries_copy, entries_s, params[1].mem_ref_size);
+        for (size_t i = 0; i < entries_length; i++) {
+            const sa_unwrap_batch_entry_s* entry = &entries_copy[i];
+            if (entry->in_offset > params[2].mem_ref_size ||
+                    entry->in_length > params[2].mem_ref_size - entry->in_offset) {
+                ERROR("Invalid in_offset or in_length");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            if (entry->aad_offset > params[2].mem_ref_size ||
+                    entry->aad_length > params[2].mem_ref_size - entry->aad_offset) {
+                ERROR("Invalid aad_offset or aad_length");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            if (entry->iv_length > sizeof(entry->iv) || entry->tag_length > MAX_GCM_TAG_LENGTH) {
+                ERROR("Invalid iv_length or tag_length");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            entries[i].key = INVALID_HANDLE;
+            entries[i].rights = &entry->rights;
+            entries[i].in = data + entry->in_offset;
+            entries[i].in_length = entry->in_length;
+            switch (key_unwrap_batch.cipher_algorithm) {
+                case SA_CIPHER_ALGORITHM_AES_CBC:
+                case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7:
+                    parameters[i].aes_cbc.iv = entry->iv;
+                    parameters[i].aes_cbc.iv_length = entry->iv_length;
+                    entries[i].algorithm_parameters = &parameters[i].aes_cbc;
+                    break;
+
+                case SA_CIPHER_ALGORITHM_AES_CTR:
+                    parameters[i].aes_ctr.ctr = entry->iv;
+                    parameters[i].aes_ctr.ctr_length = entry->iv_length;
+                    entries[i].algorithm_parameters = &parameters[i].aes_ctr;
+                    break;
+
+                case SA_CIPHER_ALGORITHM_AES_GCM:
+                    parameters[i].aes_gcm.iv = entry->iv;
+                    parameters[i].aes_gcm.iv_length = entry->iv_length;
+                    parameters[i].aes_gcm.aad = entry->aad_length > 0 ? data + entry->aad_offset : NULL;
+                    parameters[i].aes_gcm.aad_length = entry->aad_length;
+                    parameters[i].aes_gcm.tag = entry->tag;
+                    parameters[i].aes_gcm.tag_length = entry->tag_length;
+                    entries[i].algorithm_parameters = &parameters[i].aes_gcm;
+                    break;
+
+                default:
+                    entries[i].algorithm_parameters = NULL;
+                    break;
+            }
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        status = ta_sa_key_unwrap_batch(entries, entries_length, key_unwrap_batch.cipher_algorithm,
+                key_unwrap_batch.wrapping_key, context->client, uuid);
+        for (size_t i = 0; i < entries_length; i++)
+            entries_s[i].key = entries[i].key;
+    } while (false);
+
+    memory_internal_free(parameters);
+    memory_internal_free(entries);
+    memory_internal_free(entries_copy);
+    return status;
+}
+
 static sa_status ta_invoke_key_exchange(
         ta_param params[NUM_TA_PARAMS],
         const ta_session_context* context,
@@ -1247,6 +1569,88 @@ static sa_status ta_invoke_svp_buffer_copy(
             params[1].mem_ref_size / sizeof(sa_svp_offset), context->client, uuid);
 }
 
+static sa_status ta_invoke_svp_buffer_batch(
+        ta_param params[NUM_TA_PARAMS],
+        const ta_session_context* context,
+        const sa_uuid* uuid) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_svp_buffer_batch_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[1].mem_ref == NULL) {
+        ERROR("NULL params[1].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[2].mem_ref == NULL) {
+        ERROR("NULL params[2].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    // The params are in memory shared with the REE, so the entries and offsets are copied before they are validated
+    // and only the copies are used.
+    size_t entries_length = ((sa_svp_buffer_batch_s*) params[0].mem_ref)->entries_length;
+    if (entries_length == 0 || entries_length > SIZE_MAX / sizeof(sa_svp_batch_entry_s) ||
+            params[1].mem_ref_size != entries_length * sizeof(sa_svp_batch_entry_s)) {
+        ERROR("params[1].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t offsets_count = params[2].mem_ref_size / sizeof(sa_svp_offset);
+    sa_svp_batch_entry_s* entries_copy = memory_internal_alloc(params[1].mem_ref_size);
+    sa_svp_offset* offsets = memory_internal_alloc(offsets_count * sizeof(sa_svp_offset));
+    sa_svp_batch_entry* entries = memory_internal_alloc(entries_length * sizeof(sa_svp_batch_entry));
+    sa_status status = SA_STATUS_OK;
+    do {
+        if (entries_copy == NULL || (offsets == NULL && offsets_count > 0) || entries == NULL) {
+            ERROR("memory_internal_alloc failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        memcpy(entries_copy, params[1].mem_ref, params[1].mem_ref_size);
+        if (offsets_count > 0)
+            memcpy(offsets, params[2].mem_ref, offsets_count * sizeof(sa_svp_offset));
+
+        for (size_t i = 0; i < entries_length; i++) {
+            if (entries_copy[i].offsets_index > offsets_count ||
+                    entries_copy[i].offsets_length > offsets_count - entries_copy[i].offsets_index) {
+                ERROR("Invalid offsets_index or offsets_length");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+
+            entries[i].out = entries_copy[i].out;
+            entries[i].in = entries_copy[i].in;
+            entries[i].offsets = offsets + entries_copy[i].offsets_index;
+            entries[i].offsets_length = entries_copy[i].offsets_length;
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        status = ta_sa_svp_buffer_batch(params[3].mem_ref, params[3].mem_ref_size, entries, entries_length,
+                context->client, uuid);
+    } while (false);
+
+    memory_internal_free(entries);
+    memory_internal_free(offsets);
+    memory_internal_free(entries_copy);
+    return status;
+}
+
 static sa_status ta_invoke_svp_key_check(
         ta_param params[NUM_TA_PARAMS],
         const ta_session_context* context,
@@ -1313,6 +1717,42 @@ static sa_status ta_invoke_svp_buffer_check(
             uuid);
 }
 
+static sa_status ta_invoke_svp_buffer_check_ranges(
+        ta_param params[NUM_TA_PARAMS],
+        const ta_session_context* context,
+        const sa_uuid* uuid) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_svp_buffer_check_ranges_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[1].mem_ref == NULL) {
+        ERROR("NULL params[1].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[1].mem_ref_size % sizeof(sa_svp_range) != 0) {
+        ERROR("params[1].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_svp_buffer_check_ranges_s* svp_buffer_check_ranges = (sa_svp_buffer_check_ranges_s*) params[0].mem_ref;
+    return ta_sa_svp_buffer_check_ranges(svp_buffer_check_ranges->svp_buffer, params[1].mem_ref,
+            params[1].mem_ref_size / sizeof(sa_svp_range), svp_buffer_check_ranges->digest_algorithm,
+            params[2].mem_ref, params[2].mem_ref_size, context->client, uuid);
+}
+
 static sa_status ta_invoke_process_common_encryption(
         ta_param params[NUM_TA_PARAMS],
         const ta_session_context* context,
@@ -1388,7 +1828,113 @@ static sa_status ta_invoke_process_common_encryption(
     return status;
 }
 
-sa_status ta_invoke_command_handler(
+// Runs every sub-command, whether or not the previous ones succeeded, and records its status. The envelope only fails
+// if it is malformed, in which case no sub-command is run.
+static sa_status ta_invoke_command_batch(
+        ta_param params[NUM_TA_PARAMS],
+        void* session_context) {
+
+    if (params == NULL) {
+        ERROR("NULL params");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref == NULL) {
+        ERROR("NULL params[0].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[0].mem_ref_size != sizeof(sa_command_batch_s)) {
+        ERROR("params[0].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[1].mem_ref == NULL) {
+        ERROR("NULL params[1].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[2].mem_ref == NULL) {
+        ERROR("NULL params[2].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (params[3].mem_ref == NULL) {
+        ERROR("NULL params[3].mem_ref");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    // The envelope is in memory shared with the REE, so the entries are copied before they are validated and only the
+    // copies are used. Otherwise the REE could rewrite an offset after it has been checked.
+    size_t commands_length = ((sa_command_batch_s*) params[0].mem_ref)->commands_length;
+    if (commands_length == 0 || commands_length > SIZE_MAX / sizeof(sa_command_batch_entry_s) ||
+            params[1].mem_ref_size != commands_length * sizeof(sa_command_batch_entry_s)) {
+        ERROR("params[1].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (params[3].mem_ref_size != commands_length * sizeof(sa_status)) {
+        ERROR("params[3].mem_ref_size is invalid");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_command_batch_entry_s* entries = memory_internal_alloc(params[1].mem_ref_size);
+    if (entries == NULL) {
+        ERROR("memory_internal_alloc failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    memcpy(entries, params[1].mem_ref, params[1].mem_ref_size);
+
+    // Validate every entry before running anything, so that a malformed envelope has no side effects.
+    sa_status status = SA_STATUS_OK;
+    size_t data_length = params[2].mem_ref_size;
+    for (size_t i = 0; i < commands_length && status == SA_STATUS_OK; i++) {
+        if (entries[i].command_id == SA_COMMAND_BATCH) {
+            ERROR("Nested command batch");
+            status = SA_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        for (size_t j = 0; j < NUM_TA_PARAMS; j++) {
+            if (entries[i].param_sizes[j] == 0)
+                continue;
+
+            if (entries[i].param_offsets[j] % COMMAND_BATCH_ALIGNMENT != 0 ||
+                    entries[i].param_offsets[j] > data_length ||
+                    entries[i].param_sizes[j] > data_length - entries[i].param_offsets[j]) {
+                ERROR("Invalid param_offsets or param_sizes");
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+        }
+
+        if (status == SA_STATUS_OK && entries[i].param_sizes[0] == 0) {
+            ERROR("NULL sub-command params[0]");
+            status = SA_STATUS_NULL_PARAMETER;
+        }
+    }
+
+    if (status == SA_STATUS_OK) {
+        uint8_t* data = params[2].mem_ref;
+        sa_status* statuses = params[3].mem_ref;
+        for (size_t i = 0; i < commands_length; i++) {
+            ta_param command_params[NUM_TA_PARAMS];
+            for (size_t j = 0; j < NUM_TA_PARAMS; j++) {
+                command_params[j].mem_ref = entries[i].param_sizes[j] == 0 ? NULL : data + entries[i].param_offsets[j];
+                command_params[j].mem_ref_size = entries[i].param_sizes[j];
+            }
+
+            statuses[i] = ta_invoke_command_handler(session_context, (SA_COMMAND_ID) entries[i].command_id,
+                    command_params);
+        }
+    }
+
+    memory_internal_free(entries);
+    return status;
+}
+
+static sa_status ta_invoke_command_dispatch(
         void* session_context,
         SA_COMMAND_ID command_id,
         ta_param params[NUM_TA_PARAMS]) {
@@ -1464,6 +2010,14 @@ sa_status ta_invoke_command_handler(
                 status = ta_invoke_key_derive(params, context, &uuid);
                 break;
 
+            case SA_KEY_DERIVE_BATCH:
+                status = ta_invoke_key_derive_batch(params, context, &uuid);
+                break;
+
+            case SA_KEY_UNWRAP_BATCH:
+                status = ta_invoke_key_unwrap_batch(params, context, &uuid);
+                break;
+
             case SA_KEY_EXCHANGE:
                 status = ta_invoke_key_exchange(params, context, &uuid);
                 break;
@@ -1560,6 +2114,22 @@ sa_status ta_invoke_command_handler(
                 status = ta_invoke_process_common_encryption(params, context, &uuid);
                 break;
 
+            case SA_GET_STATS:
+                status = ta_invoke_get_stats(params, context, &uuid);
+                break;
+
+            case SA_SVP_BUFFER_BATCH:
+                status = ta_invoke_svp_buffer_batch(params, context, &uuid);
+                break;
+
+            case SA_SVP_BUFFER_CHECK_RANGES:
+                status = ta_invoke_svp_buffer_check_ranges(params, context, &uuid);
+                break;
+
+            case SA_COMMAND_BATCH:
+                status = ta_invoke_command_batch(params, session_context);
+                break;
+
             default:
                 status = SA_STATUS_OPERATION_NOT_SUPPORTED;
         }
@@ -1568,6 +2138,27 @@ sa_status ta_invoke_command_handler(
     return status;
 }
 
+sa_status ta_invoke_command_handler(
+        void* session_context,
+        SA_COMMAND_ID command_id,
+        ta_param params[NUM_TA_PARAMS]) {
+
+    stats_call_t call = stats_begin(command_id);
+    bool span = TRACE_SPAN_BEGIN_ARG("ta_invoke_command_handler", command_id);
+    sa_status status = ta_invoke_command_dispatch(session_context, command_id, params);
+    TRACE_SPAN_END(span);
+
+    // The commands of a batch are recorded individually, so the batch itself does not count their parameters.
+    size_t param_bytes = 0;
+    if (params != NULL && command_id != SA_COMMAND_BATCH) {
+        for (size_t i = 1; i < NUM_TA_PARAMS; i++)
+            param_bytes += params[i].mem_ref_size;
+    }
+
+    stats_record(call, status, param_bytes);
+    return status;
+}
+
 sa_status ta_open_session_handler(void** session_context) {
 
     if (session_context == NULL) {
@@ -44,6 +44,22 @@ typedef enum {
     TYPEJ_RIGHT_CGMSA_REQUIRED = 0x08
 } typej_right_e;
 
+typedef enum {
+    TYPEJ_FIELD_KEY_ID = 0,
+    TYPEJ_FIELD_KEY_RIGHTS,
+    TYPEJ_FIELD_KEY_USAGE,
+    TYPEJ_FIELD_KEY_NOT_BEFORE,
+    TYPEJ_FIELD_KEY_NOT_ON_OR_AFTER,
+    TYPEJ_FIELD_KEY_CACHEABLE,
+    TYPEJ_FIELD_ENTITLED_TA_IDS,
+    TYPEJ_FIELD_KEY_CONTAINER_VERSION,
+    TYPEJ_FIELD_KEY,
+    TYPEJ_FIELD_KEY_LENGTH,
+    TYPEJ_FIELD_KEY_TRANSPORT_ALGORITHM,
+    TYPEJ_FIELD_KEY_TRANSPORT_IV,
+    TYPEJ_FIELD_COUNT
+} typej_field_e;
+
 typedef struct {
     const void* in;
     size_t in_length;
@@ -332,8 +348,7 @@ static sa_status content_key_rights_to_usage_flags(
 
 static sa_status fields_to_rights(
         sa_rights* rights,
-        const json_key_value_t* fields,
-        size_t fields_count) {
+        const json_field_t* fields) {
 
     if (rights == NULL) {
         ERROR("NULL rights");
@@ -348,43 +363,29 @@ static sa_status fields_to_rights(
     memory_memset_unoptimizable(rights, 0, sizeof(sa_rights));
 
     // read contentKeyId
-    const json_key_value_t* key_id_field = json_key_value_find("contentKeyId", fields, fields_count);
-    if (key_id_field == NULL) {
-        ERROR("json_key_value_find failed");
-        return SA_STATUS_INVALID_KEY_FORMAT;
-    }
-
-    size_t key_id_field_size = 0;
-    const char* key_id_field_string = json_value_as_string(&key_id_field_size, key_id_field->value);
-    if (key_id_field_string == NULL) {
-        ERROR("json_value_as_string failed");
+    const json_field_t* key_id_field = &fields[TYPEJ_FIELD_KEY_ID];
+    if (!key_id_field->found) {
+        ERROR("Missing contentKeyId");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    if (key_id_field_size > (sizeof(rights->id) - 1)) {
+    if (key_id_field->string.length > (sizeof(rights->id) - 1)) {
         ERROR("Invalid contentKeyId length");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    strncpy(rights->id, key_id_field_string, sizeof(rights->id));
+    strncpy(rights->id, key_id_field->string.string, sizeof(rights->id));
 
     // read contentKeyRights
-    const json_key_value_t* rights_field = json_key_value_find("contentKeyRights", fields, fields_count);
-    if (rights_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* rights_field = &fields[TYPEJ_FIELD_KEY_RIGHTS];
+    if (!rights_field->found) {
+        ERROR("Missing contentKeyRights");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t rights_field_size = 0;
-    const char* rights_field_string = json_value_as_string(&rights_field_size, rights_field->value);
-    if (rights_field_string == NULL) {
-        ERROR("json_value_as_string failed");
-        return SA_STATUS_INVALID_KEY_FORMAT;
-    }
-
-    size_t rights_count = b64_decoded_length(rights_field_size);
+    size_t rights_count = b64_decoded_length(rights_field->string.length);
     uint8_t* rights_bytes = memory_internal_alloc(rights_count);
-    if (!b64_decode(rights_bytes, &rights_count, rights_field_string, rights_field_size, false)) {
+    if (!b64_decode(rights_bytes, &rights_count, rights_field->string.string, rights_field->string.length, false)) {
         ERROR("Invalid contentKeyRights");
         memory_secure_free(rights_bytes);
         return SA_STATUS_INVALID_KEY_FORMAT;
@@ -398,100 +399,75 @@ static sa_status fields_to_rights(
     }
 
     // read contentKeyUsage
-    const json_key_value_t* usage_field = json_key_value_find("contentKeyUsage", fields, fields_count);
-    if (usage_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* usage_field = &fields[TYPEJ_FIELD_KEY_USAGE];
+    if (!usage_field->found) {
+        ERROR("Missing contentKeyUsage");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    long long usage = json_value_as_integer(usage_field->value);
-    status = key_usage_to_usage_flags(&rights->usage_flags, usage, SA_KEY_TYPE_SYMMETRIC, AES_SUBTYPE);
+    status = key_usage_to_usage_flags(&rights->usage_flags, usage_field->integer, SA_KEY_TYPE_SYMMETRIC,
+            AES_SUBTYPE);
     if (status != SA_STATUS_OK) {
         ERROR("content_key_usage_to_usage_flags failed");
         return status;
     }
 
     // read contentKeyNotBefore
-    const json_key_value_t* not_before_field = json_key_value_find("contentKeyNotBefore", fields, fields_count);
-    if (not_before_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* not_before_field = &fields[TYPEJ_FIELD_KEY_NOT_BEFORE];
+    if (!not_before_field->found) {
+        ERROR("Missing contentKeyNotBefore");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    size_t not_before_field_size = 0;
-    const char* not_before_field_string = json_value_as_string(&not_before_field_size, not_before_field->value);
-    if (not_before_field_string == NULL) {
-        ERROR("json_value_as_string failed");
-        return SA_STATUS_INVALID_KEY_FORMAT;
-    }
-
-    if (!iso8601_to_epoch_time(&rights->not_before, not_before_field_string, not_before_field_size)) {
+    if (!iso8601_to_epoch_time(&rights->not_before, not_before_field->string.string,
+                not_before_field->string.length)) {
         ERROR("iso8601_to_epoch_time failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read contentKeyNotOnOrAfter
-    const json_key_value_t* not_on_or_after_field = json_key_value_find("contentKeyNotOnOrAfter", fields, fields_count);
-    if (not_on_or_after_field == NULL) {
-        ERROR("json_key_value_find failed");
-        return SA_STATUS_INVALID_KEY_FORMAT;
-    }
-
-    size_t not_on_or_after_field_size = 0;
-    const char* not_on_or_after_field_string = json_value_as_string(&not_on_or_after_field_size,
-            not_on_or_after_field->value);
-    if (not_on_or_after_field_string == NULL) {
-        ERROR("json_value_as_string failed");
+    const json_field_t* not_on_or_after_field = &fields[TYPEJ_FIELD_KEY_NOT_ON_OR_AFTER];
+    if (!not_on_or_after_field->found) {
+        ERROR("Missing contentKeyNotOnOrAfter");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    if (!iso8601_to_epoch_time(&rights->not_on_or_after, not_on_or_after_field_string, not_on_or_after_field_size)) {
+    if (!iso8601_to_epoch_time(&rights->not_on_or_after, not_on_or_after_field->string.string,
+                not_on_or_after_field->string.length)) {
         ERROR("iso8601_to_epoch_time failed");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
     // read contentKeyCacheable
-    const json_key_value_t* cacheable_field = json_key_value_find("contentKeyCacheable", fields, fields_count);
-    if (cacheable_field == NULL) {
-        ERROR("json_key_value_find failed");
+    const json_field_t* cacheable_field = &fields[TYPEJ_FIELD_KEY_CACHEABLE];
+    if (!cacheable_field->found) {
+        ERROR("Missing contentKeyCacheable");
         return SA_STATUS_INVALID_KEY_FORMAT;
     }
 
-    if (json_value_as_bool(cacheable_field->value)) {
+    if (cacheable_field->boolean) {
         SA_USAGE_BIT_SET(rights->usage_flags, SA_USAGE_FLAG_CACHEABLE);
     }
 
     // Populate allowed TA UUIDs
 
     // read entitled TA IDs
-    json_value_t** entitled_ta_ids = NULL;
-    const json_key_value_t* entitled_ta_ids_field = json_key_value_find("entitledTaIds", fields, fields_count);
-    if (entitled_ta_ids_field == NULL) {
+    const json_field_t* entitled_ta_ids_field = &fields[TYPEJ_FIELD_ENTITLED_TA_IDS];
+    if (!entitled_ta_ids_field->found) {
         // Versions 1 and 2 of Type-J container have no assertions about allowed TAs. All caller UUIDs are allowed for
         // those version. If omitted in a version 3 key container, the all caller UUIDS are allowed.
         memcpy(&rights->allowed_tas[0], &ALL_MATCH, sizeof(sa_uuid));
     } else {
-        size_t entitled_ta_ids_length;
-        entitled_ta_ids = json_value_as_array(&entitled_ta_ids_length, entitled_ta_ids_field->value);
-        if (entitled_ta_ids_length > MAX_NUM_ALLOWED_TA_IDS) {
-            memory_internal_free(entitled_ta_ids);
-            ERROR("Invalid entitled_ta_ids_length");
-            return SA_STATUS_INVALID_KEY_FORMAT;
-        }
-
-        for (size_t i = 0; i < entitled_ta_ids_length; i++) {
-            size_t ta_id_length;
-            const char* ta_id = json_value_as_string(&ta_id_length, entitled_ta_ids[i]);
-            if (ta_id_length != UUID_LENGTH) {
-                memory_internal_free(entitled_ta_ids);
+        // The extractor bounds the array to MAX_NUM_ALLOWED_TA_IDS entries.
+        for (size_t i = 0; i < entitled_ta_ids_field->strings_length; i++) {
+            const json_slice_t* ta_id = &entitled_ta_ids_field->strings[i];
+            if (ta_id->length != UUID_LENGTH) {
                 ERROR("Invalid ta_id");
                 return SA_STATUS_INVALID_KEY_FORMAT;
             }
 
-            convert_uuid(ta_id, ta_id_length, &rights->allowed_tas[i]);
+            convert_uuid(ta_id->string, ta_id->length, &rights->allowed_tas[i]);
         }
-
-        memory_internal_free(entitled_ta_ids);
     }
 
     return SA_STATUS_OK;
@@ -499,8 +475,7 @@ static sa_status fields_to_rights(
 
 static sa_status unwrap_key_v1(
         stored_key_t** stored_key,
-        const json_key_value_t* fields,
-        size_t fields_count,
+        const json_field_t* fields,
         const sa_rights* rights,
         const stored_key_t* stored_key_encryption) {
 
@@ -522,24 +497,17 @@ static sa_status unwrap_key_v1(
     sa_status status;
     uint8_t* content_key = NULL;
     do {
-        const json_key_value_t* content_key_field = json_key_value_find("contentKey", fields, fields_count);
-        if (content_key_field == NULL) {
-            ERROR("json_key_value_find failed");
+        const json_field_t* content_key_field = &fields[TYPEJ_FIELD_KEY];
+        if (!content_key_field->found) {
+            ERROR("Missing contentKey");
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
-        size_t content_key_b64_size = 0;
-        const char* content_key_b64 = json_value_as_string(&content_key_b64_size, content_key_field->value);
-        if (content_key_b64 == NULL) {
-            ERROR("json_value_as_string failed");
-            status = SA_STATUS_INVALID_KEY_FORMAT;
-            break;
-        }
-
-        size_t content_key_size = b64_decoded_length(content_key_b64_size);
+        size_t content_key_size = b64_decoded_length(content_key_field->string.length);
         content_key = memory_internal_alloc(content_key_size);
-        if (!b64_decode(content_key, &content_key_size, content_key_b64, content_key_b64_size, false)) {
+        if (!b64_decode(content_key, &content_key_size, content_key_field->string.string,
+                    content_key_field->string.length, false)) {
             ERROR("Invalid contentKey");
             memory_secure_free(content_key);
             status = SA_STATUS_INVALID_KEY_FORMAT;
@@ -594,8 +562,7 @@ static sa_cipher_algorithm parse_cipher_algorithm(const char* algorithm, size_t
 
 static sa_status unwrap_key_v2(
         stored_key_t** stored_key,
-        const json_key_value_t* fields,
-        size_t fields_count,
+        const json_field_t* fields,
         const sa_rights* rights,
         const stored_key_t* stored_key_encryption) {
 
@@ -623,51 +590,41 @@ static sa_status unwrap_key_v2(
     uint8_t* content_key = NULL;
     uint8_t* iv = NULL;
     do {
-        const json_key_value_t* algorithm_field = json_key_value_find("contentKeyTransportAlgorithm", fields,
-                fields_count);
-        if (algorithm_field == NULL) {
-            ERROR("json_key_value_find failed");
+        const json_field_t* algorithm_field = &fields[TYPEJ_FIELD_KEY_TRANSPORT_ALGORITHM];
+        if (!algorithm_field->found) {
+            ERROR("Missing contentKeyTransportAlgorithm");
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
-        size_t algorithm_size = 0;
-        const char* algorithm = json_value_as_string(&algorithm_size, algorithm_field->value);
-        sa_cipher_algorithm cipher_algorithm = parse_cipher_algorithm(algorithm, algorithm_size);
+        sa_cipher_algorithm cipher_algorithm = parse_cipher_algorithm(algorithm_field->string.string,
+                algorithm_field->string.length);
 
-        const json_key_value_t* content_key_field = json_key_value_find("contentKey", fields, fields_count);
-        if (content_key_field == NULL) {
-            ERROR("json_key_value_find failed");
+        const json_field_t* content_key_field = &fields[TYPEJ_FIELD_KEY];
+        if (!content_key_field->found) {
+            ERROR("Missing contentKey");
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
-        size_t content_key_b64_size = 0;
-        const char* content_key_b64 = json_value_as_string(&content_key_b64_size, content_key_field->value);
-        if (content_key_b64 == NULL) {
-            ERROR("json_value_as_string failed");
-            status = SA_STATUS_INVALID_KEY_FORMAT;
-            break;
-        }
-
-        size_t content_key_size = b64_decoded_length(content_key_b64_size);
+        size_t content_key_size = b64_decoded_length(content_key_field->string.length);
         content_key = memory_internal_alloc(content_key_size);
-        if (!b64_decode(content_key, &content_key_size, content_key_b64, content_key_b64_size, false)) {
-            ERROR("json_key_value_find failed");
+        if (!b64_decode(content_key, &content_key_size, content_key_field->string.string,
+                    content_key_field->string.length, false)) {
+            ERROR("Invalid contentKey");
             memory_secure_free(content_key);
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
-        const json_key_value_t* content_key_length_field = json_key_value_find("contentKeyLength",
-                fields, fields_count);
-        if (content_key_length_field == NULL) {
-            ERROR("json_key_value_find failed");
+        const json_field_t* content_key_length_field = &fields[TYPEJ_FIELD_KEY_LENGTH];
+        if (!content_key_length_field->found) {
+            ERROR("Missing contentKeyLength");
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
-        size_t content_key_length = json_value_as_integer(content_key_length_field->value);
+        size_t content_key_length = content_key_length_field->integer;
 
         if (cipher_algorithm == SA_CIPHER_ALGORITHM_AES_ECB ||
                 cipher_algorithm == SA_CIPHER_ALGORITHM_AES_ECB_PKCS7) {
@@ -679,24 +636,17 @@ static sa_status unwrap_key_v2(
             }
         } else if (cipher_algorithm == SA_CIPHER_ALGORITHM_AES_CBC ||
                    cipher_algorithm == SA_CIPHER_ALGORITHM_AES_CBC_PKCS7) {
-            const json_key_value_t* iv_field = json_key_value_find("contentKeyTransportIv", fields, fields_count);
-            if (iv_field == NULL) {
-                ERROR("json_key_value_find failed");
+            const json_field_t* iv_field = &fields[TYPEJ_FIELD_KEY_TRANSPORT_IV];
+            if (!iv_field->found) {
+                ERROR("Missing contentKeyTransportIv");
                 status = SA_STATUS_INVALID_KEY_FORMAT;
                 break;
             }
 
-            size_t iv_b64_size = 0;
-            const char* iv_b64 = json_value_as_string(&iv_b64_size, iv_field->value);
-            if (iv_b64 == NULL) {
-                ERROR("json_value_as_string failed");
-                status = SA_STATUS_INVALID_KEY_FORMAT;
-                break;
-            }
-
-            size_t iv_size = b64_decoded_length(iv_b64_size);
+            size_t iv_size = b64_decoded_length(iv_field->string.length);
             iv = memory_internal_alloc(iv_size);
-            if (!b64_decode(iv, &iv_size, iv_b64, iv_b64_size, false) || iv_size != SYM_128_KEY_SIZE) {
+            if (!b64_decode(iv, &iv_size, iv_field->string.string, iv_field->string.length, false) ||
+                    iv_size != SYM_128_KEY_SIZE) {
                 ERROR("Invalid contentKeyTransportIv");
                 memory_secure_free(iv);
                 status = SA_STATUS_INVALID_KEY_FORMAT;
@@ -733,13 +683,12 @@ static sa_status unwrap_key_v2(
 
 static sa_status unwrap_key_v3(
         stored_key_t** stored_key,
-        const json_key_value_t* fields,
-        size_t fields_count,
+        const json_field_t* fields,
         const sa_rights* rights,
         const stored_key_t* stored_key_encryption) {
 
     // No difference between unwrapping a v2 and v3 key.
-    return unwrap_key_v2(stored_key, fields, fields_count, rights, stored_key_encryption);
+    return unwrap_key_v2(stored_key, fields, rights, stored_key_encryption);
 }
 
 sa_status typej_unwrap(
@@ -771,8 +720,22 @@ sa_status typej_unwrap(
 
     sa_status status;
     typej_unpacked_t* unpacked = NULL;
-    json_value_t* json_value = NULL;
-    json_key_value_t* fields = NULL;
+    json_slice_t entitled_ta_ids[MAX_NUM_ALLOWED_TA_IDS];
+    json_field_t fields[TYPEJ_FIELD_COUNT] = {
+            [TYPEJ_FIELD_KEY_ID] = {.key = "contentKeyId", .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_RIGHTS] = {.key = "contentKeyRights", .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_USAGE] = {.key = "contentKeyUsage", .type = JSON_FIELD_INTEGER},
+            [TYPEJ_FIELD_KEY_NOT_BEFORE] = {.key = "contentKeyNotBefore", .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_NOT_ON_OR_AFTER] = {.key = "contentKeyNotOnOrAfter", .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_CACHEABLE] = {.key = "contentKeyCacheable", .type = JSON_FIELD_BOOL},
+            [TYPEJ_FIELD_ENTITLED_TA_IDS] = {.key = "entitledTaIds", .type = JSON_FIELD_STRING_ARRAY,
+                    .strings = entitled_ta_ids, .strings_capacity = MAX_NUM_ALLOWED_TA_IDS},
+            [TYPEJ_FIELD_KEY_CONTAINER_VERSION] = {.key = "contentKeyContainerVersion", .type = JSON_FIELD_INTEGER},
+            [TYPEJ_FIELD_KEY] = {.key = "contentKey", .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_LENGTH] = {.key = "contentKeyLength", .type = JSON_FIELD_INTEGER},
+            [TYPEJ_FIELD_KEY_TRANSPORT_ALGORITHM] = {.key = "contentKeyTransportAlgorithm",
+                    .type = JSON_FIELD_STRING},
+            [TYPEJ_FIELD_KEY_TRANSPORT_IV] = {.key = "contentKeyTransportIv", .type = JSON_FIELD_STRING}};
     do {
         unpacked = unpack_typej(in, in_length);
         if (unpacked == NULL) {
@@ -788,44 +751,35 @@ sa_status typej_unwrap(
             break;
         }
 
-        json_value = json_parse_bytes(unpacked->payload, unpacked->payload_length);
-        if (json_value == NULL) {
-            ERROR("json_parse_string failed");
-            status = SA_STATUS_INVALID_KEY_FORMAT;
-            break;
-        }
-
-        size_t fields_count;
-        fields = json_value_as_map(&fields_count, json_value);
-        if (fields == NULL) {
-            ERROR("json_value_as_map failed");
+        if (!json_extract_fields(fields, TYPEJ_FIELD_COUNT, unpacked->payload, unpacked->payload_length)) {
+            ERROR("json_extract_fields failed");
             status = SA_STATUS_INVALID_KEY_FORMAT;
             break;
         }
 
         sa_rights rights;
-        status = fields_to_rights(&rights, fields, fields_count);
+        status = fields_to_rights(&rights, fields);
         if (status != SA_STATUS_OK) {
             ERROR("fields_to_rights failed");
             break;
         }
 
-        const json_key_value_t* version_field = json_key_value_find("contentKeyContainerVersion", fields, fields_count);
-        long long version = version_field ? json_value_as_integer(version_field->value) : 1;
+        const json_field_t* version_field = &fields[TYPEJ_FIELD_KEY_CONTAINER_VERSION];
+        long long version = version_field->found ? version_field->integer : 1;
         if (version == 1) {
-            status = unwrap_key_v1(stored_key, fields, fields_count, &rights, stored_key_encryption);
+            status = unwrap_key_v1(stored_key, fields, &rights, stored_key_encryption);
             if (status != SA_STATUS_OK) {
                 ERROR("unwrap_key_v1 failed");
                 break;
             }
         } else if (version == 2) {
-            status = unwrap_key_v2(stored_key, fields, fields_count, &rights, stored_key_encryption);
+            status = unwrap_key_v2(stored_key, fields, &rights, stored_key_encryption);
             if (status != SA_STATUS_OK) {
                 ERROR("unwrap_key_v2 failed");
                 break;
             }
         } else if (version == 3) {
-            status = unwrap_key_v3(stored_key, fields, fields_count, &rights, stored_key_encryption);
+            status = unwrap_key_v3(stored_key, fields, &rights, stored_key_encryption);
             if (status != SA_STATUS_OK) {
                 ERROR("unwrap_key_v2 failed");
                 break;
@@ -841,8 +795,6 @@ sa_status typej_unwrap(
     } while (false);
 
     typej_unpacked_free(unpacked);
-    json_value_free(json_value);
-    memory_internal_free(fields);
 
     return status;
 }
@@ -944,3 +944,312 @@ sa_status unwrap_ec(
 
     return status;
 }
+
+struct unwrap_context_s {
+    sa_cipher_algorithm cipher_algorithm;
+    sa_rights wrapping_key_rights;
+    EVP_CIPHER_CTX* evp_cipher;
+};
+
+static const EVP_CIPHER* unwrap_context_cipher(
+        sa_cipher_algorithm cipher_algorithm,
+        size_t key_length) {
+
+    bool is_128 = key_length == SYM_128_KEY_SIZE;
+    switch (cipher_algorithm) {
+        case SA_CIPHER_ALGORITHM_AES_ECB:
+        case SA_CIPHER_ALGORITHM_AES_ECB_PKCS7:
+            return is_128 ? EVP_aes_128_ecb() : EVP_aes_256_ecb();
+
+        case SA_CIPHER_ALGORITHM_AES_CBC:
+        case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7:
+            return is_128 ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+
+        case SA_CIPHER_ALGORITHM_AES_CTR:
+            return is_128 ? EVP_aes_128_ctr() : EVP_aes_256_ctr();
+
+        case SA_CIPHER_ALGORITHM_AES_GCM:
+            return is_128 ? EVP_aes_128_gcm() : EVP_aes_256_gcm();
+
+        default:
+            return NULL;
+    }
+}
+
+unwrap_context_t* unwrap_context_create(
+        sa_cipher_algorithm cipher_algorithm,
+        const stored_key_t* stored_key_wrapping) {
+
+    if (stored_key_wrapping == NULL) {
+        ERROR("NULL stored_key_wrapping");
+        return NULL;
+    }
+
+    const void* key = stored_key_get_key(stored_key_wrapping);
+    if (key == NULL) {
+        ERROR("stored_key_get_key failed");
+        return NULL;
+    }
+
+    size_t key_length = stored_key_get_length(stored_key_wrapping);
+    if (key_length != SYM_128_KEY_SIZE && key_length != SYM_256_KEY_SIZE) {
+        ERROR("Invalid key_length");
+        return NULL;
+    }
+
+    const sa_header* header = stored_key_get_header(stored_key_wrapping);
+    if (header == NULL) {
+        ERROR("stored_key_get_header failed");
+        return NULL;
+    }
+
+    const EVP_CIPHER* cipher = unwrap_context_cipher(cipher_algorithm, key_length);
+    if (cipher == NULL) {
+        ERROR("Invalid cipher_algorithm");
+        return NULL;
+    }
+
+    bool status = false;
+    unwrap_context_t* context = NULL;
+    do {
+        context = memory_internal_alloc(sizeof(unwrap_context_t));
+        if (context == NULL) {
+            ERROR("memory_internal_alloc failed");
+            break;
+        }
+
+        memory_memset_unoptimizable(context, 0, sizeof(unwrap_context_t));
+        context->cipher_algorithm = cipher_algorithm;
+        context->wrapping_key_rights = header->rights;
+        context->evp_cipher = EVP_CIPHER_CTX_new();
+        if (context->evp_cipher == NULL) {
+            ERROR("EVP_CIPHER_CTX_new failed");
+            break;
+        }
+
+        // The key schedule is computed here once, each unwrap only supplies a new IV.
+        if (EVP_DecryptInit_ex(context->evp_cipher, cipher, NULL, key, NULL) != 1) {
+            ERROR("EVP_DecryptInit_ex failed");
+            break;
+        }
+
+        status = true;
+    } while (false);
+
+    if (!status) {
+        unwrap_context_free(context);
+        context = NULL;
+    }
+
+    return context;
+}
+
+sa_status unwrap_context_unwrap(
+        stored_key_t** stored_key_unwrapped,
+        unwrap_context_t* context,
+        const void* in,
+        size_t in_length,
+        const sa_rights* rights,
+        sa_key_type key_type,
+        void* type_parameters,
+        const void* algorithm_parameters) {
+
+    if (stored_key_unwrapped == NULL) {
+        ERROR("NULL stored_key_unwrapped");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (context == NULL) {
+        ERROR("NULL context");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in == NULL) {
+        ERROR("NULL in");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (rights == NULL) {
+        ERROR("NULL rights");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    const void* iv = NULL;
+    const sa_unwrap_parameters_aes_gcm* parameters_aes_gcm = NULL;
+    bool pkcs7 = false;
+    switch (context->cipher_algorithm) {
+        case SA_CIPHER_ALGORITHM_AES_ECB_PKCS7:
+            pkcs7 = true;
+            // fall through
+        case SA_CIPHER_ALGORITHM_AES_ECB:
+            if (in_length % AES_BLOCK_SIZE != 0) {
+                ERROR("Invalid in_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            break;
+
+        case SA_CIPHER_ALGORITHM_AES_CBC_PKCS7:
+            pkcs7 = true;
+            // fall through
+        case SA_CIPHER_ALGORITHM_AES_CBC: {
+            const sa_unwrap_parameters_aes_cbc* parameters_aes_cbc =
+                    (const sa_unwrap_parameters_aes_cbc*) algorithm_parameters;
+            if (parameters_aes_cbc == NULL || parameters_aes_cbc->iv == NULL) {
+                ERROR("NULL iv");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_cbc->iv_length != AES_BLOCK_SIZE) {
+                ERROR("Invalid iv_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (in_length % AES_BLOCK_SIZE != 0) {
+                ERROR("Invalid in_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            iv = parameters_aes_cbc->iv;
+            break;
+        }
+        case SA_CIPHER_ALGORITHM_AES_CTR: {
+            const sa_unwrap_parameters_aes_ctr* parameters_aes_ctr =
+                    (const sa_unwrap_parameters_aes_ctr*) algorithm_parameters;
+            if (parameters_aes_ctr == NULL || parameters_aes_ctr->ctr == NULL) {
+                ERROR("NULL ctr");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_ctr->ctr_length != AES_BLOCK_SIZE) {
+                ERROR("Invalid ctr_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            iv = parameters_aes_ctr->ctr;
+            break;
+        }
+        case SA_CIPHER_ALGORITHM_AES_GCM:
+            parameters_aes_gcm = (const sa_unwrap_parameters_aes_gcm*) algorithm_parameters;
+            if (parameters_aes_gcm == NULL || parameters_aes_gcm->iv == NULL) {
+                ERROR("NULL iv");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->iv_length != GCM_IV_LENGTH) {
+                ERROR("Invalid iv_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->aad == NULL && parameters_aes_gcm->aad_length > 0) {
+                ERROR("NULL aad");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->tag == NULL) {
+                ERROR("NULL tag");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_aes_gcm->tag_length > MAX_GCM_TAG_LENGTH) {
+                ERROR("Invalid tag_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            iv = parameters_aes_gcm->iv;
+            break;
+
+        default:
+            ERROR("Invalid cipher_algorithm");
+            return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (in_length == 0 || in_length > INT32_MAX) {
+        ERROR("Invalid in_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_status status = SA_STATUS_INTERNAL_ERROR;
+    uint8_t* unwrapped_key = NULL;
+    do {
+        unwrapped_key = memory_secure_alloc(in_length);
+        if (unwrapped_key == NULL) {
+            ERROR("memory_secure_alloc failed");
+            break;
+        }
+
+        // Re-initializing with a NULL cipher and key keeps the key schedule and resets the cipher state.
+        if (EVP_DecryptInit_ex(context->evp_cipher, NULL, NULL, NULL, iv) != 1) {
+            ERROR("EVP_DecryptInit_ex failed");
+            break;
+        }
+
+        if (EVP_CIPHER_CTX_set_padding(context->evp_cipher, 0) != 1) {
+            ERROR("EVP_CIPHER_CTX_set_padding failed");
+            break;
+        }
+
+        int length;
+        if (parameters_aes_gcm != NULL && parameters_aes_gcm->aad_length > 0) {
+            if (parameters_aes_gcm->aad_length > INT32_MAX ||
+                    EVP_DecryptUpdate(context->evp_cipher, NULL, &length, parameters_aes_gcm->aad,
+                            (int) parameters_aes_gcm->aad_length) != 1) {
+                ERROR("EVP_DecryptUpdate failed");
+                break;
+            }
+        }
+
+        length = (int) in_length;
+        if (EVP_DecryptUpdate(context->evp_cipher, unwrapped_key, &length, in, (int) in_length) != 1) {
+            ERROR("EVP_DecryptUpdate failed");
+            break;
+        }
+
+        if (parameters_aes_gcm != NULL) {
+            // set expected tag value
+            if (EVP_CIPHER_CTX_ctrl(context->evp_cipher, EVP_CTRL_GCM_SET_TAG, (int) parameters_aes_gcm->tag_length,
+                        (void*) parameters_aes_gcm->tag) != 1) { // NOLINT
+                ERROR("EVP_CIPHER_CTX_ctrl failed");
+                break;
+            }
+
+            int final_length = 0;
+            if (EVP_DecryptFinal_ex(context->evp_cipher, unwrapped_key + length, &final_length) != 1) {
+                ERROR("EVP_DecryptFinal_ex failed");
+                break;
+            }
+        }
+
+        uint8_t pad_value = 0;
+        if (pkcs7) {
+            if (!pad_check_pkcs7(&pad_value, unwrapped_key + in_length - AES_BLOCK_SIZE)) {
+                ERROR("pad_check_pkcs7 failed");
+                status = SA_STATUS_INVALID_KEY_FORMAT;
+                break;
+            }
+        }
+
+        status = import_key(stored_key_unwrapped, rights, &context->wrapping_key_rights, key_type, type_parameters,
+                unwrapped_key, in_length - pad_value);
+        if (status != SA_STATUS_OK) {
+            ERROR("import_key failed");
+            break;
+        }
+    } while (false);
+
+    if (unwrapped_key != NULL) {
+        memory_memset_unoptimizable(unwrapped_key, 0, in_length);
+        memory_secure_free(unwrapped_key);
+    }
+
+    return status;
+}
+
+void unwrap_context_free(unwrap_context_t* context) {
+    if (context == NULL)
+        return;
+
+    EVP_CIPHER_CTX_free(context->evp_cipher);
+    memory_memset_unoptimizable(context, 0, sizeof(unwrap_context_t));
+    memory_internal_free(context);
+}
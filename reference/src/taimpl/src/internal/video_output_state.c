@@ -0,0 +1,123 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "video_output_state.h" // NOLINT
+#include "log.h"
+#include <stdatomic.h>
+#include <threads.h>
+
+static once_flag flag = ONCE_FLAG_INIT;
+static mtx_t mutex;
+
+// Snapshot published with a sequence lock. The sequence is odd while an update is in progress and
+// the generation is half of the sequence. Fields are atomics so a reader racing with an update
+// observes a torn copy rather than undefined behavior, and then retries.
+static struct {
+    atomic_uint_fast64_t sequence;
+    atomic_int analog_unprotected_count;
+    atomic_int analog_cgmsa_count;
+    atomic_int digital_unprotected_count;
+    atomic_int digital_hdcp14_count;
+    atomic_int digital_hdcp22_count;
+    atomic_bool svp_enabled;
+} snapshot;
+
+static void publish(const video_output_state_t* state) {
+    if (state == NULL) {
+        ERROR("NULL state");
+        return;
+    }
+
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return;
+    }
+
+    uint_fast64_t sequence = atomic_load_explicit(&snapshot.sequence, memory_order_relaxed);
+    atomic_store_explicit(&snapshot.sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&snapshot.analog_unprotected_count, state->analog_unprotected_count, memory_order_relaxed);
+    atomic_store_explicit(&snapshot.analog_cgmsa_count, state->analog_cgmsa_count, memory_order_relaxed);
+    atomic_store_explicit(&snapshot.digital_unprotected_count, state->digital_unprotected_count,
+            memory_order_relaxed);
+    atomic_store_explicit(&snapshot.digital_hdcp14_count, state->digital_hdcp14_count, memory_order_relaxed);
+    atomic_store_explicit(&snapshot.digital_hdcp22_count, state->digital_hdcp22_count, memory_order_relaxed);
+    atomic_store_explicit(&snapshot.svp_enabled, state->svp_enabled, memory_order_relaxed);
+
+    atomic_store_explicit(&snapshot.sequence, sequence + 2, memory_order_release);
+
+    if (mtx_unlock(&mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
+}
+
+static void subscribe() {
+    if (mtx_init(&mutex, mtx_plain) != thrd_success) {
+        ERROR("mtx_init failed");
+        return;
+    }
+
+    if (!video_output_subscribe(publish)) {
+        ERROR("video_output_subscribe failed");
+    }
+}
+
+bool video_output_state_get(
+        video_output_state_t* state,
+        uint64_t* generation) {
+
+    if (state == NULL) {
+        ERROR("NULL state");
+        return false;
+    }
+
+    call_once(&flag, subscribe);
+
+    uint_fast64_t begin;
+    uint_fast64_t end;
+    do {
+        begin = atomic_load_explicit(&snapshot.sequence, memory_order_acquire);
+        state->analog_unprotected_count = atomic_load_explicit(&snapshot.analog_unprotected_count,
+                memory_order_relaxed);
+        state->analog_cgmsa_count = atomic_load_explicit(&snapshot.analog_cgmsa_count, memory_order_relaxed);
+        state->digital_unprotected_count = atomic_load_explicit(&snapshot.digital_unprotected_count,
+                memory_order_relaxed);
+        state->digital_hdcp14_count = atomic_load_explicit(&snapshot.digital_hdcp14_count, memory_order_relaxed);
+        state->digital_hdcp22_count = atomic_load_explicit(&snapshot.digital_hdcp22_count, memory_order_relaxed);
+        state->svp_enabled = atomic_load_explicit(&snapshot.svp_enabled, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&snapshot.sequence, memory_order_relaxed);
+    } while ((begin & 1) != 0 || begin != end);
+
+    if (begin == 0) {
+        ERROR("No video output state published");
+        return false;
+    }
+
+    if (generation != NULL)
+        *generation = begin / 2;
+
+    return true;
+}
+
+uint64_t video_output_state_generation() {
+    call_once(&flag, subscribe);
+    return atomic_load_explicit(&snapshot.sequence, memory_order_acquire) / 2;
+}
@@ -27,13 +27,8 @@ static void* openssl_secure_malloc(size_t size) {
 
 static void* openssl_secure_malloc(size_t size, const char* file, int line) {
 #endif
-    void* buffer = memory_secure_alloc(size);
-
-    if (buffer != NULL) {
-        memory_memset_unoptimizable(buffer, 0, size);
-    }
-
-    return buffer;
+    // memory_secure_alloc returns zero filled buffers.
+    return memory_secure_alloc(size);
 }
 
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
@@ -17,18 +17,314 @@
  */
 
 #include "porting/memory.h"
+#include "log.h"
+#include "porting/memory_internal.h"
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <threads.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+#include <arm_neon.h>
+#endif
+
+// The secure heap is a single mlock'd region carved into chunks. Each chunk serves one size class and
+// is split into equal blocks. Freed blocks are cleared and kept on a per thread cache before they are
+// returned to the per class free list, so blocks on either list are always zero filled. Requests larger
+// than the largest class, or made once the region is exhausted, fall back to the general heap.
+
+#ifndef SECURE_HEAP_SIZE
+#define SECURE_HEAP_SIZE (8 * 1024 * 1024)
+#endif
+
+#define SECURE_HEAP_CHUNK_SIZE (64 * 1024)
+#define SECURE_HEAP_MIN_BLOCK_SHIFT 4
+#define SECURE_HEAP_CLASS_COUNT 9 // 16 to 4096 bytes
+#define SECURE_HEAP_MAX_BLOCK_SIZE ((size_t) 1 << (SECURE_HEAP_MIN_BLOCK_SHIFT + SECURE_HEAP_CLASS_COUNT - 1))
+#define SECURE_HEAP_CACHE_SIZE 32
+#define SECURE_HEAP_NO_CLASS 0xff
+
+typedef struct secure_heap_block_s {
+    struct secure_heap_block_s* next;
+} secure_heap_block_t;
+
+typedef struct {
+    mtx_t mutex;
+    secure_heap_block_t* free_list;
+    uint8_t* next;
+    uint8_t* end;
+} secure_heap_class_t;
+
+typedef struct {
+    secure_heap_block_t* blocks[SECURE_HEAP_CACHE_SIZE];
+    size_t count;
+} secure_heap_cache_t;
+
+static struct {
+    once_flag once;
+    bool initialized;
+    uint8_t* base;
+    size_t chunk_stride;
+    size_t chunk_count;
+    mtx_t mutex;
+    size_t chunks_used;
+    uint8_t chunk_class[SECURE_HEAP_SIZE / SECURE_HEAP_CHUNK_SIZE];
+    secure_heap_class_t classes[SECURE_HEAP_CLASS_COUNT];
+    tss_t cache_key;
+} global_secure_heap = {.once = ONCE_FLAG_INIT};
+
+static _Thread_local secure_heap_cache_t* thread_cache = NULL;
+
+static inline size_t class_block_size(size_t class_index) {
+    return (size_t) 1 << (SECURE_HEAP_MIN_BLOCK_SHIFT + class_index);
+}
+
+static inline size_t size_to_class(size_t size) {
+    size_t class_index = 0;
+    while (class_block_size(class_index) < size)
+        class_index++;
+
+    return class_index;
+}
+
+static void secure_heap_class_push(
+        secure_heap_class_t* heap_class,
+        secure_heap_block_t** blocks,
+        size_t count) {
+
+    mtx_lock(&heap_class->mutex);
+    for (size_t i = 0; i < count; i++) {
+        blocks[i]->next = heap_class->free_list;
+        heap_class->free_list = blocks[i];
+    }
+
+    mtx_unlock(&heap_class->mutex);
+}
+
+static void secure_heap_cache_free(void* cache) {
+    secure_heap_cache_t* thread_caches = cache;
+    for (size_t i = 0; i < SECURE_HEAP_CLASS_COUNT; i++) {
+        secure_heap_class_push(&global_secure_heap.classes[i], thread_caches[i].blocks, thread_caches[i].count);
+    }
+
+    free(thread_caches);
+    thread_cache = NULL;
+}
+
+static void secure_heap_init() {
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    global_secure_heap.chunk_stride = SECURE_HEAP_CHUNK_SIZE;
+#ifdef SECURE_HEAP_GUARD_PAGES
+    // Follow every chunk with an inaccessible page to trap overruns.
+    global_secure_heap.chunk_stride += page_size;
+#endif
+    global_secure_heap.chunk_count = SECURE_HEAP_SIZE / SECURE_HEAP_CHUNK_SIZE;
+    size_t region_size = global_secure_heap.chunk_stride * global_secure_heap.chunk_count;
+
+    void* region = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        ERROR("mmap failed");
+        return;
+    }
+
+    if (mlock(region, region_size) != 0) {
+        WARN("mlock failed, secure heap may be swapped");
+    }
+
+#ifdef MADV_DONTDUMP
+    madvise(region, region_size, MADV_DONTDUMP);
+#endif
+
+#ifdef SECURE_HEAP_GUARD_PAGES
+    for (size_t i = 0; i < global_secure_heap.chunk_count; i++) {
+        uint8_t* guard = (uint8_t*) region + i * global_secure_heap.chunk_stride + SECURE_HEAP_CHUNK_SIZE;
+        if (mprotect(guard, page_size, PROT_NONE) != 0) {
+            ERROR("mprotect failed");
+            munmap(region, region_size);
+            return;
+        }
+    }
+#else
+    (void) page_size;
+#endif
+
+    if (tss_create(&global_secure_heap.cache_key, secure_heap_cache_free) != thrd_success) {
+        ERROR("tss_create failed");
+        munmap(region, region_size);
+        return;
+    }
+
+    if (mtx_init(&global_secure_heap.mutex, mtx_plain) != thrd_success) {
+        ERROR("mtx_init failed");
+        tss_delete(global_secure_heap.cache_key);
+        munmap(region, region_size);
+        return;
+    }
+
+    for (size_t i = 0; i < SECURE_HEAP_CLASS_COUNT; i++) {
+        if (mtx_init(&global_secure_heap.classes[i].mutex, mtx_plain) != thrd_success) {
+            ERROR("mtx_init failed");
+            for (size_t j = 0; j < i; j++)
+                mtx_destroy(&global_secure_heap.classes[j].mutex);
+
+            mtx_destroy(&global_secure_heap.mutex);
+            tss_delete(global_secure_heap.cache_key);
+            munmap(region, region_size);
+            return;
+        }
+    }
+
+    memset(global_secure_heap.chunk_class, SECURE_HEAP_NO_CLASS, sizeof(global_secure_heap.chunk_class));
+    global_secure_heap.base = region;
+    global_secure_heap.initialized = true;
+}
+
+static inline bool secure_heap_contains(const void* buffer) {
+    const uint8_t* pointer = buffer;
+    return global_secure_heap.base != NULL && pointer >= global_secure_heap.base &&
+           pointer < global_secure_heap.base + global_secure_heap.chunk_stride * global_secure_heap.chunk_count;
+}
+
+static inline size_t secure_heap_block_class(const void* buffer) {
+    size_t chunk = ((const uint8_t*) buffer - global_secure_heap.base) / global_secure_heap.chunk_stride;
+    return global_secure_heap.chunk_class[chunk];
+}
+
+static secure_heap_cache_t* secure_heap_thread_cache() {
+    if (thread_cache != NULL)
+        return thread_cache;
+
+    secure_heap_cache_t* caches = calloc(SECURE_HEAP_CLASS_COUNT, sizeof(secure_heap_cache_t));
+    if (caches == NULL)
+        return NULL;
+
+    if (tss_set(global_secure_heap.cache_key, caches) != thrd_success) {
+        free(caches);
+        return NULL;
+    }
+
+    thread_cache = caches;
+    return thread_cache;
+}
+
+static void* secure_heap_alloc(size_t class_index) {
+    secure_heap_cache_t* cache = secure_heap_thread_cache();
+    if (cache != NULL && cache[class_index].count > 0) {
+        secure_heap_block_t* block = cache[class_index].blocks[--cache[class_index].count];
+        block->next = NULL;
+        return block;
+    }
+
+    secure_heap_class_t* heap_class = &global_secure_heap.classes[class_index];
+    size_t block_size = class_block_size(class_index);
+    secure_heap_block_t* block = NULL;
+    mtx_lock(&heap_class->mutex);
+    do {
+        if (heap_class->free_list != NULL) {
+            block = heap_class->free_list;
+            heap_class->free_list = block->next;
+            block->next = NULL;
+            break;
+        }
+
+        if (heap_class->next == heap_class->end) {
+            mtx_lock(&global_secure_heap.mutex);
+            size_t chunk = global_secure_heap.chunks_used;
+            if (chunk < global_secure_heap.chunk_count) {
+                global_secure_heap.chunks_used++;
+                global_secure_heap.chunk_class[chunk] = (uint8_t) class_index;
+            }
+
+            mtx_unlock(&global_secure_heap.mutex);
+            if (chunk >= global_secure_heap.chunk_count)
+                break;
+
+            heap_class->next = global_secure_heap.base + chunk * global_secure_heap.chunk_stride;
+            heap_class->end = heap_class->next + SECURE_HEAP_CHUNK_SIZE;
+        }
+
+        // Fresh chunk memory is zero filled by mmap.
+        block = (secure_heap_block_t*) heap_class->next;
+        heap_class->next += block_size;
+    } while (false);
+
+    mtx_unlock(&heap_class->mutex);
+    return block;
+}
+
+static void secure_heap_free(void* buffer) {
+    size_t class_index = secure_heap_block_class(buffer);
+    memory_memset_unoptimizable(buffer, 0, class_block_size(class_index));
+
+    secure_heap_block_t* block = buffer;
+    secure_heap_cache_t* cache = secure_heap_thread_cache();
+    if (cache == NULL) {
+        secure_heap_class_push(&global_secure_heap.classes[class_index], &block, 1);
+        return;
+    }
+
+    secure_heap_cache_t* class_cache = &cache[class_index];
+    if (class_cache->count == SECURE_HEAP_CACHE_SIZE) {
+        // Return the older half of the cache to the shared list.
+        size_t flush = SECURE_HEAP_CACHE_SIZE / 2;
+        secure_heap_class_push(&global_secure_heap.classes[class_index], class_cache->blocks, flush);
+        memmove(class_cache->blocks, class_cache->blocks + flush,
+                (SECURE_HEAP_CACHE_SIZE - flush) * sizeof(secure_heap_block_t*));
+        class_cache->count -= flush;
+    }
+
+    class_cache->blocks[class_cache->count++] = block;
+}
 
 void* memory_secure_alloc(size_t size) {
-    return memory_internal_alloc(size);
+    if (size <= SECURE_HEAP_MAX_BLOCK_SIZE) {
+        call_once(&global_secure_heap.once, secure_heap_init);
+        if (global_secure_heap.initialized) {
+            void* buffer = secure_heap_alloc(size_to_class(size));
+            if (buffer != NULL)
+                return buffer;
+        }
+    }
+
+    return calloc(1, size);
 }
 
 void* memory_secure_realloc(void* buffer, size_t new_size) {
-    return memory_internal_realloc(buffer, new_size);
+    if (buffer == NULL)
+        return memory_secure_alloc(new_size);
+
+    if (!secure_heap_contains(buffer))
+        return realloc(buffer, new_size);
+
+    if (new_size == 0) {
+        secure_heap_free(buffer);
+        return NULL;
+    }
+
+    size_t block_size = class_block_size(secure_heap_block_class(buffer));
+    if (new_size <= block_size)
+        return buffer;
+
+    void* new_buffer = memory_secure_alloc(new_size);
+    if (new_buffer == NULL)
+        return NULL;
+
+    memcpy(new_buffer, buffer, block_size);
+    secure_heap_free(buffer);
+    return new_buffer;
 }
 
 void memory_secure_free(void* buffer) {
-    memory_internal_free(buffer);
+    if (secure_heap_contains(buffer)) {
+        secure_heap_free(buffer);
+        return;
+    }
+
+    free(buffer);
 }
 
 void* memory_internal_alloc(size_t size) {
@@ -36,14 +332,64 @@ void* memory_internal_alloc(size_t size) {
 }
 
 void* memory_internal_realloc(void* buffer, size_t new_size) {
+    if (secure_heap_contains(buffer))
+        return memory_secure_realloc(buffer, new_size);
+
     return realloc(buffer, new_size);
 }
 
 void memory_internal_free(void* buffer) {
+    // Buffers from memory_secure_alloc are also released here by some callers.
+    if (secure_heap_contains(buffer)) {
+        secure_heap_free(buffer);
+        return;
+    }
+
     free(buffer);
 }
 
-int memory_memcmp_constant(const void* in1, const void* in2, size_t length) {
+// Constant time primitives. Every implementation touches each byte exactly once regardless of the data
+// and accumulates differences without branching. Stores are either volatile or followed by a compiler
+// barrier so that clearing a buffer that is about to be released is never elided.
+
+#define MEMORY_BARRIER(pointer) __asm__ __volatile__("" : : "r"(pointer) : "memory")
+
+typedef int (*memcmp_constant_function)(const void* in1, const void* in2, size_t length);
+typedef void (*memset_unoptimizable_function)(void* destination, uint8_t value, size_t size);
+typedef void (*memcpy_streaming_function)(void* destination, const void* source, size_t size);
+
+// Streaming copies prefetch the source this many bytes ahead of the loads.
+#define MEMORY_PREFETCH_DISTANCE 512
+
+static inline int fold_difference(uint64_t difference) {
+    difference |= difference >> 32;
+    difference |= difference >> 16;
+    difference |= difference >> 8;
+    return (int) (difference & 0xff);
+}
+
+static inline int memcmp_constant_tail(
+        uint64_t difference,
+        const uint8_t* a,
+        const uint8_t* b,
+        size_t length) {
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word_a;
+        uint64_t word_b;
+        memcpy(&word_a, a + i, sizeof(uint64_t));
+        memcpy(&word_b, b + i, sizeof(uint64_t));
+        difference |= word_a ^ word_b;
+    }
+
+    for (; i < length; i++)
+        difference |= a[i] ^ b[i];
+
+    return fold_difference(difference);
+}
+
+static int memcmp_constant_byte(const void* in1, const void* in2, size_t length) {
     uint8_t* a = (uint8_t*) in1;
     uint8_t* b = (uint8_t*) in2;
 
@@ -55,12 +401,319 @@ int memory_memcmp_constant(const void* in1, const void* in2, size_t length) {
     return result;
 }
 
-void* memory_memset_unoptimizable(void* destination, uint8_t value, size_t size) {
+static void memset_unoptimizable_byte(void* destination, uint8_t value, size_t size) {
     volatile uint8_t* pointer = (uint8_t*) destination;
-    if (size == 0)
-        return destination;
+    while (size--)
+        *pointer++ = value;
+}
+
+// Implementations without non-temporal stores fall back to memcpy.
+static void memcpy_streaming_portable(void* destination, const void* source, size_t size) {
+    memcpy(destination, source, size);
+}
 
+static int memcmp_constant_portable(const void* in1, const void* in2, size_t length) {
+    return memcmp_constant_tail(0, in1, in2, length);
+}
+
+static void memset_unoptimizable_portable(void* destination, uint8_t value, size_t size) {
+    volatile uint8_t* pointer = (uint8_t*) destination;
+    while (size > 0 && ((uintptr_t) pointer % sizeof(uint64_t)) != 0) {
+        *pointer++ = value;
+        size--;
+    }
+
+    volatile uint64_t* word = (volatile uint64_t*) pointer;
+    uint64_t pattern = UINT64_C(0x0101010101010101) * value;
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t))
+        *word++ = pattern;
+
+    pointer = (volatile uint8_t*) word;
     while (size--)
         *pointer++ = value;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2"))) static int memcmp_constant_sse2(const void* in1, const void* in2, size_t length) {
+    const uint8_t* a = in1;
+    const uint8_t* b = in2;
+    __m128i difference = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+        __m128i block_a = _mm_loadu_si128((const __m128i*) (a + i));
+        __m128i block_b = _mm_loadu_si128((const __m128i*) (b + i));
+        difference = _mm_or_si128(difference, _mm_xor_si128(block_a, block_b));
+    }
+
+    difference = _mm_or_si128(difference, _mm_unpackhi_epi64(difference, difference));
+    uint64_t folded;
+    _mm_storel_epi64((__m128i*) &folded, difference);
+    return memcmp_constant_tail(folded, a + i, b + i, length - i);
+}
+
+__attribute__((target("sse2"))) static void memset_unoptimizable_sse2(void* destination, uint8_t value,
+        size_t size) {
+    uint8_t* pointer = destination;
+    __m128i pattern = _mm_set1_epi8((char) value);
+    size_t i = 0;
+    for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i))
+        _mm_storeu_si128((__m128i*) (pointer + i), pattern);
+
+    for (; i < size; i++)
+        pointer[i] = value;
+
+    MEMORY_BARRIER(destination);
+}
+
+__attribute__((target("sse2"))) static void memcpy_streaming_sse2(void* destination, const void* source,
+        size_t size) {
+    uint8_t* out = destination;
+    const uint8_t* in = source;
+
+    // Non-temporal stores need an aligned destination.
+    size_t head = (sizeof(__m128i) - ((uintptr_t) out % sizeof(__m128i))) % sizeof(__m128i);
+    if (head > size)
+        head = size;
+
+    memcpy(out, in, head);
+    size_t i = head;
+    for (; i + 4 * sizeof(__m128i) <= size; i += 4 * sizeof(__m128i)) {
+        __builtin_prefetch(in + i + MEMORY_PREFETCH_DISTANCE);
+        __m128i block0 = _mm_loadu_si128((const __m128i*) (in + i));
+        __m128i block1 = _mm_loadu_si128((const __m128i*) (in + i + sizeof(__m128i)));
+        __m128i block2 = _mm_loadu_si128((const __m128i*) (in + i + 2 * sizeof(__m128i)));
+        __m128i block3 = _mm_loadu_si128((const __m128i*) (in + i + 3 * sizeof(__m128i)));
+        _mm_stream_si128((__m128i*) (out + i), block0);
+        _mm_stream_si128((__m128i*) (out + i + sizeof(__m128i)), block1);
+        _mm_stream_si128((__m128i*) (out + i + 2 * sizeof(__m128i)), block2);
+        _mm_stream_si128((__m128i*) (out + i + 3 * sizeof(__m128i)), block3);
+    }
+
+    // Order the streaming stores before any later store, such as the release of the buffer lock.
+    _mm_sfence();
+    memcpy(out + i, in + i, size - i);
+}
+
+__attribute__((target("avx2"))) static int memcmp_constant_avx2(const void* in1, const void* in2, size_t length) {
+    const uint8_t* a = in1;
+    const uint8_t* b = in2;
+    __m256i difference = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+        __m256i block_a = _mm256_loadu_si256((const __m256i*) (a + i));
+        __m256i block_b = _mm256_loadu_si256((const __m256i*) (b + i));
+        difference = _mm256_or_si256(difference, _mm256_xor_si256(block_a, block_b));
+    }
+
+    __m128i half = _mm_or_si128(_mm256_castsi256_si128(difference), _mm256_extracti128_si256(difference, 1));
+    half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+    uint64_t folded;
+    _mm_storel_epi64((__m128i*) &folded, half);
+    return memcmp_constant_tail(folded, a + i, b + i, length - i);
+}
+
+__attribute__((target("avx2"))) static void memset_unoptimizable_avx2(void* destination, uint8_t value,
+        size_t size) {
+    uint8_t* pointer = destination;
+    __m256i pattern = _mm256_set1_epi8((char) value);
+    size_t i = 0;
+    for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i))
+        _mm256_storeu_si256((__m256i*) (pointer + i), pattern);
+
+    for (; i < size; i++)
+        pointer[i] = value;
+
+    MEMORY_BARRIER(destination);
+}
+
+__attribute__((target("avx2"))) static void memcpy_streaming_avx2(void* destination, const void* source,
+        size_t size) {
+    uint8_t* out = destination;
+    const uint8_t* in = source;
+    size_t head = (sizeof(__m256i) - ((uintptr_t) out % sizeof(__m256i))) % sizeof(__m256i);
+    if (head > size)
+        head = size;
+
+    memcpy(out, in, head);
+    size_t i = head;
+    for (; i + 2 * sizeof(__m256i) <= size; i += 2 * sizeof(__m256i)) {
+        __builtin_prefetch(in + i + MEMORY_PREFETCH_DISTANCE);
+        __m256i block0 = _mm256_loadu_si256((const __m256i*) (in + i));
+        __m256i block1 = _mm256_loadu_si256((const __m256i*) (in + i + sizeof(__m256i)));
+        _mm256_stream_si256((__m256i*) (out + i), block0);
+        _mm256_stream_si256((__m256i*) (out + i + sizeof(__m256i)), block1);
+    }
+
+    _mm_sfence();
+    memcpy(out + i, in + i, size - i);
+}
+#endif
+
+#if defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+static int memcmp_constant_neon(const void* in1, const void* in2, size_t length) {
+    const uint8_t* a = in1;
+    const uint8_t* b = in2;
+    uint8x16_t difference = vdupq_n_u8(0);
+    size_t i = 0;
+    for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t))
+        difference = vorrq_u8(difference, veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+
+    uint64x2_t words = vreinterpretq_u64_u8(difference);
+    uint64_t folded = vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1);
+    return memcmp_constant_tail(folded, a + i, b + i, length - i);
+}
+
+static void memset_unoptimizable_neon(void* destination, uint8_t value, size_t size) {
+    uint8_t* pointer = destination;
+    uint8x16_t pattern = vdupq_n_u8(value);
+    size_t i = 0;
+    for (; i + sizeof(uint8x16_t) <= size; i += sizeof(uint8x16_t))
+        vst1q_u8(pointer + i, pattern);
+
+    for (; i < size; i++)
+        pointer[i] = value;
+
+    MEMORY_BARRIER(destination);
+}
+#endif
+
+// The selected functions are stored atomically as memory_set_implementation may be called while other
+// threads are using them. Each function is complete on its own, so mixing two selections is harmless.
+static struct {
+    once_flag once;
+    _Atomic(memory_implementation_e) implementation;
+    _Atomic(memcmp_constant_function) memcmp_constant;
+    _Atomic(memset_unoptimizable_function) memset_unoptimizable;
+    _Atomic(memcpy_streaming_function) memcpy_streaming;
+} global_memory_primitives = {.once = ONCE_FLAG_INIT};
+
+bool memory_implementation_supported(memory_implementation_e implementation) {
+    switch (implementation) {
+        case MEMORY_IMPLEMENTATION_BYTE:
+        case MEMORY_IMPLEMENTATION_PORTABLE:
+            return true;
+
+#if defined(__x86_64__) || defined(__i386__)
+        case MEMORY_IMPLEMENTATION_SSE2:
+            // May run before constructors have initialized the CPU model.
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+
+        case MEMORY_IMPLEMENTATION_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+
+#if defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+        case MEMORY_IMPLEMENTATION_NEON:
+            return true;
+#endif
+
+        default:
+            return false;
+    }
+}
+
+static bool memory_primitives_select(memory_implementation_e implementation) {
+    memcmp_constant_function memcmp_constant = NULL;
+    memset_unoptimizable_function memset_unoptimizable = NULL;
+    memcpy_streaming_function memcpy_streaming = memcpy_streaming_portable;
+    switch (implementation) {
+        case MEMORY_IMPLEMENTATION_BYTE:
+            memcmp_constant = memcmp_constant_byte;
+            memset_unoptimizable = memset_unoptimizable_byte;
+            break;
+
+        case MEMORY_IMPLEMENTATION_PORTABLE:
+            memcmp_constant = memcmp_constant_portable;
+            memset_unoptimizable = memset_unoptimizable_portable;
+            break;
+
+#if defined(__x86_64__) || defined(__i386__)
+        case MEMORY_IMPLEMENTATION_SSE2:
+            memcmp_constant = memcmp_constant_sse2;
+            memset_unoptimizable = memset_unoptimizable_sse2;
+            memcpy_streaming = memcpy_streaming_sse2;
+            break;
+
+        case MEMORY_IMPLEMENTATION_AVX2:
+            memcmp_constant = memcmp_constant_avx2;
+            memset_unoptimizable = memset_unoptimizable_avx2;
+            memcpy_streaming = memcpy_streaming_avx2;
+            break;
+#endif
+
+#if defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+        case MEMORY_IMPLEMENTATION_NEON:
+            memcmp_constant = memcmp_constant_neon;
+            memset_unoptimizable = memset_unoptimizable_neon;
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    if (memcmp_constant == NULL || !memory_implementation_supported(implementation))
+        return false;
+
+    atomic_store_explicit(&global_memory_primitives.memcmp_constant, memcmp_constant, memory_order_relaxed);
+    atomic_store_explicit(&global_memory_primitives.memset_unoptimizable, memset_unoptimizable,
+            memory_order_relaxed);
+    atomic_store_explicit(&global_memory_primitives.memcpy_streaming, memcpy_streaming, memory_order_relaxed);
+    atomic_store_explicit(&global_memory_primitives.implementation, implementation, memory_order_relaxed);
+    return true;
+}
+
+static void memory_primitives_init() {
+    static const memory_implementation_e PREFERENCE[] = {
+            MEMORY_IMPLEMENTATION_AVX2,
+            MEMORY_IMPLEMENTATION_SSE2,
+            MEMORY_IMPLEMENTATION_NEON,
+            MEMORY_IMPLEMENTATION_PORTABLE};
+
+    for (size_t i = 0; i < sizeof(PREFERENCE) / sizeof(memory_implementation_e); i++) {
+        if (memory_primitives_select(PREFERENCE[i]))
+            return;
+    }
+}
+
+bool memory_set_implementation(memory_implementation_e implementation) {
+    // Run the default selection first so that it cannot later replace an explicit choice.
+    call_once(&global_memory_primitives.once, memory_primitives_init);
+    return memory_primitives_select(implementation);
+}
+
+memory_implementation_e memory_get_implementation() {
+    call_once(&global_memory_primitives.once, memory_primitives_init);
+    return atomic_load_explicit(&global_memory_primitives.implementation, memory_order_relaxed);
+}
+
+int memory_memcmp_constant(const void* in1, const void* in2, size_t length) {
+    call_once(&global_memory_primitives.once, memory_primitives_init);
+    memcmp_constant_function memcmp_constant =
+            atomic_load_explicit(&global_memory_primitives.memcmp_constant, memory_order_relaxed);
+    return memcmp_constant(in1, in2, length);
+}
+
+void* memory_memset_unoptimizable(void* destination, uint8_t value, size_t size) {
+    if (size == 0)
+        return destination;
+
+    call_once(&global_memory_primitives.once, memory_primitives_init);
+    memset_unoptimizable_function memset_unoptimizable =
+            atomic_load_explicit(&global_memory_primitives.memset_unoptimizable, memory_order_relaxed);
+    memset_unoptimizable(destination, value, size);
+    return destination;
+}
+
+void* memory_memcpy_streaming(void* destination, const void* source, size_t size) {
+    if (size == 0)
+        return destination;
+
+    call_once(&global_memory_primitives.once, memory_primitives_init);
+    memcpy_streaming_function memcpy_streaming =
+            atomic_load_explicit(&global_memory_primitives.memcpy_streaming, memory_order_relaxed);
+    memcpy_streaming(destination, source, size);
     return destination;
 }
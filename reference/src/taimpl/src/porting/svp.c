@@ -24,6 +24,13 @@
 #include "stored_key_internal.h"
 #include <memory.h>
 
+// Ranges at least this long are copied with non-temporal stores. Shorter ranges, such as NAL units, are likely to be
+// read back from the cache by the consumer of the buffer.
+#define SVP_STREAMING_THRESHOLD (256 * 1024)
+
+// Number of ranges ahead of the one being copied whose source and destination are prefetched.
+#define SVP_PREFETCH_RANGES 4
+
 // An SVP buffer contains a pointer to the SVP memory region and its size.
 struct svp_buffer_s {
     void* svp_memory;
@@ -43,6 +50,61 @@ static bool svp_validate_buffer(const svp_buffer_t* svp_buffer) {
     return true;
 }
 
+// The checks are written so that they cannot overflow for any offset and length.
+static bool svp_validate_offsets(
+        size_t out_size,
+        size_t in_size,
+        const sa_svp_offset* offsets,
+        size_t offsets_length) {
+
+    for (size_t i = 0; i < offsets_length; i++) {
+        if (offsets[i].length > out_size || offsets[i].out_offset > out_size - offsets[i].length) {
+            ERROR("attempting to write outside the bounds of output secure buffer");
+            return false;
+        }
+
+        if (offsets[i].length > in_size || offsets[i].in_offset > in_size - offsets[i].length) {
+            ERROR("attempting to read outside the bounds of input buffer");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Copy validated ranges. Consecutive ranges that are contiguous in both the input and the output are merged into a
+// single copy, and the ranges that follow are prefetched while the current one is copied. A buffer can be copied into
+// itself, in which case the ranges are copied in order with memmove, as the input and output of a range may overlap.
+static void svp_copy_ranges(
+        uint8_t* out,
+        const uint8_t* in,
+        const sa_svp_offset* offsets,
+        size_t offsets_length) {
+
+    size_t i = 0;
+    while (i < offsets_length) {
+        size_t out_offset = offsets[i].out_offset;
+        size_t in_offset = offsets[i].in_offset;
+        size_t length = offsets[i].length;
+        for (i++; i < offsets_length && offsets[i].out_offset == out_offset + length &&
+                  offsets[i].in_offset == in_offset + length;
+                i++)
+            length += offsets[i].length;
+
+        if (i + SVP_PREFETCH_RANGES < offsets_length) {
+            __builtin_prefetch(in + offsets[i + SVP_PREFETCH_RANGES].in_offset, 0);
+            __builtin_prefetch(out + offsets[i + SVP_PREFETCH_RANGES].out_offset, 1);
+        }
+
+        if (out == in)
+            memmove(out + out_offset, in + in_offset, length);
+        else if (length >= SVP_STREAMING_THRESHOLD)
+            memory_memcpy_streaming(out + out_offset, in + in_offset, length);
+        else
+            memcpy(out + out_offset, in + in_offset, length);
+    }
+}
+
 bool svp_create_buffer(
         svp_buffer_t** svp_buffer,
         void* svp_memory,
@@ -126,22 +188,10 @@ bool svp_write(
         return false;
     }
 
-    for (size_t i = 0; i < offsets_length; i++) {
-        if ((offsets[i].out_offset + offsets[i].length) > out_svp_buffer->size) {
-            ERROR("attempting to write outside the bounds of output secure buffer");
-            return false;
-        }
-
-        if ((offsets[i].in_offset + offsets[i].length) > in_length) {
-            ERROR("attempting to read outside the bounds of input buffer");
-            return false;
-        }
-    }
-
-    uint8_t* out_bytes = (uint8_t*) out_svp_buffer->svp_memory;
-    for (size_t i = 0; i < offsets_length; i++)
-        memcpy(out_bytes + offsets[i].out_offset, in + offsets[i].in_offset, offsets[i].length);
+    if (!svp_validate_offsets(out_svp_buffer->size, in_length, offsets, offsets_length))
+        return false;
 
+    svp_copy_ranges(out_svp_buffer->svp_memory, in, offsets, offsets_length);
     return true;
 }
 
@@ -176,22 +226,67 @@ bool svp_copy(
         return false;
     }
 
-    for (size_t i = 0; i < offsets_length; i++) {
-        if ((offsets[i].out_offset + offsets[i].length) > out_svp_buffer->size) {
-            ERROR("attempting to write outside the bounds of output secure buffer");
+    if (!svp_validate_offsets(out_svp_buffer->size, in_svp_buffer->size, offsets, offsets_length))
+        return false;
+
+    svp_copy_ranges(out_svp_buffer->svp_memory, in_svp_buffer->svp_memory, offsets, offsets_length);
+    return true;
+}
+
+bool svp_batch(
+        const svp_batch_operation_t* operations,
+        size_t operations_length) {
+
+    if (operations == NULL) {
+        ERROR("NULL operations");
+        return false;
+    }
+
+    // Validate the whole batch first so that a rejected batch leaves every buffer untouched.
+    for (size_t i = 0; i < operations_length; i++) {
+        if (operations[i].out_svp_buffer == NULL) {
+            ERROR("NULL out_svp_buffer");
             return false;
         }
 
-        if ((offsets[i].in_offset + offsets[i].length) > in_svp_buffer->size) {
-            ERROR("attempting to read outside the bounds of input secure buffer");
+        if (operations[i].offsets == NULL) {
+            ERROR("NULL offsets");
             return false;
         }
+
+        if (!svp_validate_buffer(operations[i].out_svp_buffer)) {
+            ERROR("svp_validate_buffer failed");
+            return false;
+        }
+
+        size_t in_size;
+        if (operations[i].in_svp_buffer != NULL) {
+            if (!svp_validate_buffer(operations[i].in_svp_buffer)) {
+                ERROR("svp_validate_buffer failed");
+                return false;
+            }
+
+            in_size = operations[i].in_svp_buffer->size;
+        } else {
+            if (operations[i].in == NULL && operations[i].in_length > 0) {
+                ERROR("NULL in");
+                return false;
+            }
+
+            in_size = operations[i].in_length;
+        }
+
+        if (!svp_validate_offsets(operations[i].out_svp_buffer->size, in_size, operations[i].offsets,
+                    operations[i].offsets_length))
+            return false;
     }
 
-    uint8_t* out_bytes = (uint8_t*) out_svp_buffer->svp_memory;
-    uint8_t* in_bytes = (uint8_t*) in_svp_buffer->svp_memory;
-    for (size_t i = 0; i < offsets_length; i++)
-        memcpy(out_bytes + offsets[i].out_offset, in_bytes + offsets[i].in_offset, offsets[i].length);
+    for (size_t i = 0; i < operations_length; i++) {
+        const uint8_t* in = operations[i].in_svp_buffer != NULL ? operations[i].in_svp_buffer->svp_memory :
+                                                                  operations[i].in;
+        svp_copy_ranges(operations[i].out_svp_buffer->svp_memory, in, operations[i].offsets,
+                operations[i].offsets_length);
+    }
 
     return true;
 }
@@ -262,6 +357,16 @@ bool svp_digest(
         size_t offset,
         size_t length) {
 
+    if (!svp_validate_buffer(svp_buffer)) {
+        ERROR("svp_validate_buffer failed");
+        return false;
+    }
+
+    if (length > svp_buffer->size || offset > svp_buffer->size - length) {
+        ERROR("offset and length outside of SVP buffer");
+        return false;
+    }
+
     if (!digest_sha(out, out_length, digest_algorithm, (uint8_t*) svp_buffer->svp_memory + offset, length, NULL, 0,
                 NULL, 0)) {
         ERROR("digest_sha failed");
@@ -271,6 +376,30 @@ bool svp_digest(
     return true;
 }
 
+bool svp_digest_update(
+        digest_context_t* context,
+        const svp_buffer_t* svp_buffer,
+        size_t offset,
+        size_t length) {
+
+    if (!svp_validate_buffer(svp_buffer)) {
+        ERROR("svp_validate_buffer failed");
+        return false;
+    }
+
+    if (length > svp_buffer->size || offset > svp_buffer->size - length) {
+        ERROR("offset and length outside of SVP buffer");
+        return false;
+    }
+
+    if (!digest_context_update(context, (uint8_t*) svp_buffer->svp_memory + offset, length)) {
+        ERROR("digest_context_update failed");
+        return false;
+    }
+
+    return true;
+}
+
 void* svp_get_svp_memory(const svp_buffer_t* svp_buffer) {
     if (svp_buffer == NULL)
         return NULL;
@@ -19,9 +19,14 @@
 #include "porting/video_output.h" // NOLINT
 #include "log.h"
 #include <memory.h>
+#include <threads.h>
+
+static once_flag flag = ONCE_FLAG_INIT;
+static mtx_t mutex;
 
 static struct {
     video_output_state_t state;
+    video_output_listener listener;
 } global_video_output = {
         .state = {
                 .analog_unprotected_count = 0,
@@ -29,16 +34,57 @@ static struct {
                 .digital_unprotected_count = 0,
                 .digital_hdcp14_count = 0,
                 .digital_hdcp22_count = 1,
-                .svp_enabled = true}};
+                .svp_enabled = true},
+        .listener = NULL};
+
+static void video_output_create() {
+    if (mtx_init(&mutex, mtx_plain) != thrd_success) {
+        ERROR("mtx_init failed");
+    }
+}
+
+bool video_output_subscribe(video_output_listener listener) {
+    call_once(&flag, video_output_create);
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return false;
+    }
+
+    global_video_output.listener = listener;
+
+    // deliver the current state so the subscriber starts from a known snapshot
+    if (listener != NULL)
+        listener(&global_video_output.state);
+
+    if (mtx_unlock(&mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
 
-bool video_output_poll(video_output_state_t* state) {
+    return true;
+}
+
+bool video_output_simulate(const video_output_state_t* state) {
 
     if (state == NULL) {
         ERROR("NULL state");
         return false;
     }
 
-    memcpy(state, &global_video_output.state, sizeof(video_output_state_t));
+    call_once(&flag, video_output_create);
+    if (mtx_lock(&mutex) != thrd_success) {
+        ERROR("mtx_lock failed");
+        return false;
+    }
+
+    memcpy(&global_video_output.state, state, sizeof(video_output_state_t));
+
+    // notifications are serialized by the mutex, listeners never run concurrently
+    if (global_video_output.listener != NULL)
+        global_video_output.listener(&global_video_output.state);
+
+    if (mtx_unlock(&mutex) != thrd_success) {
+        ERROR("mtx_unlock failed");
+    }
 
     return true;
 }
@@ -26,6 +26,7 @@
 #include "rights.h"
 #include "rsa.h"
 #include "ta_sa.h"
+#include "trace.h"
 
 static size_t get_required_length(
         cipher_t* cipher,
@@ -111,8 +112,8 @@ static sa_status ta_sa_crypto_cipher_process_symmetric(
 
     sa_cipher_mode cipher_mode = cipher_get_mode(cipher);
     if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-        if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_encrypt failed");
+        if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_encrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -125,8 +126,8 @@ static sa_status ta_sa_crypto_cipher_process_symmetric(
 
         *bytes_to_process = length;
     } else if (cipher_mode == SA_CIPHER_MODE_DECRYPT) {
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -385,6 +386,7 @@ sa_status ta_sa_crypto_cipher_process(
         ta_client client_slot,
         const sa_uuid* caller_uuid) {
 
+    TRACE_SPAN_SCOPE("ta_sa_crypto_cipher_process");
     if (caller_uuid == NULL) {
         ERROR("NULL caller_uuid");
         return SA_STATUS_NULL_PARAMETER;
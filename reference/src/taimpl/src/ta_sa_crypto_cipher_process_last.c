@@ -25,6 +25,7 @@
 #include "rights.h"
 #include "symmetric.h"
 #include "ta_sa.h"
+#include "trace.h"
 
 static size_t get_required_length(
         cipher_t* cipher,
@@ -100,8 +101,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_pkcs7(
     sa_status status = SA_STATUS_INTERNAL_ERROR;
     do {
         if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-            if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-                ERROR("rights_allowed_encrypt failed");
+            if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+                ERROR("rights_verdict_allowed_encrypt failed");
                 status = SA_STATUS_OPERATION_NOT_ALLOWED;
                 break;
             }
@@ -120,8 +121,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_pkcs7(
                 break;
             }
 
-            if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-                ERROR("rights_allowed_decrypt failed");
+            if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+                ERROR("rights_verdict_allowed_decrypt failed");
                 return SA_STATUS_OPERATION_NOT_ALLOWED;
             }
 
@@ -182,8 +183,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_ctr(
 
     sa_cipher_mode cipher_mode = cipher_get_mode(cipher);
     if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-        if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_encrypt failed");
+        if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_encrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -196,8 +197,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_ctr(
 
         *bytes_to_process = out_length;
     } else if (cipher_mode == SA_CIPHER_MODE_DECRYPT) {
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -258,8 +259,8 @@ static sa_status ta_sa_crypto_cipher_process_last_chacha20(
 
     sa_cipher_mode cipher_mode = cipher_get_mode(cipher);
     if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-        if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_encrypt failed");
+        if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_encrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -272,8 +273,8 @@ static sa_status ta_sa_crypto_cipher_process_last_chacha20(
 
         *bytes_to_process = out_length;
     } else if (cipher_mode == SA_CIPHER_MODE_DECRYPT) {
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -355,8 +356,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_gcm(
 
     sa_cipher_mode cipher_mode = cipher_get_mode(cipher);
     if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-        if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_encrypt failed");
+        if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_encrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -375,8 +376,8 @@ static sa_status ta_sa_crypto_cipher_process_last_aes_gcm(
 
         *bytes_to_process = out_length;
     } else if (cipher_mode == SA_CIPHER_MODE_DECRYPT) {
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -459,8 +460,8 @@ static sa_status ta_sa_crypto_cipher_process_last_chacha20_poly1305(
 
     sa_cipher_mode cipher_mode = cipher_get_mode(cipher);
     if (cipher_mode == SA_CIPHER_MODE_ENCRYPT) {
-        if (!rights_allowed_encrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_encrypt failed");
+        if (!rights_verdict_allowed_encrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_encrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -479,8 +480,8 @@ static sa_status ta_sa_crypto_cipher_process_last_chacha20_poly1305(
 
         *bytes_to_process = out_length;
     } else if (cipher_mode == SA_CIPHER_MODE_DECRYPT) {
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             return SA_STATUS_OPERATION_NOT_ALLOWED;
         }
 
@@ -515,6 +516,7 @@ sa_status ta_sa_crypto_cipher_process_last(
         ta_client client_slot,
         const sa_uuid* caller_uuid) {
 
+    TRACE_SPAN_SCOPE("ta_sa_crypto_cipher_process_last");
     if (caller_uuid == NULL) {
         ERROR("NULL caller_uuid");
         return SA_STATUS_NULL_PARAMETER;
@@ -53,30 +53,24 @@ static sa_status ta_sa_crypto_mac_init_hmac(
     }
 
     sa_status status;
-    stored_key_t* stored_key = NULL;
     hmac_context_t* hmac_context = NULL;
     do {
+        // The header is enough to check the usage rights. The key is only unwrapped if no keyed context is cached.
         key_store_t* key_store = client_get_key_store(client);
-        status = key_store_unwrap(&stored_key, key_store, key, caller_uuid);
+        sa_header header;
+        status = key_store_get_header(&header, key_store, key, caller_uuid);
         if (status != SA_STATUS_OK) {
-            ERROR("key_store_unwrap failed");
+            ERROR("key_store_get_header failed");
             break;
         }
 
-        const sa_header* header = stored_key_get_header(stored_key);
-        if (header == NULL) {
-            ERROR("stored_key_get_header failed");
-            status = SA_STATUS_NULL_PARAMETER;
-            break;
-        }
-
-        if (!rights_allowed_sign(&header->rights)) {
+        if (!rights_allowed_sign(&header.rights)) {
             ERROR("rights_allowed_sign failed");
             status = SA_STATUS_OPERATION_NOT_ALLOWED;
             break;
         }
 
-        if (!key_type_supports_hmac(header->type, header->size)) {
+        if (!key_type_supports_hmac(header.type, header.size)) {
             ERROR("key_type_supports_hmac failed");
             status = SA_STATUS_INVALID_KEY_TYPE;
             break;
@@ -91,10 +85,10 @@ static sa_status ta_sa_crypto_mac_init_hmac(
             break;
         }
 
-        hmac_context = hmac_context_create(parameters->digest_algorithm, stored_key);
-        if (hmac_context == NULL) {
-            ERROR("hmac_context_create failed");
-            status = SA_STATUS_INTERNAL_ERROR;
+        status = key_store_create_hmac_context(&hmac_context, key_store, key, parameters->digest_algorithm,
+                caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("key_store_create_hmac_context failed");
             break;
         }
 
@@ -109,7 +103,6 @@ static sa_status ta_sa_crypto_mac_init_hmac(
         hmac_context = NULL;
     } while (false);
 
-    stored_key_free(stored_key);
     hmac_context_free(hmac_context);
 
     return status;
@@ -138,39 +131,32 @@ static sa_status ta_sa_crypto_mac_init_cmac(
     }
 
     sa_status status;
-    stored_key_t* stored_key = NULL;
     cmac_context_t* cmac_context = NULL;
     do {
+        // The header is enough to check the usage rights. The key is only unwrapped if no keyed context is cached.
         key_store_t* key_store = client_get_key_store(client);
-        status = key_store_unwrap(&stored_key, key_store, key, caller_uuid);
+        sa_header header;
+        status = key_store_get_header(&header, key_store, key, caller_uuid);
         if (status != SA_STATUS_OK) {
-            ERROR("key_store_unwrap failed");
+            ERROR("key_store_get_header failed");
             break;
         }
 
-        const sa_header* header = stored_key_get_header(stored_key);
-        if (header == NULL) {
-            ERROR("stored_key_get_header failed");
-            status = SA_STATUS_NULL_PARAMETER;
-            break;
-        }
-
-        if (!rights_allowed_sign(&header->rights)) {
+        if (!rights_allowed_sign(&header.rights)) {
             ERROR("rights_allowed_sign failed");
             status = SA_STATUS_OPERATION_NOT_ALLOWED;
             break;
         }
 
-        if (!key_type_supports_aes(header->type, header->size)) {
+        if (!key_type_supports_aes(header.type, header.size)) {
             ERROR("key_type_supports_aes failed");
             status = SA_STATUS_INVALID_KEY_TYPE;
             break;
         }
 
-        cmac_context = cmac_context_create(stored_key);
-        if (cmac_context == NULL) {
-            ERROR("cmac_context_create failed");
-            status = SA_STATUS_INTERNAL_ERROR;
+        status = key_store_create_cmac_context(&cmac_context, key_store, key, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("key_store_create_cmac_context failed");
             break;
         }
 
@@ -185,7 +171,6 @@ static sa_status ta_sa_crypto_mac_init_cmac(
         cmac_context = NULL;
     } while (false);
 
-    stored_key_free(stored_key);
     cmac_context_free(cmac_context);
 
     return status;
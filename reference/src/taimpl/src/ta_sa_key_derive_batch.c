@@ -0,0 +1,314 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_store.h"
+#include "common.h"
+#include "digest.h"
+#include "kdf.h"
+#include "key_store.h"
+#include "key_type.h"
+#include "log.h"
+#include "porting/memory.h"
+#include "rights.h"
+#include "ta_sa.h"
+
+static bool is_valid_digest(sa_digest_algorithm digest_algorithm) {
+    return digest_algorithm == SA_DIGEST_ALGORITHM_SHA1 ||
+           digest_algorithm == SA_DIGEST_ALGORITHM_SHA256 ||
+           digest_algorithm == SA_DIGEST_ALGORITHM_SHA384 ||
+           digest_algorithm == SA_DIGEST_ALGORITHM_SHA512;
+}
+
+static sa_status validate_parameters(
+        sa_key* parent,
+        sa_kdf_algorithm kdf_algorithm,
+        const void* parameters) {
+
+    switch (kdf_algorithm) {
+        case SA_KDF_ALGORITHM_HKDF: {
+            const sa_kdf_parameters_hkdf* parameters_hkdf = (const sa_kdf_parameters_hkdf*) parameters;
+            if (parameters_hkdf->salt == NULL && parameters_hkdf->salt_length > 0) {
+                ERROR("NULL salt");
+                return SA_STATUS_NULL_PARAMETER;
+            }
+
+            if (parameters_hkdf->key_length > SYM_MAX_KEY_SIZE) {
+                ERROR("Invalid key_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (!is_valid_digest(parameters_hkdf->digest_algorithm)) {
+                ERROR("Invalid digest");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            *parent = parameters_hkdf->parent;
+            return SA_STATUS_OK;
+        }
+        case SA_KDF_ALGORITHM_CONCAT: {
+            const sa_kdf_parameters_concat* parameters_concat = (const sa_kdf_parameters_concat*) parameters;
+            if (parameters_concat->key_length > SYM_MAX_KEY_SIZE) {
+                ERROR("Invalid key_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (!is_valid_digest(parameters_concat->digest_algorithm)) {
+                ERROR("Invalid digest");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            *parent = parameters_concat->parent;
+            return SA_STATUS_OK;
+        }
+        case SA_KDF_ALGORITHM_ANSI_X963: {
+            const sa_kdf_parameters_ansi_x963* parameters_ansi_x963 = (const sa_kdf_parameters_ansi_x963*) parameters;
+            if (parameters_ansi_x963->key_length > SYM_MAX_KEY_SIZE) {
+                ERROR("Invalid key_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (!is_valid_digest(parameters_ansi_x963->digest_algorithm)) {
+                ERROR("Invalid digest");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            *parent = parameters_ansi_x963->parent;
+            return SA_STATUS_OK;
+        }
+        case SA_KDF_ALGORITHM_CMAC: {
+            const sa_kdf_parameters_cmac* parameters_cmac = (const sa_kdf_parameters_cmac*) parameters;
+            if (parameters_cmac->counter < 1 || parameters_cmac->counter > 4) {
+                ERROR("Invalid counter");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if ((parameters_cmac->key_length % SYM_128_KEY_SIZE) != 0) {
+                ERROR("Invalid key_length");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            if (parameters_cmac->key_length / SYM_128_KEY_SIZE > (size_t) (5 - parameters_cmac->counter)) {
+                ERROR("Invalid key_length, ctr combination");
+                return SA_STATUS_INVALID_PARAMETER;
+            }
+
+            *parent = parameters_cmac->parent;
+            return SA_STATUS_OK;
+        }
+        default:
+            ERROR("Invalid algorithm");
+            return SA_STATUS_INVALID_PARAMETER;
+    }
+}
+
+static sa_status derive_entry(
+        stored_key_t** stored_key_derived,
+        const sa_kdf_batch_entry* entry,
+        sa_kdf_algorithm kdf_algorithm,
+        const void* parameters,
+        const void* prk,
+        size_t prk_length,
+        const stored_key_t* stored_key_parent) {
+
+    switch (kdf_algorithm) {
+        case SA_KDF_ALGORITHM_HKDF: {
+            sa_kdf_parameters_hkdf parameters_hkdf = *(const sa_kdf_parameters_hkdf*) parameters;
+            parameters_hkdf.info = entry->info;
+            parameters_hkdf.info_length = entry->info_length;
+            return kdf_hkdf_hmac_expand(stored_key_derived, entry->rights, &parameters_hkdf, prk, prk_length,
+                    stored_key_parent);
+        }
+        case SA_KDF_ALGORITHM_CONCAT: {
+            sa_kdf_parameters_concat parameters_concat = *(const sa_kdf_parameters_concat*) parameters;
+            parameters_concat.info = entry->info;
+            parameters_concat.info_length = entry->info_length;
+            return kdf_concat_kdf(stored_key_derived, entry->rights, &parameters_concat, stored_key_parent);
+        }
+        case SA_KDF_ALGORITHM_ANSI_X963: {
+            sa_kdf_parameters_ansi_x963 parameters_ansi_x963 = *(const sa_kdf_parameters_ansi_x963*) parameters;
+            parameters_ansi_x963.info = entry->info;
+            parameters_ansi_x963.info_length = entry->info_length;
+            return kdf_ansi_x963(stored_key_derived, entry->rights, &parameters_ansi_x963, stored_key_parent);
+        }
+        case SA_KDF_ALGORITHM_CMAC: {
+            sa_kdf_parameters_cmac parameters_cmac = *(const sa_kdf_parameters_cmac*) parameters;
+            parameters_cmac.other_data = entry->info;
+            parameters_cmac.other_data_length = entry->info_length;
+            return kdf_ctr_cmac(stored_key_derived, entry->rights, &parameters_cmac, stored_key_parent);
+        }
+        default:
+            ERROR("Invalid algorithm");
+            return SA_STATUS_INVALID_PARAMETER;
+    }
+}
+
+sa_status ta_sa_key_derive_batch(
+        sa_kdf_batch_entry* entries,
+        size_t entries_length,
+        sa_kdf_algorithm kdf_algorithm,
+        void* parameters,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid) {
+
+    if (caller_uuid == NULL) {
+        ERROR("NULL caller_uuid");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length == 0) {
+        ERROR("Invalid entries_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (parameters == NULL) {
+        ERROR("NULL parameters");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    for (size_t i = 0; i < entries_length; i++) {
+        entries[i].key = INVALID_HANDLE;
+        if (entries[i].rights == NULL) {
+            ERROR("NULL rights");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].info == NULL && entries[i].info_length > 0) {
+            ERROR("NULL info");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+    }
+
+    sa_key parent;
+    sa_status status = validate_parameters(&parent, kdf_algorithm, parameters);
+    if (status != SA_STATUS_OK) {
+        ERROR("validate_parameters failed");
+        return status;
+    }
+
+    client_store_t* client_store = client_store_global();
+    client_t* client = NULL;
+    key_store_t* key_store = NULL;
+    stored_key_t* stored_key_parent = NULL;
+    uint8_t* prk = NULL;
+    size_t prk_length = DIGEST_MAX_LENGTH;
+    size_t derived_count = 0;
+    do {
+        status = client_store_acquire(&client, client_store, client_slot, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("client_store_acquire failed");
+            break;
+        }
+
+        key_store = client_get_key_store(client);
+        status = key_store_unwrap(&stored_key_parent, key_store, parent, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("key_store_unwrap failed");
+            break;
+        }
+
+        const sa_header* header = stored_key_get_header(stored_key_parent);
+        if (header == NULL) {
+            ERROR("stored_key_get_header failed");
+            status = SA_STATUS_NULL_PARAMETER;
+            break;
+        }
+
+        if (!rights_allowed_derive(&header->rights)) {
+            ERROR("rights_allowed_derive failed");
+            status = SA_STATUS_OPERATION_NOT_ALLOWED;
+            break;
+        }
+
+        if (header->type != SA_KEY_TYPE_SYMMETRIC) {
+            ERROR("Wrong key type");
+            status = SA_STATUS_INVALID_KEY_TYPE;
+            break;
+        }
+
+        if (kdf_algorithm == SA_KDF_ALGORITHM_HKDF) {
+            if (!key_type_supports_hmac(header->type, header->size)) {
+                ERROR("key_type_supports_hmac failed");
+                status = SA_STATUS_INVALID_KEY_TYPE;
+                break;
+            }
+
+            // The extract step does not depend on the info value, so it is shared by all entries.
+            prk = memory_secure_alloc(prk_length);
+            if (prk == NULL) {
+                ERROR("memory_secure_alloc failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            status = kdf_hkdf_hmac_extract(prk, &prk_length, parameters, stored_key_parent);
+            if (status != SA_STATUS_OK) {
+                ERROR("kdf_hkdf_hmac_extract failed");
+                break;
+            }
+        } else if (kdf_algorithm == SA_KDF_ALGORITHM_CMAC) {
+            if (!key_type_supports_aes(header->type, header->size)) {
+                ERROR("key_type_supports_aes failed");
+                status = SA_STATUS_INVALID_KEY_TYPE;
+                break;
+            }
+        }
+
+        for (; derived_count < entries_length; derived_count++) {
+            stored_key_t* stored_key_derived = NULL;
+            status = derive_entry(&stored_key_derived, &entries[derived_count], kdf_algorithm, parameters, prk,
+                    prk_length, stored_key_parent);
+            if (status != SA_STATUS_OK) {
+                ERROR("derive_entry failed");
+                break;
+            }
+
+            status = key_store_import_stored_key(&entries[derived_count].key, key_store, stored_key_derived,
+                    caller_uuid);
+            stored_key_free(stored_key_derived);
+            if (status != SA_STATUS_OK) {
+                ERROR("key_store_import_stored_key failed");
+                break;
+            }
+        }
+    } while (false);
+
+    if (status != SA_STATUS_OK && key_store != NULL) {
+        // Do not leave a partially derived batch behind.
+        for (size_t i = 0; i < derived_count; i++) {
+            if (key_store_remove(key_store, entries[i].key, caller_uuid) != SA_STATUS_OK)
+                ERROR("key_store_remove failed");
+
+            entries[i].key = INVALID_HANDLE;
+        }
+    }
+
+    if (prk != NULL) {
+        memory_memset_unoptimizable(prk, 0, DIGEST_MAX_LENGTH);
+        memory_secure_free(prk);
+    }
+
+    stored_key_free(stored_key_parent);
+    client_store_release(client_store, client_slot, client, caller_uuid);
+
+    return status;
+}
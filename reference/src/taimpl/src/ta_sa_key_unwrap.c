@@ -24,6 +24,7 @@
 #include "log.h"
 #include "rights.h"
 #include "ta_sa.h"
+#include "trace.h"
 #include "unwrap.h"
 
 static sa_status ta_sa_key_unwrap_aes_ecb(
@@ -912,6 +913,7 @@ sa_status ta_sa_key_unwrap(
         ta_client client_slot,
         const sa_uuid* caller_uuid) {
 
+    TRACE_SPAN_SCOPE("ta_sa_key_unwrap");
     if (caller_uuid == NULL) {
         ERROR("NULL caller_uuid");
         return SA_STATUS_NULL_PARAMETER;
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_store.h"
+#include "common.h"
+#include "key_store.h"
+#include "key_type.h"
+#include "log.h"
+#include "rights.h"
+#include "ta_sa.h"
+#include "unwrap.h"
+
+sa_status ta_sa_key_unwrap_batch(
+        sa_unwrap_batch_entry* entries,
+        size_t entries_length,
+        sa_cipher_algorithm cipher_algorithm,
+        sa_key wrapping_key,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid) {
+
+    if (caller_uuid == NULL) {
+        ERROR("NULL caller_uuid");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length == 0) {
+        ERROR("Invalid entries_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (cipher_algorithm != SA_CIPHER_ALGORITHM_AES_ECB && cipher_algorithm != SA_CIPHER_ALGORITHM_AES_ECB_PKCS7 &&
+            cipher_algorithm != SA_CIPHER_ALGORITHM_AES_CBC && cipher_algorithm != SA_CIPHER_ALGORITHM_AES_CBC_PKCS7 &&
+            cipher_algorithm != SA_CIPHER_ALGORITHM_AES_CTR && cipher_algorithm != SA_CIPHER_ALGORITHM_AES_GCM) {
+        ERROR("Invalid algorithm");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    for (size_t i = 0; i < entries_length; i++) {
+        entries[i].key = INVALID_HANDLE;
+        if (entries[i].rights == NULL) {
+            ERROR("NULL rights");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+
+        if (entries[i].in == NULL) {
+            ERROR("NULL in");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+    }
+
+    sa_status status;
+    client_store_t* client_store = client_store_global();
+    client_t* client = NULL;
+    key_store_t* key_store = NULL;
+    stored_key_t* stored_key_wrapping = NULL;
+    unwrap_context_t* unwrap_context = NULL;
+    size_t unwrapped_count = 0;
+    do {
+        status = client_store_acquire(&client, client_store, client_slot, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("client_store_acquire failed");
+            break;
+        }
+
+        key_store = client_get_key_store(client);
+        status = key_store_unwrap(&stored_key_wrapping, key_store, wrapping_key, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("key_store_unwrap failed");
+            break;
+        }
+
+        const sa_header* header = stored_key_get_header(stored_key_wrapping);
+        if (header == NULL) {
+            ERROR("stored_key_get_header failed");
+            status = SA_STATUS_NULL_PARAMETER;
+            break;
+        }
+
+        if (!rights_allowed_unwrap(&header->rights)) {
+            ERROR("rights_allowed_unwrap failed");
+            status = SA_STATUS_OPERATION_NOT_ALLOWED;
+            break;
+        }
+
+        if (!key_type_supports_aes(header->type, header->size)) {
+            ERROR("key_type_supports_aes failed");
+            status = SA_STATUS_INVALID_KEY_TYPE;
+            break;
+        }
+
+        // The wrapping key is scheduled once and shared by all entries.
+        unwrap_context = unwrap_context_create(cipher_algorithm, stored_key_wrapping);
+        if (unwrap_context == NULL) {
+            ERROR("unwrap_context_create failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        for (; unwrapped_count < entries_length; unwrapped_count++) {
+            sa_unwrap_batch_entry* entry = &entries[unwrapped_count];
+            stored_key_t* stored_key_unwrapped = NULL;
+            status = unwrap_context_unwrap(&stored_key_unwrapped, unwrap_context, entry->in, entry->in_length,
+                    entry->rights, SA_KEY_TYPE_SYMMETRIC, NULL, entry->algorithm_parameters);
+            if (status != SA_STATUS_OK) {
+                ERROR("unwrap_context_unwrap failed");
+                break;
+            }
+
+            status = key_store_import_stored_key(&entry->key, key_store, stored_key_unwrapped, caller_uuid);
+            stored_key_free(stored_key_unwrapped);
+            if (status != SA_STATUS_OK) {
+                ERROR("key_store_import_stored_key failed");
+                break;
+            }
+        }
+    } while (false);
+
+    if (status != SA_STATUS_OK && key_store != NULL) {
+        // Do not leave a partially unwrapped batch behind.
+        for (size_t i = 0; i < unwrapped_count; i++) {
+            if (key_store_remove(key_store, entries[i].key, caller_uuid) != SA_STATUS_OK)
+                ERROR("key_store_remove failed");
+
+            entries[i].key = INVALID_HANDLE;
+        }
+    }
+
+    unwrap_context_free(unwrap_context);
+    stored_key_free(stored_key_wrapping);
+    client_store_release(client_store, client_slot, client, caller_uuid);
+
+    return status;
+}
@@ -89,8 +89,8 @@ static sa_status verify_sample(
             break;
         }
 
-        if (!rights_allowed_decrypt(rights, SA_KEY_TYPE_SYMMETRIC)) {
-            ERROR("rights_allowed_decrypt failed");
+        if (!rights_verdict_allowed_decrypt(cipher_get_rights_verdict(cipher), rights)) {
+            ERROR("rights_verdict_allowed_decrypt failed");
             status = SA_STATUS_OPERATION_NOT_ALLOWED;
             break;
         }
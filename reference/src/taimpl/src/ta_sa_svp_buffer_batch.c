@@ -0,0 +1,178 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_store.h"
+#include "log.h"
+#include "porting/memory.h"
+#include "porting/svp.h"
+#include "ta_sa.h"
+#include "trace.h"
+#include <stdlib.h>
+
+static int compare_handles(
+        const void* a,
+        const void* b) {
+
+    sa_svp_buffer handle_a = *(const sa_svp_buffer*) a;
+    sa_svp_buffer handle_b = *(const sa_svp_buffer*) b;
+    return (handle_a > handle_b) - (handle_a < handle_b);
+}
+
+static svp_t* find_svp(
+        sa_svp_buffer handle,
+        const sa_svp_buffer* handles,
+        svp_t** svps,
+        size_t handles_length) {
+
+    const sa_svp_buffer* found = bsearch(&handle, handles, handles_length, sizeof(sa_svp_buffer), compare_handles);
+    return found != NULL ? svps[found - handles] : NULL;
+}
+
+sa_status ta_sa_svp_buffer_batch(
+        const void* in,
+        size_t in_length,
+        const sa_svp_batch_entry* entries,
+        size_t entries_length,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid) {
+
+    TRACE_SPAN_SCOPE("ta_sa_svp_buffer_batch");
+    if (caller_uuid == NULL) {
+        ERROR("NULL caller_uuid");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (in == NULL && in_length > 0) {
+        ERROR("NULL in");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries == NULL) {
+        ERROR("NULL entries");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (entries_length == 0 || entries_length > SIZE_MAX / (2 * sizeof(sa_svp_buffer))) {
+        ERROR("Invalid entries_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    for (size_t i = 0; i < entries_length; i++) {
+        if (entries[i].offsets == NULL) {
+            ERROR("NULL offsets");
+            return SA_STATUS_NULL_PARAMETER;
+        }
+    }
+
+    sa_status status;
+    client_store_t* client_store = client_store_global();
+    client_t* client = NULL;
+    svp_store_t* svp_store = NULL;
+    sa_svp_buffer* handles = NULL;
+    svp_t** svps = NULL;
+    size_t handles_length = 0;
+    size_t acquired = 0;
+    svp_batch_operation_t* operations = NULL;
+    do {
+        status = client_store_acquire(&client, client_store, client_slot, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("client_store_acquire failed");
+            break;
+        }
+
+        handles = memory_internal_alloc(2 * entries_length * sizeof(sa_svp_buffer));
+        svps = memory_internal_alloc(2 * entries_length * sizeof(svp_t*));
+        operations = memory_internal_alloc(entries_length * sizeof(svp_batch_operation_t));
+        if (handles == NULL || svps == NULL || operations == NULL) {
+            ERROR("memory_internal_alloc failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        for (size_t i = 0; i < entries_length; i++) {
+            handles[handles_length++] = entries[i].out;
+            if (entries[i].in != INVALID_HANDLE)
+                handles[handles_length++] = entries[i].in;
+        }
+
+        // Each buffer is acquired once, in ascending handle order, so that concurrent batches over the same buffers
+        // cannot deadlock.
+        qsort(handles, handles_length, sizeof(sa_svp_buffer), compare_handles);
+        size_t unique_length = 0;
+        for (size_t i = 0; i < handles_length; i++) {
+            if (unique_length == 0 || handles[unique_length - 1] != handles[i])
+                handles[unique_length++] = handles[i];
+        }
+
+        handles_length = unique_length;
+        svp_store = client_get_svp_store(client);
+        for (; acquired < handles_length; acquired++) {
+            status = svp_store_acquire_exclusive(&svps[acquired], svp_store, handles[acquired], caller_uuid);
+            if (status != SA_STATUS_OK) {
+                ERROR("svp_store_acquire_exclusive failed");
+                break;
+            }
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        for (size_t i = 0; i < entries_length; i++) {
+            operations[i].out_svp_buffer = svp_get_buffer(find_svp(entries[i].out, handles, svps, handles_length));
+            if (operations[i].out_svp_buffer == NULL) {
+                ERROR("NULL out_svp_buffer");
+                status = SA_STATUS_INVALID_SVP_BUFFER;
+                break;
+            }
+
+            operations[i].in_svp_buffer = NULL;
+            if (entries[i].in != INVALID_HANDLE) {
+                operations[i].in_svp_buffer = svp_get_buffer(find_svp(entries[i].in, handles, svps, handles_length));
+                if (operations[i].in_svp_buffer == NULL) {
+                    ERROR("NULL in_svp_buffer");
+                    status = SA_STATUS_INVALID_SVP_BUFFER;
+                    break;
+                }
+            }
+
+            operations[i].in = in;
+            operations[i].in_length = in_length;
+            operations[i].offsets = entries[i].offsets;
+            operations[i].offsets_length = entries[i].offsets_length;
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        if (!svp_batch(operations, entries_length)) {
+            ERROR("svp_batch failed");
+            status = SA_STATUS_INVALID_SVP_BUFFER;
+            break;
+        }
+    } while (false);
+
+    for (size_t i = acquired; i > 0; i--)
+        svp_store_release_exclusive(svp_store, handles[i - 1], svps[i - 1], caller_uuid);
+
+    memory_internal_free(operations);
+    memory_internal_free(svps);
+    memory_internal_free(handles);
+    client_store_release(client_store, client_slot, client, caller_uuid);
+
+    return status;
+}
@@ -71,6 +71,19 @@ sa_status ta_sa_svp_buffer_check(
         }
 
         svp_buffer_t* svp_buf = svp_get_buffer(svp);
+        if (svp_buf == NULL) {
+            ERROR("svp_get_buffer failed");
+            status = SA_STATUS_INVALID_SVP_BUFFER;
+            break;
+        }
+
+        size_t svp_size = svp_get_size(svp_buf);
+        if (length > svp_size || offset > svp_size - length) {
+            ERROR("offset and length outside of SVP buffer");
+            status = SA_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
         size_t buffer_digest_length = required_length;
         uint8_t buffer_digest[required_length];
         if (!svp_digest(buffer_digest, &buffer_digest_length, digest_algorithm, svp_buf, offset, length)) {
@@ -0,0 +1,146 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "client_store.h"
+#include "digest.h"
+#include "log.h"
+#include "porting/memory.h"
+#include "ta_sa.h"
+#include "transport.h"
+
+sa_status ta_sa_svp_buffer_check_ranges(
+        sa_svp_buffer svp_buffer,
+        const sa_svp_range* ranges,
+        size_t ranges_length,
+        sa_digest_algorithm digest_algorithm,
+        const void* hashes,
+        size_t hashes_length,
+        ta_client client_slot,
+        const sa_uuid* caller_uuid) {
+
+    if (ranges == NULL) {
+        ERROR("NULL ranges");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (hashes == NULL) {
+        ERROR("NULL hashes");
+        return SA_STATUS_NULL_PARAMETER;
+    }
+
+    if (is_ree(caller_uuid)) {
+        ERROR("ta_sa_svp_buffer_check_ranges can only be called by a TA");
+        return SA_STATUS_OPERATION_NOT_ALLOWED;
+    }
+
+    size_t required_length = digest_length(digest_algorithm);
+    if (required_length == (size_t) -1) {
+        ERROR("Invalid digest_algorithm");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    if (ranges_length == 0 || hashes_length % required_length != 0 ||
+            hashes_length / required_length != ranges_length) {
+        ERROR("Invalid hashes_length");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    sa_status status;
+    client_store_t* client_store = client_store_global();
+    client_t* client = NULL;
+    svp_store_t* svp_store = NULL;
+    svp_t* svp = NULL;
+    digest_context_t* digest_context = NULL;
+    do {
+        status = client_store_acquire(&client, client_store, client_slot, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("client_store_acquire failed");
+            break;
+        }
+
+        svp_store = client_get_svp_store(client);
+        status = svp_store_acquire_exclusive(&svp, svp_store, svp_buffer, caller_uuid);
+        if (status != SA_STATUS_OK) {
+            ERROR("svp_store_acquire_exclusive failed");
+            break;
+        }
+
+        svp_buffer_t* svp_buf = svp_get_buffer(svp);
+        if (svp_buf == NULL) {
+            ERROR("svp_get_buffer failed");
+            status = SA_STATUS_INVALID_SVP_BUFFER;
+            break;
+        }
+
+        size_t svp_size = svp_get_size(svp_buf);
+        status = SA_STATUS_OK;
+        for (size_t i = 0; i < ranges_length; i++) {
+            if (ranges[i].length > svp_size || ranges[i].offset > svp_size - ranges[i].length) {
+                ERROR("ranges[%zu] outside of SVP buffer", i);
+                status = SA_STATUS_INVALID_PARAMETER;
+                break;
+            }
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        // One context is reused for every range so that the digest implementation is only looked up once per call.
+        digest_context = digest_context_create(digest_algorithm);
+        if (digest_context == NULL) {
+            ERROR("digest_context_create failed");
+            status = SA_STATUS_INTERNAL_ERROR;
+            break;
+        }
+
+        bool mismatch = false;
+        const uint8_t* hash = hashes;
+        uint8_t buffer_digest[DIGEST_MAX_LENGTH];
+        for (size_t i = 0; i < ranges_length; i++) {
+            size_t buffer_digest_length = sizeof(buffer_digest);
+            if (!svp_digest_update(digest_context, svp_buf, ranges[i].offset, ranges[i].length) ||
+                    !digest_context_compute(buffer_digest, &buffer_digest_length, digest_context)) {
+                ERROR("svp digest failed");
+                status = SA_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            // Every range is checked so that the time taken does not reveal which range failed.
+            mismatch |= memory_memcmp_constant(buffer_digest, hash, required_length) != 0;
+            hash += required_length;
+        }
+
+        if (status != SA_STATUS_OK)
+            break;
+
+        if (mismatch) {
+            ERROR("hashes don't match");
+            status = SA_STATUS_VERIFICATION_FAILED;
+            break;
+        }
+    } while (false);
+
+    digest_context_free(digest_context);
+
+    if (svp != NULL)
+        svp_store_release_exclusive(svp_store, svp_buffer, svp, caller_uuid);
+
+    client_store_release(client_store, client_slot, client, caller_uuid);
+
+    return status;
+}
@@ -19,6 +19,7 @@
 #include "client_store.h"
 #include "log.h"
 #include "ta_sa.h"
+#include "trace.h"
 
 sa_status ta_sa_svp_buffer_copy(
         sa_svp_buffer out,
@@ -28,6 +29,7 @@ sa_status ta_sa_svp_buffer_copy(
         ta_client client_slot,
         const sa_uuid* caller_uuid) {
 
+    TRACE_SPAN_SCOPE("ta_sa_svp_buffer_copy");
     if (caller_uuid == NULL) {
         ERROR("NULL caller_uuid");
         return SA_STATUS_NULL_PARAMETER;
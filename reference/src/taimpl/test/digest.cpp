@@ -0,0 +1,139 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "digest.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+
+namespace {
+    using digest_context_ptr = std::unique_ptr<digest_context_t, decltype(&digest_context_free)>;
+
+    class DigestContextTest : public ::testing::TestWithParam<sa_digest_algorithm> {};
+
+    std::vector<uint8_t> sequence(size_t length) {
+        std::vector<uint8_t> data(length);
+        for (size_t i = 0; i < length; i++)
+            data[i] = static_cast<uint8_t>(i * 31 + 7);
+
+        return data;
+    }
+
+    TEST_P(DigestContextTest, nominalMatchesSingleShot) {
+        sa_digest_algorithm digest_algorithm = GetParam();
+        auto data = sequence(10000);
+
+        std::vector<uint8_t> expected(DIGEST_MAX_LENGTH);
+        size_t expected_length = expected.size();
+        ASSERT_TRUE(digest_sha(expected.data(), &expected_length, digest_algorithm, data.data(), data.size(), nullptr,
+                0, nullptr, 0));
+
+        digest_context_ptr context(digest_context_create(digest_algorithm), digest_context_free);
+        ASSERT_NE(context, nullptr);
+        ASSERT_EQ(digest_context_get_digest(context.get()), digest_algorithm);
+
+        // Uneven chunks, including an empty one, crossing the internal block boundaries.
+        size_t offset = 0;
+        for (size_t chunk : {1, 0, 63, 64, 65, 1000, 127}) {
+            ASSERT_TRUE(digest_context_update(context.get(), data.data() + offset, chunk));
+            offset += chunk;
+        }
+
+        ASSERT_TRUE(digest_context_update(context.get(), data.data() + offset, data.size() - offset));
+
+        std::vector<uint8_t> out(DIGEST_MAX_LENGTH);
+        size_t out_length = out.size();
+        ASSERT_TRUE(digest_context_compute(out.data(), &out_length, context.get()));
+        ASSERT_EQ(out_length, expected_length);
+        out.resize(out_length);
+        expected.resize(expected_length);
+        ASSERT_EQ(out, expected);
+    }
+
+    TEST_P(DigestContextTest, nominalReuseAfterCompute) {
+        sa_digest_algorithm digest_algorithm = GetParam();
+        auto first = sequence(300);
+        auto second = sequence(4097);
+
+        digest_context_ptr context(digest_context_create(digest_algorithm), digest_context_free);
+        ASSERT_NE(context, nullptr);
+
+        std::vector<uint8_t> out(DIGEST_MAX_LENGTH);
+        size_t out_length = out.size();
+        ASSERT_TRUE(digest_context_update(context.get(), first.data(), first.size()));
+        ASSERT_TRUE(digest_context_compute(out.data(), &out_length, context.get()));
+
+        // The second digest must not include any data from the first.
+        size_t half = second.size() / 2;
+        ASSERT_TRUE(digest_context_update(context.get(), second.data(), half));
+        ASSERT_TRUE(digest_context_update(context.get(), second.data() + half, second.size() - half));
+        out_length = out.size();
+        ASSERT_TRUE(digest_context_compute(out.data(), &out_length, context.get()));
+        out.resize(out_length);
+
+        std::vector<uint8_t> expected(DIGEST_MAX_LENGTH);
+        size_t expected_length = expected.size();
+        ASSERT_TRUE(digest_sha(expected.data(), &expected_length, digest_algorithm, second.data(), second.size(),
+                nullptr, 0, nullptr, 0));
+        expected.resize(expected_length);
+        ASSERT_EQ(out, expected);
+
+        // A compute with no updates is the digest of the empty input.
+        out.resize(DIGEST_MAX_LENGTH);
+        out_length = out.size();
+        ASSERT_TRUE(digest_context_compute(out.data(), &out_length, context.get()));
+        out.resize(out_length);
+
+        expected.resize(DIGEST_MAX_LENGTH);
+        expected_length = expected.size();
+        ASSERT_TRUE(digest_sha(expected.data(), &expected_length, digest_algorithm, nullptr, 0, nullptr, 0, nullptr,
+                0));
+        expected.resize(expected_length);
+        ASSERT_EQ(out, expected);
+    }
+
+    TEST_P(DigestContextTest, failsShortOut) {
+        digest_context_ptr context(digest_context_create(GetParam()), digest_context_free);
+        ASSERT_NE(context, nullptr);
+
+        std::vector<uint8_t> out(DIGEST_MAX_LENGTH);
+        size_t out_length = digest_length(GetParam()) - 1;
+        ASSERT_FALSE(digest_context_compute(out.data(), &out_length, context.get()));
+    }
+
+    TEST(DigestContext, failsInvalidAlgorithm) {
+        ASSERT_EQ(digest_context_create(static_cast<sa_digest_algorithm>(UINT8_MAX)), nullptr);
+    }
+
+    TEST(DigestContext, failsNullContext) {
+        uint8_t in = 0;
+        std::vector<uint8_t> out(DIGEST_MAX_LENGTH);
+        size_t out_length = out.size();
+        ASSERT_FALSE(digest_context_update(nullptr, &in, sizeof(in)));
+        ASSERT_FALSE(digest_context_compute(out.data(), &out_length, nullptr));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+            DigestContextTests,
+            DigestContextTest,
+            ::testing::Values(
+                    SA_DIGEST_ALGORITHM_SHA1,
+                    SA_DIGEST_ALGORITHM_SHA256,
+                    SA_DIGEST_ALGORITHM_SHA384,
+                    SA_DIGEST_ALGORITHM_SHA512));
+} // namespace
@@ -19,8 +19,23 @@
 #include "json.h"
 #include "porting/memory.h"
 #include "gtest/gtest.h"
+#include <string>
 
 namespace {
+    json_field_t make_field(
+            const char* key,
+            json_field_type_e type,
+            json_slice_t* strings = nullptr,
+            size_t strings_capacity = 0) {
+
+        json_field_t field = {};
+        field.key = key;
+        field.type = type;
+        field.strings = strings;
+        field.strings_capacity = strings_capacity;
+        return field;
+    }
+
     TEST(Json, parseBoolTrue) {
         const char* json = "true";
 
@@ -317,4 +332,99 @@ namespace {
         memory_internal_free(array);
         memory_internal_free(map);
     }
+
+    TEST(Json, extractFields) {
+        std::string json =
+                R"({"str":"value","skip":{"str":"nested","arr":[1,{"int":2}]},"int":-5,"bool":true,"arr":["a","bc"]})";
+        json_slice_t strings[2];
+        json_field_t fields[] = {
+                make_field("str", JSON_FIELD_STRING),
+                make_field("int", JSON_FIELD_INTEGER),
+                make_field("bool", JSON_FIELD_BOOL),
+                make_field("arr", JSON_FIELD_STRING_ARRAY, strings, 2),
+                make_field("missing", JSON_FIELD_STRING)};
+
+        ASSERT_TRUE(json_extract_fields(fields, 5, &json[0], json.size()));
+        ASSERT_TRUE(fields[0].found);
+        EXPECT_EQ(fields[0].string.length, 5);
+        EXPECT_STREQ(fields[0].string.string, "value");
+        EXPECT_GE(fields[0].string.string, json.data());
+        EXPECT_LT(fields[0].string.string, json.data() + json.size());
+        ASSERT_TRUE(fields[1].found);
+        EXPECT_EQ(fields[1].integer, -5);
+        ASSERT_TRUE(fields[2].found);
+        EXPECT_TRUE(fields[2].boolean);
+        ASSERT_TRUE(fields[3].found);
+        ASSERT_EQ(fields[3].strings_length, 2);
+        EXPECT_STREQ(strings[0].string, "a");
+        EXPECT_STREQ(strings[1].string, "bc");
+        EXPECT_FALSE(fields[4].found);
+    }
+
+    TEST(Json, extractFieldsEscaped) {
+        std::string json = R"({"str":"a\"b\\c\u0041","arr":["\/x"]})";
+        json_slice_t strings[1];
+        json_field_t fields[] = {
+                make_field("str", JSON_FIELD_STRING),
+                make_field("arr", JSON_FIELD_STRING_ARRAY, strings, 1)};
+
+        ASSERT_TRUE(json_extract_fields(fields, 2, &json[0], json.size()));
+        ASSERT_TRUE(fields[0].found);
+        EXPECT_EQ(fields[0].string.length, 6);
+        EXPECT_STREQ(fields[0].string.string, "a\"b\\cA");
+        ASSERT_EQ(fields[1].strings_length, 1);
+        EXPECT_STREQ(strings[0].string, "/x");
+    }
+
+    TEST(Json, extractFieldsFirstOccurrence) {
+        std::string json = R"({"int":1,"int":2})";
+        json_field_t field = make_field("int", JSON_FIELD_INTEGER);
+
+        ASSERT_TRUE(json_extract_fields(&field, 1, &json[0], json.size()));
+        EXPECT_EQ(field.integer, 1);
+    }
+
+    TEST(Json, extractFieldsFailsInvalidType) {
+        std::string json = R"({"int":"1"})";
+        json_field_t field = make_field("int", JSON_FIELD_INTEGER);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
+
+    TEST(Json, extractFieldsFailsNull) {
+        std::string json = R"({"str":null})";
+        json_field_t field = make_field("str", JSON_FIELD_STRING);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
+
+    TEST(Json, extractFieldsFailsTooManyStrings) {
+        std::string json = R"({"arr":["a","b"]})";
+        json_slice_t strings[1];
+        json_field_t field = make_field("arr", JSON_FIELD_STRING_ARRAY, strings, 1);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
+
+    TEST(Json, extractFieldsFailsNonStringArrayValue) {
+        std::string json = R"({"arr":["a",1]})";
+        json_slice_t strings[2];
+        json_field_t field = make_field("arr", JSON_FIELD_STRING_ARRAY, strings, 2);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
+
+    TEST(Json, extractFieldsFailsNotMap) {
+        std::string json = R"(["str"])";
+        json_field_t field = make_field("str", JSON_FIELD_STRING);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
+
+    TEST(Json, extractFieldsFailsInvalidJson) {
+        std::string json = R"({"str":"value")";
+        json_field_t field = make_field("str", JSON_FIELD_STRING);
+
+        EXPECT_FALSE(json_extract_fields(&field, 1, &json[0], json.size()));
+    }
 } // namespace
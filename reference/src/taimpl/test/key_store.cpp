@@ -0,0 +1,150 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "key_store.h"
+#include "common.h"
+#include "reclaimer.h"
+#include "sa_rights.h"
+#include "stored_key_internal.h"
+#include "ta_test_helpers.h"
+#include "gtest/gtest.h"
+
+using namespace ta_test_helpers;
+
+namespace {
+    class KeyStoreMacCacheTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            store = std::shared_ptr<key_store_t>(key_store_init(128), key_store_shutdown);
+            ASSERT_NE(store, nullptr);
+
+            clear_key = random(SYM_256_KEY_SIZE);
+            key = import(clear_key);
+            ASSERT_NE(key, INVALID_HANDLE);
+        }
+
+        sa_key import(const std::vector<uint8_t>& clear) {
+            sa_rights rights;
+            sa_rights_set_allow_all(&rights);
+
+            sa_type_parameters type_parameters = {};
+            stored_key_t* stored_key = nullptr;
+            if (stored_key_create(&stored_key, &rights, nullptr, SA_KEY_TYPE_SYMMETRIC, &type_parameters,
+                        clear.size(), clear.data(), clear.size()) != SA_STATUS_OK)
+                return INVALID_HANDLE;
+
+            sa_key result = INVALID_HANDLE;
+            sa_status status = key_store_import_stored_key(&result, store.get(), stored_key, ta_uuid());
+            stored_key_free(stored_key);
+            return status == SA_STATUS_OK ? result : INVALID_HANDLE;
+        }
+
+        std::shared_ptr<key_store_t> store;
+        std::vector<uint8_t> clear_key;
+        sa_key key = INVALID_HANDLE;
+    };
+
+    TEST_F(KeyStoreMacCacheTest, hmacCachedPerDigest) {
+        key_store_mac_cache_stats_t before;
+        key_store_get_mac_cache_stats(&before);
+
+        std::vector<uint8_t> data = random(AES_BLOCK_SIZE);
+        std::vector<uint8_t> expected(SHA256_DIGEST_LENGTH);
+        for (int i = 0; i < 3; i++) {
+            hmac_context_t* context = nullptr;
+            ASSERT_EQ(key_store_create_hmac_context(&context, store.get(), key, SA_DIGEST_ALGORITHM_SHA256,
+                              ta_uuid()),
+                    SA_STATUS_OK);
+            std::shared_ptr<hmac_context_t> guard(context, hmac_context_free);
+
+            ASSERT_EQ(hmac_context_update(context, data.data(), data.size()), SA_STATUS_OK);
+            std::vector<uint8_t> mac(SHA256_DIGEST_LENGTH);
+            size_t mac_length = mac.size();
+            ASSERT_EQ(hmac_context_compute(mac.data(), &mac_length, context), SA_STATUS_OK);
+            if (i == 0)
+                expected = mac;
+            else
+                ASSERT_EQ(mac, expected);
+        }
+
+        hmac_context_t* context = nullptr;
+        ASSERT_EQ(key_store_create_hmac_context(&context, store.get(), key, SA_DIGEST_ALGORITHM_SHA1, ta_uuid()),
+                SA_STATUS_OK);
+        hmac_context_free(context);
+
+        key_store_mac_cache_stats_t after;
+        key_store_get_mac_cache_stats(&after);
+        ASSERT_EQ(after.misses - before.misses, 2U);
+        ASSERT_EQ(after.hits - before.hits, 2U);
+        ASSERT_EQ(after.entries - before.entries, 2U);
+    }
+
+    TEST_F(KeyStoreMacCacheTest, cmacCached) {
+        key_store_mac_cache_stats_t before;
+        key_store_get_mac_cache_stats(&before);
+
+        for (int i = 0; i < 2; i++) {
+            cmac_context_t* context = nullptr;
+            ASSERT_EQ(key_store_create_cmac_context(&context, store.get(), key, ta_uuid()), SA_STATUS_OK);
+            cmac_context_free(context);
+        }
+
+        key_store_mac_cache_stats_t after;
+        key_store_get_mac_cache_stats(&after);
+        ASSERT_EQ(after.misses - before.misses, 1U);
+        ASSERT_EQ(after.hits - before.hits, 1U);
+    }
+
+    TEST_F(KeyStoreMacCacheTest, evictedOnRemove) {
+        hmac_context_t* hmac_context = nullptr;
+        ASSERT_EQ(key_store_create_hmac_context(&hmac_context, store.get(), key, SA_DIGEST_ALGORITHM_SHA512,
+                          ta_uuid()),
+                SA_STATUS_OK);
+        hmac_context_free(hmac_context);
+
+        cmac_context_t* cmac_context = nullptr;
+        ASSERT_EQ(key_store_create_cmac_context(&cmac_context, store.get(), key, ta_uuid()), SA_STATUS_OK);
+        cmac_context_free(cmac_context);
+
+        key_store_mac_cache_stats_t before;
+        key_store_get_mac_cache_stats(&before);
+        ASSERT_EQ(key_store_remove(store.get(), key, ta_uuid()), SA_STATUS_OK);
+        reclaimer_flush();
+
+        key_store_mac_cache_stats_t after;
+        key_store_get_mac_cache_stats(&after);
+        ASSERT_EQ(after.evictions - before.evictions, 2U);
+        ASSERT_EQ(before.entries - after.entries, 2U);
+    }
+
+    TEST_F(KeyStoreMacCacheTest, failsInvalidDigest) {
+        hmac_context_t* context = nullptr;
+        ASSERT_EQ(key_store_create_hmac_context(&context, store.get(), key, static_cast<sa_digest_algorithm>(-1),
+                          ta_uuid()),
+                SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(context, nullptr);
+    }
+
+    TEST_F(KeyStoreMacCacheTest, failsInvalidSlot) {
+        hmac_context_t* context = nullptr;
+        ASSERT_EQ(key_store_create_hmac_context(&context, store.get(), INVALID_HANDLE, SA_DIGEST_ALGORITHM_SHA256,
+                          ta_uuid()),
+                SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(context, nullptr);
+    }
+} // namespace
@@ -0,0 +1,253 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "porting/memory.h"
+#include "porting/memory_internal.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool is_zero(
+            const void* buffer,
+            size_t size) {
+
+        const auto* bytes = static_cast<const uint8_t*>(buffer);
+        return std::all_of(bytes, bytes + size, [](uint8_t b) { return b == 0; });
+    }
+
+    TEST(Memory, secureAllocZeroFilled) {
+        for (size_t size : {0, 1, 15, 16, 17, 100, 512, 4096, 4097, 100000}) {
+            auto* buffer = static_cast<uint8_t*>(memory_secure_alloc(size));
+            ASSERT_NE(buffer, nullptr);
+            EXPECT_TRUE(is_zero(buffer, size));
+            memset(buffer, 0xa5, size);
+            memory_secure_free(buffer);
+        }
+
+        // Reused blocks are cleared on release.
+        for (size_t size : {16, 32, 256, 4096}) {
+            auto* buffer = static_cast<uint8_t*>(memory_secure_alloc(size));
+            ASSERT_NE(buffer, nullptr);
+            EXPECT_TRUE(is_zero(buffer, size));
+            memory_secure_free(buffer);
+        }
+    }
+
+    TEST(Memory, secureAllocDistinct) {
+        std::vector<uint8_t*> buffers;
+        for (size_t i = 0; i < 1000; i++) {
+            auto* buffer = static_cast<uint8_t*>(memory_secure_alloc(48));
+            ASSERT_NE(buffer, nullptr);
+            memset(buffer, static_cast<int>(i & 0xff), 48);
+            buffers.push_back(buffer);
+        }
+
+        for (size_t i = 0; i < buffers.size(); i++) {
+            EXPECT_EQ(buffers[i][0], i & 0xff);
+            EXPECT_EQ(buffers[i][47], i & 0xff);
+            memory_secure_free(buffers[i]);
+        }
+    }
+
+    TEST(Memory, secureRealloc) {
+        auto* buffer = static_cast<uint8_t*>(memory_secure_realloc(nullptr, 20));
+        ASSERT_NE(buffer, nullptr);
+        memset(buffer, 0x5a, 20);
+
+        buffer = static_cast<uint8_t*>(memory_secure_realloc(buffer, 24));
+        ASSERT_NE(buffer, nullptr);
+        buffer = static_cast<uint8_t*>(memory_secure_realloc(buffer, 3000));
+        ASSERT_NE(buffer, nullptr);
+        buffer = static_cast<uint8_t*>(memory_secure_realloc(buffer, 10000));
+        ASSERT_NE(buffer, nullptr);
+        for (size_t i = 0; i < 20; i++)
+            EXPECT_EQ(buffer[i], 0x5a);
+
+        memory_secure_free(buffer);
+    }
+
+    TEST(Memory, secureFreeWithInternalFree) {
+        void* buffer = memory_secure_alloc(64);
+        ASSERT_NE(buffer, nullptr);
+        memory_internal_free(buffer);
+
+        buffer = memory_internal_alloc(64);
+        ASSERT_NE(buffer, nullptr);
+        memory_secure_free(buffer);
+
+        memory_secure_free(nullptr);
+        memory_internal_free(nullptr);
+    }
+
+    TEST(Memory, secureAllocThreads) {
+        std::vector<std::thread> threads;
+        std::vector<void*> handoff(8 * 256);
+        for (size_t t = 0; t < 8; t++) {
+            threads.emplace_back([t, &handoff] {
+                for (size_t i = 0; i < 256; i++) {
+                    size_t size = 16 + (i * 37 + t) % 2048;
+                    auto* buffer = static_cast<uint8_t*>(memory_secure_alloc(size));
+                    if (buffer == nullptr || !is_zero(buffer, size)) {
+                        ADD_FAILURE() << "invalid secure heap buffer";
+                        return;
+                    }
+
+                    memset(buffer, 0xff, size);
+                    if (i % 2 == 0)
+                        memory_secure_free(buffer);
+                    else
+                        handoff[t * 256 + i] = buffer;
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        // Blocks allocated on other threads can be released here.
+        for (void* buffer : handoff)
+            memory_secure_free(buffer);
+    }
+    class MemoryImplementationTest : public ::testing::TestWithParam<memory_implementation_e> {
+    protected:
+        void SetUp() override {
+            if (!memory_implementation_supported(GetParam()))
+                GTEST_SKIP() << "Implementation not supported on this CPU";
+
+            previous = memory_get_implementation();
+            ASSERT_TRUE(memory_set_implementation(GetParam()));
+        }
+
+        void TearDown() override {
+            if (memory_implementation_supported(GetParam()))
+                memory_set_implementation(previous);
+        }
+
+        static int reference_memcmp(
+                const uint8_t* a,
+                const uint8_t* b,
+                size_t length) {
+
+            int result = 0;
+            for (size_t i = 0; i < length; i++)
+                result |= a[i] ^ b[i];
+
+            return result;
+        }
+
+        memory_implementation_e previous = MEMORY_IMPLEMENTATION_PORTABLE;
+    };
+
+    TEST_P(MemoryImplementationTest, memcmpConstantEquivalent) {
+        std::mt19937 generator(1);
+        std::vector<uint8_t> a(300 + 8);
+        std::generate(a.begin(), a.end(), [&generator] { return static_cast<uint8_t>(generator()); });
+
+        for (size_t offset = 0; offset < 4; offset++) {
+            for (size_t length = 0; length <= 300; length++) {
+                std::vector<uint8_t> b(a);
+                ASSERT_EQ(memory_memcmp_constant(a.data() + offset, b.data() + offset, length), 0);
+
+                for (size_t position = 0; position < length; position++) {
+                    uint8_t flip = static_cast<uint8_t>(1 << (position % 8)) | 0x10;
+                    b[offset + position] ^= flip;
+                    ASSERT_EQ(memory_memcmp_constant(a.data() + offset, b.data() + offset, length),
+                            reference_memcmp(a.data() + offset, b.data() + offset, length))
+                            << "offset " << offset << " length " << length << " position " << position;
+                    b[offset + position] ^= flip;
+                }
+
+                // Differences outside of the compared range are ignored.
+                b[offset + length] ^= 0xff;
+                ASSERT_EQ(memory_memcmp_constant(a.data() + offset, b.data() + offset, length), 0);
+            }
+        }
+    }
+
+    TEST_P(MemoryImplementationTest, memcmpConstantLarge) {
+        std::mt19937 generator(2);
+        std::vector<uint8_t> a(1024 * 1024 + 3);
+        std::generate(a.begin(), a.end(), [&generator] { return static_cast<uint8_t>(generator()); });
+        std::vector<uint8_t> b(a);
+
+        EXPECT_EQ(memory_memcmp_constant(a.data(), b.data(), a.size()), 0);
+        b[a.size() / 2] ^= 0x81;
+        b[a.size() - 1] ^= 0x02;
+        EXPECT_EQ(memory_memcmp_constant(a.data(), b.data(), a.size()), 0x83);
+    }
+
+    TEST_P(MemoryImplementationTest, memsetUnoptimizable) {
+        std::vector<uint8_t> buffer(300 + 16);
+        for (size_t offset = 0; offset < 8; offset++) {
+            for (size_t length = 0; length <= 300; length++) {
+                std::fill(buffer.begin(), buffer.end(), 0xcc);
+                uint8_t* destination = buffer.data() + 1 + offset;
+                ASSERT_EQ(memory_memset_unoptimizable(destination, 0x5a, length), destination);
+
+                for (size_t i = 0; i < buffer.size(); i++) {
+                    bool inside = buffer.data() + i >= destination && buffer.data() + i < destination + length;
+                    ASSERT_EQ(buffer[i], inside ? 0x5a : 0xcc)
+                            << "offset " << offset << " length " << length << " index " << i;
+                }
+            }
+        }
+    }
+
+    TEST_P(MemoryImplementationTest, memcpyStreaming) {
+        std::mt19937 generator(3);
+        std::vector<uint8_t> source(300 + 64);
+        std::generate(source.begin(), source.end(), [&generator] { return static_cast<uint8_t>(generator()); });
+        std::vector<uint8_t> buffer(source.size() + 64);
+        for (size_t offset = 0; offset < 40; offset++) {
+            for (size_t length = 0; length <= 300; length++) {
+                std::fill(buffer.begin(), buffer.end(), 0xcc);
+                uint8_t* destination = buffer.data() + offset;
+                ASSERT_EQ(memory_memcpy_streaming(destination, source.data() + offset % 3, length), destination);
+
+                for (size_t i = 0; i < buffer.size(); i++) {
+                    bool inside = buffer.data() + i >= destination && buffer.data() + i < destination + length;
+                    ASSERT_EQ(buffer[i], inside ? source[i - offset + offset % 3] : 0xcc)
+                            << "offset " << offset << " length " << length << " index " << i;
+                }
+            }
+        }
+    }
+
+    TEST_P(MemoryImplementationTest, memcpyStreamingLarge) {
+        std::mt19937 generator(4);
+        std::vector<uint8_t> source(4 * 1024 * 1024 + 5);
+        std::generate(source.begin(), source.end(), [&generator] { return static_cast<uint8_t>(generator()); });
+        std::vector<uint8_t> destination(source.size() + 1);
+        memory_memcpy_streaming(destination.data() + 1, source.data(), source.size());
+        EXPECT_TRUE(std::equal(source.begin(), source.end(), destination.begin() + 1));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+            MemoryImplementationTests,
+            MemoryImplementationTest,
+            ::testing::Values(
+                    MEMORY_IMPLEMENTATION_BYTE,
+                    MEMORY_IMPLEMENTATION_PORTABLE,
+                    MEMORY_IMPLEMENTATION_SSE2,
+                    MEMORY_IMPLEMENTATION_AVX2,
+                    MEMORY_IMPLEMENTATION_NEON));
+} // namespace
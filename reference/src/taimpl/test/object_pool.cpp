@@ -0,0 +1,202 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "object_pool.h" // NOLINT
+#include "cipher_store.h"
+#include "common.h"
+#include "mac_store.h"
+#include "reclaimer.h"
+#include "sa_rights.h"
+#include "stored_key_internal.h"
+#include "symmetric.h"
+#include "ta_test_helpers.h"
+#include "gtest/gtest.h"
+
+using namespace ta_test_helpers;
+
+namespace {
+    size_t live_objects = 0;
+
+    void* create_object() {
+        live_objects++;
+        return new int(0);
+    }
+
+    void free_object(void* object) {
+        live_objects--;
+        delete static_cast<int*>(object);
+    }
+
+    std::shared_ptr<object_pool_t> create_pool(size_t capacity) {
+        return {object_pool_init(create_object, free_object, capacity), object_pool_shutdown};
+    }
+
+    object_pool_stats_t get_stats(object_pool_t* pool) {
+        object_pool_stats_t stats = {};
+        EXPECT_EQ(object_pool_get_stats(&stats, pool), SA_STATUS_OK);
+        return stats;
+    }
+
+    stored_key_t* create_stored_key() {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+
+        auto clear_key = random(SYM_128_KEY_SIZE);
+        sa_type_parameters type_parameters = {};
+        stored_key_t* stored_key = nullptr;
+        if (stored_key_create(&stored_key, &rights, nullptr, SA_KEY_TYPE_SYMMETRIC, &type_parameters,
+                    clear_key.size(), clear_key.data(), clear_key.size()) != SA_STATUS_OK)
+            return nullptr;
+
+        return stored_key;
+    }
+
+    TEST(ObjectPoolInit, failsOnNullCreate) {
+        EXPECT_EQ(object_pool_init(nullptr, free_object, 4), nullptr);
+    }
+
+    TEST(ObjectPoolInit, failsOnNullFree) {
+        EXPECT_EQ(object_pool_init(create_object, nullptr, 4), nullptr);
+    }
+
+    TEST(ObjectPoolShutdown, noThrowOnNull) {
+        EXPECT_NO_THROW(object_pool_shutdown(nullptr)); // NOLINT
+    }
+
+    TEST(ObjectPoolAcquire, reusesReleasedObjects) {
+        auto pool = create_pool(4);
+        ASSERT_NE(pool, nullptr);
+
+        void* first = object_pool_acquire(pool.get());
+        ASSERT_NE(first, nullptr);
+        object_pool_release(pool.get(), first);
+
+        for (size_t i = 0; i < 100; i++) {
+            void* object = object_pool_acquire(pool.get());
+            ASSERT_EQ(object, first);
+            object_pool_release(pool.get(), object);
+        }
+
+        auto stats = get_stats(pool.get());
+        EXPECT_EQ(stats.capacity, 4);
+        EXPECT_EQ(stats.available, 1);
+        EXPECT_EQ(stats.created, 1);
+        EXPECT_EQ(stats.reused, 100);
+        EXPECT_EQ(stats.destroyed, 0);
+    }
+
+    TEST(ObjectPoolRelease, destroysWhenFull) {
+        auto pool = create_pool(2);
+        ASSERT_NE(pool, nullptr);
+
+        std::vector<void*> objects;
+        for (size_t i = 0; i < 4; i++)
+            objects.push_back(object_pool_acquire(pool.get()));
+
+        EXPECT_EQ(live_objects, 4);
+        for (void* object : objects)
+            object_pool_release(pool.get(), object);
+
+        EXPECT_EQ(live_objects, 2);
+        auto stats = get_stats(pool.get());
+        EXPECT_EQ(stats.available, 2);
+        EXPECT_EQ(stats.created, 4);
+        EXPECT_EQ(stats.destroyed, 2);
+
+        pool.reset();
+        EXPECT_EQ(live_objects, 0);
+    }
+
+    TEST(ObjectPoolRelease, zeroCapacityDisablesPooling) {
+        auto pool = create_pool(0);
+        ASSERT_NE(pool, nullptr);
+
+        for (size_t i = 0; i < 10; i++)
+            object_pool_release(pool.get(), object_pool_acquire(pool.get()));
+
+        EXPECT_EQ(live_objects, 0);
+        auto stats = get_stats(pool.get());
+        EXPECT_EQ(stats.created, 10);
+        EXPECT_EQ(stats.reused, 0);
+        EXPECT_EQ(stats.destroyed, 10);
+    }
+
+    TEST(ObjectPoolGetStats, failsOnNullStats) {
+        auto pool = create_pool(1);
+        EXPECT_EQ(object_pool_get_stats(nullptr, pool.get()), SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST(CipherStorePool, steadyStateDoesNotAllocate) {
+        std::shared_ptr<cipher_store_t> store(cipher_store_init(128, 4), cipher_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        object_pool_stats_t symmetric_before = {};
+        for (size_t i = 0; i < 100; i++) {
+            stored_key_t* stored_key = create_stored_key();
+            ASSERT_NE(stored_key, nullptr);
+            symmetric_context_t* symmetric_context = symmetric_create_aes_ecb_encrypt_context(stored_key, false);
+            ASSERT_NE(symmetric_context, nullptr);
+
+            sa_crypto_cipher_context context = INVALID_HANDLE;
+            ASSERT_EQ(cipher_store_add_symmetric_context(&context, store.get(), SA_CIPHER_ALGORITHM_AES_ECB,
+                              SA_CIPHER_MODE_ENCRYPT, symmetric_context, stored_key, ta_uuid()),
+                    SA_STATUS_OK);
+            ASSERT_EQ(cipher_store_remove(store.get(), context, ta_uuid()), SA_STATUS_OK);
+            reclaimer_flush();
+
+            if (i == 0) {
+                ASSERT_EQ(symmetric_get_pool_stats(&symmetric_before), SA_STATUS_OK);
+            }
+        }
+
+        object_pool_stats_t stats = {};
+        ASSERT_EQ(cipher_store_get_pool_stats(&stats, store.get()), SA_STATUS_OK);
+        EXPECT_EQ(stats.created, 1);
+        EXPECT_EQ(stats.reused, 99);
+        EXPECT_EQ(stats.available, 1);
+
+        object_pool_stats_t symmetric_after = {};
+        ASSERT_EQ(symmetric_get_pool_stats(&symmetric_after), SA_STATUS_OK);
+        EXPECT_EQ(symmetric_after.created, symmetric_before.created);
+        EXPECT_EQ(symmetric_after.reused - symmetric_before.reused, 99);
+    }
+
+    TEST(MacStorePool, steadyStateDoesNotAllocate) {
+        std::shared_ptr<mac_store_t> store(mac_store_init(128, 4), mac_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        std::shared_ptr<stored_key_t> stored_key(create_stored_key(), stored_key_free);
+        ASSERT_NE(stored_key, nullptr);
+
+        for (size_t i = 0; i < 100; i++) {
+            hmac_context_t* hmac_context = hmac_context_create(SA_DIGEST_ALGORITHM_SHA256, stored_key.get());
+            ASSERT_NE(hmac_context, nullptr);
+
+            sa_crypto_mac_context context = INVALID_HANDLE;
+            ASSERT_EQ(mac_store_add_hmac_context(&context, store.get(), hmac_context, ta_uuid()), SA_STATUS_OK);
+            ASSERT_EQ(mac_store_remove(store.get(), context, ta_uuid()), SA_STATUS_OK);
+            reclaimer_flush();
+        }
+
+        object_pool_stats_t stats = {};
+        ASSERT_EQ(mac_store_get_pool_stats(&stats, store.get()), SA_STATUS_OK);
+        EXPECT_EQ(stats.created, 1);
+        EXPECT_EQ(stats.reused, 99);
+    }
+} // namespace
@@ -17,8 +17,10 @@
  */
 
 #include "object_store.h"
+#include "reclaimer.h"
 #include "ta_test_helpers.h"
 #include "gtest/gtest.h"
+#include <atomic>
 
 using namespace ta_test_helpers;
 
@@ -26,6 +28,12 @@ namespace {
     void noop(void* obj) {
     }
 
+    std::atomic<size_t> freed_count(0);
+
+    void count_free(void* obj) {
+        freed_count++;
+    }
+
     TEST(ObjectStoreInit, nominal) {
         size_t num = 128;
         std::shared_ptr<object_store_t> store(object_store_init(noop, num), object_store_shutdown);
@@ -143,6 +151,70 @@ namespace {
         }
     }
 
+    TEST(ObjectStoreRemoveDeferred, nominal) {
+        size_t num = 32;
+        std::shared_ptr<object_store_t> store(object_store_init_deferred(count_free, num), object_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        slot_t slot = SLOT_INVALID;
+        ASSERT_EQ(object_store_add(&slot, store.get(), &num, ta_uuid()), SA_STATUS_OK);
+
+        size_t before = freed_count;
+        ASSERT_EQ(object_store_remove(store.get(), slot, ta_uuid()), SA_STATUS_OK);
+        reclaimer_flush();
+        ASSERT_EQ(freed_count - before, 1U);
+    }
+
+    TEST(ObjectStoreRemoveDeferred, nominalWhileAcquired) {
+        size_t num = 32;
+        std::shared_ptr<object_store_t> store(object_store_init_deferred(count_free, num), object_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        slot_t slot = SLOT_INVALID;
+        ASSERT_EQ(object_store_add(&slot, store.get(), &num, ta_uuid()), SA_STATUS_OK);
+
+        void* object = nullptr;
+        ASSERT_EQ(object_store_acquire(&object, store.get(), slot, ta_uuid()), SA_STATUS_OK);
+
+        // The handle is invalid as soon as it is removed, but the object lives until it is released.
+        size_t before = freed_count;
+        ASSERT_EQ(object_store_remove(store.get(), slot, ta_uuid()), SA_STATUS_OK);
+        void* other = nullptr;
+        ASSERT_EQ(object_store_acquire(&other, store.get(), slot, ta_uuid()), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(object_store_remove(store.get(), slot, ta_uuid()), SA_STATUS_INVALID_PARAMETER);
+        reclaimer_flush();
+        ASSERT_EQ(freed_count - before, 0U);
+
+        ASSERT_EQ(object_store_release(store.get(), slot, object, ta_uuid()), SA_STATUS_OK);
+        reclaimer_flush();
+        ASSERT_EQ(freed_count - before, 1U);
+
+        // the slot is available again
+        slot_t new_slot = SLOT_INVALID;
+        ASSERT_EQ(object_store_add(&new_slot, store.get(), &num, ta_uuid()), SA_STATUS_OK);
+        ASSERT_EQ(new_slot, slot);
+    }
+
+    TEST(ObjectStoreRemoveDeferred, nominalShutdownWhileQueued) {
+        size_t num = 32;
+        size_t before = freed_count;
+        {
+            std::shared_ptr<object_store_t> store(object_store_init_deferred(count_free, num), object_store_shutdown);
+            ASSERT_NE(store, nullptr);
+
+            for (size_t i = 0; i < num; i++) {
+                slot_t slot = SLOT_INVALID;
+                ASSERT_EQ(object_store_add(&slot, store.get(), &num, ta_uuid()), SA_STATUS_OK);
+                if (i % 2 == 0) {
+                    ASSERT_EQ(object_store_remove(store.get(), slot, ta_uuid()), SA_STATUS_OK);
+                }
+            }
+        }
+
+        // shutdown frees the remaining objects and waits for the queued ones
+        ASSERT_EQ(freed_count - before, num);
+    }
+
     TEST(ObjectStoreSize, nominal) {
         size_t num = 128;
         std::shared_ptr<object_store_t> store(object_store_init(noop, num), object_store_shutdown);
@@ -150,4 +222,47 @@ namespace {
 
         ASSERT_EQ(num, object_store_size(store.get()));
     }
+
+    TEST(ObjectStoreGetLockStats, nominal) {
+        size_t num = 32;
+        std::shared_ptr<object_store_t> store(object_store_init(noop, num), object_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        object_store_lock_stats_t before;
+        sa_status status = object_store_get_lock_stats(&before, store.get());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        slot_t slot = SLOT_INVALID;
+        status = object_store_add(&slot, store.get(), &num, ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        void* object = nullptr;
+        status = object_store_acquire(&object, store.get(), slot, ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        status = object_store_release(store.get(), slot, object, ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        status = object_store_remove(store.get(), slot, ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        object_store_lock_stats_t after;
+        status = object_store_get_lock_stats(&after, store.get());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_GE(after.lock_count, before.lock_count + 4);
+        ASSERT_LE(after.contended_count, after.lock_count);
+        ASSERT_GE(after.wait_ns, after.max_wait_ns);
+    }
+
+    TEST(ObjectStoreGetLockStats, failsNullStats) {
+        std::shared_ptr<object_store_t> store(object_store_init(noop, 32), object_store_shutdown);
+        ASSERT_NE(store, nullptr);
+
+        sa_status status = object_store_get_lock_stats(nullptr, store.get());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST(ObjectStoreGetLockStats, failsNullStore) {
+        object_store_lock_stats_t stats;
+        sa_status status = object_store_get_lock_stats(&stats, nullptr);
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
 } // namespace
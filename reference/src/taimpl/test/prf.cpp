@@ -0,0 +1,136 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "prf.h"
+#include "common.h"
+#include "ta_test_helpers.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+using namespace ta_test_helpers;
+
+namespace {
+    std::shared_ptr<prf_t> wrap(prf_t* prf) {
+        return {prf, prf_free};
+    }
+
+    // RFC 5869 test case 1.
+    const std::vector<uint8_t> HKDF_PRK = {
+            0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f, 0x0d, 0xc4, 0x7b, 0xba, 0x63,
+            0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31, 0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5};
+
+    const std::vector<uint8_t> HKDF_INFO = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9};
+
+    const std::vector<uint8_t> HKDF_OKM = {
+            0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36,
+            0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56,
+            0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65};
+
+    TEST(PrfExpand, hkdfKnownAnswer) {
+        auto prf = wrap(prf_create_hmac(SA_DIGEST_ALGORITHM_SHA256, HKDF_PRK.data(), HKDF_PRK.size()));
+        ASSERT_NE(prf, nullptr);
+
+        std::vector<uint8_t> okm(HKDF_OKM.size());
+        ASSERT_EQ(prf_expand(okm.data(), okm.size(), prf.get(), 1, 1, false, true, HKDF_INFO.data(),
+                          HKDF_INFO.size(), nullptr, 0),
+                SA_STATUS_OK);
+        ASSERT_EQ(okm, HKDF_OKM);
+    }
+
+    TEST(PrfExpand, hkdfReusable) {
+        auto prf = wrap(prf_create_hmac(SA_DIGEST_ALGORITHM_SHA256, HKDF_PRK.data(), HKDF_PRK.size()));
+        ASSERT_NE(prf, nullptr);
+
+        for (int i = 0; i < 3; i++) {
+            std::vector<uint8_t> okm(HKDF_OKM.size());
+            ASSERT_EQ(prf_expand(okm.data(), okm.size(), prf.get(), 1, 1, false, true, HKDF_INFO.data(),
+                              HKDF_INFO.size(), nullptr, 0),
+                    SA_STATUS_OK);
+            ASSERT_EQ(okm, HKDF_OKM);
+        }
+    }
+
+    TEST(PrfExpand, digestPrefix) {
+        auto prefix = random(SYM_256_KEY_SIZE);
+        auto info = random(AES_BLOCK_SIZE);
+        auto prefixed = wrap(prf_create_digest(SA_DIGEST_ALGORITHM_SHA384, prefix.data(), prefix.size()));
+        ASSERT_NE(prefixed, nullptr);
+        auto plain = wrap(prf_create_digest(SA_DIGEST_ALGORITHM_SHA384, nullptr, 0));
+        ASSERT_NE(plain, nullptr);
+        ASSERT_EQ(prf_get_length(plain.get()), 48U);
+
+        std::vector<uint8_t> expected(48);
+        uint8_t counter[] = {0, 0, 0, 1};
+        std::vector<uint8_t> counter_vector(counter, counter + sizeof(counter));
+        ASSERT_TRUE(digest_openssl(expected, SA_DIGEST_ALGORITHM_SHA384, prefix, counter_vector, info));
+
+        std::vector<uint8_t> out(48);
+        ASSERT_EQ(prf_compute(out.data(), plain.get(), prefix.data(), prefix.size(), counter, sizeof(counter),
+                          info.data(), info.size()),
+                SA_STATUS_OK);
+        ASSERT_EQ(out, expected);
+
+        ASSERT_EQ(prf_expand(out.data(), out.size(), prefixed.get(), 1, 4, true, false, info.data(), info.size(),
+                          nullptr, 0),
+                SA_STATUS_OK);
+        ASSERT_EQ(out, expected);
+    }
+
+    TEST(PrfExpand, cmacCounterStart) {
+        auto key = random(SYM_128_KEY_SIZE);
+        auto other_data = random(AES_BLOCK_SIZE);
+        auto prf = wrap(prf_create_cmac(key.data(), key.size()));
+        ASSERT_NE(prf, nullptr);
+
+        std::vector<uint8_t> full(4 * AES_BLOCK_SIZE);
+        for (uint8_t i = 1; i <= 4; i++) {
+            ASSERT_EQ(prf_compute(full.data() + (i - 1) * AES_BLOCK_SIZE, prf.get(), &i, 1, other_data.data(),
+                              other_data.size(), nullptr, 0),
+                    SA_STATUS_OK);
+        }
+
+        std::vector<uint8_t> slice(2 * AES_BLOCK_SIZE);
+        ASSERT_EQ(prf_expand(slice.data(), slice.size(), prf.get(), 2, 1, true, false, other_data.data(),
+                          other_data.size(), nullptr, 0),
+                SA_STATUS_OK);
+        ASSERT_EQ(slice, std::vector<uint8_t>(full.begin() + AES_BLOCK_SIZE, full.begin() + 3 * AES_BLOCK_SIZE));
+    }
+
+    TEST(PrfExpand, failsTooManyBlocks) {
+        auto prf = wrap(prf_create_digest(SA_DIGEST_ALGORITHM_SHA1, nullptr, 0));
+        ASSERT_NE(prf, nullptr);
+
+        std::vector<uint8_t> out(20 * (PRF_MAX_BLOCKS + 1));
+        ASSERT_EQ(prf_expand(out.data(), out.size(), prf.get(), 1, 4, true, false, nullptr, 0, nullptr, 0),
+                SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST(PrfExpand, failsCounterOverflow) {
+        auto prf = wrap(prf_create_digest(SA_DIGEST_ALGORITHM_SHA1, nullptr, 0));
+        ASSERT_NE(prf, nullptr);
+
+        std::vector<uint8_t> out(40);
+        ASSERT_EQ(prf_expand(out.data(), out.size(), prf.get(), 0xff, 1, true, false, nullptr, 0, nullptr, 0),
+                SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST(PrfCreate, failsInvalidCmacKey) {
+        auto key = random(SYM_128_KEY_SIZE + 1);
+        ASSERT_EQ(prf_create_cmac(key.data(), key.size()), nullptr);
+    }
+} // namespace
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "reclaimer.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    std::atomic<size_t> freed_count(0);
+    std::atomic<bool> blocked(false);
+
+    void count_free(void* obj) {
+        freed_count++;
+    }
+
+    void blocking_free(void* obj) {
+        while (blocked)
+            std::this_thread::yield();
+    }
+
+    int freed_pipe = -1;
+
+    void pipe_free(void* obj) {
+        char byte = 0;
+        if (write(freed_pipe, &byte, 1) != 1)
+            _exit(2);
+    }
+
+    int wait_child(pid_t pid) {
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+            return -1;
+
+        return WEXITSTATUS(status);
+    }
+
+    TEST(Reclaimer, nominal) {
+        int object = 0;
+        size_t before = freed_count;
+        for (size_t i = 0; i < 10; i++)
+            reclaimer_defer(count_free, &object);
+
+        reclaimer_flush();
+        ASSERT_EQ(freed_count - before, 10U);
+
+        reclaimer_stats_t stats;
+        ASSERT_EQ(reclaimer_get_stats(&stats), SA_STATUS_OK);
+        ASSERT_EQ(stats.queued, 0U);
+    }
+
+    TEST(Reclaimer, nominalFreesInlineWhenFull) {
+        int object = 0;
+        reclaimer_stats_t before;
+        ASSERT_EQ(reclaimer_get_stats(&before), SA_STATUS_OK);
+
+        // The first entry keeps the reclaimer thread busy while the queue fills up.
+        blocked = true;
+        reclaimer_defer(blocking_free, &object);
+        for (size_t i = 0; i < RECLAIMER_QUEUE_SIZE + 1; i++)
+            reclaimer_defer(count_free, &object);
+
+        reclaimer_stats_t full;
+        ASSERT_EQ(reclaimer_get_stats(&full), SA_STATUS_OK);
+        blocked = false;
+        reclaimer_flush();
+
+        reclaimer_stats_t after;
+        ASSERT_EQ(reclaimer_get_stats(&after), SA_STATUS_OK);
+        ASSERT_GE(after.freed_inline - before.freed_inline, 1U);
+        ASSERT_EQ(full.queued, RECLAIMER_QUEUE_SIZE);
+        ASSERT_EQ(after.queued, 0U);
+    }
+
+    TEST(Reclaimer, nominalAfterFork) {
+        int object = 0;
+        reclaimer_flush();
+
+        // The reclaimer is busy when the process forks, so the child inherits queued entries but not the thread.
+        blocked = true;
+        reclaimer_defer(blocking_free, &object);
+        for (size_t i = 0; i < 10; i++)
+            reclaimer_defer(count_free, &object);
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            alarm(10);
+            blocked = false;
+            size_t before = freed_count;
+            reclaimer_flush();
+            bool inherited_freed = freed_count - before == 10;
+
+            // A new reclaimer thread is started in the child.
+            before = freed_count;
+            for (size_t i = 0; i < 5; i++)
+                reclaimer_defer(count_free, &object);
+
+            reclaimer_flush();
+            _exit(inherited_freed && freed_count - before == 5 ? 0 : 1);
+        }
+
+        blocked = false;
+        reclaimer_flush();
+        ASSERT_NE(pid, -1);
+        ASSERT_EQ(wait_child(pid), 0);
+    }
+
+    TEST(Reclaimer, nominalDrainedAtExit) {
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            alarm(10);
+            close(fds[0]);
+            freed_pipe = fds[1];
+            int object = 0;
+            for (size_t i = 0; i < 10; i++)
+                reclaimer_defer(pipe_free, &object);
+
+            // Runs the exit handlers, which must free the queued objects.
+            exit(0);
+        }
+
+        close(fds[1]);
+        ASSERT_NE(pid, -1);
+        size_t freed = 0;
+        char byte;
+        while (read(fds[0], &byte, 1) == 1)
+            freed++;
+
+        close(fds[0]);
+        ASSERT_EQ(wait_child(pid), 0);
+        ASSERT_EQ(freed, 10U);
+    }
+
+    TEST(Reclaimer, nominalFlushEmpty) {
+        reclaimer_flush();
+    }
+
+    TEST(Reclaimer, failsNullStats) {
+        ASSERT_EQ(reclaimer_get_stats(nullptr), SA_STATUS_NULL_PARAMETER);
+    }
+} // namespace
@@ -19,6 +19,7 @@
 #include "rights.h"
 #include "sa_rights.h"
 #include "ta_test_helpers.h"
+#include "video_output_state.h"
 #include "gtest/gtest.h"
 
 namespace {
@@ -258,4 +259,53 @@ namespace {
 
         EXPECT_FALSE(rights_allowed_video_output_state(&rights, &video_output_state));
     }
+
+    TEST(RightsVerdict, allowsPermittedOperations) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        SA_USAGE_BIT_CLEAR(rights.usage_flags, SA_USAGE_FLAG_ENCRYPT);
+
+        rights_verdict_t verdict;
+        rights_verdict_init(&verdict, &rights);
+
+        EXPECT_TRUE(rights_verdict_allowed_decrypt(&verdict, &rights));
+        EXPECT_FALSE(rights_verdict_allowed_encrypt(&verdict, &rights));
+    }
+
+    TEST(RightsVerdict, expired) {
+        time_t now = time(nullptr);
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        rights.not_before = now - 10;
+        rights.not_on_or_after = now - 5;
+
+        rights_verdict_t verdict;
+        rights_verdict_init(&verdict, &rights);
+
+        EXPECT_FALSE(rights_verdict_allowed_decrypt(&verdict, &rights));
+    }
+
+    TEST(RightsVerdict, followsVideoOutputGeneration) {
+        video_output_state_t original;
+        ASSERT_TRUE(video_output_state_get(&original, nullptr));
+
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        SA_USAGE_BIT_CLEAR(rights.usage_flags, SA_USAGE_FLAG_ALLOWED_DIGITAL_UNPROTECTED);
+
+        rights_verdict_t verdict;
+        rights_verdict_init(&verdict, &rights);
+        ASSERT_TRUE(rights_verdict_allowed_decrypt(&verdict, &rights));
+
+        uint64_t generation = video_output_state_generation();
+        video_output_state_t unprotected = original;
+        unprotected.digital_unprotected_count = 1;
+        ASSERT_TRUE(video_output_simulate(&unprotected));
+        EXPECT_NE(video_output_state_generation(), generation);
+        EXPECT_FALSE(rights_verdict_allowed_decrypt(&verdict, &rights));
+
+        ASSERT_TRUE(video_output_simulate(&original));
+        EXPECT_TRUE(rights_verdict_allowed_decrypt(&verdict, &rights));
+    }
 } // namespace
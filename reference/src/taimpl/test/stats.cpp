@@ -0,0 +1,170 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "stats.h" // NOLINT
+#include "gtest/gtest.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct command_stats {
+        sa_stats_command command;
+        std::vector<uint64_t> status_counts;
+        std::vector<uint64_t> histogram;
+    };
+
+    std::vector<uint8_t> snapshot() {
+        size_t stats_length = 0;
+        EXPECT_EQ(stats_snapshot(nullptr, &stats_length), SA_STATUS_OK);
+        std::vector<uint8_t> stats(stats_length);
+        EXPECT_EQ(stats_snapshot(stats.data(), &stats_length), SA_STATUS_OK);
+        stats.resize(stats_length);
+        return stats;
+    }
+
+    command_stats find(
+            const std::vector<uint8_t>& stats,
+            SA_COMMAND_ID command_id) {
+
+        command_stats result = {};
+        result.status_counts.resize(STATS_STATUS_COUNT);
+        result.histogram.resize(STATS_BUCKET_COUNT);
+
+        sa_stats_header header;
+        memcpy(&header, stats.data(), sizeof(header));
+        const uint8_t* record = stats.data() + header.header_length;
+        for (uint32_t i = 0; i < header.command_count; i++) {
+            sa_stats_command command;
+            memcpy(&command, record, sizeof(command));
+            if (command.command_id == static_cast<uint32_t>(command_id)) {
+                result.command = command;
+                const uint8_t* counters = record + sizeof(sa_stats_command);
+                memcpy(result.status_counts.data(), counters, header.status_count * sizeof(uint64_t));
+                memcpy(result.histogram.data(), counters + header.status_count * sizeof(uint64_t),
+                        header.bucket_count * sizeof(uint64_t));
+                break;
+            }
+
+            record += command.record_length;
+        }
+
+        return result;
+    }
+
+    uint64_t bucket_lower_bound(size_t bucket) {
+        const size_t sub_buckets = 1 << STATS_SUB_BUCKET_BITS;
+        if (bucket < sub_buckets)
+            return bucket;
+
+        return static_cast<uint64_t>(sub_buckets + bucket % sub_buckets) << (bucket / sub_buckets - 1);
+    }
+
+    TEST(StatsTest, bucketLayout) {
+        for (uint64_t ns = 0; ns < (1 << STATS_SUB_BUCKET_BITS); ns++)
+            ASSERT_EQ(stats_bucket(ns), ns);
+
+        for (size_t bucket = 0; bucket < STATS_BUCKET_COUNT; bucket++) {
+            uint64_t lower = bucket_lower_bound(bucket);
+            ASSERT_EQ(stats_bucket(lower), bucket);
+            if (bucket + 1 < STATS_BUCKET_COUNT) {
+                ASSERT_EQ(stats_bucket(bucket_lower_bound(bucket + 1) - 1), bucket);
+            }
+        }
+
+        ASSERT_EQ(stats_bucket(UINT64_C(1) << STATS_MAX_MAGNITUDE), STATS_BUCKET_COUNT - 1);
+        ASSERT_EQ(stats_bucket(UINT64_MAX), STATS_BUCKET_COUNT - 1);
+    }
+
+    TEST(StatsTest, recordsAcrossThreads) {
+        auto before = find(snapshot(), SA_SVP_BUFFER_ALLOC);
+
+        const size_t thread_count = 4;
+        const size_t calls = 1000;
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < thread_count; i++) {
+            threads.emplace_back([] {
+                for (size_t j = 0; j < calls; j++) {
+                    stats_call_t call = stats_begin(SA_SVP_BUFFER_ALLOC);
+                    stats_record(call, j % 2 == 0 ? SA_STATUS_OK : SA_STATUS_INVALID_PARAMETER, 16);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        auto after = find(snapshot(), SA_SVP_BUFFER_ALLOC);
+        ASSERT_EQ(after.command.calls - before.command.calls, thread_count * calls);
+        ASSERT_EQ(after.command.param_bytes - before.command.param_bytes, thread_count * calls * 16);
+        ASSERT_EQ(after.status_counts[SA_STATUS_OK] - before.status_counts[SA_STATUS_OK], thread_count * calls / 2);
+        ASSERT_EQ(after.status_counts[SA_STATUS_INVALID_PARAMETER] -
+                          before.status_counts[SA_STATUS_INVALID_PARAMETER],
+                thread_count * calls / 2);
+        ASSERT_GE(after.command.max_ns, before.command.max_ns);
+
+        uint64_t timed_calls = after.command.timed_calls - before.command.timed_calls;
+        ASSERT_GE(timed_calls, thread_count * calls / STATS_SAMPLE_INTERVAL);
+        ASSERT_LE(timed_calls, thread_count * (calls / STATS_SAMPLE_INTERVAL + 1));
+
+        uint64_t histogram_calls = 0;
+        for (size_t i = 0; i < STATS_BUCKET_COUNT; i++)
+            histogram_calls += after.histogram[i] - before.histogram[i];
+
+        ASSERT_EQ(histogram_calls, timed_calls);
+    }
+
+    TEST(StatsTest, timesFirstCall) {
+        auto before = find(snapshot(), SA_SVP_BUFFER_FREE);
+        std::thread([] {
+            stats_call_t call = stats_begin(SA_SVP_BUFFER_FREE);
+            ASSERT_NE(call.start, 0U);
+            stats_record(call, SA_STATUS_OK, 0);
+        }).join();
+
+        auto after = find(snapshot(), SA_SVP_BUFFER_FREE);
+        ASSERT_EQ(after.command.calls - before.command.calls, 1U);
+        ASSERT_EQ(after.command.timed_calls - before.command.timed_calls, 1U);
+    }
+
+    TEST(StatsTest, snapshotHeader) {
+        auto stats = snapshot();
+        ASSERT_GE(stats.size(), sizeof(sa_stats_header));
+
+        sa_stats_header header;
+        memcpy(&header, stats.data(), sizeof(header));
+        ASSERT_EQ(header.version, static_cast<uint32_t>(SA_STATS_VERSION));
+        ASSERT_EQ(header.header_length, sizeof(sa_stats_header));
+        ASSERT_EQ(header.status_count, static_cast<uint32_t>(STATS_STATUS_COUNT));
+        ASSERT_EQ(header.bucket_count, static_cast<uint32_t>(STATS_BUCKET_COUNT));
+        ASSERT_EQ(header.sub_bucket_bits, static_cast<uint32_t>(STATS_SUB_BUCKET_BITS));
+    }
+
+    TEST(StatsTest, failsNullStatsLength) {
+        ASSERT_EQ(stats_snapshot(nullptr, nullptr), SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST(StatsTest, failsInvalidStatsLength) {
+        size_t stats_length = 0;
+        ASSERT_EQ(stats_snapshot(nullptr, &stats_length), SA_STATUS_OK);
+        std::vector<uint8_t> stats(stats_length);
+        stats_length--;
+        ASSERT_EQ(stats_snapshot(stats.data(), &stats_length), SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,281 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common.h"
+#include "sa_rights.h"
+#include "ta.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+    class TaCommandBatchTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_EQ(ta_open_session_handler(&session), SA_STATUS_OK);
+        }
+
+        void TearDown() override {
+            if (session != nullptr)
+                ta_close_session_handler(session);
+        }
+
+        // Appends a sub-command. Each parameter is copied into the data buffer at an aligned offset.
+        void add(
+                SA_COMMAND_ID command_id,
+                const std::vector<std::vector<uint8_t>>& command_params) {
+
+            sa_command_batch_entry_s entry = {};
+            entry.command_id = command_id;
+            for (size_t j = 0; j < command_params.size(); j++) {
+                size_t offset = (data.size() + COMMAND_BATCH_ALIGNMENT - 1) / COMMAND_BATCH_ALIGNMENT *
+                                COMMAND_BATCH_ALIGNMENT;
+                data.resize(offset + command_params[j].size());
+                if (!command_params[j].empty())
+                    memcpy(data.data() + offset, command_params[j].data(), command_params[j].size());
+
+                entry.param_offsets[j] = offset;
+                entry.param_sizes[j] = command_params[j].size();
+            }
+
+            entries.push_back(entry);
+        }
+
+        sa_status invoke(size_t statuses_length) {
+            statuses.assign(statuses_length, SA_STATUS_INTERNAL_ERROR);
+            sa_command_batch_s command_batch = {API_VERSION, entries.size()};
+            ta_param params[NUM_TA_PARAMS] = {
+                    {&command_batch, sizeof(command_batch)},
+                    {entries.data(), entries.size() * sizeof(sa_command_batch_entry_s)},
+                    {data.data(), data.size()},
+                    {statuses.data(), statuses.size() * sizeof(sa_status)}};
+            return ta_invoke_command_handler(session, SA_COMMAND_BATCH, params);
+        }
+
+        sa_status invoke() {
+            return invoke(entries.size());
+        }
+
+        template <typename T>
+        static std::vector<uint8_t> bytes(const T& command) {
+            const auto* begin = reinterpret_cast<const uint8_t*>(&command);
+            return {begin, begin + sizeof(T)};
+        }
+
+        template <typename T>
+        T read(
+                size_t entry,
+                size_t param) const {
+
+            T command;
+            memcpy(&command, data.data() + entries[entry].param_offsets[param], sizeof(T));
+            return command;
+        }
+
+        sa_key generate_key() {
+            sa_key_generate_s key_generate = {API_VERSION, INVALID_HANDLE, {}, SA_KEY_TYPE_SYMMETRIC,
+                    SYM_128_KEY_SIZE};
+            sa_rights_set_allow_all(&key_generate.rights);
+            ta_param params[NUM_TA_PARAMS] = {{&key_generate, sizeof(key_generate)}, {}, {}, {}};
+            if (ta_invoke_command_handler(session, SA_KEY_GENERATE, params) != SA_STATUS_OK)
+                return INVALID_HANDLE;
+
+            return key_generate.key;
+        }
+
+        sa_status key_header(sa_key key) {
+            sa_key_header_s key_header = {};
+            key_header.api_version = API_VERSION;
+            key_header.key = key;
+            ta_param params[NUM_TA_PARAMS] = {{&key_header, sizeof(key_header)}, {}, {}, {}};
+            return ta_invoke_command_handler(session, SA_KEY_HEADER, params);
+        }
+
+        static std::vector<uint8_t> key_release(sa_key key) {
+            sa_key_release_s release = {API_VERSION, key};
+            return bytes(release);
+        }
+
+        void* session = nullptr;
+        std::vector<sa_command_batch_entry_s> entries;
+        std::vector<uint8_t> data;
+        std::vector<sa_status> statuses;
+    };
+
+    TEST_F(TaCommandBatchTest, nominal) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        ASSERT_EQ(invoke(), SA_STATUS_OK);
+
+        // A failed sub-command does not stop the batch or fail the envelope.
+        ASSERT_EQ(statuses[0], SA_STATUS_OK);
+        ASSERT_EQ(statuses[1], SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaCommandBatchTest, nominalOutputsCopiedBack) {
+        sa_get_version_s get_version = {API_VERSION, {}};
+        add(SA_GET_VERSION, {bytes(get_version)});
+
+        sa_get_name_s get_name = {API_VERSION, 64};
+        add(SA_GET_NAME, {bytes(get_name), std::vector<uint8_t>(64)});
+        ASSERT_EQ(invoke(), SA_STATUS_OK);
+        ASSERT_EQ(statuses[0], SA_STATUS_OK);
+        ASSERT_EQ(statuses[1], SA_STATUS_OK);
+
+        sa_get_version_s direct_version = {API_VERSION, {}};
+        ta_param params[NUM_TA_PARAMS] = {{&direct_version, sizeof(direct_version)}, {}, {}, {}};
+        ASSERT_EQ(ta_invoke_command_handler(session, SA_GET_VERSION, params), SA_STATUS_OK);
+
+        auto batched_version = read<sa_get_version_s>(0, 0);
+        ASSERT_EQ(memcmp(&batched_version.version, &direct_version.version, sizeof(sa_version)), 0);
+
+        sa_get_name_s direct_get_name = {API_VERSION, 64};
+        std::vector<uint8_t> direct_name(64);
+        ta_param name_params[NUM_TA_PARAMS] = {{&direct_get_name, sizeof(direct_get_name)},
+                {direct_name.data(), direct_name.size()}, {}, {}};
+        ASSERT_EQ(ta_invoke_command_handler(session, SA_GET_NAME, name_params), SA_STATUS_OK);
+
+        auto batched_get_name = read<sa_get_name_s>(1, 0);
+        ASSERT_GT(batched_get_name.name_length, 0U);
+        ASSERT_EQ(batched_get_name.name_length, direct_get_name.name_length);
+        ASSERT_EQ(memcmp(data.data() + entries[1].param_offsets[1], direct_name.data(), direct_get_name.name_length),
+                0);
+    }
+
+    TEST_F(TaCommandBatchTest, failsNestedBatch) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        sa_command_batch_s nested = {API_VERSION, 1};
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_COMMAND_BATCH, {bytes(nested)});
+        ASSERT_EQ(invoke(), SA_STATUS_INVALID_PARAMETER);
+
+        // The release before the bad entry must not have run.
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsOffsetOutOfRange) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        entries[1].param_offsets[0] = data.size();
+        ASSERT_EQ(invoke(), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsSizeOutOfRange) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        entries[1].param_sizes[0] = data.size() - entries[1].param_offsets[0] + 1;
+        ASSERT_EQ(invoke(), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsSizeOverflow) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        entries[1].param_sizes[0] = SIZE_MAX;
+        ASSERT_EQ(invoke(), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsMisalignedOffset) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        data.resize(data.size() + 1);
+        entries[1].param_offsets[0] += 1;
+        ASSERT_EQ(invoke(), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsZeroSizeSubCommandParam0) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {{}});
+        ASSERT_EQ(invoke(), SA_STATUS_NULL_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsStatusesTooShort) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        add(SA_KEY_RELEASE, {key_release(key)});
+        ASSERT_EQ(invoke(1), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsEntriesSizeMismatch) {
+        sa_key key = generate_key();
+        ASSERT_NE(key, INVALID_HANDLE);
+
+        add(SA_KEY_RELEASE, {key_release(key)});
+        statuses.assign(2, SA_STATUS_OK);
+        sa_command_batch_s command_batch = {API_VERSION, 2};
+        ta_param params[NUM_TA_PARAMS] = {
+                {&command_batch, sizeof(command_batch)},
+                {entries.data(), entries.size() * sizeof(sa_command_batch_entry_s)},
+                {data.data(), data.size()},
+                {statuses.data(), statuses.size() * sizeof(sa_status)}};
+        ASSERT_EQ(ta_invoke_command_handler(session, SA_COMMAND_BATCH, params), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(key_header(key), SA_STATUS_OK);
+    }
+
+    TEST_F(TaCommandBatchTest, failsNullParam0) {
+        add(SA_KEY_RELEASE, {key_release(INVALID_HANDLE)});
+        statuses.assign(1, SA_STATUS_OK);
+        ta_param params[NUM_TA_PARAMS] = {
+                {nullptr, sizeof(sa_command_batch_s)},
+                {entries.data(), sizeof(sa_command_batch_entry_s)},
+                {data.data(), data.size()},
+                {statuses.data(), sizeof(sa_status)}};
+        ASSERT_EQ(ta_invoke_command_handler(session, SA_COMMAND_BATCH, params), SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaCommandBatchTest, failsZeroSizeParam0) {
+        add(SA_KEY_RELEASE, {key_release(INVALID_HANDLE)});
+        statuses.assign(1, SA_STATUS_OK);
+        sa_command_batch_s command_batch = {API_VERSION, 1};
+        ta_param params[NUM_TA_PARAMS] = {
+                {&command_batch, 0},
+                {entries.data(), sizeof(sa_command_batch_entry_s)},
+                {data.data(), data.size()},
+                {statuses.data(), sizeof(sa_status)}};
+        ASSERT_EQ(ta_invoke_command_handler(session, SA_COMMAND_BATCH, params), SA_STATUS_INVALID_PARAMETER);
+        ASSERT_EQ(statuses[0], SA_STATUS_OK);
+    }
+} // namespace
@@ -0,0 +1,226 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ta_sa.h"
+#include "ta_sa_svp_common.h"
+#include "ta_test_helpers.h"
+#include "gtest/gtest.h"
+
+using namespace ta_test_helpers;
+
+namespace {
+    TEST_F(TaSvpBufferBatchTest, nominal) {
+        auto in_buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(in_buffer, nullptr);
+        auto out_buffer = create_sa_svp_buffer(1024);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(1024);
+
+        // Assemble in_buffer from two writes, then copy it to out_buffer in adjacent ranges that are merged.
+        std::vector<sa_svp_offset> write_offsets = {{0, 512, 512}, {512, 0, 512}};
+        std::vector<sa_svp_offset> copy_offsets;
+        for (size_t offset = 0; offset < 1024; offset += 16)
+            copy_offsets.push_back({offset, offset, 16});
+
+        std::vector<sa_svp_batch_entry> entries = {
+                {*in_buffer, INVALID_HANDLE, &write_offsets[0], 1},
+                {*in_buffer, INVALID_HANDLE, &write_offsets[1], 1},
+                {*out_buffer, *in_buffer, copy_offsets.data(), copy_offsets.size()}};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size(), client(),
+                ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        std::vector<uint8_t> expected(in.begin() + 512, in.end());
+        expected.insert(expected.end(), in.begin(), in.begin() + 512);
+        ASSERT_TRUE(check_sha256(*in_buffer, expected));
+        ASSERT_TRUE(check_sha256(*out_buffer, expected));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, nominalScatteredRanges) {
+        auto out_buffer = create_sa_svp_buffer(4096);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(4096);
+
+        // Reverse the order of 7 byte ranges so that none of them can be merged.
+        std::vector<sa_svp_offset> offsets;
+        std::vector<uint8_t> expected;
+        for (size_t offset = 4096 - 7; offset < 4096; offset -= 7) {
+            offsets.push_back({expected.size(), offset, 7});
+            expected.insert(expected.end(), in.begin() + static_cast<long>(offset),
+                    in.begin() + static_cast<long>(offset) + 7);
+        }
+
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, offsets.data(), offsets.size()};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_TRUE(check_sha256(*out_buffer, expected));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, nominalLarge) {
+        const size_t size = 4 * 1024 * 1024 + 3;
+        auto in_buffer = create_sa_svp_buffer(size);
+        ASSERT_NE(in_buffer, nullptr);
+        auto out_buffer = create_sa_svp_buffer(size + 5);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(size + 5);
+
+        // Unaligned destination exercises the head and tail of the streaming copy.
+        sa_svp_offset write_offset = {0, 5, size};
+        sa_svp_offset head_offset = {0, 0, 5};
+        sa_svp_offset copy_offset = {5, 0, size};
+        std::vector<sa_svp_batch_entry> entries = {
+                {*in_buffer, INVALID_HANDLE, &write_offset, 1},
+                {*out_buffer, INVALID_HANDLE, &head_offset, 1},
+                {*out_buffer, *in_buffer, &copy_offset, 1}};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size(), client(),
+                ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_TRUE(check_sha256(*in_buffer, std::vector<uint8_t>(in.begin() + 5, in.end())));
+        ASSERT_TRUE(check_sha256(*out_buffer, in));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, nominalSameBuffer) {
+        auto buffer = create_sa_svp_buffer(64);
+        ASSERT_NE(buffer, nullptr);
+        auto in = random(32);
+
+        sa_svp_offset write_offset = {0, 0, 32};
+        sa_svp_offset copy_offset = {32, 0, 32};
+        std::vector<sa_svp_batch_entry> entries = {
+                {*buffer, INVALID_HANDLE, &write_offset, 1},
+                {*buffer, *buffer, &copy_offset, 1}};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size(), client(),
+                ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        std::vector<uint8_t> expected(in);
+        expected.insert(expected.end(), in.begin(), in.end());
+        ASSERT_TRUE(check_sha256(*buffer, expected));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, nominalSameBufferOverlapping) {
+        auto buffer = create_sa_svp_buffer(64);
+        ASSERT_NE(buffer, nullptr);
+        auto in = random(48);
+
+        // The copy moves the first 48 bytes up by 16, so its input and output overlap.
+        sa_svp_offset write_offset = {0, 0, 48};
+        sa_svp_offset copy_offset = {16, 0, 48};
+        std::vector<sa_svp_batch_entry> entries = {
+                {*buffer, INVALID_HANDLE, &write_offset, 1},
+                {*buffer, *buffer, &copy_offset, 1}};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size(), client(),
+                ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+
+        std::vector<uint8_t> expected(in.begin(), in.begin() + 16);
+        expected.insert(expected.end(), in.begin(), in.end());
+        ASSERT_TRUE(check_sha256(*buffer, expected));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, nominalCopiesOnly) {
+        auto in_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(in_buffer, nullptr);
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {0, 0, AES_BLOCK_SIZE};
+        ASSERT_EQ(ta_sa_svp_buffer_write(*in_buffer, in.data(), in.size(), &offset, 1, client(), ta_uuid()),
+                SA_STATUS_OK);
+
+        sa_svp_batch_entry entry = {*out_buffer, *in_buffer, &offset, 1};
+        sa_status status = ta_sa_svp_buffer_batch(nullptr, 0, &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+        ASSERT_TRUE(check_sha256(*out_buffer, in));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsRejectedBatchWritesNothing) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        std::vector<uint8_t> zero(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {0, 0, zero.size()};
+        ASSERT_EQ(ta_sa_svp_buffer_write(*out_buffer, zero.data(), zero.size(), &offset, 1, client(), ta_uuid()),
+                SA_STATUS_OK);
+
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset bad_offset = {1, 0, AES_BLOCK_SIZE};
+        std::vector<sa_svp_batch_entry> entries = {
+                {*out_buffer, INVALID_HANDLE, &offset, 1},
+                {*out_buffer, INVALID_HANDLE, &bad_offset, 1}};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), entries.data(), entries.size(), client(),
+                ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_SVP_BUFFER);
+        ASSERT_TRUE(check_sha256(*out_buffer, zero));
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsOverflowingOffset) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {SIZE_MAX, 0, 2};
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, &offset, 1};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_SVP_BUFFER);
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsNullIn) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        sa_svp_offset offset = {0, 0, 1};
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, &offset, 1};
+        sa_status status = ta_sa_svp_buffer_batch(nullptr, 1, &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsNullEntries) {
+        auto in = random(AES_BLOCK_SIZE);
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), nullptr, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsNullOffsets) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_batch_entry entry = {*out_buffer, INVALID_HANDLE, nullptr, 0};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsInvalidOut) {
+        auto in = random(AES_BLOCK_SIZE);
+        sa_svp_offset offset = {0, 0, 1};
+        sa_svp_batch_entry entry = {INVALID_HANDLE, INVALID_HANDLE, &offset, 1};
+        sa_status status = ta_sa_svp_buffer_batch(in.data(), in.size(), &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferBatchTest, failsReleasedIn) {
+        auto out_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(out_buffer, nullptr);
+        auto in_buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(in_buffer, nullptr);
+        sa_svp_buffer in = *in_buffer;
+        in_buffer.reset();
+
+        sa_svp_offset offset = {0, 0, 1};
+        sa_svp_batch_entry entry = {*out_buffer, in, &offset, 1};
+        sa_status status = ta_sa_svp_buffer_batch(nullptr, 0, &entry, 1, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common.h"
+#include "ta_sa.h"
+#include "ta_sa_svp_common.h"
+#include "ta_test_helpers.h"
+#include "gtest/gtest.h"
+
+using namespace ta_test_helpers;
+
+namespace {
+    // Writes random bytes into the SVP buffer and computes the expected hashes of the ranges.
+    bool fill_buffer(
+            std::vector<uint8_t>& hashes,
+            sa_svp_buffer buffer,
+            size_t size,
+            const std::vector<sa_svp_range>& ranges,
+            sa_digest_algorithm digest_algorithm) {
+
+        auto in = random(size);
+        sa_svp_offset offset = {0, 0, in.size()};
+        if (ta_sa_svp_buffer_write(buffer, in.data(), in.size(), &offset, 1, client(), ta_uuid()) != SA_STATUS_OK)
+            return false;
+
+        hashes.clear();
+        for (const auto& range : ranges) {
+            std::vector<uint8_t> hash(digest_length(digest_algorithm));
+            std::vector<uint8_t> data(in.begin() + static_cast<long>(range.offset),
+                    in.begin() + static_cast<long>(range.offset + range.length));
+            if (!digest_openssl(hash, digest_algorithm, data, {}, {}))
+                return false;
+
+            hashes.insert(hashes.end(), hash.begin(), hash.end());
+        }
+
+        return true;
+    }
+
+    TEST_P(TaSvpBufferCheckRangesTest, nominal) {
+        auto digest = GetParam();
+        std::vector<sa_svp_range> ranges = {{0, 1024}, {1024, 3000}, {100, 17}, {4095, 1}, {0, 4096}, {2048, 0}};
+        auto buffer = create_sa_svp_buffer(4096);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<uint8_t> hashes;
+        ASSERT_TRUE(fill_buffer(hashes, *buffer, 4096, ranges, digest));
+
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, ranges.data(), ranges.size(), digest, hashes.data(),
+                hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_OK);
+    }
+
+    TEST_P(TaSvpBufferCheckRangesTest, failsHashMismatch) {
+        auto digest = GetParam();
+        std::vector<sa_svp_range> ranges = {{0, 1024}, {1024, 1024}, {2048, 1024}};
+        auto buffer = create_sa_svp_buffer(3072);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<uint8_t> hashes;
+        ASSERT_TRUE(fill_buffer(hashes, *buffer, 3072, ranges, digest));
+
+        hashes[digest_length(digest) + 1]++;
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, ranges.data(), ranges.size(), digest, hashes.data(),
+                hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_VERIFICATION_FAILED);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsRangeOutsideBuffer) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<sa_svp_range> ranges = {{0, AES_BLOCK_SIZE}, {1, AES_BLOCK_SIZE}};
+        std::vector<uint8_t> hashes(ranges.size() * SHA256_DIGEST_LENGTH);
+
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, ranges.data(), ranges.size(),
+                SA_DIGEST_ALGORITHM_SHA256, hashes.data(), hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsOverflowingRange) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        sa_svp_range range = {SIZE_MAX, 2};
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, &range, 1, SA_DIGEST_ALGORITHM_SHA256,
+                hashes.data(), hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsHashesWrongSize) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<sa_svp_range> ranges = {{0, 8}, {8, 8}};
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, ranges.data(), ranges.size(),
+                SA_DIGEST_ALGORITHM_SHA256, hashes.data(), hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsNoRanges) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        sa_svp_range range = {0, AES_BLOCK_SIZE};
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, &range, 0, SA_DIGEST_ALGORITHM_SHA256,
+                hashes.data(), 0, client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsNullRanges) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, nullptr, 1, SA_DIGEST_ALGORITHM_SHA256,
+                hashes.data(), hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsNullHashes) {
+        auto buffer = create_sa_svp_buffer(AES_BLOCK_SIZE);
+        ASSERT_NE(buffer, nullptr);
+        sa_svp_range range = {0, AES_BLOCK_SIZE};
+        sa_status status = ta_sa_svp_buffer_check_ranges(*buffer, &range, 1, SA_DIGEST_ALGORITHM_SHA256, nullptr, 0,
+                client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_NULL_PARAMETER);
+    }
+
+    TEST_F(TaSvpBufferCheckRangesTest, failsInvalidBuffer) {
+        sa_svp_range range = {0, AES_BLOCK_SIZE};
+        std::vector<uint8_t> hashes(SHA256_DIGEST_LENGTH);
+        sa_status status = ta_sa_svp_buffer_check_ranges(INVALID_HANDLE, &range, 1, SA_DIGEST_ALGORITHM_SHA256,
+                hashes.data(), hashes.size(), client(), ta_uuid());
+        ASSERT_EQ(status, SA_STATUS_INVALID_PARAMETER);
+    }
+} // namespace
@@ -17,6 +17,7 @@
  */
 
 #include "ta_sa_svp_common.h" // NOLINT
+#include "common.h"
 #include "log.h"
 #include "ta_test_helpers.h"
 
@@ -59,6 +60,18 @@ std::shared_ptr<sa_svp_buffer> TaSvpBase::create_sa_svp_buffer(size_t size) {
     return svp_buffer;
 }
 
+bool TaSvpBufferBatchTest::check_sha256(
+        sa_svp_buffer svp_buffer,
+        const std::vector<uint8_t>& expected) {
+
+    std::vector<uint8_t> hash(SHA256_DIGEST_LENGTH);
+    if (!digest_openssl(hash, SA_DIGEST_ALGORITHM_SHA256, expected, {}, {}))
+        return false;
+
+    return ta_sa_svp_buffer_check(svp_buffer, 0, expected.size(), SA_DIGEST_ALGORITHM_SHA256, hash.data(),
+                   hash.size(), client(), ta_uuid()) == SA_STATUS_OK;
+}
+
 INSTANTIATE_TEST_SUITE_P(
         TaSvpBufferCheckNominalTests,
         TaSvpBufferCheckTest,
@@ -68,6 +81,15 @@ INSTANTIATE_TEST_SUITE_P(
                 SA_DIGEST_ALGORITHM_SHA384,
                 SA_DIGEST_ALGORITHM_SHA512));
 
+INSTANTIATE_TEST_SUITE_P(
+        TaSvpBufferCheckRangesNominalTests,
+        TaSvpBufferCheckRangesTest,
+        ::testing::Values(
+                SA_DIGEST_ALGORITHM_SHA1,
+                SA_DIGEST_ALGORITHM_SHA256,
+                SA_DIGEST_ALGORITHM_SHA384,
+                SA_DIGEST_ALGORITHM_SHA512));
+
 INSTANTIATE_TEST_SUITE_P(
         TaSvpBufferCopyTests,
         TaSvpBufferCopyTest,
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
 
 class TaSvpBase : public ::testing::Test {
 protected:
@@ -31,8 +32,17 @@ protected:
     static std::shared_ptr<sa_svp_buffer> create_sa_svp_buffer(size_t size);
 };
 
+class TaSvpBufferBatchTest : public TaSvpBase {
+protected:
+    static bool check_sha256(
+            sa_svp_buffer svp_buffer,
+            const std::vector<uint8_t>& expected);
+};
+
 class TaSvpBufferCheckTest : public ::testing::WithParamInterface<sa_digest_algorithm>, public TaSvpBase {};
 
+class TaSvpBufferCheckRangesTest : public ::testing::WithParamInterface<sa_digest_algorithm>, public TaSvpBase {};
+
 class TaSvpKeyCheckTest : public TaSvpBase, public TaCryptoCipherBase {};
 
 using TaSvpBufferTestType = std::tuple<long>;
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "video_output_state.h" // NOLINT
+#include "rights.h"
+#include "sa_rights.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+    class VideoOutputStateTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_TRUE(video_output_state_get(&original, nullptr));
+        }
+
+        void TearDown() override {
+            video_output_simulate(&original);
+        }
+
+        static video_output_state_t uniform(int count) {
+            video_output_state_t state;
+            state.analog_unprotected_count = count;
+            state.analog_cgmsa_count = count;
+            state.digital_unprotected_count = count;
+            state.digital_hdcp14_count = count;
+            state.digital_hdcp22_count = count;
+            state.svp_enabled = (count % 2) != 0;
+            return state;
+        }
+
+        video_output_state_t original = {};
+    };
+
+    TEST_F(VideoOutputStateTest, publishesSimulatedChanges) {
+        uint64_t before = 0;
+        video_output_state_t state;
+        ASSERT_TRUE(video_output_state_get(&state, &before));
+        EXPECT_NE(before, 0);
+
+        auto changed = uniform(3);
+        ASSERT_TRUE(video_output_simulate(&changed));
+
+        uint64_t after = 0;
+        ASSERT_TRUE(video_output_state_get(&state, &after));
+        EXPECT_EQ(after, before + 1);
+        EXPECT_EQ(after, video_output_state_generation());
+        EXPECT_EQ(state.digital_hdcp14_count, 3);
+        EXPECT_TRUE(state.svp_enabled);
+    }
+
+    TEST_F(VideoOutputStateTest, readersNeverObserveTornState) {
+        auto initial = uniform(0);
+        ASSERT_TRUE(video_output_simulate(&initial));
+
+        std::atomic<bool> done(false);
+        std::thread platform([&done] {
+            for (int i = 0; i < 20000; i++) {
+                auto state = uniform(i);
+                video_output_simulate(&state);
+            }
+
+            done = true;
+        });
+
+        size_t torn = 0;
+        while (!done) {
+            video_output_state_t state;
+            uint64_t generation;
+            ASSERT_TRUE(video_output_state_get(&state, &generation));
+
+            int count = state.analog_unprotected_count;
+            if (state.analog_cgmsa_count != count || state.digital_unprotected_count != count ||
+                    state.digital_hdcp14_count != count || state.digital_hdcp22_count != count ||
+                    state.svp_enabled != ((count % 2) != 0))
+                torn++;
+        }
+
+        platform.join();
+        EXPECT_EQ(torn, 0);
+    }
+
+    TEST_F(VideoOutputStateTest, revocationLatency) {
+        sa_rights rights;
+        sa_rights_set_allow_all(&rights);
+        SA_USAGE_BIT_CLEAR(rights.usage_flags, SA_USAGE_FLAG_ALLOWED_DIGITAL_UNPROTECTED);
+
+        auto protected_state = original;
+        protected_state.digital_unprotected_count = 0;
+        ASSERT_TRUE(video_output_simulate(&protected_state));
+
+        rights_verdict_t verdict;
+        rights_verdict_init(&verdict, &rights);
+        ASSERT_TRUE(rights_verdict_allowed_decrypt(&verdict, &rights));
+
+        std::atomic<bool> revoked(false);
+        std::chrono::steady_clock::time_point revoked_at;
+        std::thread platform([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            auto unprotected = protected_state;
+            unprotected.digital_unprotected_count = 1;
+            revoked_at = std::chrono::steady_clock::now();
+            video_output_simulate(&unprotected);
+            revoked = true;
+        });
+
+        // a decrypt loop that keeps checking the cached verdict, as the per-chunk path does
+        size_t allowed_after_revocation = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            bool was_revoked = revoked;
+            if (!rights_verdict_allowed_decrypt(&verdict, &rights))
+                break;
+
+            if (was_revoked)
+                allowed_after_revocation++;
+        }
+
+        auto denied_at = std::chrono::steady_clock::now();
+        platform.join();
+
+        // once the platform call returns, the very next check must deny
+        EXPECT_EQ(allowed_after_revocation, 0);
+        EXPECT_FALSE(rights_verdict_allowed_decrypt(&verdict, &rights));
+        EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(denied_at - revoked_at).count(), 100);
+    }
+} // namespace
@@ -0,0 +1,582 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Runs the TA in its own process and serves the simulator ta_client backend (ENABLE_TA_SIMULATOR) over a Unix domain
+// socket, so that benchmarks include the cost of crossing into the TA. Each connection is served by its own thread.
+// Injected latency is spent busy waiting before the command is dispatched, as a core entering a real TEE is busy for
+// the duration of the world switch. Shared memory is tracked per client process, identified by SO_PEERCRED, so a
+// command may only refer to memory mapped by its own process, and the memory is unmapped once the last connection of
+// that process closes.
+//
+// Usage: ta_simulator [-s socket] [-l microseconds] [-c command_id=microseconds]...
+//   -s  socket path. Defaults to TA_SIMULATOR_DEFAULT_SOCKET.
+//   -l  latency injected into every command.
+//   -c  latency injected into one SA_COMMAND_ID, overriding -l. May be repeated.
+
+#include "log.h"
+#include "ta.h"
+#include "ta_simulator.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+#define MAX_COMMANDS 256
+
+typedef struct shared_region_s {
+    uint8_t* address;
+    size_t size;
+    struct shared_region_s* next;
+} shared_region;
+
+typedef struct client_process_s {
+    pid_t pid;
+    size_t connections;
+    shared_region* regions;
+    struct client_process_s* next;
+} client_process;
+
+// Injected latency of every command in nanoseconds. Command ids past MAX_COMMANDS use default_latency_ns.
+static uint64_t latency_ns[MAX_COMMANDS];
+static uint64_t default_latency_ns = 0;
+
+// Guards the process list and the regions of every process.
+static pthread_mutex_t processes_mutex = PTHREAD_MUTEX_INITIALIZER;
+static client_process* processes = NULL;
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int signal_number) {
+    running = 0;
+}
+
+static bool send_all(
+        int fd,
+        const void* buffer,
+        size_t length) {
+
+    const uint8_t* position = buffer;
+    while (length > 0) {
+        ssize_t sent = send(fd, position, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+
+        if (sent <= 0)
+            return false;
+
+        position += sent;
+        length -= (size_t) sent;
+    }
+
+    return true;
+}
+
+static bool receive_all(
+        int fd,
+        void* buffer,
+        size_t length) {
+
+    uint8_t* position = buffer;
+    while (length > 0) {
+        ssize_t received = recv(fd, position, length, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+
+        if (received <= 0)
+            return false;
+
+        position += received;
+        length -= (size_t) received;
+    }
+
+    return true;
+}
+
+// Receives a request header and the descriptor passed with it, if any.
+static bool receive_request(
+        int fd,
+        ta_simulator_request* request,
+        int* passed_fd) {
+
+    union {
+        struct cmsghdr header;
+        uint8_t buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    struct iovec iov = {request, sizeof(ta_simulator_request)};
+    struct msghdr message = {0};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    *passed_fd = -1;
+    ssize_t received;
+    do {
+        received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+
+    if (received <= 0)
+        return false;
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != NULL; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            memcpy(passed_fd, CMSG_DATA(cmsg), sizeof(int));
+    }
+
+    return receive_all(fd, (uint8_t*) request + received, sizeof(ta_simulator_request) - (size_t) received);
+}
+
+// Registers a connection of the client process at the other end of fd.
+static client_process* client_process_acquire(int fd) {
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+        ERROR("getsockopt failed: %d", errno);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&processes_mutex);
+    client_process* process = processes;
+    while (process != NULL && process->pid != credentials.pid)
+        process = process->next;
+
+    if (process == NULL) {
+        process = calloc(1, sizeof(client_process));
+        if (process != NULL) {
+            process->pid = credentials.pid;
+            process->next = processes;
+            processes = process;
+        } else {
+            ERROR("calloc failed");
+        }
+    }
+
+    if (process != NULL)
+        process->connections++;
+
+    pthread_mutex_unlock(&processes_mutex);
+    return process;
+}
+
+// Unregisters a connection, and unmaps the shared memory of the process with its last connection.
+static void client_process_release(client_process* process) {
+    pthread_mutex_lock(&processes_mutex);
+    bool last = --process->connections == 0;
+    if (last) {
+        for (client_process** entry = &processes; *entry != NULL; entry = &(*entry)->next) {
+            if (*entry == process) {
+                *entry = process->next;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&processes_mutex);
+    if (!last)
+        return;
+
+    while (process->regions != NULL) {
+        shared_region* region = process->regions;
+        process->regions = region->next;
+        munmap(region->address, region->size);
+        free(region);
+    }
+
+    free(process);
+}
+
+static sa_status map_shared_memory(
+        client_process* process,
+        int memfd,
+        uint64_t address,
+        uint64_t size) {
+
+    if (memfd < 0) {
+        ERROR("No memfd passed");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    shared_region* region = malloc(sizeof(shared_region));
+    if (region == NULL) {
+        ERROR("malloc failed");
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    // Older kernels treat MAP_FIXED_NOREPLACE as a hint, so the address is checked as well.
+    void* mapped = mmap((void*) (uintptr_t) address, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE,
+            memfd, 0);
+    if (mapped == MAP_FAILED || mapped != (void*) (uintptr_t) address) {
+        ERROR("Shared memory cannot be mapped at %" PRIx64 ": %d", address, errno);
+        if (mapped != MAP_FAILED)
+            munmap(mapped, size);
+
+        free(region);
+        return SA_STATUS_INTERNAL_ERROR;
+    }
+
+    region->address = mapped;
+    region->size = size;
+    pthread_mutex_lock(&processes_mutex);
+    region->next = process->regions;
+    process->regions = region;
+    pthread_mutex_unlock(&processes_mutex);
+    return SA_STATUS_OK;
+}
+
+static sa_status unmap_shared_memory(
+        client_process* process,
+        uint64_t address,
+        uint64_t size) {
+
+    shared_region* found = NULL;
+    pthread_mutex_lock(&processes_mutex);
+    for (shared_region** region = &process->regions; *region != NULL; region = &(*region)->next) {
+        if ((uintptr_t) (*region)->address == address && (*region)->size == size) {
+            found = *region;
+            *region = found->next;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&processes_mutex);
+    if (found == NULL) {
+        ERROR("Unknown shared memory");
+        return SA_STATUS_INVALID_PARAMETER;
+    }
+
+    munmap(found->address, found->size);
+    free(found);
+    return SA_STATUS_OK;
+}
+
+static bool is_shared(
+        client_process* process,
+        uint64_t address,
+        uint64_t size) {
+
+    bool found = false;
+    pthread_mutex_lock(&processes_mutex);
+    for (shared_region* region = process->regions; region != NULL && !found; region = region->next) {
+        uint64_t start = (uintptr_t) region->address;
+        found = address >= start && size <= region->size && address - start <= region->size - size;
+    }
+
+    pthread_mutex_unlock(&processes_mutex);
+    return found;
+}
+
+static void inject_latency(uint32_t command_id) {
+    uint64_t latency = command_id < MAX_COMMANDS ? latency_ns[command_id] : default_latency_ns;
+    if (latency == 0)
+        return;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    struct timespec now;
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((uint64_t) (now.tv_sec - start.tv_sec) * 1000000000 + now.tv_nsec - start.tv_nsec < latency);
+}
+
+static bool is_input(uint32_t type) {
+    return type == TA_PARAM_IN || type == TA_PARAM_INOUT;
+}
+
+static bool is_output(uint32_t type) {
+    return type == TA_PARAM_OUT || type == TA_PARAM_INOUT;
+}
+
+// Reads the inline parameters, invokes the command, and sends the response. Returns false if the connection failed.
+static bool invoke_command(
+        int fd,
+        client_process* process,
+        void* session_context,
+        const ta_simulator_request* request) {
+
+    ta_param params[NUM_TA_PARAMS] = {0};
+    void* inline_buffers[NUM_TA_PARAMS] = {0};
+    bool connected = true;
+    sa_status status = SA_STATUS_OK;
+    for (size_t i = 0; i < NUM_TA_PARAMS && connected; i++) {
+        const ta_simulator_param* param = &request->params[i];
+        if (param->location == TA_SIMULATOR_PARAM_INLINE) {
+            // Always allocated so that the contents sent by the client are drained even if the command fails.
+            inline_buffers[i] = malloc(param->size == 0 ? 1 : param->size);
+            if (inline_buffers[i] == NULL) {
+                ERROR("malloc failed");
+                connected = false;
+                break;
+            }
+
+            if (is_input(param->type))
+                connected = receive_all(fd, inline_buffers[i], param->size);
+
+            params[i].mem_ref = inline_buffers[i];
+            params[i].mem_ref_size = param->size;
+        } else if (param->location == TA_SIMULATOR_PARAM_SHARED) {
+            if (!is_shared(process, param->address, param->size)) {
+                ERROR("params[%zu] is not in shared memory", i);
+                status = SA_STATUS_INVALID_PARAMETER;
+            }
+
+            params[i].mem_ref = (void*) (uintptr_t) param->address;
+            params[i].mem_ref_size = param->size;
+        } else if (param->size != 0) {
+            ERROR("params[%zu] has a size but no memory", i);
+            status = SA_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    if (connected) {
+        if (session_context == NULL) {
+            ERROR("No open session");
+            status = SA_STATUS_INVALID_PARAMETER;
+        }
+
+        if (status == SA_STATUS_OK) {
+            inject_latency(request->command_id);
+            status = ta_invoke_command_handler(session_context, (SA_COMMAND_ID) request->command_id, params);
+        }
+
+        ta_simulator_response response = {TA_SIMULATOR_MAGIC, status};
+        connected = send_all(fd, &response, sizeof(response));
+        for (size_t i = 0; i < NUM_TA_PARAMS && connected; i++) {
+            if (inline_buffers[i] != NULL && is_output(request->params[i].type))
+                connected = send_all(fd, inline_buffers[i], request->params[i].size);
+        }
+    }
+
+    for (size_t i = 0; i < NUM_TA_PARAMS; i++)
+        free(inline_buffers[i]);
+
+    return connected;
+}
+
+static void* serve_connection(void* argument) {
+    int fd = (int) (intptr_t) argument;
+    client_process* process = client_process_acquire(fd);
+    if (process == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    void* session_context = NULL;
+    while (true) {
+        ta_simulator_request request;
+        int passed_fd;
+        if (!receive_request(fd, &request, &passed_fd))
+            break;
+
+        if (request.magic != TA_SIMULATOR_MAGIC) {
+            ERROR("Invalid request");
+            if (passed_fd >= 0)
+                close(passed_fd);
+
+            break;
+        }
+
+        if (request.message_type == TA_SIMULATOR_INVOKE_COMMAND) {
+            if (!invoke_command(fd, process, session_context, &request))
+                break;
+
+            continue;
+        }
+
+        sa_status status;
+        switch (request.message_type) {
+            case TA_SIMULATOR_OPEN_SESSION:
+                status = session_context != NULL ? SA_STATUS_INVALID_PARAMETER :
+                                                   ta_open_session_handler(&session_context);
+                break;
+
+            case TA_SIMULATOR_CLOSE_SESSION:
+                if (session_context != NULL)
+                    ta_close_session_handler(session_context);
+
+                session_context = NULL;
+                status = SA_STATUS_OK;
+                break;
+
+            case TA_SIMULATOR_MAP_SHARED_MEMORY:
+                status = map_shared_memory(process, passed_fd, request.address, request.size);
+                break;
+
+            case TA_SIMULATOR_UNMAP_SHARED_MEMORY:
+                status = unmap_shared_memory(process, request.address, request.size);
+                break;
+
+            default:
+                ERROR("Unknown message type %u", request.message_type);
+                status = SA_STATUS_INVALID_PARAMETER;
+        }
+
+        if (passed_fd >= 0)
+            close(passed_fd);
+
+        ta_simulator_response response = {TA_SIMULATOR_MAGIC, status};
+        if (!send_all(fd, &response, sizeof(response)))
+            break;
+    }
+
+    // A client that exits without closing its session must not leak the TA client slot.
+    if (session_context != NULL)
+        ta_close_session_handler(session_context);
+
+    client_process_release(process);
+    close(fd);
+    return NULL;
+}
+
+static bool parse_latency(
+        const char* text,
+        uint64_t* latency) {
+
+    char* end = NULL;
+    double microseconds = strtod(text, &end);
+    if (end == text || *end != '\0' || microseconds < 0)
+        return false;
+
+    *latency = (uint64_t) (microseconds * 1000.0);
+    return true;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-s socket] [-l microseconds] [-c command_id=microseconds]...\n", name);
+}
+
+int main(
+        int argc,
+        char** argv) {
+
+    const char* path = TA_SIMULATOR_DEFAULT_SOCKET;
+    uint64_t command_latency[MAX_COMMANDS];
+    bool command_latency_set[MAX_COMMANDS] = {0};
+    int option;
+    while ((option = getopt(argc, argv, "s:l:c:h")) != -1) {
+        switch (option) {
+            case 's':
+                path = optarg;
+                break;
+
+            case 'l':
+                if (!parse_latency(optarg, &default_latency_ns)) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                break;
+
+            case 'c': {
+                char* separator = strchr(optarg, '=');
+                char* end = NULL;
+                unsigned long command_id = strtoul(optarg, &end, 10);
+                if (separator == NULL || end != separator || command_id >= MAX_COMMANDS ||
+                        !parse_latency(separator + 1, &command_latency[command_id])) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+
+                command_latency_set[command_id] = true;
+                break;
+            }
+
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < MAX_COMMANDS; i++)
+        latency_ns[i] = command_latency_set[i] ? command_latency[i] : default_latency_ns;
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long\n");
+        return EXIT_FAILURE;
+    }
+
+    strcpy(address.sun_path, path);
+
+    // Handlers are installed without SA_RESTART so that accept returns when the simulator is stopped.
+    struct sigaction action = {0};
+    action.sa_handler = stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        fprintf(stderr, "socket failed: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Cannot listen on %s: %s\n", path, strerror(errno));
+        close(listen_fd);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "ta_simulator listening on %s\n", path);
+    while (running) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EINTR)
+                fprintf(stderr, "accept failed: %s\n", strerror(errno));
+
+            continue;
+        }
+
+        // Connection threads inherit a mask that keeps SIGINT and SIGTERM for the thread blocked in accept.
+        sigset_t signals;
+        sigset_t previous;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, &previous);
+        pthread_t thread;
+        int result = pthread_create(&thread, NULL, serve_connection, (void*) (intptr_t) fd);
+        pthread_sigmask(SIG_SETMASK, &previous, NULL);
+        if (result != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            close(fd);
+            continue;
+        }
+
+        pthread_detach(thread);
+    }
+
+    close(listen_fd);
+    unlink(path);
+    return EXIT_SUCCESS;
+}
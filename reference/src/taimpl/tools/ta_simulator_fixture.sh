@@ -0,0 +1,76 @@
+#!/bin/sh
+#
+# Copyright 2023 Comcast Cable Communications Management, LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Starts or stops a ta_simulator daemon for the client tests of an ENABLE_TA_SIMULATOR build.
+#
+# Usage: ta_simulator_fixture.sh start <ta_simulator> <socket>
+#        ta_simulator_fixture.sh stop <socket>
+#
+# The daemon runs from the directory of its executable so that it finds root_keystore.p12. Its pid is kept in
+# <socket>.pid and its output in <socket>.log.
+
+set -u
+
+case "${1:-}" in
+    start)
+        simulator=$2
+        socket=$3
+        "$0" stop "$socket"
+        rm -f "$socket"
+        cd "$(dirname "$simulator")" || exit 1
+        "$simulator" -s "$socket" > "$socket.log" 2>&1 &
+        echo $! > "$socket.pid"
+
+        # Wait up to 10 s for the daemon to listen.
+        i=0
+        while [ ! -S "$socket" ]; do
+            if [ $i -ge 100 ] || ! kill -0 "$(cat "$socket.pid")" 2> /dev/null; then
+                echo "ta_simulator did not start" >&2
+                cat "$socket.log" >&2
+                exit 1
+            fi
+
+            sleep 0.1
+            i=$((i + 1))
+        done
+        ;;
+
+    stop)
+        socket=$2
+        if [ -f "$socket.pid" ]; then
+            pid=$(cat "$socket.pid")
+            kill "$pid" 2> /dev/null
+
+            # Wait up to 10 s for the daemon to exit.
+            i=0
+            while [ $i -lt 100 ] && kill -0 "$pid" 2> /dev/null; do
+                sleep 0.1
+                i=$((i + 1))
+            done
+
+            rm -f "$socket.pid"
+        fi
+        ;;
+
+    *)
+        echo "Usage: $0 start <ta_simulator> <socket> | stop <socket>" >&2
+        exit 1
+        ;;
+esac
+
+exit 0
@@ -26,9 +26,11 @@
 #define LOG_H
 
 #ifdef __cplusplus
+#include <cstdbool>
 #include <cstddef>
 extern "C" {
 #else
+#include <stdbool.h>
 #include <stddef.h>
 #endif
 
@@ -41,12 +43,44 @@ typedef enum {
     LOG_LEVEL_FATAL
 } log_level_e;
 
-#define TRACE(...) log_entry(LOG_LEVEL_TRACE, __FILE__, __LINE__, __func__, __VA_ARGS__)
-#define DEBUG(...) log_entry(LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__, __VA_ARGS__)
-#define INFO(...) log_entry(LOG_LEVEL_INFO, __FILE__, __LINE__, __func__, __VA_ARGS__)
-#define WARN(...) log_entry(LOG_LEVEL_WARN, __FILE__, __LINE__, __func__, __VA_ARGS__)
-#define ERROR(...) log_entry(LOG_LEVEL_ERROR, __FILE__, __LINE__, __func__, __VA_ARGS__)
-#define FATAL(...) log_entry(LOG_LEVEL_FATAL, __FILE__, __LINE__, __func__, __VA_ARGS__)
+/**
+ * Minimum log level compiled in. Messages below this level compile to nothing. Must be a numeric
+ * value matching log_level_e so it can be evaluated by the preprocessor and the optimizer.
+ */
+#ifndef SA_LOG_MIN_LEVEL
+#define SA_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * Current minimum log level to output. Read inline by the logging macros so that disabled levels
+ * do not pay for a function call. Use log_set_level to change it. It is only accessed with atomic
+ * builtins, which work from both C and C++, as it can be changed while other threads log.
+ */
+extern log_level_e log_runtime_level;
+
+#define LOG_ENABLED(level) \
+    ((int) (level) >= SA_LOG_MIN_LEVEL && (int) (level) >= (int) __atomic_load_n(&log_runtime_level, __ATOMIC_RELAXED))
+#define LOG_ENTRY(level, ...) \
+    (LOG_ENABLED(level) ? log_entry((level), __FILE__, __LINE__, __func__, __VA_ARGS__) : (void) 0)
+
+#define TRACE(...) LOG_ENTRY(LOG_LEVEL_TRACE, __VA_ARGS__)
+#define DEBUG(...) LOG_ENTRY(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define INFO(...) LOG_ENTRY(LOG_LEVEL_INFO, __VA_ARGS__)
+#define WARN(...) LOG_ENTRY(LOG_LEVEL_WARN, __VA_ARGS__)
+#define ERROR(...) LOG_ENTRY(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define FATAL(...) LOG_ENTRY(LOG_LEVEL_FATAL, __VA_ARGS__)
+
+/**
+ * Log sink callback.
+ *
+ * @param[in] level log level.
+ * @param[in] line formatted log line without a trailing new line.
+ * @param[in] context context supplied to log_set_sink_callback.
+ */
+typedef void (*log_sink_callback)(
+        log_level_e level,
+        const char* line,
+        void* context);
 
 /**
  * Set minimum log level to output.
@@ -56,13 +90,15 @@ typedef enum {
 void log_set_level(size_t level);
 
 /**
- * Create a log entry.
+ * Create a log entry. The entry is captured into a binary record holding copies of the arguments
+ * and queued to a background thread, which formats it and writes it to the sink. FATAL entries,
+ * and all entries while asynchronous logging is disabled, are written before returning.
  *
  * @param[in] level log level.
  * @param[in] file source file.
  * @param[in] line source line number.
  * @param[in] function function name.
- * @param[in] format format string.
+ * @param[in] format format string. Must be a string literal.
  * @param[in] ... data.
  */
 void log_entry(
@@ -73,6 +109,50 @@ void log_entry(
         const char* format,
         ...);
 
+/**
+ * Write log lines to stderr. This is the default sink.
+ */
+void log_set_sink_stderr();
+
+/**
+ * Append log lines to a file.
+ *
+ * @param[in] path file path.
+ * @return true if the file was opened, false otherwise.
+ */
+bool log_set_sink_file(const char* path);
+
+/**
+ * Pass log lines to a callback. The callback is invoked from the logging thread.
+ *
+ * @param[in] callback callback.
+ * @param[in] context context passed to the callback.
+ */
+void log_set_sink_callback(
+        log_sink_callback callback,
+        void* context);
+
+/**
+ * Enable or disable asynchronous logging. Disabling flushes all queued entries.
+ *
+ * @param[in] async true to queue entries to the logging thread.
+ */
+void log_set_async(bool async);
+
+/**
+ * Limit how many entries per second a single call site may emit. Suppressed entries are counted and
+ * reported with the next entry from that call site. Limiting is off unless enabled here or with the
+ * SA_LOG_RATE_LIMIT compile definition.
+ *
+ * @param[in] per_second maximum number of entries per second per call site. 0 disables limiting.
+ */
+void log_set_rate_limit(size_t per_second);
+
+/**
+ * Wait until all queued entries have been written to the sink.
+ */
+void log_flush();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/** @section Description
+ * @file trace.h
+ *
+ * This file contains the functions and macros providing span tracing. A span covers a section of
+ * code on one thread, and spans opened while another span is open on the same thread are nested
+ * in it. Completed spans are recorded into a per-thread ring buffer and can be written out in the
+ * Chrome trace-event JSON format, which chrome://tracing and Perfetto load directly.
+ *
+ * The TRACE_SPAN macros compile to nothing unless ENABLE_TRACE is defined. When compiled in,
+ * recording is switched on at runtime with trace_set_enabled, or by setting the SA_TRACE_FILE
+ * environment variable to the file the trace is written to when the process exits.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+#include <cstdbool>
+#include <cstdint>
+extern "C" {
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+/**
+ * Whether spans are currently being recorded. Read inline by the TRACE_SPAN macros so that a
+ * disabled tracer does not pay for a function call. Use trace_set_enabled to change it. It is only
+ * accessed with atomic builtins, which work from both C and C++, as it can be changed while other
+ * threads record spans.
+ */
+extern bool trace_runtime_enabled;
+
+#define TRACE_ENABLED() __atomic_load_n(&trace_runtime_enabled, __ATOMIC_RELAXED)
+
+#ifdef ENABLE_TRACE
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/**
+ * Open a span. name must be a string literal. Evaluates to a bool token that must be passed to the
+ * matching TRACE_SPAN_END, so that a span that was not opened is not closed either.
+ */
+#define TRACE_SPAN_BEGIN(name) (TRACE_ENABLED() && trace_begin((name), 0))
+
+/** Open a span with an integer argument shown in the trace viewer. */
+#define TRACE_SPAN_BEGIN_ARG(name, arg) (TRACE_ENABLED() && trace_begin((name), (int64_t) (arg)))
+
+/** Close the span opened by the TRACE_SPAN_BEGIN that returned token. */
+#define TRACE_SPAN_END(token) ((token) ? trace_end() : (void) 0)
+
+/** Open a span that is closed when the enclosing scope exits. */
+#define TRACE_SPAN_SCOPE(name) \
+    __attribute__((cleanup(trace_scope_end))) bool TRACE_CONCAT(trace_scope_, __LINE__) = \
+            TRACE_SPAN_BEGIN(name)
+
+#else
+
+#define TRACE_SPAN_BEGIN(name) false
+#define TRACE_SPAN_BEGIN_ARG(name, arg) false
+#define TRACE_SPAN_END(token) ((void) (token))
+#define TRACE_SPAN_SCOPE(name) \
+    do { \
+    } while (0)
+
+#endif
+
+/**
+ * Enable or disable span recording. Spans that are open when recording is disabled are discarded.
+ *
+ * @param[in] enabled true to record spans.
+ */
+void trace_set_enabled(bool enabled);
+
+/**
+ * Open a span on the calling thread.
+ *
+ * @param[in] name span name. Must be a string literal, it is referenced until the trace is written.
+ * @param[in] arg integer argument recorded with the span.
+ * @return true if the span was opened, false if recording is disabled or the spans are nested too
+ * deeply.
+ */
+bool trace_begin(
+        const char* name,
+        int64_t arg);
+
+/**
+ * Close the innermost open span on the calling thread and record it.
+ */
+void trace_end();
+
+/**
+ * Close the span opened by TRACE_SPAN_SCOPE.
+ *
+ * @param[in] opened whether the span was opened.
+ */
+void trace_scope_end(bool* opened);
+
+/**
+ * Write all recorded spans to a file in the Chrome trace-event JSON format.
+ *
+ * @param[in] path file path.
+ * @return true if the file was written, false otherwise.
+ */
+bool trace_dump(const char* path);
+
+/**
+ * Discard all recorded spans.
+ */
+void trace_clear();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
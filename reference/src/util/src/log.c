@@ -16,9 +16,16 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+
 #include "log.h"
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
 #include <time.h>
 
 static const char* LOG_LEVEL_STRING[] = {
@@ -28,13 +35,667 @@ static const char* LOG_LEVEL_STRING[] = {
 #define SA_LOG_LEVEL LOG_LEVEL_INFO
 #endif
 
-static struct {
+// number of records in the ring buffer, must be a power of 2
+#ifndef SA_LOG_RING_SIZE
+#define SA_LOG_RING_SIZE 1024
+#endif
+
+// default number of entries per second per call site, 0 disables limiting
+#ifndef SA_LOG_RATE_LIMIT
+#define SA_LOG_RATE_LIMIT 0
+#endif
+
+#define LOG_ARGS_SIZE 256
+#define LOG_LINE_SIZE 1024
+#define RATE_LIMIT_SITES 256
+#define DRAIN_WAIT_NS 100000000
+
+log_level_e log_runtime_level = SA_LOG_LEVEL;
+
+// Captured log entry. Arguments are copied into args in the order of the conversions in format, so
+// the entry can be formatted later without the caller's stack. Strings are stored as a 16 bit
+// length followed by the characters. If the arguments do not fit, the message is formatted at
+// capture time and args holds the text.
+typedef struct {
+    atomic_size_t sequence;
     log_level_e level;
-} global_log = {
-        .level = SA_LOG_LEVEL};
+    int line;
+    const char* file;
+    const char* function;
+    const char* format;
+    struct timespec timestamp;
+    unsigned int suppressed;
+    bool preformatted;
+    size_t args_length;
+    uint8_t args[LOG_ARGS_SIZE];
+} log_record_t;
+
+typedef struct {
+    char flags[8];
+    size_t flags_length;
+    bool width_star;
+    int width;
+    bool precision_star;
+    int precision;
+    char length[3];
+    char conversion;
+} log_spec_t;
+
+typedef enum {
+    LOG_SINK_STDERR,
+    LOG_SINK_FILE,
+    LOG_SINK_CALLBACK
+} log_sink_e;
+
+typedef struct {
+    atomic_uintptr_t site;
+    atomic_uint_fast64_t window;
+    atomic_uint count;
+    atomic_uint suppressed;
+} rate_limit_entry_t;
+
+static once_flag flag = ONCE_FLAG_INIT;
+
+// Bounded MPSC queue. Each record carries a sequence number: a producer may claim the record at
+// position p when its sequence equals p, and publishes it by setting it to p + 1. The consumer
+// returns the record to producers by setting it to p + SA_LOG_RING_SIZE.
+static struct {
+    log_record_t records[SA_LOG_RING_SIZE];
+    atomic_size_t enqueue_position;
+    atomic_size_t dequeue_position;
+    atomic_size_t dropped;
+} ring;
+
+static struct {
+    thrd_t thread;
+    // cleared only once the thread has been joined, until then it is the only consumer
+    atomic_bool running;
+    atomic_bool async;
+    atomic_bool stop;
+    atomic_bool waiting;
+    mtx_t mutex;
+    cnd_t condition;
+} drain;
+
+static struct {
+    mtx_t mutex;
+    log_sink_e type;
+    FILE* file;
+    log_sink_callback callback;
+    void* context;
+} sink = {
+        .type = LOG_SINK_STDERR};
+
+static struct {
+    atomic_size_t per_second;
+    rate_limit_entry_t entries[RATE_LIMIT_SITES];
+} rate_limit = {
+        .per_second = SA_LOG_RATE_LIMIT};
+
+static const char* parse_spec(
+        const char* p,
+        log_spec_t* spec) {
+
+    memset(spec, 0, sizeof(log_spec_t));
+    spec->width = -1;
+    spec->precision = -1;
+
+    // skip '%'
+    p++;
+    while (*p != '\0' && strchr("-+ #0'", *p) != NULL) {
+        if (spec->flags_length < sizeof(spec->flags) - 1)
+            spec->flags[spec->flags_length++] = *p;
+        p++;
+    }
+
+    if (*p == '*') {
+        spec->width_star = true;
+        p++;
+    } else if (*p >= '0' && *p <= '9') {
+        spec->width = (int) strtol(p, (char**) &p, 10);
+    }
+
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->precision_star = true;
+            p++;
+        } else {
+            spec->precision = (int) strtol(p, (char**) &p, 10);
+        }
+    }
+
+    size_t length = 0;
+    while (*p != '\0' && strchr("hlLzjt", *p) != NULL && length < sizeof(spec->length) - 1)
+        spec->length[length++] = *p++;
+
+    if (*p == '\0' || strchr("diouxXcsfFeEgGaAp%", *p) == NULL)
+        return NULL;
+
+    spec->conversion = *p;
+    return p + 1;
+}
+
+static bool put(
+        log_record_t* record,
+        const void* value,
+        size_t size) {
+
+    if (record->args_length + size > sizeof(record->args))
+        return false;
+
+    memcpy(record->args + record->args_length, value, size);
+    record->args_length += size;
+    return true;
+}
+
+static bool get(
+        const log_record_t* record,
+        size_t* position,
+        void* value,
+        size_t size) {
+
+    if (*position + size > record->args_length)
+        return false;
+
+    memcpy(value, record->args + *position, size);
+    *position += size;
+    return true;
+}
+
+static bool is_wide(const log_spec_t* spec) {
+    return spec->length[0] == 'l' || spec->length[0] == 'z' || spec->length[0] == 'j' || spec->length[0] == 't';
+}
+
+static bool capture_args(
+        log_record_t* record,
+        va_list args) {
+
+    log_spec_t spec;
+    for (const char* p = record->format; *p != '\0';) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+        if (p == NULL)
+            return false;
+
+        if (spec.conversion == '%')
+            continue;
+
+        if (spec.width_star) {
+            int width = va_arg(args, int);
+            if (!put(record, &width, sizeof(width)))
+                return false;
+        }
+
+        if (spec.precision_star) {
+            spec.precision = va_arg(args, int);
+            if (!put(record, &spec.precision, sizeof(spec.precision)))
+                return false;
+        }
+
+        bool status;
+        switch (spec.conversion) {
+            case 's': {
+                const char* string = va_arg(args, const char*);
+                if (string == NULL)
+                    string = "(null)";
+
+                // respect the precision, the string does not have to be terminated within it
+                size_t string_length = spec.precision >= 0 ? strnlen(string, spec.precision) : strlen(string);
+                uint16_t stored_length = string_length > UINT16_MAX ? UINT16_MAX : string_length;
+                status = put(record, &stored_length, sizeof(stored_length)) &&
+                         put(record, string, stored_length);
+                break;
+            }
+            case 'p': {
+                void* pointer = va_arg(args, void*);
+                status = put(record, &pointer, sizeof(pointer));
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (spec.length[0] == 'L') {
+                    long double value = va_arg(args, long double);
+                    status = put(record, &value, sizeof(value));
+                } else {
+                    double value = va_arg(args, double);
+                    status = put(record, &value, sizeof(value));
+                }
+                break;
+
+            default: {
+                long long value;
+                if (strcmp(spec.length, "ll") == 0)
+                    value = va_arg(args, long long);
+                else if (spec.length[0] == 'l')
+                    value = va_arg(args, long);
+                else if (spec.length[0] == 'z')
+                    value = (long long) va_arg(args, size_t);
+                else if (spec.length[0] == 'j')
+                    value = (long long) va_arg(args, intmax_t);
+                else if (spec.length[0] == 't')
+                    value = va_arg(args, ptrdiff_t);
+                else
+                    value = va_arg(args, int);
+
+                status = put(record, &value, sizeof(value));
+                break;
+            }
+        }
+
+        if (!status)
+            return false;
+    }
+
+    return true;
+}
+
+static void capture(
+        log_record_t* record,
+        va_list args) {
+
+    va_list copy;
+    va_copy(copy, args);
+    record->args_length = 0;
+    record->preformatted = !capture_args(record, copy);
+    va_end(copy);
+
+    if (record->preformatted) {
+        int length = vsnprintf((char*) record->args, sizeof(record->args), record->format, args);
+        record->args_length = length < 0 ? 0 : strnlen((char*) record->args, sizeof(record->args));
+    }
+}
+
+static size_t render_args(
+        const log_record_t* record,
+        char* out,
+        size_t out_length) {
+
+    if (record->preformatted)
+        return snprintf(out, out_length, "%.*s", (int) record->args_length, (const char*) record->args);
+
+    size_t written = 0;
+    size_t position = 0;
+    log_spec_t spec;
+    for (const char* p = record->format; *p != '\0' && written < out_length - 1;) {
+        if (*p != '%') {
+            out[written++] = *p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+        if (p == NULL)
+            break;
+
+        if (spec.conversion == '%') {
+            out[written++] = '%';
+            continue;
+        }
+
+        if (spec.width_star && !get(record, &position, &spec.width, sizeof(spec.width)))
+            break;
+
+        if (spec.precision_star && !get(record, &position, &spec.precision, sizeof(spec.precision)))
+            break;
+
+        // rebuild the conversion with resolved width and precision and a normalized length
+        char format[32];
+        int format_length = snprintf(format, sizeof(format), "%%%s", spec.flags);
+        if (spec.width >= 0)
+            format_length += snprintf(format + format_length, sizeof(format) - format_length, "%d", spec.width);
+
+        int result = 0;
+        char* target = out + written;
+        size_t remaining = out_length - written;
+        switch (spec.conversion) {
+            case 's': {
+                uint16_t length;
+                if (!get(record, &position, &length, sizeof(length)) || position + length > record->args_length)
+                    return written;
+
+                snprintf(format + format_length, sizeof(format) - format_length, ".*s");
+                result = snprintf(target, remaining, format, (int) length, (const char*) record->args + position);
+                position += length;
+                break;
+            }
+            case 'p': {
+                void* pointer;
+                if (!get(record, &position, &pointer, sizeof(pointer)))
+                    return written;
+
+                snprintf(format + format_length, sizeof(format) - format_length, "p");
+                result = snprintf(target, remaining, format, pointer);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (spec.precision >= 0)
+                    format_length += snprintf(format + format_length, sizeof(format) - format_length, ".%d",
+                            spec.precision);
+
+                if (spec.length[0] == 'L') {
+                    long double value;
+                    if (!get(record, &position, &value, sizeof(value)))
+                        return written;
+
+                    snprintf(format + format_length, sizeof(format) - format_length, "L%c", spec.conversion);
+                    result = snprintf(target, remaining, format, value);
+                } else {
+                    double value;
+                    if (!get(record, &position, &value, sizeof(value)))
+                        return written;
+
+                    snprintf(format + format_length, sizeof(format) - format_length, "%c", spec.conversion);
+                    result = snprintf(target, remaining, format, value);
+                }
+                break;
+
+            default: {
+                long long value;
+                if (!get(record, &position, &value, sizeof(value)))
+                    return written;
+
+                if (spec.precision >= 0)
+                    format_length += snprintf(format + format_length, sizeof(format) - format_length, ".%d",
+                            spec.precision);
+
+                // narrow arguments keep their h/hh modifier so that sign extension matches the original
+                if (is_wide(&spec)) {
+                    snprintf(format + format_length, sizeof(format) - format_length, "ll%c", spec.conversion);
+                    result = snprintf(target, remaining, format, value);
+                } else {
+                    snprintf(format + format_length, sizeof(format) - format_length, "%s%c", spec.length,
+                            spec.conversion);
+                    result = snprintf(target, remaining, format, (int) value);
+                }
+                break;
+            }
+        }
+
+        if (result < 0)
+            break;
+
+        written += (size_t) result < remaining ? (size_t) result : remaining - 1;
+    }
+
+    out[written] = '\0';
+    return written;
+}
+
+static void render(
+        const log_record_t* record,
+        char* line,
+        size_t line_length) {
+
+    struct tm local_time;
+    localtime_r(&record->timestamp.tv_sec, &local_time);
+
+    size_t length = strftime(line, line_length, "%D %H:%M:%S ", &local_time);
+    int result = snprintf(line + length, line_length - length, "%-5s %.96s:%d (%.32s): ",
+            LOG_LEVEL_STRING[record->level], record->file, record->line, record->function);
+    if (result < 0 || (size_t) result >= line_length - length)
+        return;
+
+    length += result;
+    length += render_args(record, line + length, line_length - length);
+    if (record->suppressed > 0 && length < line_length)
+        snprintf(line + length, line_length - length, " (%u similar messages suppressed)", record->suppressed);
+}
+
+static void write_line(
+        log_level_e level,
+        const char* line,
+        bool flush) {
+
+    if (mtx_lock(&sink.mutex) != thrd_success)
+        return;
+
+    switch (sink.type) {
+        case LOG_SINK_CALLBACK:
+            sink.callback(level, line, sink.context);
+            break;
+
+        case LOG_SINK_FILE:
+            fprintf(sink.file, "%s\n", line);
+            if (flush)
+                fflush(sink.file);
+            break;
+
+        default:
+            fprintf(stderr, "%s\n", line);
+            if (flush)
+                fflush(stderr);
+            break;
+    }
+
+    mtx_unlock(&sink.mutex);
+}
+
+static void write_record(
+        const log_record_t* record,
+        bool flush) {
+
+    char line[LOG_LINE_SIZE];
+    render(record, line, sizeof(line));
+    write_line(record->level, line, flush);
+}
+
+static log_record_t* ring_claim() {
+    size_t position = atomic_load_explicit(&ring.enqueue_position, memory_order_relaxed);
+    while (true) {
+        log_record_t* record = &ring.records[position & (SA_LOG_RING_SIZE - 1)];
+        size_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring.enqueue_position, &position, position + 1,
+                        memory_order_relaxed, memory_order_relaxed))
+                return record;
+        } else if (difference < 0) {
+            // ring is full, drop rather than stall the caller
+            return NULL;
+        } else {
+            position = atomic_load_explicit(&ring.enqueue_position, memory_order_relaxed);
+        }
+    }
+}
+
+static void ring_publish(log_record_t* record) {
+    size_t position = atomic_load_explicit(&record->sequence, memory_order_relaxed);
+    atomic_store_explicit(&record->sequence, position + 1, memory_order_seq_cst);
+
+    // only wake the drain thread if it is about to sleep
+    if (atomic_load_explicit(&drain.waiting, memory_order_seq_cst)) {
+        mtx_lock(&drain.mutex);
+        cnd_signal(&drain.condition);
+        mtx_unlock(&drain.mutex);
+    }
+}
+
+static bool ring_drain_one() {
+    size_t position = atomic_load_explicit(&ring.dequeue_position, memory_order_relaxed);
+    log_record_t* record = &ring.records[position & (SA_LOG_RING_SIZE - 1)];
+    size_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+    if (sequence != position + 1)
+        return false;
+
+    // flush the sink once the ring runs empty
+    log_record_t* next = &ring.records[(position + 1) & (SA_LOG_RING_SIZE - 1)];
+    bool flush = atomic_load_explicit(&next->sequence, memory_order_acquire) != position + 2;
+    write_record(record, flush);
+
+    atomic_store_explicit(&record->sequence, position + SA_LOG_RING_SIZE, memory_order_release);
+    atomic_store_explicit(&ring.dequeue_position, position + 1, memory_order_release);
+    return true;
+}
+
+static void report_dropped() {
+    size_t dropped = atomic_exchange(&ring.dropped, 0);
+    if (dropped == 0)
+        return;
+
+    char line[128];
+    snprintf(line, sizeof(line), "%zu log messages dropped, ring buffer full", dropped);
+    write_line(LOG_LEVEL_WARN, line, true);
+}
+
+static int drain_thread(void* arg) {
+    while (true) {
+        if (ring_drain_one())
+            continue;
+
+        report_dropped();
+        if (atomic_load(&drain.stop))
+            break;
+
+        mtx_lock(&drain.mutex);
+        atomic_store_explicit(&drain.waiting, true, memory_order_seq_cst);
+
+        // re-check after announcing the wait, a producer that missed the flag is seen here
+        size_t position = atomic_load_explicit(&ring.dequeue_position, memory_order_relaxed);
+        log_record_t* record = &ring.records[position & (SA_LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&record->sequence, memory_order_seq_cst) != position + 1 &&
+                !atomic_load(&drain.stop)) {
+            struct timespec deadline;
+            timespec_get(&deadline, TIME_UTC);
+            deadline.tv_nsec += DRAIN_WAIT_NS;
+            if (deadline.tv_nsec >= 1000000000) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            cnd_timedwait(&drain.condition, &drain.mutex, &deadline);
+        }
+
+        atomic_store_explicit(&drain.waiting, false, memory_order_relaxed);
+        mtx_unlock(&drain.mutex);
+    }
+
+    return 0;
+}
+
+static void drain_remaining() {
+    mtx_lock(&drain.mutex);
+    while (ring_drain_one()) {}
+
+    report_dropped();
+    mtx_unlock(&drain.mutex);
+}
+
+static void log_stop() {
+    if (atomic_load(&drain.running)) {
+        atomic_store(&drain.stop, true);
+        mtx_lock(&drain.mutex);
+        cnd_signal(&drain.condition);
+        mtx_unlock(&drain.mutex);
+        thrd_join(drain.thread, NULL);
+        atomic_store(&drain.running, false);
+    }
+
+    // entries queued while the thread was exiting
+    drain_remaining();
+}
+
+// Holding the mutexes across fork keeps the sink and the drain state consistent in the child. drain_remaining takes
+// the drain mutex before the sink mutex, so they are taken in that order.
+static void log_fork_prepare() {
+    mtx_lock(&drain.mutex);
+    mtx_lock(&sink.mutex);
+}
+
+static void log_fork_parent() {
+    mtx_unlock(&sink.mutex);
+    mtx_unlock(&drain.mutex);
+}
+
+// The child does not inherit the drain thread. Entries queued before the fork are written by the parent, so the child
+// starts with an empty ring and writes its entries synchronously.
+static void log_fork_child() {
+    for (size_t i = 0; i < SA_LOG_RING_SIZE; i++)
+        atomic_store_explicit(&ring.records[i].sequence, i, memory_order_relaxed);
+
+    atomic_store(&ring.enqueue_position, 0);
+    atomic_store(&ring.dequeue_position, 0);
+    atomic_store(&ring.dropped, 0);
+    atomic_store(&drain.running, false);
+    atomic_store(&drain.async, false);
+    atomic_store(&drain.waiting, false);
+    mtx_unlock(&sink.mutex);
+    mtx_unlock(&drain.mutex);
+}
+
+static void log_start() {
+    for (size_t i = 0; i < SA_LOG_RING_SIZE; i++)
+        atomic_init(&ring.records[i].sequence, i);
+
+    atomic_init(&drain.async, true);
+    if (mtx_init(&sink.mutex, mtx_plain) != thrd_success || mtx_init(&drain.mutex, mtx_plain) != thrd_success ||
+            cnd_init(&drain.condition) != thrd_success) {
+        atomic_store(&drain.async, false);
+        return;
+    }
+
+    if (thrd_create(&drain.thread, drain_thread, NULL) != thrd_success) {
+        atomic_store(&drain.async, false);
+        return;
+    }
+
+    atomic_store(&drain.running, true);
+    atexit(log_stop);
+    pthread_atfork(log_fork_prepare, log_fork_parent, log_fork_child);
+}
+
+static bool rate_limit_allow(
+        const char* format,
+        int line,
+        unsigned int* suppressed) {
+
+    *suppressed = 0;
+    size_t per_second = atomic_load_explicit(&rate_limit.per_second, memory_order_relaxed);
+    if (per_second == 0)
+        return true;
+
+    uintptr_t site = (uintptr_t) format ^ ((uintptr_t) line << 1);
+    rate_limit_entry_t* entry = &rate_limit.entries[(site >> 3) % RATE_LIMIT_SITES];
+
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    uint_fast64_t window = now.tv_sec;
+
+    // entries are shared by colliding call sites, which only costs accuracy
+    if (atomic_load_explicit(&entry->site, memory_order_relaxed) != site ||
+            atomic_load_explicit(&entry->window, memory_order_relaxed) != window) {
+        atomic_store_explicit(&entry->site, site, memory_order_relaxed);
+        atomic_store_explicit(&entry->window, window, memory_order_relaxed);
+        atomic_store_explicit(&entry->count, 0, memory_order_relaxed);
+    }
+
+    if (atomic_fetch_add_explicit(&entry->count, 1, memory_order_relaxed) >= per_second) {
+        atomic_fetch_add_explicit(&entry->suppressed, 1, memory_order_relaxed);
+        return false;
+    }
+
+    *suppressed = atomic_exchange_explicit(&entry->suppressed, 0, memory_order_relaxed);
+    return true;
+}
 
 void log_set_level(size_t level) {
-    global_log.level = (log_level_e) level;
+    __atomic_store_n(&log_runtime_level, (log_level_e) level, __ATOMIC_RELAXED);
 }
 
 void log_entry(
@@ -45,25 +706,131 @@ void log_entry(
         const char* format,
         ...) {
 
-    if (level < global_log.level) {
+    if (level < __atomic_load_n(&log_runtime_level, __ATOMIC_RELAXED) || level > LOG_LEVEL_FATAL) {
         return;
     }
 
-    // get current time
-    time_t current_time = time(NULL);
-    struct tm local_time;
-    localtime_r(&current_time, &local_time);
+    call_once(&flag, log_start);
+
+    unsigned int suppressed;
+    if (level != LOG_LEVEL_FATAL && !rate_limit_allow(format, line, &suppressed))
+        return;
+
+    bool async = level != LOG_LEVEL_FATAL && atomic_load_explicit(&drain.async, memory_order_relaxed) &&
+                 !atomic_load_explicit(&drain.stop, memory_order_relaxed);
+
+    log_record_t local;
+    log_record_t* record = &local;
+    if (async) {
+        record = ring_claim();
+        if (record == NULL) {
+            atomic_fetch_add_explicit(&ring.dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
 
-    // compose new format line with timestamp, log level, file and line numbers
-    char new_format[320];
-    strftime(new_format, sizeof(new_format), "%D %H:%M:%S ", &local_time);
-    snprintf(new_format + 18, sizeof(new_format) - 18, "%-5s %.96s:%d (%.32s): %.128s\n", LOG_LEVEL_STRING[level], file,
-            line, function, format);
+    record->level = level;
+    record->file = file;
+    record->line = line;
+    record->function = function;
+    record->format = format;
+    record->suppressed = level == LOG_LEVEL_FATAL ? 0 : suppressed;
+    timespec_get(&record->timestamp, TIME_UTC);
 
-    // forward to vfprintf
     va_list args;
     va_start(args, format);
-    vfprintf(stderr, new_format, args);
-    fflush(stderr);
+    capture(record, args);
     va_end(args);
+
+    if (async) {
+        ring_publish(record);
+        return;
+    }
+
+    // keep ordering with entries already queued
+    log_flush();
+    write_record(record, true);
+}
+
+void log_set_sink_stderr() {
+    call_once(&flag, log_start);
+    mtx_lock(&sink.mutex);
+    if (sink.file != NULL)
+        fclose(sink.file);
+
+    sink.file = NULL;
+    sink.type = LOG_SINK_STDERR;
+    mtx_unlock(&sink.mutex);
+}
+
+bool log_set_sink_file(const char* path) {
+    if (path == NULL)
+        return false;
+
+    FILE* file = fopen(path, "ae");
+    if (file == NULL)
+        return false;
+
+    call_once(&flag, log_start);
+    mtx_lock(&sink.mutex);
+    if (sink.file != NULL)
+        fclose(sink.file);
+
+    sink.file = file;
+    sink.type = LOG_SINK_FILE;
+    mtx_unlock(&sink.mutex);
+    return true;
+}
+
+void log_set_sink_callback(
+        log_sink_callback callback,
+        void* context) {
+
+    if (callback == NULL) {
+        log_set_sink_stderr();
+        return;
+    }
+
+    call_once(&flag, log_start);
+    mtx_lock(&sink.mutex);
+    if (sink.file != NULL)
+        fclose(sink.file);
+
+    sink.file = NULL;
+    sink.callback = callback;
+    sink.context = context;
+    sink.type = LOG_SINK_CALLBACK;
+    mtx_unlock(&sink.mutex);
+}
+
+void log_set_async(bool async) {
+    call_once(&flag, log_start);
+    if (!atomic_load(&drain.running))
+        return;
+
+    atomic_store(&drain.async, async);
+    if (!async)
+        log_flush();
+}
+
+void log_set_rate_limit(size_t per_second) {
+    atomic_store(&rate_limit.per_second, per_second);
+}
+
+void log_flush() {
+    call_once(&flag, log_start);
+
+    size_t target = atomic_load(&ring.enqueue_position);
+    while (atomic_load(&ring.dequeue_position) < target) {
+        if (!atomic_load(&drain.running)) {
+            // no drain thread, records claimed but not yet published are given up on
+            drain_remaining();
+            break;
+        }
+
+        mtx_lock(&drain.mutex);
+        cnd_signal(&drain.condition);
+        mtx_unlock(&drain.mutex);
+        thrd_yield();
+    }
 }
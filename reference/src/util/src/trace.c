@@ -0,0 +1,292 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "trace.h" // NOLINT
+#include "log.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 4096
+#endif
+
+#define TRACE_MAX_DEPTH 32
+
+typedef struct {
+    const char* name;
+    int64_t arg;
+    uint64_t start;
+} trace_open_span_t;
+
+typedef struct {
+    // Index + 1 of the event stored in the slot, 0 while the slot is being written.
+    atomic_uint_fast64_t sequence;
+    const char* name;
+    int64_t arg;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t tid;
+} trace_event_t;
+
+typedef struct trace_buffer_s {
+    struct trace_buffer_s* next;
+    atomic_bool in_use;
+    uint32_t tid;
+    uint64_t epoch;
+    size_t depth;
+    trace_open_span_t open[TRACE_MAX_DEPTH];
+    atomic_uint_fast64_t head;
+    atomic_uint_fast64_t tail;
+    trace_event_t events[TRACE_BUFFER_SIZE];
+} trace_buffer_t;
+
+bool trace_runtime_enabled = false;
+
+static struct {
+    once_flag flag;
+    bool initialized;
+    tss_t buffer_key;
+    _Atomic(trace_buffer_t*) buffers;
+    atomic_uint_fast64_t epoch;
+    atomic_uint_fast32_t next_tid;
+    char* exit_path;
+} global_trace = {.flag = ONCE_FLAG_INIT};
+
+static _Thread_local trace_buffer_t* thread_buffer = NULL;
+
+static uint64_t trace_now() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static void trace_buffer_return(void* object) {
+    trace_buffer_t* buffer = object;
+    if (buffer != NULL)
+        atomic_store_explicit(&buffer->in_use, false, memory_order_release);
+}
+
+static void trace_init() {
+    if (tss_create(&global_trace.buffer_key, trace_buffer_return) != thrd_success) {
+        ERROR("tss_create failed");
+        return;
+    }
+
+    global_trace.initialized = true;
+}
+
+static trace_buffer_t* trace_buffer_acquire() {
+    call_once(&global_trace.flag, trace_init);
+    if (!global_trace.initialized)
+        return NULL;
+
+    // Buffers are never freed. A buffer released by an exited thread is handed to the next new
+    // thread, its recorded events keep the ID of the thread that recorded them.
+    trace_buffer_t* buffer = atomic_load_explicit(&global_trace.buffers, memory_order_acquire);
+    for (; buffer != NULL; buffer = buffer->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&buffer->in_use, &expected, true, memory_order_acquire,
+                    memory_order_relaxed))
+            break;
+    }
+
+    if (buffer == NULL) {
+        buffer = calloc(1, sizeof(trace_buffer_t));
+        if (buffer == NULL) {
+            ERROR("calloc failed");
+            return NULL;
+        }
+
+        atomic_init(&buffer->in_use, true);
+        trace_buffer_t* head = atomic_load_explicit(&global_trace.buffers, memory_order_relaxed);
+        do {
+            buffer->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&global_trace.buffers, &head, buffer, memory_order_release,
+                memory_order_relaxed));
+    }
+
+    if (tss_set(global_trace.buffer_key, buffer) != thrd_success) {
+        ERROR("tss_set failed");
+        trace_buffer_return(buffer);
+        return NULL;
+    }
+
+    buffer->tid = atomic_fetch_add_explicit(&global_trace.next_tid, 1, memory_order_relaxed) + 1;
+    buffer->depth = 0;
+    thread_buffer = buffer;
+    return buffer;
+}
+
+static void trace_exit_dump() {
+    if (global_trace.exit_path != NULL) {
+        trace_dump(global_trace.exit_path);
+        free(global_trace.exit_path);
+        global_trace.exit_path = NULL;
+    }
+}
+
+__attribute__((constructor)) static void trace_env_init() {
+    const char* path = getenv("SA_TRACE_FILE");
+    if (path == NULL || path[0] == '\0')
+        return;
+
+    global_trace.exit_path = strdup(path);
+    if (global_trace.exit_path == NULL)
+        return;
+
+    atexit(trace_exit_dump);
+    trace_set_enabled(true);
+}
+
+void trace_set_enabled(bool enabled) {
+    if (enabled && !TRACE_ENABLED())
+        atomic_fetch_add_explicit(&global_trace.epoch, 1, memory_order_relaxed);
+
+    __atomic_store_n(&trace_runtime_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+bool trace_begin(
+        const char* name,
+        int64_t arg) {
+
+    if (!TRACE_ENABLED())
+        return false;
+
+    trace_buffer_t* buffer = thread_buffer;
+    if (buffer == NULL) {
+        buffer = trace_buffer_acquire();
+        if (buffer == NULL)
+            return false;
+    }
+
+    // Spans left open when recording was last disabled are never closed, so drop them.
+    uint64_t epoch = atomic_load_explicit(&global_trace.epoch, memory_order_relaxed);
+    if (buffer->epoch != epoch) {
+        buffer->epoch = epoch;
+        buffer->depth = 0;
+    }
+
+    if (buffer->depth >= TRACE_MAX_DEPTH)
+        return false;
+
+    trace_open_span_t* span = &buffer->open[buffer->depth++];
+    span->name = name;
+    span->arg = arg;
+    span->start = trace_now();
+    return true;
+}
+
+void trace_end() {
+    trace_buffer_t* buffer = thread_buffer;
+    if (buffer == NULL || buffer->depth == 0)
+        return;
+
+    trace_open_span_t* span = &buffer->open[--buffer->depth];
+    uint64_t end = trace_now();
+
+    // Each slot is guarded by its sequence number so trace_dump can skip a slot that is being
+    // overwritten instead of reporting a torn event.
+    uint64_t index = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    trace_event_t* event = &buffer->events[index % TRACE_BUFFER_SIZE];
+    atomic_store_explicit(&event->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    event->name = span->name;
+    event->arg = span->arg;
+    event->start = span->start;
+    event->duration = end > span->start ? end - span->start : 0;
+    event->tid = buffer->tid;
+    atomic_store_explicit(&event->sequence, index + 1, memory_order_release);
+    atomic_store_explicit(&buffer->head, index + 1, memory_order_release);
+}
+
+void trace_scope_end(bool* opened) {
+    if (opened != NULL && *opened)
+        trace_end();
+}
+
+bool trace_dump(const char* path) {
+    if (path == NULL) {
+        ERROR("NULL path");
+        return false;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        ERROR("fopen failed");
+        return false;
+    }
+
+    int pid = (int) getpid();
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (trace_buffer_t* buffer = atomic_load_explicit(&global_trace.buffers, memory_order_acquire);
+            buffer != NULL; buffer = buffer->next) {
+        uint64_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+        if (head - tail > TRACE_BUFFER_SIZE)
+            tail = head - TRACE_BUFFER_SIZE;
+
+        for (uint64_t index = tail; index < head; index++) {
+            trace_event_t* slot = &buffer->events[index % TRACE_BUFFER_SIZE];
+            if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != index + 1)
+                continue;
+
+            trace_event_t event;
+            event.name = slot->name;
+            event.arg = slot->arg;
+            event.start = slot->start;
+            event.duration = slot->duration;
+            event.tid = slot->tid;
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != index + 1)
+                continue;
+
+            fprintf(file,
+                    "%s\n{\"name\":\"%s\",\"cat\":\"secapi\",\"ph\":\"X\",\"ts\":%" PRIu64 ".%03" PRIu64
+                    ",\"dur\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":%" PRIu32 ",\"args\":{\"arg\":%" PRId64
+                    "}}",
+                    first ? "" : ",", event.name, event.start / 1000, event.start % 1000, event.duration / 1000,
+                    event.duration % 1000, pid, event.tid, event.arg);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    bool status = !ferror(file);
+    if (fclose(file) != 0)
+        status = false;
+
+    return status;
+}
+
+void trace_clear() {
+    for (trace_buffer_t* buffer = atomic_load_explicit(&global_trace.buffers, memory_order_acquire);
+            buffer != NULL; buffer = buffer->next) {
+        atomic_store_explicit(&buffer->tail, atomic_load_explicit(&buffer->head, memory_order_acquire),
+                memory_order_relaxed);
+    }
+}
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include "log.h"
+#include "gtest/gtest.h" // NOLINT
+#include <cinttypes>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    class LogTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            log_set_level(LOG_LEVEL_TRACE);
+            log_set_rate_limit(0);
+            log_set_sink_callback(capture, this);
+        }
+
+        void TearDown() override {
+            log_flush();
+            log_set_sink_stderr();
+            log_set_rate_limit(0);
+            log_set_level(LOG_LEVEL_INFO);
+        }
+
+        static void capture(
+                log_level_e level,
+                const char* line,
+                void* context) {
+
+            auto* test = static_cast<LogTest*>(context);
+            std::lock_guard<std::mutex> lock(test->mutex);
+            test->lines.emplace_back(line);
+        }
+
+        std::vector<std::string> collect() {
+            log_flush();
+            std::lock_guard<std::mutex> lock(mutex);
+            return lines;
+        }
+
+        static std::string message(const std::string& line) {
+            auto position = line.find("): ");
+            return position == std::string::npos ? line : line.substr(position + 3);
+        }
+
+        std::mutex mutex;
+        std::vector<std::string> lines;
+    };
+
+    TEST_F(LogTest, formatsDeferredArguments) {
+        int64_t wide = -1234567890123;
+        ERROR("int %d, unsigned %u, hex %08x, size %zu, wide %" PRId64 ", char %c, percent %%", -42, 42U, 0xbeef,
+                static_cast<size_t>(7), wide, 'z');
+        WARN("double %.3f, string '%s', precision '%.3s', star '%*d', null '%s'", 3.14159, "text", "abcdef", 5, 12,
+                static_cast<const char*>(nullptr));
+
+        auto result = collect();
+        ASSERT_EQ(result.size(), 2);
+        EXPECT_EQ(message(result[0]),
+                "int -42, unsigned 42, hex 0000beef, size 7, wide -1234567890123, char z, percent %");
+        EXPECT_EQ(message(result[1]), "double 3.142, string 'text', precision 'abc', star '   12', null '(null)'");
+        EXPECT_NE(result[0].find("ERROR"), std::string::npos);
+        EXPECT_NE(result[0].find("logtest.cpp"), std::string::npos);
+    }
+
+    TEST_F(LogTest, copiesStringsAtCapture) {
+        char buffer[16];
+        strcpy(buffer, "before"); // NOLINT
+        INFO("value %s", buffer);
+        strcpy(buffer, "after"); // NOLINT
+
+        auto result = collect();
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(message(result[0]), "value before");
+    }
+
+    TEST_F(LogTest, filtersRuntimeLevel) {
+        log_set_level(LOG_LEVEL_WARN);
+        DEBUG("dropped");
+        INFO("dropped");
+        WARN("kept");
+
+        auto result = collect();
+        ASSERT_EQ(result.size(), 1);
+        EXPECT_EQ(message(result[0]), "kept");
+    }
+
+    TEST_F(LogTest, preservesOrderAcrossThreads) {
+        const size_t threads = 4;
+        const size_t per_thread = 200;
+
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < threads; t++) {
+            producers.emplace_back([t] {
+                for (size_t i = 0; i < per_thread; i++)
+                    INFO("%zu %zu", t, i);
+            });
+        }
+
+        for (auto& producer : producers)
+            producer.join();
+
+        auto result = collect();
+        std::vector<size_t> next(threads, 0);
+        for (const auto& line : result) {
+            size_t t;
+            size_t i;
+            ASSERT_EQ(sscanf(message(line).c_str(), "%zu %zu", &t, &i), 2); // NOLINT
+            ASSERT_LT(t, threads);
+            EXPECT_EQ(i, next[t]);
+            next[t] = i + 1;
+        }
+
+        // the ring may drop entries when full, but never reorders entries of one thread
+        EXPECT_GT(result.size(), 0);
+    }
+
+    TEST_F(LogTest, logsAfterFork) {
+        ERROR("parent");
+        collect();
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            alarm(10);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                lines.clear();
+            }
+
+            ERROR("child");
+            auto result = collect();
+            _exit(result.size() == 1 && message(result[0]) == "child" ? 0 : 1);
+        }
+
+        ASSERT_NE(pid, -1);
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_TRUE(WIFEXITED(status));
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    TEST_F(LogTest, rateLimitsRepeatedMessages) {
+        log_set_rate_limit(3);
+        for (size_t i = 0; i < 10; i++)
+            WARN("repeated %zu", i);
+
+        // a second boundary during the loop opens one more window
+        auto result = collect();
+        ASSERT_GE(result.size(), 3);
+        EXPECT_LE(result.size(), 6);
+        EXPECT_EQ(message(result[2]), "repeated 2");
+    }
+
+    TEST_F(LogTest, synchronousMode) {
+        log_set_async(false);
+        INFO("sync");
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ASSERT_EQ(lines.size(), 1);
+            EXPECT_EQ(message(lines[0]), "sync");
+        }
+
+        log_set_async(true);
+    }
+} // namespace
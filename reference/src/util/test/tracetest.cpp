@@ -0,0 +1,182 @@
+/**
+ * Copyright 2023 Comcast Cable Communications Management, LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+// Exercise the TRACE_SPAN macros regardless of how the library was configured.
+#ifndef ENABLE_TRACE
+#define ENABLE_TRACE
+#endif
+
+#include "trace.h"
+#include "gtest/gtest.h" // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct trace_event {
+        std::string name;
+        double ts;
+        double dur;
+        uint32_t tid;
+        int64_t arg;
+    };
+
+    class TraceTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            trace_clear();
+            trace_set_enabled(true);
+        }
+
+        void TearDown() override {
+            trace_set_enabled(false);
+            trace_clear();
+            std::remove(path.c_str());
+        }
+
+        std::vector<trace_event> dump() {
+            EXPECT_TRUE(trace_dump(path.c_str()));
+
+            const std::string format = R"({"name":"%63[^"]","cat":"secapi","ph":"X","ts":%lf,"dur":%lf,"pid":%*d,)"
+                                       R"("tid":%)" SCNu32 R"(,"args":{"arg":%)" SCNd64;
+
+            std::vector<trace_event> events;
+            std::ifstream file(path);
+            std::string line;
+            while (std::getline(file, line)) {
+                char name[64];
+                trace_event event;
+                if (sscanf(line.c_str(), format.c_str(), name, &event.ts, &event.dur, &event.tid, &event.arg) == 5) {
+                    event.name = name;
+                    events.push_back(event);
+                }
+            }
+
+            return events;
+        }
+
+        static const trace_event* find(
+                const std::vector<trace_event>& events,
+                const std::string& name) {
+
+            for (const auto& event : events) {
+                if (event.name == name)
+                    return &event;
+            }
+
+            return nullptr;
+        }
+
+        std::string path = "tracetest.json";
+    };
+
+    TEST_F(TraceTest, nestedSpans) {
+        bool outer_span = TRACE_SPAN_BEGIN_ARG("outer", 42);
+        {
+            TRACE_SPAN_SCOPE("inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        TRACE_SPAN_END(outer_span);
+
+        auto events = dump();
+        const trace_event* outer = find(events, "outer");
+        const trace_event* inner = find(events, "inner");
+        ASSERT_NE(outer, nullptr);
+        ASSERT_NE(inner, nullptr);
+        ASSERT_EQ(outer->arg, 42);
+        ASSERT_EQ(outer->tid, inner->tid);
+        ASSERT_GE(inner->dur, 1000.0);
+        ASSERT_LE(outer->ts, inner->ts);
+        ASSERT_GE(outer->ts + outer->dur, inner->ts + inner->dur);
+    }
+
+    TEST_F(TraceTest, disabledRecordsNothing) {
+        trace_set_enabled(false);
+        bool span = TRACE_SPAN_BEGIN("disabled");
+        TRACE_SPAN_END(span);
+
+        ASSERT_TRUE(dump().empty());
+    }
+
+    TEST_F(TraceTest, discardsSpansOpenWhenDisabled) {
+        bool abandoned = TRACE_SPAN_BEGIN("abandoned");
+        trace_set_enabled(false);
+        trace_set_enabled(true);
+        bool reopened = TRACE_SPAN_BEGIN("reopened");
+        TRACE_SPAN_END(reopened);
+        TRACE_SPAN_END(abandoned);
+
+        auto events = dump();
+        ASSERT_EQ(events.size(), 1U);
+        ASSERT_EQ(events[0].name, "reopened");
+    }
+
+    TEST_F(TraceTest, tooDeeplyNestedSpansStayPaired) {
+        bool outer_span = TRACE_SPAN_BEGIN("outer");
+        std::vector<bool> inner_spans;
+        for (size_t i = 0; i < 40; i++)
+            inner_spans.push_back(TRACE_SPAN_BEGIN("inner"));
+
+        while (!inner_spans.empty()) {
+            TRACE_SPAN_END(inner_spans.back());
+            inner_spans.pop_back();
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        TRACE_SPAN_END(outer_span);
+
+        // Spans past the maximum depth are not opened, their ends must not close an outer span.
+        auto events = dump();
+        const trace_event* outer = find(events, "outer");
+        ASSERT_NE(outer, nullptr);
+        for (const auto& event : events) {
+            if (event.name == "inner") {
+                ASSERT_GE(outer->ts + outer->dur, event.ts + event.dur + 1000.0);
+            }
+        }
+    }
+
+    TEST_F(TraceTest, perThreadBuffers) {
+        const size_t thread_count = 4;
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < thread_count; i++) {
+            threads.emplace_back([] {
+                for (size_t j = 0; j < 100; j++) {
+                    TRACE_SPAN_SCOPE("worker");
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        auto events = dump();
+        ASSERT_EQ(events.size(), thread_count * 100);
+
+        std::set<uint32_t> tids;
+        for (const auto& event : events)
+            tids.insert(event.tid);
+
+        ASSERT_EQ(tids.size(), thread_count);
+    }
+} // namespace